@@ -13,15 +13,18 @@
 #include "gt_commons.h"
 #include "gt_string.h"
 #include "gt_dna_string.h"
+#include "gt_profiler.h"
 
 // Input handlers
 #include "gt_input_file.h"
 #include "gt_buffered_input_file.h"
+#include "gt_paired_input_file.h"
 // Input parsers
 #include "gt_input_parser.h"
 #include "gt_input_map_parser.h"
 #include "gt_input_sam_parser.h"
 #include "gt_input_fasta_parser.h"
+#include "gt_input_binary_parser.h"
 #include "gt_input_generic_parser.h"
 
 // Output handlers
@@ -31,6 +34,7 @@
 #include "gt_output_fasta.h"
 #include "gt_output_map.h"
 #include "gt_output_sam.h"
+#include "gt_output_binary.h"
 
 // GEM-Tools basic data structures: Template/Alignment/Maps/...
 #include "gt_misms.h"
@@ -47,17 +51,20 @@
 
 // HighLevel Modules
 #include "gt_stats.h"
+#include "gt_map_score.h"
+#include "gt_duplicates.h"
+#include "gt_inss_model.h"
 
 // Merge functions (synch files)
 #define gt_merge_synch_map_files(input_mutex,paired_end,output_file,input_map_master,input_map_slave) \
   gt_merge_synch_map_files_va(input_mutex,paired_end,output_file,input_map_master,1,input_map_slave)
-GT_INLINE void gt_merge_synch_map_files_a(
+GT_INLINE gt_status gt_merge_synch_map_files_a(
     pthread_mutex_t* const input_mutex,const bool paired_end,gt_output_file* const output_file,
     gt_input_file** const input_map_files,const uint64_t num_input_map_files);
-GT_INLINE void gt_merge_synch_map_files_v(
+GT_INLINE gt_status gt_merge_synch_map_files_v(
     pthread_mutex_t* const input_mutex,const bool paired_end,gt_output_file* const output_file,
     gt_input_file* const input_map_master,const uint64_t num_slaves,va_list v_args);
-GT_INLINE void gt_merge_synch_map_files_va(
+GT_INLINE gt_status gt_merge_synch_map_files_va(
     pthread_mutex_t* const input_mutex,const bool paired_end,gt_output_file* const output_file,
     gt_input_file* const input_map_master,const uint64_t num_slaves,...);
 
@@ -14,6 +14,7 @@
 #include "gt_alignment.h"
 #include "gt_counters_utils.h"
 #include "gt_map_align.h"
+#include "gt_dna_read.h"
 
 #include "gt_output_map.h"
 #include "gt_input_parser.h"
@@ -103,5 +104,8 @@ GT_INLINE void gt_alignment_realign_weighted(
  * Alignment trimming
  */
 GT_INLINE void gt_alignment_trim(gt_alignment* const alignment,uint64_t const left,uint64_t const right,uint64_t const min_length,bool const set_extra);
+GT_INLINE void gt_alignment_auto_trim(
+    gt_alignment* const alignment,gt_dna_read_trim_attributes* const trim_attributes,
+    uint64_t const min_length,bool const set_extra); // Quality/Adapter/Poly-A/N trimming
 
 #endif /* GT_ALIGNMENT_UTILS_H_ */
@@ -31,6 +31,9 @@ typedef struct {
   char* cursor;
   uint64_t lines_in_buffer;
   uint64_t current_line_num;
+  /* Qualities range seen (while parsing) */
+  uint8_t min_quality;
+  uint8_t max_quality;
   /* Attached output buffer */
   gt_buffered_output_file* buffered_output_file;
 } gt_buffered_input_file;
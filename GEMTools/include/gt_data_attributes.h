@@ -54,6 +54,17 @@ typedef struct {
   gt_file_fasta_format fasta_format;
 } gt_fasta_file_format;
 
+/*
+ * BINARY File specifics Attribute (sequence names dictionary, see gt_input_binary_parser.h)
+ *   Names are registered by id as blocks are read (in file order, under the input mutex).
+ *   Chunks are never relocated, so parsing threads can look up the names of their block without locking
+ */
+#define GT_BINARY_SEQ_NAMES_CHUNK_SIZE 1024
+#define GT_BINARY_SEQ_NAMES_MAX_CHUNKS 16384
+typedef struct {
+  gt_string*** seq_names; // (gt_string*[GT_BINARY_SEQ_NAMES_CHUNK_SIZE])[GT_BINARY_SEQ_NAMES_MAX_CHUNKS]
+} gt_binary_file_format;
+
 /*
  * SAM File specifics Attribute (headers)
  */
@@ -85,6 +96,12 @@ typedef struct {
 } gt_sam_attribute;
 
 
+GT_INLINE void gt_binary_file_format_init(gt_binary_file_format* const binary_file_format);
+GT_INLINE void gt_binary_file_format_destroy(gt_binary_file_format* const binary_file_format);
+GT_INLINE bool gt_binary_file_format_set_seq_name(
+    gt_binary_file_format* const binary_file_format,const uint64_t seq_name_id,char* const seq_name,const uint64_t length);
+GT_INLINE gt_string* gt_binary_file_format_get_seq_name(gt_binary_file_format* const binary_file_format,const uint64_t seq_name_id);
+
 GT_INLINE gt_sam_headers* gt_sam_header_new(void);
 GT_INLINE void gt_sam_header_clear(gt_sam_headers* const sam_headers);
 GT_INLINE void gt_sam_header_delete(gt_sam_headers* const sam_headers);
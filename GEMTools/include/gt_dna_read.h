@@ -10,16 +10,41 @@
 #define GT_DNA_READ_H_
 
 #include "gt_commons.h"
+#include "gt_dna_string.h"
 
 typedef struct {
   gt_string* tag;
   gt_string* read;
   gt_string* qualities;
   gt_shash* attributes;
+  /* Qualities range (gathered while parsing, max_quality==0 if unknown) */
+  uint8_t min_quality;
+  uint8_t max_quality;
 } gt_dna_read;
 
 typedef enum { GT_QUALS_OFFSET_33, GT_QUALS_OFFSET_64 } gt_qualities_offset_t;
 
+/*
+ * Trimming attributes (quality/adapter/poly-A/N)
+ */
+#define GT_DNA_READ_MAX_QUALITY 93 /* Highest Phred encodable in a FASTQ line ('~' on offset 33) */
+
+typedef struct {
+  /* Quality trimming (BWA-like, 3'-end) */
+  uint8_t quality_threshold;              // Phred quality (0 disables)
+  gt_qualities_offset_t qualities_offset;
+  /* Adapter clipping (3'-end) */
+  gt_vector* adapters;                    // (gt_string*)
+  uint64_t adapter_min_overlap;
+  double adapter_max_error_rate;          // Mismatches allowed per overlapping base
+  /* Poly-A/N clipping */
+  uint64_t poly_a_min_length;             // Min length of the 3' poly-A tail to be clipped (0 disables)
+  bool trim_n_ends;                       // Clip N-runs at both ends
+} gt_dna_read_trim_attributes;
+
+#define GT_DNA_READ_TRIM_ADAPTER_MIN_OVERLAP 3
+#define GT_DNA_READ_TRIM_ADAPTER_MAX_ERROR_RATE 0.1
+
 /*
  * Checkers
  */
@@ -60,10 +85,58 @@ GT_INLINE char* gt_dna_read_get_qualities(gt_dna_read* const read);
 
 /*
  * Handlers
+ *   The qualities offset is deduced from the qualities range gathered by the parser
+ *   (the qualities are only scanned if the range is unknown)
  */
 GT_INLINE gt_status gt_dna_read_deduce_qualities_offset(gt_dna_read* const read,gt_qualities_offset_t* qualities_offset_type);
+GT_INLINE gt_status gt_qualities_deduce_offset(const uint8_t min_quality,gt_qualities_offset_t* qualities_offset_type);
+
+/*
+ * Line scanners (word-at-a-time)
+ *   Scan @line until the first non-valid character (EOL/EOS for a well-formed line) and return it.
+ *   The qualities scanner also accumulates the min/max quality seen into @min_quality/@max_quality
+ */
+GT_INLINE char* gt_dna_read_scan_read_line(char* const line);
+GT_INLINE char* gt_dna_read_scan_qualities_line(char* const line,uint8_t* const min_quality,uint8_t* const max_quality);
 
-GT_INLINE uint64_t gt_dna_read_quality_trim(gt_dna_read* const read,const uint8_t quality_threshold,const uint64_t min_length); // TODO
+/*
+ * Trimming attributes
+ */
+GT_INLINE gt_dna_read_trim_attributes* gt_dna_read_trim_attributes_new(void);
+GT_INLINE void gt_dna_read_trim_attributes_clear(gt_dna_read_trim_attributes* const trim_attributes);
+GT_INLINE void gt_dna_read_trim_attributes_delete(gt_dna_read_trim_attributes* const trim_attributes);
+GT_INLINE void gt_dna_read_trim_attributes_add_adapter(gt_dna_read_trim_attributes* const trim_attributes,char* const adapter);
+GT_INLINE bool gt_dna_read_trim_attributes_is_active(gt_dna_read_trim_attributes* const trim_attributes);
+
+/*
+ * Trimming kernels (over raw buffers)
+ *   gt_dna_read_get_quality_trim_length() returns the number of 3' bases below @quality_threshold (BWA's -q)
+ *   gt_dna_read_get_adapter_position() returns the leftmost position where @adapter (or a prefix
+ *     of it, at least @min_overlap long) matches the 3'-end of the read. @length if not found
+ *   gt_dna_read_get_poly_a_length() returns the length of the 3' poly-A tail (if >= @min_length)
+ *   gt_dna_read_get_trim_lengths() combines all of them (quality->adapters->poly-A->N-ends)
+ */
+GT_INLINE uint64_t gt_dna_read_get_quality_trim_length(
+    char* const qualities,const uint64_t length,
+    const gt_qualities_offset_t qualities_offset,const uint8_t quality_threshold);
+GT_INLINE uint64_t gt_dna_read_get_adapter_position(
+    char* const read,const uint64_t length,char* const adapter,const uint64_t adapter_length,
+    const uint64_t min_overlap,const double max_error_rate);
+GT_INLINE uint64_t gt_dna_read_get_poly_a_length(char* const read,const uint64_t length,const uint64_t min_length);
+GT_INLINE void gt_dna_read_get_trim_lengths(
+    char* const read,char* const qualities,const uint64_t length,
+    gt_dna_read_trim_attributes* const trim_attributes,uint64_t* const left_trim,uint64_t* const right_trim);
+
+/*
+ * Trimming
+ *   All return the number of bases trimmed. Reads that would end up shorter
+ *   than @min_length are left untouched (returns 0)
+ */
+GT_INLINE uint64_t gt_dna_read_quality_trim(
+    gt_dna_read* const read,const gt_qualities_offset_t qualities_offset,
+    const uint8_t quality_threshold,const uint64_t min_length);
 GT_INLINE uint64_t gt_dna_read_hard_trim(gt_dna_read* const read,const uint64_t length);
+GT_INLINE uint64_t gt_dna_read_trim(
+    gt_dna_read* const read,gt_dna_read_trim_attributes* const trim_attributes,const uint64_t min_length);
 
 #endif /* GT_DNA_READ_H_ */
@@ -0,0 +1,123 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_duplicates.h
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Streaming duplicate detection (PCR & optical) and library complexity estimation
+ *   Duplicates are detected on the fly (no sorting needed) from the 5' end position & strand of
+ *   the first map of each end (and the mate's in case of paired templates). The first template seen
+ *   with a given signature is kept as the original, the following ones are marked as duplicates.
+ */
+
+#ifndef GT_DUPLICATES_H_
+#define GT_DUPLICATES_H_
+
+#include "gt_commons.h"
+#include "gt_map.h"
+#include "gt_alignment.h"
+#include "gt_template.h"
+
+/*
+ * Duplicate status (stored as the GT_ATTR_DUPLICATE attribute of the alignment/template)
+ */
+typedef enum { GT_DUPLICATE_NONE=0, GT_DUPLICATE_PCR=1, GT_DUPLICATE_OPTICAL=2 } gt_duplicate_status;
+#define GT_ATTR_DUPLICATE "DUPLICATE"
+
+/*
+ * Duplicates attributes
+ */
+typedef struct {
+  uint64_t optical_distance; // Max pixel distance between two optical duplicates (same lane & tile)
+  uint64_t max_memory;       // Max memory (bytes) used to keep track of the signatures seen
+} gt_duplicates_attributes;
+#define GT_DUPLICATES_ATTR_DEFAULT() { \
+  .optical_distance=100, \
+  .max_memory=GT_DUPLICATES_DEFAULT_MEMORY \
+}
+
+#define GT_DUPLICATES_DEFAULT_MEMORY (256*1024*1024)
+#define GT_DUPLICATES_HLL_BITS 14  // HyperLogLog sketch of 2^14 registers (used when the tables saturate)
+#define GT_DUPLICATES_HLL_SIZE (1ull<<GT_DUPLICATES_HLL_BITS)
+#define GT_DUPLICATES_STRIPE_BITS 6 // Signatures are split in 2^6 stripes (each with its own table & lock)
+#define GT_DUPLICATES_NUM_STRIPES (1ull<<GT_DUPLICATES_STRIPE_BITS)
+
+/*
+ * Duplicates tracker
+ *   The signatures are kept in open-addressing tables (one per stripe, selected by the top bits of
+ *   the signature) that grow as needed up to the memory budget. Once a table cannot grow anymore,
+ *   new signatures of its stripe are not tracked (duplicates of the tracked ones are still detected),
+ *   the event is reported and the number of distinct signatures is estimated from the HyperLogLog sketch
+ */
+typedef struct {
+  uint64_t signature;
+  uint32_t tile; // (lane<<16 | tile) of the original (0 if unknown)
+  uint32_t x;
+  uint32_t y;
+} gt_duplicates_slot;
+
+typedef struct {
+  /* Signatures table */
+  gt_duplicates_slot* table;
+  uint64_t table_mask;
+  uint64_t table_occupancy;
+  uint64_t table_max_occupancy;
+  /* Counters */
+  uint64_t num_templates;
+  uint64_t num_duplicates;
+  uint64_t num_optical_duplicates;
+  uint64_t num_untracked;
+  pthread_mutex_t mutex;
+} gt_duplicates_stripe;
+
+typedef struct {
+  /* Signatures tables */
+  gt_duplicates_stripe stripes[GT_DUPLICATES_NUM_STRIPES];
+  uint64_t max_table_size; // Max number of slots of each stripe's table
+  /* Complexity sketch (each register is updated under the lock of its stripe) */
+  uint8_t* hll_registers;
+  /* Attributes */
+  uint64_t optical_distance;
+} gt_duplicates;
+
+/*
+ * Setup
+ */
+GT_INLINE gt_duplicates* gt_duplicates_new(gt_duplicates_attributes* const attributes);
+GT_INLINE void gt_duplicates_clear(gt_duplicates* const duplicates);
+GT_INLINE void gt_duplicates_delete(gt_duplicates* const duplicates);
+
+/*
+ * Signatures
+ *   Return false if the alignment/template is not mapped (no signature)
+ */
+GT_INLINE bool gt_duplicates_alignment_signature(gt_alignment* const alignment,uint64_t* const signature);
+GT_INLINE bool gt_duplicates_template_signature(gt_template* const template,uint64_t* const signature);
+
+/*
+ * Duplicate marking (thread safe)
+ *   Sets the GT_ATTR_DUPLICATE attribute and returns the duplicate status
+ */
+GT_INLINE gt_duplicate_status gt_duplicates_mark_alignment(gt_duplicates* const duplicates,gt_alignment* const alignment);
+GT_INLINE gt_duplicate_status gt_duplicates_mark_template(gt_duplicates* const duplicates,gt_template* const template);
+
+GT_INLINE gt_duplicate_status gt_alignment_get_duplicate_status(gt_alignment* const alignment);
+GT_INLINE gt_duplicate_status gt_template_get_duplicate_status(gt_template* const template);
+
+/*
+ * Counters (summed over the stripes)
+ */
+GT_INLINE uint64_t gt_duplicates_get_num_templates(gt_duplicates* const duplicates);
+GT_INLINE uint64_t gt_duplicates_get_num_duplicates(gt_duplicates* const duplicates);
+GT_INLINE uint64_t gt_duplicates_get_num_optical_duplicates(gt_duplicates* const duplicates);
+GT_INLINE uint64_t gt_duplicates_get_num_untracked(gt_duplicates* const duplicates); // Templates not tracked (tables full)
+GT_INLINE uint64_t gt_duplicates_get_memory(gt_duplicates* const duplicates);        // Bytes allocated by the tables
+
+/*
+ * Library complexity
+ *   Number of distinct fragments observed and estimated library size (Lander-Waterman)
+ *     C/X = 1 - exp(-N/X), where N is the number of templates and C the number of distinct ones
+ */
+GT_INLINE uint64_t gt_duplicates_get_num_distinct(gt_duplicates* const duplicates);
+GT_INLINE uint64_t gt_duplicates_estimate_library_size(gt_duplicates* const duplicates);
+
+#endif /* GT_DUPLICATES_H_ */
@@ -149,6 +149,7 @@ extern FILE* gt_error_stream;
 #define GT_ERROR_SYS_MMAP "Could not map file '%s' to memory"
 #define GT_ERROR_SYS_UNMAP "Could not unmap memory"
 #define GT_ERROR_SYS_THREAD "Could not create thread"
+#define GT_ERROR_SYS_THREAD_JOIN "Could not join thread"
 #define GT_ERROR_SYS_MUTEX "Mutex call error"
 #define GT_ERROR_SYS_MUTEX_INIT "Mutex initialization error"
 #define GT_ERROR_SYS_MUTEX_DESTROY "Mutex destroy call error"
@@ -247,6 +248,22 @@ extern FILE* gt_error_stream;
 #define GT_ERROR_PARSE_MAP_MISMS_BAD_CHARACTER "Parsing MAP error(%s:%"PRIu64":%"PRIu64"). Parsing mismatch string, bad character found"
 #define GT_ERROR_PARSE_MAP_MISMS_BAD_MISMS_POS "Parsing MAP error(%s:%"PRIu64":%"PRIu64"). Parsing mismatch string, unsorted mismatches"
 
+/*
+ * Parsing BINARY File format errors
+ */
+// IBP (Input BINARY Parser). General
+#define GT_ERROR_PARSE_BINARY "Parsing BINARY error(%s:%"PRIu64")"
+#define GT_ERROR_PARSE_BINARY_BAD_FILE_FORMAT "Parsing BINARY error(%s:%"PRIu64"). Not a BINARY file"
+#define GT_ERROR_PARSE_BINARY_PREMATURE_EOR "Parsing BINARY error(%s:%"PRIu64"). Premature End-of-record found"
+#define GT_ERROR_PARSE_BINARY_BAD_ESCAPE "Parsing BINARY error(%s:%"PRIu64"). Bad escape sequence found"
+#define GT_ERROR_PARSE_BINARY_BAD_NUMBER_OF_BLOCKS "Parsing BINARY error(%s:%"PRIu64"). Wrong number of blocks"
+#define GT_ERROR_PARSE_BINARY_QUAL_BAD_MODE "Parsing BINARY error(%s:%"PRIu64"). Parsing qualities, bad encoding"
+#define GT_ERROR_PARSE_BINARY_MAP_BAD_SEQ_NAME "Parsing BINARY error(%s:%"PRIu64"). Parsing maps, bad sequence name reference"
+#define GT_ERROR_PARSE_BINARY_MAP_BAD_MISMS "Parsing BINARY error(%s:%"PRIu64"). Parsing maps, bad mismatch type"
+#define GT_ERROR_PARSE_BINARY_MAP_BAD_JUNCTION "Parsing BINARY error(%s:%"PRIu64"). Parsing maps, bad junction type"
+#define GT_ERROR_PARSE_BINARY_MMAP_BAD_MAP_REFERENCE "Parsing BINARY error(%s:%"PRIu64"). Parsing maps, bad map reference"
+#define GT_ERROR_PARSE_BINARY_BAD_SEQ_NAME_DEFINITION "Parsing BINARY error(%s:%"PRIu64"). Bad sequence name definition"
+
 /*
  * Parsing SAM File format errors
  */
@@ -91,7 +91,10 @@ GT_INLINE gt_status gt_gprintf(gt_generic_printer* const generic_printer,const c
     GT_BUFFERED_OUTPUT_FILE_CHECK(buffered_output_file); \
     gt_generic_printer gprinter; \
     gt_generic_new_buffered_output_file_printer(&gprinter,buffered_output_file); \
-    return MODULE_NAME##_g##FUNCTION_NAME(&gprinter,GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS); \
+    GT_PROFILE_START(GT_PROFILE_FORMAT); \
+    register const gt_status error_code = MODULE_NAME##_g##FUNCTION_NAME(&gprinter,GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS); \
+    GT_PROFILE_STOP(GT_PROFILE_FORMAT); \
+    return error_code; \
   }
 
 #endif /* GT_OUTPUT_PRINTER_H_ */
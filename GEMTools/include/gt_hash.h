@@ -3,7 +3,11 @@
  * FILE: gt_hash.c
  * DATE: 2/09/2012
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
- * DESCRIPTION: // TODO
+ * DESCRIPTION: Open-addressing hash tables (integer & string keys)
+ *   Elements are stored in insertion order into blocks of increasing size (4,8,16,...) which are
+ *   never relocated (element references stay valid until clear/delete/sort). The index is a
+ *   power-of-two array of {hash,position} slots solved by linear probing (load factor <= 1/2).
+ *   Clearing keeps all the memory allocated (to be reused by the next record)
  */
 
 #ifndef GT_HASH_H_
@@ -29,6 +33,36 @@ typedef struct {
 GT_INLINE void gt_hash_free_element(void* const element,const gt_hash_element_type element_type);
 GT_INLINE void* gt_hash_copy_element(void* const element,const gt_hash_element_type element_type,const int64_t element_size);
 
+/*
+ * Index (Open addressing)
+ *   @slot->position is 0 (empty), GT_HASH_SLOT_DELETED or the position of the element plus one
+ */
+typedef struct {
+  uint64_t hash;
+  uint64_t position;
+} gt_hash_slot;
+#define GT_HASH_SLOT_DELETED UINT64_MAX
+#define GT_HASH_INDEX_MIN_SIZE 8
+
+/*
+ * Element blocks (Block @b holds GT_HASH_BLOCK_MIN_SIZE<<b elements)
+ */
+#define GT_HASH_BLOCK_MIN_SIZE 4
+#define GT_HASH_MAX_BLOCKS 40
+#define gt_hash_block_num(position) (63-__builtin_clzll(((position)/GT_HASH_BLOCK_MIN_SIZE)+1))
+#define gt_hash_block_offset(position,block_num) ((position)-GT_HASH_BLOCK_MIN_SIZE*((1ull<<(block_num))-1))
+#define gt_hash_block_size(block_num) (GT_HASH_BLOCK_MIN_SIZE<<(block_num))
+
+/*
+ * Hash functions
+ */
+#define gt_hash_integer(key) ({ \
+  register uint64_t __h = (uint64_t)(key); \
+  __h = (__h ^ (__h >> 33)) * 0xFF51AFD7ED558CCDull; \
+  __h = (__h ^ (__h >> 33)) * 0xC4CEB9FE1A85EC53ull; \
+  __h ^ (__h >> 33); })
+GT_INLINE uint64_t gt_hash_string(const char* const key,const uint64_t key_length);
+
 /*
  * Key-specific Hash
  */
@@ -3,30 +3,36 @@
  * FILE: gt_ihash.h
  * DATE: 2/09/2012
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
- * DESCRIPTION: // TODO
+ * DESCRIPTION: Integer key hash (open addressing, see gt_hash.h)
  */
 
 #ifndef GT_IHASH_H_
 #define GT_IHASH_H_
 
 #include "gt_commons.h"
-#include "uthash.h"
 
 /*
  * Integer Key Hash
  */
 typedef struct {
   int64_t key;
-  void* element;
+  void* element; // NULL => Removed
   gt_hash_element_type element_type;
   union {
     size_t element_size;
     gt_hash_element_setup element_setup;
   };
-  UT_hash_handle hh;
 } gt_ihash_element;
 typedef struct {
-  gt_ihash_element* ihash_head;
+  /* Elements (insertion order) */
+  gt_ihash_element* blocks[GT_HASH_MAX_BLOCKS];
+  uint64_t num_blocks;
+  uint64_t elements_used; // Positions taken (including removed elements)
+  uint64_t num_elements;
+  /* Index */
+  gt_hash_slot* index;
+  uint64_t index_size;
+  uint64_t index_occupied; // Slots taken (including deleted slots)
 } gt_ihash;
 
 /*
@@ -64,11 +70,18 @@ GT_INLINE gt_ihash* gt_ihash_dup(gt_ihash* const ihash);
 GT_INLINE void gt_ihash_copy(gt_ihash* const ihash_dst,gt_ihash* const ihash_src);
 
 /*
- * Iterator
+ * Iterator (insertion order)
  */
+#define gt_ihash_get_ihash_element_at(ihash,position) ({ \
+  register const uint64_t __position = (position); \
+  register const uint64_t __block_num = gt_hash_block_num(__position); \
+  (ihash)->blocks[__block_num]+gt_hash_block_offset(__position,__block_num); })
 #define GT_IHASH_BEGIN_ITERATE(ihash,it_ikey,it_element,type) { \
-  gt_ihash_element *ihash_##ih_element, *ihash_##tmp; \
-  HASH_ITER(hh,ihash->ihash_head,ihash_##ih_element,ihash_##tmp) { \
+  register gt_ihash* const ihash_##it = (ihash); \
+  register uint64_t ihash_##position; \
+  for (ihash_##position=0;ihash_##position<ihash_##it->elements_used;++ihash_##position) { \
+    register gt_ihash_element* const ihash_##ih_element = gt_ihash_get_ihash_element_at(ihash_##it,ihash_##position); \
+    if (ihash_##ih_element->element==NULL) continue; \
     register type* const it_element = (type*)(ihash_##ih_element->element); \
     register int64_t const it_ikey = ihash_##ih_element->key;
 #define GT_IHASH_END_ITERATE }}
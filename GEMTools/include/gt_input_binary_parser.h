@@ -0,0 +1,122 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_input_binary_parser.h
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Input parser for the binary packed template format (intermediate files between pipeline steps)
+ */
+
+#ifndef GT_INPUT_BINARY_PARSER_H_
+#define GT_INPUT_BINARY_PARSER_H_
+
+#include "gt_commons.h"
+#include "gt_dna_read.h"
+#include "gt_compact_dna_string.h"
+
+#include "gt_input_file.h"
+#include "gt_buffered_input_file.h"
+#include "gt_input_parser.h"
+
+#include "gt_buffered_output_file.h"
+
+#include "gt_template.h"
+#include "gt_template_utils.h"
+
+// Codes gt_status
+#define GT_IBP_OK   GT_STATUS_OK
+#define GT_IBP_FAIL GT_STATUS_FAIL
+#define GT_IBP_EOF  0
+
+/*
+ * Parsing error/state codes
+ */
+#define GT_IBP_PE_WRONG_FILE_FORMAT 10
+#define GT_IBP_PE_PREMATURE_EOR 20
+#define GT_IBP_PE_BAD_ESCAPE 21
+#define GT_IBP_PE_BAD_NUMBER_OF_BLOCKS 22
+#define GT_IBP_PE_QUAL_BAD_MODE 30
+#define GT_IBP_PE_MAP_BAD_SEQ_NAME 40
+#define GT_IBP_PE_MAP_BAD_MISMS 41
+#define GT_IBP_PE_MAP_BAD_JUNCTION 42
+#define GT_IBP_PE_MMAP_BAD_MAP_REFERENCE 43
+#define GT_IBP_PE_BAD_SEQ_NAME_DEFINITION 50
+
+/*
+ * Binary file format
+ *   One record per line, so blocks can be cut & synchronized line-wise like MAP.
+ *   Sequence name definition: <SEQ_NAME_DEFINITION><Id>\t<SeqName>\n (text)
+ *     Names are interned once per file. A definition always precedes (in file order) the records
+ *     using its id, and the same definition can be repeated (several threads writing the same file)
+ *   Template record: <RECORD_BEGIN><TAG>\t<Payload>\n
+ *     The tag is kept as text (as printed in MAP). The payload bytes are XOR'ed with GT_BINARY_BYTE_MASK
+ *     (so the most frequent bytes, small varints, are never escaped) and then escaped so that
+ *     records never contain EOS/EOL/DOS_EOL
+ *   Payload (varint := LEB128, zigzag := signed varint)
+ *     <NumBlocks>
+ *     Per block: <ReadLength><2-bit packed read><NumExceptions>{<DeltaPos><Char>}<QualsMode>[<Quals>]
+ *     <NumCounters>{<Counter>}<MCS+1><NotUnique>
+ *     Per block: <NumMaps>{<Map>}
+ *       Map := {<SeqNameRef>[<Length><SeqName>]<Position*2+Strand><zigzag(BaseLength-ReadLength)><Score>
+ *               <NumMisms>{<Misms>}<Junction>[<JunctionSize>]}
+ *       SeqNameRef := Id+1 of a defined name | 0 (name given inline)
+ *       Misms := <DeltaPos*8+Code>[<Char>|<Size>] (Code: mismatch to A/C/G/T, mismatch to <Char>, insertion, deletion)
+ *     <NumMMaps>{<MapIdx>*NumBlocks<Distance><Score>}
+ */
+#define GT_BINARY_RECORD_BEGIN ((char)0x01)
+#define GT_BINARY_SEQ_NAME_DEFINITION ((char)0x02)
+#define GT_BINARY_BYTE_MASK 0x80
+#define GT_BINARY_ESCAPE ((char)0x1B)
+#define GT_BINARY_ESCAPE_EOS '0'
+#define GT_BINARY_ESCAPE_EOL 'n'
+#define GT_BINARY_ESCAPE_DOS_EOL 'r'
+#define GT_BINARY_ESCAPE_ESCAPE 'e'
+
+#define GT_BINARY_QUALS_NONE 0
+#define GT_BINARY_QUALS_RAW 1
+#define GT_BINARY_QUALS_BINNED 2
+
+#define GT_BINARY_MISMS_CODE_BITS 3
+#define GT_BINARY_MISMS_BASE 0 /* +{A,C,G,T} */
+#define GT_BINARY_MISMS_CHAR 4
+#define GT_BINARY_MISMS_INS 5
+#define GT_BINARY_MISMS_DEL 6
+
+#define GT_BINARY_MAX_SEQ_NAMES 64 /* Distinct names resolved per record (the rest are given inline) */
+#define GT_BINARY_MAX_SEQ_NAME_LENGTH 256 /* Longer names are always given inline */
+
+/*
+ * Qualities binning (Illumina 8-level)
+ */
+#define GT_BINARY_QUALS_NUM_BINS 8
+extern const uint8_t gt_binary_quals_bin_value[GT_BINARY_QUALS_NUM_BINS];
+extern const uint8_t gt_binary_quals_bin[256];
+
+/*
+ * Binary File basics
+ */
+GT_INLINE bool gt_input_file_test_binary(
+    gt_input_file* const input_file,gt_binary_file_format* const binary_file_format,const bool show_errors);
+GT_INLINE void gt_input_binary_parser_prompt_error(
+    gt_buffered_input_file* const buffered_binary_input,
+    const uint64_t line_num,const gt_status error_code);
+GT_INLINE void gt_input_binary_parser_next_record(gt_buffered_input_file* const buffered_binary_input);
+
+/*
+ * High Level Parsers
+ */
+GT_INLINE gt_status gt_input_binary_parser_get_template(
+    gt_buffered_input_file* const buffered_binary_input,gt_template* const template);
+GT_INLINE gt_status gt_input_binary_parser_get_alignment(
+    gt_buffered_input_file* const buffered_binary_input,gt_alignment* const alignment);
+
+/*
+ * Synch read of blocks
+ */
+GT_INLINE gt_status gt_input_binary_parser_synch_blocks_v(
+    pthread_mutex_t* const input_mutex,uint64_t num_inputs,gt_buffered_input_file* const buffered_input,va_list v_args);
+GT_INLINE gt_status gt_input_binary_parser_synch_blocks_va(
+    pthread_mutex_t* const input_mutex,const uint64_t num_inputs,gt_buffered_input_file* const buffered_input,...);
+GT_INLINE gt_status gt_input_binary_parser_synch_blocks_a(
+    pthread_mutex_t* const input_mutex,gt_buffered_input_file** const buffered_input,const uint64_t num_inputs);
+
+#endif /* GT_INPUT_BINARY_PARSER_H_ */
@@ -15,6 +15,7 @@
 
 #include "gt_input_file.h"
 #include "gt_buffered_input_file.h"
+#include "gt_paired_input_file.h"
 #include "gt_input_parser.h"
 
 // Codes gt_status
@@ -67,6 +68,14 @@ GT_INLINE gt_status gt_input_fasta_parser_get_template(
 
 GT_INLINE gt_status gt_input_multifasta_parser_get_archive(
     gt_input_file* const input_multifasta_file,gt_sequence_archive* const sequence_archive);
+GT_INLINE gt_status gt_input_multifasta_parser_get_archive_parallel(
+    gt_input_file* const input_multifasta_file,gt_sequence_archive* const sequence_archive,const uint64_t num_threads);
+
+/*
+ * Qualities offset (deduced from the qualities range seen while parsing FASTQ records)
+ */
+GT_INLINE gt_status gt_input_fasta_parser_deduce_qualities_offset(
+    gt_buffered_input_file* const buffered_fasta_input,gt_qualities_offset_t* const qualities_offset_type);
 
 /*
  * FASTQ utils
@@ -84,5 +93,9 @@ GT_INLINE gt_status gt_input_fasta_parser_synch_blocks_va(
     pthread_mutex_t* const input_mutex,const uint64_t num_inputs,gt_buffered_input_file* const buffered_input,...);
 GT_INLINE gt_status gt_input_fasta_parser_synch_blocks_a(
     pthread_mutex_t* const input_mutex,gt_buffered_input_file** const buffered_input,const uint64_t num_inputs);
+/* Paired reader (files read concurrently, matched blocks taken without holding a lock while reading) */
+GT_INLINE gt_status gt_input_fasta_parser_synch_paired_blocks(
+    gt_paired_input_file* const paired_input_file,
+    gt_buffered_input_file* const buffered_input_end1,gt_buffered_input_file* const buffered_input_end2);
 
 #endif /* GT_INPUT_FASTA_PARSER_H_ */
@@ -11,6 +11,7 @@
 
 #include "gt_commons.h"
 #include "gt_data_attributes.h"
+#include "gt_profiler.h"
 
 #include <zlib.h>
 #include <bzlib.h>
@@ -31,7 +32,7 @@
 /*
  * GT Input file
  */
-typedef enum { FASTA, MAP, SAM, FILE_FORMAT_UNKNOWN } gt_file_format;
+typedef enum { FASTA, MAP, SAM, BINARY, FILE_FORMAT_UNKNOWN } gt_file_format;
 typedef enum { STREAM, REGULAR_FILE, MAPPED_FILE, GZIPPED_FILE, BZIPPED_FILE } gt_file_type;
 typedef struct {
   /* Input file */
@@ -47,6 +48,7 @@ typedef struct {
     gt_map_file_format map_type;
     gt_fasta_file_format fasta_type;
     gt_sam_headers sam_headers;
+    gt_binary_file_format binary_type;
   };
   pthread_mutex_t input_mutex;
   /* Auxiliary Buffer (for synch purposes) */
@@ -0,0 +1,79 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_inss_model.h
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Streaming & mergeable insert size model (quantiles with bounded relative error by orientation class)
+ *   Insert sizes are the signed ones given by gt_template_get_insert_size() (the same --min-inss/--max-inss
+ *   are checked against). They are accumulated into a log-linear histogram of their magnitude, one for each
+ *   sign (2^GT_INSS_MODEL_PRECISION_BITS linear sub-buckets per power of two). Magnitudes below
+ *   2^GT_INSS_MODEL_PRECISION_BITS are exact, the rest are reported within a relative error of
+ *   2^-(GT_INSS_MODEL_PRECISION_BITS+1). Models are merged adding up counts
+ */
+
+#ifndef GT_INSS_MODEL_H_
+#define GT_INSS_MODEL_H_
+
+#include "gt_commons.h"
+#include "gt_map.h"
+#include "gt_template.h"
+#include "gt_template_utils.h"
+
+/*
+ * Orientation classes (wrt the leftmost end over the reference)
+ *   FR :: Leftmost end on the forward strand, ends pointing inwards (paired-end)
+ *   RF :: Leftmost end on the reverse strand, ends pointing outwards (mate-pair)
+ *   TANDEM :: Both ends on the same strand (counted, but without insert size)
+ */
+typedef enum { GT_INSS_FR=0, GT_INSS_RF=1, GT_INSS_TANDEM=2 } gt_inss_orientation;
+#define GT_INSS_NUM_ORIENTATIONS 3
+
+#define GT_INSS_MODEL_PRECISION_BITS 6
+#define GT_INSS_MODEL_MAX_BITS 40 // Lengths beyond 2^40 are accounted in the last bucket
+#define GT_INSS_MODEL_SUB_BUCKETS (1ull<<GT_INSS_MODEL_PRECISION_BITS)
+#define GT_INSS_MODEL_NUM_BUCKETS ((GT_INSS_MODEL_MAX_BITS-GT_INSS_MODEL_PRECISION_BITS+1)*GT_INSS_MODEL_SUB_BUCKETS)
+
+typedef struct {
+  uint64_t num_samples[GT_INSS_NUM_ORIENTATIONS];
+  uint64_t* histogram[GT_INSS_NUM_ORIENTATIONS]; /* 2*GT_INSS_MODEL_NUM_BUCKETS (negative sizes, then positive ones) */
+  uint64_t num_different_contigs; // Pairs with ends on different sequences (no length)
+  uint64_t num_templates;         // Templates accounted
+  uint64_t max_templates;         // Model computed on the first @max_templates (0 => all)
+} gt_inss_model;
+
+/*
+ * Setup
+ */
+GT_INLINE gt_inss_model* gt_inss_model_new(const uint64_t max_templates);
+GT_INLINE void gt_inss_model_clear(gt_inss_model* const inss_model);
+GT_INLINE void gt_inss_model_delete(gt_inss_model* const inss_model);
+GT_INLINE void gt_inss_model_merge(gt_inss_model* const inss_model_dst,gt_inss_model* const inss_model_src);
+
+/*
+ * Accumulate
+ *   @gt_inss_model_add_mmap() classifies the pair of maps and adds its insert size
+ *   @gt_inss_model_add_template() adds the first mmap of the template (if paired & mapped).
+ *     Returns false once the model is complete (@max_templates reached)
+ */
+GT_INLINE void gt_inss_model_add(gt_inss_model* const inss_model,const gt_inss_orientation orientation,const int64_t insert_size);
+GT_INLINE void gt_inss_model_add_mmap(gt_inss_model* const inss_model,gt_map** const mmap);
+GT_INLINE bool gt_inss_model_add_template(gt_inss_model* const inss_model,gt_template* const template);
+GT_INLINE bool gt_inss_model_is_complete(gt_inss_model* const inss_model);
+
+/*
+ * Queries
+ *   @gt_inss_model_get_dominant_orientation() returns the class (FR or RF) with more insert sizes
+ *   @gt_inss_model_get_quantile() returns the @quantile (in [0,1]) of the insert size of
+ *     the given orientation class (0 if no insert sizes)
+ */
+GT_INLINE uint64_t gt_inss_model_get_num_samples(gt_inss_model* const inss_model,const gt_inss_orientation orientation);
+GT_INLINE gt_inss_orientation gt_inss_model_get_dominant_orientation(gt_inss_model* const inss_model);
+GT_INLINE int64_t gt_inss_model_get_quantile(
+    gt_inss_model* const inss_model,const gt_inss_orientation orientation,const double quantile);
+
+/*
+ * Printers
+ */
+GT_INLINE void gt_inss_model_print(FILE* stream,gt_inss_model* const inss_model);
+
+#endif /* GT_INSS_MODEL_H_ */
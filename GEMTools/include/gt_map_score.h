@@ -3,30 +3,74 @@
  * FILE: gt_map_score.h
  * DATE: 03/09/2012
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
- * DESCRIPTION: // TODO
+ * DESCRIPTION: Map scoring functions (MAPQ computed on the fly out of the counters and the maps' content)
  */
 
 #ifndef GT_MAP_SCORE_H_
 #define GT_MAP_SCORE_H_
 
+#include "gt_commons.h"
+#include "gt_dna_read.h"
+#include "gt_map.h"
+#include "gt_alignment.h"
+#include "gt_template.h"
+
 typedef struct {
   // TODO
 } gt_map_cmp_fx;
 
-
 /*
- * fx(MAP) Scoring functions
+ * MAPQ attributes (Phred scaled penalties)
  */
+typedef struct {
+  /* Penalties */
+  uint64_t mismatch_penalty;      // Mismatch penalty (no qualities available) & penalty per strata (hits not listed)
+  uint64_t max_mismatch_quality;  // Mismatch penalty is the base quality, capped to this value
+  uint64_t gap_open_penalty;      // Indel penalty (first base)
+  uint64_t gap_extension_penalty; // Indel penalty (each additional base)
+  gt_qualities_offset_t qualities_offset;
+  /* MAPQ */
+  uint64_t max_mapq;
+} gt_map_score_attributes;
+#define GT_MAP_SCORE_ATTR_DEFAULT() { \
+   /* Penalties */ \
+  .mismatch_penalty=30, \
+  .max_mismatch_quality=40, \
+  .gap_open_penalty=30, \
+  .gap_extension_penalty=10, \
+  .qualities_offset=GT_QUALS_OFFSET_33, \
+   /* MAPQ */ \
+  .max_mapq=60 \
+}
+
+#define GT_MAP_SCORE_MAX_PHRED 99     // Weights beyond this penalty are considered null
+#define GT_MAP_SCORE_MAX_STRATA 64    // Strata beyond this one are accounted in the last one
 
+GT_INLINE gt_map_score_attributes* gt_map_score_attributes_new();
+GT_INLINE void gt_map_score_attributes_delete(gt_map_score_attributes* const attributes);
+GT_INLINE void gt_map_score_attributes_reset_defaults(gt_map_score_attributes* const attributes);
 
 /*
  * fx(ALIGNMENT,MAP) Scoring functions
+ *   Phred penalty of the map (mismatches weighted by the base quality, indels as affine gaps)
  */
+GT_INLINE uint64_t gt_map_score_get_phred_penalty(
+    gt_alignment* const alignment,gt_map* const map,gt_map_score_attributes* const attributes);
 
+/*
+ * fx(ALIGNMENT) Scoring functions
+ *   Computes the MAPQ of each map and stores it as the map score. Returns the MAPQ of the best map
+ *   MAPQ = -10*log10(1-P(map)), where P(map) = w(map)/SUM(w(hits)) and w(hit) = 10^(-penalty(hit)/10)
+ *     (hits counted but not listed are penalised w.r.t. the best hit by their strata distance;
+ *      hits beyond the max-complete-strata are accounted as a pseudo-hit at the first non-complete strata)
+ */
+GT_INLINE uint64_t gt_map_score_alignment_mapq(gt_alignment* const alignment,gt_map_score_attributes* const attributes);
 
 /*
  * fx(TEMPLATE) Scoring functions
+ *   Computes the MAPQ of each mmap (stored as the mmap score). Each end map gets the best MAPQ
+ *   of the mmaps it belongs to. Unpaired templates are scored as independent alignments
  */
-
+GT_INLINE uint64_t gt_map_score_template_mapq(gt_template* const template,gt_map_score_attributes* const attributes);
 
 #endif /* GT_MAP_SCORE_H_ */
@@ -0,0 +1,57 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_output_binary.h
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Output printers to the binary packed template format (see gt_input_binary_parser.h)
+ */
+
+#ifndef GT_OUTPUT_BINARY_H_
+#define GT_OUTPUT_BINARY_H_
+
+#include "gt_commons.h"
+#include "gt_dna_read.h"
+#include "gt_template.h"
+#include "gt_output_buffer.h"
+#include "gt_buffered_output_file.h"
+#include "gt_generic_printer.h"
+#include "gt_input_binary_parser.h"
+#include "gt_output_map.h"
+
+/*
+ * Output attributes
+ *   The sequence names dictionary is shared by all the threads writing the same file
+ *   (use one attributes object per output file, or reset it between files)
+ */
+typedef struct {
+  uint64_t seq_name_id;
+  uint64_t block_id; // First block (in file order) defining the name
+} gt_output_binary_seq_name;
+typedef struct {
+  /* QUALITIES */
+  bool bin_qualities; // Store qualities binned (Illumina 8-level, lossy)
+  gt_qualities_offset_t qualities_offset;
+  /* SEQUENCE NAMES */
+  gt_shash* seq_names; // (gt_output_binary_seq_name)
+  uint64_t num_seq_names;
+  pthread_mutex_t seq_names_mutex;
+} gt_output_binary_attributes;
+
+GT_INLINE gt_output_binary_attributes* gt_output_binary_attributes_new();
+GT_INLINE void gt_output_binary_attributes_delete(gt_output_binary_attributes* const attributes);
+GT_INLINE void gt_output_binary_attributes_reset_defaults(gt_output_binary_attributes* const attributes);
+
+GT_INLINE bool gt_output_binary_attributes_is_bin_qualities(gt_output_binary_attributes* const attributes);
+GT_INLINE void gt_output_binary_attributes_set_bin_qualities(gt_output_binary_attributes* const attributes,const bool bin_qualities);
+GT_INLINE gt_qualities_offset_t gt_output_binary_attributes_get_qualities_offset(gt_output_binary_attributes* const attributes);
+GT_INLINE void gt_output_binary_attributes_set_qualities_offset(gt_output_binary_attributes* const attributes,const gt_qualities_offset_t qualities_offset);
+GT_INLINE uint64_t gt_output_binary_attributes_get_num_seq_names(gt_output_binary_attributes* const attributes);
+
+/*
+ * High-level BINARY Printers {Alignment/Template}
+ *   (Maps must be fully parsed)
+ */
+GT_GENERIC_PRINTER_PROTOTYPE(gt_output_binary,print_template,gt_template* const template,gt_output_binary_attributes* const output_binary_attributes);
+GT_GENERIC_PRINTER_PROTOTYPE(gt_output_binary,print_alignment,gt_alignment* const alignment,gt_output_binary_attributes* const output_binary_attributes);
+
+#endif /* GT_OUTPUT_BINARY_H_ */
@@ -11,6 +11,7 @@
 
 #include "gt_commons.h"
 #include "gt_output_buffer.h"
+#include "gt_profiler.h"
 
 #define GT_MAX_OUTPUT_BUFFERS 20
 
@@ -27,6 +28,9 @@ typedef struct {
   /* Block ID (for synchronization purposes) */
   uint32_t mayor_block_id;
   uint32_t minor_block_id;
+  /* Write errors (fatal unless @fatal_write_error is cleared) */
+  bool fatal_write_error;
+  bool write_error;
   /* Mutexes */
   pthread_cond_t  out_buffer_cond;
   pthread_cond_t  out_write_cond;
@@ -58,6 +62,14 @@ gt_output_file* gt_output_stream_new(FILE* const file,const gt_output_file_type
 gt_output_file* gt_output_file_new(char* const file_name,const gt_output_file_type output_file_type);
 gt_status gt_output_file_close(gt_output_file* const output_file);
 
+/*
+ * Write errors
+ *   By default a failed write is a fatal error. Otherwise, the error is recorded (further
+ *   output is discarded) and reported by @gt_output_file_has_write_error & @gt_output_file_close
+ */
+GT_INLINE void gt_output_file_set_fatal_write_error(gt_output_file* const output_file,const bool fatal_write_error);
+GT_INLINE bool gt_output_file_has_write_error(gt_output_file* const output_file);
+
 /*
  * Output File Printers
  */
@@ -0,0 +1,76 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_paired_input_file.h
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Paired reader of two synchronized files (end/1,end/2)
+ *   Each file is read by its own I/O thread, which cuts it into blocks of the same number of lines.
+ *   Matched block pairs are handed to the workers through a bounded queue (no lock held while reading)
+ */
+
+#ifndef GT_PAIRED_INPUT_FILE_H_
+#define GT_PAIRED_INPUT_FILE_H_
+
+#include "gt_commons.h"
+#include "gt_input_file.h"
+#include "gt_buffered_input_file.h"
+
+// Codes gt_status
+#define GT_PIF_OK 1
+#define GT_PIF_FAIL -1
+#define GT_PIF_EOF 0
+
+// Defaults
+#define GT_PIF_NUM_LINES (4/*4_lines_per_record*/*GT_NUM_LINES_10K)
+#define GT_PIF_NUM_BLOCKS 8
+
+typedef struct {
+  gt_vector* block_buffer;
+  uint64_t lines_in_buffer;
+  uint64_t first_line_num;
+} gt_paired_input_block;
+
+typedef struct {
+  /* Input files */
+  gt_input_file* input_file[2];
+  uint64_t num_lines;
+  /* Queue of blocks (per end) */
+  gt_paired_input_block* blocks[2];
+  uint64_t num_blocks;
+  uint64_t blocks_filled[2];
+  uint64_t blocks_consumed;
+  bool closing;
+  pthread_mutex_t queue_mutex;
+  pthread_cond_t block_ready_cond;
+  pthread_cond_t block_free_cond;
+  /* I/O threads */
+  pthread_t reader_thread[2];
+} gt_paired_input_file;
+
+/*
+ * Checkers
+ */
+#define GT_PAIRED_INPUT_FILE_CHECK(paired_input_file) \
+  GT_NULL_CHECK(paired_input_file); \
+  GT_INPUT_FILE_CHECK(paired_input_file->input_file[0]); \
+  GT_INPUT_FILE_CHECK(paired_input_file->input_file[1])
+
+/*
+ * Paired Input File Handlers
+ *   (The input files are only read by the I/O threads, and not closed by the paired reader)
+ */
+gt_paired_input_file* gt_paired_input_file_new(
+    gt_input_file* const input_file_end1,gt_input_file* const input_file_end2,
+    const uint64_t num_lines,const uint64_t num_blocks);
+gt_status gt_paired_input_file_close(gt_paired_input_file* const paired_input_file);
+
+/*
+ * Get the next pair of matched blocks (thread-safe)
+ *   The blocks are swapped into @buffered_input_end1/@buffered_input_end2 (no copy).
+ *   Returns GT_PIF_FAIL if the files have different number of lines (not synchronized)
+ */
+GT_INLINE gt_status gt_paired_input_file_get_blocks(
+    gt_paired_input_file* const paired_input_file,
+    gt_buffered_input_file* const buffered_input_end1,gt_buffered_input_file* const buffered_input_end2);
+
+#endif /* GT_PAIRED_INPUT_FILE_H_ */
@@ -0,0 +1,104 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_profiler.h
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Low-overhead per-thread profiling of the I/O pipeline (block fetch, parse, process, format, output)
+ *   Each thread accounts its time into its own counters (no locking in the hot path). Timers nest,
+ *   and only the exclusive time is charged to each stage (e.g. a block fetched from within the parser
+ *   is charged to INPUT_FETCH, not to PARSE). The time elapsed between instrumented sections is
+ *   charged to PROCESS. Disabled by default (the cost is then a single branch per hook)
+ */
+
+#ifndef GT_PROFILER_H_
+#define GT_PROFILER_H_
+
+#include "gt_commons.h"
+
+/*
+ * Pipeline stages
+ *   INPUT_WAIT :: Waiting for the input lock (or for a block from the reader threads)
+ *   INPUT_FETCH :: Reading a block from the input file (holding the input lock)
+ *   PARSE :: Parsing records
+ *   PROCESS :: Time spent by the tool itself (between instrumented sections)
+ *   FORMAT :: Printing records into the output buffers
+ *   OUTPUT_WAIT :: Waiting for a free output buffer (or for the turn to write in sorted output)
+ *   OUTPUT_WRITE :: Writing buffers to the output file
+ */
+typedef enum {
+  GT_PROFILE_INPUT_WAIT=0, GT_PROFILE_INPUT_FETCH=1, GT_PROFILE_PARSE=2, GT_PROFILE_PROCESS=3,
+  GT_PROFILE_FORMAT=4, GT_PROFILE_OUTPUT_WAIT=5, GT_PROFILE_OUTPUT_WRITE=6
+} gt_profile_stage;
+#define GT_PROFILE_NUM_STAGES 7
+#define GT_PROFILE_MAX_DEPTH 16
+
+extern const char* const gt_profile_stage_label[GT_PROFILE_NUM_STAGES];
+
+typedef struct _gt_profile gt_profile;
+struct _gt_profile {
+  /* Timers (ns) */
+  uint64_t time[GT_PROFILE_NUM_STAGES];
+  uint64_t calls[GT_PROFILE_NUM_STAGES];
+  /* Counters */
+  uint64_t num_records;
+  uint64_t num_blocks;
+  uint64_t bytes_in;
+  uint64_t bytes_out;
+  /* Timers stack */
+  gt_profile_stage stack[GT_PROFILE_MAX_DEPTH];
+  uint64_t depth;
+  uint64_t last_timestamp; // Last time accounted (0 before the first section)
+  uint64_t first_timestamp;
+  /* Registered profiles */
+  gt_profile* next;
+};
+
+/*
+ * Global switch
+ */
+extern bool gt_profile_enabled;
+
+/*
+ * Hooks
+ */
+#define GT_PROFILE_START(stage) \
+  do { if (gt_expect_false(gt_profile_enabled)) gt_profile_start(stage); } while (0)
+#define GT_PROFILE_STOP(stage) \
+  do { if (gt_expect_false(gt_profile_enabled)) gt_profile_stop(stage); } while (0)
+#define GT_PROFILE_ADD_RECORD(error_code) \
+  do { \
+    if (gt_expect_false(gt_profile_enabled) && (error_code)==GT_STATUS_OK) ++(gt_profile_get_local()->num_records); \
+  } while (0)
+#define GT_PROFILE_ADD_BLOCK(num_bytes) \
+  do { if (gt_expect_false(gt_profile_enabled)) gt_profile_add_block(num_bytes); } while (0)
+#define GT_PROFILE_ADD_BYTES_OUT(num_bytes) \
+  do { if (gt_expect_false(gt_profile_enabled)) gt_profile_get_local()->bytes_out += (num_bytes); } while (0)
+
+/*
+ * Setup
+ *   Profiles of all threads are kept (so they can be reported once the threads are done)
+ *   until @gt_profile_destroy() frees them. Threads accounting afterwards get new profiles
+ */
+GT_INLINE void gt_profile_enable(const bool enabled);
+GT_INLINE void gt_profile_reset();
+GT_INLINE void gt_profile_destroy();
+
+/*
+ * Accounting (current thread)
+ */
+GT_INLINE gt_profile* gt_profile_get_local();
+GT_INLINE void gt_profile_start(const gt_profile_stage stage);
+GT_INLINE void gt_profile_stop(const gt_profile_stage stage);
+GT_INLINE void gt_profile_add_block(const uint64_t num_bytes);
+
+/*
+ * Reports
+ *   @gt_profile_get_totals() adds up the profiles of all threads into @profile
+ *     (and returns the wall time in ns from the first to the last section accounted)
+ */
+GT_INLINE uint64_t gt_profile_get_num_threads();
+GT_INLINE gt_profile* gt_profile_get_thread(const uint64_t thread_num);
+GT_INLINE uint64_t gt_profile_get_totals(gt_profile* const profile);
+GT_INLINE void gt_profile_print(FILE* stream);
+
+#endif /* GT_PROFILER_H_ */
@@ -47,7 +47,7 @@ typedef struct {
 
 typedef struct {
   gt_sequence_archive* sequence_archive;
-  gt_shash_element *shash_it;
+  uint64_t shash_position;
 } gt_sequence_archive_iterator;
 
 /*
@@ -124,6 +124,14 @@ GT_INLINE void gt_segmented_sequence_append_string(gt_segmented_sequence* const
 
 GT_INLINE gt_status gt_segmented_sequence_get_sequence(
     gt_segmented_sequence* const sequence,const uint64_t position,const uint64_t length,gt_string* const string);
+/*
+ * SegmentedSEQ Parallel encoding
+ *   Appends @strings[i] (@lengths[i] chars) to @sequences[i] for every i<@num_sequences,
+ *   splitting the encoding of the segmented blocks among @num_threads threads
+ */
+GT_INLINE void gt_segmented_sequence_append_strings_parallel(
+    gt_segmented_sequence** const sequences,char** const strings,uint64_t* const lengths,
+    const uint64_t num_sequences,const uint64_t num_threads);
 /*
  * SegmentedSEQ Iterator
  */
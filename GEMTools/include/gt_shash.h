@@ -3,30 +3,42 @@
  * FILE: gt_shash.h
  * DATE: 10/07/2012
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
- * DESCRIPTION: // TODO
+ * DESCRIPTION: String key hash (open addressing, see gt_hash.h)
+ *   Keys shorter than GT_SHASH_KEY_INLINE_LENGTH are stored within the element (no allocation)
  */
 
 #ifndef GT_SHASH_H_
 #define GT_SHASH_H_
 
 #include "gt_commons.h"
-#include "uthash.h"
+
+#define GT_SHASH_KEY_INLINE_LENGTH 24
 
 /*
  * String Key Hash
  */
 typedef struct {
   char* key;
-  void* element;
+  void* element; // NULL => Removed
   gt_hash_element_type element_type;
   //union {
     size_t element_size;
     gt_hash_element_setup element_setup;
   //};
-  UT_hash_handle hh;
+  uint64_t hash;
+  uint64_t key_length;
+  char key_buffer[GT_SHASH_KEY_INLINE_LENGTH];
 } gt_shash_element;
 typedef struct {
-  gt_shash_element* shash_head;
+  /* Elements (insertion order) */
+  gt_shash_element* blocks[GT_HASH_MAX_BLOCKS];
+  uint64_t num_blocks;
+  uint64_t elements_used; // Positions taken (including removed elements)
+  uint64_t num_elements;
+  /* Index */
+  gt_hash_slot* index;
+  uint64_t index_size;
+  uint64_t index_occupied; // Slots taken (including deleted slots)
 } gt_shash;
 
 /*
@@ -60,27 +72,38 @@ GT_INLINE uint64_t gt_shash_get_num_elements(gt_shash* const shash);
 
 /*
  * Miscellaneous
+ *   @gt_shash_sort() sorts the elements by key (iteration order). Elements are relocated
+ *     (previous gt_shash_element/key references are no longer valid)
  */
 GT_INLINE gt_shash* gt_shash_dup(gt_shash* const shash);
 GT_INLINE void gt_shash_copy(gt_shash* const shash_dst,gt_shash* const shash_src);
+GT_INLINE void gt_shash_sort(gt_shash* const shash,int (*key_cmp_fx)(char*,char*));
 
 /*
- * Iterator
+ * Iterator (insertion order)
  */
+#define gt_shash_get_shash_element_at(shash,position) ({ \
+  register const uint64_t __position = (position); \
+  register const uint64_t __block_num = gt_hash_block_num(__position); \
+  (shash)->blocks[__block_num]+gt_hash_block_offset(__position,__block_num); })
+#define GT_SHASH_BEGIN_ITERATE_ELEMENTS_(shash) \
+  register gt_shash* const shash_##it = (shash); \
+  register uint64_t shash_##position; \
+  for (shash_##position=0;shash_##position<shash_##it->elements_used;++shash_##position) { \
+    register gt_shash_element* const shash_##sh_element = gt_shash_get_shash_element_at(shash_##it,shash_##position); \
+    if (shash_##sh_element->element==NULL) continue;
+
 #define GT_SHASH_BEGIN_ITERATE(shash,it_skey,it_element,type) { \
-  gt_shash_element *shash_##sh_element, *shash_##tmp; \
-  HASH_ITER(hh,shash->shash_head,shash_##sh_element,shash_##tmp) { \
+  GT_SHASH_BEGIN_ITERATE_ELEMENTS_(shash) \
     register type* const it_element = (type*)(shash_##sh_element->element); \
     register char* const it_skey = shash_##sh_element->key;
 
 #define GT_SHASH_BEGIN_ELEMENT_ITERATE(shash,it_element,type) { \
-  gt_shash_element *shash_##sh_element, *shash_##tmp; \
-  HASH_ITER(hh,shash->shash_head,shash_##sh_element,shash_##tmp) { \
+  GT_SHASH_BEGIN_ITERATE_ELEMENTS_(shash) \
     register type* const it_element = (type*)(shash_##sh_element->element);
 
 #define GT_SHASH_BEGIN_KEY_ITERATE(shash,it_skey,type) { \
-  gt_shash_element *shash_##sh_element, *shash_##tmp; \
-  HASH_ITER(hh,shash->shash_head,shash_##sh_element,shash_##tmp) { \
+  GT_SHASH_BEGIN_ITERATE_ELEMENTS_(shash) \
     register char* const it_skey = shash_##sh_element->key;
 
 #define GT_SHASH_END_ITERATE }}
@@ -13,6 +13,8 @@
 #include "gt_compact_dna_string.h"
 #include "gt_alignment_utils.h"
 #include "gt_template_utils.h"
+#include "gt_duplicates.h"
+#include "gt_inss_model.h"
 
 /*
  * Range Definition
@@ -114,12 +116,15 @@
 
 #define GT_STATS_MISMS_1_CONTEXT_RANGE ((GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE)*GT_STATS_MISMS_BASE_RANGE)
 #define GT_STATS_MISMS_2_CONTEXT_RANGE ((GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE)*GT_STATS_MISMS_BASE_RANGE)
-#define GT_STATS_INDEL_TRANSITION_1_RANGE ((GT_STATS_MISMS_BASE_RANGE))  /* TODO */
-#define GT_STATS_INDEL_TRANSITION_2_RANGE ((GT_STATS_MISMS_BASE_RANGE))  /* TODO */
-#define GT_STATS_INDEL_TRANSITION_3_RANGE ((GT_STATS_MISMS_BASE_RANGE))  /* TODO */
-#define GT_STATS_INDEL_TRANSITION_4_RANGE ((GT_STATS_MISMS_BASE_RANGE))  /* TODO */
-#define GT_STATS_INDEL_1_CONTEXT           (GT_STATS_MISMS_BASE_RANGE)   /* TODO */
-#define GT_STATS_INDEL_2_CONTEXT           (GT_STATS_MISMS_BASE_RANGE)   /* TODO */
+#define GT_STATS_INDEL_TRANSITION_1_RANGE (GT_STATS_MISMS_BASE_RANGE)
+#define GT_STATS_INDEL_TRANSITION_2_RANGE (GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE)
+#define GT_STATS_INDEL_TRANSITION_3_RANGE (GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE)
+#define GT_STATS_INDEL_TRANSITION_4_RANGE (GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE)
+#define GT_STATS_INDEL_1_CONTEXT          (GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE)
+#define GT_STATS_INDEL_2_CONTEXT          (GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE)
+
+#define GT_STATS_INDEL_LENGTH_RANGE 51      /* [1,50) + [50,inf) */
+#define GT_STATS_INDEL_HOMOPOLYMER_RANGE 16 /* [0,15) + [15,inf) */
 
 /*
  * Handy Functions
@@ -155,18 +160,32 @@ typedef struct {
   // Insert Size Distribution
   uint64_t *inss;               /* GT_STATS_INSS_RANGE */
   uint64_t *inss_fine_grain;    /* GT_STATS_INSS_FG_RANGE */
+  gt_inss_model* inss_model;    // Fragment length quantiles by orientation (first mmap of each template)
   // Mismatch/Errors bases
   uint64_t *misms_transition;   /* GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_RANGE */
   uint64_t *qual_score_misms;   /* GT_STATS_QUAL_SCORE_RANGE */
   uint64_t *misms_1context;     /* GT_STATS_MISMS_1_CONTEXT_RANGE */
   uint64_t *misms_2context;     /* GT_STATS_MISMS_2_CONTEXT_RANGE */
+  uint64_t *qual_score_errors;  /* GT_STATS_QUAL_SCORE_RANGE */
+  /*
+   * Indel Profile (reference-aware, trims excluded)
+   *   @indel_transition_N :: Bases of the indels of length N (INS bases taken from the reference, DEL from the read)
+   *   @indel_1context, @indel_2context :: Single-base indels along with 1/2 reference bases each side
+   *   @*_homopolymer :: Length of the reference homopolymer run flanking the indel (0 if the indel doesn't extend one)
+   */
+  uint64_t total_insertions;
+  uint64_t total_deletions;
+  uint64_t *insertion_event_length; /* GT_STATS_INDEL_LENGTH_RANGE */
+  uint64_t *deletion_event_length;  /* GT_STATS_INDEL_LENGTH_RANGE */
+  uint64_t *insertion_homopolymer;  /* GT_STATS_INDEL_HOMOPOLYMER_RANGE */
+  uint64_t *deletion_homopolymer;   /* GT_STATS_INDEL_HOMOPOLYMER_RANGE */
+  uint64_t *indel_position;         /* GT_STATS_LARGE_READ_POS_RANGE */
   uint64_t *indel_transition_1; /* GT_STATS_INDEL_TRANSITION_1_RANGE */
   uint64_t *indel_transition_2; /* GT_STATS_INDEL_TRANSITION_2_RANGE */
   uint64_t *indel_transition_3; /* GT_STATS_INDEL_TRANSITION_3_RANGE */
   uint64_t *indel_transition_4; /* GT_STATS_INDEL_TRANSITION_4_RANGE */
   uint64_t *indel_1context;     /* GT_STATS_INDEL_1_CONTEXT */
   uint64_t *indel_2context;     /* GT_STATS_INDEL_2_CONTEXT */
-  uint64_t *qual_score_errors;  /* GT_STATS_QUAL_SCORE_RANGE */
 } gt_maps_profile; // TODO Called map profile
 
 typedef struct {
@@ -213,6 +232,9 @@ typedef struct {
   uint64_t *mmap; /* GT_STATS_MMAP_RANGE */
   // Uniq Distribution
   uint64_t *uniq; /* GT_STATS_UNIQ_RANGE */
+  // Duplicates (templates previously marked, see gt_duplicates_mark_template)
+  uint64_t num_duplicates;
+  uint64_t num_optical_duplicates;
   // Error Profile
   gt_maps_profile *maps_profile;
   // Split maps info
@@ -223,7 +245,7 @@ typedef struct {
   bool best_map;
   bool nucleotide_stats;
   bool maps_profile;
-  bool indel_profile; // TODO
+  bool indel_profile; // Requires the reference (@seq_archive)
   bool split_map_stats;
 } gt_stats_analysis;
 
@@ -269,9 +291,14 @@ GT_INLINE void gt_stats_print_junction_position_distribution(FILE* stream,uint64
 GT_INLINE void gt_stats_print_qualities_error_distribution(FILE* stream,uint64_t* const qualities_error,uint64_t const total_error);
 GT_INLINE void gt_stats_print_misms_transition_table(FILE* stream,uint64_t* const misms_trans,uint64_t const total_misms);
 GT_INLINE void gt_stats_print_misms_transition_table_1context(FILE* stream,uint64_t* const misms_trans,uint64_t const total_misms);
+GT_INLINE void gt_stats_print_indel_length_distribution(FILE* stream,uint64_t* const indel_length,uint64_t const total_indels);
+GT_INLINE void gt_stats_print_indel_homopolymer_distribution(FILE* stream,uint64_t* const indel_homopolymer,uint64_t const total_indels);
+GT_INLINE void gt_stats_print_indel_transition_table_1context(FILE* stream,uint64_t* const indel_1context,uint64_t const total_indels);
 
 GT_INLINE void gt_stats_print_split_maps_stats(FILE* stream,gt_stats* const stats,const bool paired_end);
 GT_INLINE void gt_stats_print_maps_stats(FILE* stream, gt_stats* const stats,const uint64_t num_reads,const bool paired_end);
+GT_INLINE void gt_stats_print_indel_stats(FILE* stream,gt_stats* const stats);
+GT_INLINE void gt_stats_print_duplicates_stats(FILE* stream,gt_stats* const stats,gt_duplicates* const duplicates);
 GT_INLINE void gt_stats_print_general_stats(FILE* stream,gt_stats* const stats,const uint64_t num_reads,const bool paired_end);
 
 #endif /* GT_STATS_H_ */
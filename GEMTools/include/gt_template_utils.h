@@ -125,4 +125,7 @@ GT_INLINE void gt_template_realign_weighted(
  * Template trimming
  */
 GT_INLINE void gt_template_trim(gt_template* const template, uint64_t const left, uint64_t const right, uint64_t const min_length, bool const set_extra);
+GT_INLINE void gt_template_auto_trim(
+    gt_template* const template,gt_dna_read_trim_attributes* const trim_attributes,
+    uint64_t const min_length,bool const set_extra); // Quality/Adapter/Poly-A/N trimming
 #endif /* GT_TEMPLATE_UTILS_H_ */
@@ -57,7 +57,7 @@ GT_INLINE gt_status gt_merge_map_read_template_sync(
   } while (true);
 }
 
-GT_INLINE void gt_merge_synch_map_files_(
+GT_INLINE gt_status gt_merge_synch_map_files_(
     pthread_mutex_t* const input_mutex,const bool paired_end,gt_buffered_output_file* const buffered_output_file,
     gt_buffered_input_file** const buffered_input_file,const uint64_t num_files) {
   GT_NULL_CHECK(input_mutex);
@@ -75,29 +75,38 @@ GT_INLINE void gt_merge_synch_map_files_(
   // Merge loop
   gt_map_parser_attr map_parser_attr = GT_MAP_PARSER_ATTR_DEFAULT(paired_end);
   gt_output_map_attributes output_attributes = GT_OUTPUT_MAP_ATTR_DEFAULT();
-  register gt_status error_code_master, error_code_slave;
-  while (gt_input_map_parser_synch_blocks_a(input_mutex,buffered_input_file,num_files,&map_parser_attr)) {
+  register gt_status error_code = GT_STATUS_OK, error_code_master, error_code_slave;
+  while (error_code==GT_STATUS_OK) {
+    // Read synch blocks
+    error_code_master=gt_input_map_parser_synch_blocks_a(input_mutex,buffered_input_file,num_files,&map_parser_attr);
+    if (error_code_master==GT_IMP_EOF) break;
+    if (error_code_master==GT_IMP_FAIL) {
+      gt_error_msg("Fatal error synchronizing files");
+      error_code = GT_STATUS_FAIL; break;
+    }
     // Read master (always guaranteed)
     if ((error_code_master=gt_input_map_parser_get_template(buffered_input_file[0],template[0]))==GT_IMP_FAIL) {
-      gt_fatal_error_msg("Fatal error parsing file Master::%s",buffered_input_file[0]->input_file->file_name);
+      gt_error_msg("Fatal error parsing file Master::%s",buffered_input_file[0]->input_file->file_name);
+      error_code = GT_STATUS_FAIL; break;
     }
-    for (i=1;i<num_files;++i) {
+    for (i=1;i<num_files && error_code==GT_STATUS_OK;++i) {
       // Read slave
       if ((error_code_slave=gt_input_map_parser_get_template(buffered_input_file[i],template[i]))==GT_IMP_FAIL) {
-        gt_fatal_error_msg("Fatal error parsing file Slave::%s",buffered_input_file[i]->input_file->file_name);
-      }
-      if (error_code_master!=error_code_slave) {
-        gt_fatal_error_msg("<<Slave>> contains more/different reads from <<Master>>, ('%s','%s')",
+        gt_error_msg("Fatal error parsing file Slave::%s",buffered_input_file[i]->input_file->file_name);
+        error_code = GT_STATUS_FAIL;
+      } else if (error_code_master!=error_code_slave) {
+        gt_error_msg("<<Slave>> contains more/different reads from <<Master>>, ('%s','%s')",
             buffered_input_file[0]->input_file->file_name,buffered_input_file[i]->input_file->file_name);
-      }
-      // Check tags
-      if (!gt_string_equals(template[0]->tag,template[i]->tag)) {
-        gt_fatal_error_msg("Files are not synchronized ('%s','%s')\n"
+        error_code = GT_STATUS_FAIL;
+      } else if (!gt_string_equals(template[0]->tag,template[i]->tag)) { // Check tags
+        gt_error_msg("Files are not synchronized ('%s','%s')\n"
             "\tDifferent TAGs found '"PRIgts"' '"PRIgts"' ",
             buffered_input_file[0]->input_file->file_name,buffered_input_file[i]->input_file->file_name,
             PRIgts_content(template[0]->tag),PRIgts_content(template[i]->tag));
+        error_code = GT_STATUS_FAIL;
       }
     }
+    if (error_code!=GT_STATUS_OK) break;
     // Merge maps
     register gt_template *ptemplate = gt_template_union_template_mmaps_a(template,num_files);
     gt_output_map_bofprint_template(buffered_output_file,ptemplate,&output_attributes); // Print template
@@ -108,9 +117,10 @@ GT_INLINE void gt_merge_synch_map_files_(
     gt_template_delete(template[i]);
   }
   free(template);
+  return error_code;
 }
 
-GT_INLINE void gt_merge_synch_map_files_a(
+GT_INLINE gt_status gt_merge_synch_map_files_a(
     pthread_mutex_t* const input_mutex,const bool paired_end,gt_output_file* const output_file,
     gt_input_file** const input_map_files,const uint64_t num_files) {
   GT_NULL_CHECK(input_mutex);
@@ -128,16 +138,18 @@ GT_INLINE void gt_merge_synch_map_files_a(
     buffered_input_file[i] = gt_buffered_input_file_new(input_map_files[i]);
   }
   // Buffered Reading+process
-  gt_merge_synch_map_files_(input_mutex,paired_end,buffered_output_file,buffered_input_file,num_files);
+  register const gt_status error_code =
+      gt_merge_synch_map_files_(input_mutex,paired_end,buffered_output_file,buffered_input_file,num_files);
   // Clean & free
   for (i=0;i<num_files;++i) {
     gt_buffered_input_file_close(buffered_input_file[i]);
   }
   free(buffered_input_file);
   gt_buffered_output_file_close(buffered_output_file);
+  return error_code;
 }
 
-GT_INLINE void gt_merge_synch_map_files_v(
+GT_INLINE gt_status gt_merge_synch_map_files_v(
     pthread_mutex_t* const input_mutex,const bool paired_end,gt_output_file* const output_file,
     gt_input_file* const input_map_master,const uint64_t num_slaves,va_list v_args) {
   GT_NULL_CHECK(input_mutex);
@@ -161,16 +173,18 @@ GT_INLINE void gt_merge_synch_map_files_v(
     buffered_input_file[i] = gt_buffered_input_file_new(input_map_file);
   }
   // Buffered Reading+process
-  gt_merge_synch_map_files_(input_mutex,paired_end,buffered_output_file,buffered_input_file,num_files);
+  register const gt_status error_code =
+      gt_merge_synch_map_files_(input_mutex,paired_end,buffered_output_file,buffered_input_file,num_files);
   // Clean
   for (i=0;i<num_files;++i) {
     gt_buffered_input_file_close(buffered_input_file[i]);
   }
   free(buffered_input_file);
   gt_buffered_output_file_close(buffered_output_file);
+  return error_code;
 }
 
-GT_INLINE void gt_merge_synch_map_files_va(
+GT_INLINE gt_status gt_merge_synch_map_files_va(
     pthread_mutex_t* const input_mutex,const bool paired_end,gt_output_file* const output_file,
     gt_input_file* const input_map_master,const uint64_t num_slaves,...) {
   GT_NULL_CHECK(input_mutex);
@@ -178,8 +192,10 @@ GT_INLINE void gt_merge_synch_map_files_va(
   GT_INPUT_FILE_CHECK(input_map_master);
   va_list v_args;
   va_start(v_args,num_slaves);
-  gt_merge_synch_map_files_v(input_mutex,paired_end,output_file,input_map_master,num_slaves,v_args);
+  register const gt_status error_code =
+      gt_merge_synch_map_files_v(input_mutex,paired_end,output_file,input_map_master,num_slaves,v_args);
   va_end(v_args);
+  return error_code;
 }
 
 GT_INLINE void gt_merge_unsynch_map_files(
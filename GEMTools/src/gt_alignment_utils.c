@@ -431,41 +431,31 @@ GT_INLINE void gt_alignment_trim(gt_alignment* const alignment,uint64_t const le
   if (left == 0 && right == 0) return;
   char* read = gt_alignment_get_read(alignment);
   uint64_t read_length = gt_alignment_get_read_length(alignment);
-  if (read_length - left - right < min_length) return;
+  if (left + right > read_length || read_length - left - right < min_length) return;
+  register const bool has_qualities = gt_alignment_has_qualities(alignment) &&
+      gt_string_get_length(alignment->qualities)==read_length;
+  char* qual = (has_qualities) ? gt_alignment_get_qualities(alignment) : NULL;
 
-  // trim the read
+  // get trimmed parts (before the buffers are overwritten)
+  register char* left_read = (left > 0) ? strndup(read,left) : "";
+  register char* right_read = (right > 0) ? strndup(read + read_length - right,right) : "";
+  register char* left_qual = (has_qualities && left > 0) ? strndup(qual,left) : "";
+  register char* right_qual = (has_qualities && right > 0) ? strndup(qual + read_length - right,right) : "";
+
+  // trim the read & qualities (set both before any length consistency check)
   register uint64_t trimmed_length = read_length - (left + right);
   register char* trimmed_read = strndup(read + left,trimmed_length);
-  gt_alignment_set_read(alignment,trimmed_read,trimmed_length);
-
-  // get trimmed parts
-  register char* left_read = 0;
-  register char* right_read = 0;
-  if (left > 0) left_read = strndup(read,left);
-  else left_read = "";
-
-  if (right > 0) right_read = strndup(read + read_length - right,right);
-  else right_read = "";
-
-  register char* trimmed_qual = 0;
-  register char* left_qual = 0;
-  register char* right_qual = 0;
-  // trim qualities
-  char* qual = gt_alignment_get_qualities(alignment);
-  if (qual != NULL) {
+  gt_string_set_nstring(alignment->read,trimmed_read,trimmed_length);
+  register char* trimmed_qual = NULL;
+  if (has_qualities) {
     trimmed_qual = strndup(qual + left,trimmed_length);
-    gt_alignment_set_qualities(alignment,trimmed_qual,trimmed_length);
-    if (left > 0) left_qual = strndup(qual,left);
-    else left_qual = "";
-
-    if(right > 0) right_qual = strndup(qual + read_length - right,right);
-    else right_qual = "";
+    gt_string_set_nstring(alignment->qualities,trimmed_qual,trimmed_length);
   }
 
   if (set_extra) {
     // update extra
     gt_string* extra = gt_string_new(8+ (2*left) + (2*right));
-    if (qual != NULL) {
+    if (has_qualities) {
       gt_sprintf_append(extra," B T %s %s %s %s",left_read,right_read,left_qual,right_qual);
     } else {
       gt_sprintf_append(extra," B T %s %s    ",left_read,right_read);
@@ -477,13 +467,26 @@ GT_INLINE void gt_alignment_trim(gt_alignment* const alignment,uint64_t const le
     gt_shash_insert(alignment->attributes,GT_TAG_EXTRA,extra,gt_string);
   }
 
-  // free(left_read);
-  // free(trimmed_read);
-  // free(right_read);
-  // if (qual != NULL ){
-  //   free(trimmed_qual);
-  //   free(left_qual);
-  //   free(right_qual);
-  // }
+  // free (static strings keep a reference to the trimmed buffers)
+  if (left > 0) free(left_read);
+  if (right > 0) free(right_read);
+  if (has_qualities && left > 0) free(left_qual);
+  if (has_qualities && right > 0) free(right_qual);
+  if (!gt_string_is_static(alignment->read)) free(trimmed_read);
+  if (has_qualities && !gt_string_is_static(alignment->qualities)) free(trimmed_qual);
+}
+GT_INLINE void gt_alignment_auto_trim(
+    gt_alignment* const alignment,gt_dna_read_trim_attributes* const trim_attributes,
+    uint64_t const min_length,bool const set_extra) {
+  GT_ALIGNMENT_CHECK(alignment);
+  GT_NULL_CHECK(trim_attributes);
+  register const uint64_t read_length = gt_alignment_get_read_length(alignment);
+  if (read_length==0) return;
+  uint64_t left, right;
+  gt_dna_read_get_trim_lengths(gt_alignment_get_read(alignment),
+      (gt_alignment_has_qualities(alignment) && gt_string_get_length(alignment->qualities)==read_length) ?
+          gt_alignment_get_qualities(alignment) : NULL,
+      read_length,trim_attributes,&left,&right);
+  gt_alignment_trim(alignment,left,right,min_length,set_extra);
 }
 
@@ -25,6 +25,9 @@ gt_buffered_input_file* gt_buffered_input_file_new(gt_input_file* const input_fi
   buffered_input_file->block_buffer = gt_vector_new(GT_BMI_BUFFER_SIZE,sizeof(uint8_t));
   buffered_input_file->cursor = (char*) gt_vector_get_mem(buffered_input_file->block_buffer,uint8_t);
   buffered_input_file->current_line_num = UINT64_MAX;
+  /* Qualities range seen (while parsing) */
+  buffered_input_file->min_quality = UINT8_MAX;
+  buffered_input_file->max_quality = 0;
   /* Attached output buffer */
   buffered_input_file->buffered_output_file = NULL;
   return buffered_input_file;
@@ -60,6 +63,7 @@ GT_INLINE gt_status gt_buffered_input_file_get_block(
   buffered_input_file->lines_in_buffer =
       gt_input_file_get_lines(input_file,buffered_input_file->block_buffer,
           gt_expect_true(num_lines)?num_lines:GT_BMI_NUM_LINES);
+  GT_PROFILE_ADD_BLOCK(gt_vector_get_used(buffered_input_file->block_buffer));
   gt_input_file_unlock(input_file);
   // Setup the block
   buffered_input_file->cursor = gt_vector_get_mem(buffered_input_file->block_buffer,char);
@@ -119,6 +119,21 @@ const uint8_t gt_cdna_encode[256] = {
   GT_CDNA_PROYECT_CHAR(block_mem,enc_char,1,bm_one_mask,bm_zero_mask); \
   GT_CDNA_PROYECT_CHAR(block_mem,enc_char,2,bm_one_mask,bm_zero_mask)
 
+/*
+ * Encodes a full block of chars (GT_CDNA_BLOCK_CHARS) word-at-a-time
+ *   (no branches nor read-modify-write of the bitmaps, so the loop can be unrolled/vectorized)
+ */
+#define GT_CDNA_ENCODE_BLOCK(block_mem,string) { \
+  register uint64_t bm_0=0, bm_1=0, bm_2=0, j; \
+  for (j=0;j<GT_CDNA_BLOCK_CHARS;++j) { \
+    register const uint64_t enc_char = gt_cdna_encode((string)[j]); \
+    bm_0 |= (enc_char&GT_CDNA_ENCODED_CHAR_BM0)<<j; \
+    bm_1 |= ((enc_char&GT_CDNA_ENCODED_CHAR_BM1)>>1)<<j; \
+    bm_2 |= ((enc_char&GT_CDNA_ENCODED_CHAR_BM2)>>2)<<j; \
+  } \
+  (block_mem)[0]=bm_0; (block_mem)[1]=bm_1; (block_mem)[2]=bm_2; \
+}
+
 /*
  * Constructor
  */
@@ -204,10 +219,11 @@ GT_INLINE uint64_t gt_cdna_string_get_length(gt_compact_dna_string* const cdna_s
 
 GT_INLINE void gt_cdna_string_append_string(gt_compact_dna_string* const cdna_string,char* const string,const uint64_t length) {
   GT_COMPACT_DNA_STRING_CHECK(cdna_string);
+  if (gt_expect_false(length==0)) return;
   // Check allocated bitmaps
   register const uint64_t total_chars = cdna_string->length+length-1;
   if (total_chars >= cdna_string->allocated) {
-    gt_cdna_string_resize(cdna_string,total_chars);
+    gt_cdna_string_resize(cdna_string,total_chars+1);
   }
   // Copy string
   register uint64_t block_num, block_pos, i;
@@ -218,6 +234,15 @@ GT_INLINE void gt_cdna_string_append_string(gt_compact_dna_string* const cdna_st
       block_pos=0;
       block_mem+=GT_CDNA_BLOCK_BITMAPS;
     }
+    // Aligned to a block boundary. Encode full blocks at once
+    if (block_pos==0) {
+      while (length-i >= GT_CDNA_BLOCK_CHARS) {
+        GT_CDNA_ENCODE_BLOCK(block_mem,string+i);
+        block_mem+=GT_CDNA_BLOCK_BITMAPS;
+        i+=GT_CDNA_BLOCK_CHARS;
+      }
+      if (i==length) break;
+    }
     register const uint8_t enc_char = gt_cdna_encode(string[i]);
     GT_CDNA_SET_CHAR(block_mem,block_pos,enc_char);
   }
@@ -66,6 +66,57 @@ GT_INLINE void gt_attribute_set_(
   gt_shash_insert_primitive(attributes,attribute_id,attribute_cp,element_size);
 }
 
+/*
+ * BINARY File Attributes (sequence names dictionary)
+ */
+GT_INLINE void gt_binary_file_format_init(gt_binary_file_format* const binary_file_format) {
+  GT_NULL_CHECK(binary_file_format);
+  binary_file_format->seq_names = calloc(GT_BINARY_SEQ_NAMES_MAX_CHUNKS,sizeof(gt_string**));
+  gt_cond_fatal_error(!binary_file_format->seq_names,MEM_ALLOC);
+}
+GT_INLINE void gt_binary_file_format_destroy(gt_binary_file_format* const binary_file_format) {
+  GT_NULL_CHECK(binary_file_format);
+  if (binary_file_format->seq_names==NULL) return;
+  register uint64_t i, j;
+  for (i=0;i<GT_BINARY_SEQ_NAMES_MAX_CHUNKS && binary_file_format->seq_names[i]!=NULL;++i) {
+    register gt_string** const chunk = binary_file_format->seq_names[i];
+    for (j=0;j<GT_BINARY_SEQ_NAMES_CHUNK_SIZE;++j) {
+      if (chunk[j]!=NULL) gt_string_delete(chunk[j]);
+    }
+    free(chunk);
+  }
+  free(binary_file_format->seq_names);
+  binary_file_format->seq_names = NULL;
+}
+GT_INLINE bool gt_binary_file_format_set_seq_name(
+    gt_binary_file_format* const binary_file_format,const uint64_t seq_name_id,char* const seq_name,const uint64_t length) {
+  GT_NULL_CHECK(binary_file_format);
+  GT_NULL_CHECK(seq_name);
+  register const uint64_t chunk_num = seq_name_id/GT_BINARY_SEQ_NAMES_CHUNK_SIZE;
+  if (gt_expect_false(chunk_num>=GT_BINARY_SEQ_NAMES_MAX_CHUNKS)) return false;
+  // Allocate all the chunks up to the id (so the chunks in use are always contiguous)
+  register uint64_t i;
+  for (i=0;i<=chunk_num;++i) {
+    if (binary_file_format->seq_names[i]==NULL) {
+      binary_file_format->seq_names[i] = calloc(GT_BINARY_SEQ_NAMES_CHUNK_SIZE,sizeof(gt_string*));
+      gt_cond_fatal_error(!binary_file_format->seq_names[i],MEM_ALLOC);
+    }
+  }
+  register gt_string** const slot = binary_file_format->seq_names[chunk_num]+(seq_name_id%GT_BINARY_SEQ_NAMES_CHUNK_SIZE);
+  if (*slot==NULL) { // Redefinitions (same id, same name) are ignored
+    register gt_string* const name = gt_string_new(length+1);
+    gt_string_set_nstring(name,seq_name,length);
+    *slot = name;
+  }
+  return true;
+}
+GT_INLINE gt_string* gt_binary_file_format_get_seq_name(gt_binary_file_format* const binary_file_format,const uint64_t seq_name_id) {
+  GT_NULL_CHECK(binary_file_format);
+  register const uint64_t chunk_num = seq_name_id/GT_BINARY_SEQ_NAMES_CHUNK_SIZE;
+  if (gt_expect_false(chunk_num>=GT_BINARY_SEQ_NAMES_MAX_CHUNKS || binary_file_format->seq_names[chunk_num]==NULL)) return NULL;
+  return binary_file_format->seq_names[chunk_num][seq_name_id%GT_BINARY_SEQ_NAMES_CHUNK_SIZE];
+}
+
 /*
  * SAM Attributes
  */
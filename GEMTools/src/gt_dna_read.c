@@ -21,6 +21,8 @@ GT_INLINE gt_dna_read* gt_dna_read_new(void) {
   read->read = gt_string_new(GT_DNA_READ_INITIAL_LENGTH);
   read->qualities = gt_string_new(GT_DNA_READ_INITIAL_LENGTH);
   read->attributes = gt_shash_new();
+  read->min_quality = UINT8_MAX;
+  read->max_quality = 0;
   return read;
 }
 GT_INLINE void gt_dna_read_clear(gt_dna_read* read) {
@@ -29,6 +31,8 @@ GT_INLINE void gt_dna_read_clear(gt_dna_read* read) {
   gt_string_clear(read->read);
   gt_string_clear(read->qualities);
   gt_shash_clear(read->attributes,true);
+  read->min_quality = UINT8_MAX;
+  read->max_quality = 0;
 }
 GT_INLINE void gt_dna_read_delete(gt_dna_read* read) {
   GT_DNA_READ_CHECK(read);
@@ -72,11 +76,15 @@ GT_INLINE char* gt_dna_read_get_read(gt_dna_read* const read) {
 GT_INLINE void gt_dna_read_set_nqualities(gt_dna_read* read,char* const text,const uint64_t length) {
   GT_DNA_READ_CHECK(read);
   gt_string_set_nstring(read->qualities,text,length);
+  read->min_quality = UINT8_MAX;
+  read->max_quality = 0;
 }
 GT_INLINE void gt_dna_read_set_qualities(gt_dna_read* read,char* const text) {
   GT_DNA_READ_CHECK(read);
   GT_NULL_CHECK(text);
   gt_string_set_string(read->qualities,text);
+  read->min_quality = UINT8_MAX;
+  read->max_quality = 0;
 }
 GT_INLINE char* gt_dna_read_get_qualities(gt_dna_read* const read) {
   GT_DNA_READ_CHECK(read);
@@ -87,11 +95,315 @@ GT_INLINE char* gt_dna_read_get_qualities(gt_dna_read* const read) {
  * Handlers
  */
 GT_INLINE gt_status gt_dna_read_deduce_qualities_offset(gt_dna_read* const read,gt_qualities_offset_t* qualities_offset_type) {
-  register uint8_t min = UINT8_MAX;
-  GT_STRING_ITERATE(read->qualities,string,pos) {
-    if (string[pos]<min) min = string[pos];
+  GT_DNA_READ_CHECK(read);
+  GT_NULL_CHECK(qualities_offset_type);
+  if (read->max_quality==0) {
+    // Range unknown (qualities not set by the parser)
+    GT_STRING_ITERATE(read->qualities,string,pos) {
+      read->min_quality = GT_MIN(read->min_quality,(uint8_t)string[pos]);
+      read->max_quality = GT_MAX(read->max_quality,(uint8_t)string[pos]);
+    }
+    if (read->max_quality==0) return GT_STATUS_FAIL; // No qualities
   }
-  if (min >= 64) {*qualities_offset_type=GT_QUALS_OFFSET_64; return GT_STATUS_OK;} // TODO: Store as attr
-  if (min >= 33) {*qualities_offset_type=GT_QUALS_OFFSET_33; return GT_STATUS_OK;}
+  return gt_qualities_deduce_offset(read->min_quality,qualities_offset_type);
+}
+GT_INLINE gt_status gt_qualities_deduce_offset(const uint8_t min_quality,gt_qualities_offset_t* qualities_offset_type) {
+  if (min_quality >= 64) {*qualities_offset_type=GT_QUALS_OFFSET_64; return GT_STATUS_OK;}
+  if (min_quality >= 33) {*qualities_offset_type=GT_QUALS_OFFSET_33; return GT_STATUS_OK;}
   return GT_STATUS_FAIL;
 }
+
+/*
+ * Line scanners (word-at-a-time)
+ *   Words are loaded aligned (after a byte-wise head), so they never cross a page boundary
+ *   and are safe to load even if the buffer ends right after the EOL/EOS
+ */
+#define GT_DNA_READ_WORD_ONES  0x0101010101010101ull
+#define GT_DNA_READ_WORD_HIGHS 0x8080808080808080ull
+#define GT_DNA_READ_WORD_LOWS  0x7F7F7F7F7F7F7F7Full
+#define GT_DNA_READ_WORD_BROADCAST(character) (GT_DNA_READ_WORD_ONES*(uint8_t)(character))
+#define GT_DNA_READ_WORD_LOAD(word,mem) memcpy(&(word),(mem),sizeof(uint64_t))
+// High bit of each byte set iff the byte is zero
+#define GT_DNA_READ_WORD_ZERO_BYTES(word) \
+  (~((((word)&GT_DNA_READ_WORD_LOWS)+GT_DNA_READ_WORD_LOWS)|(word)|GT_DNA_READ_WORD_LOWS))
+// High bit of each byte set iff the byte equals @character
+#define GT_DNA_READ_WORD_EQ_BYTES(word,character) GT_DNA_READ_WORD_ZERO_BYTES((word)^GT_DNA_READ_WORD_BROADCAST(character))
+// High bit of each byte set iff the byte is a valid quality (33<=byte<128)
+#define GT_DNA_READ_WORD_VALID_QUALS(word) \
+  ((((word)&GT_DNA_READ_WORD_LOWS)+GT_DNA_READ_WORD_BROADCAST(128-33)) & ~(word) & GT_DNA_READ_WORD_HIGHS)
+// Byte-wise min/max of two words holding 7-bit values
+#define GT_DNA_READ_WORD_MIN_MAX(word,min_word,max_word) { \
+  register const uint64_t ge_min = ((((word)|GT_DNA_READ_WORD_HIGHS)-(min_word))&GT_DNA_READ_WORD_HIGHS)>>7; \
+  register const uint64_t ge_min_mask = ge_min*0xFF; \
+  min_word = ((min_word)&ge_min_mask) | ((word)&~ge_min_mask); \
+  register const uint64_t ge_max = ((((word)|GT_DNA_READ_WORD_HIGHS)-(max_word))&GT_DNA_READ_WORD_HIGHS)>>7; \
+  register const uint64_t ge_max_mask = ge_max*0xFF; \
+  max_word = ((word)&ge_max_mask) | ((max_word)&~ge_max_mask); \
+}
+#define GT_DNA_READ_WORD_ALIGNED(mem) ((((uintptr_t)(mem))%sizeof(uint64_t))==0)
+
+GT_INLINE char* gt_dna_read_scan_read_line(char* const line) {
+  GT_NULL_CHECK(line);
+  register char* cursor = line;
+  // Head (until aligned)
+  while (!GT_DNA_READ_WORD_ALIGNED(cursor)) {
+    if (!gt_is_dna(*cursor)) return cursor;
+    ++cursor;
+  }
+  // Body (word-at-a-time)
+  while (true) {
+    uint64_t word;
+    GT_DNA_READ_WORD_LOAD(word,cursor);
+    register const uint64_t valid =
+        GT_DNA_READ_WORD_EQ_BYTES(word,GT_DNA_CHAR_A) | GT_DNA_READ_WORD_EQ_BYTES(word,GT_DNA_CHAR_C) |
+        GT_DNA_READ_WORD_EQ_BYTES(word,GT_DNA_CHAR_G) | GT_DNA_READ_WORD_EQ_BYTES(word,GT_DNA_CHAR_T) |
+        GT_DNA_READ_WORD_EQ_BYTES(word,GT_DNA_CHAR_N);
+    if (valid!=GT_DNA_READ_WORD_HIGHS) break;
+    cursor += sizeof(uint64_t);
+  }
+  // Tail
+  while (gt_is_dna(*cursor)) ++cursor;
+  return cursor;
+}
+GT_INLINE char* gt_dna_read_scan_qualities_line(char* const line,uint8_t* const min_quality,uint8_t* const max_quality) {
+  GT_NULL_CHECK(line);
+  GT_NULL_CHECK(min_quality);
+  GT_NULL_CHECK(max_quality);
+  register char* cursor = line;
+  register uint8_t min = *min_quality, max = *max_quality;
+  // Head (until aligned)
+  while (!GT_DNA_READ_WORD_ALIGNED(cursor)) {
+    if (!gt_is_valid_quality(*cursor)) break;
+    min = GT_MIN(min,(uint8_t)*cursor);
+    max = GT_MAX(max,(uint8_t)*cursor);
+    ++cursor;
+  }
+  if (GT_DNA_READ_WORD_ALIGNED(cursor)) {
+    // Body (word-at-a-time)
+    register char* const body_begin = cursor;
+    register uint64_t min_word = GT_DNA_READ_WORD_LOWS, max_word = 0;
+    while (true) {
+      uint64_t word;
+      GT_DNA_READ_WORD_LOAD(word,cursor);
+      if (GT_DNA_READ_WORD_VALID_QUALS(word)!=GT_DNA_READ_WORD_HIGHS) break;
+      GT_DNA_READ_WORD_MIN_MAX(word,min_word,max_word);
+      cursor += sizeof(uint64_t);
+    }
+    if (cursor>body_begin) {
+      register uint64_t i;
+      for (i=0;i<sizeof(uint64_t);++i,min_word>>=8,max_word>>=8) {
+        min = GT_MIN(min,(uint8_t)(min_word&0xFF));
+        max = GT_MAX(max,(uint8_t)(max_word&0xFF));
+      }
+    }
+    // Tail
+    while (gt_is_valid_quality(*cursor)) {
+      min = GT_MIN(min,(uint8_t)*cursor);
+      max = GT_MAX(max,(uint8_t)*cursor);
+      ++cursor;
+    }
+  }
+  *min_quality = min;
+  *max_quality = max;
+  return cursor;
+}
+
+/*
+ * Trimming attributes
+ */
+GT_INLINE gt_dna_read_trim_attributes* gt_dna_read_trim_attributes_new(void) {
+  gt_dna_read_trim_attributes* const trim_attributes = malloc(sizeof(gt_dna_read_trim_attributes));
+  gt_cond_fatal_error(!trim_attributes,MEM_HANDLER);
+  trim_attributes->adapters = gt_vector_new(2,sizeof(gt_string*));
+  gt_dna_read_trim_attributes_clear(trim_attributes);
+  return trim_attributes;
+}
+GT_INLINE void gt_dna_read_trim_attributes_clear(gt_dna_read_trim_attributes* const trim_attributes) {
+  GT_NULL_CHECK(trim_attributes);
+  /* Quality trimming */
+  trim_attributes->quality_threshold = 0;
+  trim_attributes->qualities_offset = GT_QUALS_OFFSET_33;
+  /* Adapter clipping */
+  GT_VECTOR_ITERATE(trim_attributes->adapters,adapter,adapter_pos,gt_string*) {
+    gt_string_delete(*adapter);
+  }
+  gt_vector_clear(trim_attributes->adapters);
+  trim_attributes->adapter_min_overlap = GT_DNA_READ_TRIM_ADAPTER_MIN_OVERLAP;
+  trim_attributes->adapter_max_error_rate = GT_DNA_READ_TRIM_ADAPTER_MAX_ERROR_RATE;
+  /* Poly-A/N clipping */
+  trim_attributes->poly_a_min_length = 0;
+  trim_attributes->trim_n_ends = false;
+}
+GT_INLINE void gt_dna_read_trim_attributes_delete(gt_dna_read_trim_attributes* const trim_attributes) {
+  GT_NULL_CHECK(trim_attributes);
+  gt_dna_read_trim_attributes_clear(trim_attributes);
+  gt_vector_delete(trim_attributes->adapters);
+  free(trim_attributes);
+}
+GT_INLINE void gt_dna_read_trim_attributes_add_adapter(gt_dna_read_trim_attributes* const trim_attributes,char* const adapter) {
+  GT_NULL_CHECK(trim_attributes);
+  GT_NULL_CHECK(adapter);
+  register const uint64_t adapter_length = strlen(adapter);
+  if (adapter_length==0) return;
+  gt_string* const adapter_string = gt_string_new(adapter_length+1);
+  gt_string_set_nstring(adapter_string,adapter,adapter_length);
+  register char* const buffer = gt_string_get_string(adapter_string);
+  register uint64_t i;
+  for (i=0;i<adapter_length;++i) buffer[i] = toupper(buffer[i]);
+  gt_vector_insert(trim_attributes->adapters,adapter_string,gt_string*);
+}
+GT_INLINE bool gt_dna_read_trim_attributes_is_active(gt_dna_read_trim_attributes* const trim_attributes) {
+  GT_NULL_CHECK(trim_attributes);
+  return trim_attributes->quality_threshold>0 || gt_vector_get_used(trim_attributes->adapters)>0 ||
+         trim_attributes->poly_a_min_length>0 || trim_attributes->trim_n_ends;
+}
+
+/*
+ * Trimming kernels
+ */
+GT_INLINE uint64_t gt_dna_read_get_quality_trim_length(
+    char* const qualities,const uint64_t length,
+    const gt_qualities_offset_t qualities_offset,const uint8_t quality_threshold) {
+  GT_NULL_CHECK(qualities);
+  // BWA-like. Trim the 3' suffix maximizing SUM(threshold-quality)
+  register const int64_t offset = (qualities_offset==GT_QUALS_OFFSET_64) ? 64 : 33;
+  register int64_t sum = 0, max_sum = 0;
+  register uint64_t i, trim_position = length;
+  for (i=length;i>0;--i) {
+    sum += (int64_t)quality_threshold - ((int64_t)(uint8_t)qualities[i-1]-offset);
+    if (sum < 0) break;
+    if (sum > max_sum) {
+      max_sum = sum;
+      trim_position = i-1;
+    }
+  }
+  return length-trim_position;
+}
+/*
+ * Mismatches between @read and @adapter (N counts as a mismatch)
+ *   Word-at-a-time (unaligned loads), stops as soon as @max_mismatches is exceeded
+ */
+GT_INLINE uint64_t gt_dna_read_count_adapter_mismatches(
+    char* const read,char* const adapter,const uint64_t length,const uint64_t max_mismatches) {
+  register uint64_t mismatches = 0, pos = 0;
+  for (;pos+sizeof(uint64_t)<=length;pos+=sizeof(uint64_t)) {
+    uint64_t read_word, adapter_word;
+    GT_DNA_READ_WORD_LOAD(read_word,read+pos);
+    GT_DNA_READ_WORD_LOAD(adapter_word,adapter+pos);
+    register const uint64_t matches = GT_DNA_READ_WORD_ZERO_BYTES(read_word^adapter_word);
+    mismatches += sizeof(uint64_t)-__builtin_popcountll(matches);
+    if (mismatches > max_mismatches) return mismatches;
+  }
+  for (;pos<length;++pos) {
+    if (read[pos]!=adapter[pos]) {
+      if (++mismatches > max_mismatches) return mismatches;
+    }
+  }
+  return mismatches;
+}
+GT_INLINE uint64_t gt_dna_read_get_adapter_position(
+    char* const read,const uint64_t length,char* const adapter,const uint64_t adapter_length,
+    const uint64_t min_overlap,const double max_error_rate) {
+  GT_NULL_CHECK(read);
+  GT_NULL_CHECK(adapter);
+  register const uint64_t overlap_threshold = GT_MAX(min_overlap,1);
+  if (length < overlap_threshold || adapter_length < overlap_threshold) return length;
+  // Leftmost match of the adapter (full or just a prefix hanging off the 3'-end)
+  register uint64_t pos;
+  for (pos=0;pos<=length-overlap_threshold;++pos) {
+    register const uint64_t overlap = GT_MIN(length-pos,adapter_length);
+    register const uint64_t max_mismatches = (uint64_t)((double)overlap*max_error_rate);
+    if (gt_dna_read_count_adapter_mismatches(read+pos,adapter,overlap,max_mismatches) <= max_mismatches) {
+      return pos;
+    }
+  }
+  return length;
+}
+GT_INLINE uint64_t gt_dna_read_get_poly_a_length(char* const read,const uint64_t length,const uint64_t min_length) {
+  GT_NULL_CHECK(read);
+  register uint64_t tail_length = 0;
+  while (tail_length<length &&
+      (read[length-tail_length-1]==GT_DNA_CHAR_A || read[length-tail_length-1]==GT_DNA_CHAR_N)) ++tail_length;
+  return (tail_length>=min_length) ? tail_length : 0;
+}
+GT_INLINE void gt_dna_read_get_trim_lengths(
+    char* const read,char* const qualities,const uint64_t length,
+    gt_dna_read_trim_attributes* const trim_attributes,uint64_t* const left_trim,uint64_t* const right_trim) {
+  GT_NULL_CHECK(read);
+  GT_NULL_CHECK(trim_attributes);
+  GT_NULL_CHECK(left_trim);
+  GT_NULL_CHECK(right_trim);
+  register uint64_t begin = 0, end = length;
+  // Quality trimming
+  if (trim_attributes->quality_threshold>0 && qualities!=NULL) {
+    end -= gt_dna_read_get_quality_trim_length(
+        qualities,end,trim_attributes->qualities_offset,trim_attributes->quality_threshold);
+  }
+  // Adapter clipping (leftmost match among all adapters)
+  GT_VECTOR_ITERATE(trim_attributes->adapters,adapter,adapter_pos,gt_string*) {
+    end = gt_dna_read_get_adapter_position(read,end,gt_string_get_string(*adapter),
+        gt_string_get_length(*adapter),trim_attributes->adapter_min_overlap,trim_attributes->adapter_max_error_rate);
+  }
+  // Poly-A clipping
+  if (trim_attributes->poly_a_min_length>0) {
+    end -= gt_dna_read_get_poly_a_length(read,end,trim_attributes->poly_a_min_length);
+  }
+  // N-ends clipping
+  if (trim_attributes->trim_n_ends) {
+    while (end>begin && read[end-1]==GT_DNA_CHAR_N) --end;
+    while (begin<end && read[begin]==GT_DNA_CHAR_N) ++begin;
+  }
+  *left_trim = begin;
+  *right_trim = length-end;
+}
+
+/*
+ * Trimming
+ */
+GT_INLINE void gt_dna_read_trim_string(gt_string* const string,const uint64_t left_trim,const uint64_t trimmed_length) {
+  if (gt_string_is_static(string)) {
+    string->buffer += left_trim;
+  } else {
+    if (left_trim>0) memmove(string->buffer,string->buffer+left_trim,trimmed_length);
+    string->buffer[trimmed_length] = EOS;
+  }
+  string->length = trimmed_length;
+}
+GT_INLINE uint64_t gt_dna_read_apply_trim(
+    gt_dna_read* const read,const uint64_t left_trim,const uint64_t right_trim,const uint64_t min_length) {
+  register const uint64_t length = gt_string_get_length(read->read);
+  if (left_trim+right_trim==0 || left_trim+right_trim>length) return 0;
+  register const uint64_t trimmed_length = length-left_trim-right_trim;
+  if (trimmed_length < min_length) return 0;
+  gt_dna_read_trim_string(read->read,left_trim,trimmed_length);
+  if (gt_string_get_length(read->qualities)==length) {
+    gt_dna_read_trim_string(read->qualities,left_trim,trimmed_length);
+  }
+  return left_trim+right_trim;
+}
+GT_INLINE uint64_t gt_dna_read_quality_trim(
+    gt_dna_read* const read,const gt_qualities_offset_t qualities_offset,
+    const uint8_t quality_threshold,const uint64_t min_length) {
+  GT_DNA_READ_CHECK(read);
+  register const uint64_t length = gt_string_get_length(read->read);
+  if (quality_threshold==0 || gt_string_get_length(read->qualities)!=length) return 0;
+  register const uint64_t right_trim = gt_dna_read_get_quality_trim_length(
+      gt_string_get_string(read->qualities),length,qualities_offset,quality_threshold);
+  return gt_dna_read_apply_trim(read,0,right_trim,min_length);
+}
+GT_INLINE uint64_t gt_dna_read_hard_trim(gt_dna_read* const read,const uint64_t length) {
+  GT_DNA_READ_CHECK(read);
+  register const uint64_t read_length = gt_string_get_length(read->read);
+  if (read_length<=length) return 0;
+  return gt_dna_read_apply_trim(read,0,read_length-length,0);
+}
+GT_INLINE uint64_t gt_dna_read_trim(
+    gt_dna_read* const read,gt_dna_read_trim_attributes* const trim_attributes,const uint64_t min_length) {
+  GT_DNA_READ_CHECK(read);
+  register const uint64_t length = gt_string_get_length(read->read);
+  uint64_t left_trim, right_trim;
+  gt_dna_read_get_trim_lengths(gt_string_get_string(read->read),
+      (gt_string_get_length(read->qualities)==length) ? gt_string_get_string(read->qualities) : NULL,
+      length,trim_attributes,&left_trim,&right_trim);
+  return gt_dna_read_apply_trim(read,left_trim,right_trim,min_length);
+}
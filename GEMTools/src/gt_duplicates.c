@@ -0,0 +1,391 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_duplicates.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Streaming duplicate detection (PCR & optical) and library complexity estimation
+ */
+
+#include <math.h>
+#include "gt_duplicates.h"
+
+#define GT_DUPLICATES_MIN_TABLE_SIZE 1024
+#define GT_DUPLICATES_SE_SEED 0x5bd1e9955bd1e995ull
+#define GT_DUPLICATES_PE_SEED 0x9e3779b97f4a7c15ull
+
+/*
+ * Setup
+ */
+GT_INLINE void gt_duplicates_stripe_set_table(
+    gt_duplicates_stripe* const stripe,gt_duplicates_slot* const table,const uint64_t table_size) {
+  stripe->table = table;
+  stripe->table_mask = table_size-1;
+  stripe->table_max_occupancy = (table_size/4)*3;
+}
+GT_INLINE gt_duplicates* gt_duplicates_new(gt_duplicates_attributes* const attributes) {
+  GT_NULL_CHECK(attributes);
+  gt_duplicates* const duplicates = malloc(sizeof(gt_duplicates));
+  gt_cond_fatal_error(!duplicates,MEM_HANDLER);
+  // Max table size of each stripe (largest power of 2 fitting in its share of @max_memory)
+  register const uint64_t stripe_memory = attributes->max_memory/GT_DUPLICATES_NUM_STRIPES;
+  register uint64_t max_table_size = GT_DUPLICATES_MIN_TABLE_SIZE;
+  while (2*max_table_size*sizeof(gt_duplicates_slot) <= stripe_memory) max_table_size *= 2;
+  duplicates->max_table_size = max_table_size;
+  // Signatures tables (start small & grow on demand)
+  register uint64_t i;
+  for (i=0;i<GT_DUPLICATES_NUM_STRIPES;++i) {
+    register gt_duplicates_stripe* const stripe = duplicates->stripes+i;
+    gt_duplicates_slot* const table = calloc(GT_DUPLICATES_MIN_TABLE_SIZE,sizeof(gt_duplicates_slot));
+    gt_cond_fatal_error(!table,MEM_ALLOC);
+    gt_duplicates_stripe_set_table(stripe,table,GT_DUPLICATES_MIN_TABLE_SIZE);
+    stripe->table_occupancy = 0;
+    stripe->num_templates = 0;
+    stripe->num_duplicates = 0;
+    stripe->num_optical_duplicates = 0;
+    stripe->num_untracked = 0;
+    gt_cond_fatal_error(pthread_mutex_init(&stripe->mutex,NULL),SYS_MUTEX_INIT);
+  }
+  // Complexity sketch
+  duplicates->hll_registers = calloc(GT_DUPLICATES_HLL_SIZE,sizeof(uint8_t));
+  gt_cond_fatal_error(!duplicates->hll_registers,MEM_ALLOC);
+  // Attributes
+  duplicates->optical_distance = attributes->optical_distance;
+  return duplicates;
+}
+GT_INLINE void gt_duplicates_clear(gt_duplicates* const duplicates) {
+  GT_NULL_CHECK(duplicates);
+  register uint64_t i;
+  for (i=0;i<GT_DUPLICATES_NUM_STRIPES;++i) {
+    register gt_duplicates_stripe* const stripe = duplicates->stripes+i;
+    memset(stripe->table,0,(stripe->table_mask+1)*sizeof(gt_duplicates_slot));
+    stripe->table_occupancy = 0;
+    stripe->num_templates = 0;
+    stripe->num_duplicates = 0;
+    stripe->num_optical_duplicates = 0;
+    stripe->num_untracked = 0;
+  }
+  memset(duplicates->hll_registers,0,GT_DUPLICATES_HLL_SIZE*sizeof(uint8_t));
+}
+GT_INLINE void gt_duplicates_delete(gt_duplicates* const duplicates) {
+  GT_NULL_CHECK(duplicates);
+  register uint64_t i;
+  for (i=0;i<GT_DUPLICATES_NUM_STRIPES;++i) {
+    gt_cond_fatal_error(pthread_mutex_destroy(&duplicates->stripes[i].mutex),SYS_MUTEX_DESTROY);
+    free(duplicates->stripes[i].table);
+  }
+  free(duplicates->hll_registers);
+  free(duplicates);
+}
+
+/*
+ * Signatures
+ */
+GT_INLINE uint64_t gt_duplicates_mix(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdull;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ull;
+  key ^= key >> 33;
+  return key;
+}
+/*
+ * Hash of the 5' end of the map (strand, sequence & unclipped position of the first base sequenced)
+ */
+GT_INLINE uint64_t gt_duplicates_map_signature(gt_map* const map) {
+  register gt_string* const seq_name = gt_map_get_string_seq_name(map);
+  register const char* const name = gt_string_get_string(seq_name);
+  register const uint64_t name_length = gt_string_get_length(seq_name);
+  register uint64_t name_hash = 0xcbf29ce484222325ull, i;
+  for (i=0;i<name_length;++i) {
+    name_hash ^= (uint8_t)name[i];
+    name_hash *= 0x100000001b3ull;
+  }
+  register uint64_t five_prime_position;
+  if (gt_map_get_strand(map)==FORWARD) {
+    five_prime_position = gt_map_get_position_(map)<<1;
+  } else {
+    register gt_map* const last_block = gt_map_get_last_block(map);
+    five_prime_position = ((gt_map_get_position_(last_block)+gt_map_get_length(last_block))<<1) | 1;
+  }
+  return gt_duplicates_mix(name_hash^gt_duplicates_mix(five_prime_position));
+}
+GT_INLINE uint64_t gt_duplicates_fragment_signature(gt_map* const map) {
+  register const uint64_t signature = gt_duplicates_mix(gt_duplicates_map_signature(map)^GT_DUPLICATES_SE_SEED);
+  return (signature!=0) ? signature : 1; // Zero is reserved for empty slots
+}
+GT_INLINE uint64_t gt_duplicates_pair_signature(gt_map* const end1,gt_map* const end2) {
+  // Both ends are combined in order, so that pairs sequenced in swapped order collide
+  register const uint64_t end1_signature = gt_duplicates_map_signature(end1);
+  register const uint64_t end2_signature = gt_duplicates_map_signature(end2);
+  register const uint64_t lo = GT_MIN(end1_signature,end2_signature);
+  register const uint64_t hi = GT_MAX(end1_signature,end2_signature);
+  register const uint64_t signature = gt_duplicates_mix(gt_duplicates_mix(lo^GT_DUPLICATES_PE_SEED)+hi);
+  return (signature!=0) ? signature : 1;
+}
+GT_INLINE bool gt_duplicates_alignment_signature(gt_alignment* const alignment,uint64_t* const signature) {
+  GT_ALIGNMENT_CHECK(alignment);
+  GT_NULL_CHECK(signature);
+  if (gt_alignment_get_num_maps(alignment)==0) return false;
+  *signature = gt_duplicates_fragment_signature(gt_alignment_get_map(alignment,0));
+  return true;
+}
+GT_INLINE bool gt_duplicates_template_signature(gt_template* const template,uint64_t* const signature) {
+  GT_TEMPLATE_CHECK(template);
+  GT_NULL_CHECK(signature);
+  GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template,alignment) {
+    return gt_duplicates_alignment_signature(alignment,signature);
+  } GT_TEMPLATE_END_REDUCTION;
+  // Paired: both ends of the first mmap (the same ends the insert size is computed from)
+  if (gt_template_get_num_blocks(template)==2 && gt_template_get_num_mmaps(template)>0) {
+    register gt_map** const mmap = gt_template_get_mmap(template,0,NULL);
+    if (mmap[0]!=NULL && mmap[1]!=NULL) {
+      *signature = gt_duplicates_pair_signature(mmap[0],mmap[1]);
+      return true;
+    }
+  }
+  // Mate unmapped: the first mapped end is treated as a fragment
+  GT_TEMPLATE_ALIGNMENT_ITERATE(template,alignment) {
+    if (gt_duplicates_alignment_signature(alignment,signature)) return true;
+  }
+  return false;
+}
+
+/*
+ * Optical location (Illumina read names ending in ...:<lane>:<tile>:<x>:<y>[#index][/1])
+ */
+GT_INLINE bool gt_duplicates_parse_location(gt_string* const tag,uint32_t* const tile,uint32_t* const x,uint32_t* const y) {
+  register const char* const name = gt_string_get_string(tag);
+  register const uint64_t name_length = gt_string_get_length(tag);
+  uint64_t field_begin[4] = {0,0,0,0}, num_fields = 1, length, i;
+  for (length=0;length<name_length;++length) {
+    register const char c = name[length];
+    if (c==' ' || c=='\t' || c=='#' || c=='/') break;
+    if (c==':') field_begin[(num_fields++)%4] = length+1;
+  }
+  if (num_fields<4) return false;
+  uint64_t values[4];
+  for (i=0;i<4;++i) {
+    register const uint64_t field = num_fields-4+i;
+    register const uint64_t begin = field_begin[field%4];
+    register const uint64_t end = (i<3) ? field_begin[(field+1)%4]-1 : length;
+    register uint64_t value = 0, pos;
+    if (begin>=end) return false;
+    for (pos=begin;pos<end;++pos) {
+      if (!gt_is_number(name[pos])) return false;
+      value = value*10 + (name[pos]-'0');
+    }
+    values[i] = value;
+  }
+  *tile = (uint32_t)((values[0]<<16) | (values[1]&0xFFFF));
+  *x = (uint32_t)values[2];
+  *y = (uint32_t)values[3];
+  return true;
+}
+
+/*
+ * Duplicate marking
+ */
+GT_INLINE void gt_duplicates_hll_add(gt_duplicates* const duplicates,const uint64_t signature) {
+  register const uint64_t register_idx = signature >> (64-GT_DUPLICATES_HLL_BITS);
+  register const uint64_t remainder = signature << GT_DUPLICATES_HLL_BITS;
+  register const uint8_t rank = (remainder==0) ? (64-GT_DUPLICATES_HLL_BITS+1) : (__builtin_clzll(remainder)+1);
+  if (rank > duplicates->hll_registers[register_idx]) duplicates->hll_registers[register_idx] = rank;
+}
+GT_INLINE uint64_t gt_duplicates_stripe_probe(gt_duplicates_stripe* const stripe,const uint64_t signature) {
+  register gt_duplicates_slot* const table = stripe->table;
+  register uint64_t slot = signature & stripe->table_mask;
+  while (table[slot].signature!=0 && table[slot].signature!=signature) slot = (slot+1) & stripe->table_mask;
+  return slot;
+}
+/*
+ * Doubles the table of the stripe (returns false if it is not allowed to grow any further)
+ */
+GT_INLINE bool gt_duplicates_stripe_grow(gt_duplicates_stripe* const stripe,const uint64_t max_table_size) {
+  register gt_duplicates_slot* const table = stripe->table;
+  register const uint64_t table_size = stripe->table_mask+1;
+  if (table_size>=max_table_size) return false;
+  gt_duplicates_slot* const new_table = calloc(2*table_size,sizeof(gt_duplicates_slot));
+  if (new_table==NULL) return false; // Out of memory (handled as the table being full)
+  gt_duplicates_stripe_set_table(stripe,new_table,2*table_size);
+  register uint64_t i;
+  for (i=0;i<table_size;++i) {
+    if (table[i].signature!=0) new_table[gt_duplicates_stripe_probe(stripe,table[i].signature)] = table[i];
+  }
+  free(table);
+  return true;
+}
+GT_INLINE gt_duplicate_status gt_duplicates_mark(
+    gt_duplicates* const duplicates,const uint64_t signature,gt_string* const tag) {
+  uint32_t tile = 0, x = 0, y = 0;
+  register const bool has_location = gt_duplicates_parse_location(tag,&tile,&x,&y);
+  register gt_duplicate_status status = GT_DUPLICATE_NONE;
+  // Top bits select the stripe (and so the HLL registers the stripe owns)
+  register gt_duplicates_stripe* const stripe = duplicates->stripes+(signature>>(64-GT_DUPLICATES_STRIPE_BITS));
+  GT_BEGIN_MUTEX_SECTION(stripe->mutex);
+  ++stripe->num_templates;
+  gt_duplicates_hll_add(duplicates,signature);
+  // Probe the signature
+  register uint64_t slot = gt_duplicates_stripe_probe(stripe,signature);
+  if (stripe->table[slot].signature==signature) {
+    // Duplicate (optical if close to the original in the same lane & tile)
+    register gt_duplicates_slot* const original = stripe->table+slot;
+    ++stripe->num_duplicates;
+    if (has_location && original->tile!=0 && original->tile==tile &&
+        (uint64_t)GT_ABS((int64_t)original->x-(int64_t)x) <= duplicates->optical_distance &&
+        (uint64_t)GT_ABS((int64_t)original->y-(int64_t)y) <= duplicates->optical_distance) {
+      ++stripe->num_optical_duplicates;
+      status = GT_DUPLICATE_OPTICAL;
+    } else {
+      status = GT_DUPLICATE_PCR;
+    }
+  } else {
+    // New original
+    if (stripe->table_occupancy >= stripe->table_max_occupancy &&
+        gt_duplicates_stripe_grow(stripe,duplicates->max_table_size)) {
+      slot = gt_duplicates_stripe_probe(stripe,signature);
+    }
+    if (stripe->table_occupancy < stripe->table_max_occupancy) {
+      stripe->table[slot].signature = signature;
+      stripe->table[slot].tile = (has_location) ? tile : 0;
+      stripe->table[slot].x = x;
+      stripe->table[slot].y = y;
+      ++stripe->table_occupancy;
+    } else {
+      ++stripe->num_untracked; // Table full
+    }
+  }
+  GT_END_MUTEX_SECTION(stripe->mutex);
+  return status;
+}
+GT_INLINE gt_duplicate_status gt_duplicates_mark_alignment(gt_duplicates* const duplicates,gt_alignment* const alignment) {
+  GT_NULL_CHECK(duplicates);
+  GT_ALIGNMENT_CHECK(alignment);
+  uint64_t signature;
+  gt_duplicate_status status = GT_DUPLICATE_NONE;
+  if (gt_duplicates_alignment_signature(alignment,&signature)) {
+    status = gt_duplicates_mark(duplicates,signature,gt_alignment_get_string_tag(alignment));
+  }
+  gt_attribute_set(alignment->attributes,GT_ATTR_DUPLICATE,&status,gt_duplicate_status);
+  return status;
+}
+GT_INLINE gt_duplicate_status gt_duplicates_mark_template(gt_duplicates* const duplicates,gt_template* const template) {
+  GT_NULL_CHECK(duplicates);
+  GT_TEMPLATE_CHECK(template);
+  GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template,alignment) {
+    return gt_duplicates_mark_alignment(duplicates,alignment);
+  } GT_TEMPLATE_END_REDUCTION;
+  uint64_t signature;
+  gt_duplicate_status status = GT_DUPLICATE_NONE;
+  if (gt_duplicates_template_signature(template,&signature)) {
+    status = gt_duplicates_mark(duplicates,signature,gt_template_get_string_tag(template));
+  }
+  gt_attribute_set(template->attributes,GT_ATTR_DUPLICATE,&status,gt_duplicate_status);
+  return status;
+}
+GT_INLINE gt_duplicate_status gt_alignment_get_duplicate_status(gt_alignment* const alignment) {
+  GT_ALIGNMENT_CHECK(alignment);
+  register gt_duplicate_status* const status = gt_attribute_get(alignment->attributes,GT_ATTR_DUPLICATE);
+  return (status==NULL) ? GT_DUPLICATE_NONE : *status;
+}
+GT_INLINE gt_duplicate_status gt_template_get_duplicate_status(gt_template* const template) {
+  GT_TEMPLATE_CHECK(template);
+  GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template,alignment) {
+    return gt_alignment_get_duplicate_status(alignment);
+  } GT_TEMPLATE_END_REDUCTION;
+  register gt_duplicate_status* const status = gt_attribute_get(template->attributes,GT_ATTR_DUPLICATE);
+  return (status==NULL) ? GT_DUPLICATE_NONE : *status;
+}
+
+/*
+ * Counters
+ */
+GT_INLINE uint64_t gt_duplicates_get_num_templates(gt_duplicates* const duplicates) {
+  GT_NULL_CHECK(duplicates);
+  register uint64_t i, sum = 0;
+  for (i=0;i<GT_DUPLICATES_NUM_STRIPES;++i) {
+    register gt_duplicates_stripe* const stripe = duplicates->stripes+i;
+    sum += stripe->num_templates;
+  }
+  return sum;
+}
+GT_INLINE uint64_t gt_duplicates_get_num_duplicates(gt_duplicates* const duplicates) {
+  GT_NULL_CHECK(duplicates);
+  register uint64_t i, sum = 0;
+  for (i=0;i<GT_DUPLICATES_NUM_STRIPES;++i) {
+    register gt_duplicates_stripe* const stripe = duplicates->stripes+i;
+    sum += stripe->num_duplicates;
+  }
+  return sum;
+}
+GT_INLINE uint64_t gt_duplicates_get_num_optical_duplicates(gt_duplicates* const duplicates) {
+  GT_NULL_CHECK(duplicates);
+  register uint64_t i, sum = 0;
+  for (i=0;i<GT_DUPLICATES_NUM_STRIPES;++i) {
+    register gt_duplicates_stripe* const stripe = duplicates->stripes+i;
+    sum += stripe->num_optical_duplicates;
+  }
+  return sum;
+}
+GT_INLINE uint64_t gt_duplicates_get_num_untracked(gt_duplicates* const duplicates) {
+  GT_NULL_CHECK(duplicates);
+  register uint64_t i, sum = 0;
+  for (i=0;i<GT_DUPLICATES_NUM_STRIPES;++i) {
+    register gt_duplicates_stripe* const stripe = duplicates->stripes+i;
+    sum += stripe->num_untracked;
+  }
+  return sum;
+}
+GT_INLINE uint64_t gt_duplicates_get_memory(gt_duplicates* const duplicates) {
+  GT_NULL_CHECK(duplicates);
+  register uint64_t i, sum = 0;
+  for (i=0;i<GT_DUPLICATES_NUM_STRIPES;++i) {
+    register gt_duplicates_stripe* const stripe = duplicates->stripes+i;
+    sum += (stripe->table_mask+1)*sizeof(gt_duplicates_slot);
+  }
+  return sum;
+}
+GT_INLINE uint64_t gt_duplicates_get_num_tracked(gt_duplicates* const duplicates) {
+  register uint64_t i, sum = 0;
+  for (i=0;i<GT_DUPLICATES_NUM_STRIPES;++i) sum += duplicates->stripes[i].table_occupancy;
+  return sum;
+}
+
+/*
+ * Library complexity
+ */
+GT_INLINE uint64_t gt_duplicates_get_num_distinct(gt_duplicates* const duplicates) {
+  GT_NULL_CHECK(duplicates);
+  register const uint64_t num_tracked = gt_duplicates_get_num_tracked(duplicates);
+  // Exact while all the signatures fit in the tables
+  if (gt_duplicates_get_num_untracked(duplicates)==0) return num_tracked;
+  // HyperLogLog estimate (the tracked signatures are a lower bound)
+  register const double m = GT_DUPLICATES_HLL_SIZE;
+  register double sum = 0.0;
+  register uint64_t i, num_empty = 0;
+  for (i=0;i<GT_DUPLICATES_HLL_SIZE;++i) {
+    sum += ldexp(1.0,-duplicates->hll_registers[i]);
+    if (duplicates->hll_registers[i]==0) ++num_empty;
+  }
+  register double estimate = (0.7213/(1.0+1.079/m))*m*m/sum;
+  if (estimate <= 2.5*m && num_empty>0) estimate = m*log(m/(double)num_empty); // Linear counting
+  return GT_MAX((uint64_t)estimate,num_tracked);
+}
+GT_INLINE double gt_duplicates_lander_waterman(const double x,const double c,const double n) {
+  return c/x - 1.0 + exp(-n/x);
+}
+GT_INLINE uint64_t gt_duplicates_estimate_library_size(gt_duplicates* const duplicates) {
+  GT_NULL_CHECK(duplicates);
+  register const double n = gt_duplicates_get_num_templates(duplicates);
+  register const double c = gt_duplicates_get_num_distinct(duplicates);
+  if (c==0 || c>=n) return 0; // Undefined (no duplicates observed)
+  register double lo = 1.0, hi = 100.0;
+  while (gt_duplicates_lander_waterman(hi*c,c,n) >= 0.0) hi *= 10.0;
+  register uint64_t i;
+  for (i=0;i<40;++i) {
+    register const double r = (lo+hi)/2.0;
+    register const double u = gt_duplicates_lander_waterman(r*c,c,n);
+    if (u==0.0) break;
+    if (u>0.0) lo = r; else hi = r;
+  }
+  return (uint64_t)(c*(lo+hi)/2.0);
+}
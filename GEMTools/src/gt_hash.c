@@ -3,8 +3,36 @@
  * FILE: gt_hash.c
  * DATE: 2/09/2012
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
- * DESCRIPTION: // TODO
+ * DESCRIPTION: Open-addressing hash tables (integer & string keys)
  */
 
 #include "gt_hash.h"
 
+/*
+ * Internal Type Setup/Handlers
+ */
+GT_INLINE void gt_hash_free_element(void* const element,const gt_hash_element_type element_type) {
+  GT_NULL_CHECK(element);
+  gt_cond_fatal_error(element_type!=GT_HASH_TYPE_REGULAR,SELECTION_NOT_VALID);
+  free(element);
+}
+GT_INLINE void* gt_hash_copy_element(void* const element,const gt_hash_element_type element_type,const int64_t element_size) {
+  GT_NULL_CHECK(element);
+  gt_cond_fatal_error(element_type!=GT_HASH_TYPE_REGULAR,SELECTION_NOT_VALID);
+  register void* const element_cp = gt_malloc_(1,element_size,false,0);
+  memcpy(element_cp,element,element_size);
+  return element_cp;
+}
+
+/*
+ * Hash functions
+ */
+GT_INLINE uint64_t gt_hash_string(const char* const key,const uint64_t key_length) {
+  // FNV-1a (64 bits) + final avalanche (so the low bits can be used as index)
+  register uint64_t hash = 0xCBF29CE484222325ull, i;
+  for (i=0;i<key_length;++i) {
+    hash ^= (uint8_t)key[i];
+    hash *= 0x100000001B3ull;
+  }
+  return gt_hash_integer(hash);
+}
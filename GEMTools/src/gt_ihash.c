@@ -3,7 +3,7 @@
  * FILE: gt_ihash.c
  * DATE: 2/09/2012
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
- * DESCRIPTION: // TODO
+ * DESCRIPTION: Integer key hash (open addressing, see gt_hash.h)
  */
 
 #include "gt_hash.h"
@@ -25,12 +25,66 @@ GT_INLINE void gt_ihash_free_element(gt_ihash_element *ihash_element) {
       break;
   }
 }
-GT_INLINE void gt_ihash_free_ihash_element(gt_ihash_element *ihash_element,const bool free_element) {
-  GT_NULL_CHECK(ihash_element);
-  // Free element
-  if (free_element) gt_ihash_free_element(ihash_element);
-  // Free handler
-  free(ihash_element);
+
+/*
+ * Index
+ */
+GT_INLINE gt_hash_slot* gt_ihash_index_lookup(gt_ihash* const ihash,const int64_t key) {
+  if (gt_expect_false(ihash->index_size==0)) return NULL;
+  register const uint64_t mask = ihash->index_size-1;
+  register uint64_t i = gt_hash_integer(key) & mask;
+  while (true) {
+    register gt_hash_slot* const slot = ihash->index+i;
+    if (slot->position==0) return NULL;
+    if (slot->position!=GT_HASH_SLOT_DELETED && slot->hash==(uint64_t)key) return slot;
+    i = (i+1) & mask;
+  }
+}
+GT_INLINE void gt_ihash_index_add(gt_ihash* const ihash,const int64_t key,const uint64_t position) {
+  register const uint64_t mask = ihash->index_size-1;
+  register uint64_t i = gt_hash_integer(key) & mask;
+  while (ihash->index[i].position!=0 && ihash->index[i].position!=GT_HASH_SLOT_DELETED) i = (i+1) & mask;
+  if (ihash->index[i].position==0) ++ihash->index_occupied;
+  ihash->index[i].hash = (uint64_t)key;
+  ihash->index[i].position = position+1;
+}
+GT_INLINE void gt_ihash_index_rebuild(gt_ihash* const ihash,const uint64_t index_size) {
+  if (index_size!=ihash->index_size) {
+    free(ihash->index);
+    ihash->index = malloc(index_size*sizeof(gt_hash_slot));
+    gt_cond_fatal_error(!ihash->index,MEM_ALLOC);
+    ihash->index_size = index_size;
+  }
+  memset(ihash->index,0,index_size*sizeof(gt_hash_slot));
+  ihash->index_occupied = 0;
+  register uint64_t position;
+  for (position=0;position<ihash->elements_used;++position) {
+    register gt_ihash_element* const ihash_element = gt_ihash_get_ihash_element_at(ihash,position);
+    if (ihash_element->element!=NULL) gt_ihash_index_add(ihash,ihash_element->key,position);
+  }
+}
+GT_INLINE gt_ihash_element* gt_ihash_add_ihash_element(gt_ihash* const ihash,const int64_t key) {
+  // Grow the index (or purge deleted slots) keeping the load factor under 1/2
+  if (gt_expect_false(2*(ihash->index_occupied+1)>ihash->index_size)) {
+    register uint64_t index_size = GT_MAX(ihash->index_size,GT_HASH_INDEX_MIN_SIZE);
+    while (4*(ihash->num_elements+1)>index_size) index_size *= 2;
+    gt_ihash_index_rebuild(ihash,index_size);
+  }
+  // Allocate the element (new blocks are never relocated)
+  register const uint64_t position = ihash->elements_used;
+  register const uint64_t block_num = gt_hash_block_num(position);
+  if (gt_expect_false(block_num>=ihash->num_blocks)) {
+    gt_cond_fatal_error(block_num>=GT_HASH_MAX_BLOCKS,MEM_ALLOC);
+    ihash->blocks[block_num] = malloc(gt_hash_block_size(block_num)*sizeof(gt_ihash_element));
+    gt_cond_fatal_error(!ihash->blocks[block_num],MEM_ALLOC);
+    ihash->num_blocks = block_num+1;
+  }
+  ++ihash->elements_used;
+  ++ihash->num_elements;
+  register gt_ihash_element* const ihash_element = ihash->blocks[block_num]+gt_hash_block_offset(position,block_num);
+  ihash_element->key = key;
+  gt_ihash_index_add(ihash,key,position);
+  return ihash_element;
 }
 
 /*
@@ -39,20 +93,35 @@ GT_INLINE void gt_ihash_free_ihash_element(gt_ihash_element *ihash_element,const
 GT_INLINE gt_ihash* gt_ihash_new(void) {
   gt_ihash* ihash=malloc(sizeof(gt_ihash));
   gt_cond_fatal_error(!ihash,MEM_HANDLER);
-  ihash->ihash_head = NULL; // uthash initializer
+  ihash->num_blocks = 0;
+  ihash->elements_used = 0;
+  ihash->num_elements = 0;
+  ihash->index = NULL; // Allocated on the first insertion
+  ihash->index_size = 0;
+  ihash->index_occupied = 0;
   return ihash;
 }
 GT_INLINE void gt_ihash_clear(gt_ihash* const ihash,const bool free_element) {
   GT_HASH_CHECK(ihash);
-  gt_ihash_element *ihash_element, *tmp;
-  HASH_ITER(hh,ihash->ihash_head,ihash_element,tmp) {
-    HASH_DEL(ihash->ihash_head,ihash_element);
-    gt_ihash_free_ihash_element(ihash_element,free_element);
+  if (free_element) {
+    register uint64_t position;
+    for (position=0;position<ihash->elements_used;++position) {
+      register gt_ihash_element* const ihash_element = gt_ihash_get_ihash_element_at(ihash,position);
+      if (ihash_element->element!=NULL) gt_ihash_free_element(ihash_element);
+    }
   }
+  // Keep blocks & index
+  if (ihash->index_occupied>0) memset(ihash->index,0,ihash->index_size*sizeof(gt_hash_slot));
+  ihash->elements_used = 0;
+  ihash->num_elements = 0;
+  ihash->index_occupied = 0;
 }
 GT_INLINE void gt_ihash_delete(gt_ihash* const ihash,const bool free_element) {
   GT_HASH_CHECK(ihash);
   gt_ihash_clear(ihash,free_element);
+  register uint64_t i;
+  for (i=0;i<ihash->num_blocks;++i) free(ihash->blocks[i]);
+  free(ihash->index);
   free(ihash);
 }
 
@@ -61,9 +130,8 @@ GT_INLINE void gt_ihash_delete(gt_ihash* const ihash,const bool free_element) {
  */
 GT_INLINE gt_ihash_element* gt_ihash_get_ihash_element(gt_ihash* const ihash,const int64_t key) {
   GT_HASH_CHECK(ihash);
-  gt_ihash_element *ihash_element;
-  HASH_FIND_INT(ihash->ihash_head,&key,ihash_element);
-  return ihash_element;
+  register gt_hash_slot* const slot = gt_ihash_index_lookup(ihash,key);
+  return (slot!=NULL) ? gt_ihash_get_ihash_element_at(ihash,slot->position-1) : NULL;
 }
 GT_INLINE void gt_ihash_insert_primitive(
     gt_ihash* const ihash,const int64_t key,void* const element,const int64_t element_size) {
@@ -72,16 +140,12 @@ GT_INLINE void gt_ihash_insert_primitive(
   GT_NULL_CHECK(element);
   gt_ihash_element* ihash_element = gt_ihash_get_ihash_element(ihash,key);
   if (gt_expect_true(ihash_element==NULL)) {
-    ihash_element = malloc(sizeof(gt_ihash_element));
-    gt_cond_fatal_error(!ihash_element,MEM_ALLOC);
-    ihash_element->key = key;
-    ihash_element->element = element;
-    HASH_ADD_INT(ihash->ihash_head,key,ihash_element);
+    ihash_element = gt_ihash_add_ihash_element(ihash,key);
   } else {
     gt_ihash_free_element(ihash_element);
-    ihash_element->element = element;
   }
-  // Set shash element type
+  // Set ihash element type
+  ihash_element->element = element;
   ihash_element->element_type = GT_HASH_TYPE_REGULAR;
   ihash_element->element_size = element_size;
 }
@@ -93,16 +157,12 @@ GT_INLINE void gt_ihash_insert_object(
   GT_NULL_CHECK(element_dup_fx); GT_NULL_CHECK(element_free_fx);
   gt_ihash_element* ihash_element = gt_ihash_get_ihash_element(ihash,key);
   if (gt_expect_true(ihash_element==NULL)) {
-    ihash_element = malloc(sizeof(gt_ihash_element));
-    gt_cond_fatal_error(!ihash_element,MEM_ALLOC);
-    ihash_element->key = key;
-    ihash_element->element = object;
-    HASH_ADD_INT(ihash->ihash_head,key,ihash_element);
+    ihash_element = gt_ihash_add_ihash_element(ihash,key);
   } else {
     gt_ihash_free_element(ihash_element);
-    ihash_element->element = object;
   }
   // Set ihash element type
+  ihash_element->element = object;
   ihash_element->element_type = GT_HASH_TYPE_OBJECT;
   ihash_element->element_setup.element_dup_fx = element_dup_fx;
   ihash_element->element_setup.element_free_fx = element_free_fx;
@@ -114,10 +174,13 @@ GT_INLINE void* gt_ihash_get_element(gt_ihash* const ihash,const int64_t key) {
 }
 GT_INLINE void gt_ihash_remove(gt_ihash* const ihash,const int64_t key,const bool free_element) {
   GT_HASH_CHECK(ihash);
-  gt_ihash_element *ihash_element = gt_ihash_get_ihash_element(ihash,key);
-  if (ihash_element) {
-    HASH_DEL(ihash->ihash_head,ihash_element);
-    gt_ihash_free_ihash_element(ihash_element,free_element);
+  register gt_hash_slot* const slot = gt_ihash_index_lookup(ihash,key);
+  if (slot!=NULL) {
+    register gt_ihash_element* const ihash_element = gt_ihash_get_ihash_element_at(ihash,slot->position-1);
+    if (free_element) gt_ihash_free_element(ihash_element);
+    ihash_element->element = NULL; // The position is not reused (until clear)
+    slot->position = GT_HASH_SLOT_DELETED;
+    --ihash->num_elements;
   }
 }
 
@@ -126,11 +189,11 @@ GT_INLINE void gt_ihash_remove(gt_ihash* const ihash,const int64_t key,const boo
  */
 GT_INLINE bool gt_ihash_is_contained(gt_ihash* const ihash,const int64_t key) {
   GT_HASH_CHECK(ihash);
-  return (gt_ihash_get_ihash_element(ihash,key)!=NULL);
+  return (gt_ihash_index_lookup(ihash,key)!=NULL);
 }
 GT_INLINE uint64_t gt_ihash_get_num_elements(gt_ihash* const ihash) {
   GT_HASH_CHECK(ihash);
-  return (uint64_t)HASH_COUNT(ihash->ihash_head);
+  return ihash->num_elements;
 }
 
 /*
@@ -0,0 +1,636 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_input_binary_parser.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Input parser for the binary packed template format (intermediate files between pipeline steps)
+ */
+
+#include "gt_input_binary_parser.h"
+
+#define GT_IBP_NUM_LINES GT_NUM_LINES_10K
+
+/*
+ * Qualities binning (Illumina 8-level)
+ */
+const uint8_t gt_binary_quals_bin_value[GT_BINARY_QUALS_NUM_BINS] = { 2, 6, 15, 22, 27, 33, 37, 40 };
+const uint8_t gt_binary_quals_bin[256] = {
+    [0 ... 2] = 0, [3 ... 9] = 1, [10 ... 19] = 2, [20 ... 24] = 3,
+    [25 ... 29] = 4, [30 ... 34] = 5, [35 ... 39] = 6, [40 ... 255] = 7
+};
+
+/*
+ * Record decoder (payload unescaped in place)
+ */
+typedef struct {
+  uint8_t* cursor;
+  uint8_t* end;
+  gt_binary_file_format* binary_file_format; // Sequence names dictionary
+} gt_ibp_record;
+
+/*
+ * Binary File Format test
+ */
+GT_INLINE bool gt_input_binary_parser_test_binary(
+    char* const file_name,const uint64_t line_num,char* const buffer,const uint64_t buffer_size,const bool show_errors) {
+  // Required conditions:
+  //   (1) Record begin (or sequence name definition) mark
+  //   (2) TAG (or Id) delimited by TAB within the first line
+  if (buffer_size==0 || (buffer[0]!=GT_BINARY_RECORD_BEGIN && buffer[0]!=GT_BINARY_SEQ_NAME_DEFINITION)) {
+    gt_cond_error(show_errors,PARSE_BINARY_BAD_FILE_FORMAT,file_name,line_num);
+    return false;
+  }
+  register uint64_t buffer_pos;
+  for (buffer_pos=1;buffer_pos<buffer_size;++buffer_pos) {
+    register const char c = buffer[buffer_pos];
+    if (c==TAB) return true;
+    if (c==EOL || c==EOS) break;
+  }
+  gt_cond_error(show_errors,PARSE_BINARY_BAD_FILE_FORMAT,file_name,line_num);
+  return false;
+}
+GT_INLINE bool gt_input_file_test_binary(
+    gt_input_file* const input_file,gt_binary_file_format* const binary_file_format,const bool show_errors) {
+  GT_INPUT_FILE_CHECK(input_file);
+  if (!gt_input_binary_parser_test_binary(
+      input_file->file_name,input_file->processed_lines+1,(char*)input_file->file_buffer,
+      input_file->buffer_size,show_errors)) return false;
+  gt_binary_file_format_init(binary_file_format);
+  return true;
+}
+GT_INLINE gt_status gt_input_binary_parser_check_binary_file_format(gt_buffered_input_file* const buffered_binary_input) {
+  register gt_input_file* const input_file = buffered_binary_input->input_file;
+  if (gt_expect_false(input_file->file_format!=BINARY)) return GT_IBP_PE_WRONG_FILE_FORMAT;
+  return 0;
+}
+
+/*
+ * Binary File basics
+ */
+/* Error handler */
+GT_INLINE void gt_input_binary_parser_prompt_error(
+    gt_buffered_input_file* const buffered_binary_input,
+    const uint64_t line_num,const gt_status error_code) {
+  // Display textual error msg
+  register const char* const file_name = buffered_binary_input->input_file->file_name;
+  switch (error_code) {
+    case 0: /* No error */ break;
+    case GT_IBP_PE_WRONG_FILE_FORMAT: gt_error(PARSE_BINARY_BAD_FILE_FORMAT,file_name,line_num); break;
+    case GT_IBP_PE_PREMATURE_EOR: gt_error(PARSE_BINARY_PREMATURE_EOR,file_name,line_num); break;
+    case GT_IBP_PE_BAD_ESCAPE: gt_error(PARSE_BINARY_BAD_ESCAPE,file_name,line_num); break;
+    case GT_IBP_PE_BAD_NUMBER_OF_BLOCKS: gt_error(PARSE_BINARY_BAD_NUMBER_OF_BLOCKS,file_name,line_num); break;
+    case GT_IBP_PE_QUAL_BAD_MODE: gt_error(PARSE_BINARY_QUAL_BAD_MODE,file_name,line_num); break;
+    case GT_IBP_PE_MAP_BAD_SEQ_NAME: gt_error(PARSE_BINARY_MAP_BAD_SEQ_NAME,file_name,line_num); break;
+    case GT_IBP_PE_MAP_BAD_MISMS: gt_error(PARSE_BINARY_MAP_BAD_MISMS,file_name,line_num); break;
+    case GT_IBP_PE_MAP_BAD_JUNCTION: gt_error(PARSE_BINARY_MAP_BAD_JUNCTION,file_name,line_num); break;
+    case GT_IBP_PE_MMAP_BAD_MAP_REFERENCE: gt_error(PARSE_BINARY_MMAP_BAD_MAP_REFERENCE,file_name,line_num); break;
+    case GT_IBP_PE_BAD_SEQ_NAME_DEFINITION: gt_error(PARSE_BINARY_BAD_SEQ_NAME_DEFINITION,file_name,line_num); break;
+    default:
+      gt_error(PARSE_BINARY,file_name,line_num);
+      break;
+  }
+}
+/* BINARY file. Skip record */
+GT_INLINE void gt_input_binary_parser_next_record(gt_buffered_input_file* const buffered_binary_input) {
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_binary_input);
+  if (!gt_buffered_input_file_eob(buffered_binary_input)) {
+    GT_INPUT_FILE_SKIP_LINE(buffered_binary_input);
+  }
+}
+/* Sequence name definition (<SEQ_NAME_DEFINITION><Id>\t<SeqName>). Only checked if @binary_file_format is NULL */
+GT_INLINE gt_status gt_ibp_parse_seq_name_definition(
+    char* const line_start,char* const line_end,gt_binary_file_format* const binary_file_format) {
+  register char* cursor = line_start+1;
+  register uint64_t seq_name_id = 0;
+  if (gt_expect_false(cursor>=line_end || !gt_is_number(*cursor))) return GT_IBP_PE_BAD_SEQ_NAME_DEFINITION;
+  while (cursor<line_end && gt_is_number(*cursor)) {
+    seq_name_id = seq_name_id*10 + gt_get_cipher(*cursor);
+    if (gt_expect_false(seq_name_id>=GT_BINARY_SEQ_NAMES_CHUNK_SIZE*GT_BINARY_SEQ_NAMES_MAX_CHUNKS)) return GT_IBP_PE_BAD_SEQ_NAME_DEFINITION;
+    ++cursor;
+  }
+  if (gt_expect_false(cursor>=line_end || *cursor!=TAB || cursor+1==line_end)) return GT_IBP_PE_BAD_SEQ_NAME_DEFINITION;
+  ++cursor;
+  if (binary_file_format!=NULL) {
+    register uint64_t length = line_end-cursor;
+    if (line_end[-1]==DOS_EOL) --length;
+    gt_binary_file_format_set_seq_name(binary_file_format,seq_name_id,cursor,length);
+  }
+  return 0;
+}
+/* Read a block, registering its sequence names (in file order, so they are known before any later block is parsed) */
+GT_INLINE uint64_t gt_ibp_get_block(gt_buffered_input_file* const buffered_binary_input) {
+  register gt_input_file* const input_file = buffered_binary_input->input_file;
+  if (input_file->eof) return 0;
+  gt_input_file_lock(input_file);
+  if (input_file->eof) {
+    gt_input_file_unlock(input_file);
+    return 0;
+  }
+  buffered_binary_input->block_id = gt_input_file_next_id(input_file) % UINT32_MAX;
+  buffered_binary_input->current_line_num = input_file->processed_lines+1;
+  buffered_binary_input->lines_in_buffer =
+      gt_input_file_get_lines(input_file,buffered_binary_input->block_buffer,GT_IBP_NUM_LINES);
+  GT_PROFILE_ADD_BLOCK(gt_vector_get_used(buffered_binary_input->block_buffer));
+  register char* line = gt_vector_get_mem(buffered_binary_input->block_buffer,char);
+  register char* const block_end = line+gt_vector_get_used(buffered_binary_input->block_buffer);
+  if (gt_expect_false(input_file->file_format==FILE_FORMAT_UNKNOWN && line<block_end)) { // Stream
+    if (gt_input_binary_parser_test_binary(input_file->file_name,
+        buffered_binary_input->current_line_num,line,block_end-line,true)) {
+      input_file->file_format = BINARY;
+      gt_binary_file_format_init(&(input_file->binary_type));
+    }
+  }
+  if (input_file->file_format==BINARY) {
+    while (line<block_end) {
+      register char* const line_end = memchr(line,EOL,block_end-line);
+      if (*line==GT_BINARY_SEQ_NAME_DEFINITION) {
+        gt_ibp_parse_seq_name_definition(line,line_end,&(input_file->binary_type)); // (Errors reported when parsed)
+      }
+      line = line_end+1;
+    }
+  }
+  gt_input_file_unlock(input_file);
+  // Setup the block
+  buffered_binary_input->cursor = gt_vector_get_mem(buffered_binary_input->block_buffer,char);
+  return buffered_binary_input->lines_in_buffer;
+}
+/* Read new buffer */
+GT_INLINE gt_status gt_input_binary_parser_reload_buffer(gt_buffered_input_file* const buffered_binary_input) {
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_binary_input);
+  // Dump buffer if BOF it attached to Binary-input, and get new out block (always FIRST)
+  if (buffered_binary_input->buffered_output_file!=NULL) {
+    gt_buffered_output_file_dump(buffered_binary_input->buffered_output_file);
+  }
+  // Read new input block
+  if (gt_expect_false(gt_ibp_get_block(buffered_binary_input)==0)) return GT_IBP_EOF;
+  // Assign block ID
+  if (buffered_binary_input->buffered_output_file!=NULL) {
+    gt_buffered_output_file_set_block_ids(
+        buffered_binary_input->buffered_output_file,buffered_binary_input->block_id,0);
+  }
+  return GT_IBP_OK;
+}
+
+/*
+ * Binary record parsing functions
+ */
+GT_INLINE gt_status gt_ibp_unescape(char* const begin,char* const end,char** const payload_end) {
+  register char* src = begin;
+  register char* dst = begin;
+  while (src<end) {
+    if (gt_expect_false(*src==GT_BINARY_ESCAPE)) {
+      if (gt_expect_false(++src==end)) return GT_IBP_PE_BAD_ESCAPE;
+      switch (*src) {
+        case GT_BINARY_ESCAPE_EOS: *dst=EOS^GT_BINARY_BYTE_MASK; break;
+        case GT_BINARY_ESCAPE_EOL: *dst=EOL^GT_BINARY_BYTE_MASK; break;
+        case GT_BINARY_ESCAPE_DOS_EOL: *dst=DOS_EOL^GT_BINARY_BYTE_MASK; break;
+        case GT_BINARY_ESCAPE_ESCAPE: *dst=GT_BINARY_ESCAPE^GT_BINARY_BYTE_MASK; break;
+        default: return GT_IBP_PE_BAD_ESCAPE;
+      }
+      ++src; ++dst;
+    } else {
+      *dst++ = *src++ ^ GT_BINARY_BYTE_MASK;
+    }
+  }
+  *payload_end = dst;
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_get_byte(gt_ibp_record* const record,uint8_t* const value) {
+  if (gt_expect_false(record->cursor>=record->end)) return GT_IBP_PE_PREMATURE_EOR;
+  *value = *(record->cursor++);
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_get_varint(gt_ibp_record* const record,uint64_t* const value) {
+  register uint64_t number = 0, shift = 0;
+  register uint8_t byte;
+  do {
+    if (gt_expect_false(record->cursor>=record->end || shift>63)) return GT_IBP_PE_PREMATURE_EOR;
+    byte = *(record->cursor++);
+    number |= ((uint64_t)(byte&0x7F))<<shift;
+    shift += 7;
+  } while (byte&0x80);
+  *value = number;
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_get_zigzag(gt_ibp_record* const record,int64_t* const value) {
+  uint64_t number;
+  register gt_status error_code;
+  if ((error_code=gt_ibp_get_varint(record,&number))) return error_code;
+  *value = (int64_t)(number>>1) ^ -((int64_t)(number&1));
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_get_bytes(gt_ibp_record* const record,const uint64_t length,uint8_t** const bytes) {
+  if (gt_expect_false((uint64_t)(record->end-record->cursor)<length)) return GT_IBP_PE_PREMATURE_EOR;
+  *bytes = record->cursor;
+  record->cursor += length;
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_parse_read_block(gt_ibp_record* const record,gt_alignment* const alignment) {
+  register gt_status error_code;
+  uint64_t read_length, num_exceptions, delta_pos;
+  uint8_t* packed_read;
+  uint8_t mode, character;
+  // READ (2-bit packed)
+  if ((error_code=gt_ibp_get_varint(record,&read_length))) return error_code;
+  if ((error_code=gt_ibp_get_bytes(record,(read_length+3)/4,&packed_read))) return error_code;
+  register gt_string* const read = alignment->read;
+  gt_string_resize(read,read_length+1);
+  register char* const read_buffer = gt_string_get_string(read);
+  register uint64_t i, position;
+  for (i=0;i<read_length;++i) {
+    read_buffer[i] = gt_cdna_decode[(packed_read[i/4]>>(2*(i%4)))&3];
+  }
+  // Exceptions (non-ACGT characters)
+  if ((error_code=gt_ibp_get_varint(record,&num_exceptions))) return error_code;
+  for (i=0,position=0;i<num_exceptions;++i) {
+    if ((error_code=gt_ibp_get_varint(record,&delta_pos))) return error_code;
+    if ((error_code=gt_ibp_get_byte(record,&character))) return error_code;
+    position += delta_pos;
+    if (gt_expect_false(position>=read_length)) return GT_IBP_PE_PREMATURE_EOR;
+    read_buffer[position] = character;
+  }
+  gt_string_set_length(read,read_length);
+  gt_string_append_eos(read);
+  // QUALITIES
+  if ((error_code=gt_ibp_get_byte(record,&mode))) return error_code;
+  switch (mode) {
+    case GT_BINARY_QUALS_NONE:
+      gt_string_clear(alignment->qualities);
+      break;
+    case GT_BINARY_QUALS_RAW: {
+      uint8_t* qualities;
+      if ((error_code=gt_ibp_get_bytes(record,read_length,&qualities))) return error_code;
+      gt_string_set_nstring(alignment->qualities,(char*)qualities,read_length);
+      break;
+    }
+    case GT_BINARY_QUALS_BINNED: {
+      uint8_t offset, *binned_qualities;
+      if ((error_code=gt_ibp_get_byte(record,&offset))) return error_code;
+      if ((error_code=gt_ibp_get_bytes(record,(read_length+1)/2,&binned_qualities))) return error_code;
+      gt_string_resize(alignment->qualities,read_length+1);
+      register char* const qualities_buffer = gt_string_get_string(alignment->qualities);
+      for (i=0;i<read_length;++i) {
+        register const uint8_t bin = (binned_qualities[i/2]>>(4*(i%2)))&0x0F;
+        if (gt_expect_false(bin>=GT_BINARY_QUALS_NUM_BINS)) return GT_IBP_PE_QUAL_BAD_MODE;
+        qualities_buffer[i] = offset+gt_binary_quals_bin_value[bin];
+      }
+      gt_string_set_length(alignment->qualities,read_length);
+      gt_string_append_eos(alignment->qualities);
+      break;
+    }
+    default:
+      return GT_IBP_PE_QUAL_BAD_MODE;
+  }
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_parse_counters(
+    gt_ibp_record* const record,gt_vector* const counters,uint64_t* const mcs,bool* const not_unique) {
+  register gt_status error_code;
+  uint64_t num_counters, counter, mcs_plus_one;
+  uint8_t not_unique_flag;
+  gt_vector_clear(counters);
+  if ((error_code=gt_ibp_get_varint(record,&num_counters))) return error_code;
+  register uint64_t i;
+  for (i=0;i<num_counters;++i) {
+    if ((error_code=gt_ibp_get_varint(record,&counter))) return error_code;
+    gt_vector_insert(counters,counter,uint64_t);
+  }
+  if ((error_code=gt_ibp_get_varint(record,&mcs_plus_one))) return error_code;
+  if ((error_code=gt_ibp_get_byte(record,&not_unique_flag))) return error_code;
+  *mcs = mcs_plus_one-1; // (UINT64_MAX if not set)
+  *not_unique = not_unique_flag;
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_parse_seq_name(gt_ibp_record* const record,gt_map* const map) {
+  register gt_status error_code;
+  uint64_t seq_name_ref, seq_name_length;
+  uint8_t* seq_name;
+  if ((error_code=gt_ibp_get_varint(record,&seq_name_ref))) return error_code;
+  if (seq_name_ref==0) { // Inline name
+    if ((error_code=gt_ibp_get_varint(record,&seq_name_length))) return error_code;
+    if ((error_code=gt_ibp_get_bytes(record,seq_name_length,&seq_name))) return error_code;
+    gt_map_set_seq_name(map,(char*)seq_name,seq_name_length);
+  } else { // Defined name
+    register gt_string* const defined_seq_name =
+        gt_binary_file_format_get_seq_name(record->binary_file_format,seq_name_ref-1);
+    if (gt_expect_false(defined_seq_name==NULL)) return GT_IBP_PE_MAP_BAD_SEQ_NAME;
+    gt_map_set_seq_name(map,gt_string_get_string(defined_seq_name),gt_string_get_length(defined_seq_name));
+  }
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_parse_map(gt_ibp_record* const record,gt_map* map,const uint64_t read_length) {
+  register gt_status error_code;
+  uint64_t position, num_misms, token, size;
+  int64_t base_length_delta, score, junction_size;
+  uint8_t junction, base;
+  while (true) {
+    // Location
+    if ((error_code=gt_ibp_parse_seq_name(record,map))) return error_code;
+    if ((error_code=gt_ibp_get_varint(record,&position))) return error_code;
+    if ((error_code=gt_ibp_get_zigzag(record,&base_length_delta))) return error_code;
+    if ((error_code=gt_ibp_get_zigzag(record,&score))) return error_code;
+    gt_map_set_position(map,position>>1);
+    gt_map_set_strand(map,(position&1) ? REVERSE : FORWARD);
+    gt_map_set_base_length(map,read_length+base_length_delta);
+    gt_map_set_score(map,score);
+    // Mismatches
+    if ((error_code=gt_ibp_get_varint(record,&num_misms))) return error_code;
+    register uint64_t i, misms_pos = 0;
+    gt_misms misms;
+    for (i=0;i<num_misms;++i) {
+      if ((error_code=gt_ibp_get_varint(record,&token))) return error_code;
+      misms_pos += token>>GT_BINARY_MISMS_CODE_BITS;
+      register const uint64_t code = token&((1<<GT_BINARY_MISMS_CODE_BITS)-1);
+      switch (code) {
+        case GT_BINARY_MISMS_BASE ... GT_BINARY_MISMS_BASE+3:
+          gt_misms_set_mismatch(&misms,misms_pos,gt_cdna_decode[code-GT_BINARY_MISMS_BASE]);
+          break;
+        case GT_BINARY_MISMS_CHAR:
+          if ((error_code=gt_ibp_get_byte(record,&base))) return error_code;
+          gt_misms_set_mismatch(&misms,misms_pos,base);
+          break;
+        case GT_BINARY_MISMS_INS:
+          if ((error_code=gt_ibp_get_varint(record,&size))) return error_code;
+          gt_misms_set_insertion(&misms,misms_pos,size);
+          break;
+        case GT_BINARY_MISMS_DEL:
+          if ((error_code=gt_ibp_get_varint(record,&size))) return error_code;
+          gt_misms_set_deletion(&misms,misms_pos,size);
+          break;
+        default:
+          return GT_IBP_PE_MAP_BAD_MISMS;
+      }
+      gt_map_add_misms(map,&misms);
+    }
+    // Junction to the next block (if any)
+    if ((error_code=gt_ibp_get_byte(record,&junction))) return error_code;
+    if (junction==0) return 0;
+    if (gt_expect_false(junction>JUNCTION_UNKNOWN+1)) return GT_IBP_PE_MAP_BAD_JUNCTION;
+    if ((error_code=gt_ibp_get_zigzag(record,&junction_size))) return error_code;
+    register gt_map* const next_map = gt_map_new();
+    gt_map_set_next_block(map,next_map,junction-1,junction_size);
+    map = next_map;
+  }
+}
+GT_INLINE gt_status gt_ibp_parse_alignment_maps(gt_ibp_record* const record,gt_alignment* const alignment) {
+  register gt_status error_code;
+  uint64_t num_maps;
+  if ((error_code=gt_ibp_get_varint(record,&num_maps))) return error_code;
+  register const uint64_t read_length = gt_alignment_get_read_length(alignment);
+  register uint64_t i;
+  for (i=0;i<num_maps;++i) {
+    register gt_map* const map = gt_map_new();
+    gt_alignment_add_map(alignment,map);
+    if ((error_code=gt_ibp_parse_map(record,map,read_length))) return error_code;
+  }
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_parse_template_mmaps(gt_ibp_record* const record,gt_template* const template) {
+  register gt_status error_code = 0;
+  register const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  uint64_t num_mmaps, map_idx, distance;
+  if ((error_code=gt_ibp_get_varint(record,&num_mmaps))) return error_code;
+  if (num_mmaps==0) return 0;
+  if (gt_expect_false(num_blocks==1)) return GT_IBP_PE_BAD_NUMBER_OF_BLOCKS;
+  register gt_vector* const vector_maps = gt_vector_new(num_blocks,sizeof(gt_map*));
+  gt_mmap_attributes mmap_attr;
+  register uint64_t i, j;
+  for (i=0;i<num_mmaps;++i) {
+    gt_vector_clear(vector_maps);
+    for (j=0;j<num_blocks;++j) {
+      register gt_alignment* const alignment = gt_template_get_block(template,j);
+      if ((error_code=gt_ibp_get_varint(record,&map_idx))) break;
+      if (gt_expect_false(map_idx>=gt_alignment_get_num_maps(alignment))) {
+        error_code = GT_IBP_PE_MMAP_BAD_MAP_REFERENCE; break;
+      }
+      gt_vector_insert(vector_maps,gt_alignment_get_map(alignment,map_idx),gt_map*);
+    }
+    if (error_code) break;
+    gt_template_mmap_attr_new(&mmap_attr);
+    if ((error_code=gt_ibp_get_varint(record,&distance))) break;
+    if ((error_code=gt_ibp_get_zigzag(record,&mmap_attr.score))) break;
+    mmap_attr.distance = distance;
+    gt_template_add_mmap_gtvector(template,vector_maps,&mmap_attr);
+  }
+  gt_vector_delete(vector_maps);
+  return error_code;
+}
+GT_INLINE gt_status gt_ibp_begin_record(
+    char* const line_start,char* const line_end,gt_binary_file_format* const binary_file_format,
+    gt_ibp_record* const record,gt_string* const tag,gt_shash* const attributes) {
+  register gt_status error_code;
+  if (gt_expect_false(line_start==line_end || *line_start!=GT_BINARY_RECORD_BEGIN)) return GT_IBP_PE_WRONG_FILE_FORMAT;
+  // TAG (text)
+  char* text_line = line_start+1;
+  gt_input_parse_tag(&text_line,tag,attributes);
+  if (gt_expect_false(text_line>line_end)) return GT_IBP_PE_PREMATURE_EOR;
+  // Unescape the payload (in place)
+  char* payload_end;
+  if ((error_code=gt_ibp_unescape(text_line,line_end,&payload_end))) return error_code;
+  // Setup decoder
+  record->cursor = (uint8_t*)text_line;
+  record->end = (uint8_t*)payload_end;
+  record->binary_file_format = binary_file_format;
+  return 0;
+}
+GT_INLINE gt_status gt_ibp_parse_template(
+    char* const line_start,char* const line_end,gt_binary_file_format* const binary_file_format,gt_template* const template) {
+  register gt_status error_code;
+  gt_ibp_record record;
+  // TAG
+  if ((error_code=gt_ibp_begin_record(line_start,line_end,binary_file_format,
+      &record,template->tag,template->attributes))) return error_code;
+  // READ(s) & QUALITIES
+  uint64_t num_blocks;
+  if ((error_code=gt_ibp_get_varint(&record,&num_blocks))) return error_code;
+  if (gt_expect_false(num_blocks==0)) return GT_IBP_PE_BAD_NUMBER_OF_BLOCKS;
+  register uint64_t i;
+  for (i=0;i<num_blocks;++i) {
+    if ((error_code=gt_ibp_parse_read_block(&record,gt_template_get_block_dyn(template,i)))) return error_code;
+  }
+  // TAG Setup (Pair information based on template pair and num_blocks)
+  gt_template_setup_pair_attributes_to_alignments(template,true);
+  // COUNTERS
+  uint64_t mcs;
+  bool not_unique;
+  if ((error_code=gt_ibp_parse_counters(&record,(num_blocks>1) ?
+      gt_template_get_counters_vector(template) :
+      gt_alignment_get_counters_vector(gt_template_get_block(template,0)),&mcs,&not_unique))) return error_code;
+  if (mcs!=UINT64_MAX) gt_template_set_mcs(template,mcs);
+  if (not_unique) gt_template_set_not_unique_flag(template,true);
+  // MAPS
+  for (i=0;i<num_blocks;++i) {
+    if ((error_code=gt_ibp_parse_alignment_maps(&record,gt_template_get_block(template,i)))) return error_code;
+  }
+  return gt_ibp_parse_template_mmaps(&record,template);
+}
+GT_INLINE gt_status gt_ibp_parse_alignment(
+    char* const line_start,char* const line_end,gt_binary_file_format* const binary_file_format,gt_alignment* const alignment) {
+  register gt_status error_code;
+  gt_ibp_record record;
+  // TAG
+  if ((error_code=gt_ibp_begin_record(line_start,line_end,binary_file_format,
+      &record,alignment->tag,alignment->attributes))) return error_code;
+  // READ & QUALITIES
+  uint64_t num_blocks;
+  if ((error_code=gt_ibp_get_varint(&record,&num_blocks))) return error_code;
+  if (gt_expect_false(num_blocks!=1)) return GT_IBP_PE_BAD_NUMBER_OF_BLOCKS;
+  if ((error_code=gt_ibp_parse_read_block(&record,alignment))) return error_code;
+  // COUNTERS
+  uint64_t mcs;
+  bool not_unique;
+  if ((error_code=gt_ibp_parse_counters(&record,gt_alignment_get_counters_vector(alignment),&mcs,&not_unique))) return error_code;
+  if (mcs!=UINT64_MAX) gt_alignment_set_mcs(alignment,mcs);
+  if (not_unique) gt_alignment_set_not_unique_flag(alignment,true);
+  // MAPS
+  if ((error_code=gt_ibp_parse_alignment_maps(&record,alignment))) return error_code;
+  uint64_t num_mmaps;
+  if ((error_code=gt_ibp_get_varint(&record,&num_mmaps))) return error_code;
+  return (num_mmaps==0) ? 0 : GT_IBP_PE_BAD_NUMBER_OF_BLOCKS;
+}
+
+/*
+ * High Level Parsers
+ */
+GT_INLINE gt_status gt_ibp_get_record(gt_buffered_input_file* const buffered_binary_input,char** const line_end) {
+  register gt_input_file* const input_file = buffered_binary_input->input_file;
+  register gt_status error_code;
+  while (true) {
+    // Check the end_of_block. Reload buffer if needed
+    if (gt_buffered_input_file_eob(buffered_binary_input)) {
+      if ((error_code=gt_input_binary_parser_reload_buffer(buffered_binary_input))!=GT_IBP_OK) return error_code;
+    }
+    // Check file format
+    if (gt_input_binary_parser_check_binary_file_format(buffered_binary_input)) {
+      gt_error(PARSE_BINARY_BAD_FILE_FORMAT,input_file->file_name,buffered_binary_input->current_line_num);
+      return GT_IBP_FAIL;
+    }
+    // Delimit the record (escaped, so the payload never contains EOL)
+    register char* cursor = buffered_binary_input->cursor;
+    while (*cursor!=EOL) ++cursor;
+    if (*buffered_binary_input->cursor!=GT_BINARY_SEQ_NAME_DEFINITION) {
+      *line_end = cursor;
+      return GT_IBP_OK;
+    }
+    // Sequence name definition (already registered when the block was read)
+    if (gt_ibp_parse_seq_name_definition(buffered_binary_input->cursor,cursor,NULL)) {
+      gt_input_binary_parser_prompt_error(buffered_binary_input,
+          buffered_binary_input->current_line_num,GT_IBP_PE_BAD_SEQ_NAME_DEFINITION);
+      return GT_IBP_FAIL;
+    }
+    buffered_binary_input->cursor = cursor;
+    gt_input_binary_parser_next_record(buffered_binary_input);
+  }
+}
+GT_INLINE gt_status gt_input_binary_parser_get_template(
+    gt_buffered_input_file* const buffered_binary_input,gt_template* const template) {
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_binary_input);
+  GT_TEMPLATE_CHECK(template);
+  register gt_status error_code;
+  char* line_end;
+  if ((error_code=gt_ibp_get_record(buffered_binary_input,&line_end))!=GT_IBP_OK) return error_code;
+  // Prepare the template
+  register char* const line_start = buffered_binary_input->cursor;
+  register const uint64_t line_num = buffered_binary_input->current_line_num;
+  gt_template_clear(template,true);
+  template->template_id = line_num;
+  // Parse template
+  error_code = gt_ibp_parse_template(line_start,line_end,&(buffered_binary_input->input_file->binary_type),template);
+  buffered_binary_input->cursor = line_end;
+  gt_input_binary_parser_next_record(buffered_binary_input);
+  if (error_code) {
+    gt_input_binary_parser_prompt_error(buffered_binary_input,line_num,error_code);
+    return GT_IBP_FAIL;
+  }
+  return GT_IBP_OK;
+}
+GT_INLINE gt_status gt_input_binary_parser_get_alignment(
+    gt_buffered_input_file* const buffered_binary_input,gt_alignment* const alignment) {
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_binary_input);
+  GT_ALIGNMENT_CHECK(alignment);
+  register gt_status error_code;
+  char* line_end;
+  if ((error_code=gt_ibp_get_record(buffered_binary_input,&line_end))!=GT_IBP_OK) return error_code;
+  // Prepare the alignment
+  register char* const line_start = buffered_binary_input->cursor;
+  register const uint64_t line_num = buffered_binary_input->current_line_num;
+  gt_alignment_clear(alignment);
+  alignment->alignment_id = line_num;
+  // Parse alignment
+  error_code = gt_ibp_parse_alignment(line_start,line_end,&(buffered_binary_input->input_file->binary_type),alignment);
+  buffered_binary_input->cursor = line_end;
+  gt_input_binary_parser_next_record(buffered_binary_input);
+  if (error_code) {
+    gt_input_binary_parser_prompt_error(buffered_binary_input,line_num,error_code);
+    return GT_IBP_FAIL;
+  }
+  return GT_IBP_OK;
+}
+
+/*
+ * Synch read of blocks
+ */
+GT_INLINE gt_status gt_input_binary_parser_synch_blocks_v(
+    pthread_mutex_t* const input_mutex,uint64_t num_inputs,gt_buffered_input_file* const buffered_input,va_list v_args) {
+  GT_NULL_CHECK(input_mutex);
+  GT_ZERO_CHECK(num_inputs);
+  register gt_status error_code;
+  // Check the end_of_block. Reload buffer if needed (synch)
+  if (gt_buffered_input_file_eob(buffered_input)) {
+    // Dump buffer if BOF it attached to the input, and get new out block (always FIRST)
+    if (buffered_input->buffered_output_file!=NULL) {
+      gt_buffered_output_file_dump(buffered_input->buffered_output_file);
+    }
+    // Read synch blocks & Reload all the 'buffered_input' files
+    GT_BEGIN_MUTEX_SECTION(*input_mutex) {
+      if ((error_code=gt_input_binary_parser_reload_buffer(buffered_input))!=GT_IBP_OK) {
+        GT_END_MUTEX_SECTION(*input_mutex);
+        return error_code;
+      }
+      while ((--num_inputs)>0) {
+        register gt_buffered_input_file* remaining_buffered_input = va_arg(v_args,gt_buffered_input_file*);
+        GT_BUFFERED_INPUT_FILE_CHECK(remaining_buffered_input);
+        if ((error_code=gt_input_binary_parser_reload_buffer(remaining_buffered_input))!=GT_IBP_OK) {
+          GT_END_MUTEX_SECTION(*input_mutex);
+          return error_code;
+        }
+      }
+    } GT_END_MUTEX_SECTION(*input_mutex);
+  }
+  return GT_IBP_OK;
+}
+GT_INLINE gt_status gt_input_binary_parser_synch_blocks_va(
+    pthread_mutex_t* const input_mutex,const uint64_t num_inputs,gt_buffered_input_file* const buffered_input,...) {
+  GT_NULL_CHECK(input_mutex);
+  GT_ZERO_CHECK(num_inputs);
+  va_list v_args;
+  va_start(v_args,buffered_input);
+  register gt_status error_code = gt_input_binary_parser_synch_blocks_v(input_mutex,num_inputs,buffered_input,v_args);
+  va_end(v_args);
+  return error_code;
+}
+GT_INLINE gt_status gt_input_binary_parser_synch_blocks_a(
+    pthread_mutex_t* const input_mutex,gt_buffered_input_file** const buffered_input,const uint64_t num_inputs) {
+  GT_NULL_CHECK(input_mutex);
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_input[0]);
+  register gt_status error_code;
+  // Check the end_of_block. Reload buffer if needed (synch)
+  if (gt_buffered_input_file_eob(buffered_input[0])) {
+    // Dump buffer if BOF it attached to the input, and get new out block (always FIRST)
+    if (buffered_input[0]->buffered_output_file!=NULL) {
+      gt_buffered_output_file_dump(buffered_input[0]->buffered_output_file);
+    }
+    // Read synch blocks
+    GT_BEGIN_MUTEX_SECTION(*input_mutex) {
+      register uint64_t i;
+      for (i=0;i<num_inputs;++i) {
+        GT_BUFFERED_INPUT_FILE_CHECK(buffered_input[i]);
+        if ((error_code=gt_input_binary_parser_reload_buffer(buffered_input[i]))!=GT_IBP_OK) {
+          GT_END_MUTEX_SECTION(*input_mutex);
+          return error_code;
+        }
+      }
+    } GT_END_MUTEX_SECTION(*input_mutex);
+  }
+  return GT_IBP_OK;
+}
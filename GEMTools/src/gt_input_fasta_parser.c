@@ -212,10 +212,8 @@ GT_INLINE gt_status gt_input_fasta_parse_tag(char** const text_line,gt_string* c
 
 #define GT_INPUT_FASTQ_PARSE_READ_CHARS(read_begin,length) \
   register char* const read_begin = *text_line; \
-  while (!GT_IS_EOL(text_line)) { \
-    if (gt_expect_false(!gt_is_dna(**text_line))) return GT_IFP_PE_READ_BAD_CHARACTER; \
-    GT_NEXT_CHAR(text_line); \
-  } \
+  *text_line = gt_dna_read_scan_read_line(read_begin); \
+  if (gt_expect_false(!GT_IS_EOL(text_line))) return GT_IFP_PE_READ_BAD_CHARACTER; \
   register const uint64_t length = (*text_line-read_begin)
 GT_INLINE gt_status gt_input_fasta_parse_read_s(char** const text_line,gt_string* const read) {
   GT_INPUT_FASTQ_PARSE_READ_CHARS(read_begin,length);
@@ -230,21 +228,21 @@ GT_INLINE gt_status gt_input_fasta_parse_read_sq(char** const text_line,gt_segme
   return 0;
 }
 
-#define GT_INPUT_FASTA_PARSE_QUALITIES_CHARS(quals_begin,length) \
+#define GT_INPUT_FASTA_PARSE_QUALITIES_CHARS(quals_begin,length,min_quality,max_quality) \
   register char* const quals_begin = *text_line; \
-  while (!GT_IS_EOL(text_line)) { \
-    if (gt_expect_false(!gt_is_valid_quality(**text_line))) return GT_IFP_PE_QUALS_BAD_CHARACTER; \
-    GT_NEXT_CHAR(text_line); \
-  } \
+  *text_line = gt_dna_read_scan_qualities_line(quals_begin,min_quality,max_quality); \
+  if (gt_expect_false(!GT_IS_EOL(text_line))) return GT_IFP_PE_QUALS_BAD_CHARACTER; \
   register const uint64_t length = (*text_line-quals_begin)
-GT_INLINE gt_status gt_input_fasta_parse_qualities_s(char** const text_line,gt_string* const read) {
-  GT_INPUT_FASTA_PARSE_QUALITIES_CHARS(quals_begin,length);
+GT_INLINE gt_status gt_input_fasta_parse_qualities_s(
+    char** const text_line,gt_string* const read,uint8_t* const min_quality,uint8_t* const max_quality) {
+  GT_INPUT_FASTA_PARSE_QUALITIES_CHARS(quals_begin,length,min_quality,max_quality);
   gt_string_append_string(read,quals_begin,length);
   GT_NEXT_CHAR(text_line);
   return 0;
 }
-GT_INLINE gt_status gt_input_fasta_parse_qualities_sq(char** const text_line,gt_segmented_sequence* const segmented_sequence) {
-  GT_INPUT_FASTA_PARSE_QUALITIES_CHARS(quals_begin,length);
+GT_INLINE gt_status gt_input_fasta_parse_qualities_sq(
+    char** const text_line,gt_segmented_sequence* const segmented_sequence,uint8_t* const min_quality,uint8_t* const max_quality) {
+  GT_INPUT_FASTA_PARSE_QUALITIES_CHARS(quals_begin,length,min_quality,max_quality);
   gt_segmented_sequence_append_string(segmented_sequence,quals_begin,length);
   GT_NEXT_CHAR(text_line);
   return 0;
@@ -256,7 +254,8 @@ GT_INLINE gt_status gt_input_fasta_parse_qualities_sq(char** const text_line,gt_
  */
 GT_INLINE gt_status gt_ifp_parse_read(
     char** const text_line,gt_string* const tag,gt_string* const read,
-    const bool has_qualitites,gt_string* const qualities,gt_shash* const attributes) {
+    const bool has_qualitites,gt_string* const qualities,gt_shash* const attributes,
+    uint8_t* const min_quality,uint8_t* const max_quality) {
   // Parse TAG
   register gt_status error_code;
 
@@ -269,7 +268,7 @@ GT_INLINE gt_status gt_ifp_parse_read(
     if (**text_line!=GT_IFP_FASTQ_SEP) return GT_IFP_PE_SEPARATOR_BAD_CHARACTER;
     GT_SKIP_LINE(text_line); GT_NEXT_CHAR(text_line);
     // Parse qualities string
-    if ((error_code=gt_input_fasta_parse_qualities_s(text_line,qualities))) return error_code;
+    if ((error_code=gt_input_fasta_parse_qualities_s(text_line,qualities,min_quality,max_quality))) return error_code;
     // Check lengths
     if (gt_expect_false(gt_string_get_length(read)!=gt_string_get_length(qualities))) return GT_IFP_PE_QUALS_BAD_LENGTH;
   }
@@ -278,7 +277,8 @@ GT_INLINE gt_status gt_ifp_parse_read(
 
 GT_INLINE gt_status gt_ifp_parse_fasta_fastq_read(
     gt_buffered_input_file* const buffered_fasta_input,
-    gt_string* const tag,gt_string* const read,gt_string* const qualities,gt_shash* const attributes) {
+    gt_string* const tag,gt_string* const read,gt_string* const qualities,gt_shash* const attributes,
+    uint8_t* const min_quality,uint8_t* const max_quality) {
   /*
    * Check input file
    */
@@ -302,11 +302,17 @@ GT_INLINE gt_status gt_ifp_parse_fasta_fastq_read(
   register const uint64_t line_num = buffered_fasta_input->current_line_num;
   // Parse read
 
-  if ((error_code=gt_ifp_parse_read(&(buffered_fasta_input->cursor),tag,read,fasta_format==F_FASTQ,qualities,attributes))) {
+  *min_quality = UINT8_MAX;
+  *max_quality = 0;
+  if ((error_code=gt_ifp_parse_read(&(buffered_fasta_input->cursor),tag,read,fasta_format==F_FASTQ,qualities,attributes,
+      min_quality,max_quality))) {
     gt_input_fasta_parser_prompt_error(buffered_fasta_input,line_num,buffered_fasta_input->cursor-line_start,error_code);
     gt_input_fasta_parser_next_record(buffered_fasta_input,line_start);
     return GT_IFP_FAIL;
   }
+  // Qualities range seen by the buffered input
+  buffered_fasta_input->min_quality = GT_MIN(buffered_fasta_input->min_quality,*min_quality);
+  buffered_fasta_input->max_quality = GT_MAX(buffered_fasta_input->max_quality,*max_quality);
   // Update total number lines read
   if (fasta_format==F_FASTA) buffered_fasta_input->current_line_num+=2;
   if (fasta_format==F_FASTQ) buffered_fasta_input->current_line_num+=4;
@@ -322,7 +328,8 @@ GT_INLINE gt_status gt_input_fasta_parser_get_read(
   gt_dna_read_clear(dna_read);
   // Parse FASTA/FASTQ record
   return gt_ifp_parse_fasta_fastq_read(buffered_fasta_input,
-      dna_read->tag,dna_read->read,dna_read->qualities,dna_read->attributes);
+      dna_read->tag,dna_read->read,dna_read->qualities,dna_read->attributes,
+      &dna_read->min_quality,&dna_read->max_quality);
 }
 GT_INLINE gt_status gt_input_fasta_parser_get_alignment(
     gt_buffered_input_file* const buffered_fasta_input,gt_alignment* const alignment) {
@@ -331,8 +338,9 @@ GT_INLINE gt_status gt_input_fasta_parser_get_alignment(
   // Prepare read
   gt_alignment_clear(alignment);
   // Parse FASTA/FASTQ record
+  uint8_t min_quality, max_quality;
   return gt_ifp_parse_fasta_fastq_read(buffered_fasta_input,
-      alignment->tag,alignment->read,alignment->qualities,alignment->attributes);
+      alignment->tag,alignment->read,alignment->qualities,alignment->attributes,&min_quality,&max_quality);
 }
 GT_INLINE gt_status gt_input_fasta_parser_get_template(
     gt_buffered_input_file* const buffered_fasta_input,gt_template* const template,const bool paired_read) {
@@ -364,61 +372,161 @@ GT_INLINE gt_status gt_input_fasta_parser_get_template(
   return GT_IFP_OK;
 }
 
-#define GT_INPUT_MULTIFASTA_RETURN_ERROR(error_code) \
-  gt_string_delete(buffer);  \
-  gt_segmented_sequence_delete(seg_seq); \
-  return GT_IFP_PE_TAG_BAD_BEGINNING
+GT_INLINE gt_status gt_input_fasta_parser_deduce_qualities_offset(
+    gt_buffered_input_file* const buffered_fasta_input,gt_qualities_offset_t* const qualities_offset_type) {
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_fasta_input);
+  GT_NULL_CHECK(qualities_offset_type);
+  if (buffered_fasta_input->max_quality==0) return GT_STATUS_FAIL; // No qualities parsed yet
+  return gt_qualities_deduce_offset(buffered_fasta_input->min_quality,qualities_offset_type);
+}
 
-GT_INLINE gt_status gt_input_multifasta_parser_get_archive(
-    gt_input_file* const input_multifasta_file,gt_sequence_archive* const sequence_archive) {
+/*
+ * MultiFASTA Archive loader
+ *   (1) A single pass over the input buffer (whole file if mmapped) locates the headers and
+ *       normalizes the sequence lines into one plain buffer (sequences one after the other)
+ *   (2) Pending sequences are encoded into their segmented blocks in parallel (per block)
+ *       every GT_IFP_MULTIFASTA_BATCH_SIZE chars (and at EOF)
+ */
+#define GT_IFP_MULTIFASTA_BATCH_SIZE GT_BUFFER_SIZE_512M
+
+typedef struct {
+  gt_vector* sequences;  /* (gt_segmented_sequence*) */
+  gt_vector* offsets;    /* (uint64_t) Beginning of each sequence in @raw_buffer */
+  gt_vector* raw_buffer; /* (char) Normalized plain sequences (reused across batches) */
+} gt_ifp_multifasta_batch;
+
+GT_INLINE void gt_input_multifasta_parser_encode_batch(
+    gt_ifp_multifasta_batch* const batch,gt_sequence_archive* const sequence_archive,const uint64_t num_threads) {
+  register const uint64_t num_sequences = gt_vector_get_used(batch->sequences);
+  if (num_sequences==0) return;
+  // Collect plain strings
+  char** const strings = malloc(num_sequences*sizeof(char*));
+  gt_cond_fatal_error(!strings,MEM_HANDLER);
+  uint64_t* const lengths = malloc(num_sequences*sizeof(uint64_t));
+  gt_cond_fatal_error(!lengths,MEM_HANDLER);
+  register char* const raw_mem = gt_vector_get_mem(batch->raw_buffer,char);
+  register uint64_t* const offsets = gt_vector_get_mem(batch->offsets,uint64_t);
+  register uint64_t i;
+  for (i=0;i<num_sequences;++i) {
+    register const uint64_t end = (i+1<num_sequences) ? offsets[i+1] : gt_vector_get_used(batch->raw_buffer);
+    strings[i] = raw_mem+offsets[i];
+    lengths[i] = end-offsets[i];
+  }
+  // Encode (parallel)
+  register gt_segmented_sequence** const sequences = gt_vector_get_mem(batch->sequences,gt_segmented_sequence*);
+  gt_segmented_sequence_append_strings_parallel(sequences,strings,lengths,num_sequences,num_threads);
+  // Store the parsed sequences
+  for (i=0;i<num_sequences;++i) {
+    gt_sequence_archive_add_sequence(sequence_archive,sequences[i]);
+  }
+  free(strings);
+  free(lengths);
+  gt_vector_clear(batch->sequences);
+  gt_vector_clear(batch->offsets);
+  gt_vector_clear(batch->raw_buffer);
+}
+GT_INLINE void gt_input_multifasta_parser_batch_add_sequence(
+    gt_ifp_multifasta_batch* const batch,gt_segmented_sequence* const seg_seq) {
+  gt_vector_insert(batch->sequences,seg_seq,gt_segmented_sequence*);
+  gt_vector_insert(batch->offsets,gt_vector_get_used(batch->raw_buffer),uint64_t);
+}
+GT_INLINE void gt_input_multifasta_parser_batch_delete(gt_ifp_multifasta_batch* const batch) {
+  // Pending sequences (not encoded, not in the archive)
+  GT_VECTOR_ITERATE(batch->sequences,seg_seq,seg_seq_num,gt_segmented_sequence*) {
+    gt_segmented_sequence_delete(*seg_seq);
+  }
+  gt_vector_delete(batch->sequences);
+  gt_vector_delete(batch->offsets);
+  gt_vector_delete(batch->raw_buffer);
+}
+
+GT_INLINE gt_status gt_input_multifasta_parser_get_archive_parallel(
+    gt_input_file* const input_multifasta_file,gt_sequence_archive* const sequence_archive,const uint64_t num_threads) {
   GT_INPUT_FILE_CHECK(input_multifasta_file);
   GT_SEQUENCE_ARCHIVE_CHECK(sequence_archive);
+  GT_ZERO_CHECK(num_threads);
   // Clear sequence archive
   gt_sequence_archive_clear(sequence_archive);
-  // Check the file. Reload buffer if needed
+  // Check the file
   if (input_multifasta_file->eof) return GT_IFP_OK;
-  GT_INPUT_FILE_CHECK(input_multifasta_file);
   // Read all sequences
-  register gt_string* const buffer = gt_string_new(200); // TODO: Should be done in terms of dna_string
-  while (!input_multifasta_file->eof) {
-    register gt_segmented_sequence* seg_seq = gt_segmented_sequence_new();
-    // Parse TAG
-    if (GT_INPUT_FILE_CURRENT_CHAR(input_multifasta_file)!=GT_IFP_FASTA_TAG_BEGIN) {
-      GT_INPUT_MULTIFASTA_RETURN_ERROR(GT_IFP_PE_TAG_BAD_BEGINNING);
-    }
-    GT_INPUT_FILE_NEXT_CHAR(input_multifasta_file);
-    while (gt_expect_true(!input_multifasta_file->eof &&
-        GT_INPUT_FILE_CURRENT_CHAR(input_multifasta_file)!=EOL &&
-        GT_INPUT_FILE_CURRENT_CHAR(input_multifasta_file)!=DOS_EOL)) {
-      gt_string_append_char(seg_seq->seq_name,GT_INPUT_FILE_CURRENT_CHAR(input_multifasta_file));
-      GT_INPUT_FILE_NEXT_CHAR(input_multifasta_file);
-    }
-    GT_INPUT_FILE_SKIP_EOL(input_multifasta_file);
-    gt_string_append_eos(seg_seq->seq_name);
-    // Parse all the sequence lines
-    while (gt_expect_true(!input_multifasta_file->eof)) {
-      if (gt_expect_true(gt_is_iupac_code(GT_INPUT_FILE_CURRENT_CHAR(input_multifasta_file)))) {
-        // TODO: gt_get_dna_normalized should be transparent
-        gt_string_append_char(buffer,
-            gt_get_dna_normalized(GT_INPUT_FILE_CURRENT_CHAR(input_multifasta_file)));
-        GT_INPUT_FILE_NEXT_CHAR(input_multifasta_file);
-      } else if (GT_INPUT_FILE_CURRENT_CHAR(input_multifasta_file)==EOL ||
-                 GT_INPUT_FILE_CURRENT_CHAR(input_multifasta_file)==DOS_EOL) {
-        // Append string and clear buffer (next line!)
-        gt_segmented_sequence_append_string(seg_seq,
-            gt_string_get_string(buffer),gt_string_get_length(buffer));
-        gt_string_clear(buffer);
-        GT_INPUT_FILE_SKIP_EOL(input_multifasta_file);
-      } else if (GT_INPUT_FILE_CURRENT_CHAR(input_multifasta_file)==GT_IFP_FASTA_TAG_BEGIN) {
-        break; // Next sequence !
+  gt_ifp_multifasta_batch batch;
+  batch.sequences = gt_vector_new(100,sizeof(gt_segmented_sequence*));
+  batch.offsets = gt_vector_new(100,sizeof(uint64_t));
+  batch.raw_buffer = gt_vector_new(GT_BUFFER_SIZE_16M,sizeof(char));
+  register gt_segmented_sequence* seg_seq = NULL;
+  register gt_vector* const raw_buffer = batch.raw_buffer;
+  register bool line_begin = true, parsing_tag = false;
+  do {
+    register const char* const buffer = (char*)input_multifasta_file->file_buffer;
+    register const uint64_t buffer_size = input_multifasta_file->buffer_size;
+    register uint64_t buffer_pos = input_multifasta_file->buffer_pos;
+    while (buffer_pos < buffer_size) {
+      // Check TAG
+      if (line_begin) {
+        line_begin = false;
+        if (buffer[buffer_pos]==GT_IFP_FASTA_TAG_BEGIN) {
+          // Store the previous sequence (encode the batch if needed)
+          if (gt_vector_get_used(raw_buffer) >= GT_IFP_MULTIFASTA_BATCH_SIZE) {
+            gt_input_multifasta_parser_encode_batch(&batch,sequence_archive,num_threads);
+          }
+          seg_seq = gt_segmented_sequence_new();
+          gt_input_multifasta_parser_batch_add_sequence(&batch,seg_seq);
+          parsing_tag = true;
+          ++buffer_pos;
+          continue;
+        } else if (gt_expect_false(seg_seq==NULL)) {
+          gt_input_multifasta_parser_batch_delete(&batch);
+          return GT_IFP_PE_TAG_BAD_BEGINNING;
+        }
+      }
+      // Locate the end of the line (or chunk)
+      register const char* const eol = memchr(buffer+buffer_pos,EOL,buffer_size-buffer_pos);
+      register const uint64_t chunk_end = (eol!=NULL) ? eol-buffer : buffer_size;
+      register const uint64_t chunk_length = chunk_end-buffer_pos;
+      if (parsing_tag) {
+        gt_string_append_string(seg_seq->seq_name,(char*)buffer+buffer_pos,chunk_length);
+      } else {
+        // Normalize the sequence chunk (skipping non-IUPAC chars as DOS_EOL)
+        gt_cond_fatal_error(gt_vector_reserve_additional(raw_buffer,chunk_length)!=GT_VECTOR_OK,MEM_ALLOC);
+        register char* const raw_mem = gt_vector_get_free_elm(raw_buffer,char);
+        register uint64_t i, raw_length = 0;
+        for (i=buffer_pos;i<chunk_end;++i) {
+          register const uint8_t character = buffer[i];
+          raw_mem[raw_length] = gt_dna_normalized[character];
+          raw_length += gt_iupac_code[character];
+        }
+        gt_vector_add_used(raw_buffer,raw_length);
+      }
+      // Handle EOL
+      if (eol!=NULL) {
+        if (parsing_tag) {
+          register const uint64_t tag_length = gt_string_get_length(seg_seq->seq_name);
+          if (tag_length>0 && gt_string_get_string(seg_seq->seq_name)[tag_length-1]==DOS_EOL) {
+            gt_string_set_length(seg_seq->seq_name,tag_length-1);
+          }
+          gt_string_append_eos(seg_seq->seq_name);
+          parsing_tag = false;
+        }
+        line_begin = true;
+        buffer_pos = chunk_end+1;
+      } else {
+        buffer_pos = buffer_size;
       }
     }
-    // Store the parsed sequence
-    gt_sequence_archive_add_sequence(sequence_archive,seg_seq);
-  }
-  gt_string_delete(buffer);
+    input_multifasta_file->buffer_pos = buffer_size;
+    gt_input_file_fill_buffer(input_multifasta_file);
+  } while (!input_multifasta_file->eof);
+  // Store the last sequences
+  if (parsing_tag) gt_string_append_eos(seg_seq->seq_name);
+  gt_input_multifasta_parser_encode_batch(&batch,sequence_archive,num_threads);
+  gt_input_multifasta_parser_batch_delete(&batch);
   return GT_IFP_OK;
 }
+GT_INLINE gt_status gt_input_multifasta_parser_get_archive(
+    gt_input_file* const input_multifasta_file,gt_sequence_archive* const sequence_archive) {
+  return gt_input_multifasta_parser_get_archive_parallel(input_multifasta_file,sequence_archive,1);
+}
 
 /*
  * FASTQ utils
@@ -517,3 +625,29 @@ GT_INLINE gt_status gt_input_fasta_parser_synch_blocks_a(
   }
   return GT_IFP_OK;
 }
+GT_INLINE gt_status gt_input_fasta_parser_synch_paired_blocks(
+    gt_paired_input_file* const paired_input_file,
+    gt_buffered_input_file* const buffered_input_end1,gt_buffered_input_file* const buffered_input_end2) {
+  GT_PAIRED_INPUT_FILE_CHECK(paired_input_file);
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_input_end1);
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_input_end2);
+  // Check the end_of_block. Reload buffers if needed (synch)
+  if (gt_buffered_input_file_eob(buffered_input_end1)) {
+    // Dump buffer if BOF it attached to the input, and get new out block (always FIRST)
+    if (buffered_input_end1->buffered_output_file!=NULL) {
+      gt_buffered_output_file_dump(buffered_input_end1->buffered_output_file);
+    }
+    // Get the next pair of blocks
+    switch (gt_paired_input_file_get_blocks(paired_input_file,buffered_input_end1,buffered_input_end2)) {
+      case GT_PIF_EOF: return GT_IFP_EOF;
+      case GT_PIF_FAIL: return GT_IFP_FAIL;
+      default: break;
+    }
+    // Assign block ID
+    if (buffered_input_end1->buffered_output_file!=NULL) {
+      gt_buffered_output_file_set_block_ids(
+          buffered_input_end1->buffered_output_file,buffered_input_end1->block_id,0);
+    }
+  }
+  return GT_IFP_OK;
+}
@@ -112,6 +112,7 @@ gt_status gt_input_file_close(gt_input_file* const input_file) {
   GT_INPUT_FILE_CHECK(input_file);
   gt_status status = GT_INPUT_FILE_OK;
   int bzerr;
+  if (input_file->file_format==BINARY) gt_binary_file_format_destroy(&(input_file->binary_type));
   switch (input_file->file_type) {
     case REGULAR_FILE:
       free(input_file->file_buffer);
@@ -159,10 +160,14 @@ gt_input_file* gt_input_file_reads_segmented_file_open(
  */
 GT_INLINE void gt_input_file_lock(gt_input_file* const input_file) {
   GT_INPUT_FILE_CHECK(input_file);
+  GT_PROFILE_START(GT_PROFILE_INPUT_WAIT);
   gt_cond_fatal_error(pthread_mutex_lock(&input_file->input_mutex),SYS_MUTEX);
+  GT_PROFILE_STOP(GT_PROFILE_INPUT_WAIT);
+  GT_PROFILE_START(GT_PROFILE_INPUT_FETCH);
 }
 GT_INLINE void gt_input_file_unlock(gt_input_file* const input_file) {
   GT_INPUT_FILE_CHECK(input_file);
+  GT_PROFILE_STOP(GT_PROFILE_INPUT_FETCH);
   gt_cond_fatal_error(pthread_mutex_unlock(&input_file->input_mutex),SYS_MUTEX);
 }
 GT_INLINE uint64_t gt_input_file_next_id(gt_input_file* const input_file) {
@@ -324,12 +329,19 @@ GT_INLINE bool gt_input_file_test_map(
     gt_input_file* const input_file,gt_map_file_format* const map_file_format,const bool show_errors);
 GT_INLINE bool gt_input_file_test_sam(
     gt_input_file* const input_file,gt_sam_headers* const sam_headers,const bool show_errors);
+GT_INLINE bool gt_input_file_test_binary(
+    gt_input_file* const input_file,gt_binary_file_format* const binary_file_format,const bool show_errors);
 /* */
 gt_file_format gt_input_file_detect_file_format(gt_input_file* const input_file) {
   GT_INPUT_FILE_CHECK(input_file);
   if (input_file->file_format != FILE_FORMAT_UNKNOWN) return input_file->file_format;
   // Try to determine the file format
   gt_input_file_fill_buffer(input_file);
+  // BINARY test (first, as its records begin with a non-printable mark)
+  if (gt_input_file_test_binary(input_file,&(input_file->binary_type),false)) {
+    input_file->file_format = BINARY;
+    return BINARY;
+  }
   // MAP test
   if (gt_input_file_test_map(input_file,&(input_file->map_type),false)) {
     input_file->file_format = MAP;
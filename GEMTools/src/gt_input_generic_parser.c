@@ -43,7 +43,7 @@ GT_INLINE void gt_input_generic_parser_attributes_set_paired(gt_generic_parser_a
 /*
  * Parsers Helpers
  */
-GT_INLINE gt_status gt_input_generic_parser_get_alignment(
+GT_INLINE gt_status gt_igp_get_alignment(
     gt_buffered_input_file* const buffered_input,gt_alignment* const alignment,gt_generic_parser_attr* const attributes) {
   gt_status error_code = GT_IGP_FAIL;
   switch (buffered_input->input_file->file_format) {
@@ -56,13 +56,27 @@ GT_INLINE gt_status gt_input_generic_parser_get_alignment(
     case FASTA:
       return gt_input_fasta_parser_get_alignment(buffered_input,alignment);
       break;
+    case BINARY:
+      return gt_input_binary_parser_get_alignment(buffered_input,alignment);
+      break;
     default:
       gt_fatal_error_msg("File type not supported");
       break;
   }
   return error_code;
 }
-GT_INLINE gt_status gt_input_generic_parser_get_template(
+GT_INLINE gt_status gt_input_generic_parser_get_alignment(
+    gt_buffered_input_file* const buffered_input,gt_alignment* const alignment,gt_generic_parser_attr* const attributes) {
+  if (buffered_input->input_file->file_format==MAP) { // Profiled by the MAP parser
+    return gt_igp_get_alignment(buffered_input,alignment,attributes);
+  }
+  GT_PROFILE_START(GT_PROFILE_PARSE);
+  register const gt_status error_code = gt_igp_get_alignment(buffered_input,alignment,attributes);
+  GT_PROFILE_STOP(GT_PROFILE_PARSE);
+  GT_PROFILE_ADD_RECORD(error_code);
+  return error_code;
+}
+GT_INLINE gt_status gt_igp_get_template(
     gt_buffered_input_file* const buffered_input,gt_template* const template,gt_generic_parser_attr* const attributes) {
   gt_status error_code = GT_IGP_FAIL;
   switch (buffered_input->input_file->file_format) {
@@ -83,12 +97,26 @@ GT_INLINE gt_status gt_input_generic_parser_get_template(
     case FASTA:
       return gt_input_fasta_parser_get_template(buffered_input,template,gt_input_generic_parser_attributes_is_paired(attributes));
       break;
+    case BINARY:
+      return gt_input_binary_parser_get_template(buffered_input,template);
+      break;
     default:
       gt_fatal_error_msg("File type not supported");
       break;
   }
   return error_code;
 }
+GT_INLINE gt_status gt_input_generic_parser_get_template(
+    gt_buffered_input_file* const buffered_input,gt_template* const template,gt_generic_parser_attr* const attributes) {
+  if (buffered_input->input_file->file_format==MAP) { // Profiled by the MAP parser
+    return gt_igp_get_template(buffered_input,template,attributes);
+  }
+  GT_PROFILE_START(GT_PROFILE_PARSE);
+  register const gt_status error_code = gt_igp_get_template(buffered_input,template,attributes);
+  GT_PROFILE_STOP(GT_PROFILE_PARSE);
+  GT_PROFILE_ADD_RECORD(error_code);
+  return error_code;
+}
 
 
 /*
@@ -109,6 +137,9 @@ GT_INLINE gt_status gt_input_generic_parser_synch_blocks_v(
     case FASTA:
       return gt_input_fasta_parser_synch_blocks_v(input_mutex,num_inputs,buffered_input,v_args);
       break;
+    case BINARY:
+      return gt_input_binary_parser_synch_blocks_v(input_mutex,num_inputs,buffered_input,v_args);
+      break;
     default:
       gt_fatal_error_msg("File type not supported");
       break;
@@ -142,6 +173,9 @@ GT_INLINE gt_status gt_input_generic_parser_synch_blocks_a(
     case FASTA:
       return gt_input_fasta_parser_synch_blocks_a(input_mutex,buffered_input,num_inputs);
       break;
+    case BINARY:
+      return gt_input_binary_parser_synch_blocks_a(input_mutex,buffered_input,num_inputs);
+      break;
     default:
       gt_fatal_error_msg("File type not supported");
       break;
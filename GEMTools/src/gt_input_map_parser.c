@@ -242,6 +242,7 @@ GT_INLINE gt_status gt_input_map_parser_reload_buffer_matching_tag(
   }
   input_file->processed_lines+=total_lines_read;
   buffered_map_input->lines_in_buffer = total_lines_read;
+  GT_PROFILE_ADD_BLOCK(gt_vector_get_used(buffered_map_input->block_buffer));
   gt_input_file_unlock(input_file);
   // Setup the block
   buffered_map_input->cursor = gt_vector_get_mem(buffered_map_input->block_buffer,char);
@@ -280,6 +281,7 @@ GT_INLINE gt_status gt_input_map_parser_get_block(
   }
   input_file->processed_lines+=lines_read;
   buffered_map_input->lines_in_buffer = lines_read;
+  GT_PROFILE_ADD_BLOCK(gt_vector_get_used(buffered_map_input->block_buffer));
   gt_input_file_unlock(input_file);
   // Setup the block
   buffered_map_input->cursor = gt_vector_get_mem(buffered_map_input->block_buffer,char);
@@ -1528,11 +1530,8 @@ GT_INLINE void gt_input_map_parser_attributes_set_duplicates_removal(gt_map_pars
 /*
  * MAP General Parsers
  */
-GT_INLINE gt_status gt_input_map_parser_get_template_g(
+GT_INLINE gt_status gt_imp_get_template_g(
     gt_buffered_input_file* const buffered_map_input,gt_template* const template,gt_map_parser_attr* const map_parser_attr) {
-  GT_BUFFERED_INPUT_FILE_CHECK(buffered_map_input);
-  GT_TEMPLATE_CHECK(template);
-  GT_NULL_CHECK(map_parser_attr);
   register gt_status error_code;
   if ((error_code=gt_imp_get_template(buffered_map_input,template,map_parser_attr))!=GT_IMP_OK) {
     return (error_code==GT_IMP_EOF) ? GT_IMP_EOF : GT_IMP_FAIL;
@@ -1550,12 +1549,27 @@ GT_INLINE gt_status gt_input_map_parser_get_template_g(
   }
   return error_code;
 }
+GT_INLINE gt_status gt_input_map_parser_get_template_g(
+    gt_buffered_input_file* const buffered_map_input,gt_template* const template,gt_map_parser_attr* const map_parser_attr) {
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_map_input);
+  GT_TEMPLATE_CHECK(template);
+  GT_NULL_CHECK(map_parser_attr);
+  GT_PROFILE_START(GT_PROFILE_PARSE);
+  register const gt_status error_code = gt_imp_get_template_g(buffered_map_input,template,map_parser_attr);
+  GT_PROFILE_STOP(GT_PROFILE_PARSE);
+  GT_PROFILE_ADD_RECORD(error_code);
+  return error_code;
+}
 GT_INLINE gt_status gt_input_map_parser_get_alignment_g(
     gt_buffered_input_file* const buffered_map_input,gt_alignment* const alignment,gt_map_parser_attr* const map_parser_attr) {
   GT_BUFFERED_INPUT_FILE_CHECK(buffered_map_input);
   GT_ALIGNMENT_CHECK(alignment);
   GT_NULL_CHECK(map_parser_attr);
-  return gt_imp_get_alignment(buffered_map_input,alignment,map_parser_attr);
+  GT_PROFILE_START(GT_PROFILE_PARSE);
+  register const gt_status error_code = gt_imp_get_alignment(buffered_map_input,alignment,map_parser_attr);
+  GT_PROFILE_STOP(GT_PROFILE_PARSE);
+  GT_PROFILE_ADD_RECORD(error_code);
+  return error_code;
 }
 
 /*
@@ -252,6 +252,7 @@ GT_INLINE gt_status gt_input_sam_parser_get_block(
   }
   input_file->processed_lines+=lines_read;
   buffered_sam_input->lines_in_buffer = lines_read;
+  GT_PROFILE_ADD_BLOCK(gt_vector_get_used(buffered_sam_input->block_buffer));
   gt_input_file_unlock(input_file);
 
   // Setup the block
@@ -0,0 +1,193 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_inss_model.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Streaming & mergeable insert size model (quantiles with bounded relative error by orientation class)
+ */
+
+#include "gt_inss_model.h"
+
+const char* const gt_inss_orientation_label[GT_INSS_NUM_ORIENTATIONS] = { "FR", "RF", "TANDEM" };
+
+/*
+ * Setup
+ */
+GT_INLINE gt_inss_model* gt_inss_model_new(const uint64_t max_templates) {
+  gt_inss_model* const inss_model = malloc(sizeof(gt_inss_model));
+  gt_cond_fatal_error(!inss_model,MEM_HANDLER);
+  register uint64_t i;
+  for (i=0;i<GT_INSS_NUM_ORIENTATIONS;++i) {
+    inss_model->num_samples[i] = 0;
+    inss_model->histogram[i] = calloc(2*GT_INSS_MODEL_NUM_BUCKETS,sizeof(uint64_t));
+    gt_cond_fatal_error(!inss_model->histogram[i],MEM_ALLOC);
+  }
+  inss_model->num_different_contigs = 0;
+  inss_model->num_templates = 0;
+  inss_model->max_templates = max_templates;
+  return inss_model;
+}
+GT_INLINE void gt_inss_model_clear(gt_inss_model* const inss_model) {
+  GT_NULL_CHECK(inss_model);
+  register uint64_t i;
+  for (i=0;i<GT_INSS_NUM_ORIENTATIONS;++i) {
+    inss_model->num_samples[i] = 0;
+    memset(inss_model->histogram[i],0,2*GT_INSS_MODEL_NUM_BUCKETS*sizeof(uint64_t));
+  }
+  inss_model->num_different_contigs = 0;
+  inss_model->num_templates = 0;
+}
+GT_INLINE void gt_inss_model_delete(gt_inss_model* const inss_model) {
+  GT_NULL_CHECK(inss_model);
+  register uint64_t i;
+  for (i=0;i<GT_INSS_NUM_ORIENTATIONS;++i) free(inss_model->histogram[i]);
+  free(inss_model);
+}
+GT_INLINE void gt_inss_model_merge(gt_inss_model* const inss_model_dst,gt_inss_model* const inss_model_src) {
+  GT_NULL_CHECK(inss_model_dst);
+  GT_NULL_CHECK(inss_model_src);
+  register uint64_t i, j;
+  for (i=0;i<GT_INSS_NUM_ORIENTATIONS;++i) {
+    inss_model_dst->num_samples[i] += inss_model_src->num_samples[i];
+    register uint64_t* const histogram_dst = inss_model_dst->histogram[i];
+    register uint64_t* const histogram_src = inss_model_src->histogram[i];
+    for (j=0;j<2*GT_INSS_MODEL_NUM_BUCKETS;++j) histogram_dst[j] += histogram_src[j];
+  }
+  inss_model_dst->num_different_contigs += inss_model_src->num_different_contigs;
+  inss_model_dst->num_templates += inss_model_src->num_templates;
+}
+
+/*
+ * Buckets (log-linear over the magnitude, negative sizes mirrored below the positive ones)
+ */
+GT_INLINE uint64_t gt_inss_model_get_magnitude_bucket(const uint64_t magnitude) {
+  if (magnitude < GT_INSS_MODEL_SUB_BUCKETS) return magnitude;
+  register const uint64_t msb = 63-__builtin_clzll(magnitude);
+  if (msb >= GT_INSS_MODEL_MAX_BITS) return GT_INSS_MODEL_NUM_BUCKETS-1;
+  register const uint64_t shift = msb-GT_INSS_MODEL_PRECISION_BITS;
+  return (shift+1)*GT_INSS_MODEL_SUB_BUCKETS + ((magnitude>>shift)&(GT_INSS_MODEL_SUB_BUCKETS-1));
+}
+GT_INLINE uint64_t gt_inss_model_get_magnitude_bucket_value(const uint64_t bucket) {
+  if (bucket < GT_INSS_MODEL_SUB_BUCKETS) return bucket;
+  // Middle point of the bucket
+  register const uint64_t shift = bucket/GT_INSS_MODEL_SUB_BUCKETS - 1;
+  register const uint64_t lo = (GT_INSS_MODEL_SUB_BUCKETS+(bucket%GT_INSS_MODEL_SUB_BUCKETS)) << shift;
+  return lo + ((1ull<<shift)>>1);
+}
+GT_INLINE uint64_t gt_inss_model_get_bucket(const int64_t insert_size) {
+  return (insert_size>=0) ?
+      GT_INSS_MODEL_NUM_BUCKETS + gt_inss_model_get_magnitude_bucket(insert_size) :
+      GT_INSS_MODEL_NUM_BUCKETS-1 - gt_inss_model_get_magnitude_bucket(-(uint64_t)insert_size);
+}
+GT_INLINE int64_t gt_inss_model_get_bucket_value(const uint64_t bucket) {
+  return (bucket>=GT_INSS_MODEL_NUM_BUCKETS) ?
+      (int64_t)gt_inss_model_get_magnitude_bucket_value(bucket-GT_INSS_MODEL_NUM_BUCKETS) :
+      -(int64_t)gt_inss_model_get_magnitude_bucket_value(GT_INSS_MODEL_NUM_BUCKETS-1-bucket);
+}
+
+/*
+ * Accumulate
+ */
+GT_INLINE void gt_inss_model_add(gt_inss_model* const inss_model,const gt_inss_orientation orientation,const int64_t insert_size) {
+  GT_NULL_CHECK(inss_model);
+  ++inss_model->num_samples[orientation];
+  if (orientation!=GT_INSS_TANDEM) ++inss_model->histogram[orientation][gt_inss_model_get_bucket(insert_size)];
+}
+GT_INLINE void gt_inss_model_add_mmap(gt_inss_model* const inss_model,gt_map** const mmap) {
+  GT_NULL_CHECK(inss_model);
+  GT_NULL_CHECK(mmap);
+  uint64_t error_code;
+  register const int64_t insert_size = gt_template_get_insert_size(mmap,&error_code);
+  switch (error_code) {
+    case GT_TEMPLATE_INSERT_SIZE_DIFFERENT_CONTIGS:
+      ++inss_model->num_different_contigs;
+      break;
+    case GT_TEMPLATE_INSERT_SIZE_SAME_STRAND:
+      gt_inss_model_add(inss_model,GT_INSS_TANDEM,0);
+      break;
+    default: {
+      // Orientation wrt the leftmost end
+      register const uint64_t begin_0 = gt_map_get_position_(mmap[0]);
+      register const uint64_t begin_1 = gt_map_get_position_(mmap[1]);
+      register const gt_strand leftmost_strand = (begin_0<=begin_1) ? gt_map_get_strand(mmap[0]) : gt_map_get_strand(mmap[1]);
+      gt_inss_model_add(inss_model,(leftmost_strand==FORWARD) ? GT_INSS_FR : GT_INSS_RF,insert_size);
+      break;
+    }
+  }
+}
+GT_INLINE bool gt_inss_model_add_template(gt_inss_model* const inss_model,gt_template* const template) {
+  GT_NULL_CHECK(inss_model);
+  GT_TEMPLATE_CHECK(template);
+  if (gt_inss_model_is_complete(inss_model)) return false;
+  if (gt_template_get_num_blocks(template)==2 && gt_template_get_num_mmaps(template)>0) {
+    register gt_map** const mmap = gt_template_get_mmap(template,0,NULL);
+    if (mmap[0]!=NULL && mmap[1]!=NULL) {
+      gt_inss_model_add_mmap(inss_model,mmap);
+      ++inss_model->num_templates;
+    }
+  }
+  return true;
+}
+GT_INLINE bool gt_inss_model_is_complete(gt_inss_model* const inss_model) {
+  GT_NULL_CHECK(inss_model);
+  return inss_model->max_templates>0 && inss_model->num_templates>=inss_model->max_templates;
+}
+
+/*
+ * Queries
+ */
+GT_INLINE uint64_t gt_inss_model_get_num_samples(gt_inss_model* const inss_model,const gt_inss_orientation orientation) {
+  GT_NULL_CHECK(inss_model);
+  return inss_model->num_samples[orientation];
+}
+GT_INLINE gt_inss_orientation gt_inss_model_get_dominant_orientation(gt_inss_model* const inss_model) {
+  GT_NULL_CHECK(inss_model);
+  return (inss_model->num_samples[GT_INSS_RF] > inss_model->num_samples[GT_INSS_FR]) ? GT_INSS_RF : GT_INSS_FR;
+}
+GT_INLINE int64_t gt_inss_model_get_quantile(
+    gt_inss_model* const inss_model,const gt_inss_orientation orientation,const double quantile) {
+  GT_NULL_CHECK(inss_model);
+  register const uint64_t num_samples = inss_model->num_samples[orientation];
+  if (num_samples==0 || orientation==GT_INSS_TANDEM) return 0;
+  // Rank of the quantile (1-based)
+  register uint64_t rank = (uint64_t)(quantile*(double)num_samples);
+  if ((double)rank < quantile*(double)num_samples) ++rank;
+  rank = GT_MAX(rank,1);
+  rank = GT_MIN(rank,num_samples);
+  // Locate the bucket
+  register const uint64_t* const histogram = inss_model->histogram[orientation];
+  register uint64_t i, accumulated = 0;
+  for (i=0;i<2*GT_INSS_MODEL_NUM_BUCKETS-1;++i) {
+    accumulated += histogram[i];
+    if (accumulated >= rank) break;
+  }
+  return gt_inss_model_get_bucket_value(i);
+}
+
+/*
+ * Printers
+ */
+GT_INLINE void gt_inss_model_print(FILE* stream,gt_inss_model* const inss_model) {
+  GT_NULL_CHECK(stream);
+  GT_NULL_CHECK(inss_model);
+  register const uint64_t total_pairs = inss_model->num_samples[GT_INSS_FR]+
+      inss_model->num_samples[GT_INSS_RF]+inss_model->num_samples[GT_INSS_TANDEM]+inss_model->num_different_contigs;
+  fprintf(stream,"  --> InsertSize.Model (%" PRIu64 " pairs, dominant %s)\n",
+      total_pairs,gt_inss_orientation_label[gt_inss_model_get_dominant_orientation(inss_model)]);
+  register uint64_t i;
+  for (i=0;i<GT_INSS_NUM_ORIENTATIONS;++i) {
+    register const uint64_t num_samples = inss_model->num_samples[i];
+    fprintf(stream,"    --> %-6s %" PRIu64 " (%2.3f%%)",gt_inss_orientation_label[i],num_samples,
+        total_pairs ? 100.0*(float)num_samples/(float)total_pairs : 0.0);
+    if (num_samples>0 && i!=GT_INSS_TANDEM) {
+      fprintf(stream," Q01=%" PRId64 " Q05=%" PRId64 " Q25=%" PRId64 " Q50=%" PRId64 " Q75=%" PRId64 " Q95=%" PRId64 " Q99=%" PRId64,
+          gt_inss_model_get_quantile(inss_model,i,0.01),gt_inss_model_get_quantile(inss_model,i,0.05),
+          gt_inss_model_get_quantile(inss_model,i,0.25),gt_inss_model_get_quantile(inss_model,i,0.50),
+          gt_inss_model_get_quantile(inss_model,i,0.75),gt_inss_model_get_quantile(inss_model,i,0.95),
+          gt_inss_model_get_quantile(inss_model,i,0.99));
+    }
+    fprintf(stream,"\n");
+  }
+  fprintf(stream,"    --> DIFF.CONTIG %" PRIu64 " (%2.3f%%)\n",inss_model->num_different_contigs,
+      total_pairs ? 100.0*(float)inss_model->num_different_contigs/(float)total_pairs : 0.0);
+}
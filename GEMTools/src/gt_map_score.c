@@ -3,8 +3,244 @@
  * FILE: gt_map_score.c
  * DATE: 03/09/2012
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
- * DESCRIPTION: // TODO
+ * DESCRIPTION: Map scoring functions (MAPQ computed on the fly out of the counters and the maps' content)
  */
 
+#include "gt_map_score.h"
 
+/*
+ * Phred to probability table ( 10^(-phred/10) )
+ */
+const double gt_map_score_phred_prob[GT_MAP_SCORE_MAX_PHRED+1] = {
+  1.000000e+00,7.943282e-01,6.309573e-01,5.011872e-01,3.981072e-01,3.162278e-01,2.511886e-01,1.995262e-01,
+  1.584893e-01,1.258925e-01,1.000000e-01,7.943282e-02,6.309573e-02,5.011872e-02,3.981072e-02,3.162278e-02,
+  2.511886e-02,1.995262e-02,1.584893e-02,1.258925e-02,1.000000e-02,7.943282e-03,6.309573e-03,5.011872e-03,
+  3.981072e-03,3.162278e-03,2.511886e-03,1.995262e-03,1.584893e-03,1.258925e-03,1.000000e-03,7.943282e-04,
+  6.309573e-04,5.011872e-04,3.981072e-04,3.162278e-04,2.511886e-04,1.995262e-04,1.584893e-04,1.258925e-04,
+  1.000000e-04,7.943282e-05,6.309573e-05,5.011872e-05,3.981072e-05,3.162278e-05,2.511886e-05,1.995262e-05,
+  1.584893e-05,1.258925e-05,1.000000e-05,7.943282e-06,6.309573e-06,5.011872e-06,3.981072e-06,3.162278e-06,
+  2.511886e-06,1.995262e-06,1.584893e-06,1.258925e-06,1.000000e-06,7.943282e-07,6.309573e-07,5.011872e-07,
+  3.981072e-07,3.162278e-07,2.511886e-07,1.995262e-07,1.584893e-07,1.258925e-07,1.000000e-07,7.943282e-08,
+  6.309573e-08,5.011872e-08,3.981072e-08,3.162278e-08,2.511886e-08,1.995262e-08,1.584893e-08,1.258925e-08,
+  1.000000e-08,7.943282e-09,6.309573e-09,5.011872e-09,3.981072e-09,3.162278e-09,2.511886e-09,1.995262e-09,
+  1.584893e-09,1.258925e-09,1.000000e-09,7.943282e-10,6.309573e-10,5.011872e-10,3.981072e-10,3.162278e-10,
+  2.511886e-10,1.995262e-10,1.584893e-10,1.258925e-10,
+};
+#define gt_map_score_weight(relative_penalty) \
+  (((relative_penalty)>GT_MAP_SCORE_MAX_PHRED) ? 0.0 : gt_map_score_phred_prob[(relative_penalty)])
+
+/*
+ * MAPQ attributes
+ */
+GT_INLINE gt_map_score_attributes* gt_map_score_attributes_new() {
+  gt_map_score_attributes* attributes = malloc(sizeof(gt_map_score_attributes));
+  gt_cond_fatal_error(!attributes,MEM_HANDLER);
+  gt_map_score_attributes_reset_defaults(attributes);
+  return attributes;
+}
+GT_INLINE void gt_map_score_attributes_delete(gt_map_score_attributes* const attributes) {
+  GT_NULL_CHECK(attributes);
+  free(attributes);
+}
+GT_INLINE void gt_map_score_attributes_reset_defaults(gt_map_score_attributes* const attributes) {
+  GT_NULL_CHECK(attributes);
+  /* Penalties */
+  attributes->mismatch_penalty = 30;
+  attributes->max_mismatch_quality = 40;
+  attributes->gap_open_penalty = 30;
+  attributes->gap_extension_penalty = 10;
+  attributes->qualities_offset = GT_QUALS_OFFSET_33;
+  /* MAPQ */
+  attributes->max_mapq = 60;
+}
 
+/*
+ * fx(ALIGNMENT,MAP) Scoring functions
+ */
+GT_INLINE uint64_t gt_map_score_get_phred_penalty(
+    gt_alignment* const alignment,gt_map* const map,gt_map_score_attributes* const attributes) {
+  GT_ALIGNMENT_CHECK(alignment);
+  GT_MAP_CHECK(map);
+  GT_NULL_CHECK(attributes);
+  register const uint64_t read_length = gt_alignment_get_read_length(alignment);
+  register const uint8_t* const qualities =
+      (gt_alignment_has_qualities(alignment) && gt_string_get_length(alignment->qualities)==read_length) ?
+          (uint8_t*)gt_alignment_get_qualities(alignment) : NULL;
+  register const uint8_t qualities_offset = (attributes->qualities_offset==GT_QUALS_OFFSET_64) ? 64 : 33;
+  register uint64_t penalty = 0, block_offset = 0;
+  GT_MAP_ITERATE(map,map_block) {
+    GT_MISMS_ITERATE(map_block,misms) {
+      if (misms->misms_type==MISMS) {
+        register const uint64_t read_position = block_offset+misms->position;
+        if (qualities!=NULL && read_position<read_length) {
+          // Mismatch positions are given w.r.t. the read as stored (whatever the strand of the map)
+          register const uint8_t quality = qualities[read_position];
+          register const uint64_t phred = (quality>qualities_offset) ? quality-qualities_offset : 0;
+          penalty += GT_MIN(phred,attributes->max_mismatch_quality);
+        } else {
+          penalty += attributes->mismatch_penalty;
+        }
+      } else { // INS/DEL
+        penalty += attributes->gap_open_penalty + attributes->gap_extension_penalty*(misms->size-1);
+      }
+    }
+    block_offset += gt_map_get_base_length(map_block);
+  }
+  return penalty;
+}
+
+/*
+ * Hits accounting (listed maps + maps only counted in the counters)
+ */
+typedef struct {
+  uint64_t min_penalty;
+  uint64_t best_distance;
+  uint64_t listed_strata[GT_MAP_SCORE_MAX_STRATA];
+  double total_weight;
+} gt_map_score_hits;
+
+GT_INLINE void gt_map_score_hits_init(gt_map_score_hits* const hits) {
+  hits->min_penalty = UINT64_MAX;
+  hits->best_distance = 0;
+  memset(hits->listed_strata,0,GT_MAP_SCORE_MAX_STRATA*sizeof(uint64_t));
+  hits->total_weight = 0.0;
+}
+GT_INLINE void gt_map_score_hits_add_listed(gt_map_score_hits* const hits,const uint64_t penalty,const uint64_t distance) {
+  if (penalty<hits->min_penalty || (penalty==hits->min_penalty && distance<hits->best_distance)) {
+    hits->min_penalty = penalty;
+    hits->best_distance = distance;
+  }
+  ++(hits->listed_strata[GT_MIN(distance,GT_MAP_SCORE_MAX_STRATA-1)]);
+}
+GT_INLINE void gt_map_score_hits_add_weight(gt_map_score_hits* const hits,const uint64_t penalty) {
+  hits->total_weight += gt_map_score_weight(penalty-hits->min_penalty);
+}
+GT_INLINE uint64_t gt_map_score_hits_get_strata_penalty(
+    gt_map_score_hits* const hits,const uint64_t strata,gt_map_score_attributes* const attributes) {
+  // Hits only counted are penalised w.r.t. the best hit according to their strata
+  return (strata>hits->best_distance) ? (strata-hits->best_distance)*attributes->mismatch_penalty : 0;
+}
+GT_INLINE void gt_map_score_hits_add_unlisted(
+    gt_map_score_hits* const hits,gt_vector* const counters,const uint64_t mcs,gt_map_score_attributes* const attributes) {
+  register const uint64_t num_counters = gt_vector_get_used(counters);
+  register uint64_t i;
+  for (i=0;i<num_counters && i<GT_MAP_SCORE_MAX_STRATA-1;++i) {
+    register const uint64_t counter = *gt_vector_get_elm(counters,i,uint64_t);
+    if (counter>hits->listed_strata[i]) {
+      hits->total_weight += (counter-hits->listed_strata[i])*
+          gt_map_score_weight(gt_map_score_hits_get_strata_penalty(hits,i,attributes));
+    }
+  }
+  // Pseudo-hit at the first strata not searched completely
+  register uint64_t non_complete_strata = (mcs!=UINT64_MAX) ? mcs : num_counters;
+  if (non_complete_strata<=hits->best_distance) non_complete_strata = hits->best_distance+1;
+  hits->total_weight += gt_map_score_weight(gt_map_score_hits_get_strata_penalty(hits,non_complete_strata,attributes));
+}
+GT_INLINE uint64_t gt_map_score_hits_get_mapq(
+    gt_map_score_hits* const hits,const uint64_t penalty,gt_map_score_attributes* const attributes) {
+  register const double weight = gt_map_score_weight(penalty-hits->min_penalty);
+  register const double error_prob = (hits->total_weight-weight)/hits->total_weight;
+  // MAPQ = floor(-10*log10(error_prob))
+  register const uint64_t max_mapq = GT_MIN(attributes->max_mapq,GT_MAP_SCORE_MAX_PHRED);
+  register uint64_t mapq = 0;
+  while (mapq<max_mapq && gt_map_score_phred_prob[mapq+1]>=error_prob) ++mapq;
+  return mapq;
+}
+
+/*
+ * fx(ALIGNMENT) Scoring functions
+ */
+GT_INLINE uint64_t gt_map_score_alignment_mapq(gt_alignment* const alignment,gt_map_score_attributes* const attributes) {
+  GT_ALIGNMENT_CHECK(alignment);
+  GT_NULL_CHECK(attributes);
+  register const uint64_t num_maps = gt_alignment_get_num_maps(alignment);
+  if (num_maps==0) return 0;
+  // Compute penalties (temporally stored as the map score)
+  gt_map_score_hits hits;
+  gt_map_score_hits_init(&hits);
+  register uint64_t i;
+  for (i=0;i<num_maps;++i) {
+    register gt_map* const map = gt_alignment_get_map(alignment,i);
+    register const uint64_t penalty = gt_map_score_get_phred_penalty(alignment,map,attributes);
+    gt_map_set_score(map,penalty);
+    gt_map_score_hits_add_listed(&hits,penalty,gt_map_get_global_distance(map));
+  }
+  for (i=0;i<num_maps;++i) {
+    gt_map_score_hits_add_weight(&hits,gt_map_get_score(gt_alignment_get_map(alignment,i)));
+  }
+  gt_map_score_hits_add_unlisted(&hits,gt_alignment_get_counters_vector(alignment),gt_alignment_get_mcs(alignment),attributes);
+  // Compute MAPQs
+  register uint64_t best_mapq = 0;
+  for (i=0;i<num_maps;++i) {
+    register gt_map* const map = gt_alignment_get_map(alignment,i);
+    register const uint64_t mapq = gt_map_score_hits_get_mapq(&hits,gt_map_get_score(map),attributes);
+    gt_map_set_score(map,mapq);
+    best_mapq = GT_MAX(best_mapq,mapq);
+  }
+  return best_mapq;
+}
+
+/*
+ * fx(TEMPLATE) Scoring functions
+ */
+GT_INLINE uint64_t gt_map_score_template_mapq(gt_template* const template,gt_map_score_attributes* const attributes) {
+  GT_TEMPLATE_CHECK(template);
+  GT_NULL_CHECK(attributes);
+  GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template,alignment) {
+    return gt_map_score_alignment_mapq(alignment,attributes);
+  } GT_TEMPLATE_END_REDUCTION;
+  register const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  register const uint64_t num_mmaps = gt_template_get_num_mmaps(template);
+  register uint64_t best_mapq = 0, i, j;
+  if (num_mmaps==0) {
+    // Unpaired, score each end on its own
+    for (i=0;i<num_blocks;++i) {
+      best_mapq = GT_MAX(best_mapq,gt_map_score_alignment_mapq(gt_template_get_block(template,i),attributes));
+    }
+    return best_mapq;
+  }
+  // Compute the penalties of the ends (temporally stored as the map score)
+  for (i=0;i<num_blocks;++i) {
+    register gt_alignment* const alignment = gt_template_get_block(template,i);
+    register const uint64_t num_maps = gt_alignment_get_num_maps(alignment);
+    for (j=0;j<num_maps;++j) {
+      register gt_map* const map = gt_alignment_get_map(alignment,j);
+      gt_map_set_score(map,gt_map_score_get_phred_penalty(alignment,map,attributes));
+    }
+  }
+  // Compute the penalties of the mmaps (temporally stored as the mmap score)
+  gt_map_score_hits hits;
+  gt_map_score_hits_init(&hits);
+  for (i=0;i<num_mmaps;++i) {
+    register gt_map** const mmap = gt_template_get_mmap(template,i,NULL);
+    register gt_mmap_attributes* const mmap_attr = gt_template_get_mmap_attr(template,i);
+    register uint64_t penalty = 0, distance = 0;
+    for (j=0;j<num_blocks;++j) {
+      penalty += gt_map_get_score(mmap[j]);
+      distance += gt_map_get_global_distance(mmap[j]);
+    }
+    mmap_attr->score = penalty;
+    gt_map_score_hits_add_listed(&hits,penalty,distance);
+  }
+  for (i=0;i<num_mmaps;++i) {
+    gt_map_score_hits_add_weight(&hits,gt_template_get_mmap_attr(template,i)->score);
+  }
+  gt_map_score_hits_add_unlisted(&hits,gt_template_get_counters_vector(template),gt_template_get_mcs(template),attributes);
+  // Compute the MAPQs of the mmaps
+  for (i=0;i<num_blocks;++i) {
+    register gt_alignment* const alignment = gt_template_get_block(template,i);
+    register const uint64_t num_maps = gt_alignment_get_num_maps(alignment);
+    for (j=0;j<num_maps;++j) gt_map_set_score(gt_alignment_get_map(alignment,j),0);
+  }
+  for (i=0;i<num_mmaps;++i) {
+    register gt_map** const mmap = gt_template_get_mmap(template,i,NULL);
+    register gt_mmap_attributes* const mmap_attr = gt_template_get_mmap_attr(template,i);
+    register const uint64_t mapq = gt_map_score_hits_get_mapq(&hits,mmap_attr->score,attributes);
+    mmap_attr->score = mapq;
+    for (j=0;j<num_blocks;++j) {
+      if (gt_map_get_score(mmap[j])<(int64_t)mapq) gt_map_set_score(mmap[j],mapq);
+    }
+    best_mapq = GT_MAX(best_mapq,mapq);
+  }
+  return best_mapq;
+}
@@ -0,0 +1,396 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_output_binary.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Output printers to the binary packed template format (see gt_input_binary_parser.h)
+ */
+
+#include "gt_output_binary.h"
+
+#define GT_OUTPUT_BINARY_BUFFER_SIZE GT_BUFFER_SIZE_4K
+
+/*
+ * Output attributes
+ */
+GT_INLINE gt_output_binary_attributes* gt_output_binary_attributes_new() {
+  gt_output_binary_attributes* attributes = malloc(sizeof(gt_output_binary_attributes));
+  gt_cond_fatal_error(!attributes,MEM_HANDLER);
+  attributes->seq_names = gt_shash_new();
+  gt_cond_fatal_error(pthread_mutex_init(&attributes->seq_names_mutex,NULL),SYS_MUTEX_INIT);
+  gt_output_binary_attributes_reset_defaults(attributes);
+  return attributes;
+}
+GT_INLINE void gt_output_binary_attributes_delete(gt_output_binary_attributes* const attributes) {
+  GT_NULL_CHECK(attributes);
+  gt_shash_delete(attributes->seq_names,true);
+  gt_cond_fatal_error(pthread_mutex_destroy(&attributes->seq_names_mutex),SYS_MUTEX_DESTROY);
+  free(attributes);
+}
+GT_INLINE void gt_output_binary_attributes_reset_defaults(gt_output_binary_attributes* const attributes) {
+  GT_NULL_CHECK(attributes);
+  /* QUALITIES */
+  attributes->bin_qualities = false;
+  attributes->qualities_offset = GT_QUALS_OFFSET_33;
+  /* SEQUENCE NAMES */
+  gt_shash_clear(attributes->seq_names,true);
+  attributes->num_seq_names = 0;
+}
+GT_INLINE bool gt_output_binary_attributes_is_bin_qualities(gt_output_binary_attributes* const attributes) {
+  GT_NULL_CHECK(attributes);
+  return attributes->bin_qualities;
+}
+GT_INLINE void gt_output_binary_attributes_set_bin_qualities(gt_output_binary_attributes* const attributes,const bool bin_qualities) {
+  GT_NULL_CHECK(attributes);
+  attributes->bin_qualities = bin_qualities;
+}
+GT_INLINE gt_qualities_offset_t gt_output_binary_attributes_get_qualities_offset(gt_output_binary_attributes* const attributes) {
+  GT_NULL_CHECK(attributes);
+  return attributes->qualities_offset;
+}
+GT_INLINE void gt_output_binary_attributes_set_qualities_offset(gt_output_binary_attributes* const attributes,const gt_qualities_offset_t qualities_offset) {
+  GT_NULL_CHECK(attributes);
+  attributes->qualities_offset = qualities_offset;
+}
+GT_INLINE uint64_t gt_output_binary_attributes_get_num_seq_names(gt_output_binary_attributes* const attributes) {
+  GT_NULL_CHECK(attributes);
+  return attributes->num_seq_names;
+}
+
+/*
+ * Record encoder (escapes the payload on the fly and flushes it to the printer in chunks)
+ */
+typedef struct {
+  gt_generic_printer* gprinter;
+  char buffer[GT_OUTPUT_BINARY_BUFFER_SIZE+3];
+  uint64_t buffer_used;
+  /* Sequence names of the record (resolved against the dictionary) */
+  gt_string* seq_names[GT_BINARY_MAX_SEQ_NAMES];
+  uint64_t seq_name_ids[GT_BINARY_MAX_SEQ_NAMES];
+  uint64_t num_seq_names;
+} gt_output_binary_encoder;
+
+GT_INLINE void gt_output_binary_encoder_flush(gt_output_binary_encoder* const encoder) {
+  if (encoder->buffer_used==0) return;
+  encoder->buffer[encoder->buffer_used] = EOS;
+  gt_gprintf(encoder->gprinter,"%s",encoder->buffer);
+  encoder->buffer_used = 0;
+}
+GT_INLINE void gt_output_binary_put_byte(gt_output_binary_encoder* const encoder,const uint8_t value) {
+  register char* const buffer = encoder->buffer+encoder->buffer_used;
+  register const uint8_t byte = value^GT_BINARY_BYTE_MASK;
+  switch ((char)byte) {
+    case EOS: buffer[0]=GT_BINARY_ESCAPE; buffer[1]=GT_BINARY_ESCAPE_EOS; encoder->buffer_used+=2; break;
+    case EOL: buffer[0]=GT_BINARY_ESCAPE; buffer[1]=GT_BINARY_ESCAPE_EOL; encoder->buffer_used+=2; break;
+    case DOS_EOL: buffer[0]=GT_BINARY_ESCAPE; buffer[1]=GT_BINARY_ESCAPE_DOS_EOL; encoder->buffer_used+=2; break;
+    case GT_BINARY_ESCAPE: buffer[0]=GT_BINARY_ESCAPE; buffer[1]=GT_BINARY_ESCAPE_ESCAPE; encoder->buffer_used+=2; break;
+    default: buffer[0]=byte; ++encoder->buffer_used; break;
+  }
+  if (gt_expect_false(encoder->buffer_used>=GT_OUTPUT_BINARY_BUFFER_SIZE)) gt_output_binary_encoder_flush(encoder);
+}
+GT_INLINE void gt_output_binary_put_bytes(gt_output_binary_encoder* const encoder,const char* const bytes,const uint64_t length) {
+  register uint64_t i;
+  for (i=0;i<length;++i) gt_output_binary_put_byte(encoder,bytes[i]);
+}
+GT_INLINE void gt_output_binary_put_varint(gt_output_binary_encoder* const encoder,uint64_t value) {
+  while (value>=0x80) {
+    gt_output_binary_put_byte(encoder,(value&0x7F)|0x80);
+    value >>= 7;
+  }
+  gt_output_binary_put_byte(encoder,value);
+}
+GT_INLINE void gt_output_binary_put_zigzag(gt_output_binary_encoder* const encoder,const int64_t value) {
+  gt_output_binary_put_varint(encoder,((uint64_t)value<<1)^(uint64_t)(value>>63));
+}
+
+/*
+ * BINARY building blocks
+ */
+GT_INLINE void gt_output_binary_put_read_block(
+    gt_output_binary_encoder* const encoder,gt_alignment* const alignment,
+    gt_output_binary_attributes* const output_binary_attributes) {
+  register const uint64_t read_length = gt_alignment_get_read_length(alignment);
+  register const char* const read = gt_alignment_get_read(alignment);
+  register uint64_t i, num_exceptions = 0, last_exception = 0;
+  // READ (2-bit packed)
+  gt_output_binary_put_varint(encoder,read_length);
+  register uint8_t packed_bases = 0;
+  for (i=0;i<read_length;++i) {
+    register const uint8_t enc_base = gt_cdna_encode[(uint8_t)read[i]]&3;
+    if (gt_expect_false(gt_cdna_decode[enc_base]!=read[i])) ++num_exceptions;
+    packed_bases |= enc_base<<(2*(i%4));
+    if (i%4==3) {
+      gt_output_binary_put_byte(encoder,packed_bases);
+      packed_bases = 0;
+    }
+  }
+  if (read_length%4!=0) gt_output_binary_put_byte(encoder,packed_bases);
+  // Exceptions (non-ACGT characters)
+  gt_output_binary_put_varint(encoder,num_exceptions);
+  for (i=0;num_exceptions>0;++i) {
+    if (gt_cdna_decode[gt_cdna_encode[(uint8_t)read[i]]&3]!=read[i]) {
+      gt_output_binary_put_varint(encoder,i-last_exception);
+      gt_output_binary_put_byte(encoder,read[i]);
+      last_exception = i;
+      --num_exceptions;
+    }
+  }
+  // QUALITIES
+  if (!gt_alignment_has_qualities(alignment) || gt_string_get_length(alignment->qualities)!=read_length) {
+    gt_output_binary_put_byte(encoder,GT_BINARY_QUALS_NONE);
+  } else if (output_binary_attributes->bin_qualities) {
+    register const uint8_t offset = (output_binary_attributes->qualities_offset==GT_QUALS_OFFSET_64) ? 64 : 33;
+    register const uint8_t* const qualities = (uint8_t*)gt_alignment_get_qualities(alignment);
+    gt_output_binary_put_byte(encoder,GT_BINARY_QUALS_BINNED);
+    gt_output_binary_put_byte(encoder,offset);
+    register uint8_t packed_bins = 0;
+    for (i=0;i<read_length;++i) {
+      register const uint8_t phred = (qualities[i]>offset) ? qualities[i]-offset : 0;
+      packed_bins |= gt_binary_quals_bin[phred]<<(4*(i%2));
+      if (i%2==1) {
+        gt_output_binary_put_byte(encoder,packed_bins);
+        packed_bins = 0;
+      }
+    }
+    if (read_length%2!=0) gt_output_binary_put_byte(encoder,packed_bins);
+  } else {
+    gt_output_binary_put_byte(encoder,GT_BINARY_QUALS_RAW);
+    gt_output_binary_put_bytes(encoder,gt_alignment_get_qualities(alignment),read_length);
+  }
+}
+GT_INLINE void gt_output_binary_put_counters(
+    gt_output_binary_encoder* const encoder,gt_vector* const counters,const uint64_t mcs,const bool not_unique) {
+  gt_output_binary_put_varint(encoder,gt_vector_get_used(counters));
+  GT_VECTOR_ITERATE(counters,counter,counter_pos,uint64_t) {
+    gt_output_binary_put_varint(encoder,*counter);
+  }
+  gt_output_binary_put_varint(encoder,mcs+1); // (UINT64_MAX+1 => 0 => Not set)
+  gt_output_binary_put_byte(encoder,not_unique);
+}
+/*
+ * Sequence names dictionary
+ *   Names are resolved before the record is printed, as their definitions go in lines of their own.
+ *   A name is (re)defined by the first record using it in each block preceding (in file order)
+ *   all the blocks that already defined it. As output blocks are written sorted, every
+ *   record finds its names defined before it.
+ */
+GT_INLINE uint64_t gt_output_binary_get_block_id(gt_generic_printer* const gprinter) {
+  if (gprinter->printer_type!=GT_BOF_PRINTER) return 0; // Written in order
+  uint32_t mayor_block_id, minor_block_id;
+  gt_buffered_output_file_get_block_ids(gprinter->buffered_output_file,&mayor_block_id,&minor_block_id);
+  return mayor_block_id; // Blocks with the same mayor ID are written by the same thread
+}
+GT_INLINE void gt_output_binary_add_seq_names(gt_output_binary_encoder* const encoder,gt_alignment* const alignment) {
+  GT_ALIGNMENT_ITERATE(alignment,map) {
+    GT_MAP_ITERATE(map,map_block) {
+      register gt_string* const seq_name = gt_map_get_string_seq_name(map_block);
+      if (gt_string_get_length(seq_name)>GT_BINARY_MAX_SEQ_NAME_LENGTH) continue; // Inline
+      register uint64_t i;
+      for (i=0;i<encoder->num_seq_names;++i) {
+        if (gt_string_equals(encoder->seq_names[i],seq_name)) break;
+      }
+      if (i==encoder->num_seq_names) {
+        if (encoder->num_seq_names==GT_BINARY_MAX_SEQ_NAMES) return; // Inline
+        encoder->seq_names[encoder->num_seq_names++] = seq_name;
+      }
+    }
+  }
+}
+GT_INLINE void gt_output_binary_define_seq_names(
+    gt_output_binary_encoder* const encoder,gt_output_binary_attributes* const output_binary_attributes) {
+  if (encoder->num_seq_names==0) return;
+  register const uint64_t block_id = gt_output_binary_get_block_id(encoder->gprinter);
+  bool define[GT_BINARY_MAX_SEQ_NAMES];
+  char key[GT_BINARY_MAX_SEQ_NAME_LENGTH+1];
+  register uint64_t i;
+  GT_BEGIN_MUTEX_SECTION(output_binary_attributes->seq_names_mutex) {
+    for (i=0;i<encoder->num_seq_names;++i) {
+      register gt_string* const seq_name = encoder->seq_names[i];
+      gt_strncpy(key,gt_string_get_string(seq_name),gt_string_get_length(seq_name));
+      register gt_output_binary_seq_name* dictionary_entry =
+          gt_shash_get(output_binary_attributes->seq_names,key,gt_output_binary_seq_name);
+      if (dictionary_entry==NULL) {
+        dictionary_entry = malloc(sizeof(gt_output_binary_seq_name));
+        gt_cond_fatal_error(!dictionary_entry,MEM_HANDLER);
+        dictionary_entry->seq_name_id = output_binary_attributes->num_seq_names++;
+        dictionary_entry->block_id = block_id;
+        gt_shash_insert(output_binary_attributes->seq_names,key,dictionary_entry,gt_output_binary_seq_name);
+        define[i] = true;
+      } else if (dictionary_entry->block_id>block_id) {
+        dictionary_entry->block_id = block_id;
+        define[i] = true;
+      } else {
+        define[i] = false;
+      }
+      encoder->seq_name_ids[i] = dictionary_entry->seq_name_id;
+    }
+  } GT_END_MUTEX_SECTION(output_binary_attributes->seq_names_mutex);
+  // Print definitions (out of the critical section, printing can block on a buffer dump)
+  for (i=0;i<encoder->num_seq_names;++i) {
+    if (define[i]) {
+      gt_gprintf(encoder->gprinter,"%c%"PRIu64"\t"PRIgts"\n",GT_BINARY_SEQ_NAME_DEFINITION,
+          encoder->seq_name_ids[i],PRIgts_content(encoder->seq_names[i]));
+    }
+  }
+}
+GT_INLINE void gt_output_binary_put_seq_name(gt_output_binary_encoder* const encoder,gt_string* const seq_name) {
+  register uint64_t i;
+  for (i=0;i<encoder->num_seq_names;++i) {
+    if (gt_string_equals(encoder->seq_names[i],seq_name)) {
+      gt_output_binary_put_varint(encoder,encoder->seq_name_ids[i]+1);
+      return;
+    }
+  }
+  gt_output_binary_put_varint(encoder,0);
+  gt_output_binary_put_varint(encoder,gt_string_get_length(seq_name));
+  gt_output_binary_put_bytes(encoder,gt_string_get_string(seq_name),gt_string_get_length(seq_name));
+}
+GT_INLINE void gt_output_binary_put_map(gt_output_binary_encoder* const encoder,gt_map* const map,const uint64_t read_length) {
+  GT_MAP_ITERATE(map,map_block) {
+    // Location
+    gt_output_binary_put_seq_name(encoder,gt_map_get_string_seq_name(map_block));
+    gt_output_binary_put_varint(encoder,(gt_map_get_position_(map_block)<<1)|(gt_map_get_strand(map_block)==REVERSE));
+    gt_output_binary_put_zigzag(encoder,(int64_t)gt_map_get_base_length(map_block)-(int64_t)read_length);
+    gt_output_binary_put_zigzag(encoder,gt_map_get_score(map_block));
+    // Mismatches
+    register uint64_t last_misms_pos = 0;
+    gt_output_binary_put_varint(encoder,gt_map_get_num_misms(map_block));
+    GT_MISMS_ITERATE(map_block,misms) {
+      register const uint64_t delta_pos = (misms->position-last_misms_pos)<<GT_BINARY_MISMS_CODE_BITS;
+      switch (misms->misms_type) {
+        case MISMS: {
+          register const uint8_t enc_base = gt_cdna_encode[(uint8_t)misms->base];
+          if (enc_base<4 && gt_cdna_decode[enc_base]==misms->base) {
+            gt_output_binary_put_varint(encoder,delta_pos|(GT_BINARY_MISMS_BASE+enc_base));
+          } else {
+            gt_output_binary_put_varint(encoder,delta_pos|GT_BINARY_MISMS_CHAR);
+            gt_output_binary_put_byte(encoder,misms->base);
+          }
+          break;
+        }
+        case INS:
+          gt_output_binary_put_varint(encoder,delta_pos|GT_BINARY_MISMS_INS);
+          gt_output_binary_put_varint(encoder,misms->size);
+          break;
+        case DEL:
+          gt_output_binary_put_varint(encoder,delta_pos|GT_BINARY_MISMS_DEL);
+          gt_output_binary_put_varint(encoder,misms->size);
+          break;
+      }
+      last_misms_pos = misms->position;
+    }
+    // Junction to the next block (if any)
+    if (gt_map_has_next_block(map_block)) {
+      gt_output_binary_put_byte(encoder,gt_map_get_junction(map_block)+1);
+      gt_output_binary_put_zigzag(encoder,gt_map_get_junction_size(map_block));
+    } else {
+      gt_output_binary_put_byte(encoder,0);
+    }
+  }
+}
+GT_INLINE void gt_output_binary_put_alignment_maps(gt_output_binary_encoder* const encoder,gt_alignment* const alignment) {
+  register const uint64_t read_length = gt_alignment_get_read_length(alignment);
+  gt_output_binary_put_varint(encoder,gt_alignment_get_num_maps(alignment));
+  GT_VECTOR_ITERATE(alignment->maps,map,map_pos,gt_map*) {
+    gt_output_binary_put_map(encoder,*map,read_length);
+  }
+}
+GT_INLINE gt_status gt_output_binary_put_template_mmaps(gt_output_binary_encoder* const encoder,gt_template* const template) {
+  register const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  uint64_t map_idx;
+  gt_output_binary_put_varint(encoder,gt_template_get_num_mmaps(template));
+  GT_TEMPLATE__ATTR_ITERATE_(template,mmap,mmap_attr) {
+    register uint64_t i;
+    for (i=0;i<num_blocks;++i) {
+      if (!gt_alignment_locate_map_reference(gt_template_get_block(template,i),mmap[i],&map_idx)) {
+        return GT_STATUS_FAIL; // Map of the pair not present in the end's alignment
+      }
+      gt_output_binary_put_varint(encoder,map_idx);
+    }
+    gt_output_binary_put_varint(encoder,mmap_attr->distance);
+    gt_output_binary_put_zigzag(encoder,mmap_attr->score);
+  }
+  return 0;
+}
+
+/*
+ * High-level BINARY Printers {Alignment/Template}
+ */
+#undef GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS
+#define GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS template,output_binary_attributes
+GT_GENERIC_PRINTER_IMPLEMENTATION(gt_output_binary,print_template,gt_template* const template,gt_output_binary_attributes* const output_binary_attributes);
+GT_INLINE gt_status gt_output_binary_gprint_template(
+    gt_generic_printer* const gprinter,gt_template* const template,gt_output_binary_attributes* const output_binary_attributes) {
+  GT_GENERIC_PRINTER_CHECK(gprinter);
+  GT_TEMPLATE_CHECK(template);
+  GT_NULL_CHECK(output_binary_attributes);
+  GT_TEMPLATE_IF_REDUCES_TO_ALINGMENT(template,alignment) {
+    return gt_output_binary_gprint_alignment(gprinter,alignment,output_binary_attributes);
+  } GT_TEMPLATE_END_REDUCTION;
+  gt_output_map_attributes output_map_attributes = GT_OUTPUT_MAP_ATTR_DEFAULT();
+  gt_output_binary_encoder encoder;
+  encoder.gprinter = gprinter;
+  encoder.buffer_used = 0;
+  encoder.num_seq_names = 0;
+  register gt_status error_code = 0;
+  // Define sequence names
+  GT_TEMPLATE_ALIGNMENT_ITERATE(template,alignment_names) {
+    gt_output_binary_add_seq_names(&encoder,alignment_names);
+  }
+  gt_output_binary_define_seq_names(&encoder,output_binary_attributes);
+  // Print TAG
+  gt_gprintf(gprinter,"%c",GT_BINARY_RECORD_BEGIN);
+  error_code|=gt_output_map_gprint_tag(gprinter,template->tag,template->attributes,&output_map_attributes);
+  gt_gprintf(gprinter,"\t");
+  // Print READ(s) & QUALITIES
+  register const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  gt_output_binary_put_varint(&encoder,num_blocks);
+  GT_TEMPLATE_ALIGNMENT_ITERATE(template,alignment) {
+    gt_output_binary_put_read_block(&encoder,alignment,output_binary_attributes);
+  }
+  // Print COUNTERS
+  gt_output_binary_put_counters(&encoder,gt_template_get_counters_vector(template),
+      gt_template_get_mcs(template),gt_template_get_not_unique_flag(template));
+  // Print MAPS
+  GT_TEMPLATE_ALIGNMENT_ITERATE(template,alignment_maps) {
+    gt_output_binary_put_alignment_maps(&encoder,alignment_maps);
+  }
+  error_code|=gt_output_binary_put_template_mmaps(&encoder,template);
+  gt_output_binary_encoder_flush(&encoder);
+  gt_gprintf(gprinter,"\n");
+  return error_code;
+}
+#undef GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS
+#define GT_GENERIC_PRINTER_DELEGATE_CALL_PARAMS alignment,output_binary_attributes
+GT_GENERIC_PRINTER_IMPLEMENTATION(gt_output_binary,print_alignment,gt_alignment* const alignment,gt_output_binary_attributes* const output_binary_attributes);
+GT_INLINE gt_status gt_output_binary_gprint_alignment(
+    gt_generic_printer* const gprinter,gt_alignment* const alignment,gt_output_binary_attributes* const output_binary_attributes) {
+  GT_GENERIC_PRINTER_CHECK(gprinter);
+  GT_ALIGNMENT_CHECK(alignment);
+  GT_NULL_CHECK(output_binary_attributes);
+  gt_output_map_attributes output_map_attributes = GT_OUTPUT_MAP_ATTR_DEFAULT();
+  gt_output_binary_encoder encoder;
+  encoder.gprinter = gprinter;
+  encoder.buffer_used = 0;
+  encoder.num_seq_names = 0;
+  register gt_status error_code = 0;
+  // Define sequence names
+  gt_output_binary_add_seq_names(&encoder,alignment);
+  gt_output_binary_define_seq_names(&encoder,output_binary_attributes);
+  // Print TAG
+  gt_gprintf(gprinter,"%c",GT_BINARY_RECORD_BEGIN);
+  error_code|=gt_output_map_gprint_tag(gprinter,alignment->tag,alignment->attributes,&output_map_attributes);
+  gt_gprintf(gprinter,"\t");
+  // Print READ & QUALITIES
+  gt_output_binary_put_varint(&encoder,1);
+  gt_output_binary_put_read_block(&encoder,alignment,output_binary_attributes);
+  // Print COUNTERS
+  gt_output_binary_put_counters(&encoder,gt_alignment_get_counters_vector(alignment),
+      gt_alignment_get_mcs(alignment),gt_alignment_get_not_unique_flag(alignment));
+  // Print MAPS
+  gt_output_binary_put_alignment_maps(&encoder,alignment);
+  gt_output_binary_put_varint(&encoder,0); // No mmaps
+  gt_output_binary_encoder_flush(&encoder);
+  gt_gprintf(gprinter,"\n");
+  return error_code;
+}
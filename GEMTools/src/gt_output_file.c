@@ -22,6 +22,9 @@ GT_INLINE void gt_output_file_init_buffers(gt_output_file* const output_file) {
   /* Block ID (for synchronization purposes) */
   output_file->mayor_block_id=0;
   output_file->minor_block_id=0;
+  /* Write errors */
+  output_file->fatal_write_error=true;
+  output_file->write_error=false;
   /* Mutexes */
   gt_cond_fatal_error(pthread_cond_init(&output_file->out_buffer_cond,NULL),SYS_COND_VAR_INIT);
   gt_cond_fatal_error(pthread_cond_init(&output_file->out_write_cond,NULL),SYS_COND_VAR_INIT);
@@ -54,6 +57,7 @@ gt_output_file* gt_output_file_new(char* const file_name,const gt_output_file_ty
 }
 gt_status gt_output_file_close(gt_output_file* const output_file) {
   GT_OUTPUT_FILE_CONSISTENCY_CHECK(output_file);
+  register const bool write_error = output_file->write_error;
   register gt_status error_code = 0;
   // Close filem not stream
   if(strcmp(output_file->file_name, GT_STREAM_FILE_NAME) != 0){
@@ -70,7 +74,23 @@ gt_status gt_output_file_close(gt_output_file* const output_file) {
   gt_cond_error(error_code|=pthread_mutex_destroy(&output_file->out_file_mutex),SYS_MUTEX_DESTROY);
   // Free handler
   free(output_file);
-  return error_code;
+  return (write_error) ? GT_OUTPUT_FILE_FAIL : error_code;
+}
+
+/*
+ * Write errors
+ */
+GT_INLINE void gt_output_file_set_fatal_write_error(gt_output_file* const output_file,const bool fatal_write_error) {
+  GT_OUTPUT_FILE_CHECK(output_file);
+  output_file->fatal_write_error = fatal_write_error;
+}
+GT_INLINE bool gt_output_file_has_write_error(gt_output_file* const output_file) {
+  GT_OUTPUT_FILE_CHECK(output_file);
+  register bool write_error;
+  GT_BEGIN_MUTEX_SECTION(output_file->out_file_mutex) {
+    write_error = output_file->write_error;
+  } GT_END_MUTEX_SECTION(output_file->out_file_mutex);
+  return write_error;
 }
 
 /*
@@ -103,9 +123,11 @@ GT_INLINE gt_status gt_ofprintf(gt_output_file* const output_file,const char *te
 GT_INLINE gt_output_buffer* __gt_buffered_output_file_request_buffer(gt_output_file* const output_file) {
   GT_OUTPUT_FILE_CONSISTENCY_CHECK(output_file);
   // Conditional guard. Wait till there is any free buffer left
+  GT_PROFILE_START(GT_PROFILE_OUTPUT_WAIT);
   while (output_file->buffer_busy==GT_MAX_OUTPUT_BUFFERS) {
     GT_CV_WAIT(output_file->out_buffer_cond,output_file->out_file_mutex);
   }
+  GT_PROFILE_STOP(GT_PROFILE_OUTPUT_WAIT);
   // There is at least one free buffer. Get it!
   register uint64_t i;
   for (i=0;i<GT_MAX_OUTPUT_BUFFERS&&output_file->buffer[i]!=NULL;++i) {
@@ -159,13 +181,21 @@ GT_INLINE gt_output_buffer* gt_output_file_write_buffer(
   GT_OUTPUT_FILE_CONSISTENCY_CHECK(output_file);
   register int64_t bytes_written;
   register gt_vector* const vbuffer = gt_output_buffer_to_vchar(output_buffer);
+  GT_PROFILE_START(GT_PROFILE_OUTPUT_WAIT);
   GT_BEGIN_MUTEX_SECTION(output_file->out_file_mutex)
   {
-    bytes_written = fwrite(gt_vector_get_mem(vbuffer,char),1,
-        gt_vector_get_used(vbuffer),output_file->file);
+    GT_PROFILE_STOP(GT_PROFILE_OUTPUT_WAIT);
+    GT_PROFILE_START(GT_PROFILE_OUTPUT_WRITE);
+    bytes_written = (gt_expect_false(output_file->write_error)) ? 0 :
+        fwrite(gt_vector_get_mem(vbuffer,char),1,gt_vector_get_used(vbuffer),output_file->file);
+    GT_PROFILE_STOP(GT_PROFILE_OUTPUT_WRITE);
+    if (bytes_written!=gt_vector_get_used(vbuffer)) {
+      gt_cond_fatal_error(output_file->fatal_write_error,OUTPUT_FILE_FAIL_WRITE);
+      output_file->write_error = true;
+    }
   }
   GT_END_MUTEX_SECTION(output_file->out_file_mutex);
-  gt_cond_fatal_error(bytes_written!=gt_vector_get_used(vbuffer),OUTPUT_FILE_FAIL_WRITE);
+  GT_PROFILE_ADD_BYTES_OUT(bytes_written);
   gt_output_buffer_initiallize(output_buffer,GT_OUTPUT_BUFFER_BUSY);
   return output_buffer;
 }
@@ -179,11 +209,13 @@ GT_INLINE gt_output_buffer* gt_output_file_sorted_write_buffer_asynchronous(
   {
     victim = (output_file->mayor_block_id==gt_output_buffer_get_mayor_block_id(output_buffer) &&
               output_file->minor_block_id==gt_output_buffer_get_minor_block_id(output_buffer));
+    GT_PROFILE_START(GT_PROFILE_OUTPUT_WAIT);
     while (!asynchronous && !victim) {
       GT_CV_WAIT(output_file->out_write_cond,output_file->out_file_mutex);
       victim = (output_file->mayor_block_id==gt_output_buffer_get_mayor_block_id(output_buffer) &&
                 output_file->minor_block_id==gt_output_buffer_get_minor_block_id(output_buffer));
     }
+    GT_PROFILE_STOP(GT_PROFILE_OUTPUT_WAIT);
     // Set the buffer as write pending
     ++output_file->buffer_write_pending;
     gt_output_buffer_set_state(output_buffer,GT_OUTPUT_BUFFER_WRITE_PENDING);
@@ -201,11 +233,16 @@ GT_INLINE gt_output_buffer* gt_output_file_sorted_write_buffer_asynchronous(
   do {
     // Write the current buffer
     register gt_vector* const vbuffer = gt_output_buffer_to_vchar(output_buffer);
-    register const int64_t bytes_written =
+    GT_PROFILE_START(GT_PROFILE_OUTPUT_WRITE);
+    register const int64_t bytes_written = (gt_expect_false(output_file->write_error)) ? 0 :
         fwrite(gt_vector_get_mem(vbuffer,char),1,gt_vector_get_used(vbuffer),output_file->file);
-    gt_cond_fatal_error(bytes_written!=gt_vector_get_used(vbuffer),OUTPUT_FILE_FAIL_WRITE);
+    GT_PROFILE_STOP(GT_PROFILE_OUTPUT_WRITE);
+    register const bool write_failed = (bytes_written!=gt_vector_get_used(vbuffer));
+    gt_cond_fatal_error(write_failed && output_file->fatal_write_error,OUTPUT_FILE_FAIL_WRITE);
+    GT_PROFILE_ADD_BYTES_OUT(bytes_written);
     // Update buffers' state
     GT_BEGIN_MUTEX_SECTION(output_file->out_file_mutex) {
+      if (write_failed) output_file->write_error = true; // Victims write one at a time
       // Decrement write-pending blocks and update next block ID (mayorID,minorID)
       --output_file->buffer_write_pending;
       if (output_buffer->is_final_block) {
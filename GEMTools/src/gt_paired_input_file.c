@@ -0,0 +1,173 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_paired_input_file.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Paired reader of two synchronized files (end/1,end/2)
+ *   Each file is read by its own I/O thread, which cuts it into blocks of the same number of lines.
+ *   Matched block pairs are handed to the workers through a bounded queue (no lock held while reading)
+ */
+
+#include "gt_paired_input_file.h"
+
+#define GT_PIF_BUFFER_SIZE GT_BUFFER_SIZE_4M
+
+typedef struct {
+  gt_paired_input_file* paired_input_file;
+  uint64_t end;
+} gt_paired_input_reader_args;
+
+/*
+ * I/O thread (one per end)
+ */
+void* gt_paired_input_file_reader(void* const reader_args) {
+  register gt_paired_input_file* const paired_input_file = ((gt_paired_input_reader_args*)reader_args)->paired_input_file;
+  register const uint64_t end = ((gt_paired_input_reader_args*)reader_args)->end;
+  free(reader_args);
+  register gt_input_file* const input_file = paired_input_file->input_file[end];
+  register uint64_t lines_read;
+  do {
+    // Wait for a free block
+    register gt_paired_input_block* block;
+    GT_BEGIN_MUTEX_SECTION(paired_input_file->queue_mutex) {
+      while (!paired_input_file->closing &&
+          paired_input_file->blocks_filled[end]-paired_input_file->blocks_consumed >= paired_input_file->num_blocks) {
+        GT_CV_WAIT(paired_input_file->block_free_cond,paired_input_file->queue_mutex);
+      }
+      if (paired_input_file->closing) {
+        GT_END_MUTEX_SECTION(paired_input_file->queue_mutex);
+        return NULL;
+      }
+      block = paired_input_file->blocks[end]+(paired_input_file->blocks_filled[end]%paired_input_file->num_blocks);
+    } GT_END_MUTEX_SECTION(paired_input_file->queue_mutex);
+    // Read the block (outside the lock)
+    block->first_line_num = input_file->processed_lines+1;
+    lines_read = (input_file->eof) ? 0 :
+        gt_input_file_get_lines(input_file,block->block_buffer,paired_input_file->num_lines);
+    if (lines_read==0) gt_vector_clear(block->block_buffer);
+    block->lines_in_buffer = lines_read;
+    // Publish the block (an empty block signals EOF)
+    GT_BEGIN_MUTEX_SECTION(paired_input_file->queue_mutex) {
+      ++paired_input_file->blocks_filled[end];
+      GT_CV_BROADCAST(paired_input_file->block_ready_cond);
+    } GT_END_MUTEX_SECTION(paired_input_file->queue_mutex);
+  } while (lines_read>0);
+  return NULL;
+}
+
+/*
+ * Paired Input File Handlers
+ */
+gt_paired_input_file* gt_paired_input_file_new(
+    gt_input_file* const input_file_end1,gt_input_file* const input_file_end2,
+    const uint64_t num_lines,const uint64_t num_blocks) {
+  GT_INPUT_FILE_CHECK(input_file_end1);
+  GT_INPUT_FILE_CHECK(input_file_end2);
+  gt_paired_input_file* paired_input_file = malloc(sizeof(gt_paired_input_file));
+  gt_cond_fatal_error(!paired_input_file,MEM_HANDLER);
+  /* Input files */
+  paired_input_file->input_file[0] = input_file_end1;
+  paired_input_file->input_file[1] = input_file_end2;
+  paired_input_file->num_lines = gt_expect_true(num_lines) ? num_lines : GT_PIF_NUM_LINES;
+  /* Queue of blocks (per end) */
+  paired_input_file->num_blocks = gt_expect_true(num_blocks) ? num_blocks : GT_PIF_NUM_BLOCKS;
+  register uint64_t end, i;
+  for (end=0;end<2;++end) {
+    paired_input_file->blocks[end] = malloc(paired_input_file->num_blocks*sizeof(gt_paired_input_block));
+    gt_cond_fatal_error(!paired_input_file->blocks[end],MEM_HANDLER);
+    for (i=0;i<paired_input_file->num_blocks;++i) {
+      paired_input_file->blocks[end][i].block_buffer = gt_vector_new(GT_PIF_BUFFER_SIZE,sizeof(uint8_t));
+      paired_input_file->blocks[end][i].lines_in_buffer = 0;
+      paired_input_file->blocks[end][i].first_line_num = 0;
+    }
+    paired_input_file->blocks_filled[end] = 0;
+  }
+  paired_input_file->blocks_consumed = 0;
+  paired_input_file->closing = false;
+  gt_cond_fatal_error(pthread_mutex_init(&paired_input_file->queue_mutex,NULL),SYS_MUTEX_INIT);
+  gt_cond_fatal_error(pthread_cond_init(&paired_input_file->block_ready_cond,NULL),SYS_COND_VAR_INIT);
+  gt_cond_fatal_error(pthread_cond_init(&paired_input_file->block_free_cond,NULL),SYS_COND_VAR_INIT);
+  /* I/O threads */
+  for (end=0;end<2;++end) {
+    gt_paired_input_reader_args* const reader_args = malloc(sizeof(gt_paired_input_reader_args));
+    gt_cond_fatal_error(!reader_args,MEM_HANDLER);
+    reader_args->paired_input_file = paired_input_file;
+    reader_args->end = end;
+    gt_cond_fatal_error(pthread_create(paired_input_file->reader_thread+end,NULL,
+        gt_paired_input_file_reader,reader_args),SYS_THREAD);
+  }
+  return paired_input_file;
+}
+gt_status gt_paired_input_file_close(gt_paired_input_file* const paired_input_file) {
+  GT_PAIRED_INPUT_FILE_CHECK(paired_input_file);
+  // Stop the I/O threads
+  GT_BEGIN_MUTEX_SECTION(paired_input_file->queue_mutex) {
+    paired_input_file->closing = true;
+    GT_CV_BROADCAST(paired_input_file->block_free_cond);
+  } GT_END_MUTEX_SECTION(paired_input_file->queue_mutex);
+  register uint64_t end, i;
+  for (end=0;end<2;++end) {
+    gt_cond_fatal_error(pthread_join(paired_input_file->reader_thread[end],NULL),SYS_THREAD_JOIN);
+  }
+  // Free
+  for (end=0;end<2;++end) {
+    for (i=0;i<paired_input_file->num_blocks;++i) {
+      gt_vector_delete(paired_input_file->blocks[end][i].block_buffer);
+    }
+    free(paired_input_file->blocks[end]);
+  }
+  gt_cond_fatal_error(pthread_mutex_destroy(&paired_input_file->queue_mutex),SYS_MUTEX_DESTROY);
+  gt_cond_fatal_error(pthread_cond_destroy(&paired_input_file->block_ready_cond),SYS_COND_VAR_DESTROY);
+  gt_cond_fatal_error(pthread_cond_destroy(&paired_input_file->block_free_cond),SYS_COND_VAR_DESTROY);
+  free(paired_input_file);
+  return GT_PIF_OK;
+}
+
+/*
+ * Get the next pair of matched blocks
+ */
+#define GT_PAIRED_INPUT_FILE_SWAP_BLOCK(block,buffered_input,block_id) { \
+  register gt_vector* const buffer_swap = buffered_input->block_buffer; \
+  buffered_input->block_buffer = block->block_buffer; \
+  block->block_buffer = buffer_swap; \
+  buffered_input->block_id = block_id; \
+  buffered_input->lines_in_buffer = block->lines_in_buffer; \
+  buffered_input->current_line_num = block->first_line_num; \
+  buffered_input->cursor = gt_vector_get_mem(buffered_input->block_buffer,char); \
+}
+GT_INLINE gt_status gt_paired_input_file_get_blocks(
+    gt_paired_input_file* const paired_input_file,
+    gt_buffered_input_file* const buffered_input_end1,gt_buffered_input_file* const buffered_input_end2) {
+  GT_PAIRED_INPUT_FILE_CHECK(paired_input_file);
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_input_end1);
+  GT_BUFFERED_INPUT_FILE_CHECK(buffered_input_end2);
+  register gt_status status = GT_PIF_OK;
+  GT_PROFILE_START(GT_PROFILE_INPUT_WAIT);
+  GT_BEGIN_MUTEX_SECTION(paired_input_file->queue_mutex) {
+    // Wait for both ends of the next block (other workers may consume blocks meanwhile)
+    while (paired_input_file->blocks_filled[0]<=paired_input_file->blocks_consumed ||
+           paired_input_file->blocks_filled[1]<=paired_input_file->blocks_consumed) {
+      GT_CV_WAIT(paired_input_file->block_ready_cond,paired_input_file->queue_mutex);
+    }
+    GT_PROFILE_STOP(GT_PROFILE_INPUT_WAIT);
+    register const uint64_t next_block = paired_input_file->blocks_consumed;
+    register const uint64_t block_pos = next_block%paired_input_file->num_blocks;
+    register gt_paired_input_block* const block_end1 = paired_input_file->blocks[0]+block_pos;
+    register gt_paired_input_block* const block_end2 = paired_input_file->blocks[1]+block_pos;
+    if (block_end1->lines_in_buffer==0 || block_end2->lines_in_buffer==0) {
+      // EOF (left in the queue, so every worker gets it)
+      status = (block_end1->lines_in_buffer==block_end2->lines_in_buffer) ? GT_PIF_EOF : GT_PIF_FAIL;
+    } else if (block_end1->lines_in_buffer!=block_end2->lines_in_buffer) {
+      status = GT_PIF_FAIL;
+    } else {
+      register const uint32_t block_id = next_block%UINT32_MAX;
+      GT_PAIRED_INPUT_FILE_SWAP_BLOCK(block_end1,buffered_input_end1,block_id);
+      GT_PAIRED_INPUT_FILE_SWAP_BLOCK(block_end2,buffered_input_end2,block_id);
+      GT_PROFILE_ADD_BLOCK(gt_vector_get_used(buffered_input_end1->block_buffer)+
+          gt_vector_get_used(buffered_input_end2->block_buffer));
+      ++paired_input_file->blocks_consumed;
+      GT_CV_BROADCAST(paired_input_file->block_free_cond);
+    }
+  } GT_END_MUTEX_SECTION(paired_input_file->queue_mutex);
+  return status;
+}
@@ -0,0 +1,196 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_profiler.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Low-overhead per-thread profiling of the I/O pipeline (block fetch, parse, process, format, output)
+ */
+
+#include "gt_profiler.h"
+
+const char* const gt_profile_stage_label[GT_PROFILE_NUM_STAGES] =
+  { "INPUT.WAIT", "INPUT.FETCH", "PARSE", "PROCESS", "FORMAT", "OUTPUT.WAIT", "OUTPUT.WRITE" };
+
+bool gt_profile_enabled = false;
+
+/* Registered profiles (one per thread, valid while the thread's generation is the current one) */
+static __thread gt_profile* gt_profile_local = NULL;
+static __thread uint64_t gt_profile_local_generation = 0;
+static gt_profile* gt_profile_list = NULL;
+static uint64_t gt_profile_num_threads = 0;
+static uint64_t gt_profile_generation = 1;
+static pthread_mutex_t gt_profile_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+GT_INLINE uint64_t gt_profile_get_timestamp() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Setup
+ */
+GT_INLINE void gt_profile_enable(const bool enabled) {
+  gt_profile_enabled = enabled;
+}
+GT_INLINE void gt_profile_clear(gt_profile* const profile) {
+  register uint64_t i;
+  for (i=0;i<GT_PROFILE_NUM_STAGES;++i) {
+    profile->time[i] = 0;
+    profile->calls[i] = 0;
+  }
+  profile->num_records = 0;
+  profile->num_blocks = 0;
+  profile->bytes_in = 0;
+  profile->bytes_out = 0;
+  profile->depth = 0;
+  profile->last_timestamp = 0;
+  profile->first_timestamp = 0;
+}
+GT_INLINE void gt_profile_reset() {
+  GT_BEGIN_MUTEX_SECTION(gt_profile_mutex) {
+    register gt_profile* profile;
+    for (profile=gt_profile_list;profile!=NULL;profile=profile->next) gt_profile_clear(profile);
+  } GT_END_MUTEX_SECTION(gt_profile_mutex);
+}
+GT_INLINE void gt_profile_destroy() {
+  GT_BEGIN_MUTEX_SECTION(gt_profile_mutex) {
+    while (gt_profile_list!=NULL) {
+      register gt_profile* const profile = gt_profile_list;
+      gt_profile_list = profile->next;
+      free(profile);
+    }
+    gt_profile_num_threads = 0;
+    ++gt_profile_generation; // Local profiles of all threads are now stale
+  } GT_END_MUTEX_SECTION(gt_profile_mutex);
+}
+
+/*
+ * Accounting (current thread)
+ */
+GT_INLINE gt_profile* gt_profile_get_local() {
+  if (gt_expect_false(gt_profile_local==NULL || gt_profile_local_generation!=gt_profile_generation)) {
+    register gt_profile* const profile = malloc(sizeof(gt_profile));
+    gt_cond_fatal_error(!profile,MEM_HANDLER);
+    gt_profile_clear(profile);
+    GT_BEGIN_MUTEX_SECTION(gt_profile_mutex) {
+      profile->next = gt_profile_list;
+      gt_profile_list = profile;
+      ++gt_profile_num_threads;
+      gt_profile_local_generation = gt_profile_generation;
+    } GT_END_MUTEX_SECTION(gt_profile_mutex);
+    gt_profile_local = profile;
+  }
+  return gt_profile_local;
+}
+GT_INLINE void gt_profile_start(const gt_profile_stage stage) {
+  register gt_profile* const profile = gt_profile_get_local();
+  register const uint64_t timestamp = gt_profile_get_timestamp();
+  // Charge the elapsed time to the enclosing section (or to PROCESS if none)
+  if (profile->last_timestamp==0) {
+    profile->first_timestamp = timestamp;
+  } else {
+    register const gt_profile_stage enclosing = (profile->depth>0) ?
+        profile->stack[GT_MIN(profile->depth,GT_PROFILE_MAX_DEPTH)-1] : GT_PROFILE_PROCESS;
+    profile->time[enclosing] += timestamp-profile->last_timestamp;
+  }
+  profile->last_timestamp = timestamp;
+  // Push
+  if (profile->depth<GT_PROFILE_MAX_DEPTH) profile->stack[profile->depth] = stage;
+  ++profile->depth;
+  ++profile->calls[stage];
+}
+GT_INLINE void gt_profile_stop(const gt_profile_stage stage) {
+  register gt_profile* const profile = gt_profile_get_local();
+  if (profile->depth==0) return; // Enabled in the middle of a section
+  register const uint64_t timestamp = gt_profile_get_timestamp();
+  profile->time[stage] += timestamp-profile->last_timestamp;
+  profile->last_timestamp = timestamp;
+  // Pop
+  --profile->depth;
+}
+GT_INLINE void gt_profile_add_block(const uint64_t num_bytes) {
+  register gt_profile* const profile = gt_profile_get_local();
+  ++profile->num_blocks;
+  profile->bytes_in += num_bytes;
+}
+
+/*
+ * Reports
+ */
+GT_INLINE uint64_t gt_profile_get_num_threads() {
+  return gt_profile_num_threads;
+}
+GT_INLINE gt_profile* gt_profile_get_thread(const uint64_t thread_num) {
+  register gt_profile* profile;
+  register uint64_t i = gt_profile_num_threads-1-thread_num; // List kept in reverse order
+  GT_BEGIN_MUTEX_SECTION(gt_profile_mutex) {
+    for (profile=gt_profile_list;profile!=NULL && i>0;profile=profile->next,--i);
+  } GT_END_MUTEX_SECTION(gt_profile_mutex);
+  return profile;
+}
+GT_INLINE uint64_t gt_profile_get_totals(gt_profile* const profile) {
+  GT_NULL_CHECK(profile);
+  gt_profile_clear(profile);
+  register uint64_t first_timestamp = UINT64_MAX, last_timestamp = 0;
+  GT_BEGIN_MUTEX_SECTION(gt_profile_mutex) {
+    register gt_profile* thread_profile;
+    for (thread_profile=gt_profile_list;thread_profile!=NULL;thread_profile=thread_profile->next) {
+      register uint64_t i;
+      for (i=0;i<GT_PROFILE_NUM_STAGES;++i) {
+        profile->time[i] += thread_profile->time[i];
+        profile->calls[i] += thread_profile->calls[i];
+      }
+      profile->num_records += thread_profile->num_records;
+      profile->num_blocks += thread_profile->num_blocks;
+      profile->bytes_in += thread_profile->bytes_in;
+      profile->bytes_out += thread_profile->bytes_out;
+      if (thread_profile->last_timestamp>0) {
+        first_timestamp = GT_MIN(first_timestamp,thread_profile->first_timestamp);
+        last_timestamp = GT_MAX(last_timestamp,thread_profile->last_timestamp);
+      }
+    }
+  } GT_END_MUTEX_SECTION(gt_profile_mutex);
+  profile->first_timestamp = (last_timestamp>0) ? first_timestamp : 0;
+  profile->last_timestamp = last_timestamp;
+  return (last_timestamp>0) ? last_timestamp-first_timestamp : 0;
+}
+
+/*
+ * Printers
+ */
+GT_INLINE void gt_profile_print_stages(FILE* stream,gt_profile* const profile) {
+  register uint64_t i, total_time = 0;
+  for (i=0;i<GT_PROFILE_NUM_STAGES;++i) total_time += profile->time[i];
+  for (i=0;i<GT_PROFILE_NUM_STAGES;++i) {
+    fprintf(stream,"    --> %-12s %10.3f s (%6.2f%%) %" PRIu64 " calls\n",gt_profile_stage_label[i],
+        (double)profile->time[i]/1e9,total_time ? 100.0*(double)profile->time[i]/(double)total_time : 0.0,
+        profile->calls[i]);
+  }
+}
+GT_INLINE void gt_profile_print(FILE* stream) {
+  GT_NULL_CHECK(stream);
+  gt_profile totals;
+  register const uint64_t wall_time = gt_profile_get_totals(&totals);
+  register const double seconds = (double)wall_time/1e9;
+  fprintf(stream,"[PROFILE]\n");
+  fprintf(stream,"  --> Wall.time %.3f s (%" PRIu64 " threads)\n",seconds,gt_profile_num_threads);
+  fprintf(stream,"  --> Records %" PRIu64 " (%.1f records/s)\n",totals.num_records,
+      seconds>0.0 ? (double)totals.num_records/seconds : 0.0);
+  fprintf(stream,"  --> Input %" PRIu64 " blocks %.2f MB (%.2f MB/s)\n",totals.num_blocks,
+      (double)totals.bytes_in/1e6,seconds>0.0 ? (double)totals.bytes_in/1e6/seconds : 0.0);
+  fprintf(stream,"  --> Output %.2f MB (%.2f MB/s)\n",
+      (double)totals.bytes_out/1e6,seconds>0.0 ? (double)totals.bytes_out/1e6/seconds : 0.0);
+  fprintf(stream,"  --> Wait.time Input %.3f s Output %.3f s\n",
+      (double)totals.time[GT_PROFILE_INPUT_WAIT]/1e9,(double)totals.time[GT_PROFILE_OUTPUT_WAIT]/1e9);
+  fprintf(stream,"  --> Stages (all threads)\n");
+  gt_profile_print_stages(stream,&totals);
+  if (gt_profile_num_threads>1) {
+    register uint64_t i;
+    for (i=0;i<gt_profile_num_threads;++i) {
+      register gt_profile* const profile = gt_profile_get_thread(i);
+      fprintf(stream,"  --> Thread.%" PRIu64 " %" PRIu64 " records\n",i,profile->num_records);
+      gt_profile_print_stages(stream,profile);
+    }
+  }
+}
@@ -156,20 +156,17 @@ int gt_sequence_archive_karyotypic_sort_fx(char *a,char *b) {
   return str_cmp_ab;
 }
 
-#define gt_cmp_string_wrapper(arg1,arg2) gt_cmp_string((char*)arg1,(char*)arg2)
-#define gt_sequence_archive_lexicographical_sort_fx_wrapper(arg1,arg2) gt_sequence_archive_lexicographical_sort_fx((char*)arg1,(char*)arg2)
-#define gt_sequence_archive_karyotypic_sort_fx_wrapper(arg1,arg2) gt_sequence_archive_karyotypic_sort_fx((char*)arg1,(char*)arg2)
 GT_INLINE void gt_sequence_archive_sort(gt_sequence_archive* const seq_archive,int (*gt_cmp_string)(char*,char*)) {
   GT_SEQUENCE_ARCHIVE_CHECK(seq_archive);
-  HASH_SORT(seq_archive->sequences->shash_head,gt_cmp_string_wrapper);
+  gt_shash_sort(seq_archive->sequences,gt_cmp_string);
 }
 GT_INLINE void gt_sequence_archive_lexicographical_sort(gt_sequence_archive* const seq_archive) {
   GT_SEQUENCE_ARCHIVE_CHECK(seq_archive);
-  HASH_SORT(seq_archive->sequences->shash_head,gt_sequence_archive_lexicographical_sort_fx_wrapper);
+  gt_shash_sort(seq_archive->sequences,gt_sequence_archive_lexicographical_sort_fx);
 }
 GT_INLINE void gt_sequence_archive_karyotypic_sort(gt_sequence_archive* const seq_archive) {
   GT_SEQUENCE_ARCHIVE_CHECK(seq_archive);
-  HASH_SORT(seq_archive->sequences->shash_head,gt_sequence_archive_karyotypic_sort_fx_wrapper);
+  gt_shash_sort(seq_archive->sequences,gt_sequence_archive_karyotypic_sort_fx);
 }
 
 /*
@@ -180,18 +177,23 @@ GT_INLINE void gt_sequence_archive_new_iterator(
   GT_SEQUENCE_ARCHIVE_CHECK(seq_archive);
   GT_NULL_CHECK(seq_archive_iterator);
   seq_archive_iterator->sequence_archive = seq_archive;
-  seq_archive_iterator->shash_it = seq_archive->sequences->shash_head;
+  seq_archive_iterator->shash_position = 0;
 }
 GT_INLINE bool gt_sequence_archive_iterator_eos(gt_sequence_archive_iterator* const seq_archive_iterator) {
   GT_SEQUENCE_ARCHIVE_ITERATOR_CHECK(seq_archive_iterator);
-  return seq_archive_iterator->shash_it==NULL;
+  register gt_shash* const sequences = seq_archive_iterator->sequence_archive->sequences;
+  // Skip removed sequences
+  while (seq_archive_iterator->shash_position<sequences->elements_used &&
+      gt_shash_get_shash_element_at(sequences,seq_archive_iterator->shash_position)->element==NULL) {
+    ++seq_archive_iterator->shash_position;
+  }
+  return seq_archive_iterator->shash_position>=sequences->elements_used;
 }
 GT_INLINE gt_segmented_sequence* gt_sequence_archive_iterator_next(gt_sequence_archive_iterator* const seq_archive_iterator) {
   GT_SEQUENCE_ARCHIVE_ITERATOR_CHECK(seq_archive_iterator);
-  if (seq_archive_iterator->shash_it) {
-    register gt_segmented_sequence* elm =  seq_archive_iterator->shash_it->element;
-    seq_archive_iterator->shash_it = seq_archive_iterator->shash_it->hh.next;
-    return elm;
+  if (!gt_sequence_archive_iterator_eos(seq_archive_iterator)) {
+    register gt_shash* const sequences = seq_archive_iterator->sequence_archive->sequences;
+    return gt_shash_get_shash_element_at(sequences,seq_archive_iterator->shash_position++)->element;
   } else {
     return NULL;
   }
@@ -311,6 +313,90 @@ GT_INLINE gt_status gt_segmented_sequence_get_sequence(
   return (i==length) ? GT_SEQ_ARCHIVE_OK : GT_SEQ_ARCHIVE_CHUNK_OUT_OF_RANGE;
 }
 
+/*
+ * SegmentedSEQ Parallel encoding
+ */
+typedef struct {
+  gt_compact_dna_string* block;
+  char* string;
+  uint64_t length;
+} gt_segmented_sequence_encode_job;
+typedef struct {
+  gt_vector* jobs; /* (gt_segmented_sequence_encode_job) */
+  uint64_t next_job;
+  pthread_mutex_t jobs_mutex;
+} gt_segmented_sequence_encode_queue;
+
+void* gt_segmented_sequence_encode_thread(void* const encode_queue) {
+  register gt_segmented_sequence_encode_queue* const queue = (gt_segmented_sequence_encode_queue*) encode_queue;
+  register const uint64_t num_jobs = gt_vector_get_used(queue->jobs);
+  while (true) {
+    register uint64_t job_num;
+    GT_BEGIN_MUTEX_SECTION(queue->jobs_mutex) {
+      job_num = queue->next_job++;
+    } GT_END_MUTEX_SECTION(queue->jobs_mutex);
+    if (job_num>=num_jobs) break;
+    register gt_segmented_sequence_encode_job* const job =
+        gt_vector_get_elm(queue->jobs,job_num,gt_segmented_sequence_encode_job);
+    gt_cdna_string_append_string(job->block,job->string,job->length);
+  }
+  return NULL;
+}
+GT_INLINE void gt_segmented_sequence_append_strings_parallel(
+    gt_segmented_sequence** const sequences,char** const strings,uint64_t* const lengths,
+    const uint64_t num_sequences,const uint64_t num_threads) {
+  GT_NULL_CHECK(sequences);
+  GT_NULL_CHECK(strings);
+  GT_NULL_CHECK(lengths);
+  GT_ZERO_CHECK(num_threads);
+  // Split every string into block-sized encoding jobs (blocks are allocated here, encoded later)
+  gt_segmented_sequence_encode_queue queue;
+  queue.jobs = gt_vector_new(GT_SEQ_ARCHIVE_NUM_BLOCKS,sizeof(gt_segmented_sequence_encode_job));
+  queue.next_job = 0;
+  gt_cond_fatal_error(pthread_mutex_init(&queue.jobs_mutex,NULL),SYS_MUTEX_INIT);
+  register uint64_t i;
+  for (i=0;i<num_sequences;++i) {
+    register gt_segmented_sequence* const sequence = sequences[i];
+    GT_SEGMENTED_SEQ_CHECK(sequence);
+    register uint64_t block_free_space = GT_SEQ_ARCHIVE_BLOCK_SIZE-(sequence->sequence_total_length%GT_SEQ_ARCHIVE_BLOCK_SIZE);
+    register uint64_t current_length = sequence->sequence_total_length;
+    register uint64_t chars_written = 0;
+    while (chars_written < lengths[i]) {
+      register const uint64_t chunk_size = ((lengths[i]-chars_written)<block_free_space) ?
+          lengths[i]-chars_written : block_free_space;
+      gt_vector_reserve_additional(queue.jobs,1);
+      register gt_segmented_sequence_encode_job* const job = gt_vector_get_free_elm(queue.jobs,gt_segmented_sequence_encode_job);
+      gt_vector_inc_used(queue.jobs);
+      job->block = gt_segmented_sequence_get_block(sequence,current_length);
+      job->string = strings[i]+chars_written;
+      job->length = chunk_size;
+      chars_written += chunk_size;
+      current_length += chunk_size;
+      block_free_space = GT_SEQ_ARCHIVE_BLOCK_SIZE;
+    }
+    sequence->sequence_total_length = current_length;
+  }
+  // Encode all the blocks
+  register const uint64_t num_jobs = gt_vector_get_used(queue.jobs);
+  register const uint64_t num_workers = GT_MIN(num_threads,num_jobs);
+  if (num_workers<=1) {
+    gt_segmented_sequence_encode_thread(&queue);
+  } else {
+    pthread_t* const workers = malloc(num_workers*sizeof(pthread_t));
+    gt_cond_fatal_error(!workers,MEM_HANDLER);
+    for (i=0;i<num_workers;++i) {
+      gt_cond_fatal_error(pthread_create(workers+i,NULL,gt_segmented_sequence_encode_thread,&queue),SYS_THREAD);
+    }
+    for (i=0;i<num_workers;++i) {
+      gt_cond_fatal_error(pthread_join(workers[i],NULL),SYS_THREAD_JOIN);
+    }
+    free(workers);
+  }
+  // Free
+  gt_cond_fatal_error(pthread_mutex_destroy(&queue.jobs_mutex),SYS_MUTEX_DESTROY);
+  gt_vector_delete(queue.jobs);
+}
+
 /*
  * SegmentedSEQ Iterator
  */
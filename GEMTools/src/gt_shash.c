@@ -3,7 +3,7 @@
  * FILE: gt_shash.c
  * DATE: 10/07/2012
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
- * DESCRIPTION: // TODO
+ * DESCRIPTION: String key hash (open addressing, see gt_hash.h)
  */
 
 #include "gt_hash.h"
@@ -28,11 +28,94 @@ GT_INLINE void gt_shash_free_element(gt_shash_element* const shash_element) {
 GT_INLINE void gt_shash_free_shash_element(gt_shash_element* const shash_element,const bool free_element) {
   GT_NULL_CHECK(shash_element);
   // Free key
-  free(shash_element->key);
+  if (shash_element->key!=shash_element->key_buffer) free(shash_element->key);
   // Free element
   if (free_element) gt_shash_free_element(shash_element);
-  // Free handler
-  free(shash_element);
+  shash_element->element = NULL;
+}
+
+/*
+ * Index
+ */
+GT_INLINE gt_hash_slot* gt_shash_index_lookup(
+    gt_shash* const shash,char* const key,const uint64_t key_length,const uint64_t hash) {
+  if (gt_expect_false(shash->index_size==0)) return NULL;
+  register const uint64_t mask = shash->index_size-1;
+  register uint64_t i = hash & mask;
+  while (true) {
+    register gt_hash_slot* const slot = shash->index+i;
+    if (slot->position==0) return NULL;
+    if (slot->position!=GT_HASH_SLOT_DELETED && slot->hash==hash) {
+      register gt_shash_element* const shash_element = gt_shash_get_shash_element_at(shash,slot->position-1);
+      if (shash_element->key_length==key_length && memcmp(shash_element->key,key,key_length)==0) return slot;
+    }
+    i = (i+1) & mask;
+  }
+}
+GT_INLINE void gt_shash_index_add(gt_shash* const shash,const uint64_t hash,const uint64_t position) {
+  register const uint64_t mask = shash->index_size-1;
+  register uint64_t i = hash & mask;
+  while (shash->index[i].position!=0 && shash->index[i].position!=GT_HASH_SLOT_DELETED) i = (i+1) & mask;
+  if (shash->index[i].position==0) ++shash->index_occupied;
+  shash->index[i].hash = hash;
+  shash->index[i].position = position+1;
+}
+GT_INLINE void gt_shash_index_rebuild(gt_shash* const shash,const uint64_t index_size) {
+  if (index_size!=shash->index_size) {
+    free(shash->index);
+    shash->index = malloc(index_size*sizeof(gt_hash_slot));
+    gt_cond_fatal_error(!shash->index,MEM_ALLOC);
+    shash->index_size = index_size;
+  }
+  memset(shash->index,0,index_size*sizeof(gt_hash_slot));
+  shash->index_occupied = 0;
+  register uint64_t position;
+  for (position=0;position<shash->elements_used;++position) {
+    register gt_shash_element* const shash_element = gt_shash_get_shash_element_at(shash,position);
+    if (shash_element->element!=NULL) gt_shash_index_add(shash,shash_element->hash,position);
+  }
+}
+GT_INLINE gt_shash_element* gt_shash_add_shash_element(
+    gt_shash* const shash,char* const key,const uint64_t key_length,const uint64_t hash) {
+  // Grow the index (or purge deleted slots) keeping the load factor under 1/2
+  if (gt_expect_false(2*(shash->index_occupied+1)>shash->index_size)) {
+    register uint64_t index_size = GT_MAX(shash->index_size,GT_HASH_INDEX_MIN_SIZE);
+    while (4*(shash->num_elements+1)>index_size) index_size *= 2;
+    gt_shash_index_rebuild(shash,index_size);
+  }
+  // Allocate the element (new blocks are never relocated)
+  register const uint64_t position = shash->elements_used;
+  register const uint64_t block_num = gt_hash_block_num(position);
+  if (gt_expect_false(block_num>=shash->num_blocks)) {
+    gt_cond_fatal_error(block_num>=GT_HASH_MAX_BLOCKS,MEM_ALLOC);
+    shash->blocks[block_num] = malloc(gt_hash_block_size(block_num)*sizeof(gt_shash_element));
+    gt_cond_fatal_error(!shash->blocks[block_num],MEM_ALLOC);
+    shash->num_blocks = block_num+1;
+  }
+  ++shash->elements_used;
+  ++shash->num_elements;
+  register gt_shash_element* const shash_element = shash->blocks[block_num]+gt_hash_block_offset(position,block_num);
+  // Set key (inline if short)
+  if (key_length<GT_SHASH_KEY_INLINE_LENGTH) {
+    memcpy(shash_element->key_buffer,key,key_length);
+    shash_element->key_buffer[key_length] = EOS;
+    shash_element->key = shash_element->key_buffer;
+  } else {
+    shash_element->key = gt_strndup(key,key_length);
+  }
+  shash_element->key_length = key_length;
+  shash_element->hash = hash;
+  gt_shash_index_add(shash,hash,position);
+  return shash_element;
+}
+GT_INLINE gt_shash_element* gt_shash_fetch_shash_element(gt_shash* const shash,char* const key,const bool free_element) {
+  register const uint64_t key_length = strlen(key);
+  register const uint64_t hash = gt_hash_string(key,key_length);
+  register gt_hash_slot* const slot = gt_shash_index_lookup(shash,key,key_length,hash);
+  if (gt_expect_true(slot==NULL)) return gt_shash_add_shash_element(shash,key,key_length,hash);
+  register gt_shash_element* const shash_element = gt_shash_get_shash_element_at(shash,slot->position-1);
+  if (free_element) gt_shash_free_element(shash_element);
+  return shash_element;
 }
 
 /*
@@ -41,20 +124,33 @@ GT_INLINE void gt_shash_free_shash_element(gt_shash_element* const shash_element
 GT_INLINE gt_shash* gt_shash_new(void) {
   gt_shash* shash=malloc(sizeof(gt_shash));
   gt_cond_fatal_error(!shash,MEM_HANDLER);
-  shash->shash_head = NULL; // uthash initializer
+  shash->num_blocks = 0;
+  shash->elements_used = 0;
+  shash->num_elements = 0;
+  shash->index = NULL; // Allocated on the first insertion
+  shash->index_size = 0;
+  shash->index_occupied = 0;
   return shash;
 }
 GT_INLINE void gt_shash_clear(gt_shash* const shash,const bool free_element) {
   GT_HASH_CHECK(shash);
-  gt_shash_element *shash_element, *tmp;
-  HASH_ITER(hh,shash->shash_head,shash_element,tmp) {
-    HASH_DEL(shash->shash_head,shash_element);
-    gt_shash_free_shash_element(shash_element,free_element);
+  register uint64_t position;
+  for (position=0;position<shash->elements_used;++position) {
+    register gt_shash_element* const shash_element = gt_shash_get_shash_element_at(shash,position);
+    if (shash_element->element!=NULL) gt_shash_free_shash_element(shash_element,free_element);
   }
+  // Keep blocks & index
+  if (shash->index_occupied>0) memset(shash->index,0,shash->index_size*sizeof(gt_hash_slot));
+  shash->elements_used = 0;
+  shash->num_elements = 0;
+  shash->index_occupied = 0;
 }
 GT_INLINE void gt_shash_delete(gt_shash* const shash,const bool free_element) {
   GT_HASH_CHECK(shash);
   gt_shash_clear(shash,free_element);
+  register uint64_t i;
+  for (i=0;i<shash->num_blocks;++i) free(shash->blocks[i]);
+  free(shash->index);
   free(shash);
 }
 
@@ -64,28 +160,18 @@ GT_INLINE void gt_shash_delete(gt_shash* const shash,const bool free_element) {
 GT_INLINE gt_shash_element* gt_shash_get_shash_element(gt_shash* const shash,char* const key) {
   GT_HASH_CHECK(shash);
   GT_NULL_CHECK(key);
-  gt_shash_element *shash_element;
-  HASH_FIND_STR(shash->shash_head,key,shash_element);
-  return shash_element;
+  register const uint64_t key_length = strlen(key);
+  register gt_hash_slot* const slot = gt_shash_index_lookup(shash,key,key_length,gt_hash_string(key,key_length));
+  return (slot!=NULL) ? gt_shash_get_shash_element_at(shash,slot->position-1) : NULL;
 }
 GT_INLINE char* gt_shash_insert_primitive(
     gt_shash* const shash,char* const key,void* const element,const int64_t element_size) {
   GT_HASH_CHECK(shash);
   GT_ZERO_CHECK(element_size);
   GT_NULL_CHECK(key); GT_NULL_CHECK(element);
-  register gt_shash_element *shash_element = gt_shash_get_shash_element(shash,key);
-  if (gt_expect_true(shash_element==NULL)) {
-    shash_element = malloc(sizeof(gt_shash_element));
-    gt_cond_fatal_error(!shash_element,MEM_ALLOC);
-    register const uint64_t key_length = strlen(key);
-    shash_element->key = gt_strndup(key,key_length);
-    shash_element->element = element;
-    HASH_ADD_KEYPTR(hh,shash->shash_head,shash_element->key,key_length,shash_element);
-  } else {
-    gt_shash_free_element(shash_element);
-    shash_element->element = element;
-  }
+  register gt_shash_element* const shash_element = gt_shash_fetch_shash_element(shash,key,true);
   // Set shash element type
+  shash_element->element = element;
   shash_element->element_type = GT_HASH_TYPE_REGULAR;
   shash_element->element_size = element_size;
   // Return key
@@ -97,19 +183,9 @@ GT_INLINE char* gt_shash_insert_object(
   GT_HASH_CHECK(shash);
   GT_NULL_CHECK(key); GT_NULL_CHECK(object);
   GT_NULL_CHECK(element_dup_fx); GT_NULL_CHECK(element_free_fx);
-  register gt_shash_element *shash_element = gt_shash_get_shash_element(shash,key);
-  if (gt_expect_true(shash_element==NULL)) {
-    shash_element = malloc(sizeof(gt_shash_element));
-    gt_cond_fatal_error(!shash_element,MEM_ALLOC);
-    register const uint64_t key_length = strlen(key);
-    shash_element->key = gt_strndup(key,key_length);
-    shash_element->element = object;
-    HASH_ADD_KEYPTR(hh,shash->shash_head,shash_element->key,key_length,shash_element);
-  } else {
-    gt_shash_free_element(shash_element);
-    shash_element->element = object;
-  }
+  register gt_shash_element* const shash_element = gt_shash_fetch_shash_element(shash,key,true);
   // Set shash element type
+  shash_element->element = object;
   shash_element->element_type = GT_HASH_TYPE_OBJECT;
   shash_element->element_setup.element_dup_fx = element_dup_fx;
   shash_element->element_setup.element_free_fx = element_free_fx;
@@ -131,10 +207,13 @@ GT_INLINE void* gt_shash_get_element(gt_shash* const shash,char* const key) {
 GT_INLINE void gt_shash_remove(gt_shash* const shash,char* const key,const bool free_element) {
   GT_HASH_CHECK(shash);
   GT_NULL_CHECK(key);
-  gt_shash_element *shash_element = gt_shash_get_shash_element(shash,key);
-  if (shash_element) {
-    HASH_DEL(shash->shash_head,shash_element);
-    gt_shash_free_shash_element(shash_element,free_element);
+  register const uint64_t key_length = strlen(key);
+  register gt_hash_slot* const slot = gt_shash_index_lookup(shash,key,key_length,gt_hash_string(key,key_length));
+  if (slot!=NULL) {
+    register gt_shash_element* const shash_element = gt_shash_get_shash_element_at(shash,slot->position-1);
+    gt_shash_free_shash_element(shash_element,free_element); // The position is not reused (until clear)
+    slot->position = GT_HASH_SLOT_DELETED;
+    --shash->num_elements;
   }
 }
 
@@ -148,7 +227,7 @@ GT_INLINE bool gt_shash_is_contained(gt_shash* const shash,char* const key) {
 }
 GT_INLINE uint64_t gt_shash_get_num_elements(gt_shash* const shash) {
   GT_HASH_CHECK(shash);
-  return (uint64_t)HASH_COUNT(shash->shash_head);
+  return shash->num_elements;
 }
 
 /*
@@ -180,3 +259,42 @@ GT_INLINE void gt_shash_copy(gt_shash* const shash_dst,gt_shash* const shash_src
     }
   } GT_SHASH_END_ITERATE;
 }
+GT_INLINE void gt_shash_sort_elements(
+    gt_shash_element* const elements,gt_shash_element* const buffer,const uint64_t num_elements,int (*key_cmp_fx)(char*,char*)) {
+  // Merge sort (stable)
+  if (num_elements<2) return;
+  register const uint64_t half = num_elements/2;
+  gt_shash_sort_elements(elements,buffer,half,key_cmp_fx);
+  gt_shash_sort_elements(elements+half,buffer,num_elements-half,key_cmp_fx);
+  register uint64_t i = 0, j = half, k = 0;
+  while (i<half && j<num_elements) {
+    buffer[k++] = (key_cmp_fx(elements[j].key,elements[i].key)<0) ? elements[j++] : elements[i++];
+  }
+  while (i<half) buffer[k++] = elements[i++];
+  while (j<num_elements) buffer[k++] = elements[j++];
+  memcpy(elements,buffer,num_elements*sizeof(gt_shash_element));
+}
+GT_INLINE void gt_shash_sort(gt_shash* const shash,int (*key_cmp_fx)(char*,char*)) {
+  GT_HASH_CHECK(shash);
+  GT_NULL_CHECK(key_cmp_fx);
+  register const uint64_t num_elements = shash->num_elements;
+  if (num_elements==0) return;
+  // Gather the elements
+  register gt_shash_element* const elements = malloc(2*num_elements*sizeof(gt_shash_element));
+  gt_cond_fatal_error(!elements,MEM_ALLOC);
+  register uint64_t position, i = 0;
+  for (position=0;position<shash->elements_used;++position) {
+    register gt_shash_element* const shash_element = gt_shash_get_shash_element_at(shash,position);
+    if (shash_element->element!=NULL) elements[i++] = *shash_element;
+  }
+  gt_shash_sort_elements(elements,elements+num_elements,num_elements,key_cmp_fx);
+  // Store them back in order
+  for (i=0;i<num_elements;++i) {
+    register gt_shash_element* const shash_element = gt_shash_get_shash_element_at(shash,i);
+    *shash_element = elements[i];
+    if (shash_element->key_length<GT_SHASH_KEY_INLINE_LENGTH) shash_element->key = shash_element->key_buffer; // Inline key
+  }
+  shash->elements_used = num_elements;
+  gt_shash_index_rebuild(shash,shash->index_size);
+  free(elements);
+}
@@ -51,6 +51,7 @@ GT_INLINE gt_maps_profile* gt_maps_profile_new() {
   // Insert Size Distribution
   maps_profile->inss = calloc(GT_STATS_INSS_RANGE,sizeof(uint64_t));
   maps_profile->inss_fine_grain = calloc(GT_STATS_INSS_FG_RANGE,sizeof(uint64_t));
+  maps_profile->inss_model = gt_inss_model_new(0);
   // Mismatch/Errors bases
   maps_profile->misms_transition = calloc(GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE,sizeof(uint64_t));
   maps_profile->qual_score_misms = calloc(GT_STATS_QUAL_SCORE_RANGE,sizeof(uint64_t));
@@ -63,6 +64,14 @@ GT_INLINE gt_maps_profile* gt_maps_profile_new() {
   maps_profile->indel_1context = calloc(GT_STATS_INDEL_1_CONTEXT,sizeof(uint64_t));
   maps_profile->indel_2context = calloc(GT_STATS_INDEL_2_CONTEXT,sizeof(uint64_t));
   maps_profile->qual_score_errors = calloc(GT_STATS_QUAL_SCORE_RANGE,sizeof(uint64_t));
+  // Indel Profile
+  maps_profile->total_insertions=0;
+  maps_profile->total_deletions=0;
+  maps_profile->insertion_event_length = calloc(GT_STATS_INDEL_LENGTH_RANGE,sizeof(uint64_t));
+  maps_profile->deletion_event_length = calloc(GT_STATS_INDEL_LENGTH_RANGE,sizeof(uint64_t));
+  maps_profile->insertion_homopolymer = calloc(GT_STATS_INDEL_HOMOPOLYMER_RANGE,sizeof(uint64_t));
+  maps_profile->deletion_homopolymer = calloc(GT_STATS_INDEL_HOMOPOLYMER_RANGE,sizeof(uint64_t));
+  maps_profile->indel_position = calloc(GT_STATS_LARGE_READ_POS_RANGE,sizeof(uint64_t));
   return maps_profile;
 }
 GT_INLINE void gt_maps_profile_clear(gt_maps_profile* const maps_profile) {
@@ -93,6 +102,7 @@ GT_INLINE void gt_maps_profile_clear(gt_maps_profile* const maps_profile) {
   // Insert Size Distribution
   memset(maps_profile->inss,0,GT_STATS_INSS_RANGE*sizeof(uint64_t));
   memset(maps_profile->inss_fine_grain,0,GT_STATS_INSS_FG_RANGE*sizeof(uint64_t));
+  gt_inss_model_clear(maps_profile->inss_model);
   // Mismatch/Errors bases
   memset(maps_profile->misms_transition,0,GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE*sizeof(uint64_t));
   memset(maps_profile->qual_score_misms,0,GT_STATS_QUAL_SCORE_RANGE*sizeof(uint64_t));
@@ -105,7 +115,14 @@ GT_INLINE void gt_maps_profile_clear(gt_maps_profile* const maps_profile) {
   memset(maps_profile->indel_1context,0,GT_STATS_INDEL_1_CONTEXT*sizeof(uint64_t));
   memset(maps_profile->indel_2context,0,GT_STATS_INDEL_2_CONTEXT*sizeof(uint64_t));
   memset(maps_profile->qual_score_errors,0,GT_STATS_QUAL_SCORE_RANGE*sizeof(uint64_t));
-
+  // Indel Profile
+  maps_profile->total_insertions=0;
+  maps_profile->total_deletions=0;
+  memset(maps_profile->insertion_event_length,0,GT_STATS_INDEL_LENGTH_RANGE*sizeof(uint64_t));
+  memset(maps_profile->deletion_event_length,0,GT_STATS_INDEL_LENGTH_RANGE*sizeof(uint64_t));
+  memset(maps_profile->insertion_homopolymer,0,GT_STATS_INDEL_HOMOPOLYMER_RANGE*sizeof(uint64_t));
+  memset(maps_profile->deletion_homopolymer,0,GT_STATS_INDEL_HOMOPOLYMER_RANGE*sizeof(uint64_t));
+  memset(maps_profile->indel_position,0,GT_STATS_LARGE_READ_POS_RANGE*sizeof(uint64_t));
 }
 GT_INLINE void gt_maps_profile_delete(gt_maps_profile* const maps_profile) {
   // Mismatch/Indel Profile
@@ -119,6 +136,7 @@ GT_INLINE void gt_maps_profile_delete(gt_maps_profile* const maps_profile) {
   // Insert Size Distribution
   free(maps_profile->inss);
   free(maps_profile->inss_fine_grain);
+  gt_inss_model_delete(maps_profile->inss_model);
   // Mismatch/Errors bases
   free(maps_profile->misms_transition);
   free(maps_profile->qual_score_misms);
@@ -131,6 +149,12 @@ GT_INLINE void gt_maps_profile_delete(gt_maps_profile* const maps_profile) {
   free(maps_profile->indel_1context);
   free(maps_profile->indel_2context);
   free(maps_profile->qual_score_errors);
+  // Indel Profile
+  free(maps_profile->insertion_event_length);
+  free(maps_profile->deletion_event_length);
+  free(maps_profile->insertion_homopolymer);
+  free(maps_profile->deletion_homopolymer);
+  free(maps_profile->indel_position);
   free(maps_profile);
 }
 GT_INLINE void gt_maps_profile_merge(
@@ -159,6 +183,7 @@ GT_INLINE void gt_maps_profile_merge(
   // Insert Size Distribution
   GT_STATS_VECTOR_ADD(maps_profile_dst->inss,maps_profile_src->inss,GT_STATS_INSS_RANGE);
   GT_STATS_VECTOR_ADD(maps_profile_dst->inss_fine_grain,maps_profile_src->inss_fine_grain,GT_STATS_INSS_FG_RANGE);
+  gt_inss_model_merge(maps_profile_dst->inss_model,maps_profile_src->inss_model);
   // Mismatch/Errors bases
   GT_STATS_VECTOR_ADD(maps_profile_dst->misms_transition,maps_profile_src->misms_transition,GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_BASE_RANGE);
   GT_STATS_VECTOR_ADD(maps_profile_dst->qual_score_misms,maps_profile_src->qual_score_misms,GT_STATS_QUAL_SCORE_RANGE);
@@ -171,6 +196,14 @@ GT_INLINE void gt_maps_profile_merge(
   GT_STATS_VECTOR_ADD(maps_profile_dst->indel_1context,maps_profile_src->indel_1context,GT_STATS_INDEL_1_CONTEXT);
   GT_STATS_VECTOR_ADD(maps_profile_dst->indel_2context,maps_profile_src->indel_2context,GT_STATS_INDEL_2_CONTEXT);
   GT_STATS_VECTOR_ADD(maps_profile_dst->qual_score_errors,maps_profile_src->qual_score_errors,GT_STATS_QUAL_SCORE_RANGE);
+  // Indel Profile
+  maps_profile_dst->total_insertions+=maps_profile_src->total_insertions;
+  maps_profile_dst->total_deletions+=maps_profile_src->total_deletions;
+  GT_STATS_VECTOR_ADD(maps_profile_dst->insertion_event_length,maps_profile_src->insertion_event_length,GT_STATS_INDEL_LENGTH_RANGE);
+  GT_STATS_VECTOR_ADD(maps_profile_dst->deletion_event_length,maps_profile_src->deletion_event_length,GT_STATS_INDEL_LENGTH_RANGE);
+  GT_STATS_VECTOR_ADD(maps_profile_dst->insertion_homopolymer,maps_profile_src->insertion_homopolymer,GT_STATS_INDEL_HOMOPOLYMER_RANGE);
+  GT_STATS_VECTOR_ADD(maps_profile_dst->deletion_homopolymer,maps_profile_src->deletion_homopolymer,GT_STATS_INDEL_HOMOPOLYMER_RANGE);
+  GT_STATS_VECTOR_ADD(maps_profile_dst->indel_position,maps_profile_src->indel_position,GT_STATS_LARGE_READ_POS_RANGE);
 }
 
 /*
@@ -421,6 +454,9 @@ GT_INLINE gt_stats* gt_stats_new() {
   stats->num_mapped=0;
   stats->mmap = calloc(GT_STATS_MMAP_RANGE,sizeof(uint64_t)); // MMaps
   stats->uniq = calloc(GT_STATS_UNIQ_RANGE,sizeof(uint64_t)); // Uniq
+  // Duplicates
+  stats->num_duplicates=0;
+  stats->num_optical_duplicates=0;
   // Maps Error Profile
   stats->maps_profile = gt_maps_profile_new();
   // Split maps Profile
@@ -446,6 +482,9 @@ GT_INLINE void gt_stats_clear(gt_stats* const stats) {
   memset(stats->mmap,0,GT_STATS_MMAP_RANGE*sizeof(uint64_t)); // MMaps
   // Uniq Distribution
   memset(stats->uniq,0,GT_STATS_UNIQ_RANGE*sizeof(uint64_t)); // Uniq
+  // Duplicates
+  stats->num_duplicates=0;
+  stats->num_optical_duplicates=0;
   // Maps Error Profile
   gt_maps_profile_clear(stats->maps_profile);
   // Split maps Profile
@@ -483,6 +522,9 @@ GT_INLINE void gt_stats_merge(gt_stats** const stats,const uint64_t stats_array_
     GT_STATS_VECTOR_ADD(stats[0]->mmap,stats[i]->mmap,GT_STATS_MMAP_RANGE);
     // Uniq Distribution
     GT_STATS_VECTOR_ADD(stats[0]->uniq,stats[i]->uniq,GT_STATS_UNIQ_RANGE);
+    // Duplicates
+    stats[0]->num_duplicates += stats[i]->num_duplicates;
+    stats[0]->num_optical_duplicates += stats[i]->num_optical_duplicates;
     // Merge Maps Error Profile
     gt_maps_profile_merge(stats[0]->maps_profile,stats[i]->maps_profile);
     // Merge SplitMaps Profile
@@ -495,10 +537,145 @@ GT_INLINE void gt_stats_merge(gt_stats** const stats,const uint64_t stats_array_
 /*
  * Calculate stats
  */
+/*
+ * Reference base at @offset from the beginning of the map block (in the strand of the map)
+ *   @ref_position is the 0-based forward position of the block and @ref_length its length over the reference
+ */
+GT_INLINE char gt_stats_get_reference_base(
+    gt_segmented_sequence* const reference,const gt_strand strand,
+    const uint64_t ref_position,const uint64_t ref_length,const int64_t offset) {
+  register const int64_t position = (strand==FORWARD) ?
+      (int64_t)ref_position+offset : (int64_t)(ref_position+ref_length)-1-offset;
+  if (position<0 || position>=(int64_t)reference->sequence_total_length) return GT_DNA_CHAR_N;
+  register const char base = gt_segmented_sequence_get_char_at(reference,position);
+  return (strand==FORWARD) ? base : gt_get_complement(base);
+}
+GT_INLINE uint64_t gt_stats_get_homopolymer_length(
+    gt_segmented_sequence* const reference,const gt_strand strand,
+    const uint64_t ref_position,const uint64_t ref_length,
+    const char base,const int64_t left_offset,const int64_t right_offset) {
+  register uint64_t run_length = 0;
+  register int64_t offset;
+  if (gt_cdna_encode[(uint8_t)base]==GT_STATS_MISMS_BASE_N) return 0;
+  for (offset=left_offset;run_length<GT_STATS_INDEL_HOMOPOLYMER_RANGE-1;--offset,++run_length) {
+    if (gt_stats_get_reference_base(reference,strand,ref_position,ref_length,offset)!=base) break;
+  }
+  for (offset=right_offset;run_length<GT_STATS_INDEL_HOMOPOLYMER_RANGE-1;++offset,++run_length) {
+    if (gt_stats_get_reference_base(reference,strand,ref_position,ref_length,offset)!=base) break;
+  }
+  return run_length;
+}
 GT_INLINE void gt_stats_make_indel_profile(
-    gt_maps_profile *maps_error_profile,
-    gt_template* const template,const uint64_t alignment_total_length) {
-
+    gt_maps_profile *maps_error_profile,gt_template* const template,
+    gt_sequence_archive* const seq_archive,gt_map** const mmap) {
+  register const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  char indel_bases[4];
+  // Iterate all MMAPS
+  GT_MULTIMAP_ITERATE_BLOCKS(mmap,num_blocks,map,end_pos) {
+    register gt_alignment* const alignment = gt_template_get_block(template,end_pos);
+    register char* const read = gt_string_get_string(alignment->read);
+    register const uint64_t read_length = gt_alignment_get_read_length(alignment);
+    register uint64_t read_offset = 0;
+    GT_MAP_ITERATE(map,map_block) {
+      register const uint64_t base_length = gt_map_get_base_length(map_block);
+      if (gt_map_get_num_misms(map_block)==0) { read_offset+=base_length; continue; }
+      // Locate the reference
+      register gt_segmented_sequence* const reference =
+          gt_sequence_archive_get_sequence(seq_archive,gt_map_get_seq_name(map_block));
+      if (reference==NULL) { read_offset+=base_length; continue; }
+      register const gt_strand strand = gt_map_get_strand(map_block);
+      register const uint64_t ref_position = gt_map_get_position_(map_block)-1;
+      register const uint64_t ref_length = gt_map_get_length(map_block);
+      // Traverse the indels (keeping track of the offset over the reference)
+      register int64_t ref_offset_shift = 0;
+      GT_MISMS_ITERATE(map_block,misms) {
+        if (misms->misms_type==MISMS) continue;
+        register const uint64_t size = misms->size;
+        register const int64_t ref_offset = (int64_t)misms->position+ref_offset_shift;
+        register int64_t left_offset, right_offset;
+        register uint64_t i, homopolymer_length;
+        if (misms->misms_type==INS) { // Bases of the reference skipped by the read
+          ref_offset_shift += size;
+          left_offset = ref_offset-1; right_offset = ref_offset+size;
+          for (i=0;i<size && i<4;++i) {
+            indel_bases[i] = gt_stats_get_reference_base(reference,strand,ref_position,ref_length,ref_offset+i);
+          }
+        } else { // Bases of the read not present in the reference
+          ref_offset_shift -= size;
+          if (misms->position==0 || misms->position+size==base_length) continue; // Trim
+          left_offset = ref_offset-1; right_offset = ref_offset;
+          for (i=0;i<size && i<4;++i) {
+            register const uint64_t read_pos = read_offset+misms->position+i;
+            indel_bases[i] = (read_pos<read_length) ? read[read_pos] : GT_DNA_CHAR_N;
+          }
+        }
+        // Length & position in read
+        register const uint64_t length_bucket = GT_MIN(size,GT_STATS_INDEL_LENGTH_RANGE-1);
+        register const uint64_t position = read_offset+misms->position;
+        if (position < GT_STATS_LARGE_READ_POS_RANGE) maps_error_profile->indel_position[position]++;
+        // Homopolymer context (only indels of a single base-type can extend a homopolymer)
+        homopolymer_length = 0;
+        if (size<=4) {
+          for (i=1;i<size && indel_bases[i]==indel_bases[0];++i);
+          if (i==size) {
+            homopolymer_length = gt_stats_get_homopolymer_length(reference,strand,
+                ref_position,ref_length,indel_bases[0],left_offset,right_offset);
+          }
+        }
+        if (misms->misms_type==INS) {
+          ++maps_error_profile->total_insertions;
+          maps_error_profile->insertion_event_length[length_bucket]++;
+          maps_error_profile->insertion_homopolymer[homopolymer_length]++;
+        } else {
+          ++maps_error_profile->total_deletions;
+          maps_error_profile->deletion_event_length[length_bucket]++;
+          maps_error_profile->deletion_homopolymer[homopolymer_length]++;
+        }
+        // Indel bases
+        register uint64_t idx = 0;
+        switch (size) {
+          case 4: idx = gt_cdna_encode[(uint8_t)indel_bases[3]];
+          // no break
+          case 3: idx = idx*GT_STATS_MISMS_BASE_RANGE+gt_cdna_encode[(uint8_t)indel_bases[2]];
+          // no break
+          case 2: idx = idx*GT_STATS_MISMS_BASE_RANGE+gt_cdna_encode[(uint8_t)indel_bases[1]];
+          // no break
+          case 1: idx = idx*GT_STATS_MISMS_BASE_RANGE+gt_cdna_encode[(uint8_t)indel_bases[0]]; break;
+          default: break;
+        }
+        switch (size) {
+          case 1: {
+            maps_error_profile->indel_transition_1[idx]++;
+            // 1-context
+            register uint64_t ctx_idx;
+            ctx_idx  = gt_cdna_encode[(uint8_t)gt_stats_get_reference_base(reference,strand,ref_position,ref_length,left_offset)];
+            ctx_idx *= GT_STATS_MISMS_BASE_RANGE;
+            ctx_idx += idx;
+            ctx_idx *= GT_STATS_MISMS_BASE_RANGE;
+            ctx_idx += gt_cdna_encode[(uint8_t)gt_stats_get_reference_base(reference,strand,ref_position,ref_length,right_offset)];
+            maps_error_profile->indel_1context[ctx_idx]++;
+            // 2-context
+            ctx_idx  = gt_cdna_encode[(uint8_t)gt_stats_get_reference_base(reference,strand,ref_position,ref_length,left_offset-1)];
+            ctx_idx *= GT_STATS_MISMS_BASE_RANGE;
+            ctx_idx += gt_cdna_encode[(uint8_t)gt_stats_get_reference_base(reference,strand,ref_position,ref_length,left_offset)];
+            ctx_idx *= GT_STATS_MISMS_BASE_RANGE;
+            ctx_idx += idx;
+            ctx_idx *= GT_STATS_MISMS_BASE_RANGE;
+            ctx_idx += gt_cdna_encode[(uint8_t)gt_stats_get_reference_base(reference,strand,ref_position,ref_length,right_offset)];
+            ctx_idx *= GT_STATS_MISMS_BASE_RANGE;
+            ctx_idx += gt_cdna_encode[(uint8_t)gt_stats_get_reference_base(reference,strand,ref_position,ref_length,right_offset+1)];
+            maps_error_profile->indel_2context[ctx_idx]++;
+            break;
+          }
+          case 2: maps_error_profile->indel_transition_2[idx]++; break;
+          case 3: maps_error_profile->indel_transition_3[idx]++; break;
+          case 4: maps_error_profile->indel_transition_4[idx]++; break;
+          default: break;
+        }
+      }
+      read_offset += base_length;
+    }
+  }
 }
 GT_INLINE void gt_stats_make_maps_error_profile(
     gt_maps_profile *maps_error_profile,gt_template* const template,
@@ -605,8 +782,8 @@ GT_INLINE void gt_stats_make_maps_error_profile(
 }
 
 GT_INLINE void gt_stats_make_mmaps_profile(
-    gt_stats* const stats,gt_template* const template,
-    const uint64_t alignment_total_length,gt_stats_analysis* const stats_analysis) {
+    gt_stats* const stats,gt_template* const template,const uint64_t alignment_total_length,
+    gt_sequence_archive* const seq_archive,gt_stats_analysis* const stats_analysis) {
   // Check not null maps
   if (gt_template_get_num_mmaps(template)==0) return;
   register const uint64_t num_blocks_template = gt_template_get_num_blocks(template);
@@ -616,6 +793,8 @@ GT_INLINE void gt_stats_make_mmaps_profile(
   register gt_splitmaps_profile* const splitmaps_profile = stats->splitmaps_profile;
   register bool has_splitsmaps = false;
   register bool only_splitsmaps = true;
+  // Insert Size Model (first mmap only)
+  if (paired_map) gt_inss_model_add_template(maps_error_profile->inss_model,template);
   GT_TEMPLATE_ITERATE(template,mmap) {
     /*
      * Insert Size Distribution
@@ -643,6 +822,12 @@ GT_INLINE void gt_stats_make_mmaps_profile(
     if (stats_analysis->maps_profile) { // TODO: bypass this to the upper level
       gt_stats_make_maps_error_profile(maps_error_profile,template,alignment_total_length,mmap);
     }
+    /*
+     * Indel Profile
+     */
+    if (stats_analysis->indel_profile && seq_archive!=NULL) {
+      gt_stats_make_indel_profile(maps_error_profile,template,seq_archive,mmap);
+    }
     /*
      * SplitMap Stats
      */
@@ -740,15 +925,18 @@ GT_INLINE void gt_stats_calculate_template_stats(
     stats->num_maps += num_maps;
     stats->total_bases_aligned += alignment_total_length;
     gt_stats_get_mmap_distribution(stats->mmap,num_maps); // MMap Distribution
+    // Duplicates
+    switch (gt_template_get_duplicate_status(template)) {
+      case GT_DUPLICATE_OPTICAL: ++stats->num_optical_duplicates; // no break
+      case GT_DUPLICATE_PCR: ++stats->num_duplicates; break;
+      default: break;
+    }
   }
   /*
    * MMaps Profile {Insert Size Distribution, Error Profile, SM Profile, ...}
    */
   if (num_maps > 0) {
-    gt_stats_make_mmaps_profile(stats,template,alignment_total_length,stats_analysis);
-    if (stats_analysis->indel_profile) {
-      gt_stats_make_indel_profile(stats->maps_profile,template,alignment_total_length);
-    }
+    gt_stats_make_mmaps_profile(stats,template,alignment_total_length,seq_archive,stats_analysis);
   }
 }
 
@@ -965,6 +1153,47 @@ GT_INLINE void gt_stats_print_misms_transition_table_1context(FILE* stream,uint6
     }
   }
 }
+GT_INLINE void gt_stats_print_indel_length_distribution(FILE* stream,uint64_t* const indel_length,uint64_t const total_indels) {
+#define GT_STATS_PRINT_INDEL_FORMAT "%8" PRIu64 " \t %1.3f%%\n"
+  register uint64_t i, accum;
+  if(!total_indels) return;
+  for (i=1;i<=10;++i) {
+    fprintf(stream,"  -->        [%2" PRIu64 "] \t=> "GT_STATS_PRINT_INDEL_FORMAT,i,indel_length[i],GT_STATS_GET_PERCENTAGE(indel_length[i],total_indels));
+  }
+  accum = gt_stats_sum_misms_pos(indel_length,11,21);
+  fprintf(stream,"  -->     (10,20] \t=> "GT_STATS_PRINT_INDEL_FORMAT,accum,GT_STATS_GET_PERCENTAGE(accum,total_indels));
+  accum = gt_stats_sum_misms_pos(indel_length,21,GT_STATS_INDEL_LENGTH_RANGE-1);
+  fprintf(stream,"  -->     (20,50) \t=> "GT_STATS_PRINT_INDEL_FORMAT,accum,GT_STATS_GET_PERCENTAGE(accum,total_indels));
+  accum = indel_length[GT_STATS_INDEL_LENGTH_RANGE-1];
+  fprintf(stream,"  -->    [50,inf) \t=> "GT_STATS_PRINT_INDEL_FORMAT,accum,GT_STATS_GET_PERCENTAGE(accum,total_indels));
+}
+GT_INLINE void gt_stats_print_indel_homopolymer_distribution(FILE* stream,uint64_t* const indel_homopolymer,uint64_t const total_indels) {
+  register uint64_t i;
+  if(!total_indels) return;
+  for (i=0;i<GT_STATS_INDEL_HOMOPOLYMER_RANGE-1;++i) {
+    fprintf(stream,"  -->        [%2" PRIu64 "] \t=> "GT_STATS_PRINT_INDEL_FORMAT,i,
+        indel_homopolymer[i],GT_STATS_GET_PERCENTAGE(indel_homopolymer[i],total_indels));
+  }
+  fprintf(stream,"  -->    [%2" PRIu64 ",inf) \t=> "GT_STATS_PRINT_INDEL_FORMAT,i,
+      indel_homopolymer[i],GT_STATS_GET_PERCENTAGE(indel_homopolymer[i],total_indels));
+}
+GT_INLINE void gt_stats_print_indel_transition_table_1context(FILE* stream,uint64_t* const indel_1context,uint64_t const total_indels) {
+  if(!total_indels) return;
+  // Print Header (rows are the flanking reference bases, columns the indel base)
+  fprintf(stream,"      [  A  ][  C  ][  G  ][  T  ][  N  ]\n");
+  char bases[] = {'A','C','G','T','N'};
+  register uint64_t a,b,i;
+  for (a=0;a<4;++a) {
+    for (b=0;b<4;++b) {
+      fprintf(stream,"[%c_%c] ",bases[a],bases[b]);
+      for (i=0;i<GT_STATS_MISMS_BASE_RANGE;++i) {
+        register const uint64_t idx = (a*GT_STATS_MISMS_BASE_RANGE+i)*GT_STATS_MISMS_BASE_RANGE+b;
+        fprintf(stream,"[%5.2f]",100.0*(double)indel_1context[idx]/(double)total_indels);
+      }
+      fprintf(stream,"\n");
+    }
+  }
+}
 
 GT_INLINE void gt_stats_print_split_maps_stats(FILE* stream,gt_stats* const stats,const bool paired_end) {
   register gt_splitmaps_profile* const splitmap_stats = stats->splitmaps_profile;
@@ -1009,6 +1238,7 @@ GT_INLINE void gt_stats_print_maps_stats(FILE* stream, gt_stats* const stats,con
     fprintf(stream,"    --> F+F %" PRIu64 " (%2.3f%%) \n",maps_profile->pair_strand_ff,GT_STATS_GET_PERCENTAGE(maps_profile->pair_strand_ff,stats->num_maps));
     fprintf(stream,"    --> R+R %" PRIu64 " (%2.3f%%) \n",maps_profile->pair_strand_rr,GT_STATS_GET_PERCENTAGE(maps_profile->pair_strand_rr,stats->num_maps));
     gt_stats_print_inss_fg_distribution(stream,stats->maps_profile->inss_fine_grain,stats->num_maps);
+    gt_inss_model_print(stream,stats->maps_profile->inss_model);
   }
   fprintf(stream,"[ERROR.PROFILE]\n");
   fprintf(stream,"  --> Total.Mismatches %" PRIu64 " (%2.3f per map) \n",
@@ -1031,6 +1261,47 @@ GT_INLINE void gt_stats_print_maps_stats(FILE* stream, gt_stats* const stats,con
   }
   gt_stats_print_read_event_positions(stream,stats->maps_profile->error_position,stats->maps_profile->total_errors_events,stats->max_length);
 }
+GT_INLINE void gt_stats_print_indel_stats(FILE* stream,gt_stats* const stats) {
+  register const gt_maps_profile* const maps_profile = stats->maps_profile;
+  register const uint64_t total_indels = maps_profile->total_insertions+maps_profile->total_deletions;
+  fprintf(stream,"  --> Total.Indels %" PRIu64 " (%2.3f per map) \n",total_indels,GT_STATS_DIV_F(total_indels,stats->num_maps));
+  fprintf(stream,"    --> Insertions %" PRIu64 " (%2.3f%%) \n",
+      maps_profile->total_insertions,GT_STATS_GET_PERCENTAGE(maps_profile->total_insertions,total_indels));
+  fprintf(stream,"    --> Deletions %" PRIu64 " (%2.3f%%) \n",
+      maps_profile->total_deletions,GT_STATS_GET_PERCENTAGE(maps_profile->total_deletions,total_indels));
+  if (total_indels==0) return;
+  fprintf(stream,"Ins.Event.Length\n");
+  gt_stats_print_indel_length_distribution(stream,maps_profile->insertion_event_length,maps_profile->total_insertions);
+  fprintf(stream,"Del.Event.Length\n");
+  gt_stats_print_indel_length_distribution(stream,maps_profile->deletion_event_length,maps_profile->total_deletions);
+  fprintf(stream,"Ins.Homopolymer.Context\n");
+  gt_stats_print_indel_homopolymer_distribution(stream,maps_profile->insertion_homopolymer,maps_profile->total_insertions);
+  fprintf(stream,"Del.Homopolymer.Context\n");
+  gt_stats_print_indel_homopolymer_distribution(stream,maps_profile->deletion_homopolymer,maps_profile->total_deletions);
+  gt_stats_print_read_event_positions(stream,maps_profile->indel_position,total_indels,stats->max_length);
+  register const uint64_t total_single_base = gt_stats_sum_misms_pos(maps_profile->indel_transition_1,0,GT_STATS_INDEL_TRANSITION_1_RANGE);
+  if (total_single_base > 0) {
+    fprintf(stream,"Indel.1-Nucleotide.Context\n");
+    gt_stats_print_indel_transition_table_1context(stream,maps_profile->indel_1context,total_single_base);
+  }
+}
+GT_INLINE void gt_stats_print_duplicates_stats(FILE* stream,gt_stats* const stats,gt_duplicates* const duplicates) {
+  fprintf(stream,"  --> Duplicates %" PRIu64 " (%2.3f%%)\n",stats->num_duplicates,
+      GT_STATS_GET_PERCENTAGE(stats->num_duplicates,stats->num_mapped));
+  fprintf(stream,"    --> Duplicates.PCR %" PRIu64 " (%2.3f%%)\n",stats->num_duplicates-stats->num_optical_duplicates,
+      GT_STATS_GET_PERCENTAGE(stats->num_duplicates-stats->num_optical_duplicates,stats->num_mapped));
+  fprintf(stream,"    --> Duplicates.Optical %" PRIu64 " (%2.3f%%)\n",stats->num_optical_duplicates,
+      GT_STATS_GET_PERCENTAGE(stats->num_optical_duplicates,stats->num_mapped));
+  if (duplicates!=NULL) {
+    register const uint64_t num_untracked = gt_duplicates_get_num_untracked(duplicates);
+    fprintf(stream,"  --> Duplicates.Untracked %" PRIu64 "%s\n",num_untracked,
+        (num_untracked>0) ? " (signatures table full, duplicates of these are not detected)" : "");
+    fprintf(stream,"  --> Duplicates.Memory %" PRIu64 " MB\n",gt_duplicates_get_memory(duplicates)>>20);
+    fprintf(stream,"  --> Library.Distinct %" PRIu64 "%s\n",gt_duplicates_get_num_distinct(duplicates),
+        (num_untracked>0) ? " (estimated)" : "");
+    fprintf(stream,"  --> Library.Size.Estimate %" PRIu64 "\n",gt_duplicates_estimate_library_size(duplicates));
+  }
+}
 GT_INLINE void gt_stats_print_general_stats(FILE* stream,gt_stats* const stats,const uint64_t num_reads,const bool paired_end) {
   register const uint64_t num_templates = paired_end ? num_reads>>1 : num_reads; // SE => 1 template. PE => 1 template
   // For the case of zero input lines
@@ -612,3 +612,26 @@ GT_INLINE void gt_template_trim(gt_template* const template, uint64_t const left
   }
 }
 
+GT_INLINE void gt_template_auto_trim(
+    gt_template* const template,gt_dna_read_trim_attributes* const trim_attributes,
+    uint64_t const min_length,bool const set_extra) {
+  GT_TEMPLATE_CHECK(template);
+  GT_NULL_CHECK(trim_attributes);
+  GT_TEMPLATE_ALIGNMENT_ITERATE(template,alignment) {
+    gt_alignment_auto_trim(alignment,trim_attributes,min_length,set_extra);
+  }
+  if (set_extra) {
+    // transfer extra attribute (only if the first end got trimmed)
+    gt_alignment* const first = gt_template_get_block(template,0);
+    if (!gt_shash_is_contained(first->attributes,GT_TAG_EXTRA)) return;
+    gt_string* const alignment_extra = gt_shash_get(first->attributes,GT_TAG_EXTRA,gt_string);
+    if (gt_shash_is_contained(template->attributes,GT_TAG_EXTRA)) {
+      gt_string* const old = gt_shash_get(template->attributes,GT_TAG_EXTRA,gt_string);
+      gt_string_copy(old,alignment_extra);
+    } else {
+      gt_string* const extra = gt_string_new(gt_string_get_length(alignment_extra)+1);
+      gt_string_copy(extra,alignment_extra);
+      gt_shash_insert(template->attributes,GT_TAG_EXTRA,extra,gt_string);
+    }
+  }
+}
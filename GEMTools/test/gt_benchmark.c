@@ -0,0 +1,838 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_benchmark.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Deterministic synthetic data generator {MAP,SAM,FASTQ} & micro-benchmarks
+ *   --generate :: Outputs a synthetic dataset (same seed => same records, whatever the format)
+ *   (default) :: Runs the micro-benchmarks over an in-memory synthetic dataset (and over the
+ *     files given with --parse) and reports one tab-separated line per benchmark
+ */
+
+#include <getopt.h>
+
+#include "gem_tools.h"
+
+typedef enum { GT_BENCH_MAP, GT_BENCH_SAM, GT_BENCH_FASTQ } gt_bench_format;
+
+typedef struct {
+  /* [Mode] */
+  bool generate;
+  gt_bench_format format;
+  char* name_output_file;
+  char* name_reference_file;
+  /* [Dataset] */
+  uint64_t seed;
+  uint64_t num_reads;
+  uint64_t read_length;
+  bool paired_end;
+  uint64_t insert_size;
+  uint64_t insert_size_range;
+  uint64_t num_contigs;
+  uint64_t contig_length;
+  double unmapped_rate;
+  double mismatch_rate;
+  double indel_rate;
+  double split_rate;
+  double multimap_rate;
+  uint64_t max_maps;
+  /* [Benchmark] */
+  gt_vector* parse_files; // (char*)
+  uint64_t repetitions;
+  char* label;
+} gt_benchmark_args;
+
+gt_benchmark_args parameters = {
+    /* [Mode] */
+    .generate=false,
+    .format=GT_BENCH_MAP,
+    .name_output_file=NULL,
+    .name_reference_file=NULL,
+    /* [Dataset] */
+    .seed=1,
+    .num_reads=100000,
+    .read_length=100,
+    .paired_end=false,
+    .insert_size=300,
+    .insert_size_range=100,
+    .num_contigs=4,
+    .contig_length=1000000,
+    .unmapped_rate=0.05,
+    .mismatch_rate=0.01,
+    .indel_rate=0.002,
+    .split_rate=0.05,
+    .multimap_rate=0.2,
+    .max_maps=5,
+    /* [Benchmark] */
+    .parse_files=NULL,
+    .repetitions=3,
+    .label="synthetic",
+};
+
+#define GT_BENCH_MAX_INTRON 5000
+#define GT_BENCH_MAX_INDEL 3
+
+/*
+ * Deterministic RNG (xorshift64*). Each record is seeded from (seed,record_num)
+ */
+GT_INLINE uint64_t gt_bench_rand(uint64_t* const state) {
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 2685821657736338717ull;
+}
+GT_INLINE double gt_bench_uniform(uint64_t* const state) {
+  return (double)(gt_bench_rand(state)>>11) * (1.0/9007199254740992.0);
+}
+GT_INLINE uint64_t gt_bench_seed(const uint64_t seed,const uint64_t stream) {
+  register uint64_t z = seed*0x9E3779B97F4A7C15ull + stream + 1; // splitmix64
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  z = z ^ (z >> 31);
+  return z ? z : 1;
+}
+GT_INLINE uint64_t gt_bench_time_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Synthetic reference
+ */
+const char gt_bench_dna[4] = { 'A', 'C', 'G', 'T' };
+char** gt_bench_reference_new() {
+  char** const reference = malloc(parameters.num_contigs*sizeof(char*));
+  gt_cond_fatal_error(!reference,MEM_HANDLER);
+  register uint64_t i, j;
+  for (i=0;i<parameters.num_contigs;++i) {
+    reference[i] = malloc(parameters.contig_length);
+    gt_cond_fatal_error(!reference[i],MEM_ALLOC);
+    uint64_t state = gt_bench_seed(parameters.seed,UINT32_MAX+i);
+    for (j=0;j<parameters.contig_length;++j) reference[i][j] = gt_bench_dna[gt_bench_rand(&state)>>62];
+  }
+  return reference;
+}
+void gt_bench_reference_delete(char** const reference) {
+  register uint64_t i;
+  for (i=0;i<parameters.num_contigs;++i) free(reference[i]);
+  free(reference);
+}
+void gt_bench_reference_fprint(FILE* stream,char** const reference) {
+  register uint64_t i, j;
+  for (i=0;i<parameters.num_contigs;++i) {
+    fprintf(stream,">chr%"PRIu64"\n",i+1);
+    for (j=0;j<parameters.contig_length;j+=60) {
+      fprintf(stream,"%.*s\n",(int)GT_MIN(60,parameters.contig_length-j),reference[i]+j);
+    }
+  }
+}
+gt_sequence_archive* gt_bench_reference_archive_new(char** const reference) {
+  gt_sequence_archive* const sequence_archive = gt_sequence_archive_new();
+  char seq_name[32];
+  register uint64_t i;
+  for (i=0;i<parameters.num_contigs;++i) {
+    gt_segmented_sequence* const sequence = gt_segmented_sequence_new();
+    register const int length = sprintf(seq_name,"chr%"PRIu64,i+1);
+    gt_segmented_sequence_set_name(sequence,seq_name,length);
+    gt_segmented_sequence_append_string(sequence,reference[i],parameters.contig_length);
+    gt_sequence_archive_add_sequence(sequence_archive,sequence);
+  }
+  return sequence_archive;
+}
+
+/*
+ * Synthetic records
+ *   Each end is sampled from the reference and mutated (mismatches, indels & split). Alignments
+ *   are kept along the forward strand (as operations) and rendered for each output format
+ */
+typedef enum { GT_BENCH_OP_MATCH, GT_BENCH_OP_MISMS, GT_BENCH_OP_INS, GT_BENCH_OP_DEL, GT_BENCH_OP_SPLIT } gt_bench_op_t;
+typedef struct {
+  gt_bench_op_t type;
+  uint64_t value; // Length/Size or mismatch base
+} gt_bench_op;
+typedef struct {
+  gt_strand strand;
+  gt_string* read;      // Along the strand of the end
+  gt_string* qualities; // Along the strand of the end
+  gt_string* forward_read;
+  gt_vector* ops;       // (gt_bench_op) Along the forward strand
+  uint64_t reference_span;
+  uint64_t num_events;
+} gt_bench_end;
+typedef struct {
+  uint64_t contig;
+  uint64_t position[2]; // 1-based leftmost position of each end
+} gt_bench_location;
+typedef struct {
+  gt_string* tag;
+  uint64_t num_ends;
+  gt_bench_end ends[2];
+  bool unmapped;
+  gt_vector* locations; // (gt_bench_location) One per mmap (the first one is the true location)
+} gt_bench_record;
+
+GT_INLINE gt_bench_record* gt_bench_record_new() {
+  gt_bench_record* const record = malloc(sizeof(gt_bench_record));
+  gt_cond_fatal_error(!record,MEM_HANDLER);
+  record->tag = gt_string_new(64);
+  register uint64_t i;
+  for (i=0;i<2;++i) {
+    record->ends[i].read = gt_string_new(parameters.read_length+1);
+    record->ends[i].qualities = gt_string_new(parameters.read_length+1);
+    record->ends[i].forward_read = gt_string_new(parameters.read_length+1);
+    record->ends[i].ops = gt_vector_new(16,sizeof(gt_bench_op));
+  }
+  record->locations = gt_vector_new(parameters.max_maps,sizeof(gt_bench_location));
+  return record;
+}
+GT_INLINE void gt_bench_record_delete(gt_bench_record* const record) {
+  gt_string_delete(record->tag);
+  register uint64_t i;
+  for (i=0;i<2;++i) {
+    gt_string_delete(record->ends[i].read);
+    gt_string_delete(record->ends[i].qualities);
+    gt_string_delete(record->ends[i].forward_read);
+    gt_vector_delete(record->ends[i].ops);
+  }
+  gt_vector_delete(record->locations);
+  free(record);
+}
+
+GT_INLINE char gt_bench_complement(const char base) {
+  switch (base) {
+    case 'A': return 'T';
+    case 'C': return 'G';
+    case 'G': return 'C';
+    case 'T': return 'A';
+    default: return 'N';
+  }
+}
+GT_INLINE void gt_bench_add_op(gt_vector* const ops,const gt_bench_op_t type,const uint64_t value) {
+  if (type==GT_BENCH_OP_MATCH && gt_vector_get_used(ops)>0) {
+    register gt_bench_op* const last_op = gt_vector_get_last_elm(ops,gt_bench_op);
+    if (last_op->type==GT_BENCH_OP_MATCH) { last_op->value += value; return; }
+  }
+  gt_vector_reserve_additional(ops,1);
+  register gt_bench_op* const op = gt_vector_get_free_elm(ops,gt_bench_op);
+  op->type = type;
+  op->value = value;
+  gt_vector_inc_used(ops);
+}
+void gt_bench_generate_end(char* const contig,const uint64_t position,uint64_t* const state,gt_bench_end* const end) {
+  register const uint64_t length = parameters.read_length;
+  register int64_t split_point = (gt_bench_uniform(state)<parameters.split_rate) ?
+      (int64_t)(length/4 + gt_bench_rand(state)%(length/2)) : -1;
+  register uint64_t ref_pos = position-1, read_pos = 0;
+  gt_vector_clear(end->ops);
+  gt_string_clear(end->forward_read);
+  end->num_events = 0;
+  while (read_pos < length) {
+    register const bool last_op_match = gt_vector_get_used(end->ops)>0 &&
+        gt_vector_get_last_elm(end->ops,gt_bench_op)->type==GT_BENCH_OP_MATCH;
+    if ((int64_t)read_pos>=split_point && split_point>=0 && last_op_match) {
+      register const uint64_t intron = 100 + gt_bench_rand(state)%(GT_BENCH_MAX_INTRON-100);
+      gt_bench_add_op(end->ops,GT_BENCH_OP_SPLIT,intron);
+      ref_pos += intron;
+      split_point = -1;
+      ++end->num_events; // Junctions account as an event (global distance)
+      continue;
+    }
+    register const double r = gt_bench_uniform(state);
+    if (r < parameters.mismatch_rate) {
+      register const char base = gt_bench_dna[(gt_bench_rand(state)>>62)];
+      register const char mismatch = (base!=contig[ref_pos]) ? base : gt_bench_complement(base);
+      gt_string_append_char(end->forward_read,mismatch);
+      gt_bench_add_op(end->ops,GT_BENCH_OP_MISMS,mismatch);
+      ++ref_pos; ++read_pos; ++end->num_events;
+    } else if (r < parameters.mismatch_rate+parameters.indel_rate &&
+               last_op_match && read_pos+GT_BENCH_MAX_INDEL+4<length) {
+      register const uint64_t size = 1 + gt_bench_rand(state)%GT_BENCH_MAX_INDEL;
+      if (gt_bench_rand(state)&1) { // Bases skipped in the reference
+        gt_bench_add_op(end->ops,GT_BENCH_OP_INS,size);
+        ref_pos += size;
+      } else { // Bases not in the reference
+        register uint64_t i;
+        for (i=0;i<size;++i) gt_string_append_char(end->forward_read,gt_bench_dna[gt_bench_rand(state)>>62]);
+        gt_bench_add_op(end->ops,GT_BENCH_OP_DEL,size);
+        read_pos += size;
+      }
+      ++end->num_events;
+    } else {
+      gt_string_append_char(end->forward_read,contig[ref_pos]);
+      gt_bench_add_op(end->ops,GT_BENCH_OP_MATCH,1);
+      ++ref_pos; ++read_pos;
+    }
+  }
+  end->reference_span = ref_pos-(position-1);
+  // Read & Qualities (along the strand)
+  register const bool reverse = (end->strand==REVERSE);
+  register char* const forward_read = gt_string_get_string(end->forward_read);
+  register uint64_t i;
+  gt_string_clear(end->read);
+  gt_string_clear(end->qualities);
+  for (i=0;i<length;++i) {
+    gt_string_append_char(end->read,reverse ? gt_bench_complement(forward_read[length-1-i]) : forward_read[i]);
+    gt_string_append_char(end->qualities,(char)('5'+gt_bench_rand(state)%21));
+  }
+}
+GT_INLINE void gt_bench_sample_location(uint64_t* const state,gt_bench_location* const location) {
+  register const uint64_t span = parameters.insert_size+parameters.insert_size_range+
+      2*parameters.read_length+2*GT_BENCH_MAX_INTRON;
+  location->contig = gt_bench_rand(state)%parameters.num_contigs;
+  location->position[0] = 1 + gt_bench_rand(state)%(parameters.contig_length-span);
+  location->position[1] = location->position[0] + parameters.insert_size - parameters.read_length +
+      gt_bench_rand(state)%(parameters.insert_size_range+1) - parameters.insert_size_range/2;
+}
+void gt_bench_generate_record(char** const reference,const uint64_t record_num,gt_bench_record* const record) {
+  uint64_t state = gt_bench_seed(parameters.seed,record_num);
+  register uint64_t i;
+  // Tag (Casava 1.8 like, so optical duplicates & location parsing get exercised)
+  gt_string_clear(record->tag);
+  gt_sprintf_append(record->tag,"BENCH:1:FC:%"PRIu64":%"PRIu64":%"PRIu64":%"PRIu64,
+      1+gt_bench_rand(&state)%8,1101+gt_bench_rand(&state)%20,
+      1000+gt_bench_rand(&state)%19000,1000+gt_bench_rand(&state)%19000);
+  // Sample the true location & the ends (PE :: FR pairs)
+  record->num_ends = parameters.paired_end ? 2 : 1;
+  record->unmapped = gt_bench_uniform(&state)<parameters.unmapped_rate;
+  gt_vector_clear(record->locations);
+  gt_vector_reserve(record->locations,parameters.max_maps,false);
+  register gt_bench_location* const location = gt_vector_get_mem(record->locations,gt_bench_location);
+  gt_bench_sample_location(&state,location);
+  gt_vector_set_used(record->locations,1);
+  record->ends[0].strand = (record->num_ends==2 || (gt_bench_rand(&state)&1)) ? FORWARD : REVERSE;
+  record->ends[1].strand = REVERSE;
+  for (i=0;i<record->num_ends;++i) {
+    gt_bench_generate_end(reference[location->contig],location->position[i],&state,record->ends+i);
+  }
+  // Multimaps (same alignment at other locations)
+  if (!record->unmapped && gt_bench_uniform(&state)<parameters.multimap_rate) {
+    register const uint64_t num_maps = 2+gt_bench_rand(&state)%GT_MAX(parameters.max_maps-1,1);
+    for (i=1;i<num_maps;++i) gt_bench_sample_location(&state,location+i);
+    gt_vector_set_used(record->locations,num_maps);
+  }
+}
+
+/*
+ * Record printers
+ */
+GT_INLINE void gt_bench_sprint_mismatch_string(gt_string* const string,gt_bench_end* const end) {
+  register const bool reverse = (end->strand==REVERSE);
+  register const uint64_t num_ops = gt_vector_get_used(end->ops);
+  register uint64_t i;
+  for (i=0;i<num_ops;++i) {
+    register const uint64_t op_pos = reverse ? num_ops-1-i : i;
+    register gt_bench_op* const op = gt_vector_get_elm(end->ops,op_pos,gt_bench_op);
+    switch (op->type) {
+      case GT_BENCH_OP_MATCH: gt_sprintf_append(string,"%"PRIu64,op->value); break;
+      case GT_BENCH_OP_MISMS:
+        gt_string_append_char(string,reverse ? gt_bench_complement(op->value) : (char)op->value);
+        break;
+      case GT_BENCH_OP_INS: gt_sprintf_append(string,">%"PRIu64"+",op->value); break;
+      case GT_BENCH_OP_DEL: gt_sprintf_append(string,">%"PRIu64"-",op->value); break;
+      case GT_BENCH_OP_SPLIT: gt_sprintf_append(string,">%"PRIu64"*",op->value); break;
+    }
+  }
+}
+GT_INLINE void gt_bench_sprint_cigar(gt_string* const string,gt_bench_end* const end) {
+  register uint64_t match_length = 0;
+  GT_VECTOR_ITERATE(end->ops,op,op_num,gt_bench_op) {
+    if (op->type==GT_BENCH_OP_MATCH || op->type==GT_BENCH_OP_MISMS) {
+      match_length += (op->type==GT_BENCH_OP_MATCH) ? op->value : 1;
+      continue;
+    }
+    if (match_length>0) gt_sprintf_append(string,"%"PRIu64"M",match_length);
+    match_length = 0;
+    switch (op->type) {
+      case GT_BENCH_OP_INS: gt_sprintf_append(string,"%"PRIu64"D",op->value); break;
+      case GT_BENCH_OP_DEL: gt_sprintf_append(string,"%"PRIu64"I",op->value); break;
+      case GT_BENCH_OP_SPLIT: gt_sprintf_append(string,"%"PRIu64"N",op->value); break;
+      default: break;
+    }
+  }
+  if (match_length>0) gt_sprintf_append(string,"%"PRIu64"M",match_length);
+}
+void gt_bench_sprint_map(gt_string* const line,gt_bench_record* const record) {
+  register uint64_t i, j;
+  gt_string_clear(line);
+  gt_string_append_gt_string(line,record->tag);
+  // Read & Qualities (ends separated by spaces)
+  for (j=0;j<2;++j) {
+    gt_string_append_char(line,TAB);
+    for (i=0;i<record->num_ends;++i) {
+      if (i>0) gt_string_append_char(line,SPACE);
+      gt_string_append_gt_string(line,(j==0) ? record->ends[i].read : record->ends[i].qualities);
+    }
+  }
+  // Counters & Maps
+  gt_string_append_char(line,TAB);
+  if (record->unmapped) {
+    gt_string_append_string(line,"0\t-",3);
+  } else {
+    register uint64_t num_events = 0;
+    for (i=0;i<record->num_ends;++i) num_events += record->ends[i].num_events;
+    for (i=0;i<num_events;++i) gt_string_append_string(line,"0:",2);
+    gt_sprintf_append(line,"%"PRIu64"\t",gt_vector_get_used(record->locations));
+    GT_VECTOR_ITERATE(record->locations,location,location_num,gt_bench_location) {
+      if (location_num>0) gt_string_append_char(line,',');
+      for (i=0;i<record->num_ends;++i) {
+        if (i>0) gt_string_append_string(line,"::",2);
+        gt_sprintf_append(line,"chr%"PRIu64":%c:%"PRIu64":",location->contig+1,
+            (record->ends[i].strand==FORWARD)?'+':'-',location->position[i]);
+        gt_bench_sprint_mismatch_string(line,record->ends+i);
+      }
+    }
+  }
+  gt_string_append_eos(line);
+}
+void gt_bench_sprint_sam(gt_string* const line,gt_bench_record* const record) {
+  register const bool paired = (record->num_ends==2);
+  register uint64_t i, j;
+  gt_string_clear(line);
+  if (record->unmapped) {
+    for (i=0;i<record->num_ends;++i) {
+      register const uint64_t flag = paired ? (1|4|8|(i==0?64:128)) : 4;
+      gt_sprintf_append(line,PRIgts"\t%"PRIu64"\t*\t0\t0\t*\t*\t0\t0\t"PRIgts"\t"PRIgts"\n",
+          PRIgts_content(record->tag),flag,PRIgts_content(record->ends[i].forward_read),
+          PRIgts_content(record->ends[i].qualities));
+    }
+    return;
+  }
+  register const uint64_t mapq = (gt_vector_get_used(record->locations)==1) ? 60 : 0;
+  GT_VECTOR_ITERATE(record->locations,location,location_num,gt_bench_location) {
+    for (i=0;i<record->num_ends;++i) {
+      register gt_bench_end* const end = record->ends+i;
+      register gt_bench_end* const mate = record->ends+(1-i);
+      register uint64_t flag = (end->strand==REVERSE) ? 16 : 0;
+      if (paired) flag |= 1|2|(mate->strand==REVERSE?32:0)|(i==0?64:128);
+      if (location_num>0) flag |= 256;
+      gt_sprintf_append(line,PRIgts"\t%"PRIu64"\tchr%"PRIu64"\t%"PRIu64"\t%"PRIu64"\t",
+          PRIgts_content(record->tag),flag,location->contig+1,location->position[i],mapq);
+      gt_bench_sprint_cigar(line,end);
+      if (paired) {
+        register const int64_t inss = (int64_t)(location->position[1]+record->ends[1].reference_span)-(int64_t)location->position[0];
+        gt_sprintf_append(line,"\t=\t%"PRIu64"\t%"PRIi64"\t",location->position[1-i],(i==0)?inss:-inss);
+      } else {
+        gt_string_append_string(line,"\t*\t0\t0\t",7);
+      }
+      if (location_num>0) {
+        gt_string_append_string(line,"*\t*\n",4);
+      } else {
+        // SEQ (forward strand) & QUAL (reversed for reverse-strand ends)
+        gt_string_append_gt_string(line,end->forward_read);
+        gt_string_append_char(line,TAB);
+        register char* const qualities = gt_string_get_string(end->qualities);
+        register const uint64_t length = gt_string_get_length(end->qualities);
+        for (j=0;j<length;++j) {
+          gt_string_append_char(line,(end->strand==REVERSE) ? qualities[length-1-j] : qualities[j]);
+        }
+        gt_string_append_char(line,EOL);
+      }
+    }
+  }
+}
+void gt_bench_sprint_fastq(gt_string* const line,gt_bench_record* const record) {
+  register uint64_t i;
+  gt_string_clear(line);
+  for (i=0;i<record->num_ends;++i) {
+    gt_sprintf_append(line,"@"PRIgts"%s\n"PRIgts"\n+\n"PRIgts"\n",PRIgts_content(record->tag),
+        (record->num_ends==2) ? ((i==0) ? "/1" : "/2") : "",
+        PRIgts_content(record->ends[i].read),PRIgts_content(record->ends[i].qualities));
+  }
+}
+
+/*
+ * Generator
+ */
+void gt_bench_generate() {
+  char** const reference = gt_bench_reference_new();
+  // Reference
+  if (parameters.name_reference_file!=NULL) {
+    FILE* const reference_file = fopen(parameters.name_reference_file,"w");
+    gt_cond_fatal_error(reference_file==NULL,FILE_OPEN,parameters.name_reference_file);
+    gt_bench_reference_fprint(reference_file,reference);
+    fclose(reference_file);
+  }
+  // Records
+  FILE* const output = (parameters.name_output_file==NULL) ? stdout : fopen(parameters.name_output_file,"w");
+  gt_cond_fatal_error(output==NULL,FILE_OPEN,parameters.name_output_file);
+  register uint64_t i;
+  if (parameters.format==GT_BENCH_SAM) {
+    fprintf(output,"@HD\tVN:1.0\n");
+    for (i=0;i<parameters.num_contigs;++i) {
+      fprintf(output,"@SQ\tSN:chr%"PRIu64"\tLN:%"PRIu64"\n",i+1,parameters.contig_length);
+    }
+  }
+  gt_bench_record* const record = gt_bench_record_new();
+  gt_string* const line = gt_string_new(1024);
+  for (i=0;i<parameters.num_reads;++i) {
+    gt_bench_generate_record(reference,i,record);
+    switch (parameters.format) {
+      case GT_BENCH_MAP:
+        gt_bench_sprint_map(line,record);
+        gt_string_append_char(line,EOL);
+        break;
+      case GT_BENCH_SAM: gt_bench_sprint_sam(line,record); break;
+      case GT_BENCH_FASTQ: gt_bench_sprint_fastq(line,record); break;
+    }
+    fwrite(gt_string_get_string(line),1,gt_string_get_length(line),output);
+  }
+  // Free
+  gt_string_delete(line);
+  gt_bench_record_delete(record);
+  if (output!=stdout) fclose(output);
+  gt_bench_reference_delete(reference);
+}
+
+/*
+ * Micro-benchmarks
+ *   Output (TSV) :: benchmark label records bytes seconds records/s MB/s
+ */
+GT_INLINE void gt_bench_report(char* const benchmark,const uint64_t records,const uint64_t bytes,const uint64_t time_ns) {
+  register const double seconds = (double)time_ns/1e9;
+  fprintf(stdout,"%s\t%s\t%"PRIu64"\t%"PRIu64"\t%.6f\t%.1f\t%.3f\n",benchmark,parameters.label,records,bytes,seconds,
+      seconds>0.0 ? (double)records/seconds : 0.0,seconds>0.0 ? (double)bytes/1e6/seconds : 0.0);
+  fflush(stdout);
+}
+void gt_bench_parse_file(char* const file_name) {
+  gt_generic_parser_attr generic_parser_attr = GENERIC_PARSER_ATTR_DEFAULT(parameters.paired_end);
+  gt_template* const template = gt_template_new();
+  register uint64_t records = 0, bytes = 0, time_ns = 0, i;
+  for (i=0;i<parameters.repetitions;++i) {
+    register const uint64_t start = gt_bench_time_ns();
+    gt_input_file* const input_file = gt_input_file_open(file_name,false);
+    gt_buffered_input_file* const buffered_input = gt_buffered_input_file_new(input_file);
+    gt_status error_code;
+    while ((error_code=gt_input_generic_parser_get_template(buffered_input,template,&generic_parser_attr))) {
+      if (error_code!=GT_IGP_OK) gt_fatal_error_msg("Error parsing file '%s'",file_name);
+      ++records;
+    }
+    gt_buffered_input_file_close(buffered_input);
+    bytes += input_file->file_size;
+    gt_input_file_close(input_file);
+    time_ns += gt_bench_time_ns()-start;
+  }
+  register char* const base_name = strrchr(file_name,'/');
+  char benchmark[1024];
+  snprintf(benchmark,1024,"parse.file.%s",(base_name!=NULL) ? base_name+1 : file_name);
+  gt_bench_report(benchmark,records,bytes,time_ns);
+  gt_template_delete(template);
+}
+void gt_bench_micro() {
+  char** const reference = gt_bench_reference_new();
+  gt_sequence_archive* const sequence_archive = gt_bench_reference_archive_new(reference);
+  // Generate the dataset
+  register const uint64_t num_records = parameters.num_reads;
+  gt_string** const lines = malloc(num_records*sizeof(gt_string*));
+  gt_template** const templates = malloc(num_records*sizeof(gt_template*));
+  gt_cond_fatal_error(!lines || !templates,MEM_HANDLER);
+  gt_bench_record* const record = gt_bench_record_new();
+  register uint64_t input_bytes = 0, i, j, k, r;
+  for (i=0;i<num_records;++i) {
+    lines[i] = gt_string_new(1024);
+    templates[i] = gt_template_new();
+    gt_bench_generate_record(reference,i,record);
+    gt_bench_sprint_map(lines[i],record);
+    input_bytes += gt_string_get_length(lines[i])+1;
+  }
+  gt_bench_record_delete(record);
+  fprintf(stdout,"#benchmark\tlabel\trecords\tbytes\tseconds\trecords_per_second\tMB_per_second\n");
+  // Parse MAP (from memory)
+  gt_string* const buffer = gt_string_new(1024);
+  register uint64_t start = gt_bench_time_ns();
+  for (r=0;r<parameters.repetitions;++r) {
+    for (i=0;i<num_records;++i) {
+      gt_string_copy(buffer,lines[i]);
+      gt_string_append_eos(buffer);
+      gt_template_clear(templates[i],true);
+      if (gt_input_map_parse_template(gt_string_get_string(buffer),templates[i])) {
+        gt_fatal_error_msg("Error parsing synthetic record '"PRIgts"'",PRIgts_content(lines[i]));
+      }
+    }
+  }
+  gt_bench_report("parse.map",parameters.repetitions*num_records,parameters.repetitions*input_bytes,gt_bench_time_ns()-start);
+  // Printers
+  gt_output_map_attributes map_attributes = GT_OUTPUT_MAP_ATTR_DEFAULT();
+  gt_output_fasta_attributes* const fasta_attributes = gt_output_fasta_attributes_new();
+  for (k=0;k<2;++k) {
+    register uint64_t output_bytes = 0;
+    start = gt_bench_time_ns();
+    for (r=0;r<parameters.repetitions;++r) {
+      for (i=0;i<num_records;++i) {
+        gt_string_clear(buffer);
+        if (k==0) {
+          gt_output_map_sprint_template(buffer,templates[i],&map_attributes);
+        } else {
+          GT_TEMPLATE_ALIGNMENT_ITERATE(templates[i],alignment) {
+            gt_output_fasta_sprint_fastq(buffer,alignment->tag,alignment->read,alignment->qualities,
+                alignment->attributes,fasta_attributes);
+          }
+        }
+        output_bytes += gt_string_get_length(buffer);
+      }
+    }
+    gt_bench_report((k==0) ? "print.map" : "print.fastq",
+        parameters.repetitions*num_records,output_bytes,gt_bench_time_ns()-start);
+  }
+  gt_output_fasta_attributes_delete(fasta_attributes);
+  // Map comparison (all pairs of maps of each alignment)
+  register uint64_t num_comparisons = 0;
+  register int64_t checksum = 0;
+  start = gt_bench_time_ns();
+  for (r=0;r<parameters.repetitions;++r) {
+    for (i=0;i<num_records;++i) {
+      GT_TEMPLATE_ALIGNMENT_ITERATE(templates[i],alignment) {
+        register const uint64_t num_maps = gt_alignment_get_num_maps(alignment);
+        for (j=0;j<num_maps;++j) {
+          for (k=j+1;k<num_maps;++k) {
+            checksum += gt_map_cmp(gt_alignment_get_map(alignment,j),gt_alignment_get_map(alignment,k));
+            ++num_comparisons;
+          }
+        }
+      }
+    }
+  }
+  gt_bench_report("map.cmp",num_comparisons,0,gt_bench_time_ns()-start);
+  // Stats
+  gt_stats* const stats = gt_stats_new();
+  gt_stats_analysis stats_analysis = GT_STATS_ANALYSIS_DEFAULT();
+  start = gt_bench_time_ns();
+  for (r=0;r<parameters.repetitions;++r) {
+    for (i=0;i<num_records;++i) gt_stats_calculate_template_stats(stats,templates[i],NULL,&stats_analysis);
+  }
+  gt_bench_report("stats.template",parameters.repetitions*num_records,
+      parameters.repetitions*input_bytes,gt_bench_time_ns()-start);
+  gt_stats_delete(stats);
+  // Template copy (attributes & maps)
+  start = gt_bench_time_ns();
+  for (r=0;r<parameters.repetitions;++r) {
+    for (i=0;i<num_records;++i) gt_template_delete(gt_template_copy(templates[i],true,true));
+  }
+  gt_bench_report("template.copy",parameters.repetitions*num_records,
+      parameters.repetitions*input_bytes,gt_bench_time_ns()-start);
+  // Hashes (per-template position dictionary & sequence names, reused across templates)
+  gt_ihash* const ihash = gt_ihash_new();
+  gt_shash* const shash = gt_shash_new();
+  register uint64_t num_lookups = 0;
+  uint64_t hash_value = 0; // Elements are not owned by the hashes
+  start = gt_bench_time_ns();
+  for (r=0;r<parameters.repetitions;++r) {
+    for (i=0;i<num_records;++i) {
+      GT_TEMPLATE_ALIGNMENT_ITERATE(templates[i],alignment) {
+        GT_ALIGNMENT_ITERATE(alignment,map) {
+          register const int64_t position = gt_map_get_position_(map);
+          if (!gt_ihash_is_contained(ihash,position)) gt_ihash_insert(ihash,position,&hash_value,uint64_t);
+          if (gt_shash_get_element(shash,gt_map_get_seq_name(map))==NULL) {
+            gt_shash_insert(shash,gt_map_get_seq_name(map),&hash_value,uint64_t);
+          }
+          num_lookups += 2;
+        }
+      }
+      gt_ihash_clear(ihash,false);
+      gt_shash_clear(shash,false);
+    }
+  }
+  gt_bench_report("hash.lookup",num_lookups,0,gt_bench_time_ns()-start);
+  gt_ihash_delete(ihash,false);
+  gt_shash_delete(shash,false);
+  // Realigners (in-place, so each repetition realigns the output of the previous one)
+  for (k=0;k<2;++k) {
+    start = gt_bench_time_ns();
+    for (r=0;r<parameters.repetitions;++r) {
+      for (i=0;i<num_records;++i) {
+        if (k==0) {
+          gt_template_realign_hamming(templates[i],sequence_archive);
+        } else {
+          gt_template_realign_levenshtein(templates[i],sequence_archive);
+        }
+      }
+    }
+    gt_bench_report((k==0) ? "realign.hamming" : "realign.levenshtein",
+        parameters.repetitions*num_records,parameters.repetitions*input_bytes,gt_bench_time_ns()-start);
+  }
+  // Parse files
+  if (parameters.parse_files!=NULL) {
+    GT_VECTOR_ITERATE(parameters.parse_files,file_name,file_num,char*) {
+      gt_bench_parse_file(*file_name);
+    }
+  }
+  // Free
+  gt_string_delete(buffer);
+  for (i=0;i<num_records;++i) {
+    gt_string_delete(lines[i]);
+    gt_template_delete(templates[i]);
+  }
+  free(lines);
+  free(templates);
+  gt_sequence_archive_delete(sequence_archive);
+  gt_bench_reference_delete(reference);
+  if (checksum==INT64_MAX) fprintf(stderr,"\n"); // Keep the comparisons alive
+}
+
+void usage() {
+  fprintf(stderr, "USE: ./gt_benchmark [ARGS]...\n"
+                  "         [Mode]\n"
+                  "           --generate|g (output a synthetic dataset, default runs the micro-benchmarks)\n"
+                  "           --format map|sam|fastq (default=map)\n"
+                  "           --output|o [FILE]\n"
+                  "           --reference [FILE] (dump the synthetic reference as FASTA)\n"
+                  "         [Dataset]\n"
+                  "           --seed <number> (default=1)\n"
+                  "           --num-reads|n <number> (default=100000)\n"
+                  "           --read-length <number> (default=100)\n"
+                  "           --paired-end|p\n"
+                  "           --insert-size <mean>,<range> (default=300,100)\n"
+                  "           --contigs <number>,<length> (default=4,1000000)\n"
+                  "           --unmapped-rate <float> (default=0.05)\n"
+                  "           --mismatch-rate <float> (per base, default=0.01)\n"
+                  "           --indel-rate <float> (per base, default=0.002)\n"
+                  "           --split-rate <float> (per end, default=0.05)\n"
+                  "           --multimap-rate <float> (default=0.2)\n"
+                  "           --max-maps <number> (default=5)\n"
+                  "         [Benchmark]\n"
+                  "           --parse [FILE] (benchmark the parsing of the file, can be repeated)\n"
+                  "           --repetitions|r <number> (default=3)\n"
+                  "           --label <string> (default=synthetic)\n"
+                  "           --help|h\n");
+}
+
+void parse_arguments(int argc,char** argv) {
+  struct option long_options[] = {
+    /* [Mode] */
+    { "generate", no_argument, 0, 'g' },
+    { "format", required_argument, 0, 1 },
+    { "output", required_argument, 0, 'o' },
+    { "reference", required_argument, 0, 2 },
+    /* [Dataset] */
+    { "seed", required_argument, 0, 10 },
+    { "num-reads", required_argument, 0, 'n' },
+    { "read-length", required_argument, 0, 11 },
+    { "paired-end", no_argument, 0, 'p' },
+    { "insert-size", required_argument, 0, 12 },
+    { "contigs", required_argument, 0, 13 },
+    { "unmapped-rate", required_argument, 0, 14 },
+    { "mismatch-rate", required_argument, 0, 15 },
+    { "indel-rate", required_argument, 0, 16 },
+    { "split-rate", required_argument, 0, 17 },
+    { "multimap-rate", required_argument, 0, 18 },
+    { "max-maps", required_argument, 0, 19 },
+    /* [Benchmark] */
+    { "parse", required_argument, 0, 20 },
+    { "repetitions", required_argument, 0, 'r' },
+    { "label", required_argument, 0, 21 },
+    { "help", no_argument, 0, 'h' },
+    { 0, 0, 0, 0 } };
+  int c,option_index;
+  while (1) {
+    c=getopt_long(argc,argv,"go:n:pr:h",long_options,&option_index);
+    if (c==-1) break;
+    switch (c) {
+    /* [Mode] */
+    case 'g':
+      parameters.generate = true;
+      break;
+    case 1:
+      if (gt_streq(optarg,"map")) {
+        parameters.format = GT_BENCH_MAP;
+      } else if (gt_streq(optarg,"sam")) {
+        parameters.format = GT_BENCH_SAM;
+      } else if (gt_streq(optarg,"fastq")) {
+        parameters.format = GT_BENCH_FASTQ;
+      } else {
+        gt_fatal_error_msg("Format not recognized '%s'",optarg);
+      }
+      break;
+    case 'o':
+      parameters.name_output_file = optarg;
+      break;
+    case 2:
+      parameters.name_reference_file = optarg;
+      break;
+    /* [Dataset] */
+    case 10:
+      parameters.seed = atoll(optarg);
+      break;
+    case 'n':
+      parameters.num_reads = atoll(optarg);
+      break;
+    case 11:
+      parameters.read_length = atoll(optarg);
+      break;
+    case 'p':
+      parameters.paired_end = true;
+      break;
+    case 12:
+      if (sscanf(optarg,"%"SCNu64",%"SCNu64,&parameters.insert_size,&parameters.insert_size_range)!=2) {
+        gt_fatal_error_msg("Invalid insert size '%s' (<mean>,<range>)",optarg);
+      }
+      break;
+    case 13:
+      if (sscanf(optarg,"%"SCNu64",%"SCNu64,&parameters.num_contigs,&parameters.contig_length)!=2) {
+        gt_fatal_error_msg("Invalid contigs '%s' (<number>,<length>)",optarg);
+      }
+      break;
+    case 14:
+      parameters.unmapped_rate = atof(optarg);
+      break;
+    case 15:
+      parameters.mismatch_rate = atof(optarg);
+      break;
+    case 16:
+      parameters.indel_rate = atof(optarg);
+      break;
+    case 17:
+      parameters.split_rate = atof(optarg);
+      break;
+    case 18:
+      parameters.multimap_rate = atof(optarg);
+      break;
+    case 19:
+      parameters.max_maps = atoll(optarg);
+      break;
+    /* [Benchmark] */
+    case 20:
+      if (parameters.parse_files==NULL) parameters.parse_files = gt_vector_new(4,sizeof(char*));
+      gt_vector_insert(parameters.parse_files,optarg,char*);
+      break;
+    case 'r':
+      parameters.repetitions = atoll(optarg);
+      break;
+    case 21:
+      parameters.label = optarg;
+      break;
+    case 'h':
+      usage();
+      exit(1);
+    case '?':
+    default:
+      gt_fatal_error_msg("Option not recognized");
+    }
+  }
+  /*
+   * Parameters check
+   */
+  if (parameters.read_length<8) gt_fatal_error_msg("Read length must be at least 8");
+  if (parameters.num_contigs==0) gt_fatal_error_msg("Number of contigs must be greater than zero");
+  if (parameters.contig_length < 4*(parameters.insert_size+parameters.insert_size_range+
+      2*parameters.read_length+2*GT_BENCH_MAX_INTRON)) {
+    gt_fatal_error_msg("Contigs too short for the read length/insert size given");
+  }
+  if (parameters.paired_end && parameters.insert_size<parameters.read_length+parameters.insert_size_range/2) {
+    gt_fatal_error_msg("Insert size must be greater than the read length (plus half the range)");
+  }
+}
+
+int main(int argc,char** argv) {
+  // Parsing command-line options
+  parse_arguments(argc,argv);
+
+  // Generate/Benchmark
+  if (parameters.generate) {
+    gt_bench_generate();
+  } else {
+    gt_bench_micro();
+  }
+
+  if (parameters.parse_files!=NULL) gt_vector_delete(parameters.parse_files);
+  return 0;
+}
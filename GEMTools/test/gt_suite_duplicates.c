@@ -0,0 +1,184 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_suite_duplicates.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Streaming duplicate detection & library complexity
+ */
+
+#include <math.h>
+#include "gt_test.h"
+
+#define GT_TEST_DUPLICATES_NUM_SIGNATURES 100000
+#define GT_TEST_DUPLICATES_NUM_THREADS 4
+
+gt_template* duplicates_template;
+gt_duplicates_attributes duplicates_attributes;
+
+void gt_duplicates_setup(void) {
+  duplicates_template = gt_template_new();
+  gt_duplicates_attributes default_attributes = GT_DUPLICATES_ATTR_DEFAULT();
+  duplicates_attributes = default_attributes;
+}
+
+void gt_duplicates_teardown(void) {
+  gt_template_delete(duplicates_template);
+}
+
+gt_duplicate_status gt_test_duplicates_mark(gt_duplicates* const duplicates,gt_template* const template,char* const line) {
+  fail_unless(gt_input_map_parse_template(line,template)==0,"Failed parsing '%s'",line);
+  return gt_duplicates_mark_template(duplicates,template);
+}
+void gt_test_duplicates_mark_distinct(gt_duplicates* const duplicates,gt_template* const template,const uint64_t num_signatures) {
+  char line[128];
+  uint64_t i;
+  for (i=0;i<num_signatures;++i) {
+    sprintf(line,"r%"PRIu64"\tACGT\t1\tchr%"PRIu64":+:%"PRIu64":4",i,i%8,1+i/8);
+    gt_test_duplicates_mark(duplicates,template,line);
+  }
+}
+
+START_TEST(gt_test_duplicates_se)
+{
+  gt_duplicates* const duplicates = gt_duplicates_new(&duplicates_attributes);
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"r1\tACGTACGT\t1\tchr1:+:100:8")==GT_DUPLICATE_NONE);
+  fail_unless(gt_template_get_duplicate_status(duplicates_template)==GT_DUPLICATE_NONE);
+  // Same 5' end (forward: first base)
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"r2\tACGTAC\t1\tchr1:+:100:6")==GT_DUPLICATE_PCR);
+  fail_unless(gt_template_get_duplicate_status(duplicates_template)==GT_DUPLICATE_PCR);
+  // Same position, other strand (reverse: 5' end is the last base)
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"r3\tACGTACGT\t1\tchr1:-:100:8")==GT_DUPLICATE_NONE);
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"r4\tACGTAC\t1\tchr1:-:102:6")==GT_DUPLICATE_PCR);
+  // Other sequence
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"r5\tACGTACGT\t1\tchr2:+:100:8")==GT_DUPLICATE_NONE);
+  // Unmapped
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"r6\tACGTACGT\t0\t-")==GT_DUPLICATE_NONE);
+  fail_unless(gt_duplicates_get_num_templates(duplicates)==5);
+  fail_unless(gt_duplicates_get_num_duplicates(duplicates)==2);
+  fail_unless(gt_duplicates_get_num_distinct(duplicates)==3);
+  gt_duplicates_delete(duplicates);
+}
+END_TEST
+
+START_TEST(gt_test_duplicates_optical)
+{
+  gt_duplicates* const duplicates = gt_duplicates_new(&duplicates_attributes);
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"HWI:3:1101:1000:2000#0/1\tACGT\t1\tchr1:+:100:4")==GT_DUPLICATE_NONE);
+  // Same tile, close
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"HWI:3:1101:1050:2050#0/1\tACGT\t1\tchr1:+:100:4")==GT_DUPLICATE_OPTICAL);
+  // Same tile, far
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"HWI:3:1101:5000:2000#0/1\tACGT\t1\tchr1:+:100:4")==GT_DUPLICATE_PCR);
+  // Other tile
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,"HWI:3:1102:1000:2000#0/1\tACGT\t1\tchr1:+:100:4")==GT_DUPLICATE_PCR);
+  fail_unless(gt_duplicates_get_num_duplicates(duplicates)==3);
+  fail_unless(gt_duplicates_get_num_optical_duplicates(duplicates)==1);
+  gt_duplicates_delete(duplicates);
+}
+END_TEST
+
+START_TEST(gt_test_duplicates_pe)
+{
+  gt_duplicates* const duplicates = gt_duplicates_new(&duplicates_attributes);
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,
+      "r1\tACGT ACGT\t1\tchr1:+:100:4::chr1:-:300:4")==GT_DUPLICATE_NONE);
+  // Ends sequenced in swapped order
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,
+      "r2\tACGT ACGT\t1\tchr1:-:300:4::chr1:+:100:4")==GT_DUPLICATE_PCR);
+  // Same first end, other mate
+  fail_unless(gt_test_duplicates_mark(duplicates,duplicates_template,
+      "r3\tACGT ACGT\t1\tchr1:+:100:4::chr1:-:400:4")==GT_DUPLICATE_NONE);
+  gt_duplicates_delete(duplicates);
+}
+END_TEST
+
+START_TEST(gt_test_duplicates_growth)
+{
+  // Tables start small and grow, all signatures tracked
+  gt_duplicates* const duplicates = gt_duplicates_new(&duplicates_attributes);
+  const uint64_t initial_memory = gt_duplicates_get_memory(duplicates);
+  gt_test_duplicates_mark_distinct(duplicates,duplicates_template,GT_TEST_DUPLICATES_NUM_SIGNATURES);
+  fail_unless(gt_duplicates_get_memory(duplicates)>initial_memory);
+  fail_unless(gt_duplicates_get_memory(duplicates)<=duplicates_attributes.max_memory);
+  fail_unless(gt_duplicates_get_num_untracked(duplicates)==0);
+  fail_unless(gt_duplicates_get_num_distinct(duplicates)==GT_TEST_DUPLICATES_NUM_SIGNATURES);
+  // Second pass, all duplicates
+  gt_test_duplicates_mark_distinct(duplicates,duplicates_template,GT_TEST_DUPLICATES_NUM_SIGNATURES);
+  fail_unless(gt_duplicates_get_num_duplicates(duplicates)==GT_TEST_DUPLICATES_NUM_SIGNATURES);
+  gt_duplicates_delete(duplicates);
+}
+END_TEST
+
+START_TEST(gt_test_duplicates_saturation)
+{
+  // Tables can't grow, the untracked templates are accounted and the distinct ones estimated
+  duplicates_attributes.max_memory = 0;
+  gt_duplicates* const duplicates = gt_duplicates_new(&duplicates_attributes);
+  gt_test_duplicates_mark_distinct(duplicates,duplicates_template,GT_TEST_DUPLICATES_NUM_SIGNATURES);
+  const uint64_t num_untracked = gt_duplicates_get_num_untracked(duplicates);
+  fail_unless(num_untracked>0);
+  fail_unless(gt_duplicates_get_num_duplicates(duplicates)==0);
+  const double num_distinct = gt_duplicates_get_num_distinct(duplicates);
+  fail_unless(fabs(num_distinct-GT_TEST_DUPLICATES_NUM_SIGNATURES)<0.05*GT_TEST_DUPLICATES_NUM_SIGNATURES,
+      "Distinct estimate too far (%f)",num_distinct);
+  gt_duplicates_delete(duplicates);
+}
+END_TEST
+
+START_TEST(gt_test_duplicates_library_size)
+{
+  gt_duplicates* const duplicates = gt_duplicates_new(&duplicates_attributes);
+  gt_test_duplicates_mark_distinct(duplicates,duplicates_template,1000);
+  fail_unless(gt_duplicates_estimate_library_size(duplicates)==0); // No duplicates
+  gt_test_duplicates_mark_distinct(duplicates,duplicates_template,1000);
+  // Lander-Waterman: C/X = 1 - exp(-N/X)
+  const double c = 1000.0, n = 2000.0;
+  const double x = gt_duplicates_estimate_library_size(duplicates);
+  fail_unless(x>c);
+  fail_unless(fabs(c/x-1.0+exp(-n/x))<1e-3,"Library size %f doesn't fit",x);
+  gt_duplicates_delete(duplicates);
+}
+END_TEST
+
+gt_duplicates* duplicates_shared;
+void* gt_test_duplicates_thread(void* const arg) {
+  gt_template* const template = gt_template_new();
+  gt_test_duplicates_mark_distinct(duplicates_shared,template,GT_TEST_DUPLICATES_NUM_SIGNATURES/10);
+  gt_template_delete(template);
+  return NULL;
+}
+START_TEST(gt_test_duplicates_threads)
+{
+  // All threads mark the same signatures, only one original each
+  duplicates_shared = gt_duplicates_new(&duplicates_attributes);
+  pthread_t threads[GT_TEST_DUPLICATES_NUM_THREADS];
+  uint64_t i;
+  for (i=0;i<GT_TEST_DUPLICATES_NUM_THREADS;++i) {
+    fail_unless(pthread_create(threads+i,NULL,gt_test_duplicates_thread,NULL)==0);
+  }
+  for (i=0;i<GT_TEST_DUPLICATES_NUM_THREADS;++i) pthread_join(threads[i],NULL);
+  fail_unless(gt_duplicates_get_num_templates(duplicates_shared)==
+      GT_TEST_DUPLICATES_NUM_THREADS*(GT_TEST_DUPLICATES_NUM_SIGNATURES/10));
+  fail_unless(gt_duplicates_get_num_distinct(duplicates_shared)==GT_TEST_DUPLICATES_NUM_SIGNATURES/10);
+  fail_unless(gt_duplicates_get_num_duplicates(duplicates_shared)==
+      (GT_TEST_DUPLICATES_NUM_THREADS-1)*(GT_TEST_DUPLICATES_NUM_SIGNATURES/10));
+  gt_duplicates_delete(duplicates_shared);
+}
+END_TEST
+
+Suite *gt_duplicates_suite(void) {
+  Suite *s = suite_create("gt_duplicates");
+
+  /* Duplicates marking */
+  TCase *tc_duplicates = tcase_create("Duplicates");
+  tcase_add_checked_fixture(tc_duplicates,gt_duplicates_setup,gt_duplicates_teardown);
+  tcase_add_test(tc_duplicates,gt_test_duplicates_se);
+  tcase_add_test(tc_duplicates,gt_test_duplicates_optical);
+  tcase_add_test(tc_duplicates,gt_test_duplicates_pe);
+  tcase_add_test(tc_duplicates,gt_test_duplicates_growth);
+  tcase_add_test(tc_duplicates,gt_test_duplicates_saturation);
+  tcase_add_test(tc_duplicates,gt_test_duplicates_library_size);
+  tcase_add_test(tc_duplicates,gt_test_duplicates_threads);
+  suite_add_tcase(s,tc_duplicates);
+
+  return s;
+}
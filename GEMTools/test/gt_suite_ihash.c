@@ -63,6 +63,43 @@ START_TEST(gt_test_ihash_neg_key)
 }
 END_TEST
 
+START_TEST(gt_test_ihash_grow_remove_reuse)
+{
+  register int64_t key, round;
+  for (round=0;round<2;++round) { // Second round reuses the cleared table
+    // Insert (forces several index rehashes & element blocks)
+    for (key=-5000;key<5000;++key) {
+      register int64_t* const value = malloc(sizeof(int64_t));
+      *value = key*3;
+      gt_ihash_insert(ihash,key,value,int64_t);
+    }
+    fail_unless(gt_ihash_get_num_elements(ihash)==10000,"Failed counting ihash elements");
+    // Remove odd keys
+    for (key=-5000;key<5000;++key) {
+      if (key%2!=0) gt_ihash_remove(ihash,key,true);
+    }
+    fail_unless(gt_ihash_get_num_elements(ihash)==5000,"Failed removing ihash elements");
+    for (key=-5000;key<5000;++key) {
+      if (key%2!=0) {
+        fail_unless(!gt_ihash_is_contained(ihash,key),"Removed key still in ihash");
+      } else {
+        fail_unless(*gt_ihash_get(ihash,key,int64_t)==key*3,"Failed retrieving ihash element after removals");
+      }
+    }
+    // Iterate (insertion order)
+    register int64_t last_key = INT64_MIN, num_elements = 0;
+    GT_IHASH_BEGIN_ITERATE(ihash,ikey,value,int64_t) {
+      fail_unless(ikey>last_key && *value==ikey*3,"Failed iterating ihash");
+      last_key = ikey;
+      ++num_elements;
+    } GT_IHASH_END_ITERATE;
+    fail_unless(num_elements==5000,"Failed iterating ihash (number of elements)");
+    gt_ihash_clear(ihash,true);
+    fail_unless(gt_ihash_get_num_elements(ihash)==0 && !gt_ihash_is_contained(ihash,0),"Failed clearing ihash");
+  }
+}
+END_TEST
+
 Suite *gt_ihash_suite(void) {
   Suite *s = suite_create("gt_ihash");
 
@@ -71,6 +108,7 @@ Suite *gt_ihash_suite(void) {
   tcase_add_checked_fixture(tc_core,gt_ihash_setup,gt_ihash_teardown);
   tcase_add_test(tc_core,gt_test_ihash_basic_insertions);
   tcase_add_test(tc_core,gt_test_ihash_neg_key);
+  tcase_add_test(tc_core,gt_test_ihash_grow_remove_reuse);
   suite_add_tcase(s,tc_core);
 
   return s;
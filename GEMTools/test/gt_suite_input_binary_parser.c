@@ -0,0 +1,186 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_suite_input_binary_parser.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: MAP->BINARY->MAP round trips and sequence names dictionary
+ */
+
+#include "gt_test.h"
+
+#define GT_TEST_BINARY_FILE "build/gt_suite_input_binary_parser.bin"
+
+gt_output_binary_attributes* binary_attributes;
+gt_output_map_attributes* binary_map_attributes;
+gt_generic_parser_attr* binary_parser_attributes;
+gt_string* binary_expected;
+gt_string* binary_parsed;
+
+void gt_input_binary_parser_setup(void) {
+  binary_attributes = gt_output_binary_attributes_new();
+  binary_map_attributes = gt_output_map_attributes_new();
+  binary_parser_attributes = gt_input_generic_parser_attributes_new(false);
+  binary_expected = gt_string_new(1024);
+  binary_parsed = gt_string_new(1024);
+}
+
+void gt_input_binary_parser_teardown(void) {
+  gt_output_binary_attributes_delete(binary_attributes);
+  gt_output_map_attributes_delete(binary_map_attributes);
+  gt_input_generic_parser_attributes_delete(binary_parser_attributes);
+  gt_string_delete(binary_expected);
+  gt_string_delete(binary_parsed);
+  unlink(GT_TEST_BINARY_FILE);
+}
+
+/*
+ * Converts @map_file into binary and checks that each template reads back as it was
+ */
+uint64_t gt_test_binary_round_trip(char* const map_file) {
+  // MAP -> BINARY
+  gt_input_file* map_input = gt_input_file_open(map_file,false);
+  gt_buffered_input_file* buffered_map_input = gt_buffered_input_file_new(map_input);
+  gt_template* template = gt_template_new();
+  FILE* binary_output = fopen(GT_TEST_BINARY_FILE,"w");
+  fail_unless(binary_output!=NULL,"Failed opening the binary file");
+  uint64_t num_templates = 0;
+  while (gt_input_generic_parser_get_template(buffered_map_input,template,binary_parser_attributes)==GT_STATUS_OK) {
+    fail_unless(gt_output_binary_fprint_template(binary_output,template,binary_attributes)==0,"Failed printing binary");
+    ++num_templates;
+  }
+  fclose(binary_output);
+  gt_buffered_input_file_close(buffered_map_input);
+  gt_input_file_close(map_input);
+  // BINARY -> MAP (in lockstep with the original)
+  map_input = gt_input_file_open(map_file,false);
+  buffered_map_input = gt_buffered_input_file_new(map_input);
+  gt_input_file* binary_input = gt_input_file_open(GT_TEST_BINARY_FILE,false);
+  fail_unless(binary_input->file_format==BINARY,"Binary file not detected");
+  gt_buffered_input_file* buffered_binary_input = gt_buffered_input_file_new(binary_input);
+  gt_template* binary_template = gt_template_new();
+  uint64_t i;
+  for (i=0;i<num_templates;++i) {
+    fail_unless(gt_input_generic_parser_get_template(buffered_map_input,template,binary_parser_attributes)==GT_STATUS_OK);
+    fail_unless(gt_input_generic_parser_get_template(buffered_binary_input,binary_template,binary_parser_attributes)==GT_STATUS_OK,
+        "Failed parsing binary template %"PRIu64" of '%s'",i,map_file);
+    gt_string_clear(binary_expected);
+    gt_string_clear(binary_parsed);
+    gt_output_map_sprint_template(binary_expected,template,binary_map_attributes);
+    gt_output_map_sprint_template(binary_parsed,binary_template,binary_map_attributes);
+    fail_unless(gt_string_cmp(binary_expected,binary_parsed)==0,"Round trip differs:\n%s%s",
+        gt_string_get_string(binary_expected),gt_string_get_string(binary_parsed));
+  }
+  fail_unless(gt_input_generic_parser_get_template(buffered_binary_input,binary_template,binary_parser_attributes)==GT_IGP_EOF);
+  gt_template_delete(binary_template);
+  gt_template_delete(template);
+  gt_buffered_input_file_close(buffered_binary_input);
+  gt_input_file_close(binary_input);
+  gt_buffered_input_file_close(buffered_map_input);
+  gt_input_file_close(map_input);
+  return num_templates;
+}
+
+uint64_t gt_test_binary_count_seq_name_definitions(void) {
+  FILE* binary_file = fopen(GT_TEST_BINARY_FILE,"r");
+  fail_unless(binary_file!=NULL);
+  uint64_t num_definitions = 0;
+  int c, last = EOL;
+  while ((c=fgetc(binary_file))!=EOF) {
+    if (last==EOL && c==GT_BINARY_SEQ_NAME_DEFINITION) ++num_definitions;
+    last = c;
+  }
+  fclose(binary_file);
+  return num_definitions;
+}
+
+START_TEST(gt_test_ibp_round_trip_se)
+{
+  fail_unless(gt_test_binary_round_trip("../datasets/gem.new.SE.map")>0);
+  // Every name defined once
+  fail_unless(gt_test_binary_count_seq_name_definitions()==gt_output_binary_attributes_get_num_seq_names(binary_attributes));
+}
+END_TEST
+
+START_TEST(gt_test_ibp_round_trip_pe)
+{
+  fail_unless(gt_test_binary_round_trip("../datasets/gem.new.PE.map")>0);
+  gt_output_binary_attributes_reset_defaults(binary_attributes);
+  fail_unless(gt_test_binary_round_trip("../datasets/gem.new.PE.scored.map")>0);
+}
+END_TEST
+
+START_TEST(gt_test_ibp_round_trip_splits_and_indels)
+{
+  // NOTE: Some splits in the dataset disagree with its counters (reported when printing both sides)
+  fail_unless(gt_test_binary_round_trip("../datasets/gem.new.SE.splits.map")>0);
+  gt_output_binary_attributes_reset_defaults(binary_attributes);
+  fail_unless(gt_test_binary_round_trip("../datasets/gem.new.SE.454.map")>0);
+  // Smaller than the MAP text
+  struct stat map_stat, binary_stat;
+  fail_unless(stat("../datasets/gem.new.SE.454.map",&map_stat)==0 && stat(GT_TEST_BINARY_FILE,&binary_stat)==0);
+  fail_unless(binary_stat.st_size<map_stat.st_size,"Binary (%"PRIu64") not smaller than MAP (%"PRIu64")",
+      (uint64_t)binary_stat.st_size,(uint64_t)map_stat.st_size);
+}
+END_TEST
+
+START_TEST(gt_test_ibp_round_trip_fastq)
+{
+  fail_unless(gt_test_binary_round_trip("testdata/single_paired_casava_additional.fastq")>0);
+}
+END_TEST
+
+START_TEST(gt_test_ibp_seq_names_out_of_order_blocks)
+{
+  /*
+   * Block 1 is encoded first and defines the name. Block 0, written
+   * before it, must define the name again to be readable on its own
+   */
+  gt_template* template = gt_template_new();
+  fail_unless(gt_input_map_parse_template("r1\tACGT\t####\t1\tchrA:+:10:4",template)==0);
+  gt_output_file* output_file = gt_output_file_new(GT_TEST_BINARY_FILE,SORTED_FILE);
+  gt_buffered_output_file* buffered_output_0 = gt_buffered_output_file_new(output_file);
+  gt_buffered_output_file* buffered_output_1 = gt_buffered_output_file_new(output_file);
+  gt_buffered_output_file_set_block_ids(buffered_output_0,0,0);
+  gt_buffered_output_file_set_block_ids(buffered_output_1,1,0);
+  fail_unless(gt_output_binary_bofprint_template(buffered_output_1,template,binary_attributes)==0);
+  fail_unless(gt_output_binary_bofprint_template(buffered_output_0,template,binary_attributes)==0);
+  fail_unless(gt_output_binary_bofprint_template(buffered_output_0,template,binary_attributes)==0);
+  gt_buffered_output_file_close(buffered_output_0);
+  gt_buffered_output_file_close(buffered_output_1);
+  gt_output_file_close(output_file);
+  fail_unless(gt_output_binary_attributes_get_num_seq_names(binary_attributes)==1);
+  fail_unless(gt_test_binary_count_seq_name_definitions()==2);
+  // Read back
+  gt_input_file* binary_input = gt_input_file_open(GT_TEST_BINARY_FILE,false);
+  gt_buffered_input_file* buffered_binary_input = gt_buffered_input_file_new(binary_input);
+  gt_template* binary_template = gt_template_new();
+  gt_output_map_sprint_template(binary_expected,template,binary_map_attributes);
+  uint64_t i;
+  for (i=0;i<3;++i) {
+    fail_unless(gt_input_generic_parser_get_template(buffered_binary_input,binary_template,binary_parser_attributes)==GT_STATUS_OK);
+    gt_string_clear(binary_parsed);
+    gt_output_map_sprint_template(binary_parsed,binary_template,binary_map_attributes);
+    fail_unless(gt_string_cmp(binary_expected,binary_parsed)==0);
+  }
+  gt_template_delete(binary_template);
+  gt_template_delete(template);
+  gt_buffered_input_file_close(buffered_binary_input);
+  gt_input_file_close(binary_input);
+}
+END_TEST
+
+Suite *gt_input_binary_parser_suite(void) {
+  Suite *s = suite_create("gt_input_binary_parser");
+
+  /* Binary round trips */
+  TCase *tc_binary_round_trip = tcase_create("Binary round trip");
+  tcase_add_checked_fixture(tc_binary_round_trip,gt_input_binary_parser_setup,gt_input_binary_parser_teardown);
+  tcase_add_test(tc_binary_round_trip,gt_test_ibp_round_trip_se);
+  tcase_add_test(tc_binary_round_trip,gt_test_ibp_round_trip_pe);
+  tcase_add_test(tc_binary_round_trip,gt_test_ibp_round_trip_splits_and_indels);
+  tcase_add_test(tc_binary_round_trip,gt_test_ibp_round_trip_fastq);
+  tcase_add_test(tc_binary_round_trip,gt_test_ibp_seq_names_out_of_order_blocks);
+  suite_add_tcase(s,tc_binary_round_trip);
+
+  return s;
+}
@@ -367,6 +367,72 @@ START_TEST(gt_test_tag_parsing_generic_parser_single_paired_casava_additional)
 END_TEST
 
 
+START_TEST(gt_test_qualities_scan_min_max)
+{
+	// The one-pass min/max must match a byte-wise scan for any alignment, length and position
+	char buffer[64+8];
+	uint64_t offset, length, position;
+	for (offset=0;offset<8;++offset) {
+		for (length=1;length<=48;++length) {
+			for (position=0;position<length;++position) {
+				char* const line = buffer+offset;
+				uint64_t i;
+				for (i=0;i<length;++i) line[i] = 'I'+(i%7);
+				line[position] = '#';
+				line[(position+length/2)%length] = '~';
+				line[length] = '\n';
+				uint8_t min = UINT8_MAX, max = 0, expected_min = UINT8_MAX, expected_max = 0;
+				for (i=0;i<length;++i) {
+					expected_min = GT_MIN(expected_min,(uint8_t)line[i]);
+					expected_max = GT_MAX(expected_max,(uint8_t)line[i]);
+				}
+				fail_unless(gt_dna_read_scan_qualities_line(line,&min,&max)==line+length,"Line end not found");
+				fail_unless(min==expected_min && max==expected_max,
+						"Wrong qualities range (offset %"PRIu64", length %"PRIu64", position %"PRIu64")",offset,length,position);
+			}
+		}
+	}
+}
+END_TEST
+
+START_TEST(gt_test_fastq_qualities_offset)
+{
+	FILE* fastq = fopen("build/gt_suite_qualities_offset.fastq","w");
+	fail_unless(fastq!=NULL);
+	fprintf(fastq,"@r1\nACGTACGTACGTACGTACGT\n+\nhhhhhhhhhhBhhhhhhhhh\n");
+	fprintf(fastq,"@r2\nACGTACGTACGTACGTACGT\n+\nIIIIIIIIIIIIIIIIIII#\n");
+	fclose(fastq);
+	gt_input_file* input = gt_input_file_open("build/gt_suite_qualities_offset.fastq",false);
+	gt_buffered_input_file* buffered_input = gt_buffered_input_file_new(input);
+	gt_dna_read* read = gt_dna_read_new();
+	gt_qualities_offset_t qualities_offset;
+	// Nothing parsed yet
+	fail_unless(gt_input_fasta_parser_deduce_qualities_offset(buffered_input,&qualities_offset)==GT_STATUS_FAIL);
+	// Range gathered by the parser (per read and per buffered input)
+	fail_unless(gt_input_fasta_parser_get_read(buffered_input,read)==GT_IFP_OK);
+	fail_unless(read->min_quality=='B' && read->max_quality=='h');
+	fail_unless(gt_dna_read_deduce_qualities_offset(read,&qualities_offset)==GT_STATUS_OK);
+	fail_unless(qualities_offset==GT_QUALS_OFFSET_64);
+	fail_unless(gt_input_fasta_parser_deduce_qualities_offset(buffered_input,&qualities_offset)==GT_STATUS_OK);
+	fail_unless(qualities_offset==GT_QUALS_OFFSET_64);
+	fail_unless(gt_input_fasta_parser_get_read(buffered_input,read)==GT_IFP_OK);
+	fail_unless(read->min_quality=='#' && read->max_quality=='I');
+	fail_unless(gt_dna_read_deduce_qualities_offset(read,&qualities_offset)==GT_STATUS_OK);
+	fail_unless(qualities_offset==GT_QUALS_OFFSET_33);
+	fail_unless(gt_input_fasta_parser_deduce_qualities_offset(buffered_input,&qualities_offset)==GT_STATUS_OK);
+	fail_unless(qualities_offset==GT_QUALS_OFFSET_33);
+	// Qualities set by hand (range unknown, scanned once)
+	gt_dna_read_set_qualities(read,"hhhhh");
+	fail_unless(read->max_quality==0);
+	fail_unless(gt_dna_read_deduce_qualities_offset(read,&qualities_offset)==GT_STATUS_OK);
+	fail_unless(qualities_offset==GT_QUALS_OFFSET_64 && read->min_quality=='h');
+	gt_dna_read_delete(read);
+	gt_buffered_input_file_close(buffered_input);
+	gt_input_file_close(input);
+	unlink("build/gt_suite_qualities_offset.fastq");
+}
+END_TEST
+
 
 Suite *gt_input_tag_parser_suite(void) {
   Suite *s = suite_create("gt_input_parser");
@@ -385,6 +451,8 @@ Suite *gt_input_tag_parser_suite(void) {
   tcase_add_test(tc_tag_string_parser,gt_test_tag_parsing_generic_parser_single_paired_map_output_casava_additional_no_casava_no_extra);
   tcase_add_test(tc_tag_string_parser,gt_test_tag_parsing_generic_parser_single_paired_map_output_casava_additional_no_casava_no_extra_fastq);
   tcase_add_test(tc_tag_string_parser,gt_test_tag_parsing_generic_parser_single_paired_map_output_casava_additional_fasta);
+  tcase_add_test(tc_tag_string_parser,gt_test_qualities_scan_min_max);
+  tcase_add_test(tc_tag_string_parser,gt_test_fastq_qualities_offset);
 
   suite_add_tcase(s,tc_tag_string_parser);
 
@@ -0,0 +1,118 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_suite_inss_model.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Insert size model (orientation classes & quantiles of the signed insert size)
+ */
+
+#include "gt_test.h"
+
+gt_template* inss_template;
+gt_inss_model* inss_model;
+
+void gt_inss_model_setup(void) {
+  inss_template = gt_template_new();
+  inss_model = gt_inss_model_new(0);
+}
+
+void gt_inss_model_teardown(void) {
+  gt_template_delete(inss_template);
+  gt_inss_model_delete(inss_model);
+}
+
+int64_t gt_test_inss_model_add(gt_inss_model* const model,gt_template* const template,char* const line) {
+  fail_unless(gt_input_map_parse_template(line,template)==0,"Failed parsing '%s'",line);
+  fail_unless(gt_inss_model_add_template(model,template));
+  uint64_t error_code;
+  return gt_template_get_insert_size(gt_template_get_mmap(template,0,NULL),&error_code);
+}
+
+START_TEST(gt_test_inss_model_fr)
+{
+  // Leftmost end forward, pointing inwards
+  const int64_t inss_a = gt_test_inss_model_add(inss_model,inss_template,"r1\tACGT ACGT\t1\tchr1:+:100:4::chr1:-:130:4");
+  const int64_t inss_b = gt_test_inss_model_add(inss_model,inss_template,"r2\tACGT ACGT\t1\tchr1:-:140:4::chr1:+:100:4");
+  fail_unless(inss_a==35 && inss_b==45);
+  fail_unless(gt_inss_model_get_num_samples(inss_model,GT_INSS_FR)==2);
+  fail_unless(gt_inss_model_get_num_samples(inss_model,GT_INSS_RF)==0);
+  fail_unless(gt_inss_model_get_dominant_orientation(inss_model)==GT_INSS_FR);
+  // Quantiles are the insert sizes the filters are checked against
+  fail_unless(gt_inss_model_get_quantile(inss_model,GT_INSS_FR,0.0)==inss_a);
+  fail_unless(gt_inss_model_get_quantile(inss_model,GT_INSS_FR,0.5)==inss_a);
+  fail_unless(gt_inss_model_get_quantile(inss_model,GT_INSS_FR,1.0)==inss_b);
+}
+END_TEST
+
+START_TEST(gt_test_inss_model_rf)
+{
+  // Leftmost end reverse, pointing outwards (negative insert sizes)
+  const int64_t inss_a = gt_test_inss_model_add(inss_model,inss_template,"r1\tACGT ACGT\t1\tchr1:-:100:4::chr1:+:130:4");
+  const int64_t inss_b = gt_test_inss_model_add(inss_model,inss_template,"r2\tACGT ACGT\t1\tchr1:+:150:4::chr1:-:100:4");
+  const int64_t inss_c = gt_test_inss_model_add(inss_model,inss_template,"r3\tACGT ACGT\t1\tchr1:-:100:4::chr1:+:110:4");
+  fail_unless(inss_a==-25 && inss_b==-45 && inss_c==-5);
+  fail_unless(gt_inss_model_get_num_samples(inss_model,GT_INSS_RF)==3);
+  fail_unless(gt_inss_model_get_dominant_orientation(inss_model)==GT_INSS_RF);
+  fail_unless(gt_inss_model_get_quantile(inss_model,GT_INSS_RF,0.0)==inss_b);
+  fail_unless(gt_inss_model_get_quantile(inss_model,GT_INSS_RF,0.5)==inss_a);
+  fail_unless(gt_inss_model_get_quantile(inss_model,GT_INSS_RF,1.0)==inss_c);
+}
+END_TEST
+
+START_TEST(gt_test_inss_model_other_classes)
+{
+  gt_test_inss_model_add(inss_model,inss_template,"r1\tACGT ACGT\t1\tchr1:+:100:4::chr1:+:130:4");
+  gt_test_inss_model_add(inss_model,inss_template,"r2\tACGT ACGT\t1\tchr1:+:100:4::chr2:-:130:4");
+  fail_unless(gt_inss_model_get_num_samples(inss_model,GT_INSS_TANDEM)==1);
+  fail_unless(gt_inss_model_get_quantile(inss_model,GT_INSS_TANDEM,0.5)==0);
+  fail_unless(inss_model->num_different_contigs==1);
+  fail_unless(gt_inss_model_get_num_samples(inss_model,GT_INSS_FR)==0);
+}
+END_TEST
+
+START_TEST(gt_test_inss_model_large_and_merge)
+{
+  // Large insert sizes are within the relative error bound
+  gt_inss_model* const model_b = gt_inss_model_new(0);
+  gt_inss_model_add(inss_model,GT_INSS_FR,300);
+  gt_inss_model_add(model_b,GT_INSS_FR,5000);
+  gt_inss_model_add(model_b,GT_INSS_FR,-3000);
+  gt_inss_model_merge(inss_model,model_b);
+  gt_inss_model_delete(model_b);
+  fail_unless(gt_inss_model_get_num_samples(inss_model,GT_INSS_FR)==3);
+  const int64_t q0 = gt_inss_model_get_quantile(inss_model,GT_INSS_FR,0.0);
+  const int64_t q5 = gt_inss_model_get_quantile(inss_model,GT_INSS_FR,0.5);
+  const int64_t q1 = gt_inss_model_get_quantile(inss_model,GT_INSS_FR,1.0);
+  fail_unless(GT_ABS(q0+3000)<=3000/128,"Q0=%"PRId64,q0);
+  fail_unless(GT_ABS(q5-300)<=300/128,"Q50=%"PRId64,q5);
+  fail_unless(GT_ABS(q1-5000)<=5000/128,"Q100=%"PRId64,q1);
+}
+END_TEST
+
+START_TEST(gt_test_inss_model_max_templates)
+{
+  gt_inss_model* const model = gt_inss_model_new(2);
+  gt_test_inss_model_add(model,inss_template,"r1\tACGT ACGT\t1\tchr1:+:100:4::chr1:-:130:4");
+  gt_test_inss_model_add(model,inss_template,"r2\tACGT ACGT\t1\tchr1:+:100:4::chr1:-:140:4");
+  fail_unless(gt_inss_model_is_complete(model));
+  fail_unless(!gt_inss_model_add_template(model,inss_template));
+  fail_unless(gt_inss_model_get_num_samples(model,GT_INSS_FR)==2);
+  gt_inss_model_delete(model);
+}
+END_TEST
+
+Suite *gt_inss_model_suite(void) {
+  Suite *s = suite_create("gt_inss_model");
+
+  /* Insert size model */
+  TCase *tc_inss_model = tcase_create("Insert size model");
+  tcase_add_checked_fixture(tc_inss_model,gt_inss_model_setup,gt_inss_model_teardown);
+  tcase_add_test(tc_inss_model,gt_test_inss_model_fr);
+  tcase_add_test(tc_inss_model,gt_test_inss_model_rf);
+  tcase_add_test(tc_inss_model,gt_test_inss_model_other_classes);
+  tcase_add_test(tc_inss_model,gt_test_inss_model_large_and_merge);
+  tcase_add_test(tc_inss_model,gt_test_inss_model_max_templates);
+  suite_add_tcase(s,tc_inss_model);
+
+  return s;
+}
@@ -0,0 +1,91 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt_suite_map_score.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Map scoring (Phred penalties & MAPQ)
+ */
+
+#include "gt_test.h"
+
+gt_template* score_template;
+gt_map_score_attributes* score_attributes;
+
+void gt_map_score_setup(void) {
+  score_template = gt_template_new();
+  score_attributes = gt_map_score_attributes_new();
+}
+
+void gt_map_score_teardown(void) {
+  gt_template_delete(score_template);
+  gt_map_score_attributes_delete(score_attributes);
+}
+
+/*
+ * Qualities: 'I' (Q40) at the first base, '#' (Q2) elsewhere
+ */
+START_TEST(gt_test_map_score_forward_mismatch)
+{
+  fail_unless(gt_input_map_parse_template("r1\tACGTACGT\tI#######\t1\tchr1:+:10:A7",score_template)==0);
+  gt_alignment* const alignment = gt_template_get_block(score_template,0);
+  gt_map* const map = gt_alignment_get_map(alignment,0);
+  fail_unless(gt_map_score_get_phred_penalty(alignment,map,score_attributes)==40);
+  fail_unless(gt_input_map_parse_template("r1\tACGTACGT\tI#######\t1\tchr1:+:10:7A",score_template)==0);
+  fail_unless(gt_map_score_get_phred_penalty(gt_template_get_block(score_template,0),
+      gt_alignment_get_map(gt_template_get_block(score_template,0),0),score_attributes)==2);
+}
+END_TEST
+
+START_TEST(gt_test_map_score_reverse_mismatch)
+{
+  // Mismatch positions refer to the read as stored, also on the reverse strand
+  fail_unless(gt_input_map_parse_template("r1\tACGTACGT\tI#######\t1\tchr1:-:10:A7",score_template)==0);
+  gt_alignment* const alignment = gt_template_get_block(score_template,0);
+  gt_map* const map = gt_alignment_get_map(alignment,0);
+  fail_unless(gt_map_score_get_phred_penalty(alignment,map,score_attributes)==40);
+  fail_unless(gt_input_map_parse_template("r1\tACGTACGT\tI#######\t1\tchr1:-:10:7A",score_template)==0);
+  fail_unless(gt_map_score_get_phred_penalty(gt_template_get_block(score_template,0),
+      gt_alignment_get_map(gt_template_get_block(score_template,0),0),score_attributes)==2);
+}
+END_TEST
+
+START_TEST(gt_test_map_score_no_qualities)
+{
+  fail_unless(gt_input_map_parse_template("r1\tACGTACGT\t1\tchr1:-:10:A7",score_template)==0);
+  gt_alignment* const alignment = gt_template_get_block(score_template,0);
+  fail_unless(gt_map_score_get_phred_penalty(alignment,
+      gt_alignment_get_map(alignment,0),score_attributes)==score_attributes->mismatch_penalty);
+}
+END_TEST
+
+START_TEST(gt_test_map_score_mapq)
+{
+  // Unique hit (strata 0 & 1 searched)
+  fail_unless(gt_input_map_parse_template("r1\tACGTACGT\tIIIIIIII\t1:0\tchr1:+:10:8",score_template)==0);
+  const uint64_t unique_mapq = gt_map_score_template_mapq(score_template,score_attributes);
+  fail_unless(unique_mapq>=20);
+  // Two equally good hits
+  fail_unless(gt_input_map_parse_template("r1\tACGTACGT\tIIIIIIII\t2\tchr1:+:10:8,chr2:-:30:8",score_template)==0);
+  fail_unless(gt_map_score_template_mapq(score_template,score_attributes)<=3);
+  // A worse second hit (high quality mismatch) lowers the MAPQ but keeps it high
+  fail_unless(gt_input_map_parse_template("r1\tACGTACGT\tIIIIIIII\t1:1\tchr1:+:10:8,chr2:-:30:3A4",score_template)==0);
+  const uint64_t mapq = gt_map_score_template_mapq(score_template,score_attributes);
+  fail_unless(mapq>3 && mapq<unique_mapq);
+  fail_unless(gt_map_get_score(gt_alignment_get_map(gt_template_get_block(score_template,0),0))==mapq);
+}
+END_TEST
+
+Suite *gt_map_score_suite(void) {
+  Suite *s = suite_create("gt_map_score");
+
+  /* Penalties & MAPQ */
+  TCase *tc_map_score = tcase_create("Map score");
+  tcase_add_checked_fixture(tc_map_score,gt_map_score_setup,gt_map_score_teardown);
+  tcase_add_test(tc_map_score,gt_test_map_score_forward_mismatch);
+  tcase_add_test(tc_map_score,gt_test_map_score_reverse_mismatch);
+  tcase_add_test(tc_map_score,gt_test_map_score_no_qualities);
+  tcase_add_test(tc_map_score,gt_test_map_score_mapq);
+  suite_add_tcase(s,tc_map_score);
+
+  return s;
+}
@@ -10,11 +10,17 @@
 // Include Suites
 #include "gt_suite_alignment.c"
 #include "gt_suite_template_utils.c"
+#include "gt_suite_map_score.c"
+#include "gt_suite_duplicates.c"
+#include "gt_suite_inss_model.c"
 //#include "gt_suite_template.c"
 
 int main(void) {
   SRunner *sr = srunner_create(gt_alignment_suite());
   srunner_add_suite (sr, gt_template_utils_suite());
+  srunner_add_suite (sr, gt_map_score_suite());
+  srunner_add_suite (sr, gt_duplicates_suite());
+  srunner_add_suite (sr, gt_inss_model_suite());
   
   // add logging to xml
   srunner_set_xml(sr, "reports/check-test-core.xml");
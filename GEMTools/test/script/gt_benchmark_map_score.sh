@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# Throughput of the MAPQ computation against the plain parse&print loop (gt.filter)
+TIMEFORMAT=%R;
+DATASETS=${DATASETS:-../datasets}
+for file in $DATASETS/*.map
+do
+	[ -f $file ] || continue
+	FILE_SIZE=$(du -h $file | awk '{print $1}');
+	NUM_LINES=$(wc -l < $file);
+	echo "Benchmarking $file ($FILE_SIZE, $NUM_LINES lines)";
+	TIME_PARSE=$( { time ../bin/gt.filter -i $file > /dev/null; } 2>&1 );
+	TIME_MAPQ=$( { time ../bin/gt.filter -i $file --mapq > /dev/null; } 2>&1 );
+	echo "    parse+print=$TIME_PARSE s ($(awk "BEGIN{printf \"%d\",$NUM_LINES/($TIME_PARSE+0.001)}") lines/s)";
+	echo "    parse+mapq+print=$TIME_MAPQ s ($(awk "BEGIN{printf \"%d\",$NUM_LINES/($TIME_MAPQ+0.001)}") lines/s)";
+done
@@ -0,0 +1,61 @@
+#!/bin/bash
+
+# Reproducible benchmark suite. Generates a seeded synthetic dataset (SE/PE MAP, SAM & FASTQ),
+# runs the micro-benchmarks (gt_benchmark) and times the tools over it. Results are appended to a TSV report
+#   NUM_READS :: Number of reads/pairs of each dataset (default=100000)
+#   SEED :: Seed of the generator (default=1)
+#   REPETITIONS :: Repetitions of each micro-benchmark (default=3)
+TIMEFORMAT=%R;
+NUM_READS=${NUM_READS:-100000}
+SEED=${SEED:-1}
+REPETITIONS=${REPETITIONS:-3}
+THREADS=${THREADS:-$(nproc 2>/dev/null || echo 1)}
+BENCHMARK=./build/gt_benchmark
+DATASET=./build/benchmark
+REPORT=./reports/benchmark.tsv
+
+mkdir -p $DATASET ./reports
+[ -x $BENCHMARK ] || { echo "Missing $BENCHMARK (make benchmark)"; exit 1; }
+
+# Dataset
+echo "Generating dataset ($NUM_READS reads, seed=$SEED)"
+$BENCHMARK -g --seed $SEED -n $NUM_READS --reference $DATASET/ref.fa -o $DATASET/se.map || exit 1
+$BENCHMARK -g --seed $SEED -n $NUM_READS --format sam -o $DATASET/se.sam || exit 1
+$BENCHMARK -g --seed $SEED -n $NUM_READS --format fastq -o $DATASET/se.fastq || exit 1
+$BENCHMARK -g --seed $SEED -n $NUM_READS -p -o $DATASET/pe.map || exit 1
+$BENCHMARK -g --seed $SEED -n $NUM_READS -p --format sam -o $DATASET/pe.sam || exit 1
+$BENCHMARK -g --seed $SEED -n $NUM_READS -p --format fastq -o $DATASET/pe.fastq || exit 1
+
+# Report header
+{
+  echo "# date=$(date -u +%Y-%m-%dT%H:%M:%SZ) rev=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)" \
+       "host=$(hostname) nproc=$THREADS num_reads=$NUM_READS seed=$SEED"
+} > $REPORT
+
+# Micro-benchmarks
+for mode in se pe
+do
+  [ $mode == pe ] && PE_FLAG="-p" || PE_FLAG=""
+  echo "Running micro-benchmarks ($mode)"
+  $BENCHMARK --seed $SEED -n $NUM_READS $PE_FLAG -r $REPETITIONS --label $mode \
+    --parse $DATASET/$mode.map --parse $DATASET/$mode.sam --parse $DATASET/$mode.fastq | \
+    grep -v "^#" >> $REPORT || exit 1
+done
+
+# Tools
+for file in $DATASET/se.map $DATASET/pe.map
+do
+  FILE_SIZE=$(stat -c %s $file);
+  NUM_LINES=$(wc -l < $file);
+  LABEL=$(basename $file .map)
+  for tool in "gt.filter" "gt.stats -a"
+  do
+    [ -x ../bin/${tool%% *} ] || continue
+    TIME=$( { time ../bin/$tool -t $THREADS -i $file > /dev/null 2>&1; } 2>&1 );
+    awk -v name="tool.${tool%% *}" -v label=$LABEL -v n=$NUM_LINES -v b=$FILE_SIZE -v t=$TIME \
+      'BEGIN{printf "%s\t%s\t%d\t%d\t%.6f\t%.1f\t%.3f\n",name,label,n,b,t,n/(t+1e-9),b/1e6/(t+1e-9)}' >> $REPORT
+  done
+done
+
+echo "Report written to $REPORT"
+column -t -s $'\t' $REPORT 2>/dev/null || cat $REPORT
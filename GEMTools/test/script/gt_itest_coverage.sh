@@ -0,0 +1,33 @@
+#!/bin/bash
+#
+# gt.coverage on unsorted input with a tiny --max-memory (chunks spilled and merged
+# many times, few file descriptors available) must match the in-memory coverage
+#
+
+GT_COVERAGE=../bin/gt.coverage
+FILE_INPUT=build/gt_itest_coverage.map
+FILE_EXPECTED=build/gt_itest_coverage.expected
+FILE_OUTPUT=build/gt_itest_coverage.out
+
+awk 'BEGIN {
+  srand(7);
+  read="ACGTACGTACGTACGTACGTACGTACGTACGTACGT"; qualities="IIIIIIIIIIIIIIIIIIIIIIIIIIIIIIIIIIII";
+  for (i=0;i<8000;++i) printf "r%d\t%s\t%s\t1\tchr%d:+:%d:36\n",i,read,qualities,int(rand()*4)+1,int(rand()*2000000)+1;
+}' > $FILE_INPUT
+
+FAILED=0
+for FORMAT in bedgraph binary
+do
+  echo "Coverage of unsorted input ($FORMAT)"
+  $GT_COVERAGE -i $FILE_INPUT --output-format $FORMAT -o $FILE_EXPECTED || FAILED=1
+  for THREADS in 1 4
+  do
+    ( ulimit -n 64; $GT_COVERAGE -i $FILE_INPUT --output-format $FORMAT --max-memory 1 -t $THREADS -o $FILE_OUTPUT ) || FAILED=1
+    if ! cmp -s $FILE_EXPECTED $FILE_OUTPUT; then
+      echo "    --max-memory 1 -t $THREADS differs from the in-memory coverage"
+      FAILED=1
+    fi
+  done
+done
+rm -f $FILE_INPUT $FILE_EXPECTED $FILE_OUTPUT
+exit $FAILED
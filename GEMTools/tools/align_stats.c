@@ -15,6 +15,8 @@ static void usage(FILE *f)
 	fputs("  -r|--reads <reads file or file pair>\n",f);
 	fputs("  -o|--output <output stats file>\n",f);
 	fputs("  -d|--insert_dist <output insert size distribution file>\n",f);
+	fputs("  -D|--dump_stats <output file for the serialised stats> (can be merged later with --merge_stats)\n",f);
+	fputs("  -R|--merge_stats <serialised stats file list> (comma separated; merge instead of reading alignments)\n",f);
 	fputs("  -M|--min_insert <minimum insert size> (for pairing of single end files: default=0)\n",f);
 	fprintf(f,"  -m|--max_insert <maximum insert size> (for pairing of single end files: default=%d)\n",DEFAULT_MAX_INSERT);
 	fputs("  -t|--threads <number of threads>\n",f);
@@ -22,7 +24,8 @@ static void usage(FILE *f)
 	fputs("  -V|--variable  Variable length reads\n",f);
 	fputs("  -p|--paired    Paired mapping input file\n",f);
 	fputs("  -i|--ignore_id Do not attempt to parse read IDs\n",f);
-	fputs("  -m|--mmap      Mmap input files",f);
+	fputs("  -m|--mmap      Mmap input files\n",f);
+	fputs("  -P|--profile   Report throughput and time per pipeline stage\n",f);
 	fprintf(f,"  -L|--max_read_length <maximum valid read length>   (default=%u)\n",MAX_READ_LENGTH);
 	fprintf(f,"  -F|--fastq     select fastq quality coding         %s\n",DEFAULT_QUAL_OFFSET==QUAL_FASTQ?"(default)":"");
 	fprintf(f,"  -S|--solexa    select ilumina quality coding       %s\n",DEFAULT_QUAL_OFFSET==QUAL_SOLEXA?"(default)":"");
@@ -88,8 +91,6 @@ static void as_stats_free(as_stats *stats)
 		free(stats->indel_length[i]);
 		if(stats->curr_read_store[i]) {
 			free(stats->read_length_stats[i]);
-			uint64_t k;
-			for(k=0;k<stats->curr_read_store[i];k++) free(stats->base_counts_by_cycle[i][k]);
 			free(stats->base_counts_by_cycle[i]);
 		}
 	}
@@ -100,21 +101,12 @@ static void as_stats_resize(as_stats *stats,uint64_t rd,uint64_t l)
 {
 	stats->max_read_length[rd]=l;
 	if(l>=stats->curr_read_store[rd]) {
-		uint64_t i,nlen=l*1.5; // Allocate a bit more space than we need now to avoid un-necessary re-sizing in future
-		if(stats->curr_read_store[rd]) {
-			stats->read_length_stats[rd]=as_realloc(stats->read_length_stats[rd],nlen*sizeof(uint64_t));
-			stats->base_counts_by_cycle[rd]=as_realloc(stats->base_counts_by_cycle,sizeof(void *)*nlen);
-			for(i=stats->curr_read_store[rd];i<nlen;i++) {
-				stats->read_length_stats[rd][i]=0;
-				stats->base_counts_by_cycle[rd][i]=as_calloc((size_t)(MAX_QUAL+1)*5,sizeof(uint64_t));
-			}
-		} else {
-			stats->read_length_stats[rd]=as_calloc((size_t)nlen,sizeof(uint64_t));
-			stats->base_counts_by_cycle[rd]=as_malloc(sizeof(void *)*nlen);
-			for(i=0;i<nlen;i++) {
-				stats->base_counts_by_cycle[rd][i]=as_calloc((size_t)(MAX_QUAL+1)*5,sizeof(uint64_t));
-			}
-		}
+		uint64_t olen=stats->curr_read_store[rd],nlen=l*1.5; // Allocate a bit more space than we need now to avoid un-necessary re-sizing in future
+		// Counters of all the cycles are kept in a single block ([cycle*BC_CYCLE_STRIDE+qual*5+base])
+		stats->read_length_stats[rd]=as_realloc(stats->read_length_stats[rd],nlen*sizeof(uint64_t));
+		stats->base_counts_by_cycle[rd]=as_realloc(stats->base_counts_by_cycle[rd],nlen*BC_CYCLE_STRIDE*sizeof(uint64_t));
+		memset(stats->read_length_stats[rd]+olen,0,(nlen-olen)*sizeof(uint64_t));
+		memset(stats->base_counts_by_cycle[rd]+olen*BC_CYCLE_STRIDE,0,(nlen-olen)*BC_CYCLE_STRIDE*sizeof(uint64_t));
 		stats->curr_read_store[rd]=nlen;
 	}
 }
@@ -140,29 +132,33 @@ static void as_collect_stats(gt_template* template,as_stats* stats,as_param *par
 	gt_alignment *al[2];
 	char *rd[2],*ql[2];
 	uint64_t len[2];
-	register int qual_offset=param->qual_offset;
+	register const int *qual_tab=param->qual_tab;
 	// Get alignments, qualities, reads and lengths for both ends
 	for(j=0;j<nrd;j++) {
 		al[j]=gt_template_get_block(template,j);
 		rd[j]=gt_alignment_get_read(al[j]);
 		ql[j]=gt_alignment_get_qualities(al[j]);
-		len[j]=strlen(rd[j]);
+		len[j]=gt_alignment_get_read_length(al[j]);
 		// Update yield max_read_length and resize stats arrays if necessary
 		if(stats->max_read_length[j]<len[j]) as_stats_resize(stats,j,len[j]);
 		stats->read_length_stats[j][len[j]]++;
 		uint64_t i,yld=0;
-		char *p=rd[j];
-		char *q=ql[j];
-		uint64_t **bc=stats->base_counts_by_cycle[j];
+		const uint8_t *p=(uint8_t *)rd[j];
+		const uint8_t *q=(uint8_t *)ql[j];
+		int invalid=0;
+		// Check bases/qualities and count the yield (branch free)
 		for(i=0;i<len[j];i++) {
-			int base=base_tab[(int)p[i]]-1;
-			int qual=q[i]-qual_offset;
-			if(qual<0 || qual>MAX_QUAL || base<0) {
-				gt_fatal_error_msg("Illegal base or quality character '%c %c' in read\n",p[i],q[i]);
-			}
-			if(base) yld++;
-			bc[i][qual*5+base]++;
+			int base=base_tab[p[i]]-1;
+			invalid|=base|qual_tab[q[i]];
+			yld+=(base>0);
+		}
+		if(invalid<0) {
+			for(i=0;i<len[j];i++) if(base_tab[p[i]]==0 || qual_tab[q[i]]<0) break;
+			gt_fatal_error_msg("Illegal base or quality character '%c %c' in read\n",p[i],q[i]);
 		}
+		// Update the per-cycle counters
+		uint64_t *bc=stats->base_counts_by_cycle[j];
+		for(i=0;i<len[j];i++,bc+=BC_CYCLE_STRIDE) bc[qual_tab[q[i]]+base_tab[p[i]]-1]++;
 		stats->yield[j]+=yld;
 	}
 	// Filter maps (both single and paired end) to remove maps after first zero strata after the first hit
@@ -174,20 +170,20 @@ static void as_collect_stats(gt_template* template,as_stats* stats,as_param *par
 		uint64_t i,k;
 		k=gt_alignment_get_num_counters(al[j]);
 		for(i=1;i<=k;i++) {
-			uint64_t x=gt_alignment_get_counter(al[j],i);
+			uint64_t x=gt_alignment_get_counter(al[j],i-1);
 			if(x) {
 				nmaps[j]+=x;
 				max_dist[j]=i-1;
 			} else if(nmaps[j]) break;
 		}
-		if(i==k && paired_file==false) ambig[j]=true;
+		if(i>k && paired_file==false) ambig[j]=true;
 	}
 	if(nrd==2) {
 		// Paired end alignments
 		uint64_t i,k;
 		k=gt_template_get_num_counters(template);
 		for(i=1;i<=k;i++) {
-			uint64_t x=gt_template_get_counter(template,i);
+			uint64_t x=gt_template_get_counter(template,i-1);
 			if(x) {
 				nmaps[2]+=x;
 				max_dist[2]=i-1;
@@ -238,7 +234,7 @@ static void as_collect_stats(gt_template* template,as_stats* stats,as_param *par
 
 static void as_merge_stats(as_stats **st,uint64_t nt,bool paired)
 {
-	uint64_t i,j,k,k1,nr,len[2];
+	uint64_t i,j,k,nr,len[2];
 
 	nr=paired?2:1;
 	for(j=0;j<nr;j++) {
@@ -256,12 +252,11 @@ static void as_merge_stats(as_stats **st,uint64_t nt,bool paired)
 			st[0]->unique[j]+=st[i]->unique[j];
 			st[0]->ambiguous[j]+=st[i]->ambiguous[j];
 			len[j]=st[i]->max_read_length[j];
-			uint64_t **bc0=st[0]->base_counts_by_cycle[j];
-			uint64_t **bc1=st[i]->base_counts_by_cycle[j];
-			for(k=0;k<=len[j];k++) {
-				st[0]->read_length_stats[j][k]+=st[i]->read_length_stats[j][k];
-				for(k1=0;k1<5*(MAX_QUAL+1);k1++) bc0[k][k1]+=bc1[k][k1];
-			}
+			if(!st[i]->curr_read_store[j]) continue;
+			uint64_t *bc0=st[0]->base_counts_by_cycle[j];
+			uint64_t *bc1=st[i]->base_counts_by_cycle[j];
+			for(k=0;k<=len[j];k++) st[0]->read_length_stats[j][k]+=st[i]->read_length_stats[j][k];
+			for(k=0;k<(len[j]+1)*BC_CYCLE_STRIDE;k++) bc0[k]+=bc1[k];
 		}
 		for(j=0;j<3;j++) {
 			st[0]->paired_type[j]+=st[i]->paired_type[j];
@@ -275,6 +270,159 @@ static void as_merge_stats(as_stats **st,uint64_t nt,bool paired)
 	}
 }
 
+static void as_set_qual_tab(as_param *param)
+{
+	int i;
+	for(i=0;i<256;i++) {
+		int qual=i-param->qual_offset;
+		param->qual_tab[i]=(qual<0 || qual>MAX_QUAL)?-1:qual*5;
+	}
+}
+
+static void as_get_mate(as_mate *mate,gt_map *map,uint64_t *length)
+{
+	// Contig, strand and position are taken from the last block (as in gt_template_get_insert_size)
+	uint64_t l=0;
+	mate->map=map;
+	GT_BEGIN_MAP_BLOCKS_ITERATOR(map,map_it) {
+		mate->seq_name=map_it->seq_name;
+		mate->strand=map_it->strand;
+		mate->position=map_it->position;
+		l+=gt_map_get_base_length(map_it);
+	} GT_END_MAP_BLOCKS_ITERATOR;
+	*length=l;
+}
+
+static int as_cmp_mate(const void *s1,const void *s2)
+{
+	const as_mate *m1=s1,*m2=s2;
+	int64_t x=gt_string_cmp(m1->seq_name,m2->seq_name);
+	if(x) return x<0?-1:1;
+	if(m1->strand!=m2->strand) return m1->strand<m2->strand?-1:1;
+	return m1->position<m2->position?-1:(m1->position>m2->position?1:0);
+}
+
+static void as_pair_alignments(gt_template *template,gt_alignment *al1,gt_alignment *al2,gt_vector *mates,as_param *param)
+{
+	uint64_t i,n,len,max_len=0;
+	n=gt_alignment_get_num_maps(al2);
+	if(!n || !gt_alignment_get_num_maps(al1)) return;
+	// Sort the maps of the second end by contig, strand and position
+	gt_vector_reserve(mates,n,false);
+	as_mate *mate2=gt_vector_get_mem(mates,as_mate);
+	i=0;
+	GT_ALIGNMENT_ITERATE(al2,map2) {
+		as_get_mate(mate2+i,map2,&len);
+		if(len>max_len) max_len=len;
+		i++;
+	}
+	qsort(mate2,n,sizeof(as_mate),as_cmp_mate);
+	// For each map of the first end only look at the mates in the insert window
+	// (a mate with 0<=insert_size<=max_insert has its last block within [pos-max_insert-max_len-1,pos+len+max_insert+1])
+	gt_mmap_attributes attr;
+	gt_map *mmap[2];
+	as_mate key;
+	GT_ALIGNMENT_ITERATE(al1,map1) {
+		as_get_mate(&key,map1,&len);
+		uint64_t hi=key.position+len+param->max_insert+1,lo=param->max_insert+max_len+1;
+		key.position=key.position>lo?key.position-lo:0;
+		key.strand=key.strand==FORWARD?REVERSE:FORWARD;
+		uint64_t l=0,r=n;
+		while(l<r) {
+			uint64_t m=(l+r)>>1;
+			if(as_cmp_mate(mate2+m,&key)<0) l=m+1; else r=m;
+		}
+		mmap[0]=map1;
+		for(i=l;i<n && mate2[i].position<=hi && mate2[i].strand==key.strand && gt_string_equals(mate2[i].seq_name,key.seq_name);i++) {
+			mmap[1]=mate2[i].map;
+			uint64_t gt_err;
+			int64_t x=gt_template_get_insert_size(mmap,&gt_err);
+			if(gt_err==GT_TEMPLATE_INSERT_SIZE_OK && x>=param->min_insert && x<=param->max_insert) {
+				attr.distance=gt_map_get_global_distance(map1)+gt_map_get_global_distance(mmap[1]);
+				attr.score=GT_MAP_NO_SCORE;
+				gt_template_inc_counter(template,attr.distance);
+				gt_template_add_mmap_va(template,&attr,map1,mmap[1]);
+			}
+		}
+	}
+}
+
+/*
+ * Serialised stats (so results from different runs/lanes can be merged without re-reading the alignments)
+ */
+static void as_fwrite(const void *ptr,size_t size,size_t n,FILE *f)
+{
+	if(n && fwrite(ptr,size,n,f)!=n) gt_fatal_error_msg("Error writing serialised stats\n");
+}
+
+static void as_fread(void *ptr,size_t size,size_t n,FILE *f,char *name)
+{
+	if(n && fread(ptr,size,n,f)!=n) gt_fatal_error_msg("Error reading serialised stats from '%s'\n",name);
+}
+
+static void as_write_stats(as_stats *st,char *name)
+{
+	FILE *f=fopen(name,"wb");
+	if(!f) gt_fatal_error_msg("Couldn't open file '%s' for output\n",name);
+	uint32_t hdr[3]={AS_STATS_MAGIC,AS_STATS_VERSION,(st->paired?1:0)|(st->paired_file?2:0)};
+	as_fwrite(hdr,sizeof(uint32_t),3,f);
+	as_fwrite(&st->nreads,sizeof(uint64_t),1,f);
+	as_fwrite(st->yield,sizeof(uint64_t),2,f);
+	as_fwrite(st->mapped,sizeof(uint64_t),2,f);
+	as_fwrite(st->unique,sizeof(uint64_t),2,f);
+	as_fwrite(st->ambiguous,sizeof(uint64_t),2,f);
+	as_fwrite(&st->paired_mapped,sizeof(uint64_t),1,f);
+	as_fwrite(&st->paired_unique,sizeof(uint64_t),1,f);
+	as_fwrite(st->paired_type,sizeof(uint64_t),3,f);
+	as_fwrite(st->bis_stats,sizeof(uint64_t),3,f);
+	as_fwrite(st->reads_with_splitmaps,sizeof(uint64_t),3,f);
+	as_fwrite(st->reads_only_with_splitmaps,sizeof(uint64_t),3,f);
+	as_fwrite(st->max_read_length,sizeof(uint64_t),2,f);
+	uint64_t j,nr=st->paired?2:1;
+	for(j=0;j<nr;j++) {
+		if(!st->curr_read_store[j]) continue;
+		uint64_t l=st->max_read_length[j]+1;
+		as_fwrite(st->read_length_stats[j],sizeof(uint64_t),l,f);
+		as_fwrite(st->base_counts_by_cycle[j],sizeof(uint64_t),l*BC_CYCLE_STRIDE,f);
+	}
+	fclose(f);
+}
+
+static as_stats *as_read_stats(char *name)
+{
+	FILE *f=fopen(name,"rb");
+	if(!f) gt_fatal_error_msg("Couldn't open file '%s' for input\n",name);
+	uint32_t hdr[3];
+	as_fread(hdr,sizeof(uint32_t),3,f,name);
+	if(hdr[0]!=AS_STATS_MAGIC || hdr[1]!=AS_STATS_VERSION) {
+		gt_fatal_error_msg("File '%s' is not a serialised stats file (or has an incompatible version)\n",name);
+	}
+	as_stats *st=as_stats_new((hdr[2]&1)?true:false);
+	st->paired_file=(hdr[2]&2)?true:false;
+	as_fread(&st->nreads,sizeof(uint64_t),1,f,name);
+	as_fread(st->yield,sizeof(uint64_t),2,f,name);
+	as_fread(st->mapped,sizeof(uint64_t),2,f,name);
+	as_fread(st->unique,sizeof(uint64_t),2,f,name);
+	as_fread(st->ambiguous,sizeof(uint64_t),2,f,name);
+	as_fread(&st->paired_mapped,sizeof(uint64_t),1,f,name);
+	as_fread(&st->paired_unique,sizeof(uint64_t),1,f,name);
+	as_fread(st->paired_type,sizeof(uint64_t),3,f,name);
+	as_fread(st->bis_stats,sizeof(uint64_t),3,f,name);
+	as_fread(st->reads_with_splitmaps,sizeof(uint64_t),3,f,name);
+	as_fread(st->reads_only_with_splitmaps,sizeof(uint64_t),3,f,name);
+	uint64_t j,len[2],nr=st->paired?2:1;
+	as_fread(len,sizeof(uint64_t),2,f,name);
+	for(j=0;j<nr;j++) {
+		if(!len[j]) continue;
+		if(len[j]>MAX_READ_LENGTH) gt_fatal_error_msg("Corrupted serialised stats file '%s'\n",name);
+		as_stats_resize(st,j,len[j]);
+		as_fread(st->read_length_stats[j],sizeof(uint64_t),len[j]+1,f,name);
+		as_fread(st->base_counts_by_cycle[j],sizeof(uint64_t),(len[j]+1)*BC_CYCLE_STRIDE,f,name);
+	}
+	fclose(f);
+	return st;
+}
+
 static void as_print_yield_summary(FILE *f,as_stats *st,as_param *param)
 {
 	bool paired=param->paired_read;
@@ -331,8 +479,7 @@ static void as_print_yield_summary(FILE *f,as_stats *st,as_param *param)
 static void as_print_mapping_summary(FILE *f,as_stats *st,as_param *param)
 {
 	bool paired=param->paired_read;
-	bool paired_file=false; // Was the input file from a paired mapping
-	if(paired==true && !param->input_files[1]) paired_file=true;
+	bool paired_file=st->paired_file; // Was the input file from a paired mapping
 	fputs("\nSingle end mapping summary\n\n",f);
 	double z=(double)st->nreads;
 	if(paired==true) {
@@ -442,6 +589,8 @@ int main(int argc,char *argv[])
 	static struct option longopts[]={
 			{"reads",required_argument,0,'r'},
 			{"insert_dist",required_argument,0,'d'},
+			{"dump_stats",required_argument,0,'D'},
+			{"merge_stats",required_argument,0,'R'},
 			{"max_insert",required_argument,0,'m'},
 			{"min_insert",required_argument,0,'M'},
 			{"insert_dist",required_argument,0,'d'},
@@ -452,6 +601,7 @@ int main(int argc,char *argv[])
 			{"fastq",no_argument,0,'F'},
 			{"solexa",no_argument,0,'S'},
 			{"threads",required_argument,0,'t'},
+			{"profile",no_argument,0,'P'},
 			{"qual_off",required_argument,0,'q'},
 			{"output",required_argument,0,'o'},
 			{"read_length",required_argument,0,'l'},
@@ -465,10 +615,13 @@ int main(int argc,char *argv[])
 			.input_files={NULL,NULL},
 			.output_file=NULL,
 			.dist_file=NULL,
+			.dump_file=NULL,
+			.merge_files=NULL,
 			.mmap_input=false,
 			.parser_attr=GENERIC_PARSER_ATTR_DEFAULT(false),
 			.paired_read=false,
 			.ignore_id=false,
+			.profile=false,
 			.min_insert=0,
 			.max_insert=DEFAULT_MAX_INSERT,
 			.variable_read_length=false,
@@ -478,11 +631,17 @@ int main(int argc,char *argv[])
 			.qual_offset=DEFAULT_QUAL_OFFSET,
 	};
 
-	while(!err && (c=getopt_long(argc,argv,"d:t:r:o:q:m:M:l:L:x:FSVpi?",longopts,0))!=-1) {
+	while(!err && (c=getopt_long(argc,argv,"d:D:R:t:r:o:q:m:M:l:L:x:FSVpPi?",longopts,0))!=-1) {
 		switch(c) {
 		case 'd':
 			set_opt("insert_dist",&param.dist_file,optarg);
 			break;
+		case 'D':
+			set_opt("dump_stats",&param.dump_file,optarg);
+			break;
+		case 'R':
+			set_opt("merge_stats",&param.merge_files,optarg);
+			break;
 		case 'p':
 			param.paired_read=true;
 			break;
@@ -522,6 +681,9 @@ int main(int argc,char *argv[])
 		case 'i':
 			param.ignore_id=true;
 			break;
+		case 'P':
+			param.profile=true;
+			break;
 		case 't':
 			param.num_threads=atoi(optarg);
 			break;
@@ -553,9 +715,28 @@ int main(int argc,char *argv[])
 			exit(0);
 		}
 	}
-	as_stats** stats=as_malloc(param.num_threads*sizeof(void *));
-	// Do we have two map files as input (one for each read)?
-	if(param.input_files[1]) {
+	as_set_qual_tab(&param);
+	gt_profile_enable(param.profile);
+	as_stats** stats;
+	uint64_t nstats=param.num_threads;
+	if(param.merge_files) {
+		// Merge previously serialised stats
+		for(nstats=1,p=param.merge_files;(p=strchr(p,','));p++) nstats++;
+		stats=as_malloc(nstats*sizeof(void *));
+		uint64_t i;
+		for(i=0,p=param.merge_files;i<nstats;i++,p=p1+1) {
+			p1=strchr(p,',');
+			if(p1) *p1=0;
+			stats[i]=as_read_stats(p);
+			if(stats[i]->paired!=stats[0]->paired) {
+				gt_fatal_error_msg("Fatal error: serialised stats '%s' and '%s' differ in paired mode\n",p,param.merge_files);
+			}
+			if(!p1) break;
+		}
+		param.paired_read=stats[0]->paired;
+	} else if(param.input_files[1]) {
+		// Two map files as input (one for each read)
+		stats=as_malloc(nstats*sizeof(void *));
 		param.paired_read=true;
 		pthread_mutex_t mutex=PTHREAD_MUTEX_INITIALIZER;
 		gt_input_file* input_file1=gt_input_file_open(param.input_files[0],param.mmap_input);
@@ -570,6 +751,7 @@ int main(int argc,char *argv[])
 			gt_buffered_input_file* buffered_input2=gt_buffered_input_file_new(input_file2);
 			gt_status error_code;
 			gt_template *template=gt_template_new();
+			gt_vector *mates=gt_vector_new(16,sizeof(as_mate));
 			stats[tid]=as_stats_new(param.paired_read);
 			while(gt_input_map_parser_synch_blocks(buffered_input1,buffered_input2,&mutex)) {
 				error_code=gt_input_map_parser_get_template(buffered_input1,template);
@@ -592,25 +774,10 @@ int main(int argc,char *argv[])
 					gt_error_msg("Fatal ID mismatch ('%*s','%*s') parsing files '%s','%s'\n",PRIgts_content(template->tag),PRIgts_content(alignment2->tag),param.input_files[0],param.input_files[1]);
 					break;
 				}
-				gt_alignment *alignment1=gt_template_get_block(template,0);
-				gt_mmap_attributes attr;
-				gt_map *mmap[2];
-				GT_ALIGNMENT_ITERATE(alignment1,map1) {
-					mmap[0]=map1;
-					GT_ALIGNMENT_ITERATE(alignment2,map2) {
-						mmap[1]=map2;
-						uint64_t gt_err;
-						int64_t x=gt_template_get_insert_size(mmap,&gt_err);
-						if(gt_err==GT_TEMPLATE_INSERT_SIZE_OK && x>=param.min_insert && x<=param.max_insert) {
-							attr.distance=gt_map_get_global_distance(map1)+gt_map_get_global_distance(map2);
-							attr.score=GT_MAP_NO_SCORE;
-							gt_template_inc_counter(template,attr.distance+1);
-							gt_template_add_mmap_va(template,&attr,map1,map2);
-						}
-					}
-				}
+				as_pair_alignments(template,gt_template_get_block(template,0),alignment2,mates,&param);
 				as_collect_stats(template,stats[tid],&param);
 			}
+			gt_vector_delete(mates);
 			gt_template_delete(template);
 			gt_buffered_input_file_close(buffered_input1);
 			gt_buffered_input_file_close(buffered_input2);
@@ -618,6 +785,7 @@ int main(int argc,char *argv[])
 		gt_input_file_close(input_file1);
 		gt_input_file_close(input_file2);
 	} else { // Single file (could be single or paired end)
+		stats=as_malloc(nstats*sizeof(void *));
 		gt_input_file* input_file=param.input_files[0]?gt_input_file_open(param.input_files[0],param.mmap_input):gt_input_stream_open(stdin);
 #pragma omp parallel num_threads(param.num_threads)
 		{
@@ -650,9 +818,13 @@ int main(int argc,char *argv[])
 		}
 		gt_input_file_close(input_file);
 	}
-	as_merge_stats(stats,param.num_threads,param.paired_read);
+	as_merge_stats(stats,nstats,param.paired_read);
+	if(!param.merge_files) stats[0]->paired_file=(param.paired_read && !param.input_files[1]);
+	if(param.dump_file) as_write_stats(stats[0],param.dump_file);
 	as_print_stats(stats[0],&param);
 	as_stats_free(stats[0]);
 	free(stats);
+	if(param.profile) gt_profile_print(stderr);
+	gt_profile_destroy();
 	return err;
 }
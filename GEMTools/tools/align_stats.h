@@ -6,22 +6,29 @@
 #define DEFAULT_QUAL_OFFSET 33 // FASTQ quality convention
 #define MAX_QUAL 64
 #define DEFAULT_MAX_INSERT 1000
+#define BC_CYCLE_STRIDE ((MAX_QUAL+1)*5) // Counters per cycle in base_counts_by_cycle
+#define AS_STATS_MAGIC 0x54535341 // "ASST" (Serialised stats)
+#define AS_STATS_VERSION 1
 
 typedef struct {
   char *input_files[2];
   char *output_file;
   char *dist_file;
+  char *dump_file; // Serialise the (merged) stats to this file
+  char *merge_files; // Comma separated list of serialised stats to merge
   bool mmap_input;
   gt_generic_parser_attr parser_attr;
   bool paired_read;
   bool variable_read_length;
   bool ignore_id;
+  bool profile;
   uint64_t read_length[2]; // Untrimmed read length for both reads
   uint64_t max_read_length; // For sanity checking
   uint64_t min_insert; 
   uint64_t max_insert; 
   int num_threads;
   int qual_offset; // quality offset (33 for FASTQ, 64 for Illumina) 
+  int qual_tab[256]; // (quality-qual_offset)*5 or -1 if out of range
 } as_param;
 
 #define PAIR_TYPE_DS 0 // Reads on different strands, same contig
@@ -32,6 +39,13 @@ typedef struct {
 #define BIS_G2A 1
 #define BIS_LAMBDA 2
 
+typedef struct {
+  gt_map *map;
+  gt_string *seq_name;
+  gt_strand strand;
+  uint64_t position; // Position of the last block (as used by gt_template_get_insert_size)
+} as_mate;
+
 typedef struct {
   int32_t x;
   uint64_t ct[2];
@@ -78,7 +92,7 @@ typedef struct {
   uint64_t indel_stats[4];  // [rd*2+x]  x=0 INS, x=1 DEL
   uint64_t *indel_length[4]; // For insertions and deletions
   uint64_t max_indel_length;
-  uint64_t **base_counts_by_cycle[2];      // [read][cycle][qual*5+base]
+  uint64_t *base_counts_by_cycle[2];      // [read][cycle*BC_CYCLE_STRIDE+qual*5+base]
   uint64_t mm_stats[2][MAX_QUAL+1];
   uint64_t tv_stats[2][MAX_QUAL+1];
   uint64_t ts_stats[2][MAX_QUAL+1];
@@ -87,4 +101,5 @@ typedef struct {
   dist_element* insert_size; // Store insert size distribution
   loc_hash* loc_hash; // Track position and insert sizes to estimate duplicates
   bool paired;
+  bool paired_file; // Input was a paired mapping (single file)
 } as_stats;
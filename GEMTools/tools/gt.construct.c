@@ -17,12 +17,14 @@ typedef struct {
   char *name_input_file;
   char *name_output_file;
   uint64_t num_threads;
+  bool profile;
 } gem_map_filter_args;
 
 gem_map_filter_args parameters = {
     .name_input_file=NULL,
     .name_output_file=NULL,
-    .num_threads=1
+    .num_threads=1,
+    .profile=false
 };
 
 /*
@@ -319,6 +321,7 @@ void usage() {
                   "      Options::\n"
                   "        --input     <File>\n"
                   "        --output    <File>\n"
+                  "        --profile   \n"
                   "        --help|h    \n");
 }
 
@@ -559,7 +562,7 @@ void gt_load_reference__dump_it() {
 
   // Load reference
   register gt_sequence_archive* sequence_archive = gt_sequence_archive_new();
-  if (gt_input_multifasta_parser_get_archive(input_file,sequence_archive)!=GT_IFP_OK) {
+  if (gt_input_multifasta_parser_get_archive_parallel(input_file,sequence_archive,parameters.num_threads)!=GT_IFP_OK) {
     gt_error_msg("Fatal error parsing reference\n");
   }
 
@@ -670,6 +673,7 @@ void parse_arguments(int argc,char** argv) {
   struct option long_options[] = {
     { "input", required_argument, 0, 'i' },
     { "output", required_argument, 0, 'o' },
+    { "profile", no_argument, 0, 1 },
     { "help", no_argument, 0, 'h' },
     { 0, 0, 0, 0 } };
   int c,option_index;
@@ -686,6 +690,9 @@ void parse_arguments(int argc,char** argv) {
     case 'T':
       parameters.num_threads = atol(optarg);
       break;
+    case 1:
+      parameters.profile = true;
+      break;
     case 'h':
       usage();
       exit(1);
@@ -698,6 +705,7 @@ void parse_arguments(int argc,char** argv) {
 int main(int argc,char** argv) {
   // Parsing command-line options
   parse_arguments(argc,argv);
+  gt_profile_enable(parameters.profile);
 
   //
   // Load it!
@@ -720,6 +728,8 @@ int main(int argc,char** argv) {
 
   //gt_example_map_parsing();
 
+  if (parameters.profile) gt_profile_print(stderr);
+  gt_profile_destroy();
   return 0;
 }
 
@@ -0,0 +1,796 @@
+/*
+ * PROJECT: GEM-Tools library
+ * FILE: gt.coverage.c
+ * DATE: 18/10/2026
+ * AUTHOR(S): agent <agent@local>
+ * DESCRIPTION: Computes the per-base coverage of {MAP,SAM} files (bedGraph or binary RLE output)
+ */
+
+#include <getopt.h>
+#include <omp.h>
+#include <pthread.h>
+
+#include "gem_tools.h"
+
+#define GT_COVERAGE_CHUNK_BITS 16
+#define GT_COVERAGE_CHUNK_SIZE (1ull<<GT_COVERAGE_CHUNK_BITS)
+#define GT_COVERAGE_CHUNK_MASK (GT_COVERAGE_CHUNK_SIZE-1)
+#define GT_COVERAGE_MAGIC 0x56435447 // "GTCV"
+#define GT_COVERAGE_VERSION 1
+#define GT_COVERAGE_MAX_SPILL_FILES 16
+
+typedef enum { GT_COVERAGE_BEDGRAPH, GT_COVERAGE_BINARY } gt_coverage_format;
+
+typedef struct {
+  /* [I/O] */
+  char* name_input_file;
+  char* name_output_file;
+  bool mmap_input;
+  bool paired_end;
+  gt_coverage_format output_format;
+  /* [Filter] */
+  bool best_map;
+  int64_t unique_level;
+  uint64_t max_strata_after_map;
+  uint64_t max_matches;
+  bool no_split_maps;
+  /* [Misc] */
+  uint64_t max_memory;
+  uint64_t num_threads;
+  bool verbose;
+  bool profile;
+} gt_coverage_args;
+
+gt_coverage_args parameters = {
+    /* [I/O] */
+    .name_input_file=NULL,
+    .name_output_file=NULL,
+    .mmap_input=false,
+    .paired_end=false,
+    .output_format=GT_COVERAGE_BEDGRAPH,
+    /* [Filter] */
+    .best_map=false,
+    .unique_level=-1,
+    .max_strata_after_map=UINT64_MAX,
+    .max_matches=UINT64_MAX,
+    .no_split_maps=false,
+    /* [Misc] */
+    .max_memory=256,
+    .num_threads=1,
+    .verbose=false,
+    .profile=false,
+};
+
+/*
+ * Coverage of a sequence (difference array allocated in chunks as coverage shows up)
+ */
+typedef struct {
+  gt_vector* chunks; // (int32_t*) Difference array chunks (NULL if no map starts/ends within)
+  uint64_t length;   // Last covered position (exclusive)
+} gt_coverage_sequence;
+
+typedef struct {
+  gt_shash* sequences; // (gt_coverage_sequence*) Sequence name -> Coverage
+  pthread_mutex_t mutex;
+  /* Memory budget */
+  uint64_t num_chunks;    // Chunks currently allocated
+  uint64_t max_chunks;    // Chunks allowed before spilling them to disk
+  gt_vector* spill_files; // (FILE*) Spilled chunks {NAME_LENGTH,NAME,CHUNK_NUM,NUM_VALUES,VALUES} sorted by {NAME,CHUNK_NUM}
+  gt_vector* spill_values; // (gt_coverage_spill_value) Non-zero values of the chunk being spilled
+  gt_vector* free_chunks;  // (int32_t*) Zeroed chunks released by the last spill (reused)
+  /* Counters */
+  uint64_t num_templates;
+  uint64_t num_templates_used;
+  uint64_t num_segments;
+  uint64_t peak_chunks;
+  uint64_t num_spilled_chunks;
+  uint64_t num_spills;
+  uint64_t num_spill_merges;
+} gt_coverage;
+
+/*
+ * Spilled chunks only store their non-zero values (sorted by offset)
+ */
+typedef struct {
+  uint32_t offset;
+  int32_t value;
+} gt_coverage_spill_value;
+
+/*
+ * Reading cursor over a spill file (record header of the next chunk)
+ */
+typedef struct {
+  FILE* file;
+  int64_t offset;       // Offset of the current record
+  gt_string* seq_name;
+  uint64_t chunk_num;
+  uint64_t num_values;
+  gt_vector* values;    // (gt_coverage_spill_value)
+  bool eof;
+} gt_coverage_spill_cursor;
+
+/*
+ * Per-thread segment buffers (flushed into the shared coverage when full)
+ */
+typedef struct {
+  gt_shash* segments;    // (gt_vector*) Sequence name -> {begin,end} pairs (0-based, half-open)
+  gt_string* seq_name;   // Last sequence name used (cache)
+  gt_vector* last_segments;
+  uint64_t num_segments;
+  uint64_t max_segments;
+  uint64_t num_templates;
+  uint64_t num_templates_used;
+} gt_coverage_buffer;
+
+GT_INLINE gt_coverage_sequence* gt_coverage_sequence_new() {
+  gt_coverage_sequence* const sequence = malloc(sizeof(gt_coverage_sequence));
+  gt_cond_fatal_error(!sequence,MEM_HANDLER);
+  sequence->chunks = gt_vector_new(16,sizeof(int32_t*));
+  sequence->length = 0;
+  return sequence;
+}
+GT_INLINE void gt_coverage_sequence_delete(gt_coverage_sequence* const sequence) {
+  GT_VECTOR_ITERATE(sequence->chunks,chunk,chunk_pos,int32_t*) {
+    if (*chunk!=NULL) free(*chunk);
+  }
+  gt_vector_delete(sequence->chunks);
+  free(sequence);
+}
+GT_INLINE void gt_coverage_sequence_add(
+    gt_coverage* const coverage,gt_coverage_sequence* const sequence,const uint64_t position,const int32_t value) {
+  register const uint64_t chunk_num = position>>GT_COVERAGE_CHUNK_BITS;
+  register const uint64_t num_chunks = gt_vector_get_used(sequence->chunks);
+  if (chunk_num>=num_chunks) {
+    gt_vector_reserve(sequence->chunks,chunk_num+1,false);
+    register uint64_t i;
+    for (i=num_chunks;i<=chunk_num;++i) *gt_vector_get_elm(sequence->chunks,i,int32_t*) = NULL;
+    gt_vector_set_used(sequence->chunks,chunk_num+1);
+  }
+  register int32_t** const chunk = gt_vector_get_elm(sequence->chunks,chunk_num,int32_t*);
+  if (*chunk==NULL) {
+    if (gt_vector_get_used(coverage->free_chunks)>0) {
+      *chunk = *gt_vector_get_last_elm(coverage->free_chunks,int32_t*);
+      gt_vector_dec_used(coverage->free_chunks);
+    } else {
+      *chunk = calloc(GT_COVERAGE_CHUNK_SIZE,sizeof(int32_t));
+      gt_cond_fatal_error(!*chunk,MEM_ALLOC);
+    }
+    if (++coverage->num_chunks > coverage->peak_chunks) coverage->peak_chunks = coverage->num_chunks;
+  }
+  (*chunk)[position&GT_COVERAGE_CHUNK_MASK] += value;
+}
+
+GT_INLINE void gt_coverage_init(gt_coverage* const coverage,const uint64_t max_chunks) {
+  coverage->sequences = gt_shash_new();
+  pthread_mutex_init(&coverage->mutex,NULL);
+  coverage->num_chunks = 0;
+  coverage->max_chunks = max_chunks;
+  coverage->spill_files = gt_vector_new(GT_COVERAGE_MAX_SPILL_FILES,sizeof(FILE*));
+  coverage->spill_values = gt_vector_new(1024,sizeof(gt_coverage_spill_value));
+  coverage->free_chunks = gt_vector_new(16,sizeof(int32_t*));
+  coverage->num_templates = 0;
+  coverage->num_templates_used = 0;
+  coverage->num_segments = 0;
+  coverage->peak_chunks = 0;
+  coverage->num_spilled_chunks = 0;
+  coverage->num_spills = 0;
+  coverage->num_spill_merges = 0;
+}
+GT_INLINE void gt_coverage_destroy(gt_coverage* const coverage) {
+  GT_SHASH_BEGIN_ELEMENT_ITERATE(coverage->sequences,sequence,gt_coverage_sequence) {
+    gt_coverage_sequence_delete(sequence);
+  } GT_SHASH_END_ITERATE;
+  gt_shash_delete(coverage->sequences,false);
+  GT_VECTOR_ITERATE(coverage->spill_files,spill_file,spill_file_pos,FILE*) {
+    fclose(*spill_file); // Temporary files vanish on close
+  }
+  gt_vector_delete(coverage->spill_files);
+  gt_vector_delete(coverage->spill_values);
+  GT_VECTOR_ITERATE(coverage->free_chunks,free_chunk,free_chunk_pos,int32_t*) {
+    free(*free_chunk);
+  }
+  gt_vector_delete(coverage->free_chunks);
+  pthread_mutex_destroy(&coverage->mutex);
+}
+int gt_coverage_cmp_names(const void* const a,const void* const b) {
+  return strcmp(*(char**)a,*(char**)b);
+}
+GT_INLINE char** gt_coverage_get_sorted_names(gt_coverage* const coverage,uint64_t* const num_sequences) {
+  *num_sequences = gt_shash_get_num_elements(coverage->sequences);
+  char** const seq_names = malloc(GT_MAX(*num_sequences,1)*sizeof(char*));
+  gt_cond_fatal_error(!seq_names,MEM_ALLOC);
+  register uint64_t i = 0;
+  GT_SHASH_BEGIN_KEY_ITERATE(coverage->sequences,seq_name,gt_coverage_sequence) {
+    seq_names[i++] = seq_name;
+  } GT_SHASH_END_ITERATE;
+  qsort(seq_names,*num_sequences,sizeof(char*),gt_coverage_cmp_names);
+  return seq_names;
+}
+
+/*
+ * Spilling (chunks beyond the memory budget are moved into a temporary file as sparse
+ *   records; spilled difference arrays are simply added up back when the coverage is output).
+ *   Once GT_COVERAGE_MAX_SPILL_FILES are open, they are merged into one accumulated spill, so
+ *   the open files are bounded and each chunk is stored once per merged spill
+ */
+GT_INLINE void gt_coverage_fwrite(const void* const data,const size_t size,FILE* const stream) {
+  if (fwrite(data,size,1,stream)!=1) gt_fatal_error_msg("Error writing coverage output");
+}
+GT_INLINE void gt_coverage_fread(void* const data,const size_t size,FILE* const stream) {
+  if (fread(data,size,1,stream)!=1) gt_fatal_error_msg("Error reading coverage spill file");
+}
+GT_INLINE void gt_coverage_spill_write(
+    FILE* const spill_file,char* const seq_name,const uint64_t chunk_num,gt_vector* const values) {
+  const uint64_t num_values = gt_vector_get_used(values);
+  if (num_values==0) return; // No changes within the chunk
+  const uint32_t name_length = strlen(seq_name);
+  gt_coverage_fwrite(&name_length,sizeof(uint32_t),spill_file);
+  gt_coverage_fwrite(seq_name,name_length,spill_file);
+  gt_coverage_fwrite(&chunk_num,sizeof(uint64_t),spill_file);
+  gt_coverage_fwrite(&num_values,sizeof(uint64_t),spill_file);
+  gt_coverage_fwrite(gt_vector_get_mem(values,gt_coverage_spill_value),num_values*sizeof(gt_coverage_spill_value),spill_file);
+}
+GT_INLINE void gt_coverage_spill_cursor_next(gt_coverage_spill_cursor* const cursor) {
+  uint32_t name_length;
+  cursor->offset = ftell(cursor->file);
+  if (fread(&name_length,sizeof(uint32_t),1,cursor->file)!=1) {
+    cursor->eof = true;
+    return;
+  }
+  cursor->eof = false;
+  gt_string_resize(cursor->seq_name,name_length+1);
+  gt_coverage_fread(gt_string_get_string(cursor->seq_name),name_length,cursor->file);
+  gt_string_set_length(cursor->seq_name,name_length);
+  gt_string_append_eos(cursor->seq_name);
+  gt_coverage_fread(&cursor->chunk_num,sizeof(uint64_t),cursor->file);
+  gt_coverage_fread(&cursor->num_values,sizeof(uint64_t),cursor->file);
+}
+GT_INLINE void gt_coverage_spill_cursor_seek(gt_coverage_spill_cursor* const cursor,const int64_t offset) {
+  if (fseek(cursor->file,offset,SEEK_SET)!=0) gt_fatal_error_msg("Error seeking coverage spill file");
+  gt_coverage_spill_cursor_next(cursor);
+}
+GT_INLINE void gt_coverage_spill_cursor_init(gt_coverage_spill_cursor* const cursor,FILE* const file) {
+  cursor->file = file;
+  cursor->seq_name = gt_string_new(32);
+  cursor->values = gt_vector_new(1024,sizeof(gt_coverage_spill_value));
+  gt_coverage_spill_cursor_seek(cursor,0);
+}
+GT_INLINE void gt_coverage_spill_cursor_destroy(gt_coverage_spill_cursor* const cursor) {
+  gt_string_delete(cursor->seq_name);
+  gt_vector_delete(cursor->values);
+}
+GT_INLINE bool gt_coverage_spill_cursor_at(gt_coverage_spill_cursor* const cursor,char* const seq_name) {
+  return !cursor->eof && gt_streq(gt_string_get_string(cursor->seq_name),seq_name);
+}
+GT_INLINE int gt_coverage_spill_cursor_cmp(gt_coverage_spill_cursor* const a,gt_coverage_spill_cursor* const b) {
+  register const int cmp = strcmp(gt_string_get_string(a->seq_name),gt_string_get_string(b->seq_name));
+  if (cmp!=0) return cmp;
+  return (a->chunk_num<b->chunk_num) ? -1 : (a->chunk_num>b->chunk_num);
+}
+/*
+ * Adds the values of the current record to @chunk (returns them) and moves to the next record
+ */
+GT_INLINE gt_vector* gt_coverage_spill_cursor_add(gt_coverage_spill_cursor* const cursor,int32_t* const chunk) {
+  gt_vector_reserve(cursor->values,cursor->num_values,false);
+  gt_coverage_spill_value* const values = gt_vector_get_mem(cursor->values,gt_coverage_spill_value);
+  gt_coverage_fread(values,cursor->num_values*sizeof(gt_coverage_spill_value),cursor->file);
+  gt_vector_set_used(cursor->values,cursor->num_values);
+  register uint64_t i;
+  for (i=0;i<cursor->num_values;++i) chunk[values[i].offset] += values[i].value;
+  gt_coverage_spill_cursor_next(cursor);
+  return cursor->values;
+}
+int gt_coverage_cmp_offsets(const void* const a,const void* const b) {
+  register const uint32_t offset_a = *(uint32_t*)a, offset_b = *(uint32_t*)b;
+  return (offset_a<offset_b) ? -1 : (offset_a>offset_b);
+}
+GT_INLINE void gt_coverage_spill_merge(gt_coverage* const coverage) {
+  FILE* const spill_file = tmpfile();
+  if (spill_file==NULL) gt_fatal_error_msg("Unable to create coverage spill file");
+  register const uint64_t num_cursors = gt_vector_get_used(coverage->spill_files);
+  gt_coverage_spill_cursor* const cursors = malloc(num_cursors*sizeof(gt_coverage_spill_cursor));
+  int32_t* const chunk = calloc(GT_COVERAGE_CHUNK_SIZE,sizeof(int32_t));
+  gt_cond_fatal_error(!cursors || !chunk,MEM_ALLOC);
+  gt_vector* const offsets = gt_vector_new(1024,sizeof(uint32_t));
+  gt_string* const seq_name = gt_string_new(32);
+  register uint64_t i, j;
+  for (i=0;i<num_cursors;++i) {
+    gt_coverage_spill_cursor_init(cursors+i,*gt_vector_get_elm(coverage->spill_files,i,FILE*));
+  }
+  while (true) {
+    // Smallest {NAME,CHUNK_NUM} left
+    register gt_coverage_spill_cursor* next = NULL;
+    for (i=0;i<num_cursors;++i) {
+      if (!cursors[i].eof && (next==NULL || gt_coverage_spill_cursor_cmp(cursors+i,next)<0)) next = cursors+i;
+    }
+    if (next==NULL) break;
+    gt_string_copy(seq_name,next->seq_name);
+    gt_string_append_eos(seq_name);
+    register const uint64_t chunk_num = next->chunk_num;
+    // Add up the chunk (keeping the touched offsets)
+    gt_vector_clear(offsets);
+    for (i=0;i<num_cursors;++i) {
+      if (!gt_coverage_spill_cursor_at(cursors+i,gt_string_get_string(seq_name)) || cursors[i].chunk_num!=chunk_num) continue;
+      gt_vector* const values = gt_coverage_spill_cursor_add(cursors+i,chunk);
+      GT_VECTOR_ITERATE(values,value,value_pos,gt_coverage_spill_value) {
+        gt_vector_insert(offsets,value->offset,uint32_t);
+      }
+    }
+    // Write the non-zero values (and clear the chunk)
+    register uint32_t* const offset = gt_vector_get_mem(offsets,uint32_t);
+    register const uint64_t num_offsets = gt_vector_get_used(offsets);
+    qsort(offset,num_offsets,sizeof(uint32_t),gt_coverage_cmp_offsets);
+    gt_vector_clear(coverage->spill_values);
+    for (j=0;j<num_offsets;++j) {
+      if (chunk[offset[j]]==0) continue; // Cancelled out or already written
+      const gt_coverage_spill_value value = {offset[j],chunk[offset[j]]};
+      gt_vector_insert(coverage->spill_values,value,gt_coverage_spill_value);
+      chunk[offset[j]] = 0;
+    }
+    gt_coverage_spill_write(spill_file,gt_string_get_string(seq_name),chunk_num,coverage->spill_values);
+  }
+  // Replace the spill files by the merged one
+  for (i=0;i<num_cursors;++i) {
+    gt_coverage_spill_cursor_destroy(cursors+i);
+    fclose(cursors[i].file);
+  }
+  gt_vector_clear(coverage->spill_files);
+  gt_vector_insert(coverage->spill_files,spill_file,FILE*);
+  ++coverage->num_spill_merges;
+  free(cursors);
+  free(chunk);
+  gt_vector_delete(offsets);
+  gt_string_delete(seq_name);
+}
+GT_INLINE void gt_coverage_spill(gt_coverage* const coverage) {
+  if (gt_vector_get_used(coverage->spill_files)>=GT_COVERAGE_MAX_SPILL_FILES) gt_coverage_spill_merge(coverage);
+  FILE* const spill_file = tmpfile();
+  if (spill_file==NULL) gt_fatal_error_msg("Unable to create coverage spill file");
+  uint64_t num_sequences, i, j;
+  char** const seq_names = gt_coverage_get_sorted_names(coverage,&num_sequences);
+  for (i=0;i<num_sequences;++i) {
+    register gt_coverage_sequence* const sequence = gt_shash_get(coverage->sequences,seq_names[i],gt_coverage_sequence);
+    GT_VECTOR_ITERATE(sequence->chunks,chunk,chunk_pos,int32_t*) {
+      if (*chunk==NULL) continue;
+      gt_vector_clear(coverage->spill_values);
+      for (j=0;j<GT_COVERAGE_CHUNK_SIZE;++j) {
+        if ((*chunk)[j]==0) continue;
+        const gt_coverage_spill_value value = {j,(*chunk)[j]};
+        gt_vector_insert(coverage->spill_values,value,gt_coverage_spill_value);
+        (*chunk)[j] = 0;
+      }
+      gt_coverage_spill_write(spill_file,seq_names[i],chunk_pos,coverage->spill_values);
+      gt_vector_insert(coverage->free_chunks,*chunk,int32_t*);
+      *chunk = NULL;
+      ++coverage->num_spilled_chunks;
+    }
+  }
+  free(seq_names);
+  coverage->num_chunks = 0;
+  ++coverage->num_spills;
+  gt_vector_insert(coverage->spill_files,spill_file,FILE*);
+}
+
+GT_INLINE void gt_coverage_buffer_init(gt_coverage_buffer* const buffer,const uint64_t max_segments) {
+  buffer->segments = gt_shash_new();
+  buffer->seq_name = gt_string_new(32);
+  buffer->last_segments = NULL;
+  buffer->num_segments = 0;
+  buffer->max_segments = max_segments;
+  buffer->num_templates = 0;
+  buffer->num_templates_used = 0;
+}
+GT_INLINE void gt_coverage_buffer_destroy(gt_coverage_buffer* const buffer) {
+  GT_SHASH_BEGIN_ELEMENT_ITERATE(buffer->segments,segments,gt_vector) {
+    gt_vector_delete(segments);
+  } GT_SHASH_END_ITERATE;
+  gt_shash_delete(buffer->segments,false);
+  gt_string_delete(buffer->seq_name);
+}
+GT_INLINE void gt_coverage_buffer_flush(gt_coverage_buffer* const buffer,gt_coverage* const coverage) {
+  pthread_mutex_lock(&coverage->mutex);
+  GT_SHASH_BEGIN_ITERATE(buffer->segments,seq_name,segments,gt_vector) {
+    if (gt_vector_get_used(segments)==0) continue;
+    gt_coverage_sequence* sequence = gt_shash_get(coverage->sequences,seq_name,gt_coverage_sequence);
+    if (sequence==NULL) {
+      sequence = gt_coverage_sequence_new();
+      gt_shash_insert(coverage->sequences,seq_name,sequence,gt_coverage_sequence);
+    }
+    register const uint64_t num_segments = gt_vector_get_used(segments)/2;
+    register uint64_t* const segment = gt_vector_get_mem(segments,uint64_t);
+    register uint64_t i;
+    for (i=0;i<num_segments;++i) {
+      gt_coverage_sequence_add(coverage,sequence,segment[2*i],+1);
+      gt_coverage_sequence_add(coverage,sequence,segment[2*i+1],-1);
+      if (segment[2*i+1]>sequence->length) sequence->length = segment[2*i+1];
+      if (coverage->num_chunks>=coverage->max_chunks) gt_coverage_spill(coverage);
+    }
+    coverage->num_segments += num_segments;
+    gt_vector_clear(segments);
+  } GT_SHASH_END_ITERATE;
+  coverage->num_templates += buffer->num_templates;
+  coverage->num_templates_used += buffer->num_templates_used;
+  pthread_mutex_unlock(&coverage->mutex);
+  buffer->num_segments = 0;
+  buffer->num_templates = 0;
+  buffer->num_templates_used = 0;
+}
+GT_INLINE void gt_coverage_buffer_add_map(
+    gt_coverage_buffer* const buffer,gt_coverage* const coverage,gt_map* const map) {
+  GT_BEGIN_MAP_BLOCKS_ITERATOR(map,map_it) {
+    // Locate the segments of the sequence (cached)
+    if (buffer->last_segments==NULL || !gt_string_equals(buffer->seq_name,gt_map_get_string_seq_name(map_it))) {
+      gt_string_copy(buffer->seq_name,gt_map_get_string_seq_name(map_it));
+      register char* const seq_name = gt_string_get_string(buffer->seq_name);
+      buffer->last_segments = gt_shash_get(buffer->segments,seq_name,gt_vector);
+      if (buffer->last_segments==NULL) {
+        buffer->last_segments = gt_vector_new(1024,sizeof(uint64_t));
+        gt_shash_insert(buffer->segments,seq_name,buffer->last_segments,gt_vector);
+      }
+    }
+    // Add segment [position-1,position-1+length)
+    register const uint64_t begin = gt_map_get_position_(map_it)-1;
+    register const uint64_t end = begin+gt_map_get_length(map_it);
+    if (end>begin) {
+      gt_vector_reserve_additional(buffer->last_segments,2);
+      register uint64_t* const segment = gt_vector_get_free_elm(buffer->last_segments,uint64_t);
+      segment[0] = begin; segment[1] = end;
+      gt_vector_add_used(buffer->last_segments,2);
+      if (++buffer->num_segments >= buffer->max_segments) gt_coverage_buffer_flush(buffer,coverage);
+    }
+  } GT_END_MAP_BLOCKS_ITERATOR;
+}
+
+/*
+ * Filtering (uniqueness & strata, as computed from the counters)
+ */
+GT_INLINE bool gt_coverage_get_max_distance(gt_template* const template,uint64_t* const max_distance) {
+  register gt_vector* const counters = gt_template_get_counters_vector(template);
+  // Uniqueness
+  if (parameters.unique_level>=0) {
+    register const int64_t uniq_degree = gt_counters_get_uniq_degree(counters);
+    if (uniq_degree==GT_NO_STRATA || uniq_degree<parameters.unique_level) return false;
+  }
+  // Strata
+  *max_distance = UINT64_MAX;
+  if (parameters.max_strata_after_map<UINT64_MAX) {
+    register const int64_t min_matching_strata = gt_counters_get_min_matching_strata(counters);
+    if (min_matching_strata==GT_NO_STRATA) return false;
+    *max_distance = (min_matching_strata-1)+parameters.max_strata_after_map;
+  }
+  if (parameters.max_matches<UINT64_MAX) {
+    uint64_t num_strata;
+    gt_counters_calculate_num_maps(counters,0,parameters.max_matches,&num_strata,NULL);
+    if (num_strata==0) return false;
+    *max_distance = GT_MIN(*max_distance,num_strata-1);
+  }
+  return true;
+}
+GT_INLINE bool gt_coverage_is_map_allowed(gt_map* const map) {
+  return !parameters.no_split_maps || gt_map_get_num_blocks(map)==1;
+}
+GT_INLINE void gt_coverage_add_template(
+    gt_coverage_buffer* const buffer,gt_coverage* const coverage,gt_template* const template) {
+  ++buffer->num_templates;
+  uint64_t max_distance;
+  if (!gt_coverage_get_max_distance(template,&max_distance)) return;
+  register bool used = false;
+  register const uint64_t num_blocks = gt_template_get_num_blocks(template);
+  if (num_blocks==1) {
+    register gt_alignment* const alignment = gt_template_get_block(template,0);
+    GT_ALIGNMENT_ITERATE(alignment,map) {
+      if (gt_map_get_global_distance(map)>max_distance || !gt_coverage_is_map_allowed(map)) continue;
+      gt_coverage_buffer_add_map(buffer,coverage,map);
+      used = true;
+      if (parameters.best_map) break;
+    }
+  } else {
+    GT_TEMPLATE__ATTR_ITERATE_(template,mmap,mmap_attr) {
+      if (mmap_attr->distance>max_distance) continue;
+      register uint64_t i;
+      for (i=0;i<num_blocks;++i) if (!gt_coverage_is_map_allowed(mmap[i])) break;
+      if (i<num_blocks) continue;
+      for (i=0;i<num_blocks;++i) gt_coverage_buffer_add_map(buffer,coverage,mmap[i]);
+      used = true;
+      if (parameters.best_map) break;
+    }
+  }
+  if (used) ++buffer->num_templates_used;
+}
+
+/*
+ * Output
+ *   bedGraph: Non-zero coverage runs (0-based, half-open)
+ *   Binary: MAGIC,VERSION,NUM_SEQUENCES {NAME_LENGTH,NAME,LENGTH,NUM_RUNS {RUN_LENGTH,COVERAGE}*}*
+ *           (All fields uint32_t but LENGTH & NUM_RUNS (uint64_t). Runs cover [0,LENGTH) including zero-coverage runs)
+ */
+GT_INLINE uint64_t gt_coverage_output_run(
+    FILE* const stream,char* const seq_name,const uint64_t begin,const uint64_t end,const int32_t value,const bool emit) {
+  if (parameters.output_format==GT_COVERAGE_BEDGRAPH) {
+    if (value>0 && emit) fprintf(stream,"%s\t%"PRIu64"\t%"PRIu64"\t%"PRId32"\n",seq_name,begin,end,value);
+    return 1;
+  } else {
+    register uint64_t length = end-begin, num_runs = 0;
+    while (length>0) {
+      const uint32_t run[2] = {GT_MIN(length,UINT32_MAX),(uint32_t)value};
+      if (emit) gt_coverage_fwrite(run,sizeof(run),stream);
+      length -= run[0];
+      ++num_runs;
+    }
+    return num_runs;
+  }
+}
+/*
+ * Adds up the in-memory and the spilled chunks of the sequence, chunk by chunk, and outputs
+ * the coverage runs (just counted if !@emit). Returns the number of runs
+ */
+GT_INLINE uint64_t gt_coverage_output_runs(
+    FILE* const stream,char* const seq_name,gt_coverage_sequence* const sequence,
+    gt_coverage_spill_cursor* const cursors,const uint64_t num_cursors,int32_t* const chunk,const bool emit) {
+  register const uint64_t num_chunks = gt_vector_get_used(sequence->chunks);
+  register uint64_t chunk_num = 0, run_begin = 0, num_runs = 0, i, j;
+  register int32_t value = 0;
+  while (true) {
+    // Next chunk with changes (in memory or spilled)
+    while (chunk_num<num_chunks && *gt_vector_get_elm(sequence->chunks,chunk_num,int32_t*)==NULL) ++chunk_num;
+    register uint64_t next_chunk_num = (chunk_num<num_chunks) ? chunk_num : UINT64_MAX;
+    for (i=0;i<num_cursors;++i) {
+      if (gt_coverage_spill_cursor_at(cursors+i,seq_name)) next_chunk_num = GT_MIN(next_chunk_num,cursors[i].chunk_num);
+    }
+    if (next_chunk_num==UINT64_MAX) break;
+    // Add up the chunk
+    if (chunk_num==next_chunk_num) {
+      memcpy(chunk,*gt_vector_get_elm(sequence->chunks,chunk_num,int32_t*),GT_COVERAGE_CHUNK_SIZE*sizeof(int32_t));
+      ++chunk_num;
+    } else {
+      memset(chunk,0,GT_COVERAGE_CHUNK_SIZE*sizeof(int32_t));
+    }
+    for (i=0;i<num_cursors;++i) {
+      if (!gt_coverage_spill_cursor_at(cursors+i,seq_name) || cursors[i].chunk_num!=next_chunk_num) continue;
+      gt_coverage_spill_cursor_add(cursors+i,chunk);
+    }
+    // Output the runs ending within the chunk
+    register const uint64_t offset = next_chunk_num<<GT_COVERAGE_CHUNK_BITS;
+    for (j=0;j<GT_COVERAGE_CHUNK_SIZE;++j) {
+      if (chunk[j]==0) continue;
+      if (offset+j>run_begin) num_runs += gt_coverage_output_run(stream,seq_name,run_begin,offset+j,value,emit);
+      run_begin = offset+j;
+      value += chunk[j];
+    }
+  }
+  return num_runs;
+}
+GT_INLINE void gt_coverage_output_sequence(
+    FILE* const stream,char* const seq_name,gt_coverage_sequence* const sequence,
+    gt_coverage_spill_cursor* const cursors,const uint64_t num_cursors,int32_t* const chunk) {
+  if (parameters.output_format==GT_COVERAGE_BINARY) {
+    // Count the runs first (binary header), then rewind the spill files
+    register uint64_t i;
+    int64_t* const offsets = malloc(GT_MAX(num_cursors,1)*sizeof(int64_t));
+    gt_cond_fatal_error(!offsets,MEM_ALLOC);
+    for (i=0;i<num_cursors;++i) offsets[i] = cursors[i].offset;
+    const uint64_t num_runs = gt_coverage_output_runs(stream,seq_name,sequence,cursors,num_cursors,chunk,false);
+    for (i=0;i<num_cursors;++i) gt_coverage_spill_cursor_seek(cursors+i,offsets[i]);
+    free(offsets);
+    const uint32_t name_length = strlen(seq_name);
+    gt_coverage_fwrite(&name_length,sizeof(uint32_t),stream);
+    gt_coverage_fwrite(seq_name,name_length,stream);
+    gt_coverage_fwrite(&sequence->length,sizeof(uint64_t),stream);
+    gt_coverage_fwrite(&num_runs,sizeof(uint64_t),stream);
+  }
+  gt_coverage_output_runs(stream,seq_name,sequence,cursors,num_cursors,chunk,true);
+}
+GT_INLINE void gt_coverage_output(gt_coverage* const coverage) {
+  FILE* const stream = (parameters.name_output_file==NULL) ? stdout : fopen(parameters.name_output_file,"w");
+  if (stream==NULL) gt_fatal_error_msg("Unable to open output file '%s'",parameters.name_output_file);
+  // Sort sequences by name (as the spilled chunks)
+  uint64_t num_sequences, i;
+  char** const seq_names = gt_coverage_get_sorted_names(coverage,&num_sequences);
+  // Open spill files
+  register const uint64_t num_cursors = gt_vector_get_used(coverage->spill_files);
+  gt_coverage_spill_cursor* const cursors = malloc(GT_MAX(num_cursors,1)*sizeof(gt_coverage_spill_cursor));
+  gt_cond_fatal_error(!cursors,MEM_ALLOC);
+  for (i=0;i<num_cursors;++i) {
+    gt_coverage_spill_cursor_init(cursors+i,*gt_vector_get_elm(coverage->spill_files,i,FILE*));
+  }
+  int32_t* const chunk = malloc(GT_COVERAGE_CHUNK_SIZE*sizeof(int32_t));
+  gt_cond_fatal_error(!chunk,MEM_ALLOC);
+  // Output
+  if (parameters.output_format==GT_COVERAGE_BINARY) {
+    const uint32_t header[3] = {GT_COVERAGE_MAGIC,GT_COVERAGE_VERSION,num_sequences};
+    gt_coverage_fwrite(header,sizeof(header),stream);
+  }
+  for (i=0;i<num_sequences;++i) {
+    register gt_coverage_sequence* const sequence = gt_shash_get(coverage->sequences,seq_names[i],gt_coverage_sequence);
+    gt_coverage_output_sequence(stream,seq_names[i],sequence,cursors,num_cursors,chunk);
+  }
+  // Free
+  for (i=0;i<num_cursors;++i) gt_coverage_spill_cursor_destroy(cursors+i);
+  free(cursors);
+  free(chunk);
+  free(seq_names);
+  if (stream!=stdout) fclose(stream);
+}
+
+/*
+ * Coverage
+ */
+void gt_coverage_parallel_generate() {
+  // Open input file
+  gt_input_file* input_file = (parameters.name_input_file==NULL) ?
+      gt_input_stream_open(stdin) : gt_input_file_open(parameters.name_input_file,parameters.mmap_input);
+  // Memory budget (A quarter for the per-thread segment buffers, the rest for the coverage chunks)
+  register const uint64_t max_memory = parameters.max_memory<<20;
+  register const uint64_t max_segments =
+      GT_MAX((max_memory/4)/(parameters.num_threads*2*sizeof(uint64_t)),1024);
+  register const uint64_t max_chunks =
+      GT_MAX((max_memory-max_memory/4)/(GT_COVERAGE_CHUNK_SIZE*sizeof(int32_t)),4);
+
+  gt_coverage coverage;
+  gt_coverage_init(&coverage,max_chunks);
+  // Parallel reading+process
+  #pragma omp parallel num_threads(parameters.num_threads)
+  {
+    gt_buffered_input_file* buffered_input = gt_buffered_input_file_new(input_file);
+    gt_generic_parser_attr generic_parser_attr = GENERIC_PARSER_ATTR_DEFAULT(parameters.paired_end);
+    gt_coverage_buffer buffer;
+    gt_coverage_buffer_init(&buffer,max_segments);
+    gt_status error_code;
+    gt_template *template = gt_template_new();
+    while ((error_code=gt_input_generic_parser_get_template(buffered_input,template,&generic_parser_attr))) {
+      if (error_code!=GT_IMP_OK) {
+        gt_error_msg("Fatal error parsing file '%s':%"PRIu64"\n",parameters.name_input_file,buffered_input->current_line_num-1);
+        continue;
+      }
+      gt_coverage_add_template(&buffer,&coverage,template);
+    }
+    gt_coverage_buffer_flush(&buffer,&coverage);
+    // Clean
+    gt_coverage_buffer_destroy(&buffer);
+    gt_template_delete(template);
+    gt_buffered_input_file_close(buffered_input);
+  }
+  gt_input_file_close(input_file);
+
+  // Output coverage
+  gt_coverage_output(&coverage);
+  if (parameters.verbose) {
+    fprintf(stderr,"[COVERAGE]\n");
+    fprintf(stderr,"  --> Templates %"PRIu64" (Used %"PRIu64")\n",coverage.num_templates,coverage.num_templates_used);
+    fprintf(stderr,"  --> Segments %"PRIu64"\n",coverage.num_segments);
+    fprintf(stderr,"  --> Sequences %"PRIu64" (Peak chunks %"PRIu64", %"PRIu64" MB)\n",
+        gt_shash_get_num_elements(coverage.sequences),coverage.peak_chunks,
+        (uint64_t)((coverage.peak_chunks*GT_COVERAGE_CHUNK_SIZE*sizeof(int32_t))>>20));
+    fprintf(stderr,"  --> Spilled chunks %"PRIu64" (%"PRIu64" spills, %"PRIu64" merges)\n",
+        coverage.num_spilled_chunks,coverage.num_spills,coverage.num_spill_merges);
+  }
+  gt_coverage_destroy(&coverage);
+}
+
+void usage() {
+  fprintf(stderr, "USE: ./gt.coverage [ARGS]...\n"
+                  "         [I/O]\n"
+                  "           --input|-i [FILE]\n"
+                  "           --output|-o [FILE]\n"
+                  "           --mmap-input\n"
+                  "           --paired-end|p\n"
+                  "           --output-format bedgraph|binary (default=bedgraph)\n"
+                  "         [Filter]\n"
+                  "           --best-map\n"
+                  "           --unique-level <number>\n"
+                  "           --max-strata-after-map <number>\n"
+                  "           --max-matches <number>\n"
+                  "           --no-split-maps\n"
+                  "         [Misc]\n"
+                  "           --max-memory <MB> (segment buffers & coverage arrays, default=256)\n"
+                  "           --threads|t\n"
+                  "           --verbose|v\n"
+                  "           --profile\n"
+                  "           --help|h\n");
+}
+
+void parse_arguments(int argc,char** argv) {
+  struct option long_options[] = {
+    /* [I/O] */
+    { "input", required_argument, 0, 'i' },
+    { "output", required_argument, 0, 'o' },
+    { "mmap-input", no_argument, 0, 1 },
+    { "paired-end", no_argument, 0, 'p' },
+    { "output-format", required_argument, 0, 2 },
+    /* [Filter] */
+    { "best-map", no_argument, 0, 10 },
+    { "unique-level", required_argument, 0, 11 },
+    { "max-strata-after-map", required_argument, 0, 12 },
+    { "max-matches", required_argument, 0, 13 },
+    { "no-split-maps", no_argument, 0, 14 },
+    /* [Misc] */
+    { "max-memory", required_argument, 0, 20 },
+    { "threads", required_argument, 0, 't' },
+    { "verbose", no_argument, 0, 'v' },
+    { "profile", no_argument, 0, 21 },
+    { "help", no_argument, 0, 'h' },
+    { 0, 0, 0, 0 } };
+  int c,option_index;
+  while (1) {
+    c=getopt_long(argc,argv,"i:o:pt:vh",long_options,&option_index);
+    if (c==-1) break;
+    switch (c) {
+    /* [I/O] */
+    case 'i':
+      parameters.name_input_file = optarg;
+      break;
+    case 'o':
+      parameters.name_output_file = optarg;
+      break;
+    case 1:
+      parameters.mmap_input = true;
+      break;
+    case 'p':
+      parameters.paired_end = true;
+      break;
+    case 2:
+      if (gt_streq(optarg,"bedgraph")) {
+        parameters.output_format = GT_COVERAGE_BEDGRAPH;
+      } else if (gt_streq(optarg,"binary")) {
+        parameters.output_format = GT_COVERAGE_BINARY;
+      } else {
+        gt_fatal_error_msg("Output format not recognized '%s'\n",optarg);
+      }
+      break;
+    /* [Filter] */
+    case 10:
+      parameters.best_map = true;
+      break;
+    case 11:
+      parameters.unique_level = atoll(optarg);
+      break;
+    case 12:
+      parameters.max_strata_after_map = atoll(optarg);
+      break;
+    case 13:
+      parameters.max_matches = atoll(optarg);
+      break;
+    case 14:
+      parameters.no_split_maps = true;
+      break;
+    /* [Misc] */
+    case 20:
+      parameters.max_memory = atoll(optarg);
+      break;
+    case 't':
+      parameters.num_threads = atol(optarg);
+      break;
+    case 'v':
+      parameters.verbose = true;
+      break;
+    case 21:
+      parameters.profile = true;
+      break;
+    case 'h':
+      usage();
+      exit(1);
+    case '?':
+    default:
+      gt_fatal_error_msg("Option not recognized");
+    }
+  }
+  /*
+   * Parameters check
+   */
+  if (parameters.num_threads==0) gt_fatal_error_msg("Number of threads must be greater than zero");
+}
+
+int main(int argc,char** argv) {
+  // Parsing command-line options
+  parse_arguments(argc,argv);
+  gt_profile_enable(parameters.profile);
+
+  // Coverage !
+  gt_coverage_parallel_generate();
+
+  // Profile
+  if (parameters.profile) gt_profile_print(stderr);
+  gt_profile_destroy();
+
+  return 0;
+}
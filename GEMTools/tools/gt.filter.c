@@ -34,9 +34,14 @@ typedef struct {
   uint64_t min_levenshtein_distance;
   uint64_t max_levenshtein_distance;
   gt_vector* filter_map_ids;
+  uint64_t min_mapq;
   /* Filter-pairs */
   int64_t max_inss;
   int64_t min_inss;
+  bool inss_quantiles;
+  double inss_min_quantile;
+  double inss_max_quantile;
+  uint64_t inss_model_templates;
   bool filter_by_strand;
   bool allow_strand_rf;
   bool allow_strand_fr;
@@ -46,12 +51,21 @@ typedef struct {
   bool mismatch_recovery;
   bool realign_hamming;
   bool realign_levenshtein;
+  /* Trimming */
+  gt_dna_read_trim_attributes* trim_attributes;
+  uint64_t trim_min_length;
+  /* Output */
+  bool output_binary;
+  gt_output_binary_attributes* output_binary_attributes;
+  bool mapq;
+  gt_map_score_attributes* map_score_attributes;
   /* Hidden */
   bool error_plot;
   bool insert_size_plot;
   /* Misc */
   uint64_t num_threads;
   bool verbose;
+  bool profile;
 } gt_stats_args;
 
 gt_stats_args parameters = {
@@ -77,9 +91,14 @@ gt_stats_args parameters = {
     .min_levenshtein_distance=0,
     .max_levenshtein_distance=UINT64_MAX,
     .filter_map_ids=NULL,
+    .min_mapq=0,
     /* Filter-pairs */
     .max_inss=INT64_MAX,
     .min_inss=INT64_MIN,
+    .inss_quantiles=false,
+    .inss_min_quantile=0.0,
+    .inss_max_quantile=1.0,
+    .inss_model_templates=100000,
     .filter_by_strand=false,
     .allow_strand_rf=false,
     .allow_strand_fr=false,
@@ -89,12 +108,21 @@ gt_stats_args parameters = {
     .mismatch_recovery=false,
     .realign_hamming=false,
     .realign_levenshtein=false,
+    /* Trimming */
+    .trim_attributes=NULL,
+    .trim_min_length=10,
+    /* Output */
+    .output_binary=false,
+    .output_binary_attributes=NULL,
+    .mapq=false,
+    .map_score_attributes=NULL,
     /* Hidden */
     .error_plot = false,
     .insert_size_plot = false,
     /* Misc */
     .num_threads=1,
     .verbose=false,
+    .profile=false,
 };
 
 void gt_filter_delete_map_ids(gt_vector* filter_map_ids) {
@@ -225,7 +253,7 @@ void gt_filter_open_sequence_archive(gt_sequence_archive** sequence_archive) {
   *sequence_archive = gt_sequence_archive_new();
   register gt_input_file* const reference_file = gt_input_file_open(parameters.name_reference_file,false);
   fprintf(stderr,"Loading reference file ...");
-  if (gt_input_multifasta_parser_get_archive(reference_file,*sequence_archive)!=GT_IFP_OK) {
+  if (gt_input_multifasta_parser_get_archive_parallel(reference_file,*sequence_archive,parameters.num_threads)!=GT_IFP_OK) {
     fprintf(stderr,"\n");
     gt_fatal_error_msg("Error parsing reference file '%s'\n",parameters.name_reference_file);
   }
@@ -233,6 +261,44 @@ void gt_filter_open_sequence_archive(gt_sequence_archive** sequence_archive) {
   fprintf(stderr," done! \n");
 }
 
+/*
+ * Insert size range out of the quantiles of the model computed on the first templates of the input
+ */
+void gt_filter_estimate_inss_range() {
+  if (parameters.name_input_file==NULL) {
+    gt_fatal_error_msg("Insert size quantiles require an input file (--input)");
+  }
+  gt_input_file* const input_file = gt_input_file_open(parameters.name_input_file,parameters.mmap_input);
+  gt_buffered_input_file* const buffered_input = gt_buffered_input_file_new(input_file);
+  gt_generic_parser_attr generic_parser_attr = GENERIC_PARSER_ATTR_DEFAULT(parameters.paired_end);
+  gt_inss_model* const inss_model = gt_inss_model_new(parameters.inss_model_templates);
+  gt_template* const template = gt_template_new();
+  gt_status error_code;
+  while (!gt_inss_model_is_complete(inss_model) &&
+         (error_code=gt_input_generic_parser_get_template(buffered_input,template,&generic_parser_attr))) {
+    if (error_code!=GT_IMP_OK) {
+      gt_error_msg("Fatal error parsing file '%s':%"PRIu64"\n",parameters.name_input_file,buffered_input->current_line_num-1);
+    }
+    gt_inss_model_add_template(inss_model,template);
+  }
+  // Set the range wrt the dominant orientation
+  register const gt_inss_orientation orientation = gt_inss_model_get_dominant_orientation(inss_model);
+  if (gt_inss_model_get_num_samples(inss_model,orientation)==0) {
+    gt_fatal_error_msg("Insert size quantiles: no paired maps found on the first %"PRIu64" templates",parameters.inss_model_templates);
+  }
+  parameters.min_inss = gt_inss_model_get_quantile(inss_model,orientation,parameters.inss_min_quantile);
+  parameters.max_inss = gt_inss_model_get_quantile(inss_model,orientation,parameters.inss_max_quantile);
+  if (parameters.verbose) {
+    gt_inss_model_print(stderr,inss_model);
+    fprintf(stderr,"  --> InsertSize.Range [%"PRId64",%"PRId64"]\n",parameters.min_inss,parameters.max_inss);
+  }
+  // Clean
+  gt_template_delete(template);
+  gt_inss_model_delete(inss_model);
+  gt_buffered_input_file_close(buffered_input);
+  gt_input_file_close(input_file);
+}
+
 void gt_filter_read__write() {
   // Open file IN/OUT
   gt_input_file* input_file = (parameters.name_input_file==NULL) ?
@@ -266,6 +332,11 @@ void gt_filter_read__write() {
         gt_error_msg("Fatal error parsing file '%s':%"PRIu64"\n",parameters.name_input_file,buffered_input->current_line_num-1);
       }
 
+      // Trim reads (quality/adapters/poly-A/N)
+      if (parameters.trim_attributes!=NULL) {
+        gt_template_auto_trim(template,parameters.trim_attributes,parameters.trim_min_length,false);
+      }
+
       // Consider mapped/unmapped
       register const bool is_mapped = gt_template_is_mapped(template);
       if (parameters.mapped && !is_mapped) continue;
@@ -297,8 +368,17 @@ void gt_filter_read__write() {
           gt_template_recalculate_counters(template);
         }
 
+        // Compute MAPQ (output as the map scores)
+        if (parameters.mapq) {
+          register const uint64_t mapq = gt_map_score_template_mapq(template,parameters.map_score_attributes);
+          if (mapq<parameters.min_mapq) continue;
+        }
+
         // Print template
-        if (gt_output_map_bofprint_template(buffered_output,template,&output_attributes)) {
+        register const gt_status print_code = (parameters.output_binary) ?
+            gt_output_binary_bofprint_template(buffered_output,template,parameters.output_binary_attributes) :
+            gt_output_map_bofprint_template(buffered_output,template,&output_attributes);
+        if (print_code) {
           gt_error_msg("Fatal error outputting read '"PRIgts"'(InputLine:%"PRIu64")\n",
               PRIgts_content(gt_template_get_string_tag(template)),buffered_input->current_line_num-1);
         }
@@ -314,6 +394,9 @@ void gt_filter_read__write() {
   // Release archive & Clean
   if (sequence_archive != NULL) gt_sequence_archive_delete(sequence_archive);
   gt_filter_delete_map_ids(parameters.filter_map_ids);
+  if (parameters.trim_attributes!=NULL) gt_dna_read_trim_attributes_delete(parameters.trim_attributes);
+  gt_output_binary_attributes_delete(parameters.output_binary_attributes);
+  gt_map_score_attributes_delete(parameters.map_score_attributes);
   gt_input_file_close(input_file);
   gt_output_file_close(output_file);
 }
@@ -337,21 +420,38 @@ void usage() {
                   "           --min-levenshtein-error <number>\n"
                   "           --max-levenshtein-error <number>\n"
                   "           --map-id [SequenceId],... (Eg 'Chr1','Chr2')\n"
+                  "           --min-mapq <number> (implies --mapq)\n"
                   "         [Filter-pairs]\n"
                   "           --pair-strandness [COMB],...\n"
                   "               [COMB] := 'FR'|'RF'|'FF'|'RR'\n"
                   "           --min-inss <number>\n"
                   "           --max-inss <number>\n"
+                  "           --inss-quantiles <low>,<high> (Eg '0.01,0.99'. Range estimated on the first templates)\n"
+                  "           --inss-model-templates <number> (default=100000)\n"
                   "         [Filter-Realign]\n"
                   "           --mismatch-recovery\n"
                   "           --hamming-realign\n"
                   "           --levenshtein-realign\n"
-//                  "         [Output]\n"
+                  "         [Trimming]\n"
+                  "           --quality-trim <quality> (Phred, BWA-like 3'-end trimming)\n"
+                  "           --qualities-offset 33|64 (default=33)\n"
+                  "           --adapter [SEQUENCE],... (3'-end adapter clipping)\n"
+                  "           --adapter-min-overlap <number> (default=%d)\n"
+                  "           --adapter-error-rate <float> (default=%.2f)\n"
+                  "           --poly-a <number> (min poly-A tail length to be clipped)\n"
+                  "           --trim-n\n"
+                  "           --trim-min-length <number> (default=10)\n"
+                  "         [Output]\n"
+                  "           --output-binary (packed format for intermediate files, read back transparently)\n"
+                  "           --binned-qualities (lossy Illumina 8-level binning, requires --output-binary)\n"
+                  "           --mapq (compute the MAPQ of each map, output as the map score)\n"
 //                  "           --display-pretty\n"
                   "         [Misc]\n"
                   "           --threads|t\n"
                   "           --verbose|v\n"
-                  "           --help|h\n");
+                  "           --profile\n"
+                  "           --help|h\n",
+                  GT_DNA_READ_TRIM_ADAPTER_MIN_OVERLAP,GT_DNA_READ_TRIM_ADAPTER_MAX_ERROR_RATE);
 }
 
 void gt_filter_get_argument_pair_strandness(char* const strandness_opt) {
@@ -391,6 +491,15 @@ void gt_filter_get_argument_map_id(char* const strandness_opt) {
   }
 }
 
+void gt_filter_get_argument_adapters(char* const adapters_opt) {
+  char *opt;
+  opt = strtok(adapters_opt,",");
+  while (opt!=NULL) {
+    gt_dna_read_trim_attributes_add_adapter(parameters.trim_attributes,opt);
+    opt = strtok(NULL,","); // Reload
+  }
+}
+
 void parse_arguments(int argc,char** argv) {
   struct option long_options[] = {
     /* I/O */
@@ -412,23 +521,43 @@ void parse_arguments(int argc,char** argv) {
     { "min-levenshtein-error", required_argument, 0, 11 },
     { "max-levenshtein-error", required_argument, 0, 12 },
     { "map-id", required_argument, 0, 13 },
+    { "min-mapq", required_argument, 0, 14 },
     /* Filter-pairs */
     { "pair-strandness", required_argument, 0, 30 },
     { "min-inss", required_argument, 0, 31 },
     { "max-inss", required_argument, 0, 32 },
+    { "inss-quantiles", required_argument, 0, 33 },
+    { "inss-model-templates", required_argument, 0, 34 },
     /* Filter-Realign */
     { "mismatch-recovery", no_argument, 0, 40 },
     { "hamming-realign", no_argument, 0, 41 },
     { "levenshtein-realign", no_argument, 0, 42 },
+    /* Trimming */
+    { "quality-trim", required_argument, 0, 70 },
+    { "qualities-offset", required_argument, 0, 71 },
+    { "adapter", required_argument, 0, 72 },
+    { "adapter-min-overlap", required_argument, 0, 73 },
+    { "adapter-error-rate", required_argument, 0, 74 },
+    { "poly-a", required_argument, 0, 75 },
+    { "trim-n", no_argument, 0, 76 },
+    { "trim-min-length", required_argument, 0, 77 },
+    /* Output */
+    { "output-binary", no_argument, 0, 80 },
+    { "binned-qualities", no_argument, 0, 81 },
+    { "mapq", no_argument, 0, 82 },
     /* Hidden */
     { "error-plot", no_argument, 0, 50 },
     { "insert-size-plot", no_argument, 0, 51 },
     /* Misc */
     { "threads", required_argument, 0, 't' },
     { "verbose", no_argument, 0, 'v' },
+    { "profile", no_argument, 0, 90 },
     { "help", no_argument, 0, 'h' },
     { 0, 0, 0, 0 } };
   int c,option_index;
+  parameters.trim_attributes = gt_dna_read_trim_attributes_new();
+  parameters.output_binary_attributes = gt_output_binary_attributes_new();
+  parameters.map_score_attributes = gt_map_score_attributes_new();
   while (1) {
     c=getopt_long(argc,argv,"i:o:r:pt:hv",long_options,&option_index);
     if (c==-1) break;
@@ -494,6 +623,10 @@ void parse_arguments(int argc,char** argv) {
       parameters.perform_map_filter = true;
       gt_filter_get_argument_map_id(optarg);
       break;
+    case 14: // min-mapq
+      parameters.mapq = true;
+      parameters.min_mapq = atoll(optarg);
+      break;
     /* Filter-pairs */
     case 30: // pair-strandness
       parameters.perform_map_filter = true;
@@ -507,6 +640,21 @@ void parse_arguments(int argc,char** argv) {
       parameters.perform_map_filter = true;
       parameters.max_inss = atoll(optarg);
       break;
+    case 33: { // inss-quantiles
+      char* high_quantile = strchr(optarg,',');
+      if (high_quantile==NULL) gt_fatal_error_msg("Insert size quantiles must be given as <low>,<high>");
+      parameters.perform_map_filter = true;
+      parameters.inss_quantiles = true;
+      parameters.inss_min_quantile = atof(optarg);
+      parameters.inss_max_quantile = atof(high_quantile+1);
+      if (parameters.inss_min_quantile<0.0 || parameters.inss_min_quantile>parameters.inss_max_quantile || parameters.inss_max_quantile>1.0) {
+        gt_fatal_error_msg("Insert size quantiles '%s' out of range",optarg);
+      }
+      break;
+    }
+    case 34:
+      parameters.inss_model_templates = atoll(optarg);
+      break;
     /* Filter-Realign */
     case 40:
       parameters.mismatch_recovery = true;
@@ -517,6 +665,57 @@ void parse_arguments(int argc,char** argv) {
     case 42:
       parameters.realign_levenshtein = true;
       break;
+    /* Trimming */
+    case 70: {
+      char* end;
+      const long quality_threshold = strtol(optarg,&end,10);
+      if (*optarg=='\0' || *end!='\0' || quality_threshold<0 || quality_threshold>GT_DNA_READ_MAX_QUALITY) {
+        gt_fatal_error_msg("Trimming quality '%s' out of range [0,%d]",optarg,GT_DNA_READ_MAX_QUALITY);
+      }
+      parameters.trim_attributes->quality_threshold = quality_threshold;
+      break;
+    }
+    case 71:
+      if (gt_streq(optarg,"33")) {
+        parameters.trim_attributes->qualities_offset = GT_QUALS_OFFSET_33;
+        gt_output_binary_attributes_set_qualities_offset(parameters.output_binary_attributes,GT_QUALS_OFFSET_33);
+        parameters.map_score_attributes->qualities_offset = GT_QUALS_OFFSET_33;
+      } else if (gt_streq(optarg,"64")) {
+        parameters.trim_attributes->qualities_offset = GT_QUALS_OFFSET_64;
+        gt_output_binary_attributes_set_qualities_offset(parameters.output_binary_attributes,GT_QUALS_OFFSET_64);
+        parameters.map_score_attributes->qualities_offset = GT_QUALS_OFFSET_64;
+      } else {
+        gt_fatal_error_msg("Qualities offset not recognized '%s'\n",optarg);
+      }
+      break;
+    case 72: // adapter
+      gt_filter_get_argument_adapters(optarg);
+      break;
+    case 73:
+      parameters.trim_attributes->adapter_min_overlap = atoll(optarg);
+      break;
+    case 74:
+      parameters.trim_attributes->adapter_max_error_rate = atof(optarg);
+      break;
+    case 75:
+      parameters.trim_attributes->poly_a_min_length = atoll(optarg);
+      break;
+    case 76:
+      parameters.trim_attributes->trim_n_ends = true;
+      break;
+    case 77:
+      parameters.trim_min_length = atoll(optarg);
+      break;
+    /* Output */
+    case 80:
+      parameters.output_binary = true;
+      break;
+    case 81:
+      gt_output_binary_attributes_set_bin_qualities(parameters.output_binary_attributes,true);
+      break;
+    case 82:
+      parameters.mapq = true;
+      break;
     /* Hidden */
     case 50:
       parameters.error_plot = true;
@@ -531,6 +730,9 @@ void parse_arguments(int argc,char** argv) {
     case 'v':
       parameters.verbose = true;
       break;
+    case 90:
+      parameters.profile = true;
+      break;
     case 'h':
       usage();
       exit(1);
@@ -545,11 +747,22 @@ void parse_arguments(int argc,char** argv) {
   if (parameters.realign_hamming || parameters.realign_levenshtein || parameters.mismatch_recovery) {
     if (parameters.name_reference_file==NULL) gt_fatal_error_msg("Reference file required to realign");
   }
+  if (!gt_dna_read_trim_attributes_is_active(parameters.trim_attributes)) {
+    gt_dna_read_trim_attributes_delete(parameters.trim_attributes);
+    parameters.trim_attributes = NULL;
+  }
+  if (gt_output_binary_attributes_is_bin_qualities(parameters.output_binary_attributes) && !parameters.output_binary) {
+    gt_fatal_error_msg("Binned qualities require binary output (--output-binary)");
+  }
 }
 
 int main(int argc,char** argv) {
   // Parsing command-line options
   parse_arguments(argc,argv);
+  gt_profile_enable(parameters.profile);
+
+  // Estimate the insert size range
+  if (parameters.inss_quantiles) gt_filter_estimate_inss_range();
 
   // Filter !
   gt_filter_read__write();
@@ -627,6 +840,10 @@ int main(int argc,char** argv) {
 //      "CCCATCTCTTCCTAGGAGGCTGAAGAATTTATGGAGACAAAATAGGCAAGGACATTTCTTAGAGAATATGCAATGCAGTTC"
 //      "ATCCAGAATGACATCTTAGAGGTTATTTTG",435,true);
 
+  // Profile
+  if (parameters.profile) gt_profile_print(stderr);
+  gt_profile_destroy();
+
   return 0;
 }
 
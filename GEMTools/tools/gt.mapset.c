@@ -4,6 +4,7 @@
  * DATE: 08/11/2012
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
  * DESCRIPTION: Utility to perform set operations {UNION,INTERSECTION,DIFFERENCE} over alignment files {MAP,SAM}
+ *   and to evaluate the accuracy of a mapping against a truth set
  */
 
 #include <getopt.h>
@@ -11,7 +12,7 @@
 
 #include "gem_tools.h"
 
-typedef enum { GT_MAP_SET_INTERSECTION, GT_MAP_SET_UNION, GT_MAP_SET_DIFFERENCE, GT_MAP_SET_PASTE, GT_MAP_SET_COMPARE } gt_operation;
+typedef enum { GT_MAP_SET_INTERSECTION, GT_MAP_SET_UNION, GT_MAP_SET_DIFFERENCE, GT_MAP_SET_PASTE, GT_MAP_SET_COMPARE, GT_MAP_SET_ACCURACY } gt_operation;
 
 typedef struct {
   char* name_input_file_1;
@@ -23,6 +24,8 @@ typedef struct {
   double eq_threshold;
   bool strict;
   bool verbose;
+  bool profile;
+  uint64_t num_threads;
 } gt_stats_args;
 
 gt_stats_args parameters = {
@@ -34,8 +37,11 @@ gt_stats_args parameters = {
     .eq_threshold=0.5,
     .strict=false,
     .verbose=false,
+    .profile=false,
+    .num_threads=1,
 };
 uint64_t current_read_length;
+#pragma omp threadprivate(current_read_length)
 
 int64_t gt_mapset_map_cmp(gt_map* const map_1,gt_map* const map_2) {
   register const uint64_t eq_threshold = (parameters.eq_threshold <= 1.0) ?
@@ -48,83 +54,96 @@ int64_t gt_mapset_mmap_cmp(gt_map** const map_1,gt_map** const map_2,const uint6
   return parameters.strict ? gt_mmap_cmp(map_1,map_2,num_maps) : gt_mmap_range_cmp(map_1,map_2,num_maps,eq_threshold);
 }
 
+/*
+ * Synch read of templates
+ *   Blocks are synchronised by subset (gt_input_map_parser_synch_blocks_by_subset), so
+ *   each thread gets a pair of blocks spanning the same reads
+ */
 GT_INLINE gt_status gt_mapset_read_template_sync(
+    pthread_mutex_t* const input_mutex,gt_map_parser_attr* const map_parser_attr,
     gt_buffered_input_file* const buffered_input_master,gt_buffered_input_file* const buffered_input_slave,
     gt_buffered_output_file* const buffered_output,gt_template* const template_master,gt_template* const template_slave,
     const gt_operation operation) {
-  // Read master
   register gt_status error_code_master, error_code_slave;
-  gt_output_map_attributes* output_attributes = gt_output_map_attributes_new();
-  gt_generic_parser_attr generic_parser_attr = GENERIC_PARSER_ATTR_DEFAULT(parameters.paired_end);
-  if ((error_code_master=gt_input_generic_parser_get_template(
-      buffered_input_master,template_master,&generic_parser_attr))==GT_IMP_FAIL) {
-    gt_fatal_error_msg("Fatal error parsing file <<Master>>");
-  }
-  // Read slave
-  if ((error_code_slave=gt_input_generic_parser_get_template(
-      buffered_input_slave,template_slave,&generic_parser_attr))==GT_IMP_FAIL) {
-    gt_fatal_error_msg("Fatal error parsing file <<Slave>>");
-  }
-  // Check EOF conditions
-  if (error_code_master==GT_IMP_EOF) {
-    if (error_code_slave!=GT_IMP_EOF) {
-      gt_fatal_error_msg("<<Slave>> contains more/different reads from <<Master>>");
+  gt_output_map_attributes output_attributes = GT_OUTPUT_MAP_ATTR_DEFAULT();
+  register const bool print_master = (operation==GT_MAP_SET_UNION || operation==GT_MAP_SET_DIFFERENCE);
+  do {
+    // Read Synch blocks
+    error_code_master=gt_input_map_parser_synch_blocks_by_subset(
+        input_mutex,map_parser_attr,buffered_input_master,buffered_input_slave);
+    if (error_code_master==GT_IMP_EOF) return GT_IMP_EOF;
+    if (error_code_master==GT_IMP_FAIL) gt_fatal_error_msg("Fatal error synchronizing files");
+    // Read master (always guaranteed)
+    if ((error_code_master=gt_input_map_parser_get_template_g(
+        buffered_input_master,template_master,map_parser_attr))==GT_IMP_FAIL) {
+      gt_fatal_error_msg("Fatal error parsing file <<Master>>");
     }
-    return GT_IMP_EOF;
-  } else if (error_code_slave==GT_IMP_EOF) { // Slave exhausted. Dump master & return EOF
-    do {
-      if (error_code_master==GT_IMP_FAIL) gt_fatal_error_msg("Fatal error parsing file <<Master>>");
-      if (operation==GT_MAP_SET_UNION || operation==GT_MAP_SET_DIFFERENCE) {
-        gt_output_map_bofprint_template(buffered_output,template_master,output_attributes);
+    if (gt_buffered_input_file_eob(buffered_input_slave)) { // Slave exhausted. Dump master's block
+      while (true) {
+        if (print_master) gt_output_map_bofprint_template(buffered_output,template_master,&output_attributes);
+        if (gt_buffered_input_file_eob(buffered_input_master)) break;
+        if ((error_code_master=gt_input_map_parser_get_template_g(
+            buffered_input_master,template_master,map_parser_attr))!=GT_IMP_OK) {
+          gt_fatal_error_msg("Fatal error parsing file <<Master>>");
+        }
       }
-    } while ((error_code_master=gt_input_generic_parser_get_template(
-                buffered_input_master,template_master,&generic_parser_attr)));
-    return GT_IMP_EOF;
-  }
-  // Synch loop
-  while (gt_string_cmp(gt_template_get_string_tag(template_master),
-      gt_template_get_string_tag(template_slave))) {
-    // Print non correlative master's template
-    if (operation==GT_MAP_SET_UNION || operation==GT_MAP_SET_DIFFERENCE) {
-      gt_output_map_bofprint_template(buffered_output,template_master,output_attributes);
-    }
-    // Fetch next master's template
-    if ((error_code_master=gt_input_generic_parser_get_template(
-        buffered_input_master,template_master,&generic_parser_attr))!=GT_IMP_OK) {
-      gt_fatal_error_msg("<<Slave>> contains more/different reads from <<Master>>");
+    } else {
+      // Read slave
+      if ((error_code_slave=gt_input_map_parser_get_template_g(
+          buffered_input_slave,template_slave,map_parser_attr))!=GT_IMP_OK) {
+        gt_fatal_error_msg("Fatal error parsing file <<Slave>>");
+      }
+      // Synch loop
+      while (gt_string_cmp(gt_template_get_string_tag(template_master),gt_template_get_string_tag(template_slave))) {
+        // Print non correlative master's template
+        if (print_master) gt_output_map_bofprint_template(buffered_output,template_master,&output_attributes);
+        // Fetch next master's template
+        if (gt_buffered_input_file_eob(buffered_input_master)) {
+          gt_fatal_error_msg("<<Slave>> contains more/different reads from <<Master>>");
+        }
+        if ((error_code_master=gt_input_map_parser_get_template_g(
+            buffered_input_master,template_master,map_parser_attr))!=GT_IMP_OK) {
+          gt_fatal_error_msg("Fatal error parsing file <<Master>>");
+        }
+      }
+      return GT_IMP_OK;
     }
-  }
-  return GT_IMP_OK;
+  } while (true);
 }
-
 GT_INLINE gt_status gt_mapset_read_template_get_commom_map(
+    pthread_mutex_t* const input_mutex,gt_map_parser_attr* const map_parser_attr,
     gt_buffered_input_file* const buffered_input_master,gt_buffered_input_file* const buffered_input_slave,
     gt_template* const template_master,gt_template* const template_slave) {
-  register gt_status error_code_master, error_code_slave;
-  gt_generic_parser_attr generic_parser_attr = GENERIC_PARSER_ATTR_DEFAULT(parameters.paired_end);
-  // Read master
-  if ((error_code_master=gt_input_generic_parser_get_template(
-      buffered_input_master,template_master,&generic_parser_attr))==GT_IMP_FAIL) {
-    gt_fatal_error_msg("Fatal error parsing file <<Master>>");
-  }
-  if (error_code_master==GT_IMP_EOF) return GT_IMP_EOF;
-  // Read slave
-  if ((error_code_slave=gt_input_generic_parser_get_template(
-      buffered_input_slave,template_slave,&generic_parser_attr))==GT_IMP_FAIL) {
-    gt_fatal_error_msg("Fatal error parsing file <<Slave>>");
-  }
-  if (error_code_slave==GT_IMP_EOF) { // Check EOF conditions
-    gt_fatal_error_msg("<<Slave>> is not contained in master <<Master>>");
-  }
-  // Synch loop
-  while (gt_string_cmp(gt_template_get_string_tag(template_master),gt_template_get_string_tag(template_slave))) {
-    // Fetch next slave's template
-    if ((error_code_master=gt_input_generic_parser_get_template(
-        buffered_input_slave,template_slave,&generic_parser_attr))!=GT_IMP_OK) {
-      gt_fatal_error_msg("<<Slave>> is not contained in master <<Master>>");
+  register gt_status error_code;
+  do {
+    // Read Synch blocks (Master's reads are a subset of the slave's)
+    error_code=gt_input_map_parser_synch_blocks_by_subset(
+        input_mutex,map_parser_attr,buffered_input_slave,buffered_input_master);
+    if (error_code==GT_IMP_EOF) return GT_IMP_EOF;
+    if (error_code==GT_IMP_FAIL) gt_fatal_error_msg("Fatal error synchronizing files");
+    if (gt_buffered_input_file_eob(buffered_input_master)) { // Master exhausted. Skip slave's block
+      while (!gt_buffered_input_file_eob(buffered_input_slave)) {
+        if (gt_input_map_parser_get_template_g(buffered_input_slave,template_slave,map_parser_attr)!=GT_IMP_OK) {
+          gt_fatal_error_msg("Fatal error parsing file <<Slave>>");
+        }
+      }
+      continue;
     }
-  }
-  return GT_IMP_OK;
+    // Read master
+    if (gt_input_map_parser_get_template_g(buffered_input_master,template_master,map_parser_attr)!=GT_IMP_OK) {
+      gt_fatal_error_msg("Fatal error parsing file <<Master>>");
+    }
+    // Synch loop
+    do {
+      if (gt_buffered_input_file_eob(buffered_input_slave)) {
+        gt_fatal_error_msg("<<Slave>> is not contained in master <<Master>>");
+      }
+      if (gt_input_map_parser_get_template_g(buffered_input_slave,template_slave,map_parser_attr)!=GT_IMP_OK) {
+        gt_fatal_error_msg("Fatal error parsing file <<Slave>>");
+      }
+    } while (gt_string_cmp(gt_template_get_string_tag(template_master),gt_template_get_string_tag(template_slave)));
+    return GT_IMP_OK;
+  } while (true);
 }
 
 void gt_mapset_perform_set_operations() {
@@ -136,137 +155,264 @@ void gt_mapset_perform_set_operations() {
   gt_output_file* output_file = (parameters.name_output_file==NULL) ?
       gt_output_stream_new(stdout,SORTED_FILE) : gt_output_file_new(parameters.name_output_file,SORTED_FILE);
 
-  // Buffered I/O
-  gt_buffered_input_file* buffered_input_1 = gt_buffered_input_file_new(input_file_1);
-  gt_buffered_input_file* buffered_input_2 = gt_buffered_input_file_new(input_file_2);
-  gt_buffered_output_file* buffered_output = gt_buffered_output_file_new(output_file);
-  gt_buffered_input_file_attach_buffered_output(buffered_input_1,buffered_output);
+  // Parallel I/O
+  pthread_mutex_t input_mutex = PTHREAD_MUTEX_INITIALIZER;
+  #pragma omp parallel num_threads(parameters.num_threads)
+  {
+    // Buffered I/O
+    gt_buffered_input_file* buffered_input_1 = gt_buffered_input_file_new(input_file_1);
+    gt_buffered_input_file* buffered_input_2 = gt_buffered_input_file_new(input_file_2);
+    gt_buffered_output_file* buffered_output = gt_buffered_output_file_new(output_file);
+    gt_buffered_input_file_attach_buffered_output(buffered_input_1,buffered_output);
 
-  // Template I/O (synch)
-  gt_template *template_1 = gt_template_new();
-  gt_template *template_2 = gt_template_new();
-  gt_output_map_attributes* output_attributes = gt_output_map_attributes_new();
-  while (gt_mapset_read_template_sync(buffered_input_1,buffered_input_2,
-      buffered_output,template_1,template_2,parameters.operation)) {
-    // Record current read length
-    current_read_length = gt_template_get_total_length(template_1);
-    // Apply operation
-    register gt_template *ptemplate;
-    switch (parameters.operation) {
-      case GT_MAP_SET_UNION:
-        ptemplate=gt_template_union_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
-        break;
-      case GT_MAP_SET_INTERSECTION:
-        ptemplate=gt_template_intersect_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
-        break;
-      case GT_MAP_SET_DIFFERENCE:
-        ptemplate=gt_template_subtract_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
-        break;
-      default:
-        gt_fatal_error(SELECTION_NOT_VALID);
-        break;
+    // Template I/O (synch)
+    gt_template *template_1 = gt_template_new();
+    gt_template *template_2 = gt_template_new();
+    gt_map_parser_attr map_parser_attr = GT_MAP_PARSER_ATTR_DEFAULT(parameters.paired_end);
+    gt_output_map_attributes output_attributes = GT_OUTPUT_MAP_ATTR_DEFAULT();
+    while (gt_mapset_read_template_sync(&input_mutex,&map_parser_attr,buffered_input_1,buffered_input_2,
+        buffered_output,template_1,template_2,parameters.operation)) {
+      // Record current read length
+      current_read_length = gt_template_get_total_length(template_1);
+      // Apply operation
+      register gt_template *ptemplate;
+      switch (parameters.operation) {
+        case GT_MAP_SET_UNION:
+          ptemplate=gt_template_union_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
+          break;
+        case GT_MAP_SET_INTERSECTION:
+          ptemplate=gt_template_intersect_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
+          break;
+        case GT_MAP_SET_DIFFERENCE:
+          ptemplate=gt_template_subtract_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
+          break;
+        default:
+          gt_fatal_error(SELECTION_NOT_VALID);
+          break;
+      }
+      // Print template
+      gt_output_map_bofprint_template(buffered_output,ptemplate,&output_attributes);
+      // Delete template
+      gt_template_delete(ptemplate);
     }
-    // Print template
-    gt_output_map_bofprint_template(buffered_output,ptemplate,output_attributes);
-    // Delete template
-    gt_template_delete(ptemplate);
+
+    // Clean
+    gt_template_delete(template_1);
+    gt_template_delete(template_2);
+    gt_buffered_input_file_close(buffered_input_1);
+    gt_buffered_input_file_close(buffered_input_2);
+    gt_buffered_output_file_close(buffered_output);
   }
 
   // Clean
-  gt_template_delete(template_1);
-  gt_template_delete(template_2);
-  gt_buffered_input_file_close(buffered_input_1);
-  gt_buffered_input_file_close(buffered_input_2);
-  gt_buffered_output_file_close(buffered_output);
   gt_input_file_close(input_file_1);
   gt_input_file_close(input_file_2);
   gt_output_file_close(output_file);
 }
 
+/*
+ * Truth-set accuracy
+ *   Master is the truth set (first map of each template is the true location)
+ *   Slave is the mapper's output. Templates are accounted by the strata of their best mmap
+ */
+#define GT_MAPSET_ACCURACY_STRATA 11 /* [0,10) + [10,inf) */
+typedef struct {
+  uint64_t num_templates;     // Templates in the truth set with a true location
+  uint64_t num_mapped;        // ... mapped by the mapper
+  uint64_t num_correct_any;   // ... where any of the reported maps is the true one
+  uint64_t mapped[GT_MAPSET_ACCURACY_STRATA];  // Mapped templates (by strata of the best mmap)
+  uint64_t correct[GT_MAPSET_ACCURACY_STRATA]; // Mapped templates whose best mmap is the true one
+} gt_mapset_accuracy;
+
+GT_INLINE uint64_t gt_mapset_mmap_get_distance(gt_map** const mmap,const uint64_t num_blocks) {
+  register uint64_t i, distance = 0;
+  for (i=0;i<num_blocks;++i) distance += gt_map_get_global_distance(mmap[i]);
+  return distance;
+}
+GT_INLINE void gt_mapset_accuracy_template(
+    gt_mapset_accuracy* const accuracy,gt_template* const template_truth,gt_template* const template_mapper) {
+  register const uint64_t num_blocks = gt_template_get_num_blocks(template_truth);
+  if (gt_template_get_num_mmaps(template_truth)==0) return; // No true location
+  if (gt_template_get_num_blocks(template_mapper)!=num_blocks) {
+    gt_fatal_error_msg("Templates '"PRIgts"' have a different number of blocks",PRIgts_content(template_truth->tag));
+  }
+  ++accuracy->num_templates;
+  register gt_map** const true_mmap = gt_template_get_mmap(template_truth,0,NULL);
+  // Locate the best mmap & the true one among the mapper's
+  register gt_map** best_mmap = NULL;
+  register uint64_t best_distance = UINT64_MAX;
+  register bool correct_any = false;
+  GT_TEMPLATE_ITERATE_(template_mapper,mmap) {
+    register const uint64_t distance = gt_mapset_mmap_get_distance(mmap,num_blocks);
+    if (distance < best_distance) {
+      best_distance = distance;
+      best_mmap = mmap;
+    }
+    if (!correct_any && gt_mapset_mmap_cmp(mmap,true_mmap,num_blocks)==0) correct_any = true;
+  }
+  if (best_mmap==NULL) return; // Unmapped
+  ++accuracy->num_mapped;
+  if (correct_any) ++accuracy->num_correct_any;
+  register const uint64_t strata = GT_MIN(best_distance,GT_MAPSET_ACCURACY_STRATA-1);
+  ++accuracy->mapped[strata];
+  if (gt_mapset_mmap_cmp(best_mmap,true_mmap,num_blocks)==0) ++accuracy->correct[strata];
+}
+GT_INLINE void gt_mapset_accuracy_merge(gt_mapset_accuracy* const accuracy,const uint64_t num_accuracy) {
+  register uint64_t i, j;
+  for (i=1;i<num_accuracy;++i) {
+    accuracy[0].num_templates += accuracy[i].num_templates;
+    accuracy[0].num_mapped += accuracy[i].num_mapped;
+    accuracy[0].num_correct_any += accuracy[i].num_correct_any;
+    for (j=0;j<GT_MAPSET_ACCURACY_STRATA;++j) {
+      accuracy[0].mapped[j] += accuracy[i].mapped[j];
+      accuracy[0].correct[j] += accuracy[i].correct[j];
+    }
+  }
+}
+GT_INLINE void gt_mapset_accuracy_print(FILE* const stream,gt_mapset_accuracy* const accuracy) {
+  register uint64_t i, total_correct = 0, cumulative_mapped = 0, cumulative_correct = 0;
+  for (i=0;i<GT_MAPSET_ACCURACY_STRATA;++i) total_correct += accuracy->correct[i];
+  fprintf(stream,"[ACCURACY]\n");
+  fprintf(stream,"  --> Num.Templates %" PRIu64 "\n",accuracy->num_templates);
+  fprintf(stream,"    --> Mapped %" PRIu64 " (%2.3f%%)\n",
+      accuracy->num_mapped,GT_STATS_GET_PERCENTAGE(accuracy->num_mapped,accuracy->num_templates));
+  fprintf(stream,"    --> Correct.Best %" PRIu64 " (Sensitivity=%2.3f%%,Precision=%2.3f%%)\n",total_correct,
+      GT_STATS_GET_PERCENTAGE(total_correct,accuracy->num_templates),GT_STATS_GET_PERCENTAGE(total_correct,accuracy->num_mapped));
+  fprintf(stream,"    --> Correct.Any %" PRIu64 " (Sensitivity=%2.3f%%)\n",accuracy->num_correct_any,
+      GT_STATS_GET_PERCENTAGE(accuracy->num_correct_any,accuracy->num_templates));
+  fprintf(stream,"Strata \t Mapped \t Correct \t Precision \t Cum.Sensitivity \t Cum.Precision\n");
+  for (i=0;i<GT_MAPSET_ACCURACY_STRATA;++i) {
+    cumulative_mapped += accuracy->mapped[i];
+    cumulative_correct += accuracy->correct[i];
+    if (i<GT_MAPSET_ACCURACY_STRATA-1) {
+      fprintf(stream,"  [%2" PRIu64 "] ",i);
+    } else {
+      fprintf(stream,"[%2" PRIu64 ",inf) ",i);
+    }
+    fprintf(stream,"\t %" PRIu64 " \t %" PRIu64 " \t %2.3f%% \t %2.3f%% \t %2.3f%%\n",
+        accuracy->mapped[i],accuracy->correct[i],GT_STATS_GET_PERCENTAGE(accuracy->correct[i],accuracy->mapped[i]),
+        GT_STATS_GET_PERCENTAGE(cumulative_correct,accuracy->num_templates),
+        GT_STATS_GET_PERCENTAGE(cumulative_correct,cumulative_mapped));
+  }
+}
+
 void gt_mapset_perform_cmp_operations() {
   // File IN/OUT
   gt_input_file* input_file_1 = gt_input_file_open(parameters.name_input_file_1,parameters.mmap_input);
   gt_input_file* input_file_2 = (parameters.name_input_file_2==NULL) ?
       gt_input_stream_open(stdin) : gt_input_file_open(parameters.name_input_file_2,parameters.mmap_input);
   if (parameters.name_input_file_2==NULL) GT_SWAP(input_file_1,input_file_2);
-  gt_output_file* output_file = (parameters.name_output_file==NULL) ?
-      gt_output_stream_new(stdout,SORTED_FILE) : gt_output_file_new(parameters.name_output_file,SORTED_FILE);
+  gt_output_file* output_file = NULL;
+  FILE* report_file = NULL;
+  if (parameters.operation==GT_MAP_SET_ACCURACY) {
+    report_file = (parameters.name_output_file==NULL) ? stdout : fopen(parameters.name_output_file,"w");
+    if (report_file==NULL) gt_fatal_error_msg("Unable to open output file '%s'",parameters.name_output_file);
+  } else {
+    output_file = (parameters.name_output_file==NULL) ?
+        gt_output_stream_new(stdout,SORTED_FILE) : gt_output_file_new(parameters.name_output_file,SORTED_FILE);
+  }
+  gt_mapset_accuracy* const accuracy = calloc(parameters.num_threads,sizeof(gt_mapset_accuracy));
+  gt_cond_fatal_error(!accuracy,MEM_ALLOC);
 
-  // Buffered I/O
-  gt_buffered_input_file* buffered_input_1 = gt_buffered_input_file_new(input_file_1);
-  gt_buffered_input_file* buffered_input_2 = gt_buffered_input_file_new(input_file_2);
-  gt_buffered_output_file* buffered_output = gt_buffered_output_file_new(output_file);
-  gt_buffered_input_file_attach_buffered_output(buffered_input_1,buffered_output);
+  // Parallel I/O
+  pthread_mutex_t input_mutex = PTHREAD_MUTEX_INITIALIZER;
+  #pragma omp parallel num_threads(parameters.num_threads)
+  {
+    register const uint64_t tid = omp_get_thread_num();
+    // Buffered I/O (Output is synchronised with the slave, whose blocks span the master's)
+    gt_buffered_input_file* buffered_input_1 = gt_buffered_input_file_new(input_file_1);
+    gt_buffered_input_file* buffered_input_2 = gt_buffered_input_file_new(input_file_2);
+    gt_buffered_output_file* buffered_output = NULL;
+    if (output_file!=NULL) {
+      buffered_output = gt_buffered_output_file_new(output_file);
+      gt_buffered_input_file_attach_buffered_output(buffered_input_2,buffered_output);
+    }
 
-  // Template I/O (synch)
-  gt_template *template_1 = gt_template_new();
-  gt_template *template_2 = gt_template_new();
-  gt_output_map_attributes* output_map_attributes = gt_output_map_attributes_new();
-  while (gt_mapset_read_template_get_commom_map(buffered_input_1,buffered_input_2,template_1,template_2)) {
-    // Record current read length
-    current_read_length = gt_template_get_total_length(template_1);
-    // Apply operation
-    switch (parameters.operation) {
-      case GT_MAP_SET_PASTE:
-        // Print Master's TAG+Counters+Maps
-        gt_output_map_bofprint_tag(buffered_output,template_1->tag,template_1->attributes,output_map_attributes);
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_1));
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_template_maps_g(buffered_output,template_1,output_map_attributes);
-        // Print Slave's Counters+Maps
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_2));
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_template_maps_g(buffered_output,template_2,output_map_attributes);
-        gt_bofprintf(buffered_output,"\n");
-        break;
-      case GT_MAP_SET_COMPARE: {
-        // Perform simple cmp operations
-        register gt_template *template_master_minus_slave=gt_template_subtract_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
-        register gt_template *template_slave_minus_master=gt_template_subtract_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_2,template_1);
-        register gt_template *template_intersection=gt_template_intersect_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
-        /*
-         * Print results :: (TAG (Master-Slave){COUNTER MAPS} (Slave-Master){COUNTER MAPS} (Intersection){COUNTER MAPS})
-         */
-        gt_output_map_bofprint_tag(buffered_output,template_1->tag,template_1->attributes,output_map_attributes);
-        // (TAG (Master-Slave){COUNTER MAPS}
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_master_minus_slave));
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_template_maps_g(buffered_output,template_master_minus_slave,output_map_attributes);
-        // (Slave-Master){COUNTER MAPS}
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_slave_minus_master));
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_template_maps_g(buffered_output,template_slave_minus_master,output_map_attributes);
-        // (Intersection){COUNTER MAPS})
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_intersection));
-        gt_bofprintf(buffered_output,"\t");
-        gt_output_map_bofprint_template_maps_g(buffered_output,template_intersection,output_map_attributes);
-        gt_bofprintf(buffered_output,"\n");
-        // Delete templates
-        gt_template_delete(template_master_minus_slave);
-        gt_template_delete(template_slave_minus_master);
-        gt_template_delete(template_intersection);
-        }
-        break;
-      default:
-        gt_fatal_error(SELECTION_NOT_VALID);
-        break;
+    // Template I/O (synch)
+    gt_template *template_1 = gt_template_new();
+    gt_template *template_2 = gt_template_new();
+    gt_map_parser_attr map_parser_attr = GT_MAP_PARSER_ATTR_DEFAULT(parameters.paired_end);
+    gt_output_map_attributes output_map_attributes = GT_OUTPUT_MAP_ATTR_DEFAULT();
+    while (gt_mapset_read_template_get_commom_map(&input_mutex,&map_parser_attr,
+        buffered_input_1,buffered_input_2,template_1,template_2)) {
+      // Record current read length
+      current_read_length = gt_template_get_total_length(template_1);
+      // Apply operation
+      switch (parameters.operation) {
+        case GT_MAP_SET_PASTE:
+          // Print Master's TAG+Counters+Maps
+          gt_output_map_bofprint_tag(buffered_output,template_1->tag,template_1->attributes,&output_map_attributes);
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_1));
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_template_maps_g(buffered_output,template_1,&output_map_attributes);
+          // Print Slave's Counters+Maps
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_2));
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_template_maps_g(buffered_output,template_2,&output_map_attributes);
+          gt_bofprintf(buffered_output,"\n");
+          break;
+        case GT_MAP_SET_COMPARE: {
+          // Perform simple cmp operations
+          register gt_template *template_master_minus_slave=gt_template_subtract_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
+          register gt_template *template_slave_minus_master=gt_template_subtract_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_2,template_1);
+          register gt_template *template_intersection=gt_template_intersect_template_mmaps_fx(gt_mapset_mmap_cmp,gt_mapset_map_cmp,template_1,template_2);
+          /*
+           * Print results :: (TAG (Master-Slave){COUNTER MAPS} (Slave-Master){COUNTER MAPS} (Intersection){COUNTER MAPS})
+           */
+          gt_output_map_bofprint_tag(buffered_output,template_1->tag,template_1->attributes,&output_map_attributes);
+          // (TAG (Master-Slave){COUNTER MAPS}
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_master_minus_slave));
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_template_maps_g(buffered_output,template_master_minus_slave,&output_map_attributes);
+          // (Slave-Master){COUNTER MAPS}
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_slave_minus_master));
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_template_maps_g(buffered_output,template_slave_minus_master,&output_map_attributes);
+          // (Intersection){COUNTER MAPS})
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_counters(buffered_output,gt_template_get_counters_vector(template_intersection));
+          gt_bofprintf(buffered_output,"\t");
+          gt_output_map_bofprint_template_maps_g(buffered_output,template_intersection,&output_map_attributes);
+          gt_bofprintf(buffered_output,"\n");
+          // Delete templates
+          gt_template_delete(template_master_minus_slave);
+          gt_template_delete(template_slave_minus_master);
+          gt_template_delete(template_intersection);
+          }
+          break;
+        case GT_MAP_SET_ACCURACY:
+          gt_mapset_accuracy_template(accuracy+tid,template_1,template_2);
+          break;
+        default:
+          gt_fatal_error(SELECTION_NOT_VALID);
+          break;
+      }
     }
+
+    // Clean
+    gt_template_delete(template_1);
+    gt_template_delete(template_2);
+    gt_buffered_input_file_close(buffered_input_1);
+    gt_buffered_input_file_close(buffered_input_2);
+    if (buffered_output!=NULL) gt_buffered_output_file_close(buffered_output);
+  }
+
+  // Accuracy report
+  if (parameters.operation==GT_MAP_SET_ACCURACY) {
+    gt_mapset_accuracy_merge(accuracy,parameters.num_threads);
+    gt_mapset_accuracy_print(report_file,accuracy);
+    if (report_file!=stdout) fclose(report_file);
   }
 
   // Clean
-  gt_template_delete(template_1);
-  gt_template_delete(template_2);
-  gt_buffered_input_file_close(buffered_input_1);
-  gt_buffered_input_file_close(buffered_input_2);
-  gt_buffered_output_file_close(buffered_output);
+  free(accuracy);
   gt_input_file_close(input_file_1);
   gt_input_file_close(input_file_2);
-  gt_output_file_close(output_file);
+  if (output_file!=NULL) gt_output_file_close(output_file);
 }
 
 void usage() {
@@ -277,6 +423,7 @@ void usage() {
                   "         difference\n"
                   "         compare\n"
                   "         paste\n"
+                  "         accuracy (--i1 is the truth set, --i2 the mapping to evaluate)\n"
                   "       [ARGS]\n"
                   "         --i1 [FILE]\n"
                   "         --i2 [FILE]\n"
@@ -287,13 +434,15 @@ void usage() {
                   "         --eq-th <number>|<float>\n"
                   "         --strict\n"
                   "       [MISC]\n"
+                  "         --threads|t\n"
                   "         --verbose|v\n"
+                  "         --profile\n"
                   "         --help|h\n");
 }
 
 void parse_arguments(int argc,char** argv) {
   // Parse operation
-  if (argc<=1) gt_fatal_error_msg("Please specify operation {union,intersection,difference,compare}");
+  if (argc<=1) gt_fatal_error_msg("Please specify operation {union,intersection,difference,compare,paste,accuracy}");
   if (gt_streq(argv[1],"INTERSECCTION") || gt_streq(argv[1],"Intersection") || gt_streq(argv[1],"intersection")) {
     parameters.operation = GT_MAP_SET_INTERSECTION;
   } else if (gt_streq(argv[1],"UNION") || gt_streq(argv[1],"Union") || gt_streq(argv[1],"union")) {
@@ -304,6 +453,8 @@ void parse_arguments(int argc,char** argv) {
     parameters.operation = GT_MAP_SET_COMPARE;
   } else if (gt_streq(argv[1],"PASTE") || gt_streq(argv[1],"Paste") || gt_streq(argv[1],"paste")) {
     parameters.operation = GT_MAP_SET_PASTE;
+  } else if (gt_streq(argv[1],"ACCURACY") || gt_streq(argv[1],"Accuracy") || gt_streq(argv[1],"accuracy")) {
+    parameters.operation = GT_MAP_SET_ACCURACY;
   } else {
     if (argv[1][0]=='I' || argv[1][0]=='i') {
       fprintf(stderr,"\tAssuming 'Intersection' ...\n");
@@ -320,6 +471,9 @@ void parse_arguments(int argc,char** argv) {
     } else if (argv[1][0]=='P' || argv[1][0]=='p') {
       fprintf(stderr,"\tAssuming 'Paste' ...\n");
       parameters.operation = GT_MAP_SET_PASTE;
+    } else if (argv[1][0]=='A' || argv[1][0]=='a') {
+      fprintf(stderr,"\tAssuming 'Accuracy' ...\n");
+      parameters.operation = GT_MAP_SET_ACCURACY;
     } else {
       gt_fatal_error_msg("Unknown operation '%s'\n",argv[1]);
     }
@@ -336,12 +490,14 @@ void parse_arguments(int argc,char** argv) {
     { "eq-th", required_argument, 0, 4 },
     { "strict", no_argument, 0, 5 },
     /* MISC */
+    { "threads", required_argument, 0, 't' },
     { "verbose", no_argument, 0, 'v' },
+    { "profile", no_argument, 0, 6 },
     { "help", no_argument, 0, 'h' },
     { 0, 0, 0, 0 } };
   int c,option_index;
   while (1) {
-    c=getopt_long(argc,argv,"i:o:phv",long_options,&option_index);
+    c=getopt_long(argc,argv,"i:o:pt:hv",long_options,&option_index);
     if (c==-1) break;
     switch (c) {
     case 1:
@@ -365,9 +521,15 @@ void parse_arguments(int argc,char** argv) {
     case 5:
       parameters.strict = true;
       break;
+    case 't':
+      parameters.num_threads = atol(optarg);
+      break;
     case 'v':
       parameters.verbose = true;
       break;
+    case 6:
+      parameters.profile = true;
+      break;
     case 'h':
       usage();
       exit(1);
@@ -385,6 +547,7 @@ void parse_arguments(int argc,char** argv) {
 int main(int argc,char** argv) {
   // Parsing command-line options
   parse_arguments(argc,argv);
+  gt_profile_enable(parameters.profile);
 
   // Filter !
   if (parameters.operation==GT_MAP_SET_INTERSECTION ||
@@ -395,6 +558,10 @@ int main(int argc,char** argv) {
     gt_mapset_perform_cmp_operations();
   }
 
+  // Profile
+  if (parameters.profile) gt_profile_print(stderr);
+  gt_profile_destroy();
+
   return 0;
 }
 
@@ -24,6 +24,7 @@ typedef struct {
   /* [Misc] */
   uint64_t num_threads;
   bool verbose;
+  bool profile;
 } gt_stats_args;
 
 gt_stats_args parameters = {
@@ -35,6 +36,7 @@ gt_stats_args parameters = {
     .files_contain_same_reads=false,
     .num_threads=1,
     .verbose=false,
+    .profile=false,
 };
 
 void gt_merge_map_read__write() {
@@ -53,7 +55,9 @@ void gt_merge_map_read__write() {
   #pragma omp parallel num_threads(parameters.num_threads)
   {
     if (parameters.files_contain_same_reads) {
-      gt_merge_synch_map_files(&input_mutex,parameters.paired_end,output_file,input_file_1,input_file_2);
+      if (gt_merge_synch_map_files(&input_mutex,parameters.paired_end,output_file,input_file_1,input_file_2)!=GT_STATUS_OK) {
+        gt_fatal_error_msg("Fatal error merging files");
+      }
     } else {
       gt_merge_unsynch_map_files(&input_mutex,input_file_1,input_file_2,parameters.paired_end,output_file);
     }
@@ -76,6 +80,7 @@ void usage() {
                   "       [Misc]\n"
                   "         --threads|t\n"
                   "         --verbose|v\n"
+                  "         --profile\n"
                   "         --help|h\n");
 }
 
@@ -89,6 +94,7 @@ void parse_arguments(int argc,char** argv) {
     { "paired-end", no_argument, 0, 'p' },
     { "files-same-reads", no_argument, 0, 's' },
     { "verbose", no_argument, 0, 'v' },
+    { "profile", no_argument, 0, 4 },
     { "help", no_argument, 0, 'h' },
     { "threads", required_argument, 0, 't' },
     { 0, 0, 0, 0 } };
@@ -121,6 +127,9 @@ void parse_arguments(int argc,char** argv) {
     case 'v':
       parameters.verbose = true;
       break;
+    case 4:
+      parameters.profile = true;
+      break;
     case 'h':
       usage();
       exit(1);
@@ -138,10 +147,15 @@ void parse_arguments(int argc,char** argv) {
 int main(int argc,char** argv) {
   // Parsing command-line options
   parse_arguments(argc,argv);
+  gt_profile_enable(parameters.profile);
 
   // Filter !
   gt_merge_map_read__write();
 
+  // Profile
+  if (parameters.profile) gt_profile_print(stderr);
+  gt_profile_destroy();
+
   return 0;
 }
 
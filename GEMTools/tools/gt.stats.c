@@ -25,8 +25,13 @@ typedef struct {
   bool mismatch_quality;
   bool splitmaps_profile;
   bool indel_profile;
+  bool mapq_profile;
+  bool duplicates;
+  uint64_t optical_distance;
+  uint64_t duplicates_memory;
   /* [Output] */
   bool verbose;
+  bool profile;
   bool compact;
   bool quiet;
   /* [Misc] */
@@ -47,18 +52,43 @@ gt_stats_args parameters = {
     .mismatch_quality = false,
     .splitmaps_profile = false,
     .indel_profile = false,
+    .mapq_profile = false,
+    .duplicates = false,
+    .optical_distance = 100,
+    .duplicates_memory = 256,
     /* [Output] */
     .verbose=false,
+    .profile=false,
     .compact = false,
     .quiet=false,
     /* [Misc] */
     .num_threads=1,
 };
 
+/*
+ * MAPQ profile
+ */
+#define GT_STATS_MAPQ_RANGE (GT_MAP_SCORE_MAX_PHRED+1)
+void gt_stats_print_mapq_profile(uint64_t* const mapq,const uint64_t num_mapped) {
+  const uint64_t mapq_ranges[] = {0,1,4,10,20,30,40,50,60,GT_STATS_MAPQ_RANGE};
+  register uint64_t i, j;
+  for (i=0;i<9;++i) {
+    register uint64_t count = 0;
+    for (j=mapq_ranges[i];j<mapq_ranges[i+1];++j) count += mapq[j];
+    if (mapq_ranges[i+1]-mapq_ranges[i]==1) {
+      fprintf(stderr,"  --> MAPQ.%02"PRIu64"     \t %"PRIu64" \t(%2.3f%%)\n",
+          mapq_ranges[i],count,GT_STATS_GET_PERCENTAGE(count,num_mapped));
+    } else {
+      fprintf(stderr,"  --> MAPQ.[%02"PRIu64",%02"PRIu64")\t %"PRIu64" \t(%2.3f%%)\n",
+          mapq_ranges[i],mapq_ranges[i+1],count,GT_STATS_GET_PERCENTAGE(count,num_mapped));
+    }
+  }
+}
+
 /*
  * STATS Print results
  */
-void gt_stats_print_stats(gt_stats* const stats,uint64_t num_reads,const bool paired_end) {
+void gt_stats_print_stats(gt_stats* const stats,gt_duplicates* const duplicates,uint64_t num_reads,const bool paired_end) {
   /*
    * General.Stats (Reads,Alignments,...)
    */
@@ -102,6 +132,13 @@ void gt_stats_print_stats(gt_stats* const stats,uint64_t num_reads,const bool pa
           stderr,maps_profile->misms_1context,maps_profile->total_mismatches);
     }
   }
+  /*
+   * Print Indel profile
+   */
+  if (parameters.indel_profile) {
+    fprintf(stderr,"[INDEL.PROFILE]\n");
+    gt_stats_print_indel_stats(stderr,stats);
+  }
   /*
    * Print Splitmaps profile
    */
@@ -109,6 +146,13 @@ void gt_stats_print_stats(gt_stats* const stats,uint64_t num_reads,const bool pa
     fprintf(stderr,"[SPLITMAPS.PROFILE]\n");
     gt_stats_print_split_maps_stats(stderr,stats,parameters.paired_end);
   }
+  /*
+   * Print Duplicates & Library complexity
+   */
+  if (parameters.duplicates) {
+    fprintf(stderr,"[DUPLICATES]\n");
+    gt_stats_print_duplicates_stats(stderr,stats,duplicates);
+  }
 }
 void gt_stats_print_stats_compact(gt_stats* const stats,uint64_t num_reads,const bool paired_end) {
   // #mapped, %mapped
@@ -142,6 +186,8 @@ void gt_stats_parallel_generate_stats() {
   // Stats info
   gt_stats_analysis stats_analysis = GT_STATS_ANALYSIS_DEFAULT();
   gt_stats** stats = malloc(parameters.num_threads*sizeof(gt_stats*));
+  uint64_t* const mapq = calloc(parameters.num_threads*GT_STATS_MAPQ_RANGE,sizeof(uint64_t));
+  gt_cond_fatal_error(!mapq,MEM_ALLOC);
 
   // Select analysis
   stats_analysis.best_map = parameters.best_map;
@@ -159,7 +205,7 @@ void gt_stats_parallel_generate_stats() {
     sequence_archive = gt_sequence_archive_new();
     register gt_input_file* const reference_file = gt_input_file_open(parameters.name_reference_file,false);
     fprintf(stderr,"Loading reference file ...");
-    if (gt_input_multifasta_parser_get_archive(reference_file,sequence_archive)!=GT_IFP_OK) {
+    if (gt_input_multifasta_parser_get_archive_parallel(reference_file,sequence_archive,parameters.num_threads)!=GT_IFP_OK) {
       fprintf(stderr,"\n");
       gt_fatal_error_msg("Error parsing reference file '%s'\n",parameters.name_reference_file);
     }
@@ -167,6 +213,15 @@ void gt_stats_parallel_generate_stats() {
     fprintf(stderr," done! \n");
   }
 
+  // Duplicates tracker (shared among threads)
+  gt_duplicates* duplicates = NULL;
+  if (parameters.duplicates) {
+    gt_duplicates_attributes duplicates_attributes = GT_DUPLICATES_ATTR_DEFAULT();
+    duplicates_attributes.optical_distance = parameters.optical_distance;
+    duplicates_attributes.max_memory = parameters.duplicates_memory*1024*1024;
+    duplicates = gt_duplicates_new(&duplicates_attributes);
+  }
+
   // Parallel reading+process
   #pragma omp parallel num_threads(parameters.num_threads)
   {
@@ -177,13 +232,23 @@ void gt_stats_parallel_generate_stats() {
     gt_template *template = gt_template_new();
     stats[tid] = gt_stats_new();
     gt_generic_parser_attr generic_parser_attr = GENERIC_PARSER_ATTR_DEFAULT(parameters.paired_end);
+    gt_map_score_attributes map_score_attributes = GT_MAP_SCORE_ATTR_DEFAULT();
+    uint64_t* const thread_mapq = mapq+tid*GT_STATS_MAPQ_RANGE;
     while ((error_code=gt_input_generic_parser_get_template(buffered_input,template,&generic_parser_attr))) {
       if (error_code!=GT_IMP_OK) {
         gt_error_msg("Fatal error parsing file '%s'\n",parameters.name_input_file);
       }
 
+      // Mark duplicates
+      if (duplicates!=NULL) gt_duplicates_mark_template(duplicates,template);
+
       // Extract stats
       gt_stats_calculate_template_stats(stats[tid],template,sequence_archive,&stats_analysis);
+
+      // MAPQ profile
+      if (parameters.mapq_profile && gt_template_is_mapped(template)) {
+        ++thread_mapq[gt_map_score_template_mapq(template,&map_score_attributes)];
+      }
     }
 
     // Clean
@@ -193,20 +258,36 @@ void gt_stats_parallel_generate_stats() {
 
   // Merge stats
   gt_stats_merge(stats,parameters.num_threads);
+  register uint64_t i, j;
+  for (i=1;i<parameters.num_threads;++i) {
+    for (j=0;j<GT_STATS_MAPQ_RANGE;++j) mapq[j] += mapq[i*GT_STATS_MAPQ_RANGE+j];
+  }
 
   // Print Statistics
   if (!parameters.quiet) {
     if (!parameters.compact) {
-      gt_stats_print_stats(stats[0],(parameters.num_reads>0)?
+      gt_stats_print_stats(stats[0],duplicates,(parameters.num_reads>0)?
           parameters.num_reads:stats[0]->num_blocks,parameters.paired_end);
+      if (parameters.mapq_profile) {
+        fprintf(stderr,"[MAPQ.PROFILE]\n");
+        gt_stats_print_mapq_profile(mapq,stats[0]->num_mapped);
+      }
     } else {
       gt_stats_print_stats_compact(stats[0],(parameters.num_reads>0)?
           parameters.num_reads:stats[0]->num_blocks,parameters.paired_end);
     }
   }
 
+  // Report a saturated duplicates tracker (whatever the output mode)
+  if (duplicates!=NULL && gt_duplicates_get_num_untracked(duplicates)>0) {
+    gt_error_msg("Duplicates signatures table full (%"PRIu64" MB). %"PRIu64" templates not tracked, "
+        "duplicates of them are not detected (increase --duplicates-memory)",
+        parameters.duplicates_memory,gt_duplicates_get_num_untracked(duplicates));
+  }
+
   // Clean
-  gt_stats_delete(stats[0]); free(stats);
+  gt_stats_delete(stats[0]); free(stats); free(mapq);
+  if (duplicates!=NULL) gt_duplicates_delete(duplicates);
   gt_input_file_close(input_file);
 }
 
@@ -225,10 +306,15 @@ void usage() {
                   "        --mismatch-transitions|T\n"
                   "        --mismatch-quality|Q\n"
                   "        --splitmaps-profile|S\n"
-                 // "        --indel-profile|I\n"
+                  "        --indel-profile|I (requires --reference)\n"
+                  "        --mapq-profile|m\n"
+                  "        --duplicates|D\n"
+                  "        --optical-distance [PIXELS] (default=100)\n"
+                  "        --duplicates-memory [MB] (default=256)\n"
                   "       [Output]\n"
                   "        --compact|c\n"
                   "        --verbose|v\n"
+                  "        --profile\n"
                   "        --quiet|q\n"
                   "       [Misc]\n"
                   "        --threads|t\n"
@@ -252,9 +338,14 @@ void parse_arguments(int argc,char** argv) {
     { "mismatch-quality", no_argument, 0, 'Q' },
     { "splitmaps-profile", no_argument, 0, 'S' },
     { "indel-profile", no_argument, 0, 'I' },
+    { "mapq-profile", no_argument, 0, 'm' },
+    { "duplicates", no_argument, 0, 'D' },
+    { "optical-distance", required_argument, 0, 4 },
+    { "duplicates-memory", required_argument, 0, 5 },
     /* [Output] */
     { "compact", no_argument, 0, 'c' },
     { "verbose", no_argument, 0, 'v' },
+    { "profile", no_argument, 0, 6 },
     { "quiet", no_argument, 0, 'q' },
     /* [Misc] */
     { "threads", required_argument, 0, 't' },
@@ -262,7 +353,7 @@ void parse_arguments(int argc,char** argv) {
     { 0, 0, 0, 0 } };
   int c,option_index;
   while (1) {
-    c=getopt_long(argc,argv,"i:r:pn:aMTQSIcvqt:h",long_options,&option_index);
+    c=getopt_long(argc,argv,"i:r:pn:aMTQSImDcvqt:h",long_options,&option_index);
     if (c==-1) break;
     switch (c) {
     /* [Input] */
@@ -293,6 +384,7 @@ void parse_arguments(int argc,char** argv) {
       parameters.mismatch_transitions = true;
       parameters.mismatch_quality = true;
       parameters.splitmaps_profile = true;
+      parameters.mapq_profile = true;
       break;
     case 'M': // --maps-profile
       parameters.maps_profile = true;
@@ -309,6 +401,18 @@ void parse_arguments(int argc,char** argv) {
     case 'I': // --indel-profile
       parameters.indel_profile = true;
       break;
+    case 'm': // --mapq-profile
+      parameters.mapq_profile = true;
+      break;
+    case 'D': // --duplicates
+      parameters.duplicates = true;
+      break;
+    case 4: // --optical-distance
+      parameters.optical_distance = atol(optarg);
+      break;
+    case 5: // --duplicates-memory
+      parameters.duplicates_memory = atol(optarg);
+      break;
     /* [Output] */
     case 'c':
       parameters.compact = true;
@@ -316,6 +420,9 @@ void parse_arguments(int argc,char** argv) {
     case 'v':
       parameters.verbose = true;
       break;
+    case 6:
+      parameters.profile = true;
+      break;
     case 'q':
       parameters.quiet = true;
       break;
@@ -342,10 +449,15 @@ void parse_arguments(int argc,char** argv) {
 int main(int argc,char** argv) {
   // Parsing command-line options
   parse_arguments(argc,argv);
+  gt_profile_enable(parameters.profile);
 
   // Extract stats
   gt_stats_parallel_generate_stats();
 
+  // Profile
+  if (parameters.profile) gt_profile_print(stderr);
+  gt_profile_destroy();
+
   return 0;
 }
 
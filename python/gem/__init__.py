@@ -17,7 +17,6 @@ import gem
 import gem.junctions
 import __builtin__
 
-import multiprocessing as mp
 
 
 LOG_NOTHING = 1
@@ -221,10 +220,10 @@ def _prepare_quality_parameter(quality, input=None):
     quality -- the quality offset, 33|64, None to ignore or a string that
                 is either offset-33|offset-64|ignore
     input   -- optional input that can be checkd for a quality parameter. This
-               currently works only for gemtools.TemplateIterator or gemtools.InputFile
-               instances
+               currently works only for gemtools.TemplateIterator, gemtools.InputFile
+               or gemtools.tee_stats instances
     """
-    if quality is None and isinstance(input, (gt.InputFile)):
+    if quality is None and isinstance(input, (gt.InputFile, gt.tee_stats)):
         quality = input.quality
 
     ## check quality
@@ -633,17 +632,17 @@ def extract_junctions(input,
     if annotation is not None:
         annotation_junctions = annotation
         if isinstance(annotation, basestring):
-            annotation_junctions = gem.junctions.from_gtf(annotation)
+            annotation_junctions = gem.junctions.junction_set_from_gtf(annotation)
 
     denovo_junctions = splits.extract_denovo_junctions(
-        splitmap.raw_stream(),  # pass the raw stream
+        splitmap,
         minsplit=min_split,
         maxsplit=max_split,
         coverage=coverage,
         sites=merge_with,
         max_junction_matches=max_junction_matches,
         process=splitmap.process,
-        threads=max(1, threads / 2),
+        threads=threads,
         annotation_junctions=annotation_junctions
     )
     return denovo_junctions
@@ -1041,26 +1040,16 @@ class merger(object):
         m = gt.merge(files)
         return m.__iter__()
 
-    def __async_merge(self, threads):
-        of = gt.OutputFile(self._output, clean_id=False, append_extra=True)
-        files = [self.target]
-        files.extend(self.source)
-        gt.merge(files).write_stream(of, write_map=True, threads=threads)
-        of.close()
-        self._output.close()
-
     def merge_async(self, threads=1, paired=False, same_content=False):
         (r, w) = os.pipe()
         self._input = os.fdopen(r, 'r')
         self._output = os.fdopen(w, 'w')
-        process = mp.Process(target=merger.__async_merge, args=(self, threads))
-        gem.utils.register_process(process)
-
-        def ww():
-            process.join()
-        process.wait = ww
-        process.start()
-        self._output.close()
+        of = gt.OutputFile(self._output, clean_id=False, append_extra=True)
+        files = [self.target]
+        files.extend(self.source)
+        # the merge runs on a native thread that writes to its own copy
+        # of the pipe, the output is closed by write_stream
+        process = gt.merge(files).write_stream(of, write_map=True, threads=threads, async=True)
         return gt.InputFile(self._input, process=process)
 
     def merge(self, output, threads=1, paired=False, same_content=False, compress=False):
@@ -1077,19 +1066,15 @@ class merger(object):
                 return gt.InputFile(self._input, process=process)
                 #return self.merge_async(threads=threads, paired=paired, same_content=same_content)
 
-            p = None
-            out = output
             if compress and not output.endswith(".gz"):
                 output += ".gz"
-            if compress:
-                p = subprocess.Popen(_compressor(threads=max(1, threads / 2)), stdout=open(output, 'wb'), stdin=subprocess.PIPE, close_fds=True)
-                out = p.stdin
 
             logging.debug("Using merger with %d threads and same content" % (threads))
             files = [self.target]
             files.extend(self.source)
             merger = gt.merge(files)
-            out = gt.OutputFile(output)
+            # compression is done in-process by the writer (threads as pigz had)
+            out = gt.OutputFile(output, compress=compress, compress_threads=max(1, threads / 2))
 
             merger.write_stream(out, write_map=True, threads=threads)
             return gt.InputFile(output)
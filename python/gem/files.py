@@ -134,7 +134,7 @@ def open_gzip(file_name):
     if not isinstance(file_name, basestring):
         raise ValueError("The provided file name is not a string : %s" % (file_name))
     parameter = [__zcat(), file_name]
-    zcat = subprocess.Popen(parameter, stdout=subprocess.PIPE)
+    zcat = subprocess.Popen(parameter, stdout=subprocess.PIPE, close_fds=True)
     return zcat.stdout
 
 
@@ -67,6 +67,28 @@ def trim(reads, left_trim=0, right_trim=0, min_length=10, append_label=False):
     return gt.trim(reads.__iter__(), left_trim, right_trim, min_length, append_label)
 
 
+def auto_trim(reads, quality=0, quality_offset=33, adapters=None, adapter_min_overlap=3,
+              adapter_error_rate=0.1, poly_a=0, trim_n=False, min_length=10, append_label=False):
+    """Trim reads by quality (BWA-like 3' trimming with the given
+    phred threshold), clip 3' adapters (allowing adapter_error_rate
+    mismatches per overlapping base), clip poly-A tails of at least
+    poly_a bases and remove N's from both ends if trim_n is set.
+    If the resulting read length < min_length, the read is not trimmed
+    and returned as is
+    """
+    return gt.auto_trim(reads.__iter__(), quality, quality_offset, adapters, adapter_min_overlap,
+                        adapter_error_rate, poly_a, trim_n, min_length, append_label)
+
+
+def mapq(reads, min_mapq=0, quality_offset=33, max_mapq=60):
+    """Compute the MAPQ of the mappings on the fly (stored as the
+    map scores) and filter out templates with a MAPQ below min_mapq.
+    The MAPQ is calibrated out of the counters, the strata distances
+    and the mismatch qualities/indels of each map
+    """
+    return gt.mapq(reads.__iter__(), min_mapq, quality_offset, max_mapq)
+
+
 def _iterate_iterators(input):
     """Generator function that iterates over a list of iterables
     and return their values
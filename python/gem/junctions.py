@@ -10,6 +10,7 @@ import subprocess
 import sys
 import gem.filter
 import gem
+import gem.gemtools
 import logging
 
 class Exon(object):
@@ -72,10 +73,13 @@ class JunctionSite(object):
     and junction sites are comparable with == and !=
     """
 
-    def __init__(self, start_exon=None, stop_exon=None, line=None, coverage=0):
-        """Create a junction site from the start and stop exon"""
+    def __init__(self, start_exon=None, stop_exon=None, line=None, coverage=0, descriptor=None):
+        """Create a junction site from the start and stop exon, a junctions
+        line or an already normalised descriptor"""
         if start_exon is not None:
             self.descriptor = self.__descriptor(start_exon, stop_exon)
+        elif descriptor is not None:
+            self.descriptor = descriptor
         else:
             ## parse from line
             self.descriptor = self.__descriptor_from_line(line)
@@ -176,16 +180,38 @@ def filter_junctions(index, junctions, output):
     jf.close()
 
 
+def to_junction_set(junctions):
+    """
+    Return a native gem.gemtools.JunctionSet with the given
+    junction sites (JunctionSet instances are returned as is)
+    """
+    if isinstance(junctions, gem.gemtools.JunctionSet):
+        return junctions
+    return gem.gemtools.JunctionSet().update(junctions)
+
+
+def from_junction_set(junctions):
+    """Yields the JunctionSites of a native gem.gemtools.JunctionSet"""
+    for d in junctions:
+        yield JunctionSite(descriptor=list(d[:6]), coverage=d[6])
+
+
 def merge_junctions(junction_sets):
     """
     Merge the given set of junctions and return
-    the union
+    the union. If all the sets are native JunctionSets,
+    a JunctionSet is returned
 
     @param junction_sets: list of list of junctions
     @type junction_sets: list
     @return: merged junctions
     @rtype: set
     """
+    if len(junction_sets) > 0 and all(isinstance(js, gem.gemtools.JunctionSet) for js in junction_sets):
+        merged = gem.gemtools.JunctionSet()
+        for js in junction_sets:
+            merged.update(js)
+        return merged
     s = set([])
     for js in junction_sets:
         if s is None:
@@ -245,6 +271,14 @@ def _get_chromosomes(index):
 
 def filter_by_distance(junctions, min_distance, max_distance):
     """Yields the junction sites that have a distance less than equal max_distance"""
+    if isinstance(junctions, gem.gemtools.JunctionSet):
+        filtered = junctions.copy()
+        filtered.filter(min_distance, max_distance)
+        return from_junction_set(filtered)
+    return _filter_by_distance(junctions, min_distance, max_distance)
+
+
+def _filter_by_distance(junctions, min_distance, max_distance):
     for j in junctions:
         d = abs(j.descriptor[2] - j.descriptor[5])
         if min_distance <= d and d <= max_distance:
@@ -267,65 +301,17 @@ def from_junctions(junctions_file):
 
 
 def from_gtf(annotation):
-    """Extract junctions from given gtf annotation"""
-    def __get_id(tr):
-        if tr.startswith("transcript_id"):
-            t = tr.split(" ")[1]
-            if t[-1] == ";": t = t[:-1]
-            if t[0] == '"': t = t[1:]
-            if t[-1] == '"': t = t[:-1]
-            return t
-        return None
-
-    def __extract_transcript(cell, check_first=0):
-        split = [s.strip() for s in cell.split(";")]
-        t = None
-        if len(split) < check_first:
-            t = __get_id(split[check_first])
-        if t is not None:
-            return t
-        for s in split:
-            t = __get_id(s)
-            if t is not None:
-                return t
-        return None
-
-    in_fd = gem.files.open_file(annotation)  ##open(annotation, 'rb')
-    #trans_re = re.compile('.*transcript_id "(.*)";.*')
-    junctions = {}
-    line_count = 0
-    for line in in_fd:
-        if line.strip()[0] == '#':
-            logging.debug("Skipping comment line")
-            # skip comment
-            continue
-        line_count += 1
-        split = line.split("\t")
-        if len(split) < 8:
-            logging.warning("GTF line %d has < 8 fields, skipping" % line_count)
-            continue
-        if split[2] != "exon":
-            continue
-        #id = trans_re.match(split[8]).group(1) + split[0]
-        try:
-            id = __extract_transcript(split[8].strip())
-            if id is None:
-                logging.error("Failed to extract a transcript id from line %d" % line_count)
-                continue
-            id = id + split[0]
-        except:
-            logging.error("Failed to extract a transcript id from line %d" % line_count)
-            continue
-        start = int(split[3])
-        end = int(split[4])
-        if start != end:
-            exon = Exon(split[0], id, start, end, split[6])
-            junctions.setdefault(id, Junction()).append(exon)
-    logging.debug("Found %d raw sites, extracting unique" % (len(junctions)))
-    unique = sorted(set((
-        site for sites in
-        (junction.sites() for k, junction in junctions.items())
-        for site in sites)))
-    logging.debug("Found %d sites" % (len(unique)))
-    for j in unique:
-        yield j
+    """Extract junctions from given gtf annotation, sorted by
+    chromosome and position"""
+    junctions = junction_set_from_gtf(annotation).sort()
+    logging.debug("Found %d sites" % (len(junctions)))
+    return from_junction_set(junctions)
+
+
+def junction_set_from_gtf(annotation):
+    """Extract the junctions from the given (optionally gzipped) gtf
+    annotation into a native gem.gemtools.JunctionSet. The junctions
+    are the same as from_gtf() yields, with the number of transcripts
+    that contain the junction as coverage
+    """
+    return gem.gemtools.JunctionSet().load_gtf(os.path.abspath(annotation))
@@ -5,7 +5,9 @@ import json
 import logging
 import os
 import errno
+import hashlib
 import signal
+import threading
 import traceback
 
 from gem.utils import Timer
@@ -25,8 +27,250 @@ class PipelineError(Exception):
         self.message = message
 
 
+def parse_memory(value):
+    """Convert a memory specification to bytes. The value
+    is either a number of bytes or ends with one of the
+    K/M/G suffixes
+    """
+    if value is None:
+        return 0
+    value = str(value).strip().upper()
+    factor = 1
+    if len(value) > 0 and value[-1] in "KMG":
+        factor = 1024 ** ("KMG".index(value[-1]) + 1)
+        value = value[:-1]
+    try:
+        return int(float(value) * factor)
+    except ValueError:
+        raise PipelineError("Unable to parse memory specification: %s" % value)
+
+
+# share of the physical memory used as default budget for concurrent steps
+DEFAULT_MEMORY_FRACTION = 0.8
+
+
+def physical_memory():
+    """Return the physical memory of this host in bytes
+    or 0 if it can not be determined
+    """
+    try:
+        return os.sysconf("SC_PAGE_SIZE") * os.sysconf("SC_PHYS_PAGES")
+    except (ValueError, OSError, AttributeError):
+        return 0
+
+
+def write_json(file_name, data):
+    """Atomically write data as json to the given file. The
+    content is written to a temporary file that replaces the
+    target once it is complete
+    """
+    tmp = "%s.%d.tmp" % (file_name, os.getpid())
+    with open(tmp, "w") as f:
+        json.dump(data, f, indent=2, sort_keys=True)
+        f.flush()
+        os.fsync(f.fileno())
+    os.rename(tmp, file_name)
+
+
+class PipelineScheduler(object):
+    """Run pipeline steps as a DAG over their dependencies.
+
+    A step is started as soon as all of its dependencies
+    are completed. The running steps share the pipeline threads,
+    each ready step gets an equal share of the free threads
+    (at least one), and with a memory budget a step is only
+    started if its estimated memory fits next to the running
+    steps. Without parallel execution the steps run one after the
+    other, each with all threads.
+
+    Steps fused into a consumer (see MappingPipeline.fuse() and
+    MappingPipeline.share_inputs()) are not scheduled themselves, they
+    run with the consumer and share its threads. Unless forced, steps that are done (see PipelineStep.is_done())
+    once their dependencies are completed are skipped. Steps attached to
+    a skipped step are then scheduled on their own.
+    """
+    def __init__(self, steps, threads, memory=None, parallel=True, force=False):
+        """Create a scheduler for the given steps (sorted by id)
+
+        steps    -- the steps to run
+        threads  -- the number of threads shared by the steps
+        memory   -- optional memory budget in bytes
+        parallel -- run independent steps concurrently
+        force    -- run all steps, even if they are done
+        """
+        self.steps = steps
+        self.threads = max(1, threads)
+        self.memory = memory
+        self.parallel = parallel
+        self.force = force
+        self.pending = list(steps)
+        self.running = {}  # step id -> estimated memory
+        self.completed = set([])
+        self.failed = []
+        self.times = {}
+        self.used_threads = 0
+        self.used_memory = 0
+        self.condition = threading.Condition()
+        self.__scheduled = set([s.id for s in steps])
+        self.__checked = set([])
+
+    def running_steps(self):
+        """Return the currently running steps"""
+        with self.condition:
+            return [s for s in self.steps if s.id in self.running]
+
+    def __dependencies(self, step):
+        # the dependencies of fused steps are dependencies of the consumer
+        fused = [s.id for s in step.fused]
+        deps = [d for d in step.dependencies if d not in fused]
+        for s in step.fused:
+            deps.extend(self.__dependencies(s))
+        return deps
+
+    def __assign_threads(self, step, threads):
+        step.threads = threads
+        for s in step.fused:
+            self.__assign_threads(s, max(1, threads / len(step.fused)))
+
+    def __memory(self, step):
+        return step.memory() + sum([s.memory() for s in step.fused_steps()])
+
+    def __is_ready(self, step):
+        for d in self.__dependencies(step):
+            if d >= 0 and d in self.__scheduled and d not in self.completed:
+                return False
+        return True
+
+    def __skip_done(self):
+        skipped = True
+        while skipped:
+            skipped = False
+            for step in [s for s in self.pending if self.__is_ready(s) and s.id not in self.__checked]:
+                self.__checked.add(step.id)
+                if step.is_done():
+                    logging.gemtools.warning("Skipping step %s, output is up to date" % (step.name))
+                    self.pending.remove(step)
+                    self.completed.add(step.id)
+                    self.__detach(step)
+                    skipped = True
+
+    def __detach(self, step):
+        # steps attached to a skipped step are scheduled on their own
+        for s in step.detach():
+            logging.gemtools.gt("Computing %s on its own, %s is up to date", s.name, step.name)
+            self.pending.append(s)
+            self.__scheduled.add(s.id)
+        self.pending.sort(key=lambda s: s.id)
+
+    def __start_ready(self):
+        if not self.force:
+            self.__skip_done()
+        ready = [s for s in self.pending if self.__is_ready(s)]
+        if not self.parallel and len(self.running) > 0:
+            return
+        if not self.parallel:
+            ready = ready[:1]
+        free = self.threads - self.used_threads
+        # first pick the steps that fit into the memory budget. The
+        # memory is estimated with all threads a step can get, as the
+        # estimate grows with the threads (i.e. sort buffers)
+        starting = []
+        used_memory = self.used_memory
+        for step in ready:
+            if len(starting) >= free:
+                break
+            threads = free
+            if step.max_threads is not None:
+                threads = min(threads, step.max_threads)
+            self.__assign_threads(step, threads)
+            memory = self.__memory(step)
+            if self.memory and (len(self.running) > 0 or len(starting) > 0) and used_memory + memory > self.memory:
+                logging.gemtools.debug("Delaying step %s, not enough memory", step.name)
+                continue
+            starting.append(step)
+            used_memory += memory
+        # then split the free threads among the steps that start
+        for i, step in enumerate(starting):
+            free = self.threads - self.used_threads
+            threads = max(1, free / (len(starting) - i))
+            if step.max_threads is not None:
+                threads = min(threads, step.max_threads)
+            self.__assign_threads(step, threads)
+            memory = self.__memory(step)
+            self.pending.remove(step)
+            self.running[step.id] = memory
+            self.used_threads += threads
+            self.used_memory += memory
+            logging.gemtools.gt("Running step: %s (threads: %d)" % (step.name, threads))
+            thread = threading.Thread(target=self.__run_step, args=(step,), name=step.name)
+            thread.daemon = True
+            thread.start()
+
+    def __run_step(self, step):
+        error = True
+        t = Timer()
+        try:
+            signature = step.invalidate()
+            step.run()
+            step.wait_fused()
+            step.commit(signature)
+            error = False
+        except PipelineError, e:
+            logging.gemtools.error("Error while executing step %s : %s" % (step.name, str(e)))
+        except gem.utils.ProcessError, e:
+            logging.gemtools.error("Error while executing step %s : %s" % (step.name, str(e)))
+        except Exception, e:
+            traceback.print_exc()
+            logging.gemtools.error("Error while executing step %s : %s" % (step.name, str(e)))
+        finally:
+            t.stop(step.name + " completed in %s", loglevel=None)
+            if not error:
+                logging.gemtools.gt("Step %s finished in : %s", step.name, t.end)
+            else:
+                logging.gemtools.warning("Cleaning up after failed step : %s", step.name)
+                step.abort_fused()
+                step.cleanup(force=True)
+                logging.gemtools.gt("Step %s failed after : %s", step.name, t.end)
+            with self.condition:
+                self.times[step.id] = t.end
+                self.used_threads -= step.threads
+                self.used_memory -= self.running.pop(step.id)
+                if error:
+                    self.failed.append(step)
+                else:
+                    self.completed.add(step.id)
+                self.condition.notify()
+
+    def run(self):
+        """Run all steps and wait for them. No new steps are
+        started after a failure. Returns true if all steps
+        were executed successfully
+        """
+        with self.condition:
+            while len(self.running) > 0 or (len(self.pending) > 0 and len(self.failed) == 0):
+                if len(self.failed) == 0:
+                    self.__start_ready()
+                if len(self.running) == 0:
+                    if len(self.pending) == 0:
+                        # all remaining steps were skipped
+                        break
+                    # nothing can be started
+                    raise PipelineError("Unable to schedule steps: %s" % (", ".join([s.name for s in self.pending])))
+                # wait with timeout to stay responsive to signals
+                self.condition.wait(1.0)
+        return len(self.failed) == 0
+
+
 class PipelineStep(object):
     """General mapping pipeline step"""
+
+    # upper bound for the threads assigned to the step (None => no limit)
+    max_threads = None
+    # the step reads its inputs sequentially and accepts streamed inputs
+    stream_input = True
+    # executables run by the step (their versions are part of the signature)
+    tools = []
+
     def __init__(self, name, dependencies=None, final=False, description=""):
         self.id = None
         self.name = name
@@ -36,6 +280,12 @@ class PipelineStep(object):
         self._files = None
         self.configuration = None
         self.final = final
+        self.threads = 1  # threads assigned by the pipeline scheduler
+        self.streamed = False  # output is streamed into the consuming step
+        self.fused = []  # steps streamed into this step (or attached to it)
+        self.attached = False  # runs within the step that reads the same input
+        self._stream = None
+        self._signature = None
         if dependencies is not None:
             self.dependencies.extend(dependencies)
 
@@ -44,6 +294,7 @@ class PipelineStep(object):
         self.pipeline = pipeline
         self.id = id
         self.configuration = configuration
+        self.threads = pipeline.threads
         # initialize files
         self.files()
 
@@ -95,9 +346,98 @@ class PipelineStep(object):
             return self.pipeline.open_input()
         return self.pipeline.open_step(self.dependencies[-1], raw=raw)
 
+    def streamable(self):
+        """Return true if this step can stream its output
+        (see stream())"""
+        return False
+
+    def stream(self):
+        """Implement this to run the step with its output
+        streamed and return the stream (an InputFile)"""
+        raise PipelineError("Step %s can not stream its output" % self.name)
+
+    def fused_steps(self):
+        """Return all steps that are (transitively) streamed
+        into this step"""
+        steps = []
+        for step in self.fused:
+            steps.extend(step.fused_steps())
+            steps.append(step)
+        return steps
+
+    def wait_fused(self):
+        """Wait for the fused steps and commit them. Raises
+        an error if one of them did not run or failed"""
+        for step in self.fused_steps():
+            step.join_fused()
+            step.commit(step._signature)
+
+    def detach(self):
+        """Detach the steps attached to this step (see
+        MappingPipeline.share_inputs()) and return them"""
+        attached = [s for s in self.fused if s.attached]
+        for step in attached:
+            step.attached = False
+            self.fused.remove(step)
+        return attached
+
+    def abort_fused(self):
+        """Stop and reap the fused steps after this step failed.
+        Their producers would otherwise stay blocked on a full pipe"""
+        for step in self.fused_steps():
+            try:
+                step.abort_stream()
+            except Exception, e:
+                logging.gemtools.warning("Error while stopping streamed step %s : %s", step.name, str(e))
+
+    def abort_stream(self):
+        """Stop the stream of this step after the consumer it is
+        fused into failed (see abort_fused()). The read end of the
+        pipe is replaced by /dev/null, so readers see the end of the
+        stream and writers fail instead of blocking, and the producer
+        processes are terminated and waited for"""
+        stream = self._stream
+        if stream is None:
+            return
+        source = getattr(stream, "source", None)
+        if isinstance(source, file) and not source.closed:
+            devnull = os.open(os.devnull, os.O_RDONLY)
+            try:
+                os.dup2(devnull, source.fileno())
+            finally:
+                os.close(devnull)
+        process = stream.process
+        if process is not None:
+            if hasattr(process, "terminate"):
+                process.terminate()
+            try:
+                process.wait()
+            except Exception:
+                pass  # the producer was stopped, its exit value is meaningless
+
+    def join_fused(self):
+        """Wait for the stream of this step after the consumer
+        it is fused into was executed"""
+        if self._stream is None:
+            raise PipelineError("Output of streamed step %s was not read" % self.name)
+        if self._stream.process is not None:
+            exit_value = self._stream.process.wait()
+            if exit_value is not None and exit_value != 0:
+                raise gem.utils.ProcessError("Streamed step %s finished with %d" % (self.name, exit_value))
+
     def open(self, raw=False):
         """Open the steps output. The default implementation
-        opnes the last file"""
+        opnes the last file. If the step is streamed, it
+        is executed and its output stream is returned"""
+        if self.streamed:
+            if raw:
+                raise PipelineError("Output of step %s is streamed, no file available" % self.name)
+            if self._stream is not None:
+                raise PipelineError("Output of step %s is streamed and can only be read once" % self.name)
+            logging.gemtools.debug("Streaming step %s output", self.name)
+            self._signature = self.invalidate()
+            self._stream = self.stream()
+            return self._stream
         fs = self.files()
         if len(fs) > 0:
             if raw:
@@ -114,13 +454,118 @@ class PipelineStep(object):
         """Return true if this step is done and
         does not need execution
 
-        The basic implementation checks if all files exists
+        The basic implementation checks if all files exists. With
+        caching enabled, the step must also have been committed
+        with its current signature and the outputs must still have
+        the committed content
         """
         for f in self.files():
             if not os.path.exists(f):
                 return False
+        if not self.pipeline.cache:
+            return True
+        stamp = self._committed()
+        if stamp is None or stamp.get("streamed", False):
+            return False
+        outputs = stamp.get("outputs", {})
+        for f in self.files():
+            if f not in outputs or outputs[f] != self.pipeline.checksum(f):
+                return False
         return True
 
+    def signature(self):
+        """Return the content address of this step, a checksum
+        over the step configuration, the versions of the tools it
+        runs and the content of its inputs, the reads, the
+        configured files (indexes, keys and annotations, see
+        MappingPipeline.input_files()) and the outputs of its
+        dependencies. Returns None if an input is not available
+        """
+        h = hashlib.sha1()
+        h.update(self.__class__.__name__)
+        h.update(json.dumps(self.configuration, sort_keys=True, default=str))
+        input_files = self.pipeline.input_files()
+        for key in sorted(self.configuration.keys()):
+            value = self.configuration[key]
+            if isinstance(value, basestring) and os.path.abspath(value) in input_files:
+                h.update("%s:%s" % (key, self.pipeline.checksum(value)))
+        h.update(json.dumps(self.pipeline.signature_parameters(), sort_keys=True, default=str))
+        for tool in self.tools:
+            h.update(self.pipeline.tool_version(tool))
+        h.update(self.pipeline.tool_version(None))
+        for f in self.pipeline.input:
+            h.update(self.pipeline.checksum(f))
+        for d in self.dependencies:
+            if d < 0:
+                continue
+            digest = self.pipeline.steps[d].output_digest()
+            if digest is None:
+                return None
+            h.update(digest)
+        return h.hexdigest()
+
+    def _committed(self):
+        """Return the commit record of this step if it was
+        committed with its current signature"""
+        stamp = self.pipeline.load_stamp(self)
+        if stamp is None or stamp.get("signature", None) is None:
+            return None
+        if stamp["signature"] != self.signature():
+            return None
+        return stamp
+
+    def output_digest(self):
+        """Return the digest of this steps output, the committed
+        checksums of the output files (which might have been removed
+        since) or the signature of a streamed step. Returns None if
+        the step was not committed with its current signature
+        """
+        if self.streamed:
+            return self.signature()
+        stamp = self._committed()
+        if stamp is None:
+            return None
+        if stamp.get("streamed", False):
+            return stamp["signature"]
+        outputs = stamp.get("outputs", {})
+        return ",".join([str(outputs.get(f, None)) for f in self.files()])
+
+    def invalidate(self):
+        """Remove the commit of this step before it is executed
+        and return the signature to commit the step with"""
+        if not self.pipeline.cache:
+            return None
+        self.pipeline.remove_stamp(self)
+        return self.signature()
+
+    def commit(self, signature):
+        """Commit the outputs of a successfully executed step
+        with the signature computed before it was executed"""
+        if not self.pipeline.cache:
+            return
+        if self.streamed:
+            self.pipeline.write_stamp(self, {"signature": signature, "streamed": True, "outputs": {}})
+            return
+        outputs = {}
+        for f in self.files():
+            if not os.path.exists(f):
+                logging.gemtools.warning("Output %s of step %s not found, step is not committed", f, self.name)
+                return
+            outputs[f] = self.pipeline.checksum(f)
+        self.pipeline.write_stamp(self, {"signature": signature, "outputs": outputs})
+
+    def memory(self):
+        """Return the estimated memory (in bytes) this step
+        needs with its assigned threads. The basic implementation
+        accounts for the GEM index, which is loaded by the tools
+        """
+        index = None
+        if self.configuration is not None:
+            index = self.configuration.get("index", None)
+        if index is not None and os.path.exists(index):
+            return os.path.getsize(index)
+        return 0
+
 
 class PrepareInputStep(PipelineStep):
     """Prepare multiple input files,
@@ -154,18 +599,30 @@ class PrepareInputStep(PipelineStep):
 class MergeStep(PipelineStep):
     """Merge up to the current step"""
 
-    def run(self):
-        """Merge current set of mappings and delete last ones"""
+    tools = ["gem-2-gem"]
+
+    def streamable(self):
+        # only the same content merger writes to a stream
+        return self.configuration.get("same_content", True)
+
+    def stream(self):
+        return self._merge(None, False)
+
+    def _merge(self, output, compress):
         same_content = self.configuration.get("same_content", True)
         inputs = self._input()
         master = inputs[0]
         slaves = inputs[1:]
-        mapping = gem.merger(master, slaves).merge(self._output(), self.pipeline.threads, same_content=same_content, compress=self._compress())
+        return gem.merger(master, slaves).merge(output, self.threads, same_content=same_content, compress=compress)
+
+    def run(self):
+        """Merge current set of mappings and delete last ones"""
+        mapping = self._merge(self._output(), self._compress())
 
         if self.final:
             gem.score(mapping, self.configuration["index"], self._final_output(),
                 filter=self.pipeline.filter,
-                threads=max(2, self.pipeline.threads / 2),
+                threads=max(2, self.threads / 2),
                 quality=self.pipeline.quality,
                 compress=self.pipeline.compress
             )
@@ -180,6 +637,9 @@ class MergeStep(PipelineStep):
 
 class MergeAndPairStep(PipelineStep):
     """Do merging and pairing in one single step"""
+
+    tools = ["gem-mapper", "gem-2-gem"]
+
     def run(self):
         cfg = self.configuration
         same_content = self.configuration.get("same_content", True)
@@ -187,7 +647,7 @@ class MergeAndPairStep(PipelineStep):
         master = inputs[0]
         slaves = inputs[1:]
 
-        mapping = gem.merger(master, slaves).merge(None, threads=self.pipeline.threads, same_content=same_content, compress=False)
+        mapping = gem.merger(master, slaves).merge(None, threads=self.threads, same_content=same_content, compress=False)
 
         pair_mapping = gem.pairalign(
             mapping,
@@ -202,14 +662,14 @@ class MergeAndPairStep(PipelineStep):
           min_matched_bases=cfg["min_matched_bases"],
           max_extendable_matches=cfg["max_extendable_matches"],
           max_matches_per_extension=cfg["max_matches_per_extension"],
-          threads=max(2, self.pipeline.threads / 2),  # self.pipeline.threads,
+          threads=max(2, self.threads / 2),  # self.threads,
           quality=self.pipeline.quality,
           compress=self._compress())
 
         if self.final:
             gem.score(pair_mapping, cfg["index"], self._final_output(),
                 filter=self.pipeline.filter,
-                threads=self.pipeline.threads,  # max(2, self.pipeline.threads / 2),
+                threads=self.threads,  # max(2, self.threads / 2),
                 quality=self.pipeline.quality,
                 compress=self.pipeline.compress,
                 raw=True)
@@ -225,6 +685,9 @@ class MergeAndPairStep(PipelineStep):
 class CreateStatsStep(PipelineStep):
     """Create stats file"""
 
+    # the stats filled while attached to another step (see tee())
+    _stats = None
+
     def files(self):
         if self._files is None:
             self._files = []
@@ -232,23 +695,35 @@ class CreateStatsStep(PipelineStep):
             self._files.append(self.pipeline.create_file_name(self.name, name_suffix=".stats.all", file_suffix="json", final=self.final))
             self._files.append(self.pipeline.create_file_name(self.name, name_suffix=".stats.best", file_suffix="txt", final=self.final))
             self._files.append(self.pipeline.create_file_name(self.name, name_suffix=".stats.best", file_suffix="json", final=self.final))
+            self._files.append(self.pipeline.create_file_name(self.name, name_suffix=".stats.all", file_suffix="bin", final=self.final))
+            self._files.append(self.pipeline.create_file_name(self.name, name_suffix=".stats.best", file_suffix="bin", final=self.final))
         return self._files
 
-    def run(self):
-        def __read__write_stats(cfg, all_stats, best_stats, threads, out, infile):
-            gt.read_stats(infile, all_stats, best_stats, threads=threads)
-            # out = self.files()
-            if cfg['stats_json'] is not None:
-                with open(out[1], 'w') as f:
-                    json.dump(all_stats.__dict__, f)
-                with open(out[3], 'w') as f:
-                    json.dump(best_stats.__dict__, f)
+    def _write_stats(self, all_stats, best_stats):
+        cfg = self.configuration
+        out = self.files()
+        if cfg['stats_json'] is not None:
+            with open(out[1], 'w') as f:
+                json.dump(all_stats.__dict__, f)
+            with open(out[3], 'w') as f:
+                json.dump(best_stats.__dict__, f)
+
+        with open(out[0], 'w') as f:
+            all_stats.write(f)
+
+        with open(out[2], 'w') as f:
+            best_stats.write(f)
 
-            with open(out[0], 'w') as f:
-                all_stats.write(f)
+        with open(out[4], 'wb') as f:
+            all_stats.write_binary(f)
 
-            with open(out[2], 'w') as f:
-                best_stats.write(f)
+        with open(out[5], 'wb') as f:
+            best_stats.write_binary(f)
+
+    def run(self):
+        def __read__write_stats(step, all_stats, best_stats, threads, infile):
+            gt.read_stats(infile, all_stats, best_stats, threads=threads)
+            step._write_stats(all_stats, best_stats)
 
         cfg = self.configuration
         infile = self._input()
@@ -258,10 +733,31 @@ class CreateStatsStep(PipelineStep):
         import gem.utils
         import multiprocessing
 
-        process = multiprocessing.Process(target=__read__write_stats, args=(cfg, all_stats, best_stats, self.pipeline.threads, self.files(), infile))
+        process = multiprocessing.Process(target=__read__write_stats, args=(self, all_stats, best_stats, self.threads, infile))
         gem.utils.register_process(process)
         process.start()
         process.join()
+        if process.exitcode != 0:
+            raise PipelineError("Stats process of step %s finished with %d" % (self.name, process.exitcode))
+
+    def tee(self, infile):
+        """Run the step attached to the step that reads the same input
+        and return the input wrapped to fill the stats while that step
+        reads it (see MappingPipeline.share_inputs())"""
+        cfg = self.configuration
+        self._signature = self.invalidate()
+        self._stats = (gt.Stats(False, cfg["stats_paired"]), gt.Stats(True, cfg["stats_paired"]))
+        return gt.tee_stats(infile, self._stats[0], self._stats[1], threads=self.threads)
+
+    def abort_stream(self):
+        self._stats = None
+
+    def join_fused(self):
+        stats = self._stats
+        if stats is None:
+            raise PipelineError("Stats of step %s were not computed" % self.name)
+        self._stats = None
+        self._write_stats(stats[0], stats[1])
 
 
 
@@ -270,27 +766,50 @@ class CreateStatsStep(PipelineStep):
 class CreateBamStep(PipelineStep):
     """Create BAM file"""
 
+    tools = ["gem-2-sam", "samtools"]
+    # stats step filled from the gem-2-sam input (see MappingPipeline.share_inputs())
+    stats = None
+
     def files(self):
         if self._files is None:
             self._files = []
             self._files.append(self.pipeline.create_file_name(self.name, file_suffix="bam", final=self.final))
         return self._files
 
+    def detach(self):
+        self.stats = None
+        return PipelineStep.detach(self)
+
+    def memory(self):
+        """The GEM index for gem2sam and the samtools sort
+        buffers of all threads"""
+        mem = PipelineStep.memory(self)
+        if self.configuration["sort"]:
+            mem += self.threads * parse_memory(self.pipeline.sort_memory)
+        return mem
+
     def run(self):
         cfg = self.configuration
-        sam = gem.gem2sam(self._input(), cfg["index"],
-                          threads=self.pipeline.threads,
+        infile = self._input()
+        if self.stats is not None:
+            infile = self.stats.tee(infile)
+        sam = gem.gem2sam(infile, cfg["index"],
+                          threads=self.threads,
                           quality=self.pipeline.quality,
                           consensus=cfg['consensus'],
                           exclude_header=cfg['sam_no_seq_header'],
                           compact=cfg['sam_compact'],
                           calc_xs=cfg['calc_xs'])
-        gem.sam2bam(sam, self._final_output(), sorted=cfg["sort"], mapq=cfg["mapq"], threads=self.pipeline.threads, sort_memory=self.pipeline.sort_memory)
+        gem.sam2bam(sam, self._final_output(), sorted=cfg["sort"], mapq=cfg["mapq"], threads=self.threads, sort_memory=self.pipeline.sort_memory)
 
 
 class IndexBamStep(PipelineStep):
     """Index BAM file"""
 
+    max_threads = 1
+    stream_input = False
+    tools = ["samtools"]
+
     def files(self):
         if self._files is None:
             self._files = []
@@ -304,12 +823,21 @@ class IndexBamStep(PipelineStep):
 
 class MapStep(PipelineStep):
     """Mapping step"""
-    def run(self):
+
+    tools = ["gem-mapper", "gem-2-gem"]
+
+    def streamable(self):
+        return True
+
+    def stream(self):
+        return self._map(None, False)
+
+    def _map(self, output, compress):
         cfg = self.configuration
-        mapping = gem.mapper(
+        return gem.mapper(
             self._input(),
             cfg["index"],
-            self._output(),
+            output,
             mismatches=cfg["mismatches"],
             quality_threshold=cfg["quality_threshold"],
             max_decoded_matches=cfg["max_decoded_matches"],
@@ -321,13 +849,17 @@ class MapStep(PipelineStep):
             delta=cfg["strata_after_best"],
             trim=cfg["trim"],
             quality=self.pipeline.quality,
-            threads=self.pipeline.threads,
-            compress=self._compress()
+            threads=self.threads,
+            compress=compress
         )
+
+    def run(self):
+        cfg = self.configuration
+        mapping = self._map(self._output(), self._compress())
         if self.final:
             gem.score(mapping, cfg["index"], self._final_output(),
                 filter=self.pipeline.filter,
-                threads=max(2, self.pipeline.threads / 2),
+                threads=max(2, self.threads / 2),
                 quality=self.pipeline.quality,
                 compress=self.pipeline.compress
             )
@@ -335,12 +867,21 @@ class MapStep(PipelineStep):
 
 class PairalignStep(PipelineStep):
     """Pairalign"""
-    def run(self):
+
+    tools = ["gem-mapper", "gem-2-gem"]
+
+    def streamable(self):
+        return True
+
+    def stream(self):
+        return self._pair(None, False)
+
+    def _pair(self, output, compress):
         cfg = self.configuration
-        mapping = gem.pairalign(
+        return gem.pairalign(
             self._input(),
             cfg["index"],
-            self._output(),
+            output,
           quality_threshold=cfg["quality_threshold"],
           max_decoded_matches=cfg["max_decoded_matches"],
           min_decoded_strata=cfg["min_decoded_strata"],
@@ -350,14 +891,17 @@ class PairalignStep(PipelineStep):
           min_matched_bases=cfg["min_matched_bases"],
           max_extendable_matches=cfg["max_extendable_matches"],
           max_matches_per_extension=cfg["max_matches_per_extension"],
-          threads=self.pipeline.threads,
+          threads=self.threads,
           quality=self.pipeline.quality,
-          compress=self._compress())
+          compress=compress)
 
+    def run(self):
+        cfg = self.configuration
+        mapping = self._pair(self._output(), self._compress())
         if self.final:
             gem.score(mapping, cfg["index"], self._final_output(),
                 filter=self.pipeline.filter,
-                threads=max(2, self.pipeline.threads / 2),
+                threads=max(2, self.threads / 2),
                 quality=self.pipeline.quality,
                 compress=self.pipeline.compress)
 
@@ -365,6 +909,8 @@ class PairalignStep(PipelineStep):
 class CreateDenovoTranscriptomeStep(PipelineStep):
     """Create denovo transcriptome"""
 
+    tools = ["gem-rna-mapper", "gem-2-gem", "gem-info", "compute-transcriptome", "gem-indexer"]
+
     def files(self):
         """Return the output files generated by this step.
         By default one .map output file is generated
@@ -397,7 +943,7 @@ class CreateDenovoTranscriptomeStep(PipelineStep):
             filter=cfg["filter"],
             splice_consensus=cfg["junctions_consensus"],
             mismatches=cfg["mismatches"],
-            threads=self.pipeline.threads,
+            threads=self.threads,
             strata_after_first=cfg["strata_after_best"],
             coverage=cfg["coverage"],
             min_split=cfg["min_split_length"],
@@ -431,7 +977,7 @@ class CreateDenovoTranscriptomeStep(PipelineStep):
         (denovo_transcriptome, denovo_keys) = gem.compute_transcriptome(self.pipeline.max_read_length, cfg["index"], self.junctions_out, junctions_gtf_out)
 
         logging.gemtools.gt("Indexing denovo transcriptome")
-        gem.index(denovo_transcriptome, self.index_denovo_out, threads=self.pipeline.threads)
+        gem.index(denovo_transcriptome, self.index_denovo_out, threads=self.threads)
         return (self.index_denovo_out, self.denovo_keys)
 
     def cleanup(self, force=False):
@@ -445,6 +991,8 @@ class CreateDenovoTranscriptomeStep(PipelineStep):
 class ExtractJunctionsStep(PipelineStep):
     """Extract denovo junctions"""
 
+    tools = ["gem-rna-mapper", "gem-2-gem", "gem-info"]
+
     def files(self):
         if self._files is None:
             self._files = []
@@ -462,7 +1010,7 @@ class ExtractJunctionsStep(PipelineStep):
             filter=cfg["filter"],
             splice_consensus=cfg["junctions_consensus"],
             mismatches=cfg["mismatches"],
-            threads=self.pipeline.threads,
+            threads=self.threads,
             strata_after_first=cfg["strata_after_best"],
             coverage=cfg["coverage"],
             min_split=cfg["min_split_length"],
@@ -486,12 +1034,23 @@ class ExtractJunctionsStep(PipelineStep):
 class SplitMapStep(PipelineStep):
     """Call the split mapper"""
 
+    tools = ["gem-rna-mapper", "gem-2-gem"]
+
+    def streamable(self):
+        return True
+
+    def stream(self):
+        return self._splitmap(None)
+
     def run(self):
         """Extract denovo junctions"""
+        return self._splitmap(self._final_output())
+
+    def _splitmap(self, output):
         cfg = self.configuration
         splitmap = gem.splitmapper(self._input(),
                 cfg["index"],
-                output=self._final_output(),
+                output=output,
                 mismatches=cfg["mismatches"],
                 splice_consensus=cfg["junctions_consensus"],
                 filter=cfg["filter"],
@@ -504,7 +1063,7 @@ class SplitMapStep(PipelineStep):
                 trim=cfg["trim"],
                 filter_splitmaps=True,
                 post_validate=True,
-                threads=self.pipeline.threads,
+                threads=self.threads,
                 extra=None)
         return splitmap
 
@@ -512,6 +1071,8 @@ class SplitMapStep(PipelineStep):
 class TranscriptMapStep(PipelineStep):
     """Transcript Mapping step"""
 
+    tools = ["gem-mapper", "gem-2-gem", "transcriptome-2-genome"]
+
     def prepare(self, id, pipeline, config):
         PipelineStep.prepare(self, id, pipeline, config)
         if config["denovo"]:
@@ -528,17 +1089,26 @@ class TranscriptMapStep(PipelineStep):
                 # this is ugly but we have to increase the id here as we squeezed in another job
                 self.id = create_step_id + 1
 
+    def streamable(self):
+        return True
+
+    def stream(self):
+        return self._map(None)
+
     def run(self):
+        self._map(self.files()[0])
+
+    def _map(self, output):
         cfg = self.configuration
         if cfg["denovo"] and cfg["create_index"]:
             step = self.pipeline.steps[cfg["create_index"]]
             cfg["index"] = step.index_denovo_out
             cfg["keys"] = step.denovo_keys
 
-        gem.mapper(
+        return gem.mapper(
             self._input(),
             cfg["index"],
-            self.files()[0],
+            output,
             mismatches=cfg["mismatches"],
             quality_threshold=cfg["quality_threshold"],
             max_decoded_matches=cfg["max_decoded_matches"],
@@ -551,7 +1121,7 @@ class TranscriptMapStep(PipelineStep):
             trim=cfg["trim"],
             key_file=cfg["keys"],
             quality=self.pipeline.quality,
-            threads=self.pipeline.threads
+            threads=self.threads
         )
 
     def _input(self, raw=False):
@@ -606,6 +1176,13 @@ class MappingPipeline(object):
         self.sort_memory = "768M"  # samtools sort memory
         self.direct_input = False  # if true, skip the preparation step
         self.force = False  # force computation of all steps
+        self.parallel = True  # run independent steps concurrently
+        self.max_memory = None  # memory budget shared by concurrent steps (None => share of the physical memory)
+        self.stream = False  # stream intermediate outputs between steps
+        self.cache = True  # skip steps whose signature and outputs are unchanged
+        self._checksums = None  # file checksum cache
+        self._checksum_lock = threading.Lock()
+        self._tool_versions = {}
 
         self.filter_max_matches = 25
         self.filter_min_strata = 1
@@ -1195,6 +1772,10 @@ index generated from your annotation.""")
         printer("Sort BAM         : %s", self.bam_sort)
         printer("Index BAM        : %s", self.bam_index)
         printer("Keep Temporary   : %s", not self.remove_temp)
+        printer("Parallel steps   : %s", self.parallel)
+        printer("Memory budget    : %s", self.memory_budget())
+        printer("Stream steps     : %s", self.stream)
+        printer("Step caching     : %s", self.cache)
         printer("")
 
         if not run_step:
@@ -1247,6 +1828,9 @@ index generated from your annotation.""")
         del json_container["steps"]
         del json_container["run_steps"]
         del json_container["write_config"]
+        for k in json_container.keys():
+            if k.startswith("_"):
+                del json_container[k]
         # remove non default values
         default_pipeline = MappingPipeline()
         default_pipeline.initialize(silent=True)
@@ -1271,21 +1855,7 @@ index generated from your annotation.""")
             return
 
         error = False
-
-        all_done = True
-        final_files = []
-        # check final steps if we are not running a set of steps
-        if not run_step and not self.force:
-            for step in self.steps:
-                if step.final:
-                    final_files.extend(step.files())
-                    all_done = all_done & step.is_done()
-            if all_done:
-                logging.gemtools.warning("The following files already exist. Nothing to be run!\n\n%s\n" % ("\n".join(final_files)))
-                return
-
         time = Timer()
-        times = {}
 
         if run_step:
             # sort by id
@@ -1294,82 +1864,82 @@ index generated from your annotation.""")
         if run_step:
             ids = self.run_steps
 
-        step = None
+        steps = [self.steps[i] for i in ids]
+        force = run_step or self.force
+
+        if not force:
+            # a step is needed if it is not done and it is final
+            # or one of the steps reading its output is needed
+            needed = set([])
+            for step in reversed(steps):
+                if step.is_done():
+                    continue
+                consumers = [s.id for s in self.steps if step.id in s.dependencies]
+                if step.final or len(consumers) == 0 or len(needed.intersection(consumers)) > 0:
+                    needed.add(step.id)
+            steps = [s for s in steps if s.id in needed]
+            if len(steps) == 0:
+                final_files = []
+                for step in self.steps:
+                    if step.final:
+                        final_files.extend(step.files())
+                logging.gemtools.warning("The following files are up to date. Nothing to be run!\n\n%s\n" % ("\n".join(final_files)))
+                return
+
+        if run_step:
+            # check dependencies that are not part of this run are done
+            for step in steps:
+                for d in step.dependencies:
+                    if d >= 0 and d not in ids and not self.steps[d].is_done():
+                        logging.gemtools.error("Step dependency is not completed : %s", self.steps[d].name)
+                        error = True
+            if error:
+                return
+
+        if not os.path.exists(self.output_dir):
+            # make sure we create the ouput folder
+            logging.gemtools.warn("Creating output folder %s", self.output_dir)
+            try:
+                os.makedirs(self.output_dir)
+            except OSError as exc: # Python >2.5
+                if exc.errno == errno.EEXIST and os.path.isdir(self.output_dir):
+                    pass
+                else:
+                    logging.gemtools.error("unable to create output folder %s", self.output_dir)
+                    return
+
+        if self.stream:
+            steps = self.fuse(steps, force=force)
+        steps = self.share_inputs(steps)
+
+        parallel = self.parallel
+        memory = self.memory_budget()
+        if parallel and memory is None:
+            logging.gemtools.warning("Unable to determine the physical memory, running steps one after the other. Set a memory budget (--max-memory) to run them concurrently")
+            parallel = False
+        scheduler = PipelineScheduler(steps, self.threads, memory=memory, parallel=parallel, force=force)
 
         # register signal handler to catch
         # interruptions and perform cleanup
          # register cleanup signal handler
         def cleanup_in_signal(signal, frame):
             logging.gemtools.warning("Job step canceled, forcing cleanup!")
-            step.cleanup(force=True)
+            for step in scheduler.running_steps():
+                step.cleanup(force=True)
 
         signal.signal(signal.SIGINT, cleanup_in_signal)
         signal.signal(signal.SIGQUIT, cleanup_in_signal)
         signal.signal(signal.SIGHUP, cleanup_in_signal)
         signal.signal(signal.SIGTERM, cleanup_in_signal)
 
-        for step_id in ids:
-            step = self.steps[step_id]
-
-            if run_step:
-                # check dependencies are done
-                for d in step.dependencies:
-                    if not self.steps[d].is_done():
-                        logging.gemtools.error("Step dependency is not completed : %s", self.steps[d].name)
-                        error = True
-                        break
-            if run_step or self.force or not step.is_done():
-                logging.gemtools.gt("Running step: %s" % step.name)
-                t = Timer()
-
-                if not os.path.exists(self.output_dir):
-                    # make sure we create the ouput folder
-                    logging.gemtools.warn("Creating output folder %s", self.output_dir)
-                    try:
-                        os.makedirs(self.output_dir)
-                    except OSError as exc: # Python >2.5
-                        if exc.errno == errno.EEXIST and os.path.isdir(path):
-                            pass
-                        else:
-                            logging.gemtools.error("unable to create output folder %s", self.output_dir)
-                            error = True
-                            break
-
-                try:
-                    step.run()
-                except KeyboardInterrupt:
-                    logging.gemtools.warning("Job step canceled, forcing cleanup!")
-                    error = True
-                    step.cleanup(force=True)
-                    break
-                except PipelineError, e:
-                    logging.gemtools.error("Error while executing step %s : %s" % (step.name, str(e)))
-                    logging.gemtools.warning("Cleaning up after failed step : %s", step.name)
-                    step.cleanup(force=True)
-                    error = True
-                    break
-                except gem.utils.ProcessError, e:
-                    logging.gemtools.error("Error while executing step %s : %s" % (step.name, str(e)))
-                    logging.gemtools.warning("Cleaning up after failed step : %s", step.name)
-                    step.cleanup(force=True)
-                    error = True
-                    break
-                except Exception, e:
-                    traceback.print_exc()
-                    logging.gemtools.error("Error while executing step %s : %s" % (step.name, str(e)))
-                    logging.gemtools.warning("Cleaning up after failed step : %s", step.name)
-                    step.cleanup(force=True)
-                    error = True
-                    break
-                finally:
-                    t.stop(step.name + " completed in %s", loglevel=None)
-                    times[step.id] = t.end
-                    if not error:
-                        logging.gemtools.gt("Step %s finished in : %s", step.name, t.end)
-                    else:
-                        logging.gemtools.gt("Step %s failed after : %s", step.name, t.end)
-            else:
-                logging.gemtools.warning("Skipping step %s, output already exists" % (step.name))
+        try:
+            error = not scheduler.run()
+        except KeyboardInterrupt:
+            logging.gemtools.warning("Job step canceled, forcing cleanup!")
+            error = True
+            for step in scheduler.running_steps():
+                step.cleanup(force=True)
+        times = scheduler.times
 
         # do celanup if not in error state
         if not error:
@@ -1383,11 +1953,183 @@ index generated from your annotation.""")
             for s in self.steps:
                 if s.id in times:
                     logging.gemtools.gt("{0:>25} : {1}".format(s.name, times[s.id]))
+                elif s.streamed:
+                    logging.gemtools.gt("{0:>25} : streamed".format(s.name))
+                elif s.attached:
+                    logging.gemtools.gt("{0:>25} : shared input".format(s.name))
                 else:
                     logging.gemtools.gt("{0:>25} : skipped".format(s.name))
             logging.gemtools.gt("-------------------------------------")
             logging.gemtools.gt("Pipeline run finshed in %s", time.end)
 
+    def cache_file(self, name, create=False):
+        """Return the path to a file in the cache folder. If create
+        is true, the folder is created if it does not exist"""
+        cache_dir = os.path.join(self.output_dir, ".gemtools")
+        if create and not os.path.exists(cache_dir):
+            os.makedirs(cache_dir)
+        return os.path.join(cache_dir, "%s.%s.json" % (self.name, name))
+
+    def load_stamp(self, step):
+        """Load the commit record of the given step or return None"""
+        stamp = self.cache_file(step.name)
+        if not os.path.exists(stamp):
+            return None
+        try:
+            with open(stamp) as f:
+                return json.load(f)
+        except ValueError:
+            logging.gemtools.warning("Ignoring broken step commit %s", stamp)
+            return None
+
+    def write_stamp(self, step, stamp):
+        """Write the commit record of the given step"""
+        write_json(self.cache_file(step.name, create=True), stamp)
+
+    def remove_stamp(self, step):
+        """Remove the commit record of the given step"""
+        stamp = self.cache_file(step.name)
+        if os.path.exists(stamp):
+            os.remove(stamp)
+
+    def checksum(self, file_name):
+        """Return the sha1 checksum of the given file. Checksums
+        are cached by file size and modification time
+        """
+        key = os.path.abspath(file_name)
+        st = os.stat(key)
+        with self._checksum_lock:
+            if self._checksums is None:
+                self._checksums = {}
+                cache = self.cache_file("checksums")
+                if os.path.exists(cache):
+                    try:
+                        with open(cache) as f:
+                            self._checksums = json.load(f)
+                    except ValueError:
+                        logging.gemtools.warning("Ignoring broken checksum cache %s", cache)
+            cached = self._checksums.get(key, None)
+            if cached is not None and cached[0] == st.st_size and cached[1] == st.st_mtime:
+                return cached[2]
+        # hash without the lock, other steps (and the scheduler, which
+        # checks done steps) must not wait for a large file
+        logging.gemtools.debug("Computing checksum for %s", key)
+        h = hashlib.sha1()
+        with open(key, "rb") as f:
+            while True:
+                block = f.read(4 * 1024 * 1024)
+                if not block:
+                    break
+                h.update(block)
+        digest = h.hexdigest()
+        with self._checksum_lock:
+            self._checksums[key] = [st.st_size, st.st_mtime, digest]
+            write_json(self.cache_file("checksums", create=True), self._checksums)
+        return digest
+
+    def input_files(self):
+        """Return the absolute paths of the existing files configured
+        as step inputs (indexes, keys, annotations and junctions). Their
+        content is part of the signature of the steps using them
+        """
+        files = set([])
+        for f in [self.index, self.annotation, self.transcript_index, self.transcript_keys,
+                  self.denovo_index, self.denovo_keys, self.junctions_file, self.junctions_annotation]:
+            if f is not None and os.path.isfile(f):
+                files.add(os.path.abspath(f))
+        return files
+
+    def tool_version(self, tool):
+        """Return an identifier for the version of the given
+        executable (path, size and modification time) or
+        of the gemtools library if tool is None
+        """
+        if tool not in self._tool_versions:
+            path = None
+            if tool is None:
+                path = gt.__file__
+            else:
+                path = gem.executables[tool]
+                if not os.path.exists(path):
+                    path = gem.utils.which(path)
+            if path is None or not os.path.exists(path):
+                version = str(tool)
+            else:
+                st = os.stat(path)
+                version = "%s:%d:%r" % (os.path.realpath(path), st.st_size, st.st_mtime)
+            self._tool_versions[tool] = version
+        return self._tool_versions[tool]
+
+    def memory_budget(self):
+        """Return the memory budget (in bytes) of the concurrently running
+        steps. Without an explicit max_memory, the budget is
+        DEFAULT_MEMORY_FRACTION of the physical memory. A budget of 0
+        disables the limit. Returns None if there is no explicit budget
+        and the physical memory can not be determined
+        """
+        if self.max_memory is not None:
+            return parse_memory(self.max_memory)
+        physical = physical_memory()
+        if physical <= 0:
+            return None
+        return int(physical * DEFAULT_MEMORY_FRACTION)
+
+    def signature_parameters(self):
+        """Return the general parameters that change
+        the content of the step outputs"""
+        return {
+            "quality": self.quality,
+            "filter": self.filter,
+            "compress": self.compress,
+            "compress_all": self.compress_all,
+            "scoring_scheme": self.scoring_scheme,
+            "max_read_length": self.max_read_length,
+            "single_end": self.single_end,
+        }
+
+    def fuse(self, steps, force=False):
+        """Fuse the given steps into streaming chains. A step that
+        is not final and can stream its output is streamed into its
+        consumer if exactly one step that is not done yet reads the
+        output and that step is part of this run and accepts streamed
+        input. All other outputs are written to disk as usual. Unless
+        forced, steps that are done are read from disk.
+
+        Returns the steps that have to be scheduled
+        """
+        ids = set([s.id for s in steps])
+        for step in steps:
+            if step.final or not step.streamable() or (not force and step.is_done()):
+                continue
+            consumers = [s for s in self.steps if step.id in s.dependencies and (s.id in ids or not s.is_done())]
+            if len(consumers) != 1 or consumers[0].id not in ids or not consumers[0].stream_input:
+                continue
+            step.streamed = True
+            consumers[0].fused.append(step)
+            logging.gemtools.gt("Streaming step %s into %s", step.name, consumers[0].name)
+        return [s for s in steps if not s.streamed]
+
+    def share_inputs(self, steps):
+        """Attach each stats step to a BAM step of the given steps
+        that reads the same input. The stats are then filled from
+        the templates written to gem-2-sam, so the input is parsed
+        once for both steps. If the BAM step is skipped as up to date,
+        the scheduler detaches the stats step and runs it on its own.
+
+        Returns the steps that have to be scheduled
+        """
+        for step in steps:
+            if not isinstance(step, CreateStatsStep):
+                continue
+            hosts = [s for s in steps if isinstance(s, CreateBamStep) and s.stats is None and s.dependencies == step.dependencies]
+            if len(hosts) == 0:
+                continue
+            step.attached = True
+            hosts[0].stats = step
+            hosts[0].fused.append(step)
+            logging.gemtools.gt("Computing %s with the input of %s", step.name, hosts[0].name)
+        return [s for s in steps if not s.attached]
+
     def cleanup(self):
         """Delete all remaining temporary and intermediate files
         """
@@ -1527,6 +2269,10 @@ index generated from your annotation.""")
         execution_group.add_argument('--run', dest="run_steps", type=int, default=None, nargs="+", metavar="cfg", help="Run given pipeline steps idenfified by the step id")
         execution_group.add_argument('--force', dest="force", default=None, action="store_true", help="Force running all steps and skip checking for completed steps")
         execution_group.add_argument('-t', '--threads', dest="threads", metavar="threads", type=int, help="Number of threads to use. Default %d" % self.threads)
+        execution_group.add_argument('--sequential', dest="parallel", action="store_false", default=None, help="Run the pipeline steps one after the other instead of running independent steps concurrently")
+        execution_group.add_argument('--stream', dest="stream", action="store_true", default=None, help="Stream intermediate outputs that are read by exactly one step directly into that step instead of writing them to disk")
+        execution_group.add_argument('--no-cache', dest="cache", action="store_false", default=None, help="Consider steps done if their output files exist instead of checking the step signature (configuration, tool versions and input checksums) and the committed output checksums")
+        execution_group.add_argument('--max-memory', dest="max_memory", default=None, metavar="mem", help="Memory budget for concurrently running steps. Suffix K/M/G recognized. Steps are delayed while the estimated memory of the running steps exceeds the budget. 0 disables the limit. Default 80%% of the physical memory")
 
     def register_mapping(self, parser):
         """Register the genome mapping parameters with the
@@ -2,85 +2,49 @@
 import re
 import logging
 import gem
+import gem.gemtools
+import gem.junctions
 from gem.junctions import JunctionSite
 
 
 def extract_denovo_junctions(input, minsplit=4, maxsplit=2500000, sites=None, coverage=0, max_junction_matches=1, process=None, threads=1, annotation_junctions=None):
     """Extract denovo junctions from a split map run.
 
-    gemoutput - a read iterator over gem splitmapper Output
-    minsplit  - minimum length of a split to be considered, default is 4
-    maxsplit  - maximum length of a split to be considered, defauilt is 2500000
+    The split-maps are parsed and counted natively (see
+    gem.gemtools.JunctionSet) and JunctionSites are only created
+    for the distinct junctions.
+
+    input     - the split mapper output, an InputFile, a file name or a stream
+    minsplit  - minimum distance between the junction sites, default is 4
+    maxsplit  - maximum distance between the junction sites, default is 2500000
     sites     - target set where the found junctions will be
                 merged into, default is None
     coverage  - if > 0, a junction must be found > coverage times
                 to be considered, default is 0 and therefore disabled
+    max_junction_matches - skip reads with more split maps, default is 1
+    threads   - number of parser threads
     """
-    splits2junctions_p = [
-        gem.executables['splits-2-junctions'],
-        str(minsplit),
-        str(maxsplit),
-        str(max_junction_matches),
-        str(threads)
-    ]
-    p = gem.utils.run_tool(splits2junctions_p, input=input, write_map=True)
-
-    ## read from process stdout and get junctions
     if sites is None:
         sites = set([])
     initial_size = len(sites)
-    local_sites = {}
-    for line in p.stdout:
-        js = JunctionSite(line=line)
-        if coverage > 0:
-            if js.hash not in local_sites:
-                local_sites[js.hash] = js
-                local_sites[js.hash].coverage = 1
-            else:
-                local_sites[js.hash].coverage += 1
-        else:
-            sites.add(js)
+    try:
+        local_sites = gem.gemtools.extract_junctions(input, minsplit, maxsplit, max_junction_matches, threads)
+    except ValueError:
+        logging.error("Error while executing junction extraction")
+        exit(1)
+    finally:
+        if process is not None:
+            process.wait()
 
     if coverage > 0:
-        annotation_positions = None
-
-        def __get_junciton_sites(site):
-            """Helper to create hashable strings out of the junctions site chromosome
-            and position. This returns a tuple with two string that represent
-            the two junciton sites
-            """
-            j1 = "%s-%s" % (str(site.descriptor[0]), str(site.descriptor[2]))
-            j2 = "%s-%s" % (str(site.descriptor[3]), str(site.descriptor[5]))
-            return (j1, j2)
-
+        # junctions below the coverage are kept if one
+        # of their sites is an annotated junction site
+        rescue = None
         if annotation_junctions is not None:
-            # create a position dict from the annotation
-            # junctions to make sure that coverage is ignored
-            # if the junctions is covered just by one side of
-            # the annotation junciton side
-            logging.info("Updating junction position lookup")
-            annotation_positions = {}
-            for site in annotation_junctions:
-                j1, j2 = __get_junciton_sites(site)
-                annotation_positions[j1] = True
-                annotation_positions[j2] = True
-            logging.info("Annotation position lookup prepared")
-
-        for i, e in local_sites.items():
-            if e.coverage >= coverage:
-                sites.add(e)
-            else:
-                if annotation_positions is not None:
-                    j1, j2 = __get_junciton_sites(e)
-                    if j1 in annotation_positions or j2 in annotation_positions:
-                        sites.add(e)
-
-    exit_value = p.wait()
-    if process is not None:
-        process.wait()
-    if exit_value != 0:
-        logging.error("Error while executing junction extraction")
-        exit(1)
+            rescue = gem.junctions.to_junction_set(annotation_junctions)
+        local_sites.filter(min_coverage=coverage, rescue=rescue)
+    sites.update(gem.junctions.from_junction_set(local_sites))
+
     logging.info("Junction extraction: Initial %d, Output %d (%d new)" % (initial_size, len(sites), (len(sites) - initial_size)))
     return sites
 
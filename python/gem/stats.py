@@ -7,6 +7,7 @@ import locale
 import os
 import re
 import shutil
+import struct
 import zipfile
 
 #import matplotlib stuff
@@ -217,6 +218,33 @@ def __reads_format(x, pos=0):
     return locale.format("%.0f", x, True)
 
 
+def read_binary(input_file):
+    """Read stats written by gemtools.Stats.write_binary() and return
+    a dict with 'best_map', 'paired' and all counters (integers) and
+    histograms (flat lists of integers) by name.
+
+    Parameters
+    ----------
+    input_file: string or file handle
+        The binary stats file name or an open readable stream
+    """
+    of = open(input_file, 'rb') if isinstance(input_file, basestring) else input_file
+    try:
+        if of.read(8) != "GTSTATS1":
+            raise ValueError("Not a binary stats file")
+        best_map, paired, num_arrays = struct.unpack("=BBQ", of.read(10))
+        data = {"best_map": bool(best_map), "paired": bool(paired)}
+        for i in range(num_arrays):
+            name = of.read(struct.unpack("=H", of.read(2))[0])
+            kind, length = struct.unpack("=cQ", of.read(9))
+            values = list(struct.unpack("=%dQ" % length, of.read(8 * length)))
+            data[name] = values[0] if kind == "c" else values
+        return data
+    finally:
+        if of is not input_file:
+            of.close()
+
+
 def write_general_stats(data, out_dir, paired=True):
     """Generate general stats plot and
     save it to the given out_dir
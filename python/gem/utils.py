@@ -9,6 +9,7 @@ of gem.utils.Command.
 """
 
 import os
+import fcntl
 import string
 import subprocess
 import logging
@@ -18,6 +19,7 @@ import datetime
 import time
 import tempfile
 import multiprocessing as mp
+import threading
 
 
 # clobal process registry
@@ -190,7 +192,7 @@ class Process(object):
                 stdin = subprocess.PIPE
 
         logging.debug("Starting subprocess")
-        self.process = subprocess.Popen(self.commands, stdin=stdin, stdout=stdout, stderr=stderr, env=self.env, close_fds=False)
+        self.process = subprocess.Popen(self.commands, stdin=stdin, stdout=stdout, stderr=stderr, env=self.env, close_fds=True)
 
         if process_input is not None:
             logging.debug("Starting process input writer")
@@ -258,14 +260,17 @@ class ProcessInput(object):
         self.process = None
         self.input = input
         self.thread = None
+        self.error = None
 
-    def __write_input(self):
+    def __write_input(self, outfile):
         """Internal method that writes templates ot the
-        input stream of the process and puts a message on
-        the queue when done to close the stream
+        input stream of the process and closes the stream
+        when done. Errors are raised again by wait()
         """
-        outfile = gt.OutputFile(self.process.stdin, clean_id=self.clean_id, append_extra=self.append_extra)
-        self.input.write_stream(outfile, write_map=self.write_map, threads=2)
+        try:
+            self.input.write_stream(outfile, write_map=self.write_map, threads=2)
+        except Exception, e:
+            self.error = e
 
         try:
             if self.input.process is not None:
@@ -274,20 +279,26 @@ class ProcessInput(object):
             pass
 
         outfile.close()
-        self.process.stdin.close()
 
     def write(self, process):
         self.process = process
         logging.debug("Preparing process input stream -- clean_id: %s, append_extra: %s, write_map:%s" % (str(self.clean_id), str(self.append_extra), str(self.write_map)))
-        self.thread = mp.Process(target=ProcessInput.__write_input, args=(self,))
-        register_process(self.thread)
-        #self.thread = Thread(target=ProcessInput.__write_input, args=(self,))
+        # the writer thread gets its own copy of the process stdin (not
+        # inherited by other subprocesses), so we can close ours right away
+        fd = os.dup(self.process.stdin.fileno())
+        fcntl.fcntl(fd, fcntl.F_SETFD, fcntl.fcntl(fd, fcntl.F_GETFD) | fcntl.FD_CLOEXEC)
+        outfile = gt.OutputFile(os.fdopen(fd, 'w'), clean_id=self.clean_id, append_extra=self.append_extra)
+        self.thread = threading.Thread(target=self.__write_input, args=(outfile,))
         self.thread.start()
         self.process.stdin.close()
 
     def wait(self):
         if self.thread is not None:
             self.thread.join()
+        if self.error is not None:
+            error = self.error
+            self.error = None
+            raise error
 
 
 class ProcessWrapper(object):
@@ -388,6 +399,7 @@ class ProcessWrapper(object):
         except Exception, e:
             print "An error occured while waiting for one the child processes:", e
             self.exit_value = 1
+            return self.exit_value
         finally:
             if not self.keep_logfiles:
                 for p in self.processes:
@@ -395,6 +407,17 @@ class ProcessWrapper(object):
                         logging.debug("Removing log file: %s" % (p.logfile))
                         os.remove(p.logfile)
 
+    def terminate(self):
+        """Terminate all processes that are still running. Use
+        wait() to reap them
+        """
+        for p in self.processes:
+            if p.process is not None and p.process.poll() is None:
+                try:
+                    p.process.terminate()
+                except OSError:
+                    pass  # already gone
+
     def to_bash_pipe(self):
         return " | ".join([p.to_bash() for p in self.processes])
 
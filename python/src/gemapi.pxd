@@ -1,7 +1,8 @@
 # cdef extern from "stdbool.h":
 #     ctypedef int bool
 from libcpp cimport bool
-from libc.stdlib cimport malloc, free
+from libc.stdlib cimport malloc, calloc, free
+from libc.string cimport memcpy
 
 cdef extern from "stdio.h":
   printf(char* string)
@@ -22,6 +23,7 @@ cdef extern from "Python.h":
     PyObject* PyString_FromString(char *v)
     PyObject* PyString_FromStringAndSize(char *v, Py_ssize_t len)
     void PyEval_InitThreads()
+    int PyBUF_WRITABLE
 
 cdef extern from "fileobject.h":
     ctypedef class __builtin__.file [object PyFileObject]:
@@ -41,7 +43,11 @@ cdef extern from "gem_tools.h" nogil:
     cdef int GT_STATS_INSS_FG_RANGE
 
     ctypedef struct gt_vector:
-        pass
+        void* memory
+        uint64_t used
+    gt_vector* gt_vector_new(size_t num_initial_elements, size_t element_size)
+    void gt_vector_delete(gt_vector* vector)
+    void gt_vector_clear(gt_vector* vector)
 
     #gt_string
     ctypedef struct gt_string:
@@ -68,6 +74,7 @@ cdef extern from "gem_tools.h" nogil:
         FASTA
         MAP
         SAM
+        BINARY
         FILE_FORMAT_UNKNOWN
 
     enum gt_file_type:
@@ -92,7 +99,7 @@ cdef extern from "gem_tools.h" nogil:
         UNSORTED_FILE
 
     ctypedef struct gt_output_file:
-        pass
+        FILE* file
 
     gt_output_file* gt_output_stream_new(FILE* file, gt_output_file_type output_file_type)
     gt_output_file* gt_output_file_new(char* file_name, gt_output_file_type output_file_type)
@@ -204,6 +211,7 @@ cdef extern from "gem_tools.h" nogil:
     void gt_map_delete(gt_map* map)
     char* gt_map_get_seq_name(gt_map* map)
     gt_strand gt_map_get_strand(gt_map* map)
+    uint64_t gt_map_get_global_position(gt_map* map)
 
     # template
     ctypedef struct gt_template:
@@ -215,6 +223,7 @@ cdef extern from "gem_tools.h" nogil:
     uint64_t gt_template_get_num_blocks(gt_template* template)
     uint64_t gt_template_get_num_mmaps(gt_template* template)
     uint64_t gt_template_get_num_counters(gt_template*  template)
+    gt_vector* gt_template_get_counters_vector(gt_template* template)
     uint64_t gt_template_get_counter(gt_template*  template, uint64_t stratum)
     void gt_template_set_counter(gt_template*  template, uint64_t stratum, uint64_t value)
     void gt_template_dec_counter(gt_template*  template, uint64_t stratum)
@@ -231,6 +240,7 @@ cdef extern from "gem_tools.h" nogil:
     bool gt_template_is_mapped(gt_template* template)
     bool gt_template_is_thresholded_mapped(gt_template* template, uint64_t max_allowed_strata)
     void gt_template_trim(gt_template* template, uint64_t left, uint64_t right, uint64_t min_length, bool set_extra)
+    void gt_template_auto_trim(gt_template* template, gt_dna_read_trim_attributes* trim_attributes, uint64_t min_length, bool set_extra)
 
     # template merge
     cdef gt_template* gt_template_union_template_mmaps(gt_template* src_A, gt_template* src_B)
@@ -242,6 +252,37 @@ cdef extern from "gem_tools.h" nogil:
         F_FASTQ
         F_MULTI_FASTA
 
+    # read trimming (quality/adapter/poly-A/N)
+    enum gt_qualities_offset_t:
+        GT_QUALS_OFFSET_33
+        GT_QUALS_OFFSET_64
+
+    ctypedef struct gt_dna_read_trim_attributes:
+        uint8_t quality_threshold
+        gt_qualities_offset_t qualities_offset
+        uint64_t adapter_min_overlap
+        double adapter_max_error_rate
+        uint64_t poly_a_min_length
+        bool trim_n_ends
+
+    uint8_t GT_DNA_READ_MAX_QUALITY
+    gt_dna_read_trim_attributes* gt_dna_read_trim_attributes_new()
+    void gt_dna_read_trim_attributes_delete(gt_dna_read_trim_attributes* trim_attributes)
+    void gt_dna_read_trim_attributes_add_adapter(gt_dna_read_trim_attributes* trim_attributes, char* adapter)
+
+    # MAPQ computation
+    ctypedef struct gt_map_score_attributes:
+        uint64_t mismatch_penalty
+        uint64_t max_mismatch_quality
+        uint64_t gap_open_penalty
+        uint64_t gap_extension_penalty
+        gt_qualities_offset_t qualities_offset
+        uint64_t max_mapq
+
+    gt_map_score_attributes* gt_map_score_attributes_new()
+    void gt_map_score_attributes_delete(gt_map_score_attributes* attributes)
+    uint64_t gt_map_score_template_mapq(gt_template* template, gt_map_score_attributes* attributes)
+
 
 
     # map output attributes
@@ -295,6 +336,36 @@ cdef extern from "gem_tools.h" nogil:
     gt_status gt_output_map_sprint_alignment(gt_string* string,gt_alignment* alignment,gt_output_map_attributes* attributes)
     gt_status gt_output_map_ofprint_template(gt_output_file* output_file,gt_template* template, gt_output_map_attributes* attributes)
 
+cdef extern from "gt_profiler.h" nogil:
+    cdef int GT_PROFILE_NUM_STAGES
+    char* gt_profile_stage_label[]
+    ctypedef struct gt_profile:
+        uint64_t time[7]
+        uint64_t calls[7]
+        uint64_t num_records
+        uint64_t num_blocks
+        uint64_t bytes_in
+        uint64_t bytes_out
+    bool gt_profile_enabled
+    void gt_profile_enable(bool enabled)
+    void gt_profile_reset()
+    void gt_profile_destroy()
+    uint64_t gt_profile_get_num_threads()
+    gt_profile* gt_profile_get_thread(uint64_t thread_num)
+    uint64_t gt_profile_get_totals(gt_profile* profile)
+
+cdef extern from "gt_inss_model.h":
+    ctypedef enum gt_inss_orientation:
+        GT_INSS_FR
+        GT_INSS_RF
+        GT_INSS_TANDEM
+    ctypedef struct gt_inss_model:
+        uint64_t num_different_contigs
+        uint64_t num_templates
+    uint64_t gt_inss_model_get_num_samples(gt_inss_model* inss_model, gt_inss_orientation orientation)
+    gt_inss_orientation gt_inss_model_get_dominant_orientation(gt_inss_model* inss_model)
+    int64_t gt_inss_model_get_quantile(gt_inss_model* inss_model, gt_inss_orientation orientation, double quantile)
+
 cdef extern from "gt_stats.h":
     ctypedef struct gt_maps_profile:
         uint64_t *mismatches
@@ -314,6 +385,7 @@ cdef extern from "gt_stats.h":
 
         uint64_t *inss
         uint64_t *inss_fine_grain
+        gt_inss_model* inss_model
 
         uint64_t *misms_transition
         uint64_t *qual_score_misms
@@ -326,6 +398,13 @@ cdef extern from "gt_stats.h":
         uint64_t *indel_1context
         uint64_t *indel_2context
         uint64_t *qual_score_errors
+        uint64_t total_insertions
+        uint64_t total_deletions
+        uint64_t *insertion_event_length
+        uint64_t *deletion_event_length
+        uint64_t *insertion_homopolymer
+        uint64_t *deletion_homopolymer
+        uint64_t *indel_position
 
 
     ctypedef struct gt_splitmaps_profile:
@@ -384,10 +463,92 @@ cdef extern from "gt_stats.h":
     cdef int GT_STATS_INDEL_TRANSITION_4_RANGE
     cdef int GT_STATS_INDEL_1_CONTEXT
     cdef int GT_STATS_INDEL_2_CONTEXT
+    cdef int GT_STATS_INDEL_LENGTH_RANGE
+    cdef int GT_STATS_INDEL_HOMOPOLYMER_RANGE
 
 
 cdef extern from "gemtools_binding.h" nogil:
-    void gt_merge_files_synch(gt_output_file* output_file, uint64_t threads, uint64_t num_files, gt_input_file** files)
-    void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map)
+    ctypedef enum gt_template_filter_type:
+        GT_FILTER_UNMAPPED
+        GT_FILTER_UNIQUE
+        GT_FILTER_TRIM
+        GT_FILTER_AUTO_TRIM
+        GT_FILTER_MAPQ
+    ctypedef struct gt_template_filter:
+        gt_template_filter_type type
+        uint64_t max_mismatches
+        uint64_t level
+        uint64_t left
+        uint64_t right
+        uint64_t min_length
+        bool set_extra
+        gt_dna_read_trim_attributes* trim_attributes
+        gt_map_score_attributes* score_attributes
+        uint64_t min_mapq
+    ctypedef struct gt_template_filter_chain:
+        gt_template_filter* filters
+        uint64_t num_filters
+    gt_template_filter_chain* gt_template_filter_chain_new(uint64_t num_filters)
+    void gt_template_filter_chain_delete(gt_template_filter_chain* chain)
+    int64_t gt_template_get_uniq_level(gt_template* template, uint64_t max_level)
+    bool gt_template_filter_chain_apply(gt_template_filter_chain* chain, gt_template* template)
+
+    gt_status gt_merge_files_synch(gt_output_file* output_file, uint64_t threads, uint64_t num_files, gt_input_file** files)
+    gt_status gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, gt_template_filter_chain* filters)
     void gt_stats_fill(gt_input_file* input_file, gt_stats* target_all_stats, gt_stats* target_best_stats, uint64_t num_threads, bool paired_end)
-    void gt_stats_print_stats(FILE* output, gt_stats* stats, bool paired_end)
\ No newline at end of file
+    gt_status gt_stats_fill_output(gt_output_file* output, gt_input_file* input_file, gt_stats* target_all_stats, gt_stats* target_best_stats, uint64_t num_threads, bool paired_end, bool append_extra, bool clean_id)
+    void gt_stats_print_stats(FILE* output, gt_stats* stats, bool paired_end)
+
+    ctypedef struct gt_template_batch:
+        gt_template** templates
+        uint64_t num_templates
+        uint64_t max_templates
+        gt_status error_code
+    gt_template_batch* gt_template_batch_new(uint64_t max_templates)
+    void gt_template_batch_delete(gt_template_batch* batch)
+    uint64_t gt_template_batch_fill(gt_template_batch* batch, gt_buffered_input_file** buffered_inputs, uint64_t num_threads, gt_generic_parser_attr* parser_attributes, gt_template_filter_chain* filters)
+
+    FILE* gt_gzip_stream_open(int fd, int level, uint64_t num_threads)
+    FILE* gt_output_stream_dup(FILE* stream, bool compress, uint64_t compress_threads)
+    int fclose(FILE* stream)
+    ctypedef struct gt_write_job:
+        bool running
+        gt_status error_code
+    gt_write_job* gt_write_job_new(FILE* stream, gt_input_file** inputs, uint64_t num_inputs, bool merge, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, gt_template_filter_chain* filters)
+    void gt_write_job_set_stats(gt_write_job* job, gt_stats* all_stats, gt_stats* best_stats, bool paired_end)
+    void gt_write_job_start(gt_write_job* job)
+    gt_status gt_write_job_join(gt_write_job* job)
+    void gt_write_job_delete(gt_write_job* job)
+
+
+    ctypedef struct gt_junction:
+        uint64_t start_seq
+        uint64_t start_position
+        uint64_t end_seq
+        uint64_t end_position
+        gt_strand start_strand
+        gt_strand end_strand
+        uint64_t coverage
+    ctypedef struct gt_junction_set:
+        pass
+    gt_junction_set* gt_junction_set_new()
+    void gt_junction_set_clear(gt_junction_set* set)
+    void gt_junction_set_delete(gt_junction_set* set)
+    uint64_t gt_junction_set_get_seq_id(gt_junction_set* set, char* seq_name, uint64_t length)
+    char* gt_junction_set_get_seq_name(gt_junction_set* set, uint64_t seq_id)
+    uint64_t gt_junction_set_get_num_junctions(gt_junction_set* set)
+    gt_junction* gt_junction_set_get_junction(gt_junction_set* set, uint64_t position)
+    gt_junction* gt_junction_set_add(gt_junction_set* set, gt_junction* junction, uint64_t coverage)
+    void gt_junction_set_merge(gt_junction_set* set_dst, gt_junction_set* set_src)
+    uint64_t gt_junction_set_add_map(gt_junction_set* set, gt_map* map, uint64_t min_split, uint64_t max_split)
+    gt_status gt_junction_set_extract(gt_junction_set* set, gt_input_file* input, uint64_t min_split, uint64_t max_split, uint64_t max_matches, uint64_t threads)
+    gt_status gt_junction_set_load_gtf(gt_junction_set* set, char* file_name)
+    cdef uint64_t GT_JUNCTION_SEQ_NOT_FOUND
+    uint64_t gt_junction_set_find_seq_id(gt_junction_set* set, char* seq_name)
+    gt_junction* gt_junction_set_get(gt_junction_set* set, gt_junction* junction)
+    gt_junction* gt_junction_set_find(gt_junction_set* set, gt_junction_set* set_src, gt_junction* junction)
+    void gt_junction_set_intersection(gt_junction_set* set_dst, gt_junction_set* set_a, gt_junction_set* set_b)
+    uint64_t gt_junction_set_filter(gt_junction_set* set, uint64_t min_distance, uint64_t max_distance, uint64_t min_coverage, gt_junction_set* rescue)
+    void gt_junction_set_sort(gt_junction_set* set)
+    uint64_t gt_junction_set_overlaps(gt_junction_set* set, uint64_t seq_id, uint64_t begin, uint64_t end, gt_vector* positions)
+    uint64_t gt_junction_set_sites(gt_junction_set* set, uint64_t seq_id, uint64_t begin, uint64_t end, gt_vector* positions)
\ No newline at end of file
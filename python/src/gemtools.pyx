@@ -4,6 +4,7 @@ import os
 import sys
 import multiprocessing
 import string
+import struct
 
 
 from cython.parallel import parallel, prange
@@ -21,6 +22,12 @@ cdef class TemplateFilter(object):
         """
         return True
 
+    cdef bool _compile(self, gt_template_filter* f):
+        """Fill the native (C) version of this filter. Returns
+        false if the filter can only be applied from python
+        """
+        return False
+
 
 cdef class filter_unmapped(TemplateFilter):
     """Filter for unmapped reads or reads with mismatches >= max_mismatches"""
@@ -39,6 +46,11 @@ cdef class filter_unmapped(TemplateFilter):
     cpdef bool filter(self, Template template):
         return template.is_unmapped(self.max_mismatches)
 
+    cdef bool _compile(self, gt_template_filter* f):
+        f.type = GT_FILTER_UNMAPPED
+        f.max_mismatches = <uint64_t> self.max_mismatches
+        return True
+
 cdef class filter_unique(TemplateFilter):
     """Filter for unique mappings up to given uniqueness level
     """
@@ -52,6 +64,11 @@ cdef class filter_unique(TemplateFilter):
         template_level = template.level(self.level)
         return template_level > 0 and template_level >= self.level
 
+    cdef bool _compile(self, gt_template_filter* f):
+        f.type = GT_FILTER_UNIQUE
+        f.level = self.level
+        return True
+
 
 cdef class filter_trim(TemplateFilter):
     """Trimming filter that always returns true, but trims the
@@ -72,6 +89,122 @@ cdef class filter_trim(TemplateFilter):
         gt_template_trim(template.template, self.left, self.right, self.min_length, self.set_extra)
         return True
 
+    cdef bool _compile(self, gt_template_filter* f):
+        f.type = GT_FILTER_TRIM
+        f.left = self.left
+        f.right = self.right
+        f.min_length = self.min_length
+        f.set_extra = self.set_extra
+        return True
+
+cdef class filter_auto_trim(TemplateFilter):
+    """Trimming filter that always returns true, but trims the
+    template reads by quality (BWA-like), clips adapters and
+    poly-A tails, and removes N's from both ends
+    """
+    cdef gt_dna_read_trim_attributes* trim_attributes
+    cdef uint64_t min_length
+    cdef bool set_extra
+
+    def __cinit__(self):
+        self.trim_attributes = gt_dna_read_trim_attributes_new()
+
+    def __init__(self, uint64_t quality=0, uint64_t quality_offset=33, adapters=None,
+                 uint64_t adapter_min_overlap=3, double adapter_error_rate=0.1,
+                 uint64_t poly_a=0, bool trim_n=False, uint64_t min_length=10, bool set_extra=True):
+        if quality > GT_DNA_READ_MAX_QUALITY:
+            raise ValueError("Trimming quality %d out of range [0,%d]" % (quality, GT_DNA_READ_MAX_QUALITY))
+        self.trim_attributes.quality_threshold = quality
+        self.trim_attributes.qualities_offset = GT_QUALS_OFFSET_64 if quality_offset == 64 else GT_QUALS_OFFSET_33
+        if adapters is not None:
+            if isinstance(adapters, basestring):
+                adapters = [adapters]
+            for adapter in adapters:
+                gt_dna_read_trim_attributes_add_adapter(self.trim_attributes, adapter)
+        self.trim_attributes.adapter_min_overlap = adapter_min_overlap
+        self.trim_attributes.adapter_max_error_rate = adapter_error_rate
+        self.trim_attributes.poly_a_min_length = poly_a
+        self.trim_attributes.trim_n_ends = trim_n
+        self.min_length = min_length
+        self.set_extra = set_extra
+
+    def __dealloc__(self):
+        gt_dna_read_trim_attributes_delete(self.trim_attributes)
+
+    cpdef bool filter(self, Template template):
+        gt_template_auto_trim(template.template, self.trim_attributes, self.min_length, self.set_extra)
+        return True
+
+    cdef bool _compile(self, gt_template_filter* f):
+        f.type = GT_FILTER_AUTO_TRIM
+        f.trim_attributes = self.trim_attributes
+        f.min_length = self.min_length
+        f.set_extra = self.set_extra
+        return True
+
+cdef class filter_mapq(TemplateFilter):
+    """MAPQ filter. Computes the MAPQ of the template maps (stored
+    as the map scores) and filters templates with a MAPQ below min_mapq
+    """
+    cdef gt_map_score_attributes* score_attributes
+    cdef uint64_t min_mapq
+
+    def __cinit__(self):
+        self.score_attributes = gt_map_score_attributes_new()
+
+    def __init__(self, uint64_t min_mapq=0, uint64_t quality_offset=33, uint64_t max_mapq=60):
+        self.score_attributes.qualities_offset = GT_QUALS_OFFSET_64 if quality_offset == 64 else GT_QUALS_OFFSET_33
+        self.score_attributes.max_mapq = max_mapq
+        self.min_mapq = min_mapq
+
+    def __dealloc__(self):
+        gt_map_score_attributes_delete(self.score_attributes)
+
+    cpdef bool filter(self, Template template):
+        return gt_map_score_template_mapq(template.template, self.score_attributes) >= self.min_mapq
+
+    cdef bool _compile(self, gt_template_filter* f):
+        f.type = GT_FILTER_MAPQ
+        f.score_attributes = self.score_attributes
+        f.min_mapq = self.min_mapq
+        return True
+
+
+cdef class TemplateFilterChain(object):
+    """Native version of a list of built-in filters. The chain
+    is applied from C, without the GIL, by write_stream and the
+    batch iterators. Use compile_filters() to create a chain.
+    """
+    cdef gt_template_filter_chain* chain
+    # the compiled filters (own the trim/mapq attributes used by the chain)
+    cdef readonly object filters
+
+    def __dealloc__(self):
+        if self.chain is not NULL:
+            gt_template_filter_chain_delete(self.chain)
+            self.chain = NULL
+
+    cpdef bool filter(self, Template template):
+        return gt_template_filter_chain_apply(self.chain, template.template)
+
+
+cpdef compile_filters(filters):
+    """Compile a list of filters into a TemplateFilterChain. Returns
+    None if any of the filters is not a built-in filter (subclasses
+    are not compiled, as they might override filter()).
+    """
+    cdef TemplateFilterChain chain = TemplateFilterChain()
+    cdef uint64_t i
+    filters = list(filters)
+    chain.filters = filters
+    chain.chain = gt_template_filter_chain_new(len(filters))
+    for i, f in enumerate(filters):
+        if type(f) not in (filter_unmapped, filter_unique, filter_trim, filter_auto_trim, filter_mapq):
+            return None
+        if not (<TemplateFilter> f)._compile(&chain.chain.filters[i]):
+            return None
+    return chain
+
 cpdef unmapped(source, int64_t max_mismatches=GT_ALL):
     """Wrapper function that creates a filtered iterator"""
     return filter(source, filter_unmapped(max_mismatches))
@@ -84,12 +217,26 @@ cpdef trim(source, uint64_t left=0, uint64_t right=0, uint64_t min_length=10, bo
     """Wrapper function that creates a filtered iterator"""
     return filter(source, filter_trim(left=left, right=right, min_length=min_length, set_extra=set_extra))
 
+cpdef auto_trim(source, uint64_t quality=0, uint64_t quality_offset=33, adapters=None,
+                uint64_t adapter_min_overlap=3, double adapter_error_rate=0.1,
+                uint64_t poly_a=0, bool trim_n=False, uint64_t min_length=10, bool set_extra=True):
+    """Wrapper function that creates a filtered iterator"""
+    return filter(source, filter_auto_trim(quality=quality, quality_offset=quality_offset, adapters=adapters,
+                                           adapter_min_overlap=adapter_min_overlap, adapter_error_rate=adapter_error_rate,
+                                           poly_a=poly_a, trim_n=trim_n, min_length=min_length, set_extra=set_extra))
+
+cpdef mapq(source, uint64_t min_mapq=0, uint64_t quality_offset=33, uint64_t max_mapq=60):
+    """Wrapper function that creates a filtered iterator"""
+    return filter(source, filter_mapq(min_mapq=min_mapq, quality_offset=quality_offset, max_mapq=max_mapq))
+
 cdef class filter(object):
     """Filtering iterator that takes a source
     and can apply a filter
     """
     cdef object source
     cdef object template_filter
+    # native chain (None if any filter is a python filter)
+    cdef TemplateFilterChain chain
 
     def __cinit__(self, source, template_filter):
         self.source = source
@@ -97,6 +244,7 @@ cdef class filter(object):
             self.template_filter = template_filter
         else:
             self.template_filter = [template_filter]
+        self.chain = compile_filters(self.template_filter)
 
     def __iter__(self):
         self.source = self.source.__iter__()
@@ -104,6 +252,12 @@ cdef class filter(object):
 
     def __next__(self):
         cdef bool filtered = False
+        cdef Template t
+        if self.chain is not None:
+            while True:
+                t = self.source.__next__()
+                if gt_template_filter_chain_apply(self.chain.chain, t.template):
+                    return t
         while True:
             filtered = False
             n = self.source.__next__()
@@ -115,16 +269,69 @@ cdef class filter(object):
                 return n
 
 
-    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1):
+    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1, bool async=False):
         """Write the content of this filter to the output file.
 
         output   -- the output file
         write_map     -- if true, write map, otherwise write fasta/q sequence
         threads       -- number of threads to use (if supported by the iterator)
+        async         -- return the running WriteStreamThread without waiting
+                         (python filters are always written synchronously)
         """
+        if self.chain is not None:
+            # native filters, run the filters in the parallel writer
+            if isinstance(self.source, InputFile):
+                return __run_write_stream([self.source], output, write_map, threads, True, self.source.process,
+                                          async=async, filters=self.template_filter)
+            if isinstance(self.source, interleave):
+                return __run_write_stream((<interleave>self.source).files, output, write_map, max(threads, (<interleave>self.source).threads),
+                                          (<interleave>self.source).interleave, None, async=async, filters=self.template_filter)
         for t in self:
             output.write(t, write_map=write_map)
 
+    def batches(self, uint64_t size=1024, uint64_t threads=1):
+        """Iterate the filtered templates in batches (see InputFile.batches()).
+        The filters are applied by the parser threads when all of them
+        are built-in filters and the source is an InputFile.
+        """
+        if self.chain is not None and isinstance(self.source, InputFile):
+            return TemplateBatchIterator(self.source, size, threads, self.chain)
+        raise ValueError("Batches are only supported for built-in filters on an InputFile")
+
+
+cdef class tee_stats(object):
+    """Input wrapper that fills stats from the templates written
+    by write_stream(), so the same parse of the input feeds the
+    output (i.e. the input of a gem-2-sam process) and the stats.
+    The stats are complete once the write is joined.
+    """
+    cdef InputFile source
+    cdef Stats all_stats
+    cdef Stats best_stats
+    cdef uint64_t threads
+
+    def __cinit__(self, InputFile source, Stats all_stats=None, Stats best_stats=None, uint64_t threads=1):
+        self.source = source
+        self.all_stats = all_stats
+        self.best_stats = best_stats
+        self.threads = threads
+
+    property process:
+        def __get__(self):
+            return self.source.process
+
+    property quality:
+        def __get__(self):
+            return self.source.quality
+
+    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1, bool async=False):
+        """Write the templates (always in map format, write_map is ignored)
+        and fill the stats. The stats are filled by max(threads, self.threads)
+        threads.
+        """
+        return __run_write_stream([self.source], output, True, max(threads, self.threads), True, self.source.process,
+                                  async=async, all_stats=self.all_stats, best_stats=self.best_stats)
+
 
 
 cdef class interleave(object):
@@ -177,14 +384,15 @@ cdef class interleave(object):
                     if mises >= self.length or self.i >= self.length:
                         raise StopIteration()
 
-    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1):
+    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1, bool async=False):
         """Write the content interleaved to the output file
 
         output_file   -- the output file
         write_map     -- if true, write map, otherwise write fasta/q sequence
         threads       -- number of threads to use (if supported by the iterator)
+        async         -- return the running WriteStreamThread without waiting
         """
-        __run_write_stream(self.files, output, write_map, max(threads, self.threads), self.interleave, None)
+        return __run_write_stream(self.files, output, write_map, max(threads, self.threads), self.interleave, None, async=async)
 
     cpdef close(self):
         try:
@@ -259,7 +467,7 @@ cdef class merge(object):
         # for i in range(num_inputs):
         #     gt_input_file_close(inputs[i])
         # free(inputs)
-        __run_write_stream(self.inputs, output, write_map, threads, False, None, __write_merge_stream, async)
+        return __run_write_stream(self.inputs, output, write_map, threads, False, None, merge=True, async=async)
 
 
 
@@ -282,8 +490,16 @@ cdef class OutputFile:
     cdef bool append_extra
     # list of filters
     cdef object filters
-
-    def __init__(self, target, bool clean_id=False, bool append_extra=True):
+    # gzip the output (in-process)
+    cdef readonly bool compress
+    # number of compressor threads (if compress)
+    cdef readonly uint64_t compress_threads
+    # the compressed stream (if compress)
+    cdef FILE* stream
+    # the file opened for a compressed output file name
+    cdef object raw_target
+
+    def __init__(self, target, bool clean_id=False, bool append_extra=True, bool compress=False, uint64_t compress_threads=1):
         """Initialize the output file from the given target. The
         target can be either a string a stream. If init_buffer is
         true, the output buffer is initialized. The output can be configured
@@ -296,8 +512,12 @@ cdef class OutputFile:
         clean_id     -- ensure /1 /2 read pair encoding
         append_extra -- append additional infomration to the id
         init_buffer  -- if true, the buffered output will be initialized, default True
+        compress     -- gzip the output (in-process)
+        compress_threads -- number of threads compressing the output (as pigz -p)
         """
         self.target = target
+        self.compress = compress
+        self.compress_threads = max(1, compress_threads)
         self.map_attributes = gt_output_map_attributes_new()
         self.fasta_attributes = gt_output_fasta_attributes_new()
         self.clean_id = clean_id
@@ -334,7 +554,13 @@ cdef class OutputFile:
         stream      -- the output stream
         init_buffer -- if true, initialize the output buffer
         """
-        self.output_file = gt_output_stream_new(PyFile_AsFile(stream), SORTED_FILE)
+        if self.compress:
+            self.stream = gt_output_stream_dup(PyFile_AsFile(stream), True, self.compress_threads)
+            if self.stream is NULL:
+                raise IOError("Unable to open the compressed output stream")
+            self.output_file = gt_output_stream_new(self.stream, SORTED_FILE)
+        else:
+            self.output_file = gt_output_stream_new(PyFile_AsFile(stream), SORTED_FILE)
 
     cpdef _open_file(self, char* file_name):
         """Initialize this instance from a file
@@ -342,15 +568,44 @@ cdef class OutputFile:
         file_name   -- the output file name
         init_buffer -- if true, initialize the output buffer
         """
-        self.output_file = gt_output_file_new(file_name, SORTED_FILE)
+        if self.compress:
+            self.raw_target = open(file_name, "wb")
+            self._open_stream(self.raw_target)
+        else:
+            self.output_file = gt_output_file_new(file_name, SORTED_FILE)
+
+    cdef FILE* _dup_stream(self):
+        """Return a new stream on the underlying output (compressed
+        if this is a compressed output) that can be written
+        independently of this output file
+        """
+        if self.raw_target is not None:
+            return gt_output_stream_dup(PyFile_AsFile(self.raw_target), self.compress, self.compress_threads)
+        if not isinstance(self.target, basestring):
+            return gt_output_stream_dup(PyFile_AsFile(self.target), self.compress, self.compress_threads)
+        if self.output_file is NULL:
+            return NULL
+        return gt_output_stream_dup(self.output_file.file, self.compress, self.compress_threads)
 
     cpdef close(self):
-        """Close the output file"""
+        """Close the output file. Raises an IOError if the compressed
+        output could not be written
+        """
+        cdef bool failed = False
         if self.output_file is not NULL:
             gt_output_file_close(self.output_file)
             self.output_file = NULL
+        if self.stream is not NULL:
+            with nogil:
+                failed = fclose(self.stream) != 0
+            self.stream = NULL
+        if self.raw_target is not None:
+            self.raw_target.close()
+            self.raw_target = None
         if not isinstance(self.target, basestring):
             self.target.close()
+        if failed:
+            raise IOError("Error while compressing the output")
 
     cpdef write(self, Template template, write_map=True):
         """Write a single template to this otuout file.
@@ -493,7 +748,7 @@ cdef class InputFile(object):
                 self.process.wait()
         return s
 
-    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1):
+    cpdef write_stream(self, OutputFile output, bool write_map=False, uint64_t threads=1, bool async=False):
         """Write the content of this input stream to the output file
         file.
 
@@ -501,8 +756,24 @@ cdef class InputFile(object):
         write_map     -- if true, write map, otherwise write fasta/q sequence
         interleave    -- interleave muliple inputs
         threads       -- number of threads to use (if supported by the iterator)
+        async         -- return the running WriteStreamThread without waiting
+        """
+        return __run_write_stream([self], output, write_map, threads, True, self.process, async=async)
+
+    def batches(self, uint64_t size=1024, uint64_t threads=1):
+        """Iterate the templates in batches of up to size templates.
+        Each batch is parsed without holding the GIL, using
+        threads parser threads. The same TemplateBatch instance is
+        reused (and refilled) on every step, so copy what you need
+        before requesting the next batch.
+
+        Note that with threads > 1 the order of the templates
+        is only preserved within the blocks read by each thread.
+
+        size    -- maximum number of templates per batch
+        threads -- number of parser threads
         """
-        __run_write_stream([self], output, write_map, threads, True, self.process)
+        return TemplateBatchIterator(self, size, threads)
 
     cpdef close(self):
         if self.buffered_input is not NULL:
@@ -516,52 +787,445 @@ cdef class InputFile(object):
             self.input_file = NULL
 
 
-cpdef __run_write_stream(source, OutputFile output, bool write_map=False, uint64_t threads=1, bool interleave=True, parent=None, function=__write_stream, bool async=False):
-    import gem.utils
-    process = multiprocessing.Process(target=function, args=(source, output, write_map, threads, interleave,))
-    gem.utils.register_process(process)
-    process.start()
+cdef class TemplateBatch(object):
+    """A reusable batch of parsed templates. Templates
+    returned from the batch are views that are only valid
+    until the batch is refilled.
+    """
+    cdef gt_template_batch* batch
 
-    if not async:
-        process.join()
-        if parent is not None:
-            parent.wait()
-    return process
+    def __cinit__(self, uint64_t size=1024):
+        self.batch = gt_template_batch_new(size)
 
-cpdef __write_stream(source, OutputFile output, bool write_map=False, uint64_t threads=1, bool interleave=True):
-    cdef gt_output_file* output_file = output.output_file
-    cdef uint64_t num_inputs = len(source)
-    cdef gt_input_file** inputs = <gt_input_file**>malloc( num_inputs *sizeof(gt_input_file*))
-    cdef bool clean_id = output.clean_id
-    cdef bool append_extra = output.append_extra
-    cdef uint64_t use_threads = threads
+    def __dealloc__(self):
+        if self.batch is not NULL:
+            gt_template_batch_delete(self.batch)
+            self.batch = NULL
 
-    for i in range(num_inputs):
-        inputs[i] = (<InputFile> source[i])._open()
+    def __len__(self):
+        return self.batch.num_templates
 
-    with nogil:
-        gt_write_stream(output_file, inputs, num_inputs, append_extra, clean_id, interleave, use_threads, write_map)
+    def __getitem__(self, int64_t i):
+        if i < 0:
+            i += self.batch.num_templates
+        if i < 0 or i >= <int64_t>self.batch.num_templates:
+            raise IndexError("Template batch index out of range")
+        return _create_template(self.batch.templates[i], self)
 
-    output.close()
-    for i in range(num_inputs):
-        gt_input_file_close(inputs[i])
-    free(inputs)
+    def __iter__(self):
+        cdef uint64_t i
+        for i in range(self.batch.num_templates):
+            yield _create_template(self.batch.templates[i], self)
+
+    # Batch exports. Each one returns new (uint64, or uint8 for the
+    # read bytes) ArrayViews filled in a single native loop (no python
+    # object per template)
+
+    cpdef num_maps(self):
+        """Number of maps of each template"""
+        cdef uint64_t n = self.batch.num_templates
+        cdef ArrayView result = _uint64_array(n)
+        cdef uint64_t* data = <uint64_t*>result.data
+        cdef uint64_t i
+        for i in range(n):
+            data[i] = gt_template_get_num_mmaps(self.batch.templates[i])
+        return result
+
+    cpdef read_lengths(self, uint64_t block=0):
+        """Read length of the given block of each template (0 if the
+        template has no such block)
+        """
+        cdef uint64_t n = self.batch.num_templates
+        cdef ArrayView result = _uint64_array(n)
+        cdef uint64_t* data = <uint64_t*>result.data
+        cdef uint64_t i
+        for i in range(n):
+            if block < gt_template_get_num_blocks(self.batch.templates[i]):
+                data[i] = gt_alignment_get_read_length(gt_template_get_block(self.batch.templates[i], block))
+        return result
+
+    cpdef counters(self, uint64_t num_strata):
+        """(templates x num_strata) matrix with the first num_strata
+        counters of each template
+        """
+        cdef uint64_t n = self.batch.num_templates
+        cdef ArrayView result = _uint64_array(n, num_strata)
+        cdef uint64_t* data = <uint64_t*>result.data
+        cdef gt_template* template
+        cdef uint64_t i, j, c
+        for i in range(n):
+            template = self.batch.templates[i]
+            c = gt_template_get_num_counters(template)
+            for j in range(min(c, num_strata)):
+                data[i*num_strata+j] = gt_template_get_counter(template, j)
+        return result
+
+    cpdef map_positions(self, uint64_t block=0):
+        """Global positions of the maps of the given block of all templates.
+        Returns (offsets, positions), where the positions of template i
+        are positions[offsets[i]:offsets[i+1]]
+        """
+        cdef uint64_t n = self.batch.num_templates
+        cdef ArrayView offsets = _uint64_array(n+1)
+        cdef uint64_t* offsets_data = <uint64_t*>offsets.data
+        cdef ArrayView positions
+        cdef uint64_t* positions_data
+        cdef gt_alignment* alignment
+        cdef uint64_t i, j, total = 0
+        for i in range(n):
+            offsets_data[i] = total
+            if block < gt_template_get_num_blocks(self.batch.templates[i]):
+                total += gt_alignment_get_num_maps(gt_template_get_block(self.batch.templates[i], block))
+        offsets_data[n] = total
+        positions = _uint64_array(total)
+        positions_data = <uint64_t*>positions.data
+        for i in range(n):
+            if block < gt_template_get_num_blocks(self.batch.templates[i]):
+                alignment = gt_template_get_block(self.batch.templates[i], block)
+                for j in range(offsets_data[i+1]-offsets_data[i]):
+                    positions_data[offsets_data[i]+j] = gt_map_get_global_position(gt_alignment_get_map(alignment, j))
+        return offsets, positions
+
+    cpdef reads(self, uint64_t block=0):
+        """Read bytes of the given block of all templates, concatenated.
+        Returns (offsets, reads), where the read of template i
+        is reads[offsets[i]:offsets[i+1]]
+        """
+        return self._sequences(block, False)
 
-cpdef __write_merge_stream(source, OutputFile output, bool write_map=False, uint64_t threads=1, bool interleave=True):
-    cdef gt_output_file* output_file = output.output_file
-    cdef uint64_t num_inputs = len(source)
-    cdef gt_input_file** inputs = <gt_input_file**>malloc( num_inputs *sizeof(gt_input_file*))
-    cdef uint64_t use_threads = threads
+    cpdef qualities(self, uint64_t block=0):
+        """Quality bytes of the given block of all templates, concatenated.
+        Returns (offsets, qualities), where the qualities of template i
+        are qualities[offsets[i]:offsets[i+1]] (empty if the read
+        has no qualities)
+        """
+        return self._sequences(block, True)
+
+    cdef _sequences(self, uint64_t block, bool qualities):
+        cdef uint64_t n = self.batch.num_templates
+        cdef ArrayView offsets = _uint64_array(n+1)
+        cdef uint64_t* offsets_data = <uint64_t*>offsets.data
+        cdef ArrayView sequences
+        cdef char* sequences_data
+        cdef gt_alignment* alignment
+        cdef uint64_t i, total = 0
+        for i in range(n):
+            offsets_data[i] = total
+            if block < gt_template_get_num_blocks(self.batch.templates[i]):
+                alignment = gt_template_get_block(self.batch.templates[i], block)
+                if not qualities or gt_alignment_has_qualities(alignment):
+                    total += gt_alignment_get_read_length(alignment)
+        offsets_data[n] = total
+        sequences = _uint8_array(total)
+        sequences_data = <char*>sequences.data
+        for i in range(n):
+            if offsets_data[i+1] > offsets_data[i]:
+                alignment = gt_template_get_block(self.batch.templates[i], block)
+                memcpy(sequences_data + offsets_data[i],
+                       gt_alignment_get_qualities(alignment) if qualities else gt_alignment_get_read(alignment),
+                       offsets_data[i+1]-offsets_data[i])
+        return offsets, sequences
+
+
+cdef class TemplateBatchIterator(object):
+    """Iterate an input file in template batches. The iterator
+    opens its own input and one buffered input per parser thread.
+    """
+    cdef InputFile source
+    cdef readonly TemplateBatch batch
+    cdef uint64_t threads
+    cdef gt_input_file* input_file
+    cdef gt_buffered_input_file** buffered_inputs
+    cdef gt_generic_parser_attr* parser_attr
+    # native filters applied while parsing (optional)
+    cdef TemplateFilterChain filters
 
-    for i in range(num_inputs):
-        inputs[i] = (<InputFile> source[i])._open()
+    def __init__(self, InputFile source, uint64_t size=1024, uint64_t threads=1, TemplateFilterChain filters=None):
+        cdef uint64_t i
+        if size == 0:
+            raise ValueError("Template batch size must be > 0")
+        self.source = source
+        self.filters = filters
+        self.batch = TemplateBatch(size)
+        self.threads = max(threads, 1)
+        self.input_file = source._open()
+        self.parser_attr = gt_input_generic_parser_attributes_new(source.force_paired_reads)
+        self.buffered_inputs = <gt_buffered_input_file**>malloc(self.threads * sizeof(gt_buffered_input_file*))
+        for i in range(self.threads):
+            self.buffered_inputs[i] = gt_buffered_input_file_new(self.input_file)
 
-    with nogil:
-        gt_merge_files_synch(output_file, threads, num_inputs, inputs);
-    output.close()
+    def __dealloc__(self):
+        self._close()
+
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        cdef gt_template_batch* batch = self.batch.batch
+        cdef gt_template_filter_chain* chain = NULL
+        cdef uint64_t num_templates = 0
+        if self.input_file is NULL:
+            raise StopIteration()
+        if self.filters is not None:
+            chain = self.filters.chain
+        with nogil:
+            num_templates = gt_template_batch_fill(batch, self.buffered_inputs, self.threads, self.parser_attr, chain)
+        if batch.error_code != GT_STATUS_OK:
+            self.close()
+            raise ValueError("Error while parsing templates")
+        if num_templates == 0:
+            self.close()
+            raise StopIteration()
+        return self.batch
+
+    cdef _close(self):
+        cdef uint64_t i
+        if self.buffered_inputs is not NULL:
+            for i in range(self.threads):
+                gt_buffered_input_file_close(self.buffered_inputs[i])
+            free(self.buffered_inputs)
+            self.buffered_inputs = NULL
+        if self.parser_attr is not NULL:
+            free(self.parser_attr)
+            self.parser_attr = NULL
+        if self.input_file is not NULL:
+            gt_input_file_close(self.input_file)
+            self.input_file = NULL
+
+    cpdef close(self):
+        self._close()
+        if self.source is not None and self.source.process is not None:
+            # if this is a stream based process, make sure we clean up
+            self.source.process.wait()
+        self.source = None
+
+
+cdef class WriteStreamThread(object):
+    """Handle of a write_stream running on a native thread. The thread
+    writes to its own copy of the output (and closes the inputs when done).
+    join() (or wait()) blocks until the output is written and raises
+    an IOError if the inputs could not be parsed or the output could
+    not be written.
+    """
+    cdef gt_write_job* job
+    # the native filters used by the thread
+    cdef object filters
+    # the stats filled by the thread
+    cdef object stats
+    # the process that creates the content of the input (if any)
+    cdef object parent
+
+    def __dealloc__(self):
+        if self.job is not NULL:
+            with nogil:
+                gt_write_job_delete(self.job)
+            self.job = NULL
+
+    cpdef bool is_alive(self):
+        return self.job is not NULL and self.job.running
+
+    cpdef join(self):
+        cdef gt_status status
+        if self.job is NULL:
+            return
+        with nogil:
+            status = gt_write_job_join(self.job)
+            gt_write_job_delete(self.job)
+        self.job = NULL
+        self.filters = None
+        self.stats = None
+        if self.parent is not None:
+            parent = self.parent
+            self.parent = None
+            parent.wait()
+        if status != GT_STATUS_OK:
+            raise IOError("Error while writing the output stream")
+
+    def wait(self):
+        self.join()
+
+
+cpdef __run_write_stream(source, OutputFile output, bool write_map=False, uint64_t threads=1, bool interleave=True, parent=None, bool merge=False, bool async=False, filters=None,
+                         Stats all_stats=None, Stats best_stats=None):
+    """Write the inputs to the output on a native thread (no fork). The
+    output is closed, the thread writes to its own copy of the underlying
+    stream. Returns the WriteStreamThread (joined unless async is True).
+    With stats (single input, map output) the written templates also fill
+    them.
+    """
+    cdef WriteStreamThread writer = WriteStreamThread()
+    cdef TemplateFilterChain chain = None
+    cdef gt_template_filter_chain* native_filters = NULL
+    cdef uint64_t num_inputs = len(source)
+    cdef gt_input_file** inputs
+    cdef FILE* stream
+    cdef uint64_t i
+    with_stats = all_stats is not None or best_stats is not None
+    if with_stats and (num_inputs != 1 or merge or filters is not None):
+        raise ValueError("Stats can only be filled from a single unfiltered input")
+    if filters is not None:
+        chain = compile_filters(filters)
+        if chain is None:
+            raise ValueError("Only built-in filters can be applied by write_stream")
+        native_filters = chain.chain
+    stream = output._dup_stream()
+    if stream is NULL:
+        raise IOError("Unable to open the output stream")
+    inputs = <gt_input_file**>malloc(num_inputs * sizeof(gt_input_file*))
     for i in range(num_inputs):
-        gt_input_file_close(inputs[i])
+        inputs[i] = (<InputFile> source[i])._open()
+    writer.job = gt_write_job_new(stream, inputs, num_inputs, merge, output.append_extra, output.clean_id, interleave, threads, write_map, native_filters)
     free(inputs)
+    if with_stats:
+        gt_write_job_set_stats(writer.job, all_stats.stats if all_stats is not None else NULL,
+                               best_stats.stats if best_stats is not None else NULL,
+                               (all_stats if all_stats is not None else best_stats).paired)
+        writer.stats = (all_stats, best_stats)
+    writer.filters = chain
+    writer.parent = parent
+    gt_write_job_start(writer.job)
+    output.close()
+    if not async:
+        writer.join()
+    return writer
+
+
+cdef uint64_t _empty_array[1]
+
+cdef class ArrayView(object):
+    """Native memory (uint8 or uint64, one or two dimensions) exported
+    through the buffer protocol, so it can be wrapped with
+    numpy.asarray(view) or memoryview(view) without copying.
+    Views of memory that is never reallocated (stats) keep their owner
+    alive and are read-only. Template memory is reallocated when the
+    template is refilled, so templates only export read-only copies
+    (the *_array properties) and batches export their reads, qualities
+    and map positions in contiguous arrays. Exported arrays own their
+    (writable) data.
+    """
+    cdef void* data
+    cdef char* format
+    cdef Py_ssize_t itemsize
+    cdef int ndim
+    cdef Py_ssize_t _shape[2]
+    cdef Py_ssize_t _strides[2]
+    # free the data on dealloc (exported arrays and copies)
+    cdef bool owns_data
+    # the buffer is exported read-only
+    cdef bool readonly
+    # the owner of the memory
+    cdef object owner
+
+    def __dealloc__(self):
+        if self.owns_data and self.data is not NULL:
+            free(self.data)
+        self.data = NULL
+
+    def __getbuffer__(self, Py_buffer* buffer, int flags):
+        if self.readonly and (flags & PyBUF_WRITABLE) == PyBUF_WRITABLE:
+            raise BufferError("ArrayView is read-only")
+        buffer.buf = self.data
+        buffer.obj = self
+        buffer.len = self._size() * self.itemsize
+        buffer.readonly = 1 if self.readonly else 0
+        buffer.itemsize = self.itemsize
+        buffer.format = self.format
+        buffer.ndim = self.ndim
+        buffer.shape = self._shape
+        buffer.strides = self._strides
+        buffer.suboffsets = NULL
+        buffer.internal = NULL
+
+    def __releasebuffer__(self, Py_buffer* buffer):
+        pass
+
+    cdef Py_ssize_t _size(self):
+        if self.ndim == 2:
+            return self._shape[0] * self._shape[1]
+        return self._shape[0]
+
+    def __len__(self):
+        return self._shape[0]
+
+    property shape:
+        def __get__(self):
+            if self.ndim == 2:
+                return (self._shape[0], self._shape[1])
+            return (self._shape[0],)
+
+    def tostring(self):
+        """Return a copy of the raw bytes"""
+        return (<char*>self.data)[:self._size() * self.itemsize]
+
+    def tolist(self):
+        """Return the content as a (nested) list of integers"""
+        cdef Py_ssize_t i, j, n = self._size()
+        cdef unsigned char* bytes = <unsigned char*>self.data
+        cdef uint64_t* values = <uint64_t*>self.data
+        if self.itemsize == 1:
+            flat = [bytes[i] for i in range(n)]
+        else:
+            flat = [values[i] for i in range(n)]
+        if self.ndim == 2:
+            j = self._shape[1]
+            return [flat[i*j:(i+1)*j] for i in range(self._shape[0])]
+        return flat
+
+
+cdef ArrayView _array_view(void* data, char* format, Py_ssize_t itemsize, Py_ssize_t length, object owner, bool owns_data=False, Py_ssize_t columns=0):
+    cdef ArrayView view = ArrayView()
+    view.data = data if data is not NULL else <void*>_empty_array
+    view.format = format
+    view.itemsize = itemsize
+    view.owner = owner
+    view.owns_data = owns_data and data is not NULL
+    view.readonly = not owns_data
+    if columns > 0:
+        view.ndim = 2
+        view._shape[0] = length
+        view._shape[1] = columns
+        view._strides[0] = columns * itemsize
+        view._strides[1] = itemsize
+    else:
+        view.ndim = 1
+        view._shape[0] = length
+        view._strides[0] = itemsize
+    return view
+
+cdef ArrayView _uint64_view(uint64_t* data, Py_ssize_t length, object owner):
+    return _array_view(data, "Q", sizeof(uint64_t), length, owner)
+
+cdef ArrayView _array_copy(void* data, char* format, Py_ssize_t itemsize, Py_ssize_t length):
+    """Read-only copy of native memory that can be reallocated by its owner"""
+    cdef ArrayView view
+    cdef void* copy = NULL
+    if length > 0:
+        copy = malloc(length * itemsize)
+        if copy is NULL:
+            raise MemoryError()
+        memcpy(copy, data, length * itemsize)
+    view = _array_view(copy, format, itemsize, length, None, True)
+    view.readonly = True
+    return view
+
+cdef ArrayView _uint8_array(Py_ssize_t length):
+    """New (owned) uint8 array used to export bytes in batch"""
+    cdef void* data = NULL
+    if length > 0:
+        data = malloc(length)
+        if data is NULL:
+            raise MemoryError()
+    return _array_view(data, "B", 1, length, None, True)
+
+cdef ArrayView _uint64_array(Py_ssize_t length, Py_ssize_t columns=0):
+    """New (owned, zeroed) uint64 array used to export values in batch"""
+    cdef Py_ssize_t size = length * (columns if columns > 0 else 1)
+    cdef uint64_t* data = NULL
+    if size > 0:
+        data = <uint64_t*>calloc(size, sizeof(uint64_t))
+        if data is NULL:
+            raise MemoryError()
+    return _array_view(data, "Q", sizeof(uint64_t), length, None, True, columns)
 
 
 cdef _create_alignment(gt_alignment* ali):
@@ -630,6 +1294,34 @@ cdef class Alignment:
         def __get__(self):
             return self._qualities()
 
+    property read_array:
+        """Read-only uint8 copy of the read"""
+        def __get__(self):
+            return _array_copy(gt_alignment_get_read(self.alignment), "B", 1, self._length())
+
+    property qualities_array:
+        """Read-only uint8 copy of the qualities (None if there are no qualities)"""
+        def __get__(self):
+            if not gt_alignment_has_qualities(self.alignment):
+                return None
+            return _array_copy(gt_alignment_get_qualities(self.alignment), "B", 1, self._length())
+
+    property counters_array:
+        """Read-only uint64 copy of the counters"""
+        def __get__(self):
+            cdef gt_vector* counters = gt_alignment_get_counters_vector(self.alignment)
+            return _array_copy(counters.memory, "Q", sizeof(uint64_t), counters.used)
+
+    cpdef map_positions(self):
+        """Return the global positions of all maps as a uint64 ArrayView"""
+        cdef uint64_t num_maps = gt_alignment_get_num_maps(self.alignment)
+        cdef ArrayView positions = _uint64_array(num_maps)
+        cdef uint64_t* data = <uint64_t*>positions.data
+        cdef uint64_t i
+        for i in range(num_maps):
+            data[i] = gt_map_get_global_position(gt_alignment_get_map(self.alignment, i))
+        return positions
+
     cdef uint64_t _length(self):
         return gt_alignment_get_read_length(self.alignment)
 
@@ -781,15 +1473,27 @@ cdef class Map:
 
 
 
+cdef _create_template(gt_template* tmpl, object owner=None):
+    t = Template(initialize=False)
+    t.template = tmpl
+    t.owner = owner
+    return t
+
 cdef class Template:
     """Wrapper class around gt_tempalte"""
     cdef gt_template* template
+    cdef bool initialize
+    # keeps the owner of a non-initialized template alive
+    cdef object owner
 
-    def __cinit__(self):
-        self.template = gt_template_new()
+    def __cinit__(self, initialize=True):
+        self.initialize = initialize
+        if initialize:
+            self.template = gt_template_new()
 
     def __dealloc__(self):
-        gt_template_delete(self.template)
+        if self.initialize:
+            gt_template_delete(self.template)
 
     property tag:
         def __get__(self):
@@ -813,6 +1517,12 @@ cdef class Template:
         def __get__(self):
             return gt_template_get_num_counters(self.template)
 
+    property counters_array:
+        """Read-only uint64 copy of the counters"""
+        def __get__(self):
+            cdef gt_vector* counters = gt_template_get_counters_vector(self.template)
+            return _array_copy(counters.memory, "Q", sizeof(uint64_t), counters.used)
+
     property num_maps:
         def __get__(self):
             return gt_template_get_num_mmaps(self.template)
@@ -947,8 +1657,11 @@ cdef class Template:
     cpdef merge(self, Template other):
         """Merge the other template into this one"""
         cdef gt_template* tmpl = gt_template_union_template_mmaps(self.template, other.template)
-        gt_template_delete(self.template)
+        if self.initialize:
+            gt_template_delete(self.template)
         self.template = tmpl
+        self.initialize = True
+        self.owner = None
 
     cpdef get_pair(self):
         """Return 0 for unpaired or 1 or 2"""
@@ -1008,6 +1721,28 @@ cdef class Stats(object):
     cpdef write(self, output):
         gt_stats_print_stats(PyFile_AsFile(output), self.stats, self.paired)
 
+    cpdef write_binary(self, output):
+        """Write the stats in a compact binary form (see
+        gem.stats.read_binary()). Counters and histograms are stored
+        as named uint64 arrays (host byte order, two dimensional
+        histograms row major)
+        """
+        views = self.views
+        arrays = {}
+        for name, value in _stats_counters(self.__dict__):
+            if name.split(".")[0] not in views:
+                arrays[name] = ("c", struct.pack("=Q", value))
+        for name, view in views.items():
+            arrays[name] = ("h", view.tostring())
+        output.write(STATS_BINARY_MAGIC)
+        output.write(struct.pack("=BBQ", self.best_map, self.paired, len(arrays)))
+        for name in sorted(arrays):
+            kind, data = arrays[name]
+            output.write(struct.pack("=H", len(name)))
+            output.write(name)
+            output.write(struct.pack("=cQ", kind, len(data) // 8))
+            output.write(data)
+
     property min_length:
         def __get__(self):
             return self.stats.min_length
@@ -1056,15 +1791,13 @@ cdef class Stats(object):
             return {"A": c[0], "C":c[1], "G":c[2], "T":c[3], "N":c[4]}
     property mmap:
         def __get__(self):
-            cdef uint64_t * c = self.stats.mmap
-            return [c[i] for i in range(8)]
+            return _uint64_view(self.stats.mmap, GT_STATS_MMAP_RANGE, self).tolist()
     property mmap_description:
         def __get__(self):
             return ["0", "5", "10", "50", "100", "500", "1000", "more"]
     property uniq:
         def __get__(self):
-            cdef uint64_t * c = self.stats.uniq
-            return [c[i] for i in range(10)]
+            return _uint64_view(self.stats.uniq, GT_STATS_UNIQ_RANGE, self).tolist()
     property uniq_description:
         def __get__(self):
             return ["0", "1", "2", "3", "10", "50", "100", "500", "more", "rest"]
@@ -1074,6 +1807,19 @@ cdef class Stats(object):
     property splits_profile:
         def __get__(self):
             return StatsSplitsProfile(self)
+    property views:
+        """Zero-copy uint64 views of all histograms (including the
+        maps and splits profiles) that can be wrapped with numpy.asarray()
+        """
+        def __get__(self):
+            views = {
+                "nt_counting": _uint64_view(self.stats.nt_counting, GT_STATS_NT_BASE_RANGE, self),
+                "mmap": _uint64_view(self.stats.mmap, GT_STATS_MMAP_RANGE, self),
+                "uniq": _uint64_view(self.stats.uniq, GT_STATS_UNIQ_RANGE, self),
+            }
+            views.update(self.maps_profile.views)
+            views.update(self.splits_profile.views)
+            return views
 
     property __dict__:
         def __get__(self):
@@ -1099,11 +1845,37 @@ cdef class Stats(object):
             }
 
 
+# header of the binary stats (Stats.write_binary())
+STATS_BINARY_MAGIC = "GTSTATS1"
+
+def _stats_counters(values, prefix=""):
+    """Yield (name, value) for all integer counters of a stats dict.
+    Counters of the profiles are prefixed with the profile name"""
+    for name, value in values.items():
+        if isinstance(value, dict):
+            for counter in _stats_counters(value, prefix + name + "."):
+                yield counter
+        elif isinstance(value, (int, long)) and not isinstance(value, bool):
+            yield (prefix + name, value)
+
+
 cdef class StatsSplitsProfile(object):
     cdef gt_splitmaps_profile* profile
+    # the stats that own the profile
+    cdef object owner
 
     def __init__(self, Stats stats):
         self.profile = stats.stats.splitmaps_profile
+        self.owner = stats
+
+    property views:
+        """Zero-copy uint64 views of all histograms"""
+        def __get__(self):
+            return {
+                "num_junctions": _uint64_view(self.profile.num_junctions, GT_STATS_NUM_JUNCTION_RANGE, self.owner),
+                "length_junctions": _uint64_view(self.profile.length_junctions, GT_STATS_LEN_JUNCTION_RANGE, self.owner),
+                "junction_position": _uint64_view(self.profile.junction_position, GT_STATS_SHORT_READ_POS_RANGE, self.owner),
+            }
 
     property num_mapped_with_splitmaps:
         def __get__(self):
@@ -1119,19 +1891,19 @@ cdef class StatsSplitsProfile(object):
             return self.profile.total_junctions
     property num_junctions:
         def __get__(self):
-            return [self.profile.num_junctions[i] for i in range(4)]
+            return _uint64_view(self.profile.num_junctions, GT_STATS_NUM_JUNCTION_RANGE, self.owner).tolist()
     property num_junctions_description:
         def __get__(self):
             return ["1", "2", "3", "more"]
     property length_junctions:
         def __get__(self):
-            return [self.profile.length_junctions[i] for i in range(6)]
+            return _uint64_view(self.profile.length_junctions, GT_STATS_LEN_JUNCTION_RANGE, self.owner).tolist()
     property length_junctions_description:
         def __get__(self):
             return ["100", "1000", "5000", "10000", "50000", "more"]
     property junction_position:
         def __get__(self):
-            return [self.profile.junction_position[i] for i in range(100)]
+            return _uint64_view(self.profile.junction_position, GT_STATS_SHORT_READ_POS_RANGE, self.owner).tolist()
     property pe_sm_sm:
         def __get__(self):
             return self.profile.pe_sm_sm
@@ -1162,28 +1934,61 @@ cdef class StatsSplitsProfile(object):
 
 cdef class StatsMapProfile(object):
     cdef gt_maps_profile* profile
+    # the stats that own the profile
+    cdef object owner
 
     def __init__(self, Stats stats):
         self.profile = stats.stats.maps_profile
+        self.owner = stats
+
+    property views:
+        """Zero-copy uint64 views of all histograms"""
+        def __get__(self):
+            return {
+                "mismatches": _uint64_view(self.profile.mismatches, GT_STATS_MISMS_RANGE, self.owner),
+                "levenshtein": _uint64_view(self.profile.levenshtein, GT_STATS_MISMS_RANGE, self.owner),
+                "insertion_length": _uint64_view(self.profile.insertion_length, GT_STATS_MISMS_RANGE, self.owner),
+                "deletion_length": _uint64_view(self.profile.deletion_length, GT_STATS_MISMS_RANGE, self.owner),
+                "errors_events": _uint64_view(self.profile.errors_events, GT_STATS_MISMS_RANGE, self.owner),
+                "error_position": _uint64_view(self.profile.error_position, GT_STATS_LARGE_READ_POS_RANGE, self.owner),
+                "inss": _uint64_view(self.profile.inss, GT_STATS_INSS_RANGE, self.owner),
+                "inss_fine_grain": _uint64_view(self.profile.inss_fine_grain, GT_STATS_INSS_FG_RANGE, self.owner),
+                "misms_transition": _array_view(self.profile.misms_transition, "Q", sizeof(uint64_t), GT_STATS_MISMS_BASE_RANGE, self.owner, False, GT_STATS_MISMS_BASE_RANGE),
+                "qual_score_misms": _uint64_view(self.profile.qual_score_misms, GT_STATS_QUAL_SCORE_RANGE, self.owner),
+                "qual_score_errors": _uint64_view(self.profile.qual_score_errors, GT_STATS_QUAL_SCORE_RANGE, self.owner),
+                "misms_1context": _uint64_view(self.profile.misms_1context, GT_STATS_MISMS_1_CONTEXT_RANGE, self.owner),
+                "misms_2context": _uint64_view(self.profile.misms_2context, GT_STATS_MISMS_2_CONTEXT_RANGE, self.owner),
+                "indel_transition_1": _uint64_view(self.profile.indel_transition_1, GT_STATS_INDEL_TRANSITION_1_RANGE, self.owner),
+                "indel_transition_2": _uint64_view(self.profile.indel_transition_2, GT_STATS_INDEL_TRANSITION_2_RANGE, self.owner),
+                "indel_transition_3": _uint64_view(self.profile.indel_transition_3, GT_STATS_INDEL_TRANSITION_3_RANGE, self.owner),
+                "indel_transition_4": _uint64_view(self.profile.indel_transition_4, GT_STATS_INDEL_TRANSITION_4_RANGE, self.owner),
+                "indel_1context": _uint64_view(self.profile.indel_1context, GT_STATS_INDEL_1_CONTEXT, self.owner),
+                "indel_2context": _uint64_view(self.profile.indel_2context, GT_STATS_INDEL_2_CONTEXT, self.owner),
+                "insertion_event_length": _uint64_view(self.profile.insertion_event_length, GT_STATS_INDEL_LENGTH_RANGE, self.owner),
+                "deletion_event_length": _uint64_view(self.profile.deletion_event_length, GT_STATS_INDEL_LENGTH_RANGE, self.owner),
+                "insertion_homopolymer": _uint64_view(self.profile.insertion_homopolymer, GT_STATS_INDEL_HOMOPOLYMER_RANGE, self.owner),
+                "deletion_homopolymer": _uint64_view(self.profile.deletion_homopolymer, GT_STATS_INDEL_HOMOPOLYMER_RANGE, self.owner),
+                "indel_position": _uint64_view(self.profile.indel_position, GT_STATS_LARGE_READ_POS_RANGE, self.owner),
+            }
 
     property mismatches_description:
         def __get__(self):
             return ["1", "2","3", "4", "5", "6", "7", "8", "9", "10", "20", "50", "more"]
     property mismatches:
         def __get__(self):
-            return [self.profile.mismatches[i] for i in range(14)]
+            return _uint64_view(self.profile.mismatches, GT_STATS_MISMS_RANGE, self.owner).tolist()
     property levenshtein:
         def __get__(self):
-            return [self.profile.levenshtein[i] for i in range(14)]
+            return _uint64_view(self.profile.levenshtein, GT_STATS_MISMS_RANGE, self.owner).tolist()
     property insertion_length:
         def __get__(self):
-            return [self.profile.insertion_length[i] for i in range(14)]
+            return _uint64_view(self.profile.insertion_length, GT_STATS_MISMS_RANGE, self.owner).tolist()
     property deletion_length:
         def __get__(self):
-            return [self.profile.deletion_length[i] for i in range(14)]
+            return _uint64_view(self.profile.deletion_length, GT_STATS_MISMS_RANGE, self.owner).tolist()
     property errors_events:
         def __get__(self):
-            return [self.profile.errors_events[i] for i in range(14)]
+            return _uint64_view(self.profile.errors_events, GT_STATS_MISMS_RANGE, self.owner).tolist()
     property total_mismatches:
         def __get__(self):
             return self.profile.total_mismatches
@@ -1198,7 +2003,7 @@ cdef class StatsMapProfile(object):
             return self.profile.total_errors_events
     property error_position:
         def __get__(self):
-            return [self.profile.error_position[i] for i in range(1000)]
+            return _uint64_view(self.profile.error_position, GT_STATS_LARGE_READ_POS_RANGE, self.owner).tolist()
     property total_bases:
         def __get__(self):
             return self.profile.total_bases
@@ -1210,46 +2015,92 @@ cdef class StatsMapProfile(object):
             return self.profile.total_bases_trimmed
     property inss_fine_grain:
         def __get__(self):
-            return [self.profile.inss_fine_grain[i] for i in range(GT_STATS_INSS_FG_RANGE)]
+            return _uint64_view(self.profile.inss_fine_grain, GT_STATS_INSS_FG_RANGE, self.owner).tolist()
     property inss:
         def __get__(self):
-            return [self.profile.inss[i] for i in range(16)]
+            return _uint64_view(self.profile.inss, GT_STATS_INSS_RANGE, self.owner).tolist()
+    property inss_orientations:
+        def __get__(self):
+            cdef gt_inss_model* m = self.profile.inss_model
+            return {"FR": gt_inss_model_get_num_samples(m, GT_INSS_FR),
+                    "RF": gt_inss_model_get_num_samples(m, GT_INSS_RF),
+                    "TANDEM": gt_inss_model_get_num_samples(m, GT_INSS_TANDEM),
+                    "DIFF_CONTIG": m.num_different_contigs}
+    property inss_quantiles:
+        def __get__(self):
+            return dict((q, self.inss_quantile(q)) for q in [0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99])
+    def inss_quantile(self, double quantile, orientation=None):
+        """Return the given quantile (0..1) of the signed insert size
+        (as used by the insert size filters) of the pairs with the given
+        orientation ('FR' or 'RF'; tandem pairs have no insert size).
+        If no orientation is given, the dominant one is used. The value
+        is within 1% of the exact quantile.
+        """
+        cdef gt_inss_orientation o
+        if orientation is None:
+            o = gt_inss_model_get_dominant_orientation(self.profile.inss_model)
+        elif orientation in ("FR", "RF"):
+            o = GT_INSS_FR if orientation == "FR" else GT_INSS_RF
+        else:
+            raise ValueError("No insert size quantiles for orientation %s" % orientation)
+        return gt_inss_model_get_quantile(self.profile.inss_model, o, quantile)
     property inss_description:
         def __get__(self):
             return ["(-inf, 0)", "(-100, 0)", "(0, 100]", "(100, 200]", "(200, 300]", "(300, 400]", "(400, 500]", "(500, 600]", "(600, 700]", "(700, 800]", "(800, 900]", "(900, 1000]", "(1000, 2000]", "(2000, 5000]", "(5000, 10000]", "(1000, inf]"]
     property misms_transition:
         def __get__(self):
-            return [self.profile.misms_transition[i] for i in range(5*14)] # GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_RANGE */
+            return _uint64_view(self.profile.misms_transition, GT_STATS_MISMS_BASE_RANGE*GT_STATS_MISMS_RANGE, self.owner).tolist()
     property qual_score_misms:
         def __get__(self):
-            return [self.profile.qual_score_misms[i] for i in range(256)]
+            return _uint64_view(self.profile.qual_score_misms, GT_STATS_QUAL_SCORE_RANGE, self.owner).tolist()
     property qual_score_errors:
         def __get__(self):
-            return [self.profile.qual_score_errors[i] for i in range(256)]
+            return _uint64_view(self.profile.qual_score_errors, GT_STATS_QUAL_SCORE_RANGE, self.owner).tolist()
     property misms_1context:
         def __get__(self):
-            return [self.profile.misms_1context[i] for i in range(GT_STATS_MISMS_1_CONTEXT_RANGE)]
+            return _uint64_view(self.profile.misms_1context, GT_STATS_MISMS_1_CONTEXT_RANGE, self.owner).tolist()
     property misms_2context:
         def __get__(self):
-            return [self.profile.misms_2context[i] for i in range(GT_STATS_MISMS_2_CONTEXT_RANGE)]
+            return _uint64_view(self.profile.misms_2context, GT_STATS_MISMS_2_CONTEXT_RANGE, self.owner).tolist()
     property indel_transition_1:
         def __get__(self):
-            return [self.profile.indel_transition_1[i] for i in range(GT_STATS_INDEL_TRANSITION_1_RANGE)]
+            return _uint64_view(self.profile.indel_transition_1, GT_STATS_INDEL_TRANSITION_1_RANGE, self.owner).tolist()
     property indel_transition_2:
         def __get__(self):
-            return [self.profile.indel_transition_2[i] for i in range(GT_STATS_INDEL_TRANSITION_2_RANGE)]
+            return _uint64_view(self.profile.indel_transition_2, GT_STATS_INDEL_TRANSITION_2_RANGE, self.owner).tolist()
     property indel_transition_3:
         def __get__(self):
-            return [self.profile.indel_transition_3[i] for i in range(GT_STATS_INDEL_TRANSITION_3_RANGE)]
+            return _uint64_view(self.profile.indel_transition_3, GT_STATS_INDEL_TRANSITION_3_RANGE, self.owner).tolist()
     property indel_transition_4:
         def __get__(self):
-            return [self.profile.indel_transition_4[i] for i in range(GT_STATS_INDEL_TRANSITION_4_RANGE)]
+            return _uint64_view(self.profile.indel_transition_4, GT_STATS_INDEL_TRANSITION_4_RANGE, self.owner).tolist()
     property indel_1context:
         def __get__(self):
-            return [self.profile.indel_1context[i] for i in range(GT_STATS_INDEL_1_CONTEXT)]
+            return _uint64_view(self.profile.indel_1context, GT_STATS_INDEL_1_CONTEXT, self.owner).tolist()
     property indel_2context:
         def __get__(self):
-            return [self.profile.indel_2context[i] for i in range(GT_STATS_INDEL_2_CONTEXT)]
+            return _uint64_view(self.profile.indel_2context, GT_STATS_INDEL_2_CONTEXT, self.owner).tolist()
+    property total_insertions:
+        def __get__(self):
+            return self.profile.total_insertions
+    property total_deletions:
+        def __get__(self):
+            return self.profile.total_deletions
+    property insertion_event_length:
+        def __get__(self):
+            return _uint64_view(self.profile.insertion_event_length, GT_STATS_INDEL_LENGTH_RANGE, self.owner).tolist()
+    property deletion_event_length:
+        def __get__(self):
+            return _uint64_view(self.profile.deletion_event_length, GT_STATS_INDEL_LENGTH_RANGE, self.owner).tolist()
+    property insertion_homopolymer:
+        def __get__(self):
+            return _uint64_view(self.profile.insertion_homopolymer, GT_STATS_INDEL_HOMOPOLYMER_RANGE, self.owner).tolist()
+    property deletion_homopolymer:
+        def __get__(self):
+            return _uint64_view(self.profile.deletion_homopolymer, GT_STATS_INDEL_HOMOPOLYMER_RANGE, self.owner).tolist()
+    property indel_position:
+        def __get__(self):
+            return _uint64_view(self.profile.indel_position, GT_STATS_LARGE_READ_POS_RANGE, self.owner).tolist()
     property __dict__:
         def __get__(self):
             return {
@@ -1270,6 +2121,8 @@ cdef class StatsMapProfile(object):
                 "inss": self.inss,
                 "inss_fine_grain": self.inss_fine_grain,
                 "inss_description": self.inss_description,
+                "inss_orientations": self.inss_orientations,
+                "inss_quantiles": self.inss_quantiles,
                 "misms_transition": self.misms_transition,
                 "qual_score_misms": self.qual_score_misms,
                 "qual_score_errors": self.qual_score_errors,
@@ -1281,6 +2134,13 @@ cdef class StatsMapProfile(object):
                 "indel_transition_4": self.indel_transition_4,
                 "indel_1context": self.indel_1context,
                 "indel_2context": self.indel_2context,
+                "total_insertions": self.total_insertions,
+                "total_deletions": self.total_deletions,
+                "insertion_event_length": self.insertion_event_length,
+                "deletion_event_length": self.deletion_event_length,
+                "insertion_homopolymer": self.insertion_homopolymer,
+                "deletion_homopolymer": self.deletion_homopolymer,
+                "indel_position": self.indel_position,
             }
 
 
@@ -1318,3 +2178,221 @@ cpdef __calculate_stats_process(Stats all_stats, Stats best_stats, source, uint6
         gt_stats_fill(input, target_all, target_best, threads, paired)
 
 
+# maximum junction site distance (no limit)
+GT_JUNCTION_MAX_DISTANCE = 0xFFFFFFFFFFFFFFFF
+
+cdef class JunctionSet(object):
+    """Native set of junction sites and their coverage. Iterating
+    yields (chr_1, strand_1, pos_1, chr_2, strand_2, pos_2, coverage)
+    tuples in insertion order (or sorted, after sort()), where the first
+    six fields are the descriptor of a gem.junctions.JunctionSite.
+    Overlap and site queries use a sorted interval index.
+    """
+    cdef gt_junction_set* junctions
+
+    def __cinit__(self):
+        self.junctions = gt_junction_set_new()
+
+    def __dealloc__(self):
+        if self.junctions is not NULL:
+            gt_junction_set_delete(self.junctions)
+            self.junctions = NULL
+
+    def __len__(self):
+        return gt_junction_set_get_num_junctions(self.junctions)
+
+    def __iter__(self):
+        cdef uint64_t i
+        for i in range(gt_junction_set_get_num_junctions(self.junctions)):
+            yield self._descriptor(i)
+
+    cdef tuple _descriptor(self, uint64_t position):
+        cdef gt_junction* junction = gt_junction_set_get_junction(self.junctions, position)
+        return (gt_junction_set_get_seq_name(self.junctions, junction.start_seq),
+                "+" if junction.start_strand == FORWARD else "-",
+                junction.start_position,
+                gt_junction_set_get_seq_name(self.junctions, junction.end_seq),
+                "+" if junction.end_strand == FORWARD else "-",
+                junction.end_position,
+                junction.coverage)
+
+    cpdef add(self, char* chr_1, strand_1, uint64_t pos_1, char* chr_2, strand_2, uint64_t pos_2, uint64_t coverage=1):
+        """Add coverage to a junction (inserted if not yet in the set)"""
+        cdef gt_junction junction
+        junction.start_seq = gt_junction_set_get_seq_id(self.junctions, chr_1, len(chr_1))
+        junction.start_strand = FORWARD if strand_1 == "+" else REVERSE
+        junction.start_position = pos_1
+        junction.end_seq = gt_junction_set_get_seq_id(self.junctions, chr_2, len(chr_2))
+        junction.end_strand = FORWARD if strand_2 == "+" else REVERSE
+        junction.end_position = pos_2
+        gt_junction_set_add(self.junctions, &junction, coverage)
+
+    cpdef update(self, other):
+        """Merge the junctions (adding the coverage) of other into this set.
+        other is either a JunctionSet or an iterable of gem.junctions.JunctionSite
+        or descriptor tuples (with an optional coverage as 7th element)
+        """
+        if isinstance(other, JunctionSet):
+            gt_junction_set_merge(self.junctions, (<JunctionSet>other).junctions)
+            return self
+        for site in other:
+            if hasattr(site, "descriptor"):
+                d = site.descriptor
+                self.add(d[0], d[1], d[2], d[3], d[4], d[5], max(site.coverage, 1))
+            else:
+                self.add(site[0], site[1], site[2], site[3], site[4], site[5], site[6] if len(site) > 6 else 1)
+        return self
+
+    cpdef clear(self):
+        gt_junction_set_clear(self.junctions)
+
+    cpdef copy(self):
+        return JunctionSet().update(self)
+
+    cpdef union(self, JunctionSet other):
+        """New set with the junctions of both sets (coverage added)"""
+        return self.copy().update(other)
+
+    cpdef intersection(self, JunctionSet other):
+        """New set with the junctions (and coverage) of this set also in other"""
+        cdef JunctionSet result = JunctionSet()
+        gt_junction_set_intersection(result.junctions, self.junctions, other.junctions)
+        return result
+
+    def __contains__(self, site):
+        d = site.descriptor if hasattr(site, "descriptor") else site
+        cdef gt_junction junction
+        junction.start_seq = gt_junction_set_find_seq_id(self.junctions, d[0])
+        junction.end_seq = gt_junction_set_find_seq_id(self.junctions, d[3])
+        if junction.start_seq == GT_JUNCTION_SEQ_NOT_FOUND or junction.end_seq == GT_JUNCTION_SEQ_NOT_FOUND:
+            return False
+        junction.start_strand = FORWARD if d[1] == "+" else REVERSE
+        junction.start_position = d[2]
+        junction.end_strand = FORWARD if d[4] == "+" else REVERSE
+        junction.end_position = d[5]
+        return gt_junction_set_get(self.junctions, &junction) is not NULL
+
+    cpdef uint64_t filter(self, uint64_t min_distance=0, uint64_t max_distance=GT_JUNCTION_MAX_DISTANCE, uint64_t min_coverage=0, JunctionSet rescue=None):
+        """Remove the junctions whose site distance is not in [min_distance, max_distance],
+        or with less than min_coverage (unless they share a site with the
+        rescue set, e.g. the annotation). Returns the number of junctions removed
+        """
+        cdef gt_junction_set* rescue_set = NULL
+        if rescue is not None:
+            rescue_set = rescue.junctions
+        return gt_junction_set_filter(self.junctions, min_distance, max_distance, min_coverage, rescue_set)
+
+    cpdef sort(self):
+        """Sort the junctions by sequence name and span and build the
+        interval index (queries do this on demand)
+        """
+        gt_junction_set_sort(self.junctions)
+        return self
+
+    cpdef overlaps(self, char* chr, uint64_t begin, uint64_t end):
+        """Junctions on chr whose span overlaps [begin, end]"""
+        return self._query(chr, begin, end, False)
+
+    cpdef sites(self, char* chr, uint64_t begin, uint64_t end):
+        """Junctions with a site on chr within [begin, end]"""
+        return self._query(chr, begin, end, True)
+
+    cdef list _query(self, char* chr, uint64_t begin, uint64_t end, bool by_site):
+        cdef uint64_t seq_id = gt_junction_set_find_seq_id(self.junctions, chr)
+        if seq_id == GT_JUNCTION_SEQ_NOT_FOUND:
+            return []
+        cdef gt_vector* positions = gt_vector_new(16, sizeof(uint64_t))
+        cdef uint64_t i
+        if by_site:
+            gt_junction_set_sites(self.junctions, seq_id, begin, end, positions)
+        else:
+            gt_junction_set_overlaps(self.junctions, seq_id, begin, end, positions)
+        result = [self._descriptor((<uint64_t*>positions.memory)[i]) for i in range(positions.used)]
+        gt_vector_delete(positions)
+        return result
+
+    cpdef load_gtf(self, char* file_name):
+        """Add the junctions between consecutive exons of the transcripts
+        in the (optionally gzipped) GTF annotation
+        """
+        cdef gt_status status
+        with nogil:
+            status = gt_junction_set_load_gtf(self.junctions, file_name)
+        if status != GT_STATUS_OK:
+            raise IOError("Unable to open annotation %s" % file_name)
+        return self
+
+    cpdef extract(self, source, uint64_t min_split=4, uint64_t max_split=2500000, uint64_t max_matches=1, uint64_t threads=1):
+        """Add the junctions found in the split-maps of source (an InputFile,
+        a file name or a stream) without holding the GIL.
+
+        min_split   -- minimum distance between the junction sites
+        max_split   -- maximum distance between the junction sites
+        max_matches -- skip alignments with more maps (0 disables the limit)
+        threads     -- number of parser threads
+        """
+        if not isinstance(source, InputFile):
+            source = InputFile(source)
+        cdef gt_input_file* input = (<InputFile>source)._open()
+        cdef gt_status status
+        with nogil:
+            status = gt_junction_set_extract(self.junctions, input, min_split, max_split, max_matches, threads)
+        gt_input_file_close(input)
+        if status != GT_STATUS_OK:
+            raise ValueError("Error while parsing the split-maps")
+        return self
+
+
+cpdef extract_junctions(source, uint64_t min_split=4, uint64_t max_split=2500000, uint64_t max_matches=1, uint64_t threads=1):
+    """Extract the junctions (and their coverage) from the split-maps of source
+    and return them as JunctionSet (see JunctionSet.extract)
+    """
+    return JunctionSet().extract(source, min_split, max_split, max_matches, threads)
+
+
+cdef __profile_to_dict(gt_profile* profile, uint64_t wall_time):
+    cdef double seconds = wall_time / 1e9
+    cdef uint64_t i
+    stages = {}
+    for i in range(GT_PROFILE_NUM_STAGES):
+        stages[gt_profile_stage_label[i]] = {"time": profile.time[i] / 1e9, "calls": profile.calls[i]}
+    return {
+        "records": profile.num_records,
+        "blocks": profile.num_blocks,
+        "bytes_in": profile.bytes_in,
+        "bytes_out": profile.bytes_out,
+        "records_per_second": profile.num_records / seconds if seconds > 0 else 0.0,
+        "bytes_in_per_second": profile.bytes_in / seconds if seconds > 0 else 0.0,
+        "bytes_out_per_second": profile.bytes_out / seconds if seconds > 0 else 0.0,
+        "stages": stages,
+    }
+
+
+cpdef profile_enable(bool enabled=True):
+    """Enable (or disable) the profiling of the I/O pipeline. Time is accounted
+    per thread and stage (input wait/fetch, parse, process, format and
+    output wait/write) together with the records and bytes read and written
+    """
+    gt_profile_enable(enabled)
+
+
+cpdef profile_reset():
+    """Reset the profiling counters of all threads. The profiles of the
+    threads are freed (pipelines spawn new threads on every run); threads
+    accounting afterwards start from new ones
+    """
+    gt_profile_destroy()
+
+
+cpdef profile_stats():
+    """Return the profiling counters as a dictionary. The totals (all threads)
+    are at the top level, the per-thread counters in 'threads'
+    """
+    cdef gt_profile totals
+    cdef uint64_t wall_time = gt_profile_get_totals(&totals)
+    cdef uint64_t i
+    stats = __profile_to_dict(&totals, wall_time)
+    stats["wall_time"] = wall_time / 1e9
+    stats["threads"] = [__profile_to_dict(gt_profile_get_thread(i), wall_time)
+                        for i in range(gt_profile_get_num_threads())]
+    return stats
@@ -3,13 +3,25 @@ GEMTools python binding utilities
  */
 #include "gemtools_binding.h"
 #include <omp.h>
+#include <fcntl.h>
 
 
 void gt_stats_fill(gt_input_file* input_file, gt_stats* target_all_stats, gt_stats* target_best_stats, uint64_t num_threads, bool paired_end){
+  if(gt_stats_fill_output(NULL, input_file, target_all_stats, target_best_stats, num_threads, paired_end, false, false) != GT_STATUS_OK){
+    gt_error_msg("Fatal error parsing file\n");
+  }
+  gt_input_file_close(input_file);
+}
+
+gt_status gt_stats_fill_output(gt_output_file* output, gt_input_file* input_file, gt_stats* target_all_stats, gt_stats* target_best_stats, uint64_t num_threads, bool paired_end, bool append_extra, bool clean_id){
+  gt_status error_code = GT_STATUS_OK; // Set (by any thread) if a template cannot be parsed
+  num_threads = GT_MAX(num_threads,1);
 // Stats info
   gt_stats** all_stats = malloc(num_threads*sizeof(gt_stats*));
+  gt_cond_fatal_error(!all_stats,MEM_ALLOC);
   all_stats[0] = target_all_stats;
   gt_stats** best_stats = malloc(num_threads*sizeof(gt_stats*));
+  gt_cond_fatal_error(!best_stats,MEM_ALLOC);
   best_stats[0] = target_best_stats;
 
   gt_stats_analysis params_all = GT_STATS_ANALYSIS_DEFAULT();
@@ -17,24 +29,41 @@ void gt_stats_fill(gt_input_file* input_file, gt_stats* target_all_stats, gt_sta
   gt_stats_analysis params_best = GT_STATS_ANALYSIS_DEFAULT();
   params_best.best_map = true;
 
+  gt_output_map_attributes* map_attributes = 0;
+  if(output != NULL){
+    map_attributes = gt_output_map_attributes_new();
+    gt_output_map_attributes_set_print_extra(map_attributes, append_extra);
+    gt_output_map_attributes_set_print_casava(map_attributes, !clean_id);
+  }
+  // Printed templates are parsed as gt_write_stream() does (mates already paired in the file)
+  gt_generic_parser_attr* generic_parser_attr = gt_input_generic_parser_attributes_new(output==NULL && paired_end);
+  pthread_mutex_t input_mutex = PTHREAD_MUTEX_INITIALIZER;
+
   //params_all.indel_profile = true
-  // Parallel reading+process
+  // Parallel reading+process (templates are printed in input order, blocks keep their ids)
   #pragma omp parallel num_threads(num_threads)
   {
     uint64_t tid = omp_get_thread_num();
     gt_buffered_input_file* buffered_input = gt_buffered_input_file_new(input_file);
+    gt_buffered_output_file* buffered_output = 0;
+    if(output != NULL){
+      buffered_output = gt_buffered_output_file_new(output);
+      gt_buffered_input_file_attach_buffered_output(buffered_input, buffered_output);
+    }
 
-    gt_status error_code;
+    gt_status status;
     gt_template *template = gt_template_new();
     if(tid > 0){
         all_stats[tid] = gt_stats_new();
         best_stats[tid] = gt_stats_new();
     }
-    gt_generic_parser_attr* generic_parser_attr =  gt_input_generic_parser_attributes_new(paired_end);
-    while ((error_code=gt_input_generic_parser_get_template(buffered_input,template, generic_parser_attr))) {
-      if (error_code!=GT_IMP_OK) {
-        gt_error_msg("Fatal error parsing file\n");
+    while (gt_input_generic_parser_synch_blocks_a(&input_mutex, &buffered_input, 1, generic_parser_attr) == GT_STATUS_OK) {
+      status = gt_input_generic_parser_get_template(buffered_input, template, generic_parser_attr);
+      if (status == GT_IGP_FAIL){
+        #pragma omp critical
+        error_code = GT_STATUS_FAIL;
       }
+      if (status != GT_IGP_OK) continue;
       // Extract all_stats
       if(target_all_stats != NULL){
         gt_stats_calculate_template_stats(all_stats[tid],template,NULL, &params_all);
@@ -42,44 +71,206 @@ void gt_stats_fill(gt_input_file* input_file, gt_stats* target_all_stats, gt_sta
       if(target_best_stats != NULL){
         gt_stats_calculate_template_stats(best_stats[tid],template,NULL, &params_best);
       }
+      // Same parse, printed back
+      if(buffered_output != NULL){
+        gt_output_map_bofprint_template(buffered_output, template, map_attributes);
+      }
     }
     // Clean
     gt_template_delete(template);
-    // gt_template_delete(template_copy);
+    if(buffered_output != NULL) gt_buffered_output_file_close(buffered_output);
     gt_buffered_input_file_close(buffered_input);
   }
 
   // Merge all_stats
   if(target_all_stats != NULL){
     gt_stats_merge(all_stats, num_threads);
+  }else{
+    register uint64_t i;
+    for(i=1; i<num_threads; i++) gt_stats_delete(all_stats[i]);
   }
   if(target_best_stats != NULL){
     gt_stats_merge(best_stats, num_threads);
+  }else{
+    register uint64_t i;
+    for(i=1; i<num_threads; i++) gt_stats_delete(best_stats[i]);
   }
 
   // Clean
   free(all_stats);
   free(best_stats);
-  gt_input_file_close(input_file);
+  if(map_attributes != NULL) gt_output_map_attributes_delete(map_attributes);
+  gt_input_generic_parser_attributes_delete(generic_parser_attr);
+  return error_code;
+}
+
+
+gt_template_filter_chain* gt_template_filter_chain_new(uint64_t num_filters){
+    gt_template_filter_chain* chain = malloc(sizeof(gt_template_filter_chain));
+    gt_cond_fatal_error(!chain,MEM_HANDLER);
+    chain->filters = calloc(GT_MAX(num_filters,1),sizeof(gt_template_filter));
+    gt_cond_fatal_error(!chain->filters,MEM_ALLOC);
+    chain->num_filters = num_filters;
+    return chain;
+}
+
+void gt_template_filter_chain_delete(gt_template_filter_chain* chain){
+    free(chain->filters);
+    free(chain);
+}
+
+int64_t gt_template_get_uniq_level(gt_template* template, uint64_t max_level){
+    // Same as Template.level()
+    register const uint64_t num_counters = gt_template_get_num_counters(template);
+    register uint64_t i, j, level = 0;
+    for(i=0; i<num_counters; i++){
+        register const uint64_t counter = gt_template_get_counter(template, i);
+        if(counter == 1){
+            for(j=i+1; j<num_counters; j++){
+                if(level >= max_level) return level;
+                if(gt_template_get_counter(template, j) > 0) return j-(i+1);
+                level++;
+            }
+            return num_counters-(i+1);
+        }else if(counter > 1){
+            return -1;
+        }
+    }
+    return -1;
+}
+
+bool gt_template_filter_chain_apply(gt_template_filter_chain* chain, gt_template* template){
+    register uint64_t i;
+    for(i=0; i<chain->num_filters; i++){
+        gt_template_filter* const filter = chain->filters+i;
+        switch(filter->type){
+            case GT_FILTER_UNMAPPED:
+                if(gt_template_is_thresholded_mapped(template, filter->max_mismatches)) return false;
+                break;
+            case GT_FILTER_UNIQUE: {
+                register const int64_t level = gt_template_get_uniq_level(template, filter->level);
+                if(level <= 0 || (uint64_t)level < filter->level) return false;
+                break;
+            }
+            case GT_FILTER_TRIM:
+                gt_template_trim(template, filter->left, filter->right, filter->min_length, filter->set_extra);
+                break;
+            case GT_FILTER_AUTO_TRIM:
+                gt_template_auto_trim(template, filter->trim_attributes, filter->min_length, filter->set_extra);
+                break;
+            case GT_FILTER_MAPQ:
+                if(gt_map_score_template_mapq(template, filter->score_attributes) < filter->min_mapq) return false;
+                break;
+            default:
+                gt_fatal_error(SELECTION_NOT_VALID);
+                break;
+        }
+    }
+    return true;
+}
+
+gt_template_batch* gt_template_batch_new(uint64_t max_templates){
+    gt_template_batch* batch = malloc(sizeof(gt_template_batch));
+    gt_cond_fatal_error(!batch,MEM_HANDLER);
+    batch->templates = malloc(max_templates*sizeof(gt_template*));
+    gt_cond_fatal_error(!batch->templates,MEM_ALLOC);
+    register uint64_t i;
+    for(i=0; i<max_templates; i++){
+        batch->templates[i] = gt_template_new();
+    }
+    batch->num_templates = 0;
+    batch->max_templates = max_templates;
+    batch->error_code = GT_IGP_OK;
+    return batch;
+}
+
+void gt_template_batch_delete(gt_template_batch* batch){
+    register uint64_t i;
+    for(i=0; i<batch->max_templates; i++){
+        gt_template_delete(batch->templates[i]);
+    }
+    free(batch->templates);
+    free(batch);
 }
 
+uint64_t gt_template_batch_fill(gt_template_batch* batch, gt_buffered_input_file** buffered_inputs, uint64_t num_threads, gt_generic_parser_attr* parser_attributes, gt_template_filter_chain* filters){
+    batch->num_templates = 0;
+    batch->error_code = GT_IGP_OK;
+    if(num_threads <= 1){
+        gt_status status;
+        while(batch->num_templates < batch->max_templates){
+            status = gt_input_generic_parser_get_template(buffered_inputs[0], batch->templates[batch->num_templates], parser_attributes);
+            if(status != GT_IGP_OK){
+                if(status != GT_IGP_EOF) batch->error_code = status;
+                break;
+            }
+            if(filters==NULL || gt_template_filter_chain_apply(filters, batch->templates[batch->num_templates])){
+                batch->num_templates++;
+            }
+        }
+        return batch->num_templates;
+    }
+    // Each thread fills its own slice of the batch (from the blocks it reads)
+    register const uint64_t slice = (batch->max_templates+num_threads-1)/num_threads;
+    uint64_t* const filled = malloc(num_threads*sizeof(uint64_t));
+    gt_cond_fatal_error(!filled,MEM_ALLOC);
+    #pragma omp parallel num_threads(num_threads)
+    {
+        register const uint64_t tid = omp_get_thread_num();
+        register const uint64_t begin = GT_MIN(tid*slice, batch->max_templates);
+        register const uint64_t end = GT_MIN(begin+slice, batch->max_templates);
+        register uint64_t i = begin;
+        gt_status status;
+        while(i < end){
+            status = gt_input_generic_parser_get_template(buffered_inputs[tid], batch->templates[i], parser_attributes);
+            if(status != GT_IGP_OK){
+                if(status != GT_IGP_EOF){
+                    #pragma omp critical
+                    batch->error_code = status;
+                }
+                break;
+            }
+            if(filters==NULL || gt_template_filter_chain_apply(filters, batch->templates[i])) i++;
+        }
+        filled[tid] = i-begin;
+    }
+    // Compact the slices (swapping templates, so none is lost)
+    register uint64_t t, i;
+    for(t=0; t<num_threads; t++){
+        register const uint64_t begin = GT_MIN(t*slice, batch->max_templates);
+        for(i=0; i<filled[t]; i++){
+            gt_template* const template = batch->templates[begin+i];
+            batch->templates[begin+i] = batch->templates[batch->num_templates];
+            batch->templates[batch->num_templates] = template;
+            batch->num_templates++;
+        }
+    }
+    free(filled);
+    return batch->num_templates;
+}
 
 bool gt_input_file_has_qualities(gt_input_file* file){
     return (file->file_format == FASTA && file->fasta_type.fasta_format == F_FASTQ) || (file->file_format == MAP && file->map_type.contains_qualities);
 }
 
-void gt_merge_files_synch(gt_output_file* const output_file, uint64_t threads, const uint64_t num_files,  gt_input_file** files) {
+gt_status gt_merge_files_synch(gt_output_file* const output_file, uint64_t threads, const uint64_t num_files,  gt_input_file** files) {
+  gt_status error_code = GT_STATUS_OK; // Set (by any thread) if the files cannot be merged
   // Mutex
   pthread_mutex_t input_mutex = PTHREAD_MUTEX_INITIALIZER;
   // Parallel reading+process
   #pragma omp parallel num_threads(threads)
   {
     //gt_merge_map_files(&input_mutex,input_file_1,input_file_2,false, same_content ,output_file);
-    gt_merge_synch_map_files_a(&input_mutex, false, output_file, files, num_files);
+    if(gt_merge_synch_map_files_a(&input_mutex, false, output_file, files, num_files) != GT_STATUS_OK){
+      #pragma omp critical
+      error_code = GT_STATUS_FAIL;
+    }
   }
+  return error_code;
 }
 
-void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map){
+gt_status gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, gt_template_filter_chain* filters){
+    gt_status error_code = GT_STATUS_OK; // Set (by any thread) if a template cannot be parsed
     // prepare attributes
 
     gt_output_fasta_attributes* attributes = 0;
@@ -102,7 +293,52 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
     gt_generic_parser_attr* parser_attributes = gt_input_generic_parser_attributes_new(false); // do not force pairs
     pthread_mutex_t input_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-    if(interleave){
+    if(interleave && num_inputs == 2 && inputs[0]->file_format == FASTA && inputs[1]->file_format == FASTA){
+        // paired reads, both files are read concurrently by the paired reader
+        gt_paired_input_file* paired_input = gt_paired_input_file_new(inputs[0], inputs[1], 0, 0);
+        #pragma omp parallel num_threads(threads)
+        {
+            register uint64_t i = 0;
+            gt_buffered_output_file* buffered_output = gt_buffered_output_file_new(output);
+            gt_buffered_input_file* buffered_input[2];
+            for(i=0; i<2; i++){
+                buffered_input[i] = gt_buffered_input_file_new(inputs[i]);
+            }
+            // attache first input to output
+            gt_buffered_input_file_attach_buffered_output(buffered_input[0], buffered_output);
+
+            gt_template* template = gt_template_new();
+            gt_status status, synch_status;
+            while( (synch_status=gt_input_fasta_parser_synch_paired_blocks(paired_input, buffered_input[0], buffered_input[1])) == GT_IFP_OK ){
+                for(i=0; i<2; i++){
+                    status = gt_input_generic_parser_get_template(buffered_input[i], template, parser_attributes);
+                    if(status == GT_IGP_FAIL){
+                        #pragma omp critical
+                        error_code = GT_STATUS_FAIL;
+                    }
+                    if(status == GT_STATUS_OK){
+                        if(filters!=NULL && !gt_template_filter_chain_apply(filters, template)) continue;
+                        if(write_map){
+                            gt_output_map_bofprint_template(buffered_output, template, map_attributes);
+                        }else{
+                            gt_output_fasta_bofprint_template(buffered_output, template, attributes);
+                        }
+                    }
+                }
+            }
+            // The ends are out of synch (different number of reads)
+            if(synch_status == GT_IFP_FAIL){
+                #pragma omp critical
+                error_code = GT_STATUS_FAIL;
+            }
+            gt_buffered_output_file_close(buffered_output);
+            for(i=0; i<2; i++){
+                gt_buffered_input_file_close(buffered_input[i]);
+            }
+            gt_template_delete(template);
+        }
+        gt_paired_input_file_close(paired_input);
+    }else if(interleave){
 
 
         // main loop, interleave
@@ -124,7 +360,13 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
             i=0;
             while( gt_input_generic_parser_synch_blocks_a(&input_mutex, buffered_input, num_inputs, parser_attributes) == GT_STATUS_OK ){
                 for(i=0; i<num_inputs; i++){
-                    if( (status = gt_input_generic_parser_get_template(buffered_input[i], template, parser_attributes)) == GT_STATUS_OK){
+                    status = gt_input_generic_parser_get_template(buffered_input[i], template, parser_attributes);
+                    if(status == GT_IGP_FAIL){
+                        #pragma omp critical
+                        error_code = GT_STATUS_FAIL;
+                    }
+                    if(status == GT_STATUS_OK){
+                        if(filters!=NULL && !gt_template_filter_chain_apply(filters, template)) continue;
                         if(write_map){
                             gt_output_map_bofprint_template(buffered_output, template, map_attributes);
                         }else{
@@ -166,7 +408,13 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
 
                 // read
                 while( gt_input_generic_parser_synch_blocks_a(&input_mutex, buffered_input, 1, parser_attributes) == GT_STATUS_OK ){
-                    if( (status = gt_input_generic_parser_get_template(current_input, template, parser_attributes)) == GT_STATUS_OK){
+                    status = gt_input_generic_parser_get_template(current_input, template, parser_attributes);
+                    if(status == GT_IGP_FAIL){
+                        #pragma omp critical
+                        error_code = GT_STATUS_FAIL;
+                    }
+                    if(status == GT_STATUS_OK){
+                        if(filters!=NULL && !gt_template_filter_chain_apply(filters, template)) continue;
                         if(write_map){
                             gt_output_map_bofprint_template(buffered_output, template, map_attributes);
                         }else{
@@ -188,6 +436,7 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
     gt_output_fasta_attributes_delete(attributes);
     gt_output_map_attributes_delete(map_attributes);
     gt_input_generic_parser_attributes_delete(parser_attributes);
+    return error_code;
 
     // register uint64_t i = 0;
     // for(i=0; i<num_inputs; i++){
@@ -196,6 +445,306 @@ void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t nu
     // gt_output_file_close(output);
 }
 
+/*
+ * In-process gzip output
+ */
+typedef struct {
+  char* data;            // Raw chunk
+  size_t length;
+  char* deflated;        // Gzip member of the chunk
+  size_t deflated_length;
+  size_t deflated_size;
+  bool compressed;
+} gt_gzip_chunk;
+
+typedef struct {
+  int fd;
+  int level;
+  /* Ring of chunks (chunk number i is at chunks[i%num_chunks]) */
+  gt_gzip_chunk* chunks;
+  uint64_t num_chunks;
+  uint64_t next_fill;     // Chunks [next_compress,next_fill) wait for a compressor
+  uint64_t next_compress; // Chunks [next_write,next_compress) are being compressed (or wait to be written)
+  uint64_t next_write;
+  bool writing;           // A compressor is writing (members are written in order, one at a time)
+  bool closed;
+  bool error;
+  pthread_mutex_t mutex;
+  pthread_cond_t changed;
+  /* Chunk being filled (by the writer) */
+  char* chunk;
+  size_t length;
+  /* Compressors */
+  pthread_t* compressors;
+  uint64_t num_compressors;
+} gt_gzip_stream;
+
+bool gt_gzip_chunk_compress(gt_gzip_chunk* const chunk, z_stream* const z){
+    if(deflateReset(z)!=Z_OK) return false;
+    const size_t bound = deflateBound(z,chunk->length);
+    if(chunk->deflated_size < bound){
+        free(chunk->deflated);
+        chunk->deflated = malloc(bound);
+        gt_cond_fatal_error(!chunk->deflated,MEM_ALLOC);
+        chunk->deflated_size = bound;
+    }
+    z->next_in = (Bytef*)chunk->data;
+    z->avail_in = chunk->length;
+    z->next_out = (Bytef*)chunk->deflated;
+    z->avail_out = chunk->deflated_size;
+    const bool done = (deflate(z,Z_FINISH)==Z_STREAM_END);
+    chunk->deflated_length = chunk->deflated_size-z->avail_out;
+    return done;
+}
+
+bool gt_gzip_write_all(int fd, const char* buffer, size_t length){
+    while(length > 0){
+        const ssize_t written = write(fd,buffer,length);
+        if(written < 0){
+            if(errno==EINTR) continue;
+            return false;
+        }
+        buffer += written;
+        length -= written;
+    }
+    return true;
+}
+
+void* gt_gzip_stream_compressor(void* arg){
+    gt_gzip_stream* const gz_stream = arg;
+    z_stream z;
+    memset(&z,0,sizeof(z_stream));
+    const bool z_ready = (deflateInit2(&z,gz_stream->level,Z_DEFLATED,15+16,8,Z_DEFAULT_STRATEGY)==Z_OK); // Gzip wrapper
+    pthread_mutex_lock(&gz_stream->mutex);
+    if(!z_ready) gz_stream->error = true;
+    while(true){
+        if(gz_stream->next_compress < gz_stream->next_fill){
+            gt_gzip_chunk* const chunk = gz_stream->chunks+(gz_stream->next_compress%gz_stream->num_chunks);
+            gz_stream->next_compress++;
+            // Compress (after an error chunks are just drained, so the writer never blocks)
+            const bool skip = gz_stream->error;
+            pthread_mutex_unlock(&gz_stream->mutex);
+            const bool compressed = skip || gt_gzip_chunk_compress(chunk,&z);
+            pthread_mutex_lock(&gz_stream->mutex);
+            if(!compressed) gz_stream->error = true;
+            chunk->compressed = true;
+            // Write the compressed chunks in order
+            while(!gz_stream->writing && gz_stream->next_write < gz_stream->next_compress){
+                gt_gzip_chunk* const next_chunk = gz_stream->chunks+(gz_stream->next_write%gz_stream->num_chunks);
+                if(!next_chunk->compressed) break;
+                gz_stream->writing = true;
+                const bool skip_write = gz_stream->error;
+                pthread_mutex_unlock(&gz_stream->mutex);
+                const bool written = skip_write || gt_gzip_write_all(gz_stream->fd,next_chunk->deflated,next_chunk->deflated_length);
+                pthread_mutex_lock(&gz_stream->mutex);
+                if(!written) gz_stream->error = true;
+                next_chunk->compressed = false;
+                gz_stream->next_write++;
+                gz_stream->writing = false;
+            }
+            pthread_cond_broadcast(&gz_stream->changed);
+        }else if(gz_stream->closed){
+            break;
+        }else{
+            pthread_cond_wait(&gz_stream->changed,&gz_stream->mutex);
+        }
+    }
+    pthread_mutex_unlock(&gz_stream->mutex);
+    if(z_ready) deflateEnd(&z);
+    return NULL;
+}
+
+bool gt_gzip_stream_push(gt_gzip_stream* const gz_stream){
+    pthread_mutex_lock(&gz_stream->mutex);
+    while(gz_stream->next_fill-gz_stream->next_write == gz_stream->num_chunks){
+        pthread_cond_wait(&gz_stream->changed,&gz_stream->mutex);
+    }
+    // Swap buffers with the (already written) chunk
+    gt_gzip_chunk* const chunk = gz_stream->chunks+(gz_stream->next_fill%gz_stream->num_chunks);
+    char* const data = chunk->data;
+    chunk->data = gz_stream->chunk;
+    chunk->length = gz_stream->length;
+    gz_stream->next_fill++;
+    const bool error = gz_stream->error;
+    pthread_cond_broadcast(&gz_stream->changed);
+    pthread_mutex_unlock(&gz_stream->mutex);
+    if(data==NULL){
+        gz_stream->chunk = malloc(GT_GZIP_CHUNK_SIZE);
+        gt_cond_fatal_error(!gz_stream->chunk,MEM_ALLOC);
+    }else{
+        gz_stream->chunk = data;
+    }
+    gz_stream->length = 0;
+    return !error;
+}
+
+ssize_t gt_gzip_stream_write(void* cookie, const char* buffer, size_t size){
+    gt_gzip_stream* const gz_stream = cookie;
+    size_t written = 0;
+    bool ok = true;
+    while(written < size){
+        const size_t length = GT_MIN(size-written, GT_GZIP_CHUNK_SIZE-gz_stream->length);
+        memcpy(gz_stream->chunk+gz_stream->length, buffer+written, length);
+        gz_stream->length += length;
+        written += length;
+        if(gz_stream->length==GT_GZIP_CHUNK_SIZE) ok = gt_gzip_stream_push(gz_stream) && ok;
+    }
+    return ok ? (ssize_t)size : -1;
+}
+
+int gt_gzip_stream_close(void* cookie){
+    gt_gzip_stream* const gz_stream = cookie;
+    // Last chunk (an empty output still gets one, empty, gzip member)
+    if(gz_stream->length>0 || gz_stream->next_fill==0) gt_gzip_stream_push(gz_stream);
+    pthread_mutex_lock(&gz_stream->mutex);
+    gz_stream->closed = true;
+    pthread_cond_broadcast(&gz_stream->changed);
+    pthread_mutex_unlock(&gz_stream->mutex);
+    register uint64_t i;
+    for(i=0; i<gz_stream->num_compressors; i++){
+        pthread_join(gz_stream->compressors[i],NULL);
+    }
+    bool error = gz_stream->error || gz_stream->next_write!=gz_stream->next_fill;
+    if(close(gz_stream->fd)!=0) error = true;
+    pthread_mutex_destroy(&gz_stream->mutex);
+    pthread_cond_destroy(&gz_stream->changed);
+    for(i=0; i<gz_stream->num_chunks; i++){
+        free(gz_stream->chunks[i].data);
+        free(gz_stream->chunks[i].deflated);
+    }
+    free(gz_stream->chunks);
+    free(gz_stream->compressors);
+    free(gz_stream->chunk);
+    free(gz_stream);
+    return error ? EOF : 0;
+}
+
+FILE* gt_gzip_stream_open(int fd, int level, uint64_t num_threads){
+    gt_gzip_stream* const gz_stream = malloc(sizeof(gt_gzip_stream));
+    gt_cond_fatal_error(!gz_stream,MEM_HANDLER);
+    gz_stream->fd = fd;
+    gz_stream->level = GT_MIN(GT_MAX(level,1),9);
+    gz_stream->num_compressors = GT_MAX(num_threads,1);
+    gz_stream->num_chunks = GT_GZIP_CHUNKS_PER_THREAD*gz_stream->num_compressors;
+    gz_stream->chunks = calloc(gz_stream->num_chunks,sizeof(gt_gzip_chunk));
+    gt_cond_fatal_error(!gz_stream->chunks,MEM_ALLOC);
+    gz_stream->next_fill = 0;
+    gz_stream->next_compress = 0;
+    gz_stream->next_write = 0;
+    gz_stream->writing = false;
+    gz_stream->closed = false;
+    gz_stream->error = false;
+    pthread_mutex_init(&gz_stream->mutex,NULL);
+    pthread_cond_init(&gz_stream->changed,NULL);
+    gz_stream->chunk = malloc(GT_GZIP_CHUNK_SIZE);
+    gt_cond_fatal_error(!gz_stream->chunk,MEM_ALLOC);
+    gz_stream->length = 0;
+    gz_stream->compressors = malloc(gz_stream->num_compressors*sizeof(pthread_t));
+    gt_cond_fatal_error(!gz_stream->compressors,MEM_ALLOC);
+    register uint64_t i;
+    for(i=0; i<gz_stream->num_compressors; i++){
+        gt_cond_fatal_error(pthread_create(gz_stream->compressors+i,NULL,gt_gzip_stream_compressor,gz_stream),SYS_THREAD);
+    }
+    cookie_io_functions_t io_functions = { NULL, gt_gzip_stream_write, NULL, gt_gzip_stream_close };
+    FILE* const gz_file = fopencookie(gz_stream,"w",io_functions);
+    if(gz_file==NULL){
+        gz_stream->fd = -1; // Not taken (closed by the caller)
+        gt_gzip_stream_close(gz_stream);
+    }
+    return gz_file;
+}
+
+FILE* gt_output_stream_dup(FILE* stream, bool compress, uint64_t compress_threads){
+    fflush(stream);
+    const int fd = fcntl(fileno(stream),F_DUPFD_CLOEXEC,0); // Not inherited by subprocesses
+    if(fd < 0) return NULL;
+    FILE* const dup_stream = compress ? gt_gzip_stream_open(fd,6,compress_threads) : fdopen(fd,"w");
+    if(dup_stream==NULL) close(fd);
+    return dup_stream;
+}
+
+/*
+ * Asynchronous writes
+ */
+gt_write_job* gt_write_job_new(FILE* stream, gt_input_file** inputs, uint64_t num_inputs, bool merge, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, gt_template_filter_chain* filters){
+    gt_write_job* job = malloc(sizeof(gt_write_job));
+    gt_cond_fatal_error(!job,MEM_HANDLER);
+    job->stream = stream;
+    job->output = gt_output_stream_new(stream,SORTED_FILE);
+    gt_output_file_set_fatal_write_error(job->output,false); // Reported by gt_write_job_join()
+    job->inputs = malloc(num_inputs*sizeof(gt_input_file*));
+    gt_cond_fatal_error(!job->inputs,MEM_ALLOC);
+    memcpy(job->inputs,inputs,num_inputs*sizeof(gt_input_file*));
+    job->num_inputs = num_inputs;
+    job->merge = merge;
+    job->append_extra = append_extra;
+    job->clean_id = clean_id;
+    job->interleave = interleave;
+    job->write_map = write_map;
+    job->threads = GT_MAX(threads,1);
+    job->filters = filters;
+    job->all_stats = NULL;
+    job->best_stats = NULL;
+    job->paired_end = false;
+    job->started = false;
+    job->running = false;
+    job->error_code = GT_STATUS_OK;
+    return job;
+}
+
+void gt_write_job_set_stats(gt_write_job* job, gt_stats* all_stats, gt_stats* best_stats, bool paired_end){
+    job->all_stats = all_stats;
+    job->best_stats = best_stats;
+    job->paired_end = paired_end;
+}
+
+void* gt_write_job_run(void* arg){
+    gt_write_job* const job = arg;
+    gt_status error_code;
+    if(job->all_stats!=NULL || job->best_stats!=NULL){
+        error_code = gt_stats_fill_output(job->output, job->inputs[0], job->all_stats, job->best_stats,
+            job->threads, job->paired_end, job->append_extra, job->clean_id);
+    }else if(job->merge){
+        error_code = gt_merge_files_synch(job->output, job->threads, job->num_inputs, job->inputs);
+    }else{
+        error_code = gt_write_stream(job->output, job->inputs, job->num_inputs, job->append_extra,
+            job->clean_id, job->interleave, job->threads, job->write_map, job->filters);
+    }
+    // Close output & inputs (the stream is not closed by the gt_output_file)
+    if(gt_output_file_close(job->output)!=GT_OUTPUT_FILE_OK) error_code = GT_STATUS_FAIL; // Write errors
+    job->output = NULL;
+    if(fclose(job->stream)!=0) error_code = GT_STATUS_FAIL; // Compression errors
+    job->error_code = error_code;
+    job->stream = NULL;
+    register uint64_t i;
+    for(i=0; i<job->num_inputs; i++){
+        gt_input_file_close(job->inputs[i]);
+    }
+    job->num_inputs = 0;
+    job->running = false;
+    return NULL;
+}
+
+void gt_write_job_start(gt_write_job* job){
+    job->started = true;
+    job->running = true;
+    gt_cond_fatal_error(pthread_create(&job->thread,NULL,gt_write_job_run,job),SYS_THREAD);
+}
+
+gt_status gt_write_job_join(gt_write_job* job){
+    if(job->started){
+        gt_cond_fatal_error(pthread_join(job->thread,NULL),SYS_THREAD_JOIN);
+        job->started = false;
+    }
+    return job->error_code;
+}
+
+void gt_write_job_delete(gt_write_job* job){
+    gt_write_job_join(job);
+    free(job->inputs);
+    free(job);
+}
+
 void gt_stats_print_stats(FILE* output, gt_stats* const stats, const bool paired_end) {
   register uint64_t num_reads = stats->num_blocks;
   /*
@@ -259,3 +808,610 @@ void gt_stats_print_stats(FILE* output, gt_stats* const stats, const bool paired
 
 
 
+
+/*
+ * Junction sets
+ */
+#define GT_JUNCTION_SET_INDEX_MIN_SIZE 1024
+#define gt_junction_hash(junction) \
+  gt_hash_integer(gt_hash_integer(gt_hash_integer(((junction)->start_seq<<1 | (junction)->start_strand) ^ (junction)->start_position) ^ \
+    ((junction)->end_seq<<1 | (junction)->end_strand)) ^ (junction)->end_position)
+#define gt_junction_equals(junction_a,junction_b) \
+  ((junction_a)->start_position==(junction_b)->start_position && (junction_a)->end_position==(junction_b)->end_position && \
+   (junction_a)->start_seq==(junction_b)->start_seq && (junction_a)->end_seq==(junction_b)->end_seq && \
+   (junction_a)->start_strand==(junction_b)->start_strand && (junction_a)->end_strand==(junction_b)->end_strand)
+
+gt_junction_set* gt_junction_set_new(void){
+    gt_junction_set* set = malloc(sizeof(gt_junction_set));
+    gt_cond_fatal_error(!set,MEM_HANDLER);
+    set->seq_ids = gt_shash_new();
+    set->seq_names = gt_vector_new(32, sizeof(char*));
+    set->seq_buffer = gt_string_new(64);
+    set->last_seq = UINT64_MAX;
+    set->junctions = gt_vector_new(GT_JUNCTION_SET_INDEX_MIN_SIZE/2, sizeof(gt_junction));
+    set->index = NULL; // Allocated on the first insertion
+    set->index_size = 0;
+    set->sorted = false;
+    set->seq_ranges = gt_vector_new(32, sizeof(gt_junction_range));
+    set->max_end = gt_vector_new(GT_JUNCTION_SET_INDEX_MIN_SIZE/2, sizeof(uint64_t));
+    set->sites = gt_vector_new(GT_JUNCTION_SET_INDEX_MIN_SIZE, sizeof(gt_junction_site));
+    return set;
+}
+
+void gt_junction_set_clear(gt_junction_set* set){
+    gt_shash_clear(set->seq_ids, true);
+    gt_vector_clear(set->seq_names);
+    set->last_seq = UINT64_MAX;
+    gt_vector_clear(set->junctions);
+    if(set->index != NULL) memset(set->index, 0, set->index_size*sizeof(uint64_t));
+    set->sorted = false;
+}
+
+void gt_junction_set_delete(gt_junction_set* set){
+    gt_shash_delete(set->seq_ids, true);
+    gt_vector_delete(set->seq_names);
+    gt_string_delete(set->seq_buffer);
+    gt_vector_delete(set->junctions);
+    free(set->index);
+    gt_vector_delete(set->seq_ranges);
+    gt_vector_delete(set->max_end);
+    gt_vector_delete(set->sites);
+    free(set);
+}
+
+uint64_t gt_junction_set_get_seq_id(gt_junction_set* set, char* seq_name, uint64_t length){
+    if(set->last_seq != UINT64_MAX){
+        register char* const last_name = *gt_vector_get_elm(set->seq_names, set->last_seq, char*);
+        if(strncmp(last_name, seq_name, length)==0 && last_name[length]=='\0') return set->last_seq;
+    }
+    // Null-terminated copy of the name (map names are not)
+    gt_string_clear(set->seq_buffer);
+    gt_string_append_string(set->seq_buffer, seq_name, length);
+    gt_string_append_eos(set->seq_buffer);
+    register char* const key = gt_string_get_string(set->seq_buffer);
+    register uint64_t* seq_id = gt_shash_get(set->seq_ids, key, uint64_t);
+    if(seq_id == NULL){
+        seq_id = malloc(sizeof(uint64_t));
+        gt_cond_fatal_error(!seq_id,MEM_ALLOC);
+        *seq_id = gt_vector_get_used(set->seq_names);
+        char* const name = gt_shash_insert(set->seq_ids, key, seq_id, uint64_t);
+        gt_vector_insert(set->seq_names, name, char*);
+    }
+    set->last_seq = *seq_id;
+    return *seq_id;
+}
+
+char* gt_junction_set_get_seq_name(gt_junction_set* set, uint64_t seq_id){
+    return *gt_vector_get_elm(set->seq_names, seq_id, char*);
+}
+
+uint64_t gt_junction_set_get_num_junctions(gt_junction_set* set){
+    return gt_vector_get_used(set->junctions);
+}
+
+gt_junction* gt_junction_set_get_junction(gt_junction_set* set, uint64_t position){
+    return gt_vector_get_elm(set->junctions, position, gt_junction);
+}
+
+void gt_junction_set_index_add(gt_junction_set* set, gt_junction* junction, uint64_t position){
+    register const uint64_t mask = set->index_size-1;
+    register uint64_t i = gt_junction_hash(junction) & mask;
+    while(set->index[i] != 0) i = (i+1) & mask;
+    set->index[i] = position+1;
+}
+
+void gt_junction_set_index_rebuild(gt_junction_set* set, uint64_t index_size){
+    free(set->index);
+    set->index = calloc(index_size, sizeof(uint64_t));
+    gt_cond_fatal_error(!set->index,MEM_ALLOC);
+    set->index_size = index_size;
+    register const uint64_t num_junctions = gt_vector_get_used(set->junctions);
+    register uint64_t i;
+    for(i=0; i<num_junctions; i++){
+        gt_junction_set_index_add(set, gt_vector_get_elm(set->junctions, i, gt_junction), i);
+    }
+}
+
+gt_junction* gt_junction_set_get(gt_junction_set* set, gt_junction* junction){
+    if(set->index_size == 0) return NULL;
+    register const uint64_t mask = set->index_size-1;
+    register uint64_t i = gt_junction_hash(junction) & mask;
+    while(set->index[i] != 0){
+        register gt_junction* const stored = gt_vector_get_elm(set->junctions, set->index[i]-1, gt_junction);
+        if(gt_junction_equals(stored, junction)) return stored;
+        i = (i+1) & mask;
+    }
+    return NULL;
+}
+
+gt_junction* gt_junction_set_add(gt_junction_set* set, gt_junction* junction, uint64_t coverage){
+    register gt_junction* stored = gt_junction_set_get(set, junction);
+    if(stored != NULL){
+        stored->coverage += coverage;
+        return stored;
+    }
+    // Insert (keeping the load factor under 1/2)
+    register const uint64_t position = gt_vector_get_used(set->junctions);
+    if(gt_expect_false(2*(position+1) > set->index_size)){
+        register uint64_t index_size = GT_MAX(set->index_size, GT_JUNCTION_SET_INDEX_MIN_SIZE);
+        while(2*(position+1) > index_size) index_size *= 2;
+        gt_junction_set_index_rebuild(set, index_size);
+    }
+    gt_vector_reserve_additional(set->junctions, 1);
+    stored = gt_vector_get_free_elm(set->junctions, gt_junction);
+    *stored = *junction;
+    stored->coverage = coverage;
+    gt_vector_inc_used(set->junctions);
+    set->sorted = false;
+    gt_junction_set_index_add(set, stored, position);
+    return stored;
+}
+
+void gt_junction_set_merge(gt_junction_set* set_dst, gt_junction_set* set_src){
+    // Translate the sequence ids of the source set
+    register const uint64_t num_seqs = gt_vector_get_used(set_src->seq_names);
+    uint64_t* const seq_map = malloc(GT_MAX(num_seqs,1)*sizeof(uint64_t));
+    gt_cond_fatal_error(!seq_map,MEM_ALLOC);
+    register uint64_t i;
+    for(i=0; i<num_seqs; i++){
+        register char* const name = gt_junction_set_get_seq_name(set_src, i);
+        seq_map[i] = gt_junction_set_get_seq_id(set_dst, name, strlen(name));
+    }
+    register const uint64_t num_junctions = gt_vector_get_used(set_src->junctions);
+    for(i=0; i<num_junctions; i++){
+        gt_junction junction = *gt_vector_get_elm(set_src->junctions, i, gt_junction);
+        junction.start_seq = seq_map[junction.start_seq];
+        junction.end_seq = seq_map[junction.end_seq];
+        gt_junction_set_add(set_dst, &junction, junction.coverage);
+    }
+    free(seq_map);
+}
+
+uint64_t gt_junction_set_add_map(gt_junction_set* set, gt_map* map, uint64_t min_split, uint64_t max_split){
+    register uint64_t num_added = 0;
+    register gt_map* block = map;
+    while(gt_map_has_next_block(block)){
+        register gt_map* const next_block = gt_map_get_next_block(block);
+        if(gt_map_get_junction(block) == SPLICE){
+            gt_junction junction;
+            // Blocks come in read order; on the reverse strand the next block lies upstream
+            if(gt_map_get_strand(block) == FORWARD){
+                junction.start_position = gt_map_get_position_(block)+gt_map_get_length(block)-1;
+                junction.end_position = gt_map_get_position_(next_block);
+            }else{
+                junction.start_position = gt_map_get_position_(block);
+                junction.end_position = gt_map_get_position_(next_block)+gt_map_get_length(next_block)-1;
+            }
+            junction.start_strand = gt_map_get_strand(block);
+            junction.end_strand = gt_map_get_strand(next_block);
+            if(junction.start_position > junction.end_position){
+                register const uint64_t position = junction.start_position;
+                junction.start_position = junction.end_position;
+                junction.end_position = position;
+                junction.start_strand = (junction.start_strand==FORWARD) ? REVERSE : FORWARD;
+                junction.end_strand = (junction.end_strand==FORWARD) ? REVERSE : FORWARD;
+            }
+            register const uint64_t distance = junction.end_position-junction.start_position;
+            if(distance >= min_split && distance <= max_split){
+                junction.start_seq = gt_junction_set_get_seq_id(set, gt_map_get_seq_name(block), gt_map_get_seq_name_length(block));
+                junction.end_seq = gt_junction_set_get_seq_id(set, gt_map_get_seq_name(next_block), gt_map_get_seq_name_length(next_block));
+                gt_junction_set_add(set, &junction, 1);
+                num_added++;
+            }
+        }
+        block = next_block;
+    }
+    return num_added;
+}
+
+gt_status gt_junction_set_extract(gt_junction_set* set, gt_input_file* input, uint64_t min_split, uint64_t max_split, uint64_t max_matches, uint64_t threads){
+    gt_status error_code = GT_STATUS_OK;
+    gt_junction_set** const sets = calloc(GT_MAX(threads,1), sizeof(gt_junction_set*));
+    gt_cond_fatal_error(!sets,MEM_ALLOC);
+    #pragma omp parallel num_threads(threads)
+    {
+        register const uint64_t tid = omp_get_thread_num();
+        gt_junction_set* const local_set = (tid==0) ? set : gt_junction_set_new();
+        sets[tid] = local_set;
+        gt_buffered_input_file* buffered_input = gt_buffered_input_file_new(input);
+        gt_generic_parser_attr* parser_attributes = gt_input_generic_parser_attributes_new(false);
+        gt_template* template = gt_template_new();
+        gt_status status;
+        while((status=gt_input_generic_parser_get_template(buffered_input, template, parser_attributes)) == GT_IGP_OK){
+            GT_TEMPLATE_ALIGNMENT_ITERATE(template, alignment){
+                if(max_matches > 0 && gt_alignment_get_num_maps(alignment) > max_matches) continue;
+                GT_ALIGNMENT_ITERATE(alignment, map){
+                    gt_junction_set_add_map(local_set, map, min_split, max_split);
+                }
+            }
+        }
+        if(status != GT_IGP_EOF){
+            #pragma omp critical
+            error_code = GT_STATUS_FAIL;
+        }
+        gt_template_delete(template);
+        free(parser_attributes);
+        gt_buffered_input_file_close(buffered_input);
+    }
+    // Merge the per-thread sets
+    register uint64_t i;
+    for(i=1; i<threads; i++){
+        if(sets[i] == NULL) continue; // Fewer threads than requested
+        gt_junction_set_merge(set, sets[i]);
+        gt_junction_set_delete(sets[i]);
+    }
+    free(sets);
+    return error_code;
+}
+
+uint64_t gt_junction_set_find_seq_id(gt_junction_set* set, char* seq_name){
+    register uint64_t* const seq_id = gt_shash_get(set->seq_ids, seq_name, uint64_t);
+    return (seq_id != NULL) ? *seq_id : GT_JUNCTION_SEQ_NOT_FOUND;
+}
+
+gt_junction* gt_junction_set_find(gt_junction_set* set, gt_junction_set* set_src, gt_junction* junction){
+    // Translate the sequence ids of @junction (from @set_src)
+    gt_junction translated = *junction;
+    translated.start_seq = gt_junction_set_find_seq_id(set, gt_junction_set_get_seq_name(set_src, junction->start_seq));
+    if(translated.start_seq == GT_JUNCTION_SEQ_NOT_FOUND) return NULL;
+    translated.end_seq = gt_junction_set_find_seq_id(set, gt_junction_set_get_seq_name(set_src, junction->end_seq));
+    if(translated.end_seq == GT_JUNCTION_SEQ_NOT_FOUND) return NULL;
+    return gt_junction_set_get(set, &translated);
+}
+
+void gt_junction_set_intersection(gt_junction_set* set_dst, gt_junction_set* set_a, gt_junction_set* set_b){
+    // Junctions of @set_a (and their coverage) also present in @set_b
+    register const uint64_t num_junctions = gt_vector_get_used(set_a->junctions);
+    register uint64_t i;
+    for(i=0; i<num_junctions; i++){
+        register gt_junction* const junction = gt_vector_get_elm(set_a->junctions, i, gt_junction);
+        if(gt_junction_set_find(set_b, set_a, junction) == NULL) continue;
+        gt_junction translated = *junction;
+        register char* const start_name = gt_junction_set_get_seq_name(set_a, junction->start_seq);
+        register char* const end_name = gt_junction_set_get_seq_name(set_a, junction->end_seq);
+        translated.start_seq = gt_junction_set_get_seq_id(set_dst, start_name, strlen(start_name));
+        translated.end_seq = gt_junction_set_get_seq_id(set_dst, end_name, strlen(end_name));
+        gt_junction_set_add(set_dst, &translated, junction->coverage);
+    }
+}
+
+bool gt_junction_set_has_site(gt_junction_set* set, uint64_t seq_id, uint64_t position){
+    gt_junction_set_sort(set);
+    register const uint64_t num_sites = gt_vector_get_used(set->sites);
+    register gt_junction_site* const sites = gt_vector_get_mem(set->sites, gt_junction_site);
+    // Lower bound of {seq_id,position}
+    register uint64_t lo = 0, hi = num_sites;
+    while(lo < hi){
+        register const uint64_t mid = lo+(hi-lo)/2;
+        if(sites[mid].seq < seq_id || (sites[mid].seq == seq_id && sites[mid].position < position)) lo = mid+1;
+        else hi = mid;
+    }
+    return lo < num_sites && sites[lo].seq == seq_id && sites[lo].position == position;
+}
+
+uint64_t gt_junction_set_filter(gt_junction_set* set, uint64_t min_distance, uint64_t max_distance, uint64_t min_coverage, gt_junction_set* rescue){
+    register const uint64_t num_junctions = gt_vector_get_used(set->junctions);
+    register gt_junction* const junctions = gt_vector_get_mem(set->junctions, gt_junction);
+    register uint64_t i, kept = 0;
+    for(i=0; i<num_junctions; i++){
+        register gt_junction* const junction = junctions+i;
+        register const uint64_t distance = (junction->start_position > junction->end_position) ?
+            junction->start_position-junction->end_position : junction->end_position-junction->start_position;
+        if(distance < min_distance || distance > max_distance) continue;
+        if(junction->coverage < min_coverage){
+            // Rescued if any of its sites is annotated
+            if(rescue == NULL) continue;
+            register const uint64_t start_seq = gt_junction_set_find_seq_id(rescue, gt_junction_set_get_seq_name(set, junction->start_seq));
+            register const uint64_t end_seq = gt_junction_set_find_seq_id(rescue, gt_junction_set_get_seq_name(set, junction->end_seq));
+            if(!(start_seq != GT_JUNCTION_SEQ_NOT_FOUND && gt_junction_set_has_site(rescue, start_seq, junction->start_position)) &&
+               !(end_seq != GT_JUNCTION_SEQ_NOT_FOUND && gt_junction_set_has_site(rescue, end_seq, junction->end_position))) continue;
+        }
+        if(kept != i) junctions[kept] = *junction;
+        kept++;
+    }
+    if(kept == num_junctions) return 0;
+    gt_vector_set_used(set->junctions, kept);
+    gt_junction_set_index_rebuild(set, set->index_size);
+    set->sorted = false;
+    return num_junctions-kept;
+}
+
+/*
+ * Interval index
+ */
+typedef struct {
+  char* name;
+  uint64_t seq_id;
+} gt_junction_seq_key;
+typedef struct {
+  uint64_t seq_rank;
+  uint64_t begin;
+  uint64_t end;
+  uint64_t position;
+} gt_junction_sort_key;
+#define gt_junction_span_begin(junction) GT_MIN((junction)->start_position,(junction)->end_position)
+#define gt_junction_span_end(junction) GT_MAX((junction)->start_position,(junction)->end_position)
+
+int gt_junction_seq_key_cmp(const void* a, const void* b){
+    return strcmp(((gt_junction_seq_key*)a)->name, ((gt_junction_seq_key*)b)->name);
+}
+int gt_junction_sort_key_cmp(const void* a, const void* b){
+    register const gt_junction_sort_key* const key_a = a;
+    register const gt_junction_sort_key* const key_b = b;
+    if(key_a->seq_rank != key_b->seq_rank) return (key_a->seq_rank < key_b->seq_rank) ? -1 : 1;
+    if(key_a->begin != key_b->begin) return (key_a->begin < key_b->begin) ? -1 : 1;
+    if(key_a->end != key_b->end) return (key_a->end < key_b->end) ? -1 : 1;
+    return (key_a->position < key_b->position) ? -1 : (key_a->position > key_b->position);
+}
+int gt_junction_site_cmp(const void* a, const void* b){
+    register const gt_junction_site* const site_a = a;
+    register const gt_junction_site* const site_b = b;
+    if(site_a->seq != site_b->seq) return (site_a->seq < site_b->seq) ? -1 : 1;
+    if(site_a->position != site_b->position) return (site_a->position < site_b->position) ? -1 : 1;
+    return (site_a->junction < site_b->junction) ? -1 : (site_a->junction > site_b->junction);
+}
+
+void gt_junction_set_sort(gt_junction_set* set){
+    if(set->sorted) return;
+    register const uint64_t num_seqs = gt_vector_get_used(set->seq_names);
+    register const uint64_t num_junctions = gt_vector_get_used(set->junctions);
+    register uint64_t i;
+    // Rank the sequences by name
+    gt_junction_seq_key* const seq_keys = malloc(GT_MAX(num_seqs,1)*sizeof(gt_junction_seq_key));
+    uint64_t* const seq_rank = malloc(GT_MAX(num_seqs,1)*sizeof(uint64_t));
+    gt_cond_fatal_error(!seq_keys||!seq_rank,MEM_ALLOC);
+    for(i=0; i<num_seqs; i++){
+        seq_keys[i].name = gt_junction_set_get_seq_name(set, i);
+        seq_keys[i].seq_id = i;
+    }
+    qsort(seq_keys, num_seqs, sizeof(gt_junction_seq_key), gt_junction_seq_key_cmp);
+    for(i=0; i<num_seqs; i++) seq_rank[seq_keys[i].seq_id] = i;
+    // Sort the junctions by {sequence name, span}
+    gt_junction_sort_key* const keys = malloc(GT_MAX(num_junctions,1)*sizeof(gt_junction_sort_key));
+    gt_junction* const sorted = malloc(GT_MAX(num_junctions,1)*sizeof(gt_junction));
+    gt_cond_fatal_error(!keys||!sorted,MEM_ALLOC);
+    register gt_junction* const junctions = gt_vector_get_mem(set->junctions, gt_junction);
+    for(i=0; i<num_junctions; i++){
+        keys[i].seq_rank = seq_rank[junctions[i].start_seq];
+        keys[i].begin = gt_junction_span_begin(junctions+i);
+        keys[i].end = gt_junction_span_end(junctions+i);
+        keys[i].position = i;
+    }
+    qsort(keys, num_junctions, sizeof(gt_junction_sort_key), gt_junction_sort_key_cmp);
+    for(i=0; i<num_junctions; i++) sorted[i] = junctions[keys[i].position];
+    memcpy(junctions, sorted, num_junctions*sizeof(gt_junction));
+    free(sorted);
+    free(keys);
+    free(seq_rank);
+    free(seq_keys);
+    gt_junction_set_index_rebuild(set, set->index_size);
+    // Sequence ranges & maximum span end (per sequence)
+    gt_vector_clear(set->seq_ranges);
+    gt_vector_reserve(set->seq_ranges, num_seqs, true);
+    gt_vector_set_used(set->seq_ranges, num_seqs);
+    memset(gt_vector_get_mem(set->seq_ranges, gt_junction_range), 0, num_seqs*sizeof(gt_junction_range));
+    gt_vector_clear(set->max_end);
+    gt_vector_reserve(set->max_end, num_junctions, false);
+    gt_vector_set_used(set->max_end, num_junctions);
+    register uint64_t* const max_end = gt_vector_get_mem(set->max_end, uint64_t);
+    for(i=0; i<num_junctions; i++){
+        register gt_junction_range* const range = gt_vector_get_elm(set->seq_ranges, junctions[i].start_seq, gt_junction_range);
+        register const uint64_t end = gt_junction_span_end(junctions+i);
+        if(i == 0 || junctions[i-1].start_seq != junctions[i].start_seq){
+            range->begin = i;
+            max_end[i] = end;
+        }else{
+            max_end[i] = GT_MAX(max_end[i-1], end);
+        }
+        range->end = i+1;
+    }
+    // Sites
+    gt_vector_clear(set->sites);
+    gt_vector_reserve(set->sites, 2*num_junctions, false);
+    gt_vector_set_used(set->sites, 2*num_junctions);
+    register gt_junction_site* const sites = gt_vector_get_mem(set->sites, gt_junction_site);
+    for(i=0; i<num_junctions; i++){
+        sites[2*i].seq = junctions[i].start_seq;
+        sites[2*i].position = junctions[i].start_position;
+        sites[2*i].junction = i;
+        sites[2*i+1].seq = junctions[i].end_seq;
+        sites[2*i+1].position = junctions[i].end_position;
+        sites[2*i+1].junction = i;
+    }
+    qsort(sites, 2*num_junctions, sizeof(gt_junction_site), gt_junction_site_cmp);
+    set->sorted = true;
+}
+
+uint64_t gt_junction_set_overlaps(gt_junction_set* set, uint64_t seq_id, uint64_t begin, uint64_t end, gt_vector* positions){
+    gt_junction_set_sort(set);
+    if(seq_id >= gt_vector_get_used(set->seq_ranges)) return 0;
+    register const gt_junction_range* const range = gt_vector_get_elm(set->seq_ranges, seq_id, gt_junction_range);
+    register const gt_junction* const junctions = gt_vector_get_mem(set->junctions, gt_junction);
+    register const uint64_t* const max_end = gt_vector_get_mem(set->max_end, uint64_t);
+    // First junction starting after @end
+    register uint64_t lo = range->begin, hi = range->end;
+    while(lo < hi){
+        register const uint64_t mid = lo+(hi-lo)/2;
+        if(gt_junction_span_begin(junctions+mid) <= end) lo = mid+1;
+        else hi = mid;
+    }
+    // Scan back while any previous span can reach @begin
+    register const uint64_t first = gt_vector_get_used(positions);
+    register uint64_t i = lo;
+    while(i > range->begin && max_end[i-1] >= begin){
+        --i;
+        if(gt_junction_span_end(junctions+i) >= begin) gt_vector_insert(positions, i, uint64_t);
+    }
+    // Report in order
+    register uint64_t* const found = gt_vector_get_mem(positions, uint64_t);
+    register uint64_t a = first, b = gt_vector_get_used(positions);
+    while(a+1 < b){
+        register const uint64_t position = found[a];
+        found[a++] = found[--b];
+        found[b] = position;
+    }
+    return gt_vector_get_used(positions)-first;
+}
+
+uint64_t gt_junction_set_sites(gt_junction_set* set, uint64_t seq_id, uint64_t begin, uint64_t end, gt_vector* positions){
+    gt_junction_set_sort(set);
+    register const uint64_t num_sites = gt_vector_get_used(set->sites);
+    register const gt_junction_site* const sites = gt_vector_get_mem(set->sites, gt_junction_site);
+    register uint64_t lo = 0, hi = num_sites;
+    while(lo < hi){
+        register const uint64_t mid = lo+(hi-lo)/2;
+        if(sites[mid].seq < seq_id || (sites[mid].seq == seq_id && sites[mid].position < begin)) lo = mid+1;
+        else hi = mid;
+    }
+    register const uint64_t first = lo;
+    register uint64_t num_found = 0;
+    for(; lo<num_sites && sites[lo].seq==seq_id && sites[lo].position<=end; lo++){
+        register const gt_junction* const junction = gt_junction_set_get_junction(set, sites[lo].junction);
+        if(junction->start_seq == seq_id && junction->start_position >= begin && junction->start_position <= end){
+            // Both sites in range. Report the junction once (at its start site)
+            if(sites[lo].position != junction->start_position) continue;
+            if(lo > first && sites[lo-1].junction == sites[lo].junction && sites[lo-1].position == sites[lo].position) continue;
+        }
+        gt_vector_insert(positions, sites[lo].junction, uint64_t);
+        num_found++;
+    }
+    return num_found;
+}
+
+/*
+ * GTF loading
+ */
+typedef struct {
+  uint64_t transcript;
+  uint64_t seq;
+  uint64_t start;
+  uint64_t end;
+  gt_strand strand;
+  uint64_t order;
+} gt_junction_exon;
+
+int gt_junction_exon_cmp(const void* a, const void* b){
+    register const gt_junction_exon* const exon_a = a;
+    register const gt_junction_exon* const exon_b = b;
+    if(exon_a->transcript != exon_b->transcript) return (exon_a->transcript < exon_b->transcript) ? -1 : 1;
+    if(exon_a->start != exon_b->start) return (exon_a->start < exon_b->start) ? -1 : 1;
+    return (exon_a->order < exon_b->order) ? -1 : (exon_a->order > exon_b->order);
+}
+
+bool gt_junction_gtf_transcript_id(char* attributes, char** const id, uint64_t* const id_length){
+    // First attribute named transcript_id (value unquoted)
+    register char* attribute = attributes;
+    while(*attribute != '\0'){
+        while(*attribute == ' ' || *attribute == ';') ++attribute;
+        if(strncmp(attribute, "transcript_id", 13) == 0 && attribute[13] == ' '){
+            register char* value = attribute+14;
+            while(*value == ' ') ++value;
+            if(*value == '"') ++value;
+            register char* value_end = value;
+            while(*value_end != '\0' && *value_end != ';' && *value_end != '"' && *value_end != ' ' && *value_end != '\n') ++value_end;
+            if(value_end == value) return false;
+            *id = value;
+            *id_length = value_end-value;
+            return true;
+        }
+        while(*attribute != '\0' && *attribute != ';') ++attribute;
+    }
+    return false;
+}
+
+gt_status gt_junction_set_load_gtf(gt_junction_set* set, char* file_name){
+    gzFile file = gzopen(file_name, "r"); // Also reads uncompressed files
+    if(file == NULL) return GT_STATUS_FAIL;
+    gt_shash* const transcripts = gt_shash_new();
+    gt_string* const transcript_key = gt_string_new(64);
+    gt_vector* const exons = gt_vector_new(1024, sizeof(gt_junction_exon));
+    gt_string* const line = gt_string_new(1024);
+    char buffer[8192];
+    bool eof = false;
+    while(!eof){
+        // Read the (complete) line
+        gt_string_clear(line);
+        while(true){
+            if(gzgets(file, buffer, sizeof(buffer)) == NULL){ eof = true; break; }
+            register const uint64_t length = strlen(buffer);
+            gt_string_append_string(line, buffer, length);
+            if(length > 0 && buffer[length-1] == '\n') break;
+        }
+        gt_string_append_eos(line);
+        register char* const text = gt_string_get_string(line);
+        if(text[0] == '#' || text[0] == '\0' || text[0] == '\n') continue;
+        // Split the fields {seq,source,feature,start,end,score,strand,frame,attributes}
+        char* fields[9];
+        register uint64_t num_fields = 0;
+        register char* cursor = text;
+        fields[num_fields++] = cursor;
+        while(*cursor != '\0' && num_fields < 9){
+            if(*cursor == '\t'){
+                *cursor = '\0';
+                fields[num_fields++] = cursor+1;
+            }
+            ++cursor;
+        }
+        if(num_fields < 9 || strcmp(fields[2], "exon") != 0) continue;
+        gt_junction_exon exon;
+        switch(fields[6][0]){
+            case '+': case 'F': exon.strand = FORWARD; break;
+            case '-': case 'R': exon.strand = REVERSE; break;
+            default: continue;
+        }
+        exon.start = strtoull(fields[3], NULL, 10);
+        exon.end = strtoull(fields[4], NULL, 10);
+        if(exon.start == exon.end) continue;
+        if(exon.start > exon.end){
+            register const uint64_t position = exon.start;
+            exon.start = exon.end;
+            exon.end = position;
+            exon.strand = (exon.strand==FORWARD) ? REVERSE : FORWARD;
+        }
+        // Transcripts are identified by {transcript_id,seq}
+        char* id;
+        uint64_t id_length;
+        if(!gt_junction_gtf_transcript_id(fields[8], &id, &id_length)) continue;
+        gt_string_clear(transcript_key);
+        gt_string_append_string(transcript_key, id, id_length);
+        gt_string_append_string(transcript_key, fields[0], strlen(fields[0]));
+        gt_string_append_eos(transcript_key);
+        register uint64_t* transcript = gt_shash_get(transcripts, gt_string_get_string(transcript_key), uint64_t);
+        if(transcript == NULL){
+            transcript = malloc(sizeof(uint64_t));
+            gt_cond_fatal_error(!transcript,MEM_ALLOC);
+            *transcript = gt_shash_get_num_elements(transcripts);
+            gt_shash_insert(transcripts, gt_string_get_string(transcript_key), transcript, uint64_t);
+        }
+        exon.transcript = *transcript;
+        exon.seq = gt_junction_set_get_seq_id(set, fields[0], strlen(fields[0]));
+        exon.order = gt_vector_get_used(exons);
+        gt_vector_insert(exons, exon, gt_junction_exon);
+    }
+    gzclose(file);
+    // Junctions between consecutive exons (as gem.junctions.Junction.sites)
+    register const uint64_t num_exons = gt_vector_get_used(exons);
+    register gt_junction_exon* const sorted_exons = gt_vector_get_mem(exons, gt_junction_exon);
+    qsort(sorted_exons, num_exons, sizeof(gt_junction_exon), gt_junction_exon_cmp);
+    register uint64_t i;
+    for(i=1; i<num_exons; i++){
+        register gt_junction_exon* const last_exon = sorted_exons+(i-1);
+        register gt_junction_exon* const exon = sorted_exons+i;
+        if(exon->transcript != last_exon->transcript) continue;
+        register gt_junction_exon* const start_exon = (exon->strand==REVERSE) ? exon : last_exon;
+        register gt_junction_exon* const end_exon = (exon->strand==REVERSE) ? last_exon : exon;
+        gt_junction junction;
+        junction.start_seq = start_exon->seq;
+        junction.start_strand = start_exon->strand;
+        junction.start_position = (start_exon->strand==FORWARD) ? start_exon->end : start_exon->start;
+        junction.end_seq = end_exon->seq;
+        junction.end_strand = end_exon->strand;
+        junction.end_position = (end_exon->strand==FORWARD) ? end_exon->start : end_exon->end;
+        gt_junction_set_add(set, &junction, 1);
+    }
+    gt_string_delete(line);
+    gt_vector_delete(exons);
+    gt_string_delete(transcript_key);
+    gt_shash_delete(transcripts, true);
+    return GT_STATUS_OK;
+}
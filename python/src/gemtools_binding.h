@@ -4,9 +4,182 @@
 
 #include "gem_tools.h"
 
-void gt_merge_files_synch(gt_output_file* const output_file, uint64_t threads, const uint64_t num_files,  gt_input_file** files);
-void gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map);
+/*
+ * Native template filter chains. Built-in python TemplateFilters are compiled
+ * into a list of C predicates that can be applied without the GIL
+ *   (Trim/MAPQ attributes are borrowed from the python filter objects)
+ */
+typedef enum { GT_FILTER_UNMAPPED, GT_FILTER_UNIQUE, GT_FILTER_TRIM, GT_FILTER_AUTO_TRIM, GT_FILTER_MAPQ } gt_template_filter_type;
+typedef struct {
+  gt_template_filter_type type;
+  uint64_t max_mismatches; // GT_FILTER_UNMAPPED
+  uint64_t level;          // GT_FILTER_UNIQUE
+  uint64_t left;           // GT_FILTER_TRIM
+  uint64_t right;
+  uint64_t min_length;     // GT_FILTER_TRIM, GT_FILTER_AUTO_TRIM
+  bool set_extra;
+  gt_dna_read_trim_attributes* trim_attributes; // GT_FILTER_AUTO_TRIM
+  gt_map_score_attributes* score_attributes;    // GT_FILTER_MAPQ
+  uint64_t min_mapq;
+} gt_template_filter;
+typedef struct {
+  gt_template_filter* filters;
+  uint64_t num_filters;
+} gt_template_filter_chain;
+
+gt_template_filter_chain* gt_template_filter_chain_new(uint64_t num_filters);
+void gt_template_filter_chain_delete(gt_template_filter_chain* chain);
+int64_t gt_template_get_uniq_level(gt_template* template, uint64_t max_level);
+bool gt_template_filter_chain_apply(gt_template_filter_chain* chain, gt_template* template);
+
+gt_status gt_merge_files_synch(gt_output_file* const output_file, uint64_t threads, const uint64_t num_files,  gt_input_file** files);
+gt_status gt_write_stream(gt_output_file* output, gt_input_file** inputs, uint64_t num_inputs, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, gt_template_filter_chain* filters);
 void gt_stats_fill(gt_input_file* input_file, gt_stats* target_all_stats, gt_stats* target_best_stats, uint64_t num_threads, bool paired_end);
+// Fills the stats and prints every parsed template (MAP format, input order) to @output (if not NULL)
+//   With an @output pairs are not forced (the file is parsed as gt_write_stream does)
+gt_status gt_stats_fill_output(gt_output_file* output, gt_input_file* input_file, gt_stats* target_all_stats, gt_stats* target_best_stats, uint64_t num_threads, bool paired_end, bool append_extra, bool clean_id);
 bool gt_input_file_has_qualities(gt_input_file* file);
 void gt_stats_print_stats(FILE* output, gt_stats* const stats, const bool paired_end);
+
+/*
+ * Template batches. Templates are parsed N at a time without the GIL
+ * (and optionally on several threads, each one with its own buffered input)
+ */
+typedef struct {
+  gt_template** templates;
+  uint64_t num_templates;
+  uint64_t max_templates;
+  gt_status error_code; // GT_IGP_FAIL if any template could not be parsed
+} gt_template_batch;
+
+gt_template_batch* gt_template_batch_new(uint64_t max_templates);
+void gt_template_batch_delete(gt_template_batch* batch);
+uint64_t gt_template_batch_fill(gt_template_batch* batch, gt_buffered_input_file** buffered_inputs, uint64_t num_threads, gt_generic_parser_attr* parser_attributes, gt_template_filter_chain* filters);
+
+/*
+ * In-process gzip output. Writes to the returned stream are cut into chunks that
+ * @num_threads compressor threads deflate concurrently (as pigz does) from a bounded ring.
+ * Each chunk is a gzip member; members are written in order (their concatenation is a
+ * valid gzip file). fclose() flushes the ring and reports compression/write errors
+ */
+#define GT_GZIP_CHUNK_SIZE (1<<20)
+#define GT_GZIP_CHUNKS_PER_THREAD 4
+FILE* gt_gzip_stream_open(int fd, int level, uint64_t num_threads);
+// Independent stream over a dup() of @stream (compressed by @compress_threads if @compress)
+FILE* gt_output_stream_dup(FILE* stream, bool compress, uint64_t compress_threads);
+
+/*
+ * Asynchronous writes. A native thread runs gt_write_stream()/gt_merge_files_synch()
+ * over its own output stream (see gt_output_stream_dup) and closes the inputs when done.
+ * Parse, merge, write and compression errors are returned by gt_write_job_join() (never fatal)
+ *   Jobs with stats (see gt_write_job_set_stats) fill them from the same parse (gt_stats_fill_output)
+ */
+typedef struct {
+  /* Output */
+  FILE* stream;
+  gt_output_file* output;
+  /* Input */
+  gt_input_file** inputs;
+  uint64_t num_inputs;
+  /* Parameters */
+  bool merge;
+  bool append_extra;
+  bool clean_id;
+  bool interleave;
+  bool write_map;
+  uint64_t threads;
+  gt_template_filter_chain* filters; // Borrowed (NULL if none)
+  gt_stats* all_stats;  // Borrowed (NULL if none)
+  gt_stats* best_stats; // Borrowed (NULL if none)
+  bool paired_end;
+  /* Thread */
+  pthread_t thread;
+  bool started;
+  volatile bool running; // Cleared by the thread once the output is written
+  gt_status error_code;
+} gt_write_job;
+
+gt_write_job* gt_write_job_new(FILE* stream, gt_input_file** inputs, uint64_t num_inputs, bool merge, bool append_extra, bool clean_id, bool interleave, uint64_t threads, bool write_map, gt_template_filter_chain* filters);
+void gt_write_job_set_stats(gt_write_job* job, gt_stats* all_stats, gt_stats* best_stats, bool paired_end);
+void gt_write_job_start(gt_write_job* job);
+gt_status gt_write_job_join(gt_write_job* job);
+void gt_write_job_delete(gt_write_job* job);
+
+/*
+ * Junction sets. De-novo junctions are taken from the SPLICE junctions between consecutive
+ * map blocks and their coverage is counted in a compact (open addressing) hash.
+ *   Extracted junctions are normalised as gem.junctions.JunctionSite does when reading a
+ *   junctions line (start_position<=end_position, flipping the strands if swapped). Annotation
+ *   junctions keep the GTF descriptor (on the reverse strand start_position>end_position)
+ *   Sequence names are interned (start_seq/end_seq index @seq_names)
+ *   Queries use an interval index (built on demand by gt_junction_set_sort), where each junction
+ *   spans [min,max] of its site positions on the sequence of its start site
+ */
+typedef struct {
+  uint64_t start_seq;
+  uint64_t start_position;
+  uint64_t end_seq;
+  uint64_t end_position;
+  gt_strand start_strand;
+  gt_strand end_strand;
+  uint64_t coverage;
+} gt_junction;
+typedef struct {
+  /* Sequence names */
+  gt_shash* seq_ids;    // (uint64_t) name -> seq_id
+  gt_vector* seq_names; // (char*) seq_id -> name (keys of @seq_ids)
+  gt_string* seq_buffer;
+  uint64_t last_seq;    // Last interned seq_id (consecutive maps share the sequence)
+  /* Junctions */
+  gt_vector* junctions; // (gt_junction)
+  uint64_t* index;      // Position+1 of the junction (0 => empty)
+  uint64_t index_size;
+  /* Interval index */
+  bool sorted;          // Cleared whenever junctions are added/removed
+  gt_vector* seq_ranges; // (gt_junction_range) seq_id -> sorted junctions on the sequence
+  gt_vector* max_end;   // (uint64_t) Maximum span end up to each junction of the sequence
+  gt_vector* sites;     // (gt_junction_site) All sites sorted by {seq,position}
+} gt_junction_set;
+typedef struct {
+  uint64_t begin;
+  uint64_t end;
+} gt_junction_range;
+typedef struct {
+  uint64_t seq;
+  uint64_t position;
+  uint64_t junction;
+} gt_junction_site;
+
+gt_junction_set* gt_junction_set_new(void);
+void gt_junction_set_clear(gt_junction_set* set);
+void gt_junction_set_delete(gt_junction_set* set);
+uint64_t gt_junction_set_get_seq_id(gt_junction_set* set, char* seq_name, uint64_t length);
+char* gt_junction_set_get_seq_name(gt_junction_set* set, uint64_t seq_id);
+uint64_t gt_junction_set_get_num_junctions(gt_junction_set* set);
+gt_junction* gt_junction_set_get_junction(gt_junction_set* set, uint64_t position);
+// Add @coverage to the junction (inserted if not present). Returns the stored junction
+gt_junction* gt_junction_set_add(gt_junction_set* set, gt_junction* junction, uint64_t coverage);
+void gt_junction_set_merge(gt_junction_set* set_dst, gt_junction_set* set_src);
+// Add the junctions of @map with a distance in [@min_split,@max_split]. Returns the number added
+uint64_t gt_junction_set_add_map(gt_junction_set* set, gt_map* map, uint64_t min_split, uint64_t max_split);
+// Extract the junctions of all alignments with at most @max_matches maps (0 => no limit)
+gt_status gt_junction_set_extract(gt_junction_set* set, gt_input_file* input, uint64_t min_split, uint64_t max_split, uint64_t max_matches, uint64_t threads);
+// Add the junctions between consecutive exons of each transcript (as gem.junctions.from_gtf)
+gt_status gt_junction_set_load_gtf(gt_junction_set* set, char* file_name);
+
+// Set operations (junctions of different sets are matched by sequence name)
+#define GT_JUNCTION_SEQ_NOT_FOUND UINT64_MAX
+uint64_t gt_junction_set_find_seq_id(gt_junction_set* set, char* seq_name);
+gt_junction* gt_junction_set_get(gt_junction_set* set, gt_junction* junction);
+gt_junction* gt_junction_set_find(gt_junction_set* set, gt_junction_set* set_src, gt_junction* junction);
+void gt_junction_set_intersection(gt_junction_set* set_dst, gt_junction_set* set_a, gt_junction_set* set_b);
+// Keep the junctions with a distance in [@min_distance,@max_distance] and a coverage of at least
+// @min_coverage (or sharing a site with @rescue, if given). Returns the number of junctions removed
+uint64_t gt_junction_set_filter(gt_junction_set* set, uint64_t min_distance, uint64_t max_distance, uint64_t min_coverage, gt_junction_set* rescue);
+
+// Interval index (results are appended to @positions as junction positions)
+void gt_junction_set_sort(gt_junction_set* set);
+uint64_t gt_junction_set_overlaps(gt_junction_set* set, uint64_t seq_id, uint64_t begin, uint64_t end, gt_vector* positions);
+uint64_t gt_junction_set_sites(gt_junction_set* set, uint64_t seq_id, uint64_t begin, uint64_t end, gt_vector* positions);
+
 #endif /* GEMTOOLS_BINDING_H */
@@ -1,3 +1,4 @@
+from nose.tools import raises
 from gem import files
 from gem import filter
 from testfiles import testfiles
@@ -39,6 +40,24 @@ def test_fastq_trim_both():
     assert sum_length == 550000, sum_length
 
 
+def test_fastq_auto_trim_quality():
+    reads = files.open(testfiles["reads_1.fastq"])
+    sum_length = sum(r.length for r in filter.auto_trim(reads, quality=20))
+    assert sum_length == 730409, sum_length
+
+
+@raises(ValueError)
+def test_fastq_auto_trim_quality_out_of_range():
+    reads = files.open(testfiles["reads_1.fastq"])
+    filter.auto_trim(reads, quality=300)
+
+
+def test_fastq_auto_trim_poly_a_and_n():
+    reads = files.open(testfiles["reads_1.fastq"])
+    sum_length = sum(r.length for r in filter.auto_trim(reads, poly_a=5, trim_n=True))
+    assert sum_length == 749780, sum_length
+
+
 def test_fastq_filtering():
     reads = files.open(testfiles["reads_1.fastq"])
     num_reads = sum(1 for r in reads.clone())
@@ -5,7 +5,7 @@ import gem.gemtools as gt
 from testfiles import testfiles
 import os
 import shutil
-from nose.tools import with_setup
+from nose.tools import with_setup, raises
 from gem import files
 
 results_dir = None
@@ -131,3 +131,18 @@ def test_writing_interleaved_file():
         lines = f.readlines()
         assert len(lines) == 80000
 
+
+@with_setup(setup_func, cleanup)
+@raises(IOError)
+def test_writing_interleaved_file_out_of_synch():
+    # the second end misses its last read
+    truncated = results_dir + "/reads_2_truncated.fastq"
+    with open(testfiles["reads_2.fastq"]) as f:
+        lines = f.readlines()
+    with open(truncated, "w") as f:
+        f.writelines(lines[:-4])
+    source1 = files.open(testfiles["reads_1.fastq"])
+    source2 = files.open(truncated)
+    out = gt.OutputFile(results_dir + "/write_interleaved.fastq")
+    gt.interleave([source1, source2]).write_stream(out, write_map=False)
+
@@ -116,6 +116,43 @@ def test_template_merge():
     template_1.merge(template_2)
     assert template_1.to_map() == "A/1\tAAA\t###\t1\tchr1:+:50:3", "Not '%s'" % template_1.to_map()
 
+
+def test_template_batch_reads_and_qualities():
+    expected = [(t.read, t.qualities) for t in gt.InputFile(test_mapping)]
+    found = []
+    for batch in gt.InputFile(test_mapping).batches(4):
+        (read_offsets, reads) = batch.reads()
+        (qualities_offsets, qualities) = batch.qualities()
+        assert len(read_offsets) == len(batch) + 1
+        assert len(qualities_offsets) == len(batch) + 1
+        read_bytes = reads.tostring()
+        quality_bytes = qualities.tostring()
+        for i in range(len(batch)):
+            found.append((read_bytes[read_offsets[i]:read_offsets[i + 1]],
+                          quality_bytes[qualities_offsets[i]:qualities_offsets[i + 1]]))
+    assert found == expected, found
+
+
+def test_template_batch_reads_of_missing_block_are_empty():
+    for batch in gt.InputFile(test_mapping).batches(16):
+        (offsets, reads) = batch.reads(1)
+        assert offsets.tolist() == [0] * (len(batch) + 1)
+        assert len(reads) == 0
+
+
+def test_template_arrays_are_copies():
+    template = gt.Template()
+    template.parse("A/1\tACGT\t####\t0\t-\n")
+    alignment = template.alignments()[0]
+    read = alignment.read_array
+    qualities = alignment.qualities_array
+    assert read.tostring() == "ACGT"
+    assert qualities.tostring() == "####"
+    # copies stay valid when the template is refilled
+    template.parse("B/1\tTTTTTT\t\t0\t-\n")
+    assert read.tostring() == "ACGT"
+    assert template.alignments()[0].qualities_array is None
+
 #
 #def test_template_counters_list():
 #    infile = gt.open_file(testfiles["paired_w_splitmap.map"])
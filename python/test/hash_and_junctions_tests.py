@@ -52,3 +52,49 @@ def test_junction_filter():
         assert source_xs == filter_xs
 
 
+
+
+def test_extract_denovo_junctions():
+    sites = gem.splits.extract_denovo_junctions(testfiles["chr21_mapping_initial_split.map"])
+    assert len(sites) == 23
+    assert junctions.JunctionSite(line="chr21\t+\t47848504\tchr21\t+\t47849924") in sites
+    assert len(gem.splits.extract_denovo_junctions(testfiles["chr21_mapping_initial_split.map"], threads=2)) == 23
+
+
+def test_junction_set_from_gtf():
+    js = junctions.junction_set_from_gtf(testfiles["refseq.gtf"])
+    assert len(js) == 260
+    assert len(list(junctions.from_gtf(testfiles["refseq.gtf"]))) == 260
+    assert ("chr1", "+", 12227, "chr1", "+", 12613) in js
+    assert ("chr1", "+", 12227, "chr1", "+", 12613) in [d[:6] for d in js.sites("chr1", 12000, 12300)]
+    assert ("chr1", "+", 12227, "chr1", "+", 12613) in [d[:6] for d in js.overlaps("chr1", 12400, 12400)]
+    assert len(js.intersection(js)) == 260
+    # junctions are returned in span order (numeric, by sequence)
+    found = [(j.descriptor, j.coverage) for j in junctions.from_gtf(testfiles["refseq.gtf"])]
+    assert found[:6] == [
+        (["chr1", "+", 12227, "chr1", "+", 12613], 1),
+        (["chr1", "+", 12721, "chr1", "+", 13221], 1),
+        (["chr1", "+", 324060, "chr1", "+", 324288], 3),
+        (["chr1", "+", 324345, "chr1", "+", 324439], 3),
+        (["chr1", "+", 326938, "chr1", "+", 327036], 1),
+        (["chr1", "+", 763155, "chr1", "+", 764383], 1),
+    ], found[:6]
+    assert found[-3:] == [
+        (["chr1", "+", 2116137, "chr1", "+", 2116361], 4),
+        (["chr1", "+", 2161174, "chr1", "+", 2234417], 1),
+        (["chr1", "+", 2234542, "chr1", "+", 2234724], 1),
+    ], found[-3:]
+
+
+def test_junction_set_from_gtf_reverse_strand():
+    # exons of reverse strand transcripts are listed from the 3' end;
+    # junctions go from the upstream exon start to the downstream exon end
+    found = [(j.descriptor, j.coverage) for j in junctions.from_gtf(testfiles["reverse_strand.gtf"])]
+    assert found == [
+        (["chr1", "+", 200, "chr1", "+", 301], 1),
+        (["chr2", "-", 1501, "chr2", "-", 1100], 1),
+        (["chr2", "-", 2001, "chr2", "-", 1600], 2),
+    ], found
+    js = junctions.junction_set_from_gtf(testfiles["reverse_strand.gtf"])
+    assert ("chr2", "-", 1501, "chr2", "-", 1100) in js
+    assert ("chr2", "-", 1501, "chr2", "-", 1100) in [d[:6] for d in js.overlaps("chr2", 1200, 1300)]
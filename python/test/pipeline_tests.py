@@ -0,0 +1,617 @@
+import os
+import shutil
+import tempfile
+import threading
+import time
+import argparse
+import gem.utils
+import gem.pipeline as pipeline
+from gem.pipeline import PipelineScheduler, PipelineStep, PipelineError, MappingPipeline, CreateBamStep, CreateStatsStep
+
+__author__ = 'agent <agent@local>'
+
+
+class StubPipeline(object):
+    """Minimal pipeline for stub steps (no caching, no files)"""
+    def __init__(self):
+        self.cache = False
+        self.remove_temp = False
+        self.threads = 1
+
+
+class Concurrency(object):
+    """Records the order of step events and the maximum
+    number of steps running at the same time"""
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.events = []
+        self.running = 0
+        self.max_running = 0
+
+    def start(self, name):
+        with self.lock:
+            self.events.append(("start", name))
+            self.running += 1
+            self.max_running = max(self.max_running, self.running)
+
+    def end(self, name):
+        with self.lock:
+            self.events.append(("end", name))
+            self.running -= 1
+
+    def index(self, event, name):
+        return self.events.index((event, name))
+
+
+class StubStep(PipelineStep):
+    """Step that sleeps for a while (or fails) and records its execution"""
+    def __init__(self, id, name, concurrency, dependencies=None, memory=0, fail=False, done=False, duration=0.2):
+        PipelineStep.__init__(self, name, dependencies=dependencies)
+        self.id = id
+        self.pipeline = StubPipeline()
+        self.configuration = {}
+        self.concurrency = concurrency
+        self._memory = memory
+        self.fail = fail
+        self.done = done
+        self.duration = duration
+        self.executed = False
+        self.run_threads = None
+
+    def files(self):
+        return []
+
+    def memory(self):
+        return self._memory
+
+    def is_done(self):
+        return self.done
+
+    def run(self):
+        self.executed = True
+        self.run_threads = self.threads
+        self.concurrency.start(self.name)
+        time.sleep(self.duration)
+        self.concurrency.end(self.name)
+        if self.fail:
+            raise PipelineError("Step %s failed" % self.name)
+
+
+def test_scheduler_runs_dependencies_first():
+    c = Concurrency()
+    a = StubStep(0, "a", c)
+    b = StubStep(1, "b", c, dependencies=[0])
+    scheduler = PipelineScheduler([a, b], 2)
+    assert scheduler.run()
+    assert c.index("end", "a") < c.index("start", "b")
+
+
+def test_scheduler_runs_independent_steps_concurrently():
+    c = Concurrency()
+    steps = [StubStep(0, "a", c, memory=10), StubStep(1, "b", c, memory=10)]
+    scheduler = PipelineScheduler(steps, 4, memory=100)
+    assert scheduler.run()
+    assert c.max_running == 2
+    # the threads are shared by the ready steps
+    assert [s.threads for s in steps] == [2, 2]
+
+
+def test_scheduler_delays_steps_over_memory_budget():
+    c = Concurrency()
+    steps = [StubStep(0, "a", c, memory=60), StubStep(1, "b", c, memory=60)]
+    scheduler = PipelineScheduler(steps, 4, memory=100)
+    assert scheduler.run()
+    assert c.max_running == 1
+    assert len(scheduler.completed) == 2
+    # a step delayed for memory does not take a share of the threads
+    assert [s.run_threads for s in steps] == [4, 4]
+
+
+def test_scheduler_splits_threads_among_started_steps():
+    c = Concurrency()
+    steps = [StubStep(0, "a", c, memory=40), StubStep(1, "b", c, memory=40), StubStep(2, "c", c, memory=40)]
+    scheduler = PipelineScheduler(steps, 4, memory=100)
+    assert scheduler.run()
+    assert c.max_running == 2
+    # a and b start together, c runs alone once they are done
+    assert [s.run_threads for s in steps] == [2, 2, 4]
+
+
+def test_scheduler_sequential():
+    c = Concurrency()
+    steps = [StubStep(0, "a", c), StubStep(1, "b", c)]
+    scheduler = PipelineScheduler(steps, 4, parallel=False)
+    assert scheduler.run()
+    assert c.max_running == 1
+    assert [s.threads for s in steps] == [4, 4]
+
+
+def test_scheduler_stops_after_failure():
+    c = Concurrency()
+    a = StubStep(0, "a", c, fail=True)
+    b = StubStep(1, "b", c, dependencies=[0])
+    scheduler = PipelineScheduler([a, b], 2)
+    assert not scheduler.run()
+    assert scheduler.failed == [a]
+    assert not b.executed
+
+
+def test_scheduler_skips_done_steps():
+    c = Concurrency()
+    a = StubStep(0, "a", c, done=True)
+    b = StubStep(1, "b", c, dependencies=[0])
+    scheduler = PipelineScheduler([a, b], 2)
+    assert scheduler.run()
+    assert not a.executed
+    assert b.executed
+
+
+def test_default_memory_budget_from_physical_memory():
+    p = MappingPipeline()
+    physical = pipeline.physical_memory()
+    if physical > 0:
+        assert p.memory_budget() == int(physical * pipeline.DEFAULT_MEMORY_FRACTION)
+    p.max_memory = "2G"
+    assert p.memory_budget() == 2 * 1024 ** 3
+    p.max_memory = "0"
+    assert p.memory_budget() == 0
+
+
+def test_no_memory_budget_without_physical_memory():
+    p = MappingPipeline()
+    physical_memory = pipeline.physical_memory
+    pipeline.physical_memory = lambda: 0
+    try:
+        assert p.memory_budget() is None
+        p.max_memory = "512M"
+        assert p.memory_budget() == 512 * 1024 ** 2
+    finally:
+        pipeline.physical_memory = physical_memory
+
+
+class StubStream(object):
+    """Output stream of a streamed step (read end of a pipe and the producer)"""
+    def __init__(self, source, process):
+        self.source = source
+        self.process = process
+
+
+class ThreadProducer(object):
+    """Producer writing to a pipe on a thread (as the native write_stream
+    threads do), it can only be waited for"""
+    def __init__(self):
+        (r, w) = os.pipe()
+        self.source = os.fdopen(r, 'r')
+        self.output = os.fdopen(w, 'w')
+        self.error = None
+        self.thread = threading.Thread(target=self.__write)
+        self.thread.daemon = True
+        self.thread.start()
+
+    def __write(self):
+        try:
+            while True:
+                self.output.write("x" * 4096)
+                self.output.flush()
+        except IOError, e:
+            self.error = e
+        finally:
+            try:
+                self.output.close()
+            except IOError:
+                pass
+
+    def wait(self):
+        self.thread.join(10)
+        if self.error is not None:
+            raise self.error
+
+
+class StreamedStep(StubStep):
+    """Step streamed into its consumer"""
+    def __init__(self, id, name, concurrency, stream):
+        StubStep.__init__(self, id, name, concurrency)
+        self.streamed = True
+        self._stub_stream = stream
+
+    def stream(self):
+        return self._stub_stream()
+
+
+class FailingConsumerStep(StubStep):
+    """Consumer that opens its fused input and fails"""
+    def run(self):
+        self.executed = True
+        self.input = self.fused[0].open()
+        raise PipelineError("Consumer %s failed" % self.name)
+
+
+def _process_stream(command):
+    process = gem.utils.ProcessWrapper()
+    process.submit(command)
+    process.start()
+    return StubStream(process.stdout, process)
+
+
+def _run_failing_consumer(stream):
+    c = Concurrency()
+    producer = StreamedStep(0, "producer", c, stream)
+    consumer = FailingConsumerStep(1, "consumer", c, dependencies=[0])
+    consumer.fused.append(producer)
+    scheduler = PipelineScheduler([consumer], 2)
+    t = time.time()
+    assert not scheduler.run()
+    assert time.time() - t < 10
+    return consumer.input
+
+
+def test_failed_consumer_stops_producer_on_full_pipe():
+    stream = _run_failing_consumer(lambda: _process_stream(["yes"]))
+    assert stream.process.processes[0].process.returncode is not None
+
+
+def test_failed_consumer_terminates_producer():
+    # the producer does not write, only terminating it stops it
+    stream = _run_failing_consumer(lambda: _process_stream(["sleep", "30"]))
+    assert stream.process.processes[0].process.returncode is not None
+
+
+def test_failed_consumer_stops_producer_thread():
+    def stream():
+        producer = ThreadProducer()
+        return StubStream(producer.source, producer)
+    stream = _run_failing_consumer(stream)
+    assert not stream.process.thread.is_alive()
+    assert stream.process.error is not None
+
+
+class ReadingConsumerStep(StubStep):
+    """Consumer that reads its fused input to the end"""
+    def run(self):
+        self.executed = True
+        self.input = self.fused[0].open()
+        self.input.source.read()
+
+
+def test_consumer_fails_if_streamed_producer_fails():
+    c = Concurrency()
+    producer = StreamedStep(0, "producer", c, lambda: _process_stream(["false"]))
+    consumer = ReadingConsumerStep(1, "consumer", c, dependencies=[0])
+    consumer.fused.append(producer)
+    scheduler = PipelineScheduler([consumer], 2)
+    assert not scheduler.run()
+    assert consumer.executed
+    assert scheduler.failed == [consumer]
+
+
+class StreamableStep(StubStep):
+    """Step that can stream its output"""
+    def __init__(self, id, name, dependencies=None, final=False, done=False, stream_input=True):
+        StubStep.__init__(self, id, name, Concurrency(), dependencies=dependencies, done=done)
+        self.final = final
+        self.stream_input = stream_input
+
+    def streamable(self):
+        return True
+
+
+def _fuse(steps, force=False):
+    p = MappingPipeline()
+    p.steps = steps
+    return p.fuse(steps, force)
+
+
+def test_fuse_streams_into_single_pending_consumer():
+    a = StreamableStep(0, "a")
+    b = StreamableStep(1, "b", dependencies=[0])
+    assert _fuse([a, b]) == [b]
+    assert a.streamed
+    assert b.fused == [a]
+
+
+def test_fuse_ignores_consumers_that_are_done():
+    a = StreamableStep(0, "a")
+    b = StreamableStep(1, "b", dependencies=[0], done=True)
+    c = StreamableStep(2, "c", dependencies=[0])
+    p = MappingPipeline()
+    p.steps = [a, b, c]
+    # b is up to date and not scheduled, c is the only pending consumer
+    assert p.fuse([a, c]) == [c]
+    assert c.fused == [a]
+
+
+def test_fuse_skips_final_steps():
+    a = StreamableStep(0, "a", final=True)
+    b = StreamableStep(1, "b", dependencies=[0])
+    assert _fuse([a, b]) == [a, b]
+    assert not a.streamed and b.fused == []
+
+
+def test_fuse_skips_outputs_with_several_readers():
+    a = StreamableStep(0, "a")
+    b = StreamableStep(1, "b", dependencies=[0])
+    c = StreamableStep(2, "c", dependencies=[0])
+    assert _fuse([a, b, c]) == [a, b, c]
+    assert not a.streamed
+
+
+def test_fuse_skips_consumers_without_stream_input():
+    a = StreamableStep(0, "a")
+    b = StreamableStep(1, "b", dependencies=[0], stream_input=False)
+    assert _fuse([a, b]) == [a, b]
+    assert not a.streamed
+
+
+def test_fuse_skips_done_steps_unless_forced():
+    a = StreamableStep(0, "a", done=True)
+    b = StreamableStep(1, "b", dependencies=[0])
+    assert _fuse([a, b]) == [a, b]
+    assert not a.streamed
+    a = StreamableStep(0, "a", done=True)
+    b = StreamableStep(1, "b", dependencies=[0])
+    assert _fuse([a, b], force=True) == [b]
+    assert a.streamed
+
+
+class FileStep(PipelineStep):
+    """Step that writes its output file in the pipeline output folder
+    and counts its executions"""
+    def __init__(self, name, pipeline, dependencies=None, fail=False):
+        PipelineStep.__init__(self, name, dependencies=dependencies)
+        self.fail = fail
+        self.runs = 0
+        self.prepare(len(pipeline.steps), pipeline, {"index": pipeline.index})
+        pipeline.steps.append(self)
+
+    def files(self):
+        return [os.path.join(self.pipeline.output_dir, self.name + ".out")]
+
+    def run(self):
+        self.runs += 1
+        if self.fail:
+            raise PipelineError("Step %s failed" % self.name)
+        with open(self.files()[0], "w") as f:
+            f.write(self.name)
+
+
+def _write(file_name, content):
+    with open(file_name, "w") as f:
+        f.write(content)
+
+
+class CachedPipeline(object):
+    """Pipeline with reads and an index in a temporary output folder"""
+    def __init__(self):
+        self.directory = tempfile.mkdtemp()
+        self.pipeline = MappingPipeline()
+        self.pipeline.name = "test"
+        self.pipeline.output_dir = self.directory
+        self.pipeline.input = [self.file("reads.fastq", "@r\nACGT\n+\n####\n")]
+        self.pipeline.index = self.file("genome.gem", "ACGT")
+
+    def file(self, name, content):
+        file_name = os.path.join(self.directory, name)
+        _write(file_name, content)
+        return file_name
+
+    def run(self):
+        return PipelineScheduler(self.pipeline.steps, 2).run()
+
+    def close(self):
+        shutil.rmtree(self.directory)
+
+
+class BlockingSha1(object):
+    """sha1 that blocks its first update until released"""
+    def __init__(self, sha1, entered, release):
+        self.entered = entered
+        self.release = release
+        self.h = sha1()
+
+    def update(self, block):
+        self.entered.set()
+        self.release.wait()
+        self.h.update(block)
+
+    def hexdigest(self):
+        return self.h.hexdigest()
+
+
+def test_checksum_hashes_without_holding_the_cache_lock():
+    p = CachedPipeline()
+    entered = threading.Event()
+    release = threading.Event()
+    sha1 = pipeline.hashlib.sha1
+    hashing = None
+    try:
+        cached = p.pipeline.checksum(p.pipeline.index)
+        pipeline.hashlib.sha1 = lambda: BlockingSha1(sha1, entered, release)
+        hashing = threading.Thread(target=p.pipeline.checksum, args=(p.pipeline.input[0],))
+        hashing.start()
+        entered.wait(5)
+        assert entered.is_set()
+        # a cached checksum is returned while the other file is hashed
+        result = []
+        lookup = threading.Thread(target=lambda: result.append(p.pipeline.checksum(p.pipeline.index)))
+        lookup.start()
+        lookup.join(5)
+        assert result == [cached]
+    finally:
+        release.set()
+        if hashing is not None:
+            hashing.join()
+        pipeline.hashlib.sha1 = sha1
+        p.close()
+
+
+def test_cached_steps_are_skipped():
+    p = CachedPipeline()
+    try:
+        a = FileStep("a", p.pipeline)
+        b = FileStep("b", p.pipeline, dependencies=[0])
+        assert p.run()
+        assert p.run()
+        assert (a.runs, b.runs) == (1, 1)
+    finally:
+        p.close()
+
+
+def test_signature_changes_with_index_content():
+    p = CachedPipeline()
+    try:
+        a = FileStep("a", p.pipeline)
+        signature = a.signature()
+        assert p.run()
+        # rebuild the index in place, same path
+        _write(p.pipeline.index, "ACGTACGT")
+        assert a.signature() != signature
+        assert not a.is_done()
+        assert p.run()
+        assert a.runs == 2
+    finally:
+        p.close()
+
+
+def test_signature_changes_with_reads_and_configuration():
+    p = CachedPipeline()
+    try:
+        a = FileStep("a", p.pipeline)
+        signature = a.signature()
+        _write(p.pipeline.input[0], "@r\nACGTA\n+\n#####\n")
+        assert a.signature() != signature
+        signature = a.signature()
+        a.configuration["mismatches"] = 0.08
+        assert a.signature() != signature
+    finally:
+        p.close()
+
+
+def test_dependent_steps_rerun_with_changed_outputs():
+    p = CachedPipeline()
+    try:
+        a = FileStep("a", p.pipeline)
+        b = FileStep("b", p.pipeline, dependencies=[0])
+        assert p.run()
+        # the output of a changes after it was committed
+        _write(a.files()[0], "changed")
+        assert not a.is_done()
+        assert p.run()
+        assert (a.runs, b.runs) == (2, 1)
+        # a restored its output, b is still up to date
+        assert b.is_done()
+    finally:
+        p.close()
+
+
+def test_resume_after_failure():
+    p = CachedPipeline()
+    try:
+        a = FileStep("a", p.pipeline)
+        b = FileStep("b", p.pipeline, dependencies=[0], fail=True)
+        c = FileStep("c", p.pipeline, dependencies=[1])
+        assert not p.run()
+        assert a.is_done()
+        assert not b.is_done()
+        assert c.runs == 0
+        b.fail = False
+        assert p.run()
+        assert (a.runs, b.runs, c.runs) == (1, 2, 1)
+    finally:
+        p.close()
+
+
+def test_no_cache_checks_output_files_only():
+    p = CachedPipeline()
+    try:
+        parser = argparse.ArgumentParser()
+        p.pipeline.register_execution(parser)
+        p.pipeline.update(vars(parser.parse_args(["--no-cache"])))
+        assert not p.pipeline.cache
+        a = FileStep("a", p.pipeline)
+        assert p.run()
+        _write(p.pipeline.index, "ACGTACGT")
+        assert a.is_done()
+        assert p.run()
+        assert a.runs == 1
+        # nothing is committed
+        assert p.pipeline.load_stamp(a) is None
+        os.remove(a.files()[0])
+        assert not a.is_done()
+    finally:
+        p.close()
+
+
+class StubBamStep(StubStep, CreateBamStep):
+    """BAM step that records its execution"""
+    def __init__(self, id, name, concurrency, dependencies=None, done=False):
+        StubStep.__init__(self, id, name, concurrency, dependencies=dependencies, done=done)
+
+
+class StubStatsStep(StubStep, CreateStatsStep):
+    """Stats step that records its execution, on its own or
+    attached to a BAM step"""
+    def __init__(self, id, name, concurrency, dependencies=None):
+        StubStep.__init__(self, id, name, concurrency, dependencies=dependencies)
+        self.attached_runs = 0
+
+    def join_fused(self):
+        self.attached_runs += 1
+
+    def commit(self, signature):
+        pass
+
+
+class StandaloneStatsStep(CreateStatsStep):
+    """Stats step that computes its stats in a process, reading nothing"""
+    def __init__(self):
+        CreateStatsStep.__init__(self, "stats")
+        self.id = 0
+        self.pipeline = StubPipeline()
+        self.configuration = {"stats_paired": False}
+        self.threads = 1
+
+    def _input(self):
+        return None
+
+
+def test_stats_step_fails_if_stats_process_fails():
+    def crash(*args, **kwargs):
+        os._exit(3)
+    read_stats = pipeline.gt.read_stats
+    pipeline.gt.read_stats = crash
+    try:
+        StandaloneStatsStep().run()
+        assert False, "Failed stats process not detected"
+    except PipelineError, e:
+        assert "finished with 3" in e.message, e.message
+    finally:
+        pipeline.gt.read_stats = read_stats
+
+
+def _shared_input_steps(bam_done):
+    c = Concurrency()
+    bam = StubBamStep(0, "bam", c, dependencies=[-1], done=bam_done)
+    stats = StubStatsStep(1, "stats", c, dependencies=[-1])
+    steps = MappingPipeline().share_inputs([bam, stats])
+    assert steps == [bam]
+    assert stats.attached and bam.stats is stats
+    return (steps, bam, stats)
+
+
+def test_attached_stats_run_with_bam_step():
+    (steps, bam, stats) = _shared_input_steps(False)
+    assert PipelineScheduler(steps, 2).run()
+    assert bam.executed
+    assert not stats.executed
+    assert stats.attached_runs == 1
+
+
+def test_attached_stats_run_on_their_own_if_bam_step_is_skipped():
+    (steps, bam, stats) = _shared_input_steps(True)
+    scheduler = PipelineScheduler(steps, 2)
+    assert scheduler.run()
+    assert not bam.executed
+    assert stats.executed
+    assert stats.attached_runs == 0
+    assert not stats.attached and bam.stats is None and bam.fused == []
+    assert scheduler.completed == set([0, 1])
@@ -0,0 +1,99 @@
+import gem.gemtools as gt
+import gem.stats
+from gem import files
+from testfiles import testfiles
+import os
+import shutil
+from nose.tools import with_setup, raises
+
+__author__ = 'agent <agent@local>'
+
+results_dir = None
+
+
+def setup_func():
+    global results_dir
+    results_dir = "test_results"
+    if not os.path.exists(results_dir):
+        os.mkdir(results_dir)
+    results_dir = os.path.abspath(results_dir)
+
+
+def cleanup():
+    shutil.rmtree(results_dir, ignore_errors=True)
+
+
+def _read_stats(file_name, paired=False):
+    all_stats = gt.Stats(False, paired)
+    best_stats = gt.Stats(True, paired)
+    gt.read_stats(files.open(file_name), all_stats, best_stats)
+    return (all_stats, best_stats)
+
+
+def _assert_binary_matches(stats, data, best_map, paired=False):
+    assert data["best_map"] == best_map
+    assert data["paired"] == paired
+    assert data["num_blocks"] == stats.num_blocks
+    assert data["num_alignments"] == stats.num_alignments
+    assert data["num_maps"] == stats.num_maps
+    assert data["num_mapped"] == stats.num_mapped
+    assert data["total_bases"] == stats.total_bases
+    for name, view in stats.views.items():
+        values = view.tolist()
+        if len(view.shape) == 2:
+            values = [v for row in values for v in row]
+        assert data[name] == values
+
+
+@with_setup(setup_func, cleanup)
+def test_stats_binary_round_trip():
+    (all_stats, best_stats) = _read_stats(testfiles["test.map"])
+    assert all_stats.num_blocks == 10
+    for name, stats, best_map in [("all", all_stats, False), ("best", best_stats, True)]:
+        binary = "%s/test.stats.%s.bin" % (results_dir, name)
+        with open(binary, "wb") as f:
+            stats.write_binary(f)
+        _assert_binary_matches(stats, gem.stats.read_binary(binary), best_map)
+        # from an open stream
+        with open(binary, "rb") as f:
+            _assert_binary_matches(stats, gem.stats.read_binary(f), best_map)
+            assert f.read() == ""
+
+
+def test_stats_misms_transition_view_is_read_base_by_misms_base():
+    (all_stats, best_stats) = _read_stats(testfiles["test.map"])
+    view = all_stats.views["misms_transition"]
+    assert view.shape == (5, 5)
+    # gt_stats indexes the transitions as read_base*5+misms_base
+    assert [v for row in view.tolist() for v in row] == all_stats.maps_profile.misms_transition[:5 * 5]
+
+
+@with_setup(setup_func, cleanup)
+def test_stats_binary_round_trip_paired():
+    (all_stats, best_stats) = _read_stats(testfiles["paired_w_splitmap.map"], paired=True)
+    binary = results_dir + "/paired.stats.bin"
+    with open(binary, "wb") as f:
+        all_stats.write_binary(f)
+    _assert_binary_matches(all_stats, gem.stats.read_binary(binary), False, paired=True)
+
+
+@with_setup(setup_func, cleanup)
+@raises(ValueError)
+def test_stats_read_binary_rejects_text_stats():
+    gem.stats.read_binary(testfiles["stats.txt"])
+
+
+@with_setup(setup_func, cleanup)
+def test_tee_stats_fill_stats_while_writing():
+    (all_stats, best_stats) = _read_stats(testfiles["test.map"])
+    tee_all = gt.Stats(False, False)
+    tee_best = gt.Stats(True, False)
+    tee = gt.tee_stats(files.open(testfiles["test.map"]), tee_all, tee_best, threads=2)
+    output = gt.OutputFile(results_dir + "/tee.map")
+    tee.write_stream(output, write_map=True)
+    output.close()
+    # the templates are written unchanged
+    assert sum(1 for t in files.open(results_dir + "/tee.map")) == 10
+    # and the stats are the ones read from the input
+    assert tee_all.__dict__ == all_stats.__dict__
+    assert tee_best.__dict__ == best_stats.__dict__
@@ -305,7 +305,7 @@ except:
 gemtools = Extension("gem.gemtools", sources=["python/src/gemtools_binding.c", "python/src/gemtools.pyx", "python/src/gemapi.pxd"],
                     include_dirs=['GEMTools/include', 'GEMTools/resources/include/'],
                     library_dirs=['GEMTools/lib'],
-                    libraries=['z', 'bz2', 'gemtools'],
+                    libraries=['z', 'bz2', 'gemtools', 'm'],
                     extra_compile_args=['-fopenmp'],
                     extra_link_args=["-fopenmp"]
 )